@@ -3,6 +3,7 @@
 #include "data/clientGeoJsonSource.h"
 
 #include <cassert>
+#include <vector>
 
 extern "C" {
 
@@ -345,4 +346,92 @@ extern "C" {
         map->applySceneUpdates();
     }
 
+    JNIEXPORT jlong JNICALL Java_com_mapzen_tangram_MapController_nativeMarkerAdd(JNIEnv* jniEnv, jobject obj, jlong mapPtr) {
+        assert(mapPtr > 0);
+        auto map = reinterpret_cast<Tangram::Map*>(mapPtr);
+        return map->markerAdd();
+    }
+
+    JNIEXPORT jboolean JNICALL Java_com_mapzen_tangram_MapController_nativeMarkerRemove(JNIEnv* jniEnv, jobject obj, jlong mapPtr, jlong markerId) {
+        assert(mapPtr > 0);
+        auto map = reinterpret_cast<Tangram::Map*>(mapPtr);
+        return map->markerRemove(static_cast<Tangram::MarkerID>(markerId));
+    }
+
+    JNIEXPORT jboolean JNICALL Java_com_mapzen_tangram_MapController_nativeMarkerSetStyling(JNIEnv* jniEnv, jobject obj, jlong mapPtr, jlong markerId, jstring styling) {
+        assert(mapPtr > 0);
+        auto map = reinterpret_cast<Tangram::Map*>(mapPtr);
+        const char* cStyling = jniEnv->GetStringUTFChars(styling, NULL);
+        jboolean result = map->markerSetStyling(static_cast<Tangram::MarkerID>(markerId), cStyling);
+        jniEnv->ReleaseStringUTFChars(styling, cStyling);
+        return result;
+    }
+
+    JNIEXPORT void JNICALL Java_com_mapzen_tangram_MapController_nativeApplyUpdateBatch(JNIEnv* jniEnv, jobject obj, jlong mapPtr, jint count, jintArray jtypes, jlongArray jids, jdoubleArray jargs) {
+        assert(mapPtr > 0);
+        auto map = reinterpret_cast<Tangram::Map*>(mapPtr);
+
+        jint* types = jniEnv->GetIntArrayElements(jtypes, NULL);
+        jlong* ids = jniEnv->GetLongArrayElements(jids, NULL);
+        jdouble* args = jniEnv->GetDoubleArrayElements(jargs, NULL);
+
+        // Command codes and argument stride; must match MapUpdateBatch.java
+        enum { MARKER_SET_POINT = 0, MARKER_SET_POINT_EASED, MARKER_SET_VISIBLE,
+               SET_POSITION, SET_ZOOM, SET_ROTATION, SET_TILT };
+        const jint stride = 4;
+
+        // Runs of point updates are folded into one 'markerSetPoints' call, so
+        // a tick that moves every marker walks the marker list once.
+        std::vector<Tangram::MarkerID> markers;
+        std::vector<Tangram::LngLat> points;
+        auto flushPoints = [&]() {
+            if (!markers.empty()) {
+                map->markerSetPoints(markers.data(), points.data(), static_cast<int>(markers.size()));
+                markers.clear();
+                points.clear();
+            }
+        };
+
+        for (jint i = 0; i < count; i++) {
+            const jdouble* a = args + i * stride;
+            switch (types[i]) {
+            case MARKER_SET_POINT:
+                markers.push_back(static_cast<Tangram::MarkerID>(ids[i]));
+                points.push_back({a[0], a[1]});
+                break;
+            case MARKER_SET_POINT_EASED:
+                flushPoints();
+                map->markerSetPointEased(static_cast<Tangram::MarkerID>(ids[i]), {a[0], a[1]},
+                                         static_cast<float>(a[2]),
+                                         static_cast<Tangram::EaseType>(static_cast<int>(a[3])));
+                break;
+            case MARKER_SET_VISIBLE:
+                flushPoints();
+                map->markerSetVisible(static_cast<Tangram::MarkerID>(ids[i]), a[0] != 0);
+                break;
+            case SET_POSITION:
+                flushPoints();
+                map->setPosition(a[0], a[1]);
+                break;
+            case SET_ZOOM:
+                flushPoints();
+                map->setZoom(static_cast<float>(a[0]));
+                break;
+            case SET_ROTATION:
+                flushPoints();
+                map->setRotation(static_cast<float>(a[0]));
+                break;
+            case SET_TILT:
+                flushPoints();
+                map->setTilt(static_cast<float>(a[0]));
+                break;
+            }
+        }
+        flushPoints();
+
+        jniEnv->ReleaseIntArrayElements(jtypes, types, JNI_ABORT);
+        jniEnv->ReleaseLongArrayElements(jids, ids, JNI_ABORT);
+        jniEnv->ReleaseDoubleArrayElements(jargs, args, JNI_ABORT);
+    }
+
 }
@@ -20,9 +20,12 @@
 #include <android/asset_manager_jni.h>
 #include <cstdarg>
 
+#include <fcntl.h>
 #include <libgen.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/resource.h>
+#include <sys/stat.h>
 #include <fstream>
 #include <algorithm>
 
@@ -58,6 +61,14 @@ static bool s_isContinuousRendering = false;
 PFNGLBINDVERTEXARRAYOESPROC glBindVertexArrayOESEXT = 0;
 PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT = 0;
 PFNGLGENVERTEXARRAYSOESPROC glGenVertexArraysOESEXT = 0;
+PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinaryOESEXT = 0;
+PFNGLPROGRAMBINARYOESPROC glProgramBinaryOESEXT = 0;
+PFNGLGENQUERIESEXTPROC glGenQueriesEXTEXT = 0;
+PFNGLDELETEQUERIESEXTPROC glDeleteQueriesEXTEXT = 0;
+PFNGLBEGINQUERYEXTPROC glBeginQueryEXTEXT = 0;
+PFNGLENDQUERYEXTPROC glEndQueryEXTEXT = 0;
+PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuivEXTEXT = 0;
+PFNGLDISCARDFRAMEBUFFEREXTPROC glDiscardFramebufferEXTEXT = 0;
 
 void bindJniEnvToThread(JNIEnv* jniEnv) {
     jniEnv->GetJavaVM(&jvm);
@@ -239,6 +250,68 @@ std::string stringFromFile(const char* _path) {
 
 }
 
+MappedFile mapFile(const char* _path) {
+
+    size_t len = strlen(_path);
+    if (len == 0) { return {}; }
+
+    if (_path[0] == '/') {
+
+        int fd = open(_path, O_RDONLY);
+        if (fd < 0) {
+            logMsg("Failed to open file at path: %s\n", _path);
+            return {};
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            close(fd);
+            return {};
+        }
+
+        size_t size = st.st_size;
+        void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (data == MAP_FAILED) {
+            // Fall back to a heap copy
+            size_t length = 0;
+            unsigned char* bytes = bytesFromFileSystem(_path, length);
+            if (!bytes) { return {}; }
+            return MappedFile(reinterpret_cast<const char*>(bytes), length,
+                              [](const char* _data, size_t) {
+                                  free(const_cast<char*>(_data));
+                              });
+        }
+
+        return MappedFile(static_cast<const char*>(data), size,
+                          [](const char* _data, size_t _size) {
+                              munmap(const_cast<char*>(_data), _size);
+                          });
+    }
+
+    // See bytesFromFile
+    if (len >= 2 && (_path[0] == '.') && (_path[1] == '/')) { _path += 2; }
+
+    // For uncompressed assets the buffer is the mmap'd apk entry itself;
+    // the view keeps the asset open until it is dropped.
+    AAsset* asset = AAssetManager_open(assetManager, _path, AASSET_MODE_BUFFER);
+    if (asset == nullptr) {
+        logMsg("Failed to open asset at path: %s\n", _path);
+        return {};
+    }
+
+    const void* buffer = AAsset_getBuffer(asset);
+    off_t size = AAsset_getLength(asset);
+    if (buffer == nullptr || size <= 0) {
+        AAsset_close(asset);
+        return {};
+    }
+
+    return MappedFile(static_cast<const char*>(buffer), size,
+                      [asset](const char*, size_t) { AAsset_close(asset); });
+}
+
 unsigned char* bytesFromFile(const char* _path, size_t& _size) {
 
     size_t len = strlen(_path);
@@ -277,11 +350,34 @@ bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
     return methodResult;
 }
 
+bool startUrlRequest(const std::string& _url, UrlChunkCallback _onChunk, UrlCallback _callback) {
+
+    // The Java networking stack hands over complete responses only, so the
+    // body is delivered as a single chunk before the completion callback.
+    return startUrlRequest(_url, [_onChunk, _callback](std::vector<char>&& _data) {
+        if (_onChunk && !_data.empty()) { _onChunk(_data.data(), _data.size()); }
+        _callback(std::move(_data));
+    });
+}
+
+bool startUrlRequest(const std::string& _url, const std::string& _etag, UrlValidateCallback _callback) {
+
+    // No conditional request support here yet - revalidation falls back to
+    // a full fetch without a response validator.
+    return startUrlRequest(_url, [_callback](std::vector<char>&& _data) {
+        _callback(std::move(_data), std::string(), false);
+    });
+}
+
 void cancelUrlRequest(const std::string& _url) {
     jstring jUrl = jniRenderThreadEnv->NewStringUTF(_url.c_str());
     jniRenderThreadEnv->CallVoidMethod(tangramInstance, cancelUrlRequestMID, jUrl);
 }
 
+void prewarmUrlHost(const std::string& _url) {
+    // Connection pooling is managed by the HTTP client on the Java side
+}
+
 void onUrlSuccess(JNIEnv* _jniEnv, jbyteArray _jBytes, jlong _jCallbackPtr) {
 
     size_t length = _jniEnv->GetArrayLength(_jBytes);
@@ -332,6 +428,14 @@ void initGLExtensions() {
     glBindVertexArrayOESEXT = (PFNGLBINDVERTEXARRAYOESPROC) dlsym(libhandle, "glBindVertexArrayOES");
     glDeleteVertexArraysOESEXT = (PFNGLDELETEVERTEXARRAYSOESPROC) dlsym(libhandle, "glDeleteVertexArraysOES");
     glGenVertexArraysOESEXT = (PFNGLGENVERTEXARRAYSOESPROC) dlsym(libhandle, "glGenVertexArraysOES");
+    glGetProgramBinaryOESEXT = (PFNGLGETPROGRAMBINARYOESPROC) dlsym(libhandle, "glGetProgramBinaryOES");
+    glProgramBinaryOESEXT = (PFNGLPROGRAMBINARYOESPROC) dlsym(libhandle, "glProgramBinaryOES");
+    glGenQueriesEXTEXT = (PFNGLGENQUERIESEXTPROC) dlsym(libhandle, "glGenQueriesEXT");
+    glDeleteQueriesEXTEXT = (PFNGLDELETEQUERIESEXTPROC) dlsym(libhandle, "glDeleteQueriesEXT");
+    glBeginQueryEXTEXT = (PFNGLBEGINQUERYEXTPROC) dlsym(libhandle, "glBeginQueryEXT");
+    glEndQueryEXTEXT = (PFNGLENDQUERYEXTPROC) dlsym(libhandle, "glEndQueryEXT");
+    glGetQueryObjectuivEXTEXT = (PFNGLGETQUERYOBJECTUIVEXTPROC) dlsym(libhandle, "glGetQueryObjectuivEXT");
+    glDiscardFramebufferEXTEXT = (PFNGLDISCARDFRAMEBUFFEREXTPROC) dlsym(libhandle, "glDiscardFramebufferEXT");
 }
 
 std::string stringFromJString(JNIEnv* jniEnv, jstring string) {
@@ -703,6 +703,51 @@ public class MapController implements Renderer {
         nativeUseCachedGlState(mapPointer, use);
     }
 
+    /**
+     * Add a marker to the map; the marker is not drawn until styling and geometry are set, either
+     * with {@link #setMarkerStyling(long, String)} and a {@link MapUpdateBatch} or directly
+     * @return An identifier for the marker; 0 indicates an invalid marker
+     */
+    public long addMarker() {
+        checkPointer(mapPointer);
+        return nativeMarkerAdd(mapPointer);
+    }
+
+    /**
+     * Remove a marker from the map
+     * @param markerId The marker to remove, as returned by {@link #addMarker()}
+     * @return True if the marker was found and removed
+     */
+    public boolean removeMarker(long markerId) {
+        checkPointer(mapPointer);
+        return nativeMarkerRemove(mapPointer, markerId);
+    }
+
+    /**
+     * Set the styling for a marker
+     * @param markerId The marker to update
+     * @param styling A string of YAML defining a 'draw rule' according to the scene file syntax
+     * @return True if the marker was found and updated
+     */
+    public boolean setMarkerStyling(long markerId, String styling) {
+        checkPointer(mapPointer);
+        return nativeMarkerSetStyling(mapPointer, markerId, styling);
+    }
+
+    /**
+     * Apply the commands queued in a {@link MapUpdateBatch} in one native call; runs of marker
+     * position updates are applied through the batched marker interface, so moving many markers
+     * per frame costs one JNI crossing instead of one per marker
+     * @param batch The batch of commands to apply; cleared for reuse after the call
+     */
+    public void applyUpdateBatch(MapUpdateBatch batch) {
+        checkPointer(mapPointer);
+        if (batch.count > 0) {
+            nativeApplyUpdateBatch(mapPointer, batch.count, batch.types, batch.ids, batch.args);
+            batch.clear();
+        }
+    }
+
 
     // Package private methods
     // =======================
@@ -780,6 +825,10 @@ public class MapController implements Renderer {
     private synchronized native void nativePickFeature(long mapPtr, float posX, float posY, FeaturePickListener listener);
     private synchronized native void nativeUseCachedGlState(long mapPtr, boolean use);
     private synchronized native void nativeCaptureSnapshot(long mapPtr, int[] buffer);
+    private synchronized native long nativeMarkerAdd(long mapPtr);
+    private synchronized native boolean nativeMarkerRemove(long mapPtr, long markerId);
+    private synchronized native boolean nativeMarkerSetStyling(long mapPtr, long markerId, String styling);
+    private synchronized native void nativeApplyUpdateBatch(long mapPtr, int count, int[] types, long[] ids, double[] args);
 
     private native void nativeOnUrlSuccess(byte[] rawDataBytes, long callbackPtr);
     private native void nativeOnUrlFailure(long callbackPtr);
@@ -0,0 +1,160 @@
+package com.mapzen.tangram;
+
+import com.mapzen.tangram.MapController.EaseType;
+
+/**
+ * {@code MapUpdateBatch} collects marker and camera mutations into flat arrays so that many
+ * updates cross the JNI boundary in a single call to
+ * {@link MapController#applyUpdateBatch(MapUpdateBatch)}. Moving hundreds of markers per frame
+ * one native call at a time spends more time crossing JNI than updating the map; a batch makes
+ * that cost per call instead of per marker. Batches can be reused: fill, apply, {@link #clear()}.
+ */
+public class MapUpdateBatch {
+
+    // Command codes; must match the decoder in jniExports.cpp
+    static final int MARKER_SET_POINT = 0;
+    static final int MARKER_SET_POINT_EASED = 1;
+    static final int MARKER_SET_VISIBLE = 2;
+    static final int SET_POSITION = 3;
+    static final int SET_ZOOM = 4;
+    static final int SET_ROTATION = 5;
+    static final int SET_TILT = 6;
+
+    // Each command occupies one slot in 'types' and 'ids' and ARG_STRIDE slots in 'args'
+    static final int ARG_STRIDE = 4;
+
+    int count = 0;
+    int[] types;
+    long[] ids;
+    double[] args;
+
+    public MapUpdateBatch() {
+        this(64);
+    }
+
+    /**
+     * @param capacity Number of commands to allocate space for; the batch grows as needed
+     */
+    public MapUpdateBatch(int capacity) {
+        types = new int[capacity];
+        ids = new long[capacity];
+        args = new double[capacity * ARG_STRIDE];
+    }
+
+    /**
+     * Queue a change of the geometry of a point marker
+     * @param markerId The marker to update, as returned by {@link MapController#addMarker()}
+     * @param point The new coordinates of the marker
+     * @return This batch, for call chaining
+     */
+    public MapUpdateBatch setMarkerPoint(long markerId, LngLat point) {
+        int i = add(MARKER_SET_POINT, markerId);
+        args[i] = point.longitude;
+        args[i + 1] = point.latitude;
+        return this;
+    }
+
+    /**
+     * Queue an eased change of the geometry of a point marker
+     * @param markerId The marker to update
+     * @param point The new coordinates of the marker
+     * @param duration Time in seconds to ease to the new position
+     * @param ease Type of easing to use
+     * @return This batch, for call chaining
+     */
+    public MapUpdateBatch setMarkerPointEased(long markerId, LngLat point, float duration, EaseType ease) {
+        int i = add(MARKER_SET_POINT_EASED, markerId);
+        args[i] = point.longitude;
+        args[i + 1] = point.latitude;
+        args[i + 2] = duration;
+        args[i + 3] = ease.ordinal();
+        return this;
+    }
+
+    /**
+     * Queue a change of the visibility of a marker
+     * @param markerId The marker to update
+     * @param visible Whether the marker should be drawn
+     * @return This batch, for call chaining
+     */
+    public MapUpdateBatch setMarkerVisible(long markerId, boolean visible) {
+        int i = add(MARKER_SET_VISIBLE, markerId);
+        args[i] = visible ? 1 : 0;
+        return this;
+    }
+
+    /**
+     * Queue a change of the geographic position of the center of the map view
+     * @param position The new position of the map center
+     * @return This batch, for call chaining
+     */
+    public MapUpdateBatch setPosition(LngLat position) {
+        int i = add(SET_POSITION, 0);
+        args[i] = position.longitude;
+        args[i + 1] = position.latitude;
+        return this;
+    }
+
+    /**
+     * Queue a change of the zoom level of the map view
+     * @param zoom The new zoom level
+     * @return This batch, for call chaining
+     */
+    public MapUpdateBatch setZoom(float zoom) {
+        int i = add(SET_ZOOM, 0);
+        args[i] = zoom;
+        return this;
+    }
+
+    /**
+     * Queue a change of the counter-clockwise rotation of the map view
+     * @param rotation The new rotation in radians
+     * @return This batch, for call chaining
+     */
+    public MapUpdateBatch setRotation(float rotation) {
+        int i = add(SET_ROTATION, 0);
+        args[i] = rotation;
+        return this;
+    }
+
+    /**
+     * Queue a change of the tilt angle of the map view
+     * @param tilt The new tilt in radians
+     * @return This batch, for call chaining
+     */
+    public MapUpdateBatch setTilt(float tilt) {
+        int i = add(SET_TILT, 0);
+        args[i] = tilt;
+        return this;
+    }
+
+    /**
+     * Remove all queued commands, keeping the allocated arrays for reuse
+     */
+    public void clear() {
+        count = 0;
+    }
+
+    private int add(int type, long id) {
+        if (count == types.length) {
+            grow();
+        }
+        types[count] = type;
+        ids[count] = id;
+        return count++ * ARG_STRIDE;
+    }
+
+    private void grow() {
+        int capacity = types.length * 2;
+        int[] newTypes = new int[capacity];
+        long[] newIds = new long[capacity];
+        double[] newArgs = new double[capacity * ARG_STRIDE];
+        System.arraycopy(types, 0, newTypes, 0, count);
+        System.arraycopy(ids, 0, newIds, 0, count);
+        System.arraycopy(args, 0, newArgs, 0, count * ARG_STRIDE);
+        types = newTypes;
+        ids = newIds;
+        args = newArgs;
+    }
+
+}
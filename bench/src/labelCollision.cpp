@@ -0,0 +1,183 @@
+#include "tangram.h"
+#include "platform.h"
+#include "log.h"
+#include "labels/labelCollider.h"
+#include "labels/labels.h"
+#include "labels/labelSet.h"
+#include "labels/textLabel.h"
+#include "labels/textLabels.h"
+#include "style/style.h"
+#include "style/textStyle.h"
+#include "marker/marker.h"
+#include "tile/tile.h"
+#include "tile/tileCache.h"
+#include "view/view.h"
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+/* Label collision benchmarks.
+ *
+ * Builds synthetic label sets at the density given by the benchmark
+ * argument and measures the two collision paths separately: the
+ * tile-build pass (LabelCollider::process) and the per-frame occlusion
+ * solve (Labels::handleOcclusions), including its carried-over solve
+ * for unchanged views. Label positions come from a fixed LCG so runs
+ * are comparable.
+ */
+
+using namespace Tangram;
+
+namespace {
+
+TextStyle dummyStyle("textStyle", nullptr);
+TextLabels dummyTextLabels(dummyStyle);
+
+// Deterministic positions in tile-local coordinates
+struct Lcg {
+    uint32_t state = 12345;
+    float next() {
+        state = state * 1664525 + 1013904223;
+        return (state >> 8) / float(1 << 24);
+    }
+};
+
+std::unique_ptr<TextLabel> makeLabel(glm::vec2 _transform, size_t _n) {
+    Label::Options options;
+    options.offset = {0.0f, 0.0f};
+    options.anchors.anchor[0] = LabelProperty::Anchor::center;
+    options.anchors.count = 1;
+    // Mixed priorities and repeat groups exercise the sort and the
+    // repeat-distance pass
+    options.priority = _n % 10;
+    options.repeatGroup = _n % 4;
+    options.repeatDistance = 32.f;
+
+    return std::unique_ptr<TextLabel>(
+            new TextLabel({glm::vec3(_transform, 0)}, Label::Type::point, options,
+                          {}, {10, 10}, dummyTextLabels, {},
+                          TextLabelProperty::Align::none));
+}
+
+std::vector<std::unique_ptr<Label>> makeLabels(size_t _count) {
+    Lcg lcg;
+    std::vector<std::unique_ptr<Label>> labels;
+    labels.reserve(_count);
+    for (size_t i = 0; i < _count; i++) {
+        labels.push_back(makeLabel({lcg.next(), lcg.next()}, i));
+    }
+    return labels;
+}
+
+struct TestLabelMesh : public LabelSet {
+    void setLabels(std::vector<std::unique_ptr<Label>>&& _labels) {
+        m_labels = std::move(_labels);
+    }
+};
+
+// Shared scaffolding for the per-frame occlusion benchmarks: one tile
+// holding the synthetic label set, viewed by a tilted camera.
+struct OcclusionContext {
+
+    View view{ 1024, 1024 };
+    std::unique_ptr<Labels> labels = std::make_unique<Labels>();
+    std::vector<std::unique_ptr<Style>> styles;
+    std::vector<std::shared_ptr<Tile>> tiles;
+    std::vector<std::unique_ptr<Marker>> markers;
+    std::unique_ptr<TileCache> cache = std::make_unique<TileCache>(0);
+
+    void setup(size_t _count) {
+        view.setPosition(0, 0);
+        view.setZoom(0);
+        view.update(false);
+
+        auto mesh = std::make_unique<TestLabelMesh>();
+        mesh->setLabels(makeLabels(_count));
+
+        auto style = std::make_unique<TextStyle>("test", nullptr, false);
+        style->setID(0);
+
+        auto tile = std::make_shared<Tile>(TileID{0, 0, 0}, view.getMapProjection());
+        tile->initGeometry(1);
+        tile->setMesh(*style, std::move(mesh));
+        tile->update(0, view);
+
+        styles.push_back(std::move(style));
+        tiles.push_back(std::move(tile));
+
+        // Sizes the broadphase grid for the viewport
+        labels->updateLabelSet(view.state(), 0, styles, tiles, markers, *cache);
+    }
+
+    void applyView(float _pitch) {
+        view.setPitch(_pitch);
+        view.update(false);
+        tiles[0]->update(0, view);
+    }
+};
+
+}
+
+static void BM_LabelColliderProcess(benchmark::State& st) {
+
+    LabelCollider collider;
+
+    while (st.KeepRunning()) {
+        st.PauseTiming();
+        auto labels = makeLabels(st.range_x());
+        st.ResumeTiming();
+
+        collider.addLabels(labels);
+        collider.process({0, 0, 0}, 1.f, 256.f);
+    }
+
+    st.SetItemsProcessed(st.iterations() * st.range_x());
+}
+BENCHMARK(BM_LabelColliderProcess)->Arg(128)->Arg(512)->Arg(2048);
+
+static void BM_LabelsHandleOcclusions(benchmark::State& st) {
+
+    OcclusionContext ctx;
+    ctx.setup(st.range_x());
+
+    // Alternate the tilt so label boxes move non-uniformly between
+    // iterations, forcing a full solve every time
+    float pitch = 0.f;
+
+    while (st.KeepRunning()) {
+        st.PauseTiming();
+        pitch = (pitch == 0.f) ? 0.4f : 0.f;
+        ctx.applyView(pitch);
+        ctx.labels->updateLabels(ctx.view.state(), 0, ctx.styles, ctx.tiles, ctx.markers, false);
+        st.ResumeTiming();
+
+        ctx.labels->handleOcclusions(ctx.view.state());
+    }
+
+    st.SetItemsProcessed(st.iterations() * st.range_x());
+}
+BENCHMARK(BM_LabelsHandleOcclusions)->Arg(128)->Arg(512)->Arg(2048);
+
+static void BM_LabelsHandleOcclusionsReuse(benchmark::State& st) {
+
+    OcclusionContext ctx;
+    ctx.setup(st.range_x());
+
+    // Static view: after the first solve every iteration takes the
+    // carried-over path
+    while (st.KeepRunning()) {
+        st.PauseTiming();
+        ctx.labels->updateLabels(ctx.view.state(), 0, ctx.styles, ctx.tiles, ctx.markers, false);
+        st.ResumeTiming();
+
+        ctx.labels->handleOcclusions(ctx.view.state());
+    }
+
+    st.SetItemsProcessed(st.iterations() * st.range_x());
+}
+BENCHMARK(BM_LabelsHandleOcclusionsReuse)->Arg(512)->Arg(2048);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,116 @@
+#include "tangram.h"
+#include "debug/sessionRecorder.h"
+#include "log.h"
+
+#include <cstdlib>
+#include <sstream>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+#define FRAME_STEP (1.f / 60.f)
+
+// Replays a recorded interaction session (see debug/sessionRecorder.h)
+// against a headless Map on a fixed-step clock. Point TANGRAM_SESSION at a
+// file written by Map::stopSessionRecording to benchmark a real user
+// session; without it a built-in scripted session of pans, pinches and
+// rotations is used. For byte-identical tile data across builds attach a
+// warmed DataSource disk cache - with the mock platform no tiles load and
+// the bench covers the view, camera and label update path.
+
+namespace {
+
+std::string scriptedSession() {
+
+    std::stringstream session;
+    float t = 0.f;
+
+    session << t << " setPosition -74.00976419 40.70532700\n";
+    session << t << " setZoom 16\n";
+
+    // Pan across the viewport in small per-frame increments
+    for (int i = 0; i < 120; i++) {
+        t += FRAME_STEP;
+        session << t << " panGesture 512 384 " << (512 - 4) << ' ' << (384 - 2) << '\n';
+    }
+
+    // Pinch out, then rotate and tilt around the new position
+    for (int i = 0; i < 60; i++) {
+        t += FRAME_STEP;
+        session << t << " pinchGesture 512 384 1.01 0\n";
+    }
+    for (int i = 0; i < 60; i++) {
+        t += FRAME_STEP;
+        session << t << " rotateGesture 512 384 0.01\n";
+    }
+    for (int i = 0; i < 60; i++) {
+        t += FRAME_STEP;
+        session << t << " shoveGesture -1\n";
+    }
+
+    // Coast on a fling, then jump back to the start
+    t += FRAME_STEP;
+    session << t << " flingGesture 512 384 800 200\n";
+    t += 2.f;
+    session << t << " setPosition -74.00976419 40.70532700\n";
+    session << t << " setZoom 16\n";
+
+    return session.str();
+}
+
+struct ReplayContext {
+
+    std::unique_ptr<Map> map;
+    SessionReplay replay;
+
+    void setup() {
+        if (map) { return; }
+
+        map = std::make_unique<Map>();
+        map->loadScene("scene.yaml");
+        map->resize(1024, 768);
+        map->update(0.f);
+
+        const char* path = getenv("TANGRAM_SESSION");
+        if (!path || !replay.load(path)) {
+            replay.parse(scriptedSession());
+        }
+    }
+};
+
+ReplayContext ctx;
+
+}
+
+static void BM_SessionReplay(benchmark::State& state) {
+    ctx.setup();
+
+    size_t frames = 0;
+
+    while (state.KeepRunning()) {
+        ctx.replay.reset();
+
+        // Run the session to exhaustion on a fixed-step clock, plus one
+        // trailing second so eased and fling animations settle.
+        float trailing = 1.f;
+        bool more = true;
+        while (more || (trailing -= FRAME_STEP) > 0.f) {
+            more = ctx.replay.step(*ctx.map, FRAME_STEP);
+            ctx.map->update(FRAME_STEP);
+            frames++;
+        }
+    }
+
+    state.SetItemsProcessed(frames);
+
+    char label[64];
+    snprintf(label, sizeof(label), "events=%zu duration=%.1fs",
+             ctx.replay.eventCount(), double(ctx.replay.duration()));
+    state.SetLabel(label);
+}
+
+BENCHMARK(BM_SessionReplay);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,290 @@
+#include "tangram.h"
+#include "gl.h"
+#include "platform.h"
+#include "log.h"
+#include "data/dataSource.h"
+#include "scene/sceneLoader.h"
+#include "scene/scene.h"
+#include "scene/dataLayer.h"
+#include "style/style.h"
+#include "scene/styleContext.h"
+#include "scene/drawRule.h"
+#include "labels/labelCollider.h"
+#include "util/mapProjection.h"
+#include "tile/tile.h"
+#include "tile/tileBuilder.h"
+#include "tile/tileTask.h"
+#include "text/fontContext.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+/* Corpus replay benchmark with per-stage breakdown.
+ *
+ * Replays a directory of recorded MVT tiles against scene.yaml and times
+ * the build stages separately - parse, filter/rule match, tessellation
+ * and label build - so a regression can be attributed to a stage before
+ * bisecting. The corpus directory is taken from the TANGRAM_TILE_CORPUS
+ * environment variable (default "corpus"); tile coordinates are read
+ * from file names of the form "z-x-y.mvt" or "z_x_y.mvt". Without a
+ * corpus the single recorded tile used by tileLoading is replayed.
+ *
+ * The stages mirror TileBuilder::build but run through the same public
+ * entry points it uses, so the per-stage sums track the production path.
+ */
+
+using namespace Tangram;
+
+namespace {
+
+double msSince(const std::chrono::steady_clock::time_point& _start) {
+    return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - _start).count();
+}
+
+struct CorpusTile {
+    TileID id = { 0, 0, 10, 10, 0 };
+    std::vector<char> rawData;
+};
+
+struct StageTimes {
+    double parse = 0;
+    double filter = 0;
+    double tessellation = 0;
+    double labels = 0;
+};
+
+struct CorpusContext {
+
+    MercatorProjection projection;
+
+    std::shared_ptr<Scene> scene;
+    std::shared_ptr<DataSource> source;
+
+    StyleContext styleContext;
+    DrawRuleMergeSet ruleSet;
+    LabelCollider labelLayout;
+    fastmap<std::string, std::unique_ptr<StyleBuilder>> styleBuilders;
+
+    std::vector<CorpusTile> tiles;
+
+    void loadScene(const char* sceneFile) {
+        scene = std::make_shared<Scene>(sceneFile);
+        auto sceneString = stringFromFile(sceneFile);
+
+        YAML::Node sceneNode;
+
+        try { sceneNode = YAML::Load(sceneString); }
+        catch (YAML::ParserException e) {
+            LOGE("Parsing scene config '%s'", e.what());
+            return;
+        }
+        SceneLoader::applyConfig(sceneNode, scene);
+
+        scene->fontContext()->loadFonts();
+
+        styleContext.initFunctions(*scene);
+
+        for (auto& style : scene->styles()) {
+            styleBuilders[style->getName()] = style->createBuilder();
+        }
+
+        source = *scene->dataSources().begin();
+    }
+
+    bool loadTileFile(const std::string& path, const TileID& id) {
+        std::ifstream resource(path, std::ifstream::ate | std::ifstream::binary);
+        if (!resource.is_open()) {
+            LOGE("Failed to read file at path: %s", path.c_str());
+            return false;
+        }
+
+        CorpusTile entry;
+        entry.id = id;
+
+        size_t size = resource.tellg();
+        resource.seekg(std::ifstream::beg);
+
+        entry.rawData.resize(size);
+        resource.read(&entry.rawData[0], size);
+        resource.close();
+
+        tiles.push_back(std::move(entry));
+        return true;
+    }
+
+    void loadCorpus() {
+
+        const char* corpusDir = getenv("TANGRAM_TILE_CORPUS");
+        if (!corpusDir) { corpusDir = "corpus"; }
+
+        if (DIR* dir = opendir(corpusDir)) {
+            while (struct dirent* entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (name.size() < 5 ||
+                    name.compare(name.size() - 4, 4, ".mvt") != 0) {
+                    continue;
+                }
+
+                int z = 0, x = 0, y = 0;
+                if (sscanf(name.c_str(), "%d%*[-_]%d%*[-_]%d", &z, &x, &y) != 3) {
+                    LOGW("Skipping corpus file without z-x-y name: %s", name.c_str());
+                    continue;
+                }
+
+                TileID id(x, y, z, z, 0);
+                loadTileFile(std::string(corpusDir) + "/" + name, id);
+            }
+            closedir(dir);
+        }
+
+        if (tiles.empty()) {
+            LOGW("No corpus at '%s', replaying single recorded tile", corpusDir);
+            loadTileFile("tile.mvt", { 0, 0, 10, 10, 0 });
+        }
+    }
+
+    // One staged tile build; mirrors TileBuilder::build with a stopwatch
+    // around each stage.
+    size_t buildStaged(const CorpusTile& _corpusTile, StageTimes& _times) {
+
+        auto start = std::chrono::steady_clock::now();
+
+        auto task = source->createTask(_corpusTile.id);
+        auto& downloadTask = dynamic_cast<DownloadTileTask&>(*task);
+        downloadTask.rawTileData = std::make_shared<std::vector<char>>(_corpusTile.rawData);
+
+        auto tileData = source->parse(*task, projection);
+
+        _times.parse += msSince(start);
+
+        if (!tileData) { return 0; }
+
+        Tile tile(_corpusTile.id, projection);
+        tile.initGeometry(scene->styles().size());
+
+        float tileSize = scene->mapProjection()->TileSize() * scene->pixelScale();
+
+        styleContext.setKeywordZoom(_corpusTile.id.s);
+        ruleSet.clearCache();
+
+        for (auto& builder : styleBuilders) {
+            builder.second->setup(tile);
+        }
+
+        size_t features = 0;
+
+        for (const auto& datalayer : scene->layers()) {
+
+            if (datalayer.source() != source->name()) { continue; }
+            if (!datalayer.bounds().matchZoom(_corpusTile.id.s)) { continue; }
+
+            for (const auto& collection : tileData->layers) {
+
+                if (!collection.name.empty()) {
+                    const auto& dlc = datalayer.collections();
+                    if (std::find(dlc.begin(), dlc.end(), collection.name) == dlc.end()) {
+                        continue;
+                    }
+                }
+
+                for (const auto& feat : collection.features) {
+
+                    features++;
+
+                    start = std::chrono::steady_clock::now();
+                    bool matched = ruleSet.match(feat, datalayer, styleContext);
+                    _times.filter += msSince(start);
+
+                    if (!matched) { continue; }
+
+                    for (auto& rule : ruleSet.matchedRules()) {
+
+                        start = std::chrono::steady_clock::now();
+                        bool valid = ruleSet.evaluateRuleForContext(rule, styleContext);
+                        _times.filter += msSince(start);
+
+                        if (!valid) { continue; }
+
+                        auto it = styleBuilders.find(rule.getStyleName());
+                        if (it == styleBuilders.end()) { continue; }
+
+                        start = std::chrono::steady_clock::now();
+                        it->second->addFeature(feat, rule);
+                        _times.tessellation += msSince(start);
+                    }
+                }
+            }
+        }
+
+        start = std::chrono::steady_clock::now();
+        for (auto& builder : styleBuilders) {
+            builder.second->addLayoutItems(labelLayout);
+        }
+        labelLayout.process(_corpusTile.id, tile.getInverseScale(), tileSize);
+        _times.labels += msSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (auto& builder : styleBuilders) {
+            tile.setMesh(builder.second->style(), builder.second->build());
+        }
+        _times.tessellation += msSince(start);
+
+        return features;
+    }
+};
+
+}
+
+class TileCorpusFixture : public benchmark::Fixture {
+public:
+    CorpusContext ctx;
+
+    void SetUp() override {
+        ctx.loadScene("scene.yaml");
+        ctx.loadCorpus();
+        LOG("Corpus ready: %d tiles", int(ctx.tiles.size()));
+    }
+};
+
+BENCHMARK_DEFINE_F(TileCorpusFixture, CorpusBuild)(benchmark::State& st) {
+
+    StageTimes times;
+    size_t features = 0;
+    size_t iterations = 0;
+
+    while (st.KeepRunning()) {
+        for (const auto& tile : ctx.tiles) {
+            features += ctx.buildStaged(tile, times);
+        }
+        iterations++;
+    }
+
+    if (iterations > 0) {
+        // Per-iteration stage breakdown; one iteration replays the corpus.
+        char label[256];
+        snprintf(label, sizeof(label),
+                 "tiles=%zu parse=%.2fms filter=%.2fms tessellation=%.2fms labels=%.2fms",
+                 ctx.tiles.size(),
+                 times.parse / iterations,
+                 times.filter / iterations,
+                 times.tessellation / iterations,
+                 times.labels / iterations);
+        st.SetLabel(label);
+    }
+
+    st.SetItemsProcessed(features);
+}
+
+BENCHMARK_REGISTER_F(TileCorpusFixture, CorpusBuild);
+
+BENCHMARK_MAIN();
@@ -121,12 +121,23 @@ GLint GL::getUniformLocation(GLuint program, const GLchar *name) {
 GLint GL::getAttribLocation(GLuint program, const GLchar *name) {
     return GL_CHECK(glGetAttribLocation(program, name));
 }
+void GL::bindAttribLocation(GLuint program, GLuint index, const GLchar *name) {
+    GL_CHECK(glBindAttribLocation(program, index, name));
+}
 void GL::getProgramiv(GLuint program, GLenum pname, GLint *params) {
     GL_CHECK(glGetProgramiv(program,pname,params));
 }
 void GL::getShaderiv(GLuint shader, GLenum pname, GLint *params) {
     GL_CHECK(glGetShaderiv(shader,pname, params));
 }
+void GL::getProgramBinary(GLuint program, GLsizei bufSize, GLsizei *length,
+                          GLenum *binaryFormat, void *binary) {
+    GL_CHECK(glGetProgramBinary(program, bufSize, length, binaryFormat, binary));
+}
+void GL::programBinary(GLuint program, GLenum binaryFormat,
+                       const void *binary, GLsizei length) {
+    GL_CHECK(glProgramBinary(program, binaryFormat, binary, length));
+}
 
 // Buffers
 void GL::bindBuffer(GLenum target, GLuint buffer) {
@@ -149,6 +160,29 @@ void GL::readPixels(GLint x, GLint y, GLsizei width, GLsizei height,
     GL_CHECK(glReadPixels(x, y, width, height, format, type, pixels));
 }
 
+// Framebuffer
+void GL::genFramebuffers(GLsizei n, GLuint *framebuffers) {
+    GL_CHECK(glGenFramebuffers(n, framebuffers));
+}
+void GL::deleteFramebuffers(GLsizei n, const GLuint *framebuffers) {
+    GL_CHECK(glDeleteFramebuffers(n, framebuffers));
+}
+void GL::bindFramebuffer(GLenum target, GLuint framebuffer) {
+    GL_CHECK(glBindFramebuffer(target, framebuffer));
+}
+void GL::framebufferTexture2D(GLenum target, GLenum attachment,
+                              GLenum textarget, GLuint texture, GLint level) {
+    GL_CHECK(glFramebufferTexture2D(target, attachment, textarget, texture, level));
+}
+GLenum GL::checkFramebufferStatus(GLenum target) {
+    GLenum status = glCheckFramebufferStatus(target);
+    GL_CHECK();
+    return status;
+}
+void GL::discardFramebuffer(GLenum target, GLsizei numAttachments, const GLenum *attachments) {
+    GL_CHECK(glDiscardFramebufferEXT(target, numAttachments, attachments));
+}
+
 // Texture
 void GL::bindTexture(GLenum target, GLuint texture ) {
     GL_CHECK(glBindTexture(target, texture ));
@@ -282,4 +316,21 @@ void GL::deleteVertexArrays(GLsizei n, const GLuint *arrays) {
 void GL::genVertexArrays(GLsizei n, GLuint *arrays) {
     GL_CHECK(glGenVertexArrays(n, arrays));
 }
+
+// timer queries
+void GL::genQueries(GLsizei n, GLuint *queries) {
+    GL_CHECK(glGenQueries(n, queries));
+}
+void GL::deleteQueries(GLsizei n, const GLuint *queries) {
+    GL_CHECK(glDeleteQueries(n, queries));
+}
+void GL::beginQuery(GLenum target, GLuint query) {
+    GL_CHECK(glBeginQuery(target, query));
+}
+void GL::endQuery(GLenum target) {
+    GL_CHECK(glEndQuery(target));
+}
+void GL::getQueryObjectuiv(GLuint query, GLenum pname, GLuint *params) {
+    GL_CHECK(glGetQueryObjectuiv(query, pname, params));
+}
 }
@@ -13,10 +13,26 @@
 extern PFNGLBINDVERTEXARRAYOESPROC glBindVertexArrayOESEXT;
 extern PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT;
 extern PFNGLGENVERTEXARRAYSOESPROC glGenVertexArraysOESEXT;
+extern PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinaryOESEXT;
+extern PFNGLPROGRAMBINARYOESPROC glProgramBinaryOESEXT;
+extern PFNGLGENQUERIESEXTPROC glGenQueriesEXTEXT;
+extern PFNGLDELETEQUERIESEXTPROC glDeleteQueriesEXTEXT;
+extern PFNGLBEGINQUERYEXTPROC glBeginQueryEXTEXT;
+extern PFNGLENDQUERYEXTPROC glEndQueryEXTEXT;
+extern PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuivEXTEXT;
+extern PFNGLDISCARDFRAMEBUFFEREXTPROC glDiscardFramebufferEXTEXT;
 
 #define glDeleteVertexArrays glDeleteVertexArraysOESEXT
 #define glGenVertexArrays glGenVertexArraysOESEXT
 #define glBindVertexArray glBindVertexArrayOESEXT
+#define glGetProgramBinary glGetProgramBinaryOESEXT
+#define glProgramBinary glProgramBinaryOESEXT
+#define glGenQueries glGenQueriesEXTEXT
+#define glDeleteQueries glDeleteQueriesEXTEXT
+#define glBeginQuery glBeginQueryEXTEXT
+#define glEndQuery glEndQueryEXTEXT
+#define glGetQueryObjectuiv glGetQueryObjectuivEXTEXT
+#define glDiscardFramebufferEXT glDiscardFramebufferEXTEXT
 #endif
 
 #ifdef PLATFORM_IOS
@@ -62,7 +78,78 @@ static void glGenVertexArrays(GLsizei n, GLuint *arrays) {}
 
 #endif
 
-#if defined(PLATFORM_ANDROID) || defined(PLATFORM_IOS) || defined(PLATFORM_RPI)
+#ifdef PLATFORM_HEADLESS
+//  Offscreen EGL context for CI performance runs, no window system
+//
+#include <GLES2/gl2platform.h>
+
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES 1
+#endif
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+// defined in platform_headless.cpp, resolved through eglGetProcAddress
+extern PFNGLBINDVERTEXARRAYOESPROC glBindVertexArrayOESEXT;
+extern PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT;
+extern PFNGLGENVERTEXARRAYSOESPROC glGenVertexArraysOESEXT;
+extern PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinaryOESEXT;
+extern PFNGLPROGRAMBINARYOESPROC glProgramBinaryOESEXT;
+extern PFNGLGENQUERIESEXTPROC glGenQueriesEXTEXT;
+extern PFNGLDELETEQUERIESEXTPROC glDeleteQueriesEXTEXT;
+extern PFNGLBEGINQUERYEXTPROC glBeginQueryEXTEXT;
+extern PFNGLENDQUERYEXTPROC glEndQueryEXTEXT;
+extern PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuivEXTEXT;
+extern PFNGLDISCARDFRAMEBUFFEREXTPROC glDiscardFramebufferEXTEXT;
+
+#define glDeleteVertexArrays glDeleteVertexArraysOESEXT
+#define glGenVertexArrays glGenVertexArraysOESEXT
+#define glBindVertexArray glBindVertexArrayOESEXT
+#define glGetProgramBinary glGetProgramBinaryOESEXT
+#define glProgramBinary glProgramBinaryOESEXT
+#define glGenQueries glGenQueriesEXTEXT
+#define glDeleteQueries glDeleteQueriesEXTEXT
+#define glBeginQuery glBeginQueryEXTEXT
+#define glEndQuery glEndQueryEXTEXT
+#define glGetQueryObjectuiv glGetQueryObjectuivEXTEXT
+#define glDiscardFramebufferEXT glDiscardFramebufferEXTEXT
+#endif
+
+#if defined(PLATFORM_ANDROID) || defined(PLATFORM_IOS) || defined(PLATFORM_RPI) || defined(PLATFORM_HEADLESS)
     #define glMapBuffer glMapBufferOES
     #define glUnmapBuffer glUnmapBufferOES
 #endif
+
+#if defined(PLATFORM_IOS) || defined(PLATFORM_OSX) || defined(PLATFORM_RPI)
+// Dummy program binary functions - the get_program_binary extension is
+// never advertised on these platforms, so they are not reached
+static void glGetProgramBinaryDummy(GLuint, GLsizei, GLsizei*, GLenum*, void*) {}
+static void glProgramBinaryDummy(GLuint, GLenum, const void*, GLsizei) {}
+
+#define glGetProgramBinary glGetProgramBinaryDummy
+#define glProgramBinary glProgramBinaryDummy
+#endif
+
+#if defined(PLATFORM_IOS) || defined(PLATFORM_RPI)
+// Dummy timer query functions - no timer_query extension is advertised
+// on these platforms, so they are not reached
+static void glGenQueriesDummy(GLsizei, GLuint*) {}
+static void glDeleteQueriesDummy(GLsizei, const GLuint*) {}
+static void glBeginQueryDummy(GLenum, GLuint) {}
+static void glEndQueryDummy(GLenum) {}
+static void glGetQueryObjectuivDummy(GLuint, GLenum, GLuint*) {}
+
+#define glGenQueries glGenQueriesDummy
+#define glDeleteQueries glDeleteQueriesDummy
+#define glBeginQuery glBeginQueryDummy
+#define glEndQuery glEndQueryDummy
+#define glGetQueryObjectuiv glGetQueryObjectuivDummy
+#endif
+
+#if defined(PLATFORM_OSX) || defined(PLATFORM_LINUX) || defined(PLATFORM_RPI)
+// Dummy discard function - the discard_framebuffer extension is only
+// found on mobile GLES drivers, so it is not reached on these platforms
+static void glDiscardFramebufferDummy(GLenum, GLsizei, const GLenum*) {}
+
+#define glDiscardFramebufferEXT glDiscardFramebufferDummy
+#endif
@@ -2,9 +2,9 @@
 precision mediump float;
 #endif
 
-uniform vec3 u_color;
+varying vec4 v_color;
 
 void main() {
-    gl_FragColor = vec4(u_color, 1.0);
+    gl_FragColor = v_color;
 }
 
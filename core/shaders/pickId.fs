@@ -0,0 +1,11 @@
+#ifdef GL_ES
+precision highp float;
+#endif
+
+uniform vec4 u_pick_color;
+
+void main() {
+
+    gl_FragColor = u_pick_color;
+
+}
@@ -0,0 +1,15 @@
+#ifdef GL_ES
+precision highp float;
+#endif
+
+uniform mat4 u_mvp;
+
+attribute vec4 a_position;
+
+// Positions in style meshes are packed as shorts; see polygon.vs/polyline.vs
+#define UNPACK_POSITION(x) (x / 8192.0)
+
+void main() {
+
+    gl_Position = u_mvp * vec4(UNPACK_POSITION(a_position.xyz), 1.0);
+}
@@ -19,7 +19,6 @@ uniform float u_device_pixel_ratio;
 #ifdef TANGRAM_TEXT
 uniform vec2 u_uv_scale_factor;
 uniform float u_max_stroke_width;
-uniform LOWP int u_pass;
 #endif
 
 #pragma tangram: uniforms
@@ -29,6 +28,8 @@ attribute LOWP float a_alpha;
 attribute LOWP vec4 a_color;
 #ifdef TANGRAM_TEXT
 attribute vec2 a_position;
+attribute vec2 a_screen_origin;
+attribute LOWP vec2 a_rotation;
 attribute LOWP vec4 a_stroke;
 attribute float a_scale;
 #else
@@ -38,7 +39,8 @@ attribute vec3 a_position;
 varying vec4 v_color;
 varying vec2 v_texcoords;
 #ifdef TANGRAM_TEXT
-varying float v_sdf_threshold;
+varying LOWP vec4 v_stroke_color;
+varying float v_stroke_threshold;
 varying float v_sdf_scale;
 #endif
 varying float v_alpha;
@@ -56,16 +58,23 @@ void main() {
 
 
 #ifdef TANGRAM_TEXT
-    vec2 vertex_pos = UNPACK_POSITION(a_position);
+    // a_position is the glyph corner in label-local space; rotate it by
+    // the label's rotation unit vector around the label screen origin.
+    // Matches rotateBy() in util/geom.h.
+    vec2 local_pos = UNPACK_POSITION(a_position);
+    vec2 vertex_pos = UNPACK_POSITION(a_screen_origin)
+        + vec2(local_pos.x * a_rotation.x + local_pos.y * a_rotation.y,
+               -local_pos.x * a_rotation.y + local_pos.y * a_rotation.x);
     v_texcoords = UNPACK_TEXTURE(a_uv);
     v_sdf_scale = a_scale / 64.0;
 
-    if (u_pass == 0) {
-        // fill
-        v_sdf_threshold = 0.5;
-        //v_alpha = 0.0;
-    } else if (a_stroke.a > 0.0) {
-        // stroke
+    // Fill and stroke are rendered in a single pass: the fill sits at the
+    // fixed 0.5 glyph threshold, the stroke extends it outwards by the
+    // stroke width. A stroke alpha of 0 disables the stroke entirely.
+    v_stroke_color = a_stroke;
+    v_stroke_threshold = 0.5;
+
+    if (a_stroke.a > 0.0) {
         // (0.5 / 3.0) <= sdf change by pixel distance to outline == 0.083
         float sdf_pixel = 0.5/u_max_stroke_width;
 
@@ -78,11 +87,7 @@ void main() {
         // scale sdf (texture is scaled depeding on font size)
         stroke_width /= v_sdf_scale;
 
-        v_sdf_threshold = max(0.5 - stroke_width, 0.0);
-
-        v_color.rgb = a_stroke.rgb;
-    } else {
-        v_alpha = 0.0;
+        v_stroke_threshold = max(0.5 - stroke_width, 0.0);
     }
 
     vec4 position = vec4(vertex_pos, 0.0, 1.0);
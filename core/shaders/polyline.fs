@@ -18,6 +18,7 @@ uniform float u_time;
 uniform float u_meters_per_pixel;
 uniform float u_device_pixel_ratio;
 uniform float u_texture_ratio;
+uniform vec2 u_texture_region;
 uniform sampler2D u_texture;
 
 #pragma tangram: uniforms
@@ -31,6 +32,10 @@ varying vec3 v_normal;
     varying vec2 v_texcoord;
 #endif
 
+#ifdef TANGRAM_LINE_FRAGMENT_ROUNDS
+    varying vec2 v_round;
+#endif
+
 #ifdef TANGRAM_LIGHTING_VERTEX
     varying vec4 v_lighting;
 #endif
@@ -57,6 +62,15 @@ void main(void) {
     // Initialize globals
     #pragma tangram: setup
 
+    #ifdef TANGRAM_LINE_FRAGMENT_ROUNDS
+        // Cap and join quads reach past the line ends; keep only the
+        // fragments within half a line width of their anchor point.
+        // Segment quads never exceed unit offset, so they pass whole.
+        if (dot(v_round, v_round) > 1.0001) {
+            discard;
+        }
+    #endif
+
     vec4 color = v_color;
     vec3 normal = v_normal;
 
@@ -65,7 +79,7 @@ void main(void) {
     #endif
 
     #ifdef TANGRAM_LINE_TEXTURE
-        vec2 line_st = vec2(v_texcoord.x, fract(v_texcoord.y / u_texture_ratio));
+        vec2 line_st = vec2(v_texcoord.x, u_texture_region.x + fract(v_texcoord.y / u_texture_ratio) * u_texture_region.y);
         vec4 line_color = texture2D(u_texture, line_st);
 
         if (line_color.a < TANGRAM_ALPHA_TEST) {
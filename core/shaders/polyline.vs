@@ -34,6 +34,10 @@ varying vec4 v_position;
 varying vec4 v_color;
 varying vec3 v_normal;
 
+#ifdef TANGRAM_LINE_FRAGMENT_ROUNDS
+    varying vec2 v_round;
+#endif
+
 #ifdef TANGRAM_LIGHTING_VERTEX
     varying vec4 v_lighting;
 #endif
@@ -106,6 +110,13 @@ void main() {
             v_texcoord.y /= 2. * extrude.z;
         #endif
 
+        #ifdef TANGRAM_LINE_FRAGMENT_ROUNDS
+            // Offset from the segment anchor in units of the half line
+            // width; the fragment shader carves round caps and joins
+            // from this
+            v_round = extrude.xy;
+        #endif
+
         position.xy += extrude.xy * width;
     }
 
@@ -17,13 +17,13 @@ uniform float u_time;
 uniform float u_meters_per_pixel;
 uniform float u_device_pixel_ratio;
 uniform float u_max_stroke_width;
-uniform LOWP int u_pass;
 
 #pragma tangram: uniforms
 
 varying vec4 v_color;
+varying LOWP vec4 v_stroke_color;
 varying vec2 v_texcoords;
-varying float v_sdf_threshold;
+varying float v_stroke_threshold;
 varying float v_alpha;
 varying float v_sdf_scale;
 
@@ -44,30 +44,36 @@ void main(void) {
     //   plus 0.25 for a bit of smoothness
     //
     //   ==> (0.5 / 3.0) * (0.5 + 0.25) == 0.1245
-    //   This value is added to sdf_threshold to antialias
+    //   This value is added to the thresholds to antialias
     //   the outline within one pixel for the *unscaled* glyph.
     //
     // - sdf_scale == fontScale / glyphScale:
     //   When the glyph is scaled down, 's' must be increased
-    //   (used to interpolate 1px of the scaled glyph around v_sdf_threshold)
+    //   (used to interpolate 1px of the scaled glyph around the threshold)
 
     float sdf_pixel = 0.5 / (u_max_stroke_width * v_sdf_scale);
     float add_smooth = 0.25;
     float filter_width = (sdf_pixel * (0.5 + add_smooth));
 
-    float start = max(v_sdf_threshold - filter_width, 0.0);
-    float end = v_sdf_threshold + filter_width;
+    // Fill coverage at the fixed 0.5 glyph threshold
+    float fill_alpha = smoothstep(max(0.5 - filter_width, 0.0), 0.5 + filter_width,
+                                  signed_distance);
+    float alpha = fill_alpha;
 
-    float alpha;
-
-    if (u_pass == 0) {
-        alpha = smoothstep(start, end, signed_distance);
-    } else {
+    if (v_stroke_color.a > 0.0) {
         // smooth the signed distance for outlines
         float signed_distance_1_over_2 = 1.0 / (2.0 * signed_distance);
         float smooth_signed_distance = pow(signed_distance, signed_distance_1_over_2);
 
-        alpha = smoothstep(start, end, smooth_signed_distance);
+        float start = max(v_stroke_threshold - filter_width, 0.0);
+        float end = v_stroke_threshold + filter_width;
+
+        float stroke_alpha = smoothstep(start, end, smooth_signed_distance);
+
+        // The stroke region encloses the fill, so its coverage bounds both;
+        // blend the fill over the stroke color by the fill coverage
+        alpha = max(stroke_alpha, fill_alpha);
+        color.rgb = mix(v_stroke_color.rgb, v_color.rgb, fill_alpha);
     }
 
     color.a *= v_alpha * alpha;
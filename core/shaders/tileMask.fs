@@ -0,0 +1,10 @@
+#ifdef GL_ES
+precision lowp float;
+#endif
+
+void main() {
+
+    // Color writes are masked off; only the stencil footprint matters.
+    gl_FragColor = vec4(0.0);
+
+}
@@ -6,12 +6,15 @@
 #include "platform.h"
 #include "tangram.h"
 #include "tile/tileTask.h"
+#include "util/frameScheduler.h"
 #include "util/geom.h"
 #include "data/propertyItem.h"
 #include "data/tileData.h"
+#include "log.h"
 #include "tile/tile.h"
 #include "view/view.h"
 
+#include <cmath>
 #include <regex>
 
 using namespace mapbox::util;
@@ -47,7 +50,8 @@ ClientGeoJsonSource::ClientGeoJsonSource(const std::string& _name, const std::st
             startUrlRequest(_url,
                     [&, this](std::vector<char>&& rawData) {
                         addData(std::string(rawData.begin(), rawData.end()));
-                        m_hasPendingData = false;
+                        // Runs after the ingestion task queued by addData
+                        m_worker.enqueue([this]() { m_hasPendingData = false; });
                     });
             m_hasPendingData = true;
         } else {
@@ -62,16 +66,49 @@ ClientGeoJsonSource::~ClientGeoJsonSource() {}
 
 void ClientGeoJsonSource::addData(const std::string& _data) {
 
-    auto features = geojsonvt::GeoJSONVT::convertFeatures(_data);
+    m_worker.enqueue([this, _data]() {
 
-    for (auto& f : features) {
-        m_features.push_back(std::move(f));
-    }
+        auto features = geojsonvt::GeoJSONVT::convertFeatures(_data);
+
+        for (auto& f : features) {
+            m_features.push_back(std::move(f));
+        }
+
+        rebuildStore(0.0, 0.0, 1.0, 1.0);
+    });
+}
+
+void ClientGeoJsonSource::rebuildStore(double _minX, double _minY, double _maxX, double _maxY) {
 
     std::lock_guard<std::mutex> lock(m_mutexStore);
-    m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
+
+    if (m_features.empty()) {
+        m_store.reset();
+    } else {
+        m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
+    }
+
+    // Drop parsed tiles whose extent intersects the dirty region; the
+    // remainder is still valid and re-served from the cache when the
+    // tiles reload for the new generation.
+    for (auto it = m_tileDataCache.begin(); it != m_tileDataCache.end();) {
+        const auto& id = it->first;
+        double size = 1.0 / (1 << id.z);
+        double x = id.x * size;
+        double y = id.y * size;
+
+        if (x <= _maxX && x + size >= _minX &&
+            y <= _maxY && y + size >= _minY) {
+            it = m_tileDataCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
     m_generation++;
 
+    // Wake the renderer so the tile manager picks up the new generation
+    FrameScheduler::requestFrame();
 }
 
 bool ClientGeoJsonSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
@@ -87,63 +124,310 @@ bool ClientGeoJsonSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTa
 
 void ClientGeoJsonSource::clearData() {
 
-    m_features.clear();
+    m_worker.enqueue([this]() {
+        m_features.clear();
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
-    m_store.reset();
-    m_generation++;
+        rebuildStore(0.0, 0.0, 1.0, 1.0);
+    });
 }
 
 void ClientGeoJsonSource::addPoint(const Properties& _tags, LngLat _point) {
 
-    auto container = geojsonvt::Convert::project({ geojsonvt::LonLat(_point.longitude, _point.latitude) }, tolerance);
+    auto tags = std::make_shared<Properties>(_tags);
 
-    geojsonvt::Tags tags;
+    m_worker.enqueue([this, tags, _point]() {
 
-    auto feature = geojsonvt::Convert::create(geojsonvt::Tags{std::make_shared<Properties>(_tags)},
-                                              geojsonvt::ProjectedFeatureType::Point,
-                                              container.members);
+        auto container = geojsonvt::Convert::project({ geojsonvt::LonLat(_point.longitude, _point.latitude) }, tolerance);
 
-    m_features.push_back(std::move(feature));
+        auto feature = geojsonvt::Convert::create(geojsonvt::Tags{tags},
+                                                  geojsonvt::ProjectedFeatureType::Point,
+                                                  container.members);
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
-    m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
-    m_generation++;
+        m_features.push_back(std::move(feature));
+
+        auto& f = m_features.back();
+        rebuildStore(f.min.x, f.min.y, f.max.x, f.max.y);
+    });
 }
 
 void ClientGeoJsonSource::addLine(const Properties& _tags, const Coordinates& _line) {
-    auto& line = reinterpret_cast<const std::vector<geojsonvt::LonLat>&>(_line);
 
-    std::vector<geojsonvt::ProjectedGeometry> geometry = { geojsonvt::Convert::project(line, tolerance) };
+    auto tags = std::make_shared<Properties>(_tags);
 
-    auto feature = geojsonvt::Convert::create(geojsonvt::Tags{std::make_shared<Properties>(_tags)},
-                                              geojsonvt::ProjectedFeatureType::LineString,
-                                              geometry);
+    m_worker.enqueue([this, tags, _line]() {
+        auto& line = reinterpret_cast<const std::vector<geojsonvt::LonLat>&>(_line);
 
-    m_features.push_back(std::move(feature));
+        std::vector<geojsonvt::ProjectedGeometry> geometry = { geojsonvt::Convert::project(line, tolerance) };
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
-    m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
-    m_generation++;
+        auto feature = geojsonvt::Convert::create(geojsonvt::Tags{tags},
+                                                  geojsonvt::ProjectedFeatureType::LineString,
+                                                  geometry);
+
+        m_features.push_back(std::move(feature));
+
+        auto& f = m_features.back();
+        rebuildStore(f.min.x, f.min.y, f.max.x, f.max.y);
+    });
 }
 
 void ClientGeoJsonSource::addPoly(const Properties& _tags, const std::vector<Coordinates>& _poly) {
 
-    geojsonvt::ProjectedGeometryContainer geometry;
-    for (auto& _ring : _poly) {
-        auto& ring = reinterpret_cast<const std::vector<geojsonvt::LonLat>&>(_ring);
-        geometry.members.push_back(geojsonvt::Convert::project(ring, tolerance));
+    auto tags = std::make_shared<Properties>(_tags);
+
+    m_worker.enqueue([this, tags, _poly]() {
+
+        geojsonvt::ProjectedGeometryContainer geometry;
+        for (auto& _ring : _poly) {
+            auto& ring = reinterpret_cast<const std::vector<geojsonvt::LonLat>&>(_ring);
+            geometry.members.push_back(geojsonvt::Convert::project(ring, tolerance));
+        }
+
+        auto feature = geojsonvt::Convert::create(geojsonvt::Tags{tags},
+                                                  geojsonvt::ProjectedFeatureType::Polygon,
+                                                  geometry);
+
+        m_features.push_back(std::move(feature));
+
+        auto& f = m_features.back();
+        rebuildStore(f.min.x, f.min.y, f.max.x, f.max.y);
+    });
+}
+
+void ClientGeoJsonSource::addPoints(const std::vector<Properties>& _tags,
+                                    const std::vector<LngLat>& _points) {
+
+    if (_points.empty()) { return; }
+    if (!_tags.empty() && _tags.size() != _points.size()) {
+        LOGW("Tag table size does not match feature count");
+        return;
     }
 
-    auto feature = geojsonvt::Convert::create(geojsonvt::Tags{std::make_shared<Properties>(_tags)},
-                                              geojsonvt::ProjectedFeatureType::Polygon,
-                                              geometry);
+    m_worker.enqueue([this, _tags, _points]() {
 
-    m_features.push_back(std::move(feature));
+        double minX = 1.0, minY = 1.0, maxX = 0.0, maxY = 0.0;
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
-    m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
-    m_generation++;
+        m_features.reserve(m_features.size() + _points.size());
+
+        for (size_t i = 0; i < _points.size(); i++) {
+            auto container = geojsonvt::Convert::project(
+                { geojsonvt::LonLat(_points[i].longitude, _points[i].latitude) }, tolerance);
+
+            auto tags = _tags.empty()
+                ? geojsonvt::Tags{}
+                : geojsonvt::Tags{std::make_shared<Properties>(_tags[i])};
+
+            auto feature = geojsonvt::Convert::create(std::move(tags),
+                                                      geojsonvt::ProjectedFeatureType::Point,
+                                                      container.members);
+
+            minX = std::min(minX, feature.min.x);
+            minY = std::min(minY, feature.min.y);
+            maxX = std::max(maxX, feature.max.x);
+            maxY = std::max(maxY, feature.max.y);
+
+            m_features.push_back(std::move(feature));
+        }
+
+        rebuildStore(minX, minY, maxX, maxY);
+    });
+}
+
+void ClientGeoJsonSource::addLines(const std::vector<Properties>& _tags,
+                                   const std::vector<Coordinates>& _lines) {
+
+    if (_lines.empty()) { return; }
+    if (!_tags.empty() && _tags.size() != _lines.size()) {
+        LOGW("Tag table size does not match feature count");
+        return;
+    }
+
+    m_worker.enqueue([this, _tags, _lines]() {
+
+        double minX = 1.0, minY = 1.0, maxX = 0.0, maxY = 0.0;
+
+        m_features.reserve(m_features.size() + _lines.size());
+
+        for (size_t i = 0; i < _lines.size(); i++) {
+            auto& line = reinterpret_cast<const std::vector<geojsonvt::LonLat>&>(_lines[i]);
+
+            std::vector<geojsonvt::ProjectedGeometry> geometry = { geojsonvt::Convert::project(line, tolerance) };
+
+            auto tags = _tags.empty()
+                ? geojsonvt::Tags{}
+                : geojsonvt::Tags{std::make_shared<Properties>(_tags[i])};
+
+            auto feature = geojsonvt::Convert::create(std::move(tags),
+                                                      geojsonvt::ProjectedFeatureType::LineString,
+                                                      geometry);
+
+            minX = std::min(minX, feature.min.x);
+            minY = std::min(minY, feature.min.y);
+            maxX = std::max(maxX, feature.max.x);
+            maxY = std::max(maxY, feature.max.y);
+
+            m_features.push_back(std::move(feature));
+        }
+
+        rebuildStore(minX, minY, maxX, maxY);
+    });
+}
+
+void ClientGeoJsonSource::addPolys(const std::vector<Properties>& _tags,
+                                   const std::vector<std::vector<Coordinates>>& _polys) {
+
+    if (_polys.empty()) { return; }
+    if (!_tags.empty() && _tags.size() != _polys.size()) {
+        LOGW("Tag table size does not match feature count");
+        return;
+    }
+
+    m_worker.enqueue([this, _tags, _polys]() {
+
+        double minX = 1.0, minY = 1.0, maxX = 0.0, maxY = 0.0;
+
+        m_features.reserve(m_features.size() + _polys.size());
+
+        for (size_t i = 0; i < _polys.size(); i++) {
+
+            geojsonvt::ProjectedGeometryContainer geometry;
+            for (auto& _ring : _polys[i]) {
+                auto& ring = reinterpret_cast<const std::vector<geojsonvt::LonLat>&>(_ring);
+                geometry.members.push_back(geojsonvt::Convert::project(ring, tolerance));
+            }
+
+            auto tags = _tags.empty()
+                ? geojsonvt::Tags{}
+                : geojsonvt::Tags{std::make_shared<Properties>(_tags[i])};
+
+            auto feature = geojsonvt::Convert::create(std::move(tags),
+                                                      geojsonvt::ProjectedFeatureType::Polygon,
+                                                      geometry);
+
+            minX = std::min(minX, feature.min.x);
+            minY = std::min(minY, feature.min.y);
+            maxX = std::max(maxX, feature.max.x);
+            maxY = std::max(maxY, feature.max.y);
+
+            m_features.push_back(std::move(feature));
+        }
+
+        rebuildStore(minX, minY, maxX, maxY);
+    });
+}
+
+void ClientGeoJsonSource::updatePoints(size_t _offset, const std::vector<LngLat>& _points) {
+
+    m_worker.enqueue([this, _offset, _points]() {
+
+        // Checked on the worker so queued add calls are counted
+        if (_offset + _points.size() > m_features.size()) {
+            LOGW("Feature range exceeds the number of stored features");
+            return;
+        }
+
+        double minX = 1.0, minY = 1.0, maxX = 0.0, maxY = 0.0;
+
+        for (size_t i = 0; i < _points.size(); i++) {
+            auto& feature = m_features[_offset + i];
+
+            if (feature.type != geojsonvt::ProjectedFeatureType::Point) {
+                LOGW("Skipping non-point feature in update");
+                continue;
+            }
+
+            // Both the old and the new position are dirty.
+            minX = std::min(minX, feature.min.x);
+            minY = std::min(minY, feature.min.y);
+            maxX = std::max(maxX, feature.max.x);
+            maxY = std::max(maxY, feature.max.y);
+
+            auto container = geojsonvt::Convert::project(
+                { geojsonvt::LonLat(_points[i].longitude, _points[i].latitude) }, tolerance);
+
+            feature = geojsonvt::Convert::create(feature.tags,
+                                                 geojsonvt::ProjectedFeatureType::Point,
+                                                 container.members);
+
+            minX = std::min(minX, feature.min.x);
+            minY = std::min(minY, feature.min.y);
+            maxX = std::max(maxX, feature.max.x);
+            maxY = std::max(maxY, feature.max.y);
+        }
+
+        rebuildStore(minX, minY, maxX, maxY);
+    });
+}
+
+void ClientGeoJsonSource::setPointClustering(bool _enabled, float _radius, int32_t _maxZoom) {
+
+    m_clusterPoints = _enabled;
+    m_clusterRadius = _radius;
+    m_clusterMaxZoom = _maxZoom;
+
+    // Every cached tile may change its feature set
+    m_worker.enqueue([this]() {
+        rebuildStore(0.0, 0.0, 1.0, 1.0);
+    });
+}
+
+void ClientGeoJsonSource::clusterPoints(Layer& _layer, int32_t _zoom) const {
+
+    int32_t maxZoom = m_clusterMaxZoom.load();
+    if (maxZoom < 0) { maxZoom = m_maxZoom - 1; }
+    if (_zoom > maxZoom) { return; }
+
+    // Cluster cells as a fraction of the tile, from the pixel radius at
+    // the nominal 256px tile size
+    double cellSize = std::min(1.0, m_clusterRadius.load() / 256.0);
+    int32_t cells = int32_t(std::ceil(1.0 / cellSize));
+
+    struct Cluster {
+        Point center = { 0, 0, 0 };
+        size_t first = 0; // first member, kept as-is for lone points
+        int count = 0;
+    };
+    std::map<int32_t, Cluster> grid;
+
+    std::vector<Feature> features;
+    features.swap(_layer.features);
+
+    for (size_t i = 0; i < features.size(); i++) {
+        auto& feature = features[i];
+
+        if (feature.geometryType != GeometryType::points || feature.points.size() != 1) {
+            _layer.features.push_back(std::move(feature));
+            continue;
+        }
+
+        const auto& point = feature.points[0];
+
+        // Tile geometry extends into the buffer, so allow one cell of
+        // margin around the tile
+        int32_t cx = glm::clamp(int32_t(point.x / cellSize), -1, cells);
+        int32_t cy = glm::clamp(int32_t(point.y / cellSize), -1, cells);
+
+        auto& cluster = grid[(cy + 1) * (cells + 2) + (cx + 1)];
+        if (cluster.count == 0) { cluster.first = i; }
+        cluster.center += point;
+        cluster.count++;
+    }
+
+    for (auto& entry : grid) {
+        auto& cluster = entry.second;
+
+        if (cluster.count == 1) {
+            _layer.features.push_back(std::move(features[cluster.first]));
+            continue;
+        }
+
+        Feature feature(m_id);
+        feature.geometryType = GeometryType::points;
+        feature.points.push_back(cluster.center / float(cluster.count));
+        feature.props.set("cluster", 1.0);
+        feature.props.set("point_count", double(cluster.count));
+
+        _layer.features.push_back(std::move(feature));
+    }
 }
 
 std::shared_ptr<TileData> ClientGeoJsonSource::parse(const TileTask& _task,
@@ -151,11 +435,19 @@ std::shared_ptr<TileData> ClientGeoJsonSource::parse(const TileTask& _task,
 
     auto data = std::make_shared<TileData>();
 
+    TileID id(_task.tileId().x, _task.tileId().y, _task.tileId().z);
+
     geojsonvt::Tile tile;
+    int64_t generation;
     {
         std::lock_guard<std::mutex> lock(m_mutexStore);
         if (!m_store) { return nullptr; }
-        tile = m_store->getTile(_task.tileId().z, _task.tileId().x, _task.tileId().y);
+
+        auto cached = m_tileDataCache.find(id);
+        if (cached != m_tileDataCache.end()) { return cached->second; }
+
+        tile = m_store->getTile(id.z, id.x, id.y);
+        generation = m_generation;
     }
 
     Layer layer(""); // empty name will skip filtering by 'collection'
@@ -211,8 +503,18 @@ std::shared_ptr<TileData> ClientGeoJsonSource::parse(const TileTask& _task,
 
     }
 
+    if (m_clusterPoints) { clusterPoints(layer, id.z); }
+
     data->layers.emplace_back(std::move(layer));
 
+    {
+        std::lock_guard<std::mutex> lock(m_mutexStore);
+        // Only cache when no update invalidated the store meanwhile.
+        if (m_generation == generation) {
+            m_tileDataCache[id] = data;
+        }
+    }
+
     return data;
 
 }
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "dataSource.h"
+#include "tile/tileID.h"
+#include "util/taskExecutor.h"
 #include "util/types.h"
 
+#include <atomic>
+#include <map>
 #include <mutex>
 
 namespace mapbox {
@@ -18,6 +22,7 @@ namespace Tangram {
 using GeoJSONVT = mapbox::util::geojsonvt::GeoJSONVT;
 
 struct Properties;
+struct Layer;
 
 class ClientGeoJsonSource : public DataSource {
 
@@ -27,27 +32,78 @@ public:
                         int32_t _minDisplayZoom = -1, int32_t _maxDisplayZoom = -1, int32_t _maxZoom = 18);
     ~ClientGeoJsonSource();
 
-    // Add geometry from a GeoJSON string
+    // Add geometry from a GeoJSON string. Parsing and tile index
+    // construction run on a worker thread; tiles keep rendering from the
+    // previous index until the new one is swapped in.
     void addData(const std::string& _data);
     void addPoint(const Properties& _tags, LngLat _point);
     void addLine(const Properties& _tags, const Coordinates& _line);
     void addPoly(const Properties& _tags, const std::vector<Coordinates>& _poly);
 
+    /* Add many features at once from typed coordinate arrays and a parallel
+     * tag table, going straight into the tile index without a JSON round
+     * trip. _tags may be empty or hold one entry per feature; the index is
+     * rebuilt once per call instead of once per feature. */
+    void addPoints(const std::vector<Properties>& _tags, const std::vector<LngLat>& _points);
+    void addLines(const std::vector<Properties>& _tags, const std::vector<Coordinates>& _lines);
+    void addPolys(const std::vector<Properties>& _tags, const std::vector<std::vector<Coordinates>>& _polys);
+
+    /* Aggregate point features into grid clusters when building tiles at
+     * or below _maxZoom (default: every zoom below the source's max zoom),
+     * so low-zoom tiles of dense point layers carry a few hundred cluster
+     * features instead of the full point set. Clusters average the
+     * positions of their members and carry 'cluster' and 'point_count'
+     * properties; lone points keep their own tags. _radius is the cluster
+     * cell size in pixels at the nominal 256px tile size. */
+    void setPointClustering(bool _enabled, float _radius = 60.f, int32_t _maxZoom = -1);
+
+    /* Move point features in place, keeping their tags. _offset indexes
+     * features in insertion order across all add calls. Tiles that touch
+     * neither the old nor the new positions are served from the parsed-tile
+     * cache without re-tiling. */
+    void updatePoints(size_t _offset, const std::vector<LngLat>& _points);
+
     virtual bool loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) override;
     std::shared_ptr<TileTask> createTask(TileID _tileId, int _subTask) override;
 
     virtual void cancelLoadingTile(const TileID& _tile) override {};
     virtual void clearData() override;
 
+    /* Tiles from the geojson-vt index are simplified to display resolution
+     * already, and parsed tiles are shared through m_tileDataCache. */
+    virtual bool simplifyGeometry() const override { return false; }
+
 protected:
 
     virtual std::shared_ptr<TileData> parse(const TileTask& _task,
                                             const MapProjection& _projection) const override;
 
+    /* Rebuild the tile index and drop parsed tiles that intersect the
+     * dirty region, given in projected (0..1 mercator) coordinates. */
+    void rebuildStore(double _minX, double _minY, double _maxX, double _maxY);
+
+    /* Replace single-point features in _layer with their grid clusters */
+    void clusterPoints(Layer& _layer, int32_t _zoom) const;
+
+    /* Written from the client thread, read by tile workers in parse() */
+    std::atomic<bool> m_clusterPoints { false };
+    std::atomic<float> m_clusterRadius { 60.f };
+    std::atomic<int32_t> m_clusterMaxZoom { -1 };
+
     std::unique_ptr<GeoJSONVT> m_store;
     mutable std::mutex m_mutexStore;
     std::vector<mapbox::util::geojsonvt::ProjectedFeature> m_features;
-    bool m_hasPendingData = false;
+    std::atomic<bool> m_hasPendingData { false };
+
+    /* Parsed tiles by ID, kept across updates that do not touch them */
+    mutable std::map<TileID, std::shared_ptr<TileData>> m_tileDataCache;
+
+    /* All feature mutations and index rebuilds run on this serial lane,
+     * so ingestion never blocks the calling thread; parse() reads the
+     * store under m_mutexStore and sees either the old or the new index.
+     * Declared last so its in-flight task ends before other members go
+     * away. */
+    TaskExecutor::Lane m_worker;
 
 };
 
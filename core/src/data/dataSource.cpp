@@ -1,4 +1,10 @@
 #include "dataSource.h"
+#include "data/diskCache.h"
+#include "data/inFlightRequests.h"
+#include "data/tileArchive.h"
+#include "debug/trace.h"
+#include "tile/tileMeshCache.h"
+#include "util/bufferPool.h"
 #include "util/geoJson.h"
 #include "platform.h"
 #include "tileData.h"
@@ -10,7 +16,9 @@
 #include "gl/texture.h"
 #include "log.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cstdio>
 #include <mutex>
 #include <list>
 #include <functional>
@@ -89,15 +97,62 @@ struct RawCache {
     }
 };
 
+struct ParseCache {
+
+    // Parsed ancestor data shared between overzoomed sibling tasks. A
+    // handful of entries covers the children currently drawn over one
+    // data tile; older entries are evicted first.
+    std::mutex m_mutex;
+
+    struct Entry {
+        TileID id;
+        int64_t generation;
+        std::shared_ptr<TileData> data;
+    };
+    std::list<Entry> m_entries;
+
+    size_t m_maxEntries = 4;
+
+    std::shared_ptr<TileData> get(const TileID& _id, int64_t _generation) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->id == _id && it->generation == _generation) {
+                m_entries.splice(m_entries.begin(), m_entries, it);
+                return m_entries.front().data;
+            }
+        }
+        return nullptr;
+    }
+
+    void put(const TileID& _id, int64_t _generation, std::shared_ptr<TileData> _data) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_entries.push_front({_id, _generation, _data});
+
+        while (m_entries.size() > m_maxEntries) {
+            m_entries.pop_back();
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+    }
+};
+
 DataSource::DataSource(const std::string& _name, const std::string& _urlTemplate,
                        int32_t _minDisplayZoom, int32_t _maxDisplayZoom, int32_t _maxZoom) :
     m_name(_name), m_urlTemplate(_urlTemplate),
     m_minDisplayZoom(_minDisplayZoom), m_maxDisplayZoom(_maxDisplayZoom), m_maxZoom(_maxZoom),
-    m_cache(std::make_unique<RawCache>()){
+    m_cache(std::make_unique<RawCache>()),
+    m_parseCache(std::make_unique<ParseCache>()){
 
     static std::atomic<int32_t> s_serial;
 
     m_id = s_serial++;
+
+    splitUrlTemplate();
 }
 
 DataSource::~DataSource() {
@@ -107,7 +162,11 @@ DataSource::~DataSource() {
 std::shared_ptr<TileTask> DataSource::createTask(TileID _tileId, int _subTask) {
     auto task = std::make_shared<DownloadTileTask>(_tileId, shared_from_this(), _subTask);
 
-    cacheGet(*task);
+    if (!cacheGet(*task) && !task->cachedTileData && m_tileArchive) {
+        // Offline archive hit: the task starts out with data, so it goes
+        // straight to a worker without a download.
+        task->rawTileData = m_tileArchive->getTileData(_tileId);
+    }
 
     return task;
 }
@@ -116,31 +175,141 @@ void DataSource::setCacheSize(size_t _cacheSize) {
     m_cache->m_maxUsage = _cacheSize;
 }
 
+size_t DataSource::cacheUsage() {
+    std::lock_guard<std::mutex> lock(m_cache->m_mutex);
+    return m_cache->m_usage;
+}
+
+void DataSource::setDiskCache(const std::string& _path, size_t _maxSize) {
+    m_diskCache = std::make_unique<DiskCache>(_path, _maxSize);
+}
+
+void DataSource::setTileArchive(std::shared_ptr<TileArchive> _archive) {
+    m_tileArchive = _archive;
+}
+
+void DataSource::setMeshCache(std::shared_ptr<TileMeshCache> _cache) {
+    m_meshCache = _cache;
+}
+
 bool DataSource::cacheGet(DownloadTileTask& _task) {
-    return m_cache->get(_task);
+    if (m_cache->get(_task)) { return true; }
+
+    if (m_diskCache) {
+        std::string etag;
+        auto data = m_diskCache->get(_task.tileId(), _task.sourceGeneration(), &etag);
+        if (data) {
+            if (!etag.empty()) {
+                // The entry carries a validator - keep it aside and let the
+                // task revalidate with a conditional request, which costs a
+                // 304 round trip instead of a body transfer when unchanged.
+                _task.cachedTileData = data;
+                _task.cachedETag = etag;
+                return false;
+            }
+            _task.rawTileData = data;
+            // Promote to the in-memory tier for repeat hits.
+            m_cache->put(_task.tileId(), data);
+            return true;
+        }
+    }
+
+    return false;
 }
 
-void DataSource::cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef) {
+void DataSource::cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef,
+                          const std::string& _etag) {
     m_cache->put(_tileID, _rawDataRef);
+
+    if (m_diskCache) {
+        m_diskCache->put(_tileID, m_generation, *_rawDataRef, _etag);
+    }
 }
 
 void DataSource::clearData() {
     m_cache->clear();
+    m_parseCache->clear();
     m_generation++;
 }
 
+std::shared_ptr<TileData> DataSource::parseShared(const TileTask& _task, const MapProjection& _projection,
+                                                  bool& _shared) {
+    _shared = false;
+
+    const TileID id = _task.tileId();
+    if (id.s <= id.z) {
+        return parse(_task, _projection);
+    }
+
+    // Past max zoom the children of one data tile parse an identical
+    // buffer - share one result between them.
+    TileID key(id.x, id.y, id.z);
+
+    if (auto data = m_parseCache->get(key, _task.sourceGeneration())) {
+        _shared = true;
+        return data;
+    }
+
+    auto data = parse(_task, _projection);
+    if (data) {
+        m_parseCache->put(key, _task.sourceGeneration(), data);
+        // A sibling may pick this entry up while the build is still
+        // running, so the first user's copy counts as shared too.
+        _shared = true;
+    }
+    return data;
+}
+
+void DataSource::splitUrlTemplate() {
+
+    std::vector<std::pair<size_t, UrlField>> fields;
+
+    for (auto field : { UrlField::x, UrlField::y, UrlField::z }) {
+        const char* tag = (field == UrlField::x) ? "{x}"
+                        : (field == UrlField::y) ? "{y}" : "{z}";
+
+        size_t pos = m_urlTemplate.find(tag);
+        if (pos != std::string::npos) {
+            fields.emplace_back(pos, field);
+        }
+    }
+    std::sort(fields.begin(), fields.end());
+
+    size_t pos = 0;
+    for (auto& field : fields) {
+        m_urlSegments.push_back(m_urlTemplate.substr(pos, field.first - pos));
+        m_urlFields.push_back(field.second);
+        pos = field.first + 3;
+    }
+    m_urlSegments.push_back(m_urlTemplate.substr(pos));
+}
+
 void DataSource::constructURL(const TileID& _tileCoord, std::string& _url) const {
-    _url.assign(m_urlTemplate);
-    try {
-        size_t xpos = _url.find("{x}");
-        _url.replace(xpos, 3, std::to_string(_tileCoord.x));
-        size_t ypos = _url.find("{y}");
-        _url.replace(ypos, 3, std::to_string(_tileCoord.y));
-        size_t zpos = _url.find("{z}");
-        _url.replace(zpos, 3, std::to_string(_tileCoord.z));
-    } catch(...) {
+
+    if (m_urlFields.size() != 3) {
         LOGE("Bad URL template!");
     }
+
+    // Assigning into the caller's buffer reuses its capacity - no
+    // temporaries are created here
+    _url.clear();
+
+    char digits[16];
+
+    for (size_t i = 0; i < m_urlFields.size(); i++) {
+        _url.append(m_urlSegments[i]);
+
+        int32_t value = 0;
+        switch (m_urlFields[i]) {
+            case UrlField::x: value = _tileCoord.x; break;
+            case UrlField::y: value = _tileCoord.y; break;
+            case UrlField::z: value = _tileCoord.z; break;
+        }
+
+        int length = snprintf(digits, sizeof(digits), "%d", value);
+        _url.append(digits, length);
+    }
+    _url.append(m_urlSegments.back());
 }
 
 bool DataSource::equals(const DataSource& other) const {
@@ -160,21 +329,27 @@ bool DataSource::equals(const DataSource& other) const {
 void DataSource::onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<TileTask>&& _task,
                               TileTaskCb _cb) {
 
-    if (_task->isCanceled()) { return; }
+    if (_task->isCanceled()) {
+        BufferPool::release(std::move(_rawData));
+        return;
+    }
 
     TileID tileID = _task->tileId();
 
     if (!_rawData.empty()) {
 
-        auto rawDataRef = std::make_shared<std::vector<char>>();
-        std::swap(*rawDataRef, _rawData);
+        auto rawDataRef = BufferPool::adopt(std::move(_rawData));
 
         auto& task = static_cast<DownloadTileTask&>(*_task);
         task.rawTileData = rawDataRef;
 
+        std::string etag = task.responseETag;
+
         _cb.func(std::move(_task));
 
-        cachePut(tileID, rawDataRef);
+        cachePut(tileID, rawDataRef, etag);
+    } else {
+        BufferPool::release(std::move(_rawData));
     }
 }
 
@@ -182,18 +357,40 @@ bool DataSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb)
 
     std::string url(constructURL(_task->tileId()));
 
+    // With no stored validator this is a plain fetch that additionally
+    // captures the response ETag for later revalidation.
+    std::string etag = static_cast<DownloadTileTask&>(*_task).cachedETag;
+
     // lambda captured parameters are const by default, we want "task" (moved) to be non-const,
     // hence "mutable"
     // Refer: http://en.cppreference.com/w/cpp/language/lambda
-    return startUrlRequest(url,
-            [this, _cb, task = std::move(_task)](std::vector<char>&& rawData) mutable {
+    return InFlightRequests::start(url, etag,
+            [this, _cb, task = std::move(_task)](std::vector<char>&& rawData,
+                                                 std::string&& etag, bool notModified) mutable {
+
+                TRACE_SCOPE("DataSource::loadTileData " + m_name);
+
+                auto& dlTask = static_cast<DownloadTileTask&>(*task);
+
+                if (dlTask.cachedTileData && (notModified || rawData.empty())) {
+                    // The cached copy is confirmed current (or the fetch
+                    // failed and it is the best we have) - serve it without
+                    // a body transfer and promote it to the memory tier.
+                    if (task->isCanceled()) { return; }
+                    dlTask.rawTileData = dlTask.cachedTileData;
+                    m_cache->put(task->tileId(), dlTask.cachedTileData);
+                    _cb.func(std::move(task));
+                    return;
+                }
+
+                dlTask.responseETag = std::move(etag);
                 this->onTileLoaded(std::move(rawData), std::move(task), _cb);
             });
 
 }
 
 void DataSource::cancelLoadingTile(const TileID& _tileID) {
-    cancelUrlRequest(constructURL(_tileID));
+    InFlightRequests::cancel(constructURL(_tileID));
     for (auto& raster : m_rasterSources) {
         TileID rasterID = _tileID.withMaxSourceZoom(raster->maxZoom());
         raster->cancelLoadingTile(rasterID);
@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include <atomic>
 #include <string>
 #include <memory>
 #include <vector>
@@ -16,6 +17,10 @@ struct Raster;
 class Tile;
 class TileManager;
 struct RawCache;
+struct ParseCache;
+class DiskCache;
+class TileArchive;
+class TileMeshCache;
 class Texture;
 
 class DataSource : public std::enable_shared_from_this<DataSource> {
@@ -47,11 +52,21 @@ public:
     /* Parse a <TileTask> with data into a <TileData>, returning an empty TileData on failure */
     virtual std::shared_ptr<TileData> parse(const TileTask& _task, const MapProjection& _projection) const = 0;
 
+    /* Parse through an ancestor-keyed cache: tiles past this source's max
+     * zoom all map to the same data tile, so overzoomed siblings reuse one
+     * parsed <TileData> and only the per-tile scaling and build step runs
+     * per child. _shared is set when the returned data may be referenced
+     * by other tasks and must not be modified in place. */
+    std::shared_ptr<TileData> parseShared(const TileTask& _task, const MapProjection& _projection,
+                                          bool& _shared);
+
     /* Clears all data associated with this DataSource */
     virtual void clearData();
 
     const std::string& name() const { return m_name; }
 
+    const std::string& urlTemplate() const { return m_urlTemplate; }
+
     virtual void clearRasters();
     virtual void clearRaster(const TileID& id);
 
@@ -64,6 +79,32 @@ public:
      */
     void setCacheSize(size_t _cacheSize);
 
+    /* Bytes currently held by the in-memory cache for raw tile data. */
+    size_t cacheUsage();
+
+    /* Bytes held by decoded raster tile textures; see RasterSource. */
+    virtual size_t rasterBytes() { return 0; }
+
+    /* Attach a persistent disk cache tier below the in-memory cache. Raw
+     * tile data is appended to a memory-mapped blob file at @_path, keyed
+     * by TileID and source generation, so tiles survive app restarts.
+     */
+    void setDiskCache(const std::string& _path, size_t _maxSize);
+
+    /* Attach a baked-tile cache that stores and restores compiled per-style
+     * meshes, bypassing parse and tessellation for unchanged scenes. The
+     * cache may be shared between sources.
+     */
+    void setMeshCache(std::shared_ptr<TileMeshCache> _cache);
+
+    TileMeshCache* meshCache() const { return m_meshCache.get(); }
+
+    /* Attach a packed offline tile archive. Tiles found in the archive are
+     * served from the memory-mapped file without touching the network.
+     * The archive may be shared between sources.
+     */
+    void setTileArchive(std::shared_ptr<TileArchive> _archive);
+
     /* ID of this DataSource instance */
     int32_t id() const { return m_id; }
 
@@ -89,6 +130,11 @@ public:
     /* Avoid RTTI by adding a boolean check on the data source object */
     virtual bool isRaster() const { return false; }
 
+    /* Whether TileBuilder may simplify parsed geometry in place before
+     * tessellation. Sources that hand out shared tile data or already
+     * simplify to display resolution return false. */
+    virtual bool simplifyGeometry() const { return true; }
+
 protected:
 
     virtual void onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<TileTask>&& _task,
@@ -97,6 +143,9 @@ protected:
     /* Constructs the URL of a tile using <m_urlTemplate> */
     virtual void constructURL(const TileID& _tileCoord, std::string& _url) const;
 
+    /* Splits <m_urlTemplate> into m_urlSegments and m_urlFields */
+    void splitUrlTemplate();
+
     std::string constructURL(const TileID& _tileCoord) const {
         std::string url;
         constructURL(_tileCoord, url);
@@ -105,7 +154,8 @@ protected:
 
     bool cacheGet(DownloadTileTask& _task);
 
-    void cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef);
+    void cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef,
+                  const std::string& _etag = "");
 
     // This datasource is used to generate actual tile geometry
     bool m_generateGeometry = false;
@@ -126,13 +176,31 @@ protected:
     int32_t m_id;
 
     // Generation of dynamic DataSource state (incremented for each update)
-    int64_t m_generation = 1;
+    // Bumped whenever the source data changes, possibly off-thread;
+    // compared against Tile generations to trigger rebuilds
+    std::atomic<int64_t> m_generation { 1 };
 
     // URL template for requesting tiles from a network or filesystem
     std::string m_urlTemplate;
 
+    /* m_urlTemplate split at its {x}/{y}/{z} placeholders once at
+     * construction: the literal segments in order, with the coordinate
+     * that fills each gap between them. constructURL() appends the pieces
+     * and formats the numbers in place, with no temporary strings. */
+    enum class UrlField : uint8_t { x, y, z };
+    std::vector<std::string> m_urlSegments;
+    std::vector<UrlField> m_urlFields;
+
     std::unique_ptr<RawCache> m_cache;
 
+    std::unique_ptr<ParseCache> m_parseCache;
+
+    std::unique_ptr<DiskCache> m_diskCache;
+
+    std::shared_ptr<TileArchive> m_tileArchive;
+
+    std::shared_ptr<TileMeshCache> m_meshCache;
+
     /* vector of raster sources (as raster samplers) referenced by this datasource */
     std::vector<std::shared_ptr<DataSource>> m_rasterSources;
 };
@@ -0,0 +1,188 @@
+#include "data/diskCache.h"
+
+#include "log.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Tangram {
+
+// Bump when IndexRecord changes layout; an index written with another
+// version is discarded together with its blob on open.
+#define CACHE_INDEX_MAGIC 0x32434454 // "TDC2"
+
+DiskCache::DiskCache(const std::string& _path, size_t _maxSize)
+    : m_path(_path), m_maxSize(_maxSize) {
+
+    if (!open()) {
+        LOGW("Could not open tile cache at %s", m_path.c_str());
+        close();
+    }
+}
+
+DiskCache::~DiskCache() {
+    close();
+}
+
+bool DiskCache::open() {
+
+    std::string blobPath = m_path + ".blob";
+    std::string indexPath = m_path + ".idx";
+
+    m_blobFd = ::open(blobPath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (m_blobFd < 0) { return false; }
+
+    m_indexFd = ::open(indexPath.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (m_indexFd < 0) { return false; }
+
+    struct stat st;
+    if (fstat(m_blobFd, &st) != 0) { return false; }
+    m_blobSize = st.st_size;
+
+    if (m_blobSize > m_maxSize) {
+        // Blob outgrew its budget - start over. Entries are appended in
+        // access order, so this effectively drops the oldest tiles.
+        if (ftruncate(m_blobFd, 0) != 0 || ftruncate(m_indexFd, 0) != 0) {
+            return false;
+        }
+        m_blobSize = 0;
+    }
+
+    loadIndex();
+
+    return m_blobSize == 0 || remap(m_blobSize);
+}
+
+void DiskCache::close() {
+    if (m_mapped) {
+        munmap(m_mapped, m_mappedSize);
+        m_mapped = nullptr;
+        m_mappedSize = 0;
+    }
+    if (m_blobFd >= 0) { ::close(m_blobFd); m_blobFd = -1; }
+    if (m_indexFd >= 0) { ::close(m_indexFd); m_indexFd = -1; }
+}
+
+void DiskCache::loadIndex() {
+
+    uint32_t magic = 0;
+
+    lseek(m_indexFd, 0, SEEK_SET);
+
+    ssize_t bytesRead = read(m_indexFd, &magic, sizeof(magic));
+
+    if (bytesRead > 0 && (bytesRead != sizeof(magic) || magic != CACHE_INDEX_MAGIC)) {
+        // Index written by another version - start over.
+        if (ftruncate(m_blobFd, 0) != 0 || ftruncate(m_indexFd, 0) != 0) {
+            return;
+        }
+        m_blobSize = 0;
+        bytesRead = 0;
+    }
+
+    if (bytesRead == 0) {
+        magic = CACHE_INDEX_MAGIC;
+        if (write(m_indexFd, &magic, sizeof(magic)) != sizeof(magic)) {
+            return;
+        }
+        return;
+    }
+
+    IndexRecord record;
+
+    while (read(m_indexFd, &record, sizeof(record)) == sizeof(record)) {
+
+        if (record.offset + record.length > m_blobSize) {
+            // Truncated write from an earlier crash - ignore the rest.
+            break;
+        }
+
+        TileID id(record.x, record.y, record.z);
+        // Later records win, so re-written tiles resolve to fresh data.
+        m_index[id] = { record.generation, record.offset, record.length,
+                        std::string(record.etag, strnlen(record.etag, sizeof(record.etag))) };
+    }
+}
+
+bool DiskCache::remap(size_t _minSize) {
+
+    if (m_mapped && m_mappedSize >= _minSize) { return true; }
+
+    if (m_mapped) {
+        munmap(m_mapped, m_mappedSize);
+        m_mapped = nullptr;
+    }
+
+    void* mapped = mmap(nullptr, _minSize, PROT_READ, MAP_SHARED, m_blobFd, 0);
+    if (mapped == MAP_FAILED) {
+        m_mappedSize = 0;
+        return false;
+    }
+
+    m_mapped = static_cast<char*>(mapped);
+    m_mappedSize = _minSize;
+    return true;
+}
+
+std::shared_ptr<std::vector<char>> DiskCache::get(const TileID& _tileID, int64_t _generation,
+                                                  std::string* _etag) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_blobFd < 0) { return nullptr; }
+
+    TileID id(_tileID.x, _tileID.y, _tileID.z);
+
+    auto it = m_index.find(id);
+    if (it == m_index.end() || it->second.generation != _generation) {
+        return nullptr;
+    }
+
+    auto& entry = it->second;
+    if (!remap(entry.offset + entry.length)) { return nullptr; }
+
+    if (_etag) { *_etag = entry.etag; }
+
+    const char* data = m_mapped + entry.offset;
+    return std::make_shared<std::vector<char>>(data, data + entry.length);
+}
+
+void DiskCache::put(const TileID& _tileID, int64_t _generation, const std::vector<char>& _data,
+                    const std::string& _etag) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_blobFd < 0 || _data.empty()) { return; }
+
+    if (m_blobSize + _data.size() > m_maxSize) {
+        // Full - new tiles are dropped until the cache is compacted on
+        // the next open.
+        return;
+    }
+
+    TileID id(_tileID.x, _tileID.y, _tileID.z);
+
+    uint64_t offset = m_blobSize;
+
+    if (pwrite(m_blobFd, _data.data(), _data.size(), offset) != ssize_t(_data.size())) {
+        return;
+    }
+    m_blobSize += _data.size();
+
+    IndexRecord record { id.x, id.y, id.z, _generation, offset, _data.size(), {} };
+    if (_etag.size() <= sizeof(record.etag)) {
+        memcpy(record.etag, _etag.data(), _etag.size());
+    }
+    if (write(m_indexFd, &record, sizeof(record)) != sizeof(record)) {
+        return;
+    }
+
+    m_index[id] = { _generation, offset, record.length,
+                    std::string(record.etag, strnlen(record.etag, sizeof(record.etag))) };
+}
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "tile/tileID.h"
+#include "tile/tileHash.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+/* Persistent cache for raw (compressed) tile blobs.
+ *
+ * Tiles are appended to a single blob file; a sidecar index file maps
+ * (TileID, source generation) to the blob offset. The blob is memory-mapped
+ * for reads, so a warm start serves tiles straight from the page cache
+ * instead of the network. The blob is append-only: stale generations are
+ * dropped from the index on open but their bytes are only reclaimed when
+ * the file exceeds its size limit and is rewritten.
+ */
+class DiskCache {
+
+public:
+
+    /* @_path: base path of the cache; "<path>.blob" and "<path>.idx" are
+     * created next to it. @_maxSize: blob size in bytes above which the
+     * cache is compacted on open. */
+    DiskCache(const std::string& _path, size_t _maxSize);
+
+    ~DiskCache();
+
+    DiskCache(const DiskCache&) = delete;
+    DiskCache& operator=(const DiskCache&) = delete;
+
+    /* Look up a tile blob. Returns an empty pointer on a miss. When @_etag
+     * is given it receives the validator the blob was stored with, so the
+     * entry can be revalidated with a conditional request. */
+    std::shared_ptr<std::vector<char>> get(const TileID& _tileID, int64_t _generation,
+                                           std::string* _etag = nullptr);
+
+    /* Append a tile blob for the given source generation, optionally with
+     * the ETag of the response it came from. */
+    void put(const TileID& _tileID, int64_t _generation, const std::vector<char>& _data,
+             const std::string& _etag = "");
+
+    bool isOpen() const { return m_blobFd >= 0; }
+
+private:
+
+    struct Entry {
+        int64_t generation;
+        uint64_t offset;
+        uint64_t length;
+        std::string etag;
+    };
+
+    struct IndexRecord {
+        int32_t x, y, z;
+        int64_t generation;
+        uint64_t offset;
+        uint64_t length;
+        // Response validator, zero-padded but not null-terminated; values
+        // that do not fit are dropped and the entry has no validator.
+        char etag[64];
+    };
+
+    bool open();
+    void close();
+    void loadIndex();
+    bool remap(size_t _minSize);
+
+    std::string m_path;
+    size_t m_maxSize;
+
+    std::mutex m_mutex;
+
+    std::unordered_map<TileID, Entry> m_index;
+
+    int m_blobFd = -1;
+    int m_indexFd = -1;
+
+    char* m_mapped = nullptr;
+    size_t m_mappedSize = 0;
+    size_t m_blobSize = 0;
+};
+
+}
@@ -0,0 +1,113 @@
+#include "inFlightRequests.h"
+#include "util/bufferPool.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Tangram {
+
+namespace InFlightRequests {
+
+struct Entry {
+    // Waiters are counted separately from callbacks: cancel() only drops
+    // the count, so callbacks of canceled tasks still fire and filter
+    // themselves through TileTask::isCanceled(), while live waiters on
+    // the same URL keep receiving their response.
+    int waiters = 0;
+    std::vector<UrlValidateCallback> callbacks;
+};
+
+static std::mutex s_mutex;
+static std::unordered_map<std::string, Entry> s_table;
+
+bool start(const std::string& _url, const std::string& _etag, UrlValidateCallback _callback) {
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        auto it = s_table.find(_url);
+        if (it != s_table.end()) {
+            // Ride along on the running transfer
+            it->second.waiters++;
+            it->second.callbacks.push_back(std::move(_callback));
+            return true;
+        }
+
+        auto& entry = s_table[_url];
+        entry.waiters = 1;
+        entry.callbacks.push_back(std::move(_callback));
+    }
+
+    bool ok = startUrlRequest(_url, _etag,
+            [url = _url](std::vector<char>&& _data, std::string&& _responseEtag, bool _notModified) {
+
+                std::vector<UrlValidateCallback> callbacks;
+                {
+                    std::lock_guard<std::mutex> lock(s_mutex);
+
+                    auto it = s_table.find(url);
+                    if (it == s_table.end()) { return; }
+
+                    callbacks.swap(it->second.callbacks);
+                    s_table.erase(it);
+                }
+
+                // All but the last waiter get copies, in recycled buffers
+                for (size_t i = 0; i + 1 < callbacks.size(); i++) {
+                    auto copy = BufferPool::acquire();
+                    copy.assign(_data.begin(), _data.end());
+                    callbacks[i](std::move(copy), std::string(_responseEtag), _notModified);
+                }
+                if (!callbacks.empty()) {
+                    callbacks.back()(std::move(_data), std::move(_responseEtag), _notModified);
+                }
+            });
+
+    if (!ok) {
+        std::vector<UrlValidateCallback> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+
+            auto it = s_table.find(_url);
+            if (it != s_table.end()) {
+                callbacks.swap(it->second.callbacks);
+                s_table.erase(it);
+            }
+        }
+        // Callers that attached before the failure was known were told
+        // the request started - hand them the failure response instead
+        // of leaving their tasks waiting.
+        for (size_t i = 1; i < callbacks.size(); i++) {
+            callbacks[i]({}, std::string(), false);
+        }
+    }
+
+    return ok;
+}
+
+bool start(const std::string& _url, UrlCallback _callback) {
+    return start(_url, std::string(),
+            [callback = std::move(_callback)](std::vector<char>&& _data,
+                                              std::string&&, bool) {
+                callback(std::move(_data));
+            });
+}
+
+void cancel(const std::string& _url) {
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        auto it = s_table.find(_url);
+        if (it == s_table.end()) { return; }
+
+        if (--it->second.waiters > 0) { return; }
+
+        s_table.erase(it);
+    }
+    cancelUrlRequest(_url);
+}
+
+}
+
+}
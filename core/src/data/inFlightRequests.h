@@ -0,0 +1,32 @@
+#pragma once
+
+#include "platform.h"
+
+#include <string>
+
+namespace Tangram {
+
+/* Global table of in-flight url requests, keyed by URL.
+ *
+ * When a tile URL is requested while a transfer for the same URL is
+ * still running - a raster source shared between styles, or referenced
+ * both directly and as a subtask of a vector source - the new caller is
+ * attached to the running request and the single response fans out to
+ * all waiters, instead of fetching the same body more than once.
+ */
+namespace InFlightRequests {
+
+/* Start a request for _url, or attach _callback to one already in
+ * flight. When requests with different validators race for one URL the
+ * first caller's _etag is used. */
+bool start(const std::string& _url, const std::string& _etag, UrlValidateCallback _callback);
+
+bool start(const std::string& _url, UrlCallback _callback);
+
+/* Detach one waiter from the request for _url; the transfer itself is
+ * only canceled when the last waiter goes. */
+void cancel(const std::string& _url);
+
+}
+
+}
@@ -7,6 +7,8 @@
 #include "util/pbfParser.h"
 #include "platform.h"
 
+#include <algorithm>
+
 namespace Tangram {
 
 
@@ -23,10 +25,27 @@ std::shared_ptr<TileData> MVTSource::parse(const TileTask& _task, const MapProje
 
     protobuf::message item(task.rawTileData->data(), task.rawTileData->size());
     PbfParser::ParserContext ctx(m_id);
+    ctx.arena = &tileData->arena();
+
+    // String properties are parsed as views into the raw buffer.
+    tileData->pinSourceData(task.rawTileData);
+
+    const auto* filter = _task.collectionFilter();
 
     while(item.next()) {
         if(item.tag == 3) {
-            tileData->layers.push_back(PbfParser::getLayer(ctx, item.getMessage()));
+            auto layerMsg = item.getMessage();
+
+            if (filter) {
+                // Skip the geometry and tag decode of layers the scene
+                // never references; only their name field is read.
+                auto name = PbfParser::getLayerName(layerMsg);
+                if (std::find(filter->begin(), filter->end(), name) == filter->end()) {
+                    continue;
+                }
+            }
+
+            tileData->layers.push_back(PbfParser::getLayer(ctx, layerMsg));
         } else {
             item.skip();
         }
@@ -1,5 +1,7 @@
 #include "propertyItem.h"
 #include "properties.h"
+#include "util/hash.h"
+#include "util/stringIntern.h"
 #include <algorithm>
 
 namespace Tangram {
@@ -10,6 +12,7 @@ Properties::~Properties() {}
 
 Properties& Properties::operator=(Properties&& _other) {
     props = std::move(_other.props);
+    pool = std::move(_other.pool);
     sourceId = _other.sourceId;
     return *this;
 }
@@ -20,26 +23,60 @@ void Properties::setSorted(std::vector<Item>&& _items) {
 
 const Value& Properties::get(const std::string& key) const {
 
-    const auto it = std::find_if(props.begin(), props.end(),
-                                 [&](const auto& item) {
-                                     return item.key == key;
-                                 });
-    if (it == props.end()) {
+    // Stored keys are always interned, so a key unknown to the pool
+    // cannot match any item and the scan is a plain integer compare.
+    uint32_t keyId = StringIntern::find(key);
+    if (keyId == 0) {
         return NOT_A_VALUE;
     }
 
-    // auto it = std::lower_bound(props.begin(), props.end(), key,
-    //                            [](auto& item, auto& key) {
-    //                                return keyComparator(item.key, key);
-    //                            });
-    // if (it == props.end() || it->key != key) {
-    //     return NOT_FOUND;
-    // }
+    return get(keyId);
+}
+
+const Value& Properties::get(uint32_t keyId) const {
+
+    // Items are ordered by key id, so the probe is a binary search over
+    // integer keys with no string compares at all.
+    const auto it = std::lower_bound(props.begin(), props.end(), keyId,
+                                     [](const auto& item, uint32_t key) {
+                                         return item.keyId < key;
+                                     });
+    if (it == props.end() || it->keyId != keyId) {
+        return NOT_A_VALUE;
+    }
 
     return it->value;
 }
 
-void Properties::clear() { props.clear(); }
+void Properties::clear() {
+    props.clear();
+    pool.reset();
+}
+
+void Properties::compact() {
+
+    size_t bytes = 0;
+    for (const auto& item : props) {
+        if (item.value.is<std::string>()) {
+            bytes += item.value.get<std::string>().length();
+        }
+    }
+    if (bytes == 0) { return; }
+
+    // The buffer is sized up front so the views stay stable while it is
+    // filled; it is never resized afterwards.
+    pool = std::make_shared<std::vector<char>>();
+    pool->reserve(bytes);
+
+    for (auto& item : props) {
+        if (!item.value.is<std::string>()) { continue; }
+
+        const auto& str = item.value.get<std::string>();
+        const char* start = pool->data() + pool->size();
+        pool->insert(pool->end(), str.begin(), str.end());
+        item.value = Value(StringView{start, str.length()});
+    }
+}
 
 bool Properties::contains(const std::string& key) const {
     return !get(key).is<none_type>();
@@ -64,28 +101,22 @@ double Properties::getNumber(const std::string& key) const {
 
 bool Properties::getString(const std::string& key, std::string& value) const {
     auto& it = get(key);
-    if (it.is<std::string>()) {
-        value = it.get<std::string>();
+    if (it.isString()) {
+        value = it.toString();
         return true;
     }
     return false;
 }
 
-const std::string& Properties::getString(const std::string& key) const {
-    const static std::string EMPTY_STRING = "";
-
-    auto& it = get(key);
-    if (it.is<std::string>()) {
-        return it.get<std::string>();
-    }
-    return EMPTY_STRING;
+std::string Properties::getString(const std::string& key) const {
+    return get(key).toString();
 }
 
 const bool Properties::getAsString(const std::string& key, std::string& value) const {
     auto& it = get(key);
 
-    if (it.is<std::string>()) {
-        value = it.get<std::string>();
+    if (it.isString()) {
+        value = it.toString();
         return true;
     } else if (it.is<double>()) {
         value = std::to_string(it.get<double>());
@@ -96,8 +127,8 @@ const bool Properties::getAsString(const std::string& key, std::string& value) c
 }
 
 std::string Properties::asString(const Value& value) const {
-    if (value.is<std::string>()) {
-        return value.get<std::string>();
+    if (value.isString()) {
+        return value.toString();
     } else if (value.is<double>()) {
         return std::to_string(value.get<double>());
     }
@@ -114,15 +145,40 @@ void Properties::sort() {
     std::sort(props.begin(), props.end());
 }
 
+size_t Properties::hash() const {
+
+    size_t seed = 0;
+
+    for (const auto& item : props) {
+        hash_combine(seed, item.keyId);
+
+        if (item.value.is<double>()) {
+            hash_combine(seed, item.value.get<double>());
+        } else if (item.value.is<std::string>()) {
+            hash_combine(seed, item.value.get<std::string>());
+        } else if (item.value.is<StringView>()) {
+            const auto& view = item.value.get<StringView>();
+            size_t h = 5381;
+            for (uint32_t i = 0; i < view.length; i++) {
+                h = h * 33 + view.data[i];
+            }
+            hash_combine(seed, h);
+        }
+    }
+    return seed;
+}
+
 void Properties::set(std::string key, std::string value) {
 
-    auto it = std::lower_bound(props.begin(), props.end(), key,
-                               [](auto& item, auto& key) {
-                                   return keyComparator(item.key, key);
+    uint32_t keyId = StringIntern::intern(key);
+
+    auto it = std::lower_bound(props.begin(), props.end(), keyId,
+                               [](const auto& item, uint32_t _keyId) {
+                                   return item.keyId < _keyId;
                                });
 
-    if (it == props.end() || it->key != key) {
-        props.emplace(it, std::move(key), std::move(value));
+    if (it == props.end() || it->keyId != keyId) {
+        props.emplace(it, keyId, std::move(value));
     } else {
         it->value = std::move(value);
     }
@@ -130,13 +186,15 @@ void Properties::set(std::string key, std::string value) {
 
 void Properties::set(std::string key, double value) {
 
-    auto it = std::lower_bound(props.begin(), props.end(), key,
-                               [](auto& item, auto& key) {
-                                   return keyComparator(item.key, key);
+    uint32_t keyId = StringIntern::intern(key);
+
+    auto it = std::lower_bound(props.begin(), props.end(), keyId,
+                               [](const auto& item, uint32_t _keyId) {
+                                   return item.keyId < _keyId;
                                });
 
-    if (it == props.end() || it->key != key) {
-        props.emplace(it, std::move(key), value);
+    if (it == props.end() || it->keyId != keyId) {
+        props.emplace(it, keyId, value);
     } else {
         it->value = value;
     }
@@ -148,7 +206,7 @@ std::string Properties::toJson() const {
 
     for (const auto& item : props) {
         bool last = (&item == &props.back());
-        json += "\"" + item.key + "\": \"" + asString(item.value) + (last ? "\"" : "\",");
+        json += "\"" + item.key() + "\": \"" + asString(item.value) + (last ? "\"" : "\",");
     }
 
     json += " }";
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -22,10 +23,16 @@ struct Properties {
 
     const Value& get(const std::string& key) const;
 
+    /* Get the value for an interned key id, skipping the pool lookup */
+    const Value& get(uint32_t keyId) const;
+
     void sort();
 
     void clear();
 
+    /* Hash over all items; equal property sets hash equally. */
+    size_t hash() const;
+
     bool contains(const std::string& key) const;
 
     bool getNumber(const std::string& key, double& value) const;
@@ -34,7 +41,7 @@ struct Properties {
 
     bool getString(const std::string& key, std::string& value) const;
 
-    const std::string& getString(const std::string& key) const;
+    std::string getString(const std::string& key) const;
 
     std::string asString(const Value& value) const;
 
@@ -49,6 +56,13 @@ struct Properties {
 
     void setSorted(std::vector<Item>&& _items);
 
+    /* Move all owned string values into one contiguous buffer and keep
+     * them as views into it. Property-heavy tiles otherwise pay one heap
+     * allocation per string value; packed, the filter equality checks
+     * walk a single buffer per feature. Call once after the items are
+     * set; copies of this Properties share the immutable buffer. */
+    void compact();
+
     // template <typename... Args> void set(std::string key, Args&&... args) {
     //     props.emplace_back(std::move(key), Value{std::forward<Args>(args)...});
     //     sort();
@@ -58,15 +72,12 @@ struct Properties {
 
     int32_t sourceId;
 
-    static bool keyComparator(const std::string& a, const std::string& b) {
-        if (a.size() == b.size()) {
-            return a < b;
-        } else {
-            return a.size() < b.size();
-        }
-    }
 private:
+    // Sorted by interned key id; see PropertyItem::operator<.
     std::vector<Item> props;
+
+    /* Backing buffer of compacted string values, shared by copies */
+    std::shared_ptr<std::vector<char>> pool;
 };
 
 }
@@ -1,19 +1,27 @@
 #pragma once
 
+#include "util/stringIntern.h"
 #include "util/variant.h"
 
 namespace Tangram {
 
 struct PropertyItem {
-    PropertyItem(std::string _key, Value _value) :
-        key(std::move(_key)), value(std::move(_value)) {}
+    PropertyItem(const std::string& _key, Value _value) :
+        keyId(StringIntern::intern(_key)), value(std::move(_value)) {}
 
-    std::string key;
+    PropertyItem(uint32_t _keyId, Value _value) :
+        keyId(_keyId), value(std::move(_value)) {}
+
+    // Interned key id, see StringIntern.
+    uint32_t keyId;
     Value value;
+
+    const std::string& key() const { return StringIntern::string(keyId); }
+
+    // Canonical ordering of property items is by interned key id, so
+    // sorting and lookups compare integers only.
     bool operator<(const PropertyItem& _rhs) const {
-        return key.size() == _rhs.key.size()
-            ? key < _rhs.key
-            : key.size() < _rhs.key.size();
+        return keyId < _rhs.keyId;
     }
 };
 
@@ -1,10 +1,12 @@
 #include "rasterSource.h"
+#include "data/inFlightRequests.h"
 #include "propertyItem.h"
 #include "util/mapProjection.h"
 
 #include "tileData.h"
 #include "tile/tile.h"
 #include "tile/tileTask.h"
+#include "util/bufferPool.h"
 #include "util/geoJson.h"
 #include "platform.h"
 
@@ -53,7 +55,6 @@ public:
         m_tile->rasters().push_back(std::move(raster));
 
         for (auto& subTask : m_subTasks) {
-            assert(subTask->isReady());
             subTask->complete(*this);
         }
     }
@@ -61,11 +62,41 @@ public:
     void complete(TileTask& _mainTask) override {
         auto source = reinterpret_cast<RasterSource*>(m_source.get());
 
+        if (!isReady()) {
+            // Still downloading or decoding - hold the sampler slot with
+            // the placeholder so slot order stays stable, and swap the
+            // real texture in through completeLate() when it arrives.
+            m_rasterSlot = _mainTask.tile()->rasters().size();
+            m_targetTile = _mainTask.tile();
+            _mainTask.tile()->rasters().emplace_back(m_tileId, source->emptyTexture());
+            return;
+        }
+
         auto raster = source->getRaster(*this);
         assert(raster.isValid());
 
         _mainTask.tile()->rasters().push_back(std::move(raster));
     }
+
+    void completeLate() override {
+        auto tile = m_targetTile.lock();
+        if (!tile || !m_texture) { return; }
+
+        auto source = reinterpret_cast<RasterSource*>(m_source.get());
+        auto raster = source->getRaster(*this);
+
+        auto& rasters = tile->rasters();
+        if (m_rasterSlot < rasters.size() &&
+            rasters[m_rasterSlot].texture == source->emptyTexture()) {
+            rasters[m_rasterSlot].texture = raster.texture;
+        }
+    }
+
+private:
+
+    // Tile that completed with a placeholder in this task's raster slot
+    std::weak_ptr<Tile> m_targetTile;
+    size_t m_rasterSlot = 0;
 };
 
 
@@ -87,6 +118,11 @@ std::shared_ptr<Texture> RasterSource::createTexture(const std::vector<char>& _r
 
     auto texture = std::make_shared<Texture>(udata, dataSize, m_texOptions, m_genMipmap);
 
+    // Raster tile contents never change after decoding, so the CPU pixel
+    // copy can go once the texture is uploaded. After a context loss the
+    // tile is rebuilt from the raw data cache instead.
+    texture->setDisposeAfterUpload(true);
+
     return texture;
 }
 
@@ -120,7 +156,9 @@ std::shared_ptr<TileTask> RasterSource::createTask(TileID _tileId, int _subTask)
 
         auto texIt = m_textures.find(id);
         if (texIt != m_textures.end()) {
-            task->m_texture = texIt->second;
+            // Touch the entry so reuse keeps it warm
+            m_textureList.splice(m_textureList.begin(), m_textureList, texIt->second);
+            task->m_texture = texIt->second->second;
             return task;
         }
     }
@@ -134,12 +172,14 @@ std::shared_ptr<TileTask> RasterSource::createTask(TileID _tileId, int _subTask)
 void RasterSource::onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<TileTask>&& _task,
                                 TileTaskCb _cb) {
 
-    if (_task->isCanceled()) { return; }
+    if (_task->isCanceled()) {
+        BufferPool::release(std::move(_rawData));
+        return;
+    }
 
     TileID tileID = _task->tileId();
 
-    auto rawDataRef = std::make_shared<std::vector<char>>();
-    std::swap(*rawDataRef, _rawData);
+    auto rawDataRef = BufferPool::adopt(std::move(_rawData));
 
     auto& task = static_cast<DownloadTileTask&>(*_task);
     task.rawTileData = rawDataRef;
@@ -158,7 +198,10 @@ bool RasterSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _c
     // lambda captured parameters are const by default, we want "task" (moved) to be non-const,
     // hence "mutable"
     // Refer: http://en.cppreference.com/w/cpp/language/lambda
-    bool status = startUrlRequest(url,
+    // A raster source referenced by several styles, or shared between
+    // direct tiles and subtasks, may request one URL many times over -
+    // the table merges those into a single transfer.
+    bool status = InFlightRequests::start(url,
             [this, _cb, task = std::move(_task)](std::vector<char>&& rawData) mutable {
                 this->onTileLoaded(std::move(rawData), std::move(task), _cb);
             });
@@ -176,15 +219,52 @@ bool RasterSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _c
 Raster RasterSource::getRaster(const TileTask& _task) {
     TileID id(_task.tileId().x, _task.tileId().y, _task.tileId().z);
 
-    auto texIt = m_textures.find(id);
+    auto& task = static_cast<const RasterTileTask&>(_task);
+
+    return { id, cacheTexture(id, task.m_texture) };
+}
+
+namespace {
+
+size_t textureBytes(Texture& _texture) {
+    // The CPU pixel copy is dropped after upload (see createTexture), so
+    // the dimensions count the GPU-resident bytes.
+    return size_t(_texture.getWidth()) * size_t(_texture.getHeight())
+        * _texture.bytesPerPixel();
+}
+
+}
+
+std::shared_ptr<Texture> RasterSource::cacheTexture(const TileID& _id, std::shared_ptr<Texture> _texture) {
+
+    auto texIt = m_textures.find(_id);
     if (texIt != m_textures.end()) {
-        return { id, texIt->second };
+        m_textureList.splice(m_textureList.begin(), m_textureList, texIt->second);
+        return m_textureList.front().second;
     }
 
-    auto& task = static_cast<const RasterTileTask&>(_task);
-    m_textures.emplace(id, task.m_texture);
+    m_textureList.push_front({_id, _texture});
+    m_textures.emplace(_id, m_textureList.begin());
+    m_textureUsage += textureBytes(*_texture);
 
-    return { id, task.m_texture };
+    evictTextures();
+
+    return _texture;
+}
+
+void RasterSource::evictTextures() {
+
+    // Walk from the cold end; entries a tile still references are
+    // skipped and re-tried once clearRaster signals a dropped reference.
+    auto it = m_textureList.end();
+    while (m_textureUsage > m_maxTextureUsage && it != m_textureList.begin()) {
+        --it;
+        if (it->second.use_count() > 1) { continue; }
+
+        m_textureUsage -= textureBytes(*it->second);
+        m_textures.erase(it->first);
+        it = m_textureList.erase(it);
+    }
 }
 
 void RasterSource::clearRasters() {
@@ -192,7 +272,9 @@ void RasterSource::clearRasters() {
         raster->clearRasters();
     }
 
+    m_textureList.clear();
     m_textures.clear();
+    m_textureUsage = 0;
 }
 
 void RasterSource::clearRaster(const TileID &tileID) {
@@ -203,13 +285,9 @@ void RasterSource::clearRaster(const TileID &tileID) {
         raster->clearRaster(rasterID);
     }
 
-    auto rasterID = id.withMaxSourceZoom(m_maxZoom);
-
-    // We do not want to delete the texture reference from the
-    // DS if any of the tiles is still using this as a reference
-    if (m_textures[rasterID].use_count() <= 1) {
-        m_textures.erase(rasterID);
-    }
+    // The tile dropped its reference; the texture stays cached for reuse
+    // until the byte budget pushes it out from the cold end.
+    evictTextures();
 }
 
 }
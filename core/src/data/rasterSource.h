@@ -7,6 +7,7 @@
 #include "gl/texture.h"
 
 #include <functional>
+#include <list>
 #include <unordered_map>
 #include <mutex>
 
@@ -18,7 +19,29 @@ class RasterSource : public DataSource {
 
     TextureOptions m_texOptions;
     bool m_genMipmap;
-    std::unordered_map<TileID, std::shared_ptr<Texture>> m_textures;
+
+    // LRU cache of decoded tile textures, most recently used first.
+    // Bounded by m_maxTextureUsage, counted from texture dimensions like
+    // the other byte counts in MemoryStats. Entries a tile still
+    // references are never evicted - their pixels are pinned on the GPU
+    // either way - and are reclaimed once the tile lets go. Only touched
+    // on the thread running TileManager::updateTileSets.
+    using TextureEntry = std::pair<TileID, std::shared_ptr<Texture>>;
+    using TextureList = std::list<TextureEntry>;
+
+    TextureList m_textureList;
+    std::unordered_map<TileID, TextureList::iterator> m_textures;
+    size_t m_textureUsage = 0;
+    size_t m_maxTextureUsage = 0;
+
+    /* Insert _texture for _id, or touch and return the texture already
+     * cached under _id, evicting over-budget entries afterwards. */
+    std::shared_ptr<Texture> cacheTexture(const TileID& _id, std::shared_ptr<Texture> _texture);
+
+    /* Drop unreferenced textures from the cold end of the cache until
+     * the byte budget is met. The GL handles are released through the
+     * textures' Disposer on the next frame. */
+    void evictTextures();
 
     std::shared_ptr<Texture> m_emptyTexture;
 
@@ -44,8 +67,17 @@ public:
     virtual void clearRaster(const TileID& id) override;
     virtual bool isRaster() const override { return true; }
 
+    /* @_bytes: Byte budget of the decoded texture cache; textures no
+     * tile references anymore are kept for reuse within this bound. */
+    void setTextureCacheSize(size_t _bytes) { m_maxTextureUsage = _bytes; evictTextures(); }
+
+    virtual size_t rasterBytes() override { return m_textureUsage; }
+
     std::shared_ptr<Texture> createTexture(const std::vector<char>& _rawTileData);
 
+    /* Placeholder texture sampled until a raster arrives. */
+    std::shared_ptr<Texture> emptyTexture() { return m_emptyTexture; }
+
     Raster getRaster(const TileTask& _task);
 
 };
@@ -0,0 +1,108 @@
+#include "data/tileArchive.h"
+
+#include "log.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TILE_ARCHIVE_MAGIC 0x314b5054 // 'TPK1'
+
+namespace Tangram {
+
+TileArchive::TileArchive(const std::string& _path) {
+    if (!open(_path)) {
+        LOGW("Could not open tile archive at %s", _path.c_str());
+    }
+}
+
+TileArchive::~TileArchive() {
+    if (m_mapped) {
+        munmap(m_mapped, m_mappedSize);
+    }
+}
+
+bool TileArchive::open(const std::string& _path) {
+
+    int fd = ::open(_path.c_str(), O_RDONLY);
+    if (fd < 0) { return false; }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || size_t(st.st_size) < 2 * sizeof(uint32_t)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+
+    if (mapped == MAP_FAILED) { return false; }
+
+    m_mapped = static_cast<char*>(mapped);
+    m_mappedSize = st.st_size;
+
+    uint32_t magic, count;
+    std::memcpy(&magic, m_mapped, sizeof(magic));
+    std::memcpy(&count, m_mapped + sizeof(magic), sizeof(count));
+
+    if (magic != TILE_ARCHIVE_MAGIC) {
+        munmap(m_mapped, m_mappedSize);
+        m_mapped = nullptr;
+        return false;
+    }
+
+    struct DirRecord {
+        int32_t z, x, y;
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    size_t directoryEnd = 2 * sizeof(uint32_t) + count * sizeof(DirRecord);
+    if (directoryEnd > m_mappedSize) {
+        munmap(m_mapped, m_mappedSize);
+        m_mapped = nullptr;
+        return false;
+    }
+
+    const char* cursor = m_mapped + 2 * sizeof(uint32_t);
+
+    m_directory.reserve(count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        DirRecord record;
+        std::memcpy(&record, cursor, sizeof(record));
+        cursor += sizeof(record);
+
+        if (record.offset + record.length > m_mappedSize) { continue; }
+
+        m_directory[TileID(record.x, record.y, record.z)] =
+            { record.offset, record.length };
+    }
+
+    return true;
+}
+
+bool TileArchive::hasTile(const TileID& _tileID) const {
+    TileID id(_tileID.x, _tileID.y, _tileID.z);
+    return m_directory.find(id) != m_directory.end();
+}
+
+std::shared_ptr<std::vector<char>> TileArchive::getTileData(const TileID& _tileID) const {
+
+    if (!m_mapped) { return nullptr; }
+
+    TileID id(_tileID.x, _tileID.y, _tileID.z);
+
+    auto it = m_directory.find(id);
+    if (it == m_directory.end()) { return nullptr; }
+
+    const char* data = m_mapped + it->second.offset;
+    return std::make_shared<std::vector<char>>(data, data + it->second.length);
+}
+
+}
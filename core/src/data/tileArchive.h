@@ -0,0 +1,61 @@
+#pragma once
+
+#include "tile/tileID.h"
+#include "tile/tileHash.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+/* Memory-mapped packed tile archive for offline regions.
+ *
+ * Serves the role of MBTiles without pulling in SQLite: a flat file
+ * containing a header, a tile directory and the raw (still compressed)
+ * tile blobs. The file is mapped once on open and lookups touch only the
+ * in-memory directory, so offline tiles are available without any network
+ * stack or per-tile file I/O.
+ *
+ * File layout (all integers little-endian):
+ *   uint32 magic 'TPK1' | uint32 entry count
+ *   count * { int32 z, x, y | uint64 offset | uint64 length }
+ *   tile blobs
+ */
+class TileArchive {
+
+public:
+
+    explicit TileArchive(const std::string& _path);
+
+    ~TileArchive();
+
+    TileArchive(const TileArchive&) = delete;
+    TileArchive& operator=(const TileArchive&) = delete;
+
+    bool isOpen() const { return m_mapped != nullptr; }
+
+    /* Look up the blob for a tile; returns an empty pointer on a miss. */
+    std::shared_ptr<std::vector<char>> getTileData(const TileID& _tileID) const;
+
+    /* Whether the archive contains the given tile. */
+    bool hasTile(const TileID& _tileID) const;
+
+private:
+
+    struct Entry {
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    bool open(const std::string& _path);
+
+    std::unordered_map<TileID, Entry> m_directory;
+
+    char* m_mapped = nullptr;
+    size_t m_mappedSize = 0;
+};
+
+}
@@ -2,6 +2,7 @@
 
 #include "glm/vec3.hpp"
 #include "data/properties.h"
+#include "util/arena.h"
 
 #include <vector>
 #include <string>
@@ -65,19 +66,25 @@ enum GeometryType {
 
 typedef glm::vec3 Point;
 
-typedef std::vector<Point> Line;
+// Geometry containers take their storage from the owning TileData's arena
+// when one is passed at construction; default-constructed containers fall
+// back to the heap, keeping client code unchanged.
+typedef std::vector<Point, ArenaAllocator<Point>> Line;
 
-typedef std::vector<Line> Polygon;
+typedef std::vector<Line, ArenaAllocator<Line>> Polygon;
 
 struct Feature {
     Feature() {}
-    Feature(int32_t _sourceId) { props.sourceId = _sourceId; }
+    Feature(int32_t _sourceId, Arena* _arena = nullptr)
+        : points(_arena), lines(_arena), polygons(_arena) {
+        props.sourceId = _sourceId;
+    }
 
     GeometryType geometryType = GeometryType::polygons;
 
-    std::vector<Point> points;
-    std::vector<Line> lines;
-    std::vector<Polygon> polygons;
+    Line points;
+    std::vector<Line, ArenaAllocator<Line>> lines;
+    std::vector<Polygon, ArenaAllocator<Polygon>> polygons;
 
     Properties props;
 };
@@ -96,6 +103,24 @@ struct TileData {
 
     std::vector<Layer> layers;
 
+    /* Backing store for arena-allocated feature geometry; freed in one
+     * shot with the TileData. Created on demand by parsers that opt in. */
+    Arena& arena() {
+        if (!m_arena) { m_arena = std::make_unique<Arena>(); }
+        return *m_arena;
+    }
+
+    /* Keep the raw source buffer alive for parsers that store StringView
+     * property values referencing it. */
+    void pinSourceData(std::shared_ptr<std::vector<char>> _data) {
+        m_sourceData = std::move(_data);
+    }
+
+private:
+
+    std::unique_ptr<Arena> m_arena;
+
+    std::shared_ptr<std::vector<char>> m_sourceData;
 };
 
 }
@@ -32,19 +32,10 @@ std::shared_ptr<TileData> TopoJsonSource::parse(const TileTask& _task,
         return tileData;
     }
 
-    // Transform JSON data into a TileData using TopoJson functions
-    BoundingBox tileBounds(_projection.TileBounds(task.tileId()));
-    glm::dvec2 tileOrigin = {tileBounds.min.x, tileBounds.max.y*-1.0};
-    double tileInverseScale = 1.0 / tileBounds.width();
-
-    const auto projFn = [&](glm::dvec2 _lonLat){
-        glm::dvec2 tmp = _projection.LonLatToMeters(_lonLat);
-        return Point {
-            (tmp.x - tileOrigin.x) * tileInverseScale,
-            (tmp.y - tileOrigin.y) * tileInverseScale,
-             0
-        };
-    };
+    // Transform JSON data into a TileData using TopoJson functions.
+    // Tile origin and scale are computed in double once; the per-point
+    // transform hands out floats, see TileTransform.
+    TileTransform projFn(_projection, task.tileId());
 
     // Parse topology and transform
     auto topology = TopoJson::getTopology(document, projFn);
@@ -0,0 +1,135 @@
+#include "debug/allocStats.h"
+
+#ifdef TANGRAM_ALLOC_STATS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace Tangram {
+
+namespace AllocStats {
+
+namespace {
+
+// Each allocation is prefixed with a header recording its size and tag,
+// sized to preserve malloc's max_align_t alignment for the payload.
+struct alignas(alignof(std::max_align_t)) Header {
+    size_t size;
+    Tag tag;
+};
+
+struct Counters {
+    std::atomic<size_t> bytes { 0 };
+    std::atomic<size_t> allocs { 0 };
+    std::atomic<size_t> liveBytes { 0 };
+};
+
+Counters s_counters[tagCount];
+
+thread_local Tag t_tag = none;
+
+const char* s_tagNames[tagCount] = {
+    "untagged",
+    "tile parse",
+    "style build",
+    "labels",
+    "scene",
+};
+
+void* allocate(size_t _size) {
+    auto* header = static_cast<Header*>(std::malloc(sizeof(Header) + _size));
+    if (!header) { return nullptr; }
+
+    header->size = _size;
+    header->tag = t_tag;
+
+    auto& counters = s_counters[t_tag];
+    counters.bytes.fetch_add(_size, std::memory_order_relaxed);
+    counters.allocs.fetch_add(1, std::memory_order_relaxed);
+    counters.liveBytes.fetch_add(_size, std::memory_order_relaxed);
+
+    return header + 1;
+}
+
+void deallocate(void* _ptr) {
+    if (!_ptr) { return; }
+
+    auto* header = static_cast<Header*>(_ptr) - 1;
+    s_counters[header->tag].liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+
+    std::free(header);
+}
+
+}
+
+const char* tagName(Tag _tag) {
+    return s_tagNames[_tag];
+}
+
+TagStats stats(Tag _tag) {
+    TagStats out;
+    const auto& counters = s_counters[_tag];
+    out.bytes = counters.bytes.load(std::memory_order_relaxed);
+    out.allocs = counters.allocs.load(std::memory_order_relaxed);
+    out.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    return out;
+}
+
+Scope::Scope(Tag _tag) : m_previous(t_tag) {
+    t_tag = _tag;
+}
+
+Scope::~Scope() {
+    t_tag = m_previous;
+}
+
+}
+
+}
+
+void* operator new(size_t _size) {
+    void* ptr = Tangram::AllocStats::allocate(_size);
+    if (!ptr) { throw std::bad_alloc(); }
+    return ptr;
+}
+
+void* operator new[](size_t _size) {
+    void* ptr = Tangram::AllocStats::allocate(_size);
+    if (!ptr) { throw std::bad_alloc(); }
+    return ptr;
+}
+
+void* operator new(size_t _size, const std::nothrow_t&) noexcept {
+    return Tangram::AllocStats::allocate(_size);
+}
+
+void* operator new[](size_t _size, const std::nothrow_t&) noexcept {
+    return Tangram::AllocStats::allocate(_size);
+}
+
+void operator delete(void* _ptr) noexcept {
+    Tangram::AllocStats::deallocate(_ptr);
+}
+
+void operator delete[](void* _ptr) noexcept {
+    Tangram::AllocStats::deallocate(_ptr);
+}
+
+void operator delete(void* _ptr, size_t) noexcept {
+    Tangram::AllocStats::deallocate(_ptr);
+}
+
+void operator delete[](void* _ptr, size_t) noexcept {
+    Tangram::AllocStats::deallocate(_ptr);
+}
+
+void operator delete(void* _ptr, const std::nothrow_t&) noexcept {
+    Tangram::AllocStats::deallocate(_ptr);
+}
+
+void operator delete[](void* _ptr, const std::nothrow_t&) noexcept {
+    Tangram::AllocStats::deallocate(_ptr);
+}
+
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Per-subsystem allocation accounting.
+ *
+ * When built with TANGRAM_ALLOC_STATS, global operator new/delete are
+ * replaced with versions that stamp each allocation with the tag active
+ * on the calling thread and keep cumulative byte and allocation counters
+ * per tag. ALLOC_TAG(tag) sets the tag for the enclosing scope; nested
+ * scopes restore the previous tag on exit, and untagged allocations land
+ * in the 'none' bucket.
+ *
+ * Counters are monotonic so consumers can diff snapshots to get rates;
+ * the tangram_infos overlay reports per-tag bytes and allocations per
+ * second this way. Without TANGRAM_ALLOC_STATS everything here compiles
+ * to nothing.
+ */
+
+namespace Tangram {
+
+namespace AllocStats {
+
+enum Tag : uint8_t {
+    none = 0,
+    tileParse,
+    styleBuild,
+    labels,
+    scene,
+    tagCount,
+};
+
+/* Display name for a tag, e.g. for the stats overlay. */
+const char* tagName(Tag _tag);
+
+/* Cumulative counters for one tag; bytes and allocs only grow. */
+struct TagStats {
+    size_t bytes = 0;
+    size_t allocs = 0;
+    size_t liveBytes = 0;
+};
+
+/* Snapshot of the counters for _tag. */
+TagStats stats(Tag _tag);
+
+/* RAII tag for allocations on the calling thread; use through ALLOC_TAG. */
+struct Scope {
+    Scope(Tag _tag);
+    ~Scope();
+
+private:
+    Tag m_previous;
+};
+
+}
+
+}
+
+#ifdef TANGRAM_ALLOC_STATS
+#define ALLOC_TAG_CONCAT_IMPL(a, b) a ## b
+#define ALLOC_TAG_CONCAT(a, b) ALLOC_TAG_CONCAT_IMPL(a, b)
+#define ALLOC_TAG(_tag) \
+    Tangram::AllocStats::Scope ALLOC_TAG_CONCAT(_allocTag, __LINE__)(Tangram::AllocStats::_tag)
+#else
+#define ALLOC_TAG(_tag)
+#endif
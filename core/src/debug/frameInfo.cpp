@@ -1,6 +1,8 @@
 #include "debug/frameInfo.h"
 
 #include "tangram.h"
+#include "debug/allocStats.h"
+#include "debug/gpuProfiler.h"
 #include "debug/textDisplay.h"
 #include "tile/tileManager.h"
 #include "tile/tile.h"
@@ -10,6 +12,7 @@
 #include "gl.h"
 #include "gl/error.h"
 
+#include <algorithm>
 #include <deque>
 #include <ctime>
 
@@ -17,6 +20,12 @@
 
 #define DEBUG_STATS_MAX_SIZE 128
 
+// Rolling window for frame-time percentiles
+#define FRAME_STATS_WINDOW 256
+
+// 60Hz deadline; frames over this count as dropped and get classified
+#define FRAME_BUDGET_MS 16.7f
+
 namespace Tangram {
 
 static float s_lastUpdateTime = 0.0;
@@ -26,6 +35,57 @@ static clock_t s_startFrameTime = 0,
     s_startUpdateTime = 0,
     s_endUpdateTime = 0;
 
+static float s_frameTimes[FRAME_STATS_WINDOW] = { 0 };
+static size_t s_frameCount = 0;
+static size_t s_droppedFrames = 0;
+static FrameStats s_worstFrame;
+
+bool FrameInfo::recordFrameTime(float _frameMs) {
+
+    s_frameTimes[s_frameCount % FRAME_STATS_WINDOW] = _frameMs;
+    s_frameCount++;
+
+    if (_frameMs > FRAME_BUDGET_MS) {
+        s_droppedFrames++;
+        return true;
+    }
+    return false;
+}
+
+void FrameInfo::recordJank(float _frameMs, size_t _tilesLoading, size_t _labels,
+                           size_t _pendingUploads) {
+
+    if (_frameMs <= s_worstFrame.worstFrameMs) { return; }
+
+    s_worstFrame.worstFrameMs = _frameMs;
+    s_worstFrame.worstFrameTilesLoading = _tilesLoading;
+    s_worstFrame.worstFrameLabels = _labels;
+    s_worstFrame.worstFramePendingUploads = _pendingUploads;
+}
+
+FrameStats FrameInfo::getFrameStats() {
+
+    FrameStats stats = s_worstFrame;
+    stats.frameCount = s_frameCount;
+    stats.droppedFrames = s_droppedFrames;
+
+    size_t filled = std::min(s_frameCount, size_t(FRAME_STATS_WINDOW));
+    if (filled > 0) {
+        float sorted[FRAME_STATS_WINDOW];
+        std::copy(s_frameTimes, s_frameTimes + filled, sorted);
+        std::sort(sorted, sorted + filled);
+
+        stats.p50Ms = sorted[(filled - 1) * 50 / 100];
+        stats.p95Ms = sorted[(filled - 1) * 95 / 100];
+        stats.p99Ms = sorted[(filled - 1) * 99 / 100];
+    }
+
+    // Each telemetry pull reports its own worst frame
+    s_worstFrame = FrameStats();
+
+    return stats;
+}
+
 void FrameInfo::beginUpdate() {
 
     if (getDebugFlag(DebugFlags::tangram_infos) || getDebugFlag(DebugFlags::tangram_stats)) {
@@ -52,7 +112,8 @@ void FrameInfo::beginFrame() {
 }
 
 
-void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManager) {
+void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManager,
+                     const GpuProfiler& _gpuProfiler) {
 
     if (getDebugFlag(DebugFlags::tangram_infos) || getDebugFlag(DebugFlags::tangram_stats)) {
         static int cpt = 0;
@@ -106,23 +167,61 @@ void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManag
         }
 
         if (getDebugFlag(DebugFlags::tangram_infos)) {
-            std::vector<std::string> debuginfos;
-
-            debuginfos.push_back("visible tiles:"
-                                 + std::to_string(_tileManager.getVisibleTiles().size()));
-            debuginfos.push_back("tile cache size:"
-                                 + std::to_string(_tileManager.getTileCache()->getMemoryUsage() / 1024) + "kb");
-            debuginfos.push_back("tile size:" + std::to_string(memused / 1024) + "kb");
-            debuginfos.push_back("avg frame cpu time:" + to_string_with_precision(avgTimeCpu, 2) + "ms");
-            debuginfos.push_back("avg frame render time:" + to_string_with_precision(avgTimeRender, 2) + "ms");
-            debuginfos.push_back("avg frame update time:" + to_string_with_precision(avgTimeUpdate, 2) + "ms");
-            debuginfos.push_back("zoom:" + std::to_string(_view.getZoom()));
-            debuginfos.push_back("pos:" + std::to_string(_view.getPosition().x) + "/"
-                                 + std::to_string(_view.getPosition().y));
-            debuginfos.push_back("tilt:" + std::to_string(_view.getPitch() * 57.3) + "deg");
-            debuginfos.push_back("pixel scale:" + std::to_string(_view.pixelScale()));
-
-            TextDisplay::Instance().draw(rs, debuginfos);
+            auto& display = TextDisplay::Instance();
+            display.beginInfos();
+
+            display.info("visible tiles:%d", int(_tileManager.getVisibleTiles().size()));
+            display.info("tile cache size:%dkb",
+                         int(_tileManager.getTileCache()->getMemoryUsage() / 1024));
+            display.info("tile size:%dkb", int(memused / 1024));
+            display.info("avg frame cpu time:%.2fms", avgTimeCpu);
+            display.info("avg frame render time:%.2fms", avgTimeRender);
+            display.info("avg frame update time:%.2fms", avgTimeUpdate);
+
+            // Rolling GPU time per style pass, when timer queries are available
+            for (const auto& entry : _gpuProfiler.stats()) {
+                display.info("gpu %s:%.2fms", entry.name.c_str(), entry.averageMs);
+            }
+#ifdef TANGRAM_ALLOC_STATS
+            // Allocation churn per tag, diffed against the last second
+            static AllocStats::TagStats lastStats[AllocStats::tagCount];
+            static clock_t lastStatsTime = 0;
+            static float bytesPerSec[AllocStats::tagCount] = { 0 };
+            static float allocsPerSec[AllocStats::tagCount] = { 0 };
+
+            clock_t statsNow = clock();
+            float interval = TIME_TO_MS(lastStatsTime, statsNow) / 1000.f;
+            if (interval >= 1.f) {
+                for (int i = 0; i < AllocStats::tagCount; i++) {
+                    auto tagStats = AllocStats::stats(AllocStats::Tag(i));
+                    bytesPerSec[i] = (tagStats.bytes - lastStats[i].bytes) / interval;
+                    allocsPerSec[i] = (tagStats.allocs - lastStats[i].allocs) / interval;
+                    lastStats[i] = tagStats;
+                }
+                lastStatsTime = statsNow;
+            }
+            for (int i = 0; i < AllocStats::tagCount; i++) {
+                auto tag = AllocStats::Tag(i);
+                display.info("alloc %s:%.2fMB/s %d/s %dkb live", AllocStats::tagName(tag),
+                             bytesPerSec[i] / (1024.f * 1024.f), int(allocsPerSec[i]),
+                             int(AllocStats::stats(tag).liveBytes / 1024));
+            }
+#endif
+
+            display.info("zoom:%f", _view.getZoom());
+            display.info("pos:%f/%f", _view.getPosition().x, _view.getPosition().y);
+            display.info("tilt:%fdeg", _view.getPitch() * 57.3);
+            display.info("pixel scale:%f", _view.pixelScale());
+
+            // State changes the render state cache could not eliminate
+            const auto& stats = rs.stats();
+            display.info("program binds:%u", stats.programBinds);
+            display.info("texture binds:%u", stats.textureBinds);
+            display.info("blend changes:%u", stats.blendChanges);
+            display.info("buffer binds:%u", stats.bufferBinds);
+            display.info("vao binds:%u", stats.vertexArrayBinds);
+
+            display.draw(rs);
         }
 
         if (getDebugFlag(DebugFlags::tangram_stats)) {
@@ -143,8 +242,13 @@ void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManag
             Primitives::setColor(rs, 0xff0000);
             Primitives::drawLine(rs, glm::vec2(0.0, 16.6 * scale),
                 glm::vec2(DEBUG_STATS_MAX_SIZE * 4 * _view.pixelScale() + 4, 16.6 * scale));
+
+            Primitives::flush(rs);
         }
     }
+
+    // Start the state-change counters fresh for the next frame
+    rs.resetStats();
 }
 
 }
@@ -2,10 +2,13 @@
 
 namespace Tangram {
 
+class GpuProfiler;
 class RenderState;
 class TileManager;
 class View;
 
+struct FrameStats;
+
 struct FrameInfo {
 
     static void beginUpdate();
@@ -13,7 +16,23 @@ struct FrameInfo {
 
     static void endUpdate();
 
-    static void draw(RenderState& rs, const View& _view, TileManager& _tileManager);
+    static void draw(RenderState& rs, const View& _view, TileManager& _tileManager,
+                     const GpuProfiler& _gpuProfiler);
+
+    /* Add a frame to the rolling frame-time histogram. Returns true when
+     * the frame missed the 60Hz budget, in which case the caller should
+     * classify it with recordJank. Render thread only. */
+    static bool recordFrameTime(float _frameMs);
+
+    /* Attach an engine-state snapshot to an over-budget frame; kept when
+     * it is the slowest since the stats were last read. */
+    static void recordJank(float _frameMs, size_t _tilesLoading, size_t _labels,
+                           size_t _pendingUploads);
+
+    /* Percentiles over the rolling window plus cumulative counts; the
+     * worst-frame snapshot is cleared on read so periodic telemetry pulls
+     * each report their own worst frame. */
+    static FrameStats getFrameStats();
 };
 
 }
@@ -0,0 +1,97 @@
+#include "debug/gpuProfiler.h"
+
+#include "tangram.h"
+#include "gl/hardware.h"
+#include "log.h"
+
+#define MAX_QUERY_FRAME_LAG 60
+#define ROLLING_AVERAGE_FACTOR 0.1f
+
+namespace Tangram {
+
+void GpuProfiler::beginFrame() {
+
+    m_frameActive = false;
+
+    if (m_disabled || !Hardware::supportsTimerQueries) { return; }
+
+    m_frame++;
+
+    // Results complete in submission order - poll oldest first and stop
+    // at the first query still in flight.
+    while (!m_pending.empty()) {
+        auto& pending = m_pending.front();
+
+        GLuint available = 0;
+        GL::getQueryObjectuiv(pending.query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (!available) {
+            if (m_frame - pending.frame > MAX_QUERY_FRAME_LAG) {
+                LOGW("Timer query results never arrived, disabling GPU profiling");
+                m_disabled = true;
+                m_pending.clear();
+            }
+            break;
+        }
+
+        GLuint elapsed = 0;
+        GL::getQueryObjectuiv(pending.query, GL_QUERY_RESULT, &elapsed);
+
+        auto& stat = m_stats[pending.statIndex];
+        stat.averageMs += (elapsed / 1.0e6f - stat.averageMs) * ROLLING_AVERAGE_FACTOR;
+
+        m_queryPool.push_back(pending.query);
+        m_pending.erase(m_pending.begin());
+    }
+
+    if (m_disabled) { return; }
+
+    if (getDebugFlag(DebugFlags::tangram_infos) || getDebugFlag(DebugFlags::tangram_stats)) {
+        m_frameActive = true;
+    }
+}
+
+void GpuProfiler::begin(const std::string& _name) {
+
+    if (!m_frameActive || m_scopeActive) { return; }
+
+    GLuint query = 0;
+    if (!m_queryPool.empty()) {
+        query = m_queryPool.back();
+        m_queryPool.pop_back();
+    } else {
+        GL::genQueries(1, &query);
+    }
+
+    GL::beginQuery(GL_TIME_ELAPSED, query);
+    m_pending.push_back({ query, m_frame, statIndex(_name) });
+    m_scopeActive = true;
+}
+
+void GpuProfiler::end() {
+
+    if (!m_scopeActive) { return; }
+
+    GL::endQuery(GL_TIME_ELAPSED);
+    m_scopeActive = false;
+}
+
+void GpuProfiler::invalidate() {
+
+    m_pending.clear();
+    m_queryPool.clear();
+    m_scopeActive = false;
+    m_frameActive = false;
+    m_disabled = false;
+}
+
+size_t GpuProfiler::statIndex(const std::string& _name) {
+
+    for (size_t i = 0; i < m_stats.size(); i++) {
+        if (m_stats[i].name == _name) { return i; }
+    }
+    m_stats.push_back({ _name, 0.f });
+    return m_stats.size() - 1;
+}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "gl.h"
+
+#include <string>
+#include <vector>
+
+namespace Tangram {
+
+/* GpuProfiler - per-pass GPU timing through GL timer queries
+ *
+ * Wraps draw groups in GL_TIME_ELAPSED queries when the driver exposes
+ * a timer_query extension (Hardware::supportsTimerQueries) and keeps a
+ * rolling average per scope name, so the GPU cost of each style pass is
+ * visible next to the CPU times FrameInfo already shows.
+ *
+ * Query results arrive some frames after the draws they measure;
+ * beginFrame() polls finished queries without stalling, so the averages
+ * trail the rendered frames by the GPU pipeline depth. Profiling is only
+ * active while the tangram_infos or tangram_stats debug flag is set.
+ */
+class GpuProfiler {
+
+public:
+
+    struct Entry {
+        std::string name;
+        float averageMs = 0.f;
+    };
+
+    /* Poll finished queries and start accepting scopes for this frame. */
+    void beginFrame();
+
+    /* Time a draw group. Scopes cannot nest - the GL allows a single
+     * active GL_TIME_ELAPSED query. */
+    void begin(const std::string& _name);
+    void end();
+
+    /* Forget outstanding queries; they died with the GL context. */
+    void invalidate();
+
+    /* Rolling per-scope GPU time averages, ordered by first appearance. */
+    const std::vector<Entry>& stats() const { return m_stats; }
+
+private:
+
+    struct PendingQuery {
+        GLuint query;
+        uint32_t frame;
+        size_t statIndex;
+    };
+
+    size_t statIndex(const std::string& _name);
+
+    std::vector<Entry> m_stats;
+
+    // Issued queries awaiting results, oldest first.
+    std::vector<PendingQuery> m_pending;
+
+    // Query objects available for reuse.
+    std::vector<GLuint> m_queryPool;
+
+    uint32_t m_frame = 0;
+    bool m_frameActive = false;
+    bool m_scopeActive = false;
+
+    // Set when the driver advertises the extension but never delivers
+    // results, to stop issuing queries that would pile up forever.
+    bool m_disabled = false;
+};
+
+}
@@ -0,0 +1,93 @@
+#include "debug/sceneLoadProfile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+namespace Tangram {
+
+namespace SceneLoadProfile {
+
+namespace {
+
+std::mutex s_mutex;
+SceneLoadReport s_report;
+int64_t s_loadStart = 0;
+
+int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+void beginLoad() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_report = SceneLoadReport();
+    s_loadStart = nowUs();
+}
+
+void endLoad() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_report.totalMs = (nowUs() - s_loadStart) / 1000.f;
+}
+
+int64_t now() {
+    return nowUs();
+}
+
+float msSince(int64_t _start) {
+    return (nowUs() - _start) / 1000.f;
+}
+
+void addResource(const std::string& _url, size_t _bytes, float _ms) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_report.resources.push_back({ _url, _bytes, _ms });
+}
+
+void addShader(const std::string& _name, float _ms) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_report.shaders.push_back({ _name, _ms });
+}
+
+SceneLoadReport report() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_report;
+}
+
+Phase::Phase(const char* _name) : m_name(_name), m_start(nowUs()) {}
+
+Phase::~Phase() {
+    float ms = (nowUs() - m_start) / 1000.f;
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_report.phases.push_back({ std::move(m_name), ms });
+}
+
+}
+
+std::string SceneLoadReport::toString() const {
+
+    std::string out;
+    char line[256];
+
+    snprintf(line, sizeof(line), "scene load: %.1fms\n", totalMs);
+    out += line;
+
+    for (const auto& phase : phases) {
+        snprintf(line, sizeof(line), "  phase %s: %.1fms\n", phase.name.c_str(), phase.ms);
+        out += line;
+    }
+    for (const auto& resource : resources) {
+        snprintf(line, sizeof(line), "  fetch %s: %zub %.1fms\n",
+                 resource.url.c_str(), resource.bytes, resource.ms);
+        out += line;
+    }
+    for (const auto& shader : shaders) {
+        snprintf(line, sizeof(line), "  shader %s: %.1fms\n", shader.name.c_str(), shader.ms);
+        out += line;
+    }
+
+    return out;
+}
+
+}
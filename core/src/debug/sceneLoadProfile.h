@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Scene-load profiling.
+ *
+ * SceneLoadProfile collects timings while a scene loads: the duration of
+ * each load phase (imports, fonts, applyConfig), the bytes and fetch time
+ * of every URL resource, and the compile time of each shader program.
+ * Collection restarts with each beginLoad(), so the report always covers
+ * the most recent scene load.
+ *
+ * Shader programs build lazily on first use, so their entries keep
+ * accruing during the first frames after the load phases complete; pull
+ * the report once the map has settled to get the full startup picture.
+ */
+
+namespace Tangram {
+
+struct SceneLoadReport {
+
+    struct Phase {
+        std::string name;
+        float ms = 0.f;
+    };
+
+    struct Resource {
+        std::string url;
+        size_t bytes = 0;
+        float ms = 0.f;
+    };
+
+    struct Shader {
+        std::string name;
+        float ms = 0.f;
+    };
+
+    std::vector<Phase> phases;
+    std::vector<Resource> resources;
+    std::vector<Shader> shaders;
+
+    // From beginLoad to endLoad; 0 while the load is still running
+    float totalMs = 0.f;
+
+    /* Multi-line summary for logging. */
+    std::string toString() const;
+};
+
+namespace SceneLoadProfile {
+
+/* Start a fresh report; drops the previous one. */
+void beginLoad();
+
+/* Close the report's total time; entries may still accrue (shaders). */
+void endLoad();
+
+/* Record a fetched resource with its size and fetch duration. */
+void addResource(const std::string& _url, size_t _bytes, float _ms);
+
+/* Timestamp helpers for timing async fetches across a callback. */
+int64_t now();
+float msSince(int64_t _start);
+
+/* Record one shader program build. */
+void addShader(const std::string& _name, float _ms);
+
+/* Snapshot of the current report. */
+SceneLoadReport report();
+
+/* RAII phase timer; phases on concurrent threads may overlap. */
+struct Phase {
+    Phase(const char* _name);
+    ~Phase();
+
+private:
+    std::string m_name;
+    int64_t m_start;
+};
+
+}
+
+}
@@ -0,0 +1,214 @@
+#include "debug/sessionRecorder.h"
+
+#include "tangram.h"
+#include "log.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace Tangram {
+
+namespace {
+
+const char* callNames[] = {
+    "tapGesture",
+    "doubleTapGesture",
+    "panGesture",
+    "flingGesture",
+    "pinchGesture",
+    "rotateGesture",
+    "shoveGesture",
+    "setPosition",
+    "setZoom",
+    "setRotation",
+    "setTilt",
+};
+
+int argCount(SessionEvent::Call _call) {
+    switch (_call) {
+    case SessionEvent::Call::tapGesture:
+    case SessionEvent::Call::doubleTapGesture:
+    case SessionEvent::Call::setPosition:
+        return 2;
+    case SessionEvent::Call::panGesture:
+    case SessionEvent::Call::flingGesture:
+    case SessionEvent::Call::pinchGesture:
+        return 4;
+    case SessionEvent::Call::rotateGesture:
+        return 3;
+    case SessionEvent::Call::shoveGesture:
+    case SessionEvent::Call::setZoom:
+    case SessionEvent::Call::setRotation:
+    case SessionEvent::Call::setTilt:
+        return 1;
+    }
+    return 0;
+}
+
+double now() {
+    return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+void SessionRecorder::start() {
+
+    m_events.clear();
+    m_startTime = now();
+    m_recording = true;
+}
+
+void SessionRecorder::record(SessionEvent::Call _call,
+                             double _a, double _b, double _c, double _d) {
+
+    if (!m_recording) { return; }
+
+    SessionEvent event;
+    event.time = float(now() - m_startTime);
+    event.call = _call;
+    event.args[0] = _a;
+    event.args[1] = _b;
+    event.args[2] = _c;
+    event.args[3] = _d;
+    m_events.push_back(event);
+}
+
+bool SessionRecorder::stop(const char* _path) {
+
+    m_recording = false;
+
+    std::ofstream file(_path);
+    if (!file.is_open()) {
+        LOGE("Failed to write session to path: %s", _path);
+        return false;
+    }
+
+    for (const auto& event : m_events) {
+        file << event.time << ' ' << callNames[uint8_t(event.call)];
+        for (int i = 0; i < argCount(event.call); i++) {
+            // Positions need full double precision to survive the round trip
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), " %.17g", event.args[i]);
+            file << buffer;
+        }
+        file << '\n';
+    }
+
+    m_events.clear();
+    return true;
+}
+
+bool SessionReplay::load(const char* _path) {
+
+    std::ifstream file(_path);
+    if (!file.is_open()) {
+        LOGE("Failed to read session at path: %s", _path);
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return parse(buffer.str());
+}
+
+bool SessionReplay::parse(const std::string& _session) {
+
+    m_events.clear();
+    reset();
+
+    std::stringstream stream(_session);
+    std::string line;
+
+    while (std::getline(stream, line)) {
+        if (line.empty() || line[0] == '#') { continue; }
+
+        std::stringstream fields(line);
+        SessionEvent event;
+        std::string name;
+
+        if (!(fields >> event.time >> name)) {
+            LOGW("Skipping malformed session line: %s", line.c_str());
+            continue;
+        }
+
+        bool known = false;
+        const int callCount = sizeof(callNames) / sizeof(callNames[0]);
+        for (int i = 0; i < callCount; i++) {
+            if (name == callNames[i]) {
+                event.call = SessionEvent::Call(i);
+                known = true;
+                break;
+            }
+        }
+        if (!known) {
+            LOGW("Skipping unknown session call: %s", name.c_str());
+            continue;
+        }
+
+        for (int i = 0; i < argCount(event.call); i++) {
+            fields >> event.args[i];
+        }
+
+        m_events.push_back(event);
+    }
+
+    return !m_events.empty();
+}
+
+bool SessionReplay::step(Map& _map, float _dt) {
+
+    m_time += _dt;
+
+    while (m_position < m_events.size() && m_events[m_position].time <= m_time) {
+
+        const auto& e = m_events[m_position++];
+        const auto& a = e.args;
+
+        switch (e.call) {
+        case SessionEvent::Call::tapGesture:
+            _map.handleTapGesture(a[0], a[1]);
+            break;
+        case SessionEvent::Call::doubleTapGesture:
+            _map.handleDoubleTapGesture(a[0], a[1]);
+            break;
+        case SessionEvent::Call::panGesture:
+            _map.handlePanGesture(a[0], a[1], a[2], a[3]);
+            break;
+        case SessionEvent::Call::flingGesture:
+            _map.handleFlingGesture(a[0], a[1], a[2], a[3]);
+            break;
+        case SessionEvent::Call::pinchGesture:
+            _map.handlePinchGesture(a[0], a[1], a[2], a[3]);
+            break;
+        case SessionEvent::Call::rotateGesture:
+            _map.handleRotateGesture(a[0], a[1], a[2]);
+            break;
+        case SessionEvent::Call::shoveGesture:
+            _map.handleShoveGesture(a[0]);
+            break;
+        case SessionEvent::Call::setPosition:
+            _map.setPosition(a[0], a[1]);
+            break;
+        case SessionEvent::Call::setZoom:
+            _map.setZoom(a[0]);
+            break;
+        case SessionEvent::Call::setRotation:
+            _map.setRotation(a[0]);
+            break;
+        case SessionEvent::Call::setTilt:
+            _map.setTilt(a[0]);
+            break;
+        }
+    }
+
+    return m_position < m_events.size();
+}
+
+float SessionReplay::duration() const {
+    return m_events.empty() ? 0.f : m_events.back().time;
+}
+
+}
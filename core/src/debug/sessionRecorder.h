@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Tangram {
+
+class Map;
+
+/* Interaction session record/replay.
+ *
+ * SessionRecorder captures the timestamped stream of camera-affecting
+ * Map API calls (gestures and position/zoom/rotation/tilt setters) so a
+ * user session reported from the field can be replayed deterministically.
+ * Tile bytes are not part of the capture - attach a DataSource disk
+ * cache during recording and replay against the same cache directory to
+ * get byte-identical tile data.
+ *
+ * Sessions are stored as plain text, one call per line:
+ *     <seconds> <call> <args...>
+ *
+ * SessionReplay feeds a session back into a Map on a fixed-step clock;
+ * combined with identical tile data this makes frame-time measurements
+ * comparable across builds.
+ */
+
+struct SessionEvent {
+
+    enum class Call : uint8_t {
+        tapGesture,
+        doubleTapGesture,
+        panGesture,
+        flingGesture,
+        pinchGesture,
+        rotateGesture,
+        shoveGesture,
+        setPosition,
+        setZoom,
+        setRotation,
+        setTilt,
+    };
+
+    float time = 0.f;
+    Call call;
+    double args[4] = { 0, 0, 0, 0 };
+};
+
+class SessionRecorder {
+
+public:
+
+    void start();
+
+    /* Append a call; no-op unless recording. */
+    void record(SessionEvent::Call _call,
+                double _a = 0, double _b = 0, double _c = 0, double _d = 0);
+
+    /* Stop recording and write the session to _path. */
+    bool stop(const char* _path);
+
+    bool isRecording() const { return m_recording; }
+
+private:
+
+    std::vector<SessionEvent> m_events;
+    double m_startTime = 0;
+    bool m_recording = false;
+};
+
+class SessionReplay {
+
+public:
+
+    bool load(const char* _path);
+    bool parse(const std::string& _session);
+
+    /* Advance the replay clock by _dt seconds and apply the calls that
+     * came due to _map. Returns false once the session is exhausted. */
+    bool step(Map& _map, float _dt);
+
+    void reset() { m_position = 0; m_time = 0.f; }
+
+    float duration() const;
+    size_t eventCount() const { return m_events.size(); }
+
+private:
+
+    std::vector<SessionEvent> m_events;
+    size_t m_position = 0;
+    float m_time = 0.f;
+};
+
+}
@@ -1,5 +1,6 @@
 #include "textDisplay.h"
 #include <cstdarg>
+#include <cstring>
 #include "platform.h"
 #include "gl/error.h"
 #include "gl/vertexLayout.h"
@@ -13,11 +14,13 @@
 namespace Tangram {
 
 TextDisplay::TextDisplay() : m_textDisplayResolution(200.0), m_initialized(false) {
-    m_vertexBuffer = new char[VERTEX_BUFFER_SIZE];
+    m_quadBuffer = new char[VERTEX_BUFFER_SIZE];
+    std::memset(m_log, 0, sizeof(m_log));
+    std::memset(m_infos, 0, sizeof(m_infos));
 }
 
 TextDisplay::~TextDisplay() {
-    delete[] m_vertexBuffer;
+    delete[] m_quadBuffer;
 }
 
 void TextDisplay::init() {
@@ -60,88 +63,138 @@ void TextDisplay::init() {
 void TextDisplay::deinit() {
 
     m_shader.reset(nullptr);
+    // The stream buffers die with the GL context
+    m_bufferRing.fill(0);
+    m_bufferRingSizes.fill(0);
+    m_generation = -1;
     m_initialized = false;
 
 }
 
 void TextDisplay::log(const char* fmt, ...) {
-    static char text[99999];
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_logStart = (m_logStart + LOG_CAPACITY - 1) % LOG_CAPACITY;
 
     va_list args;
     va_start(args, fmt);
-    vsprintf(text, fmt, args);
+    vsnprintf(m_log[m_logStart], DISPLAY_LINE_LENGTH, fmt, args);
     va_end(args);
+}
 
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
+void TextDisplay::beginInfos() {
+    m_infoCount = 0;
+}
 
-        for (int i = LOG_CAPACITY - 1; i >= 1; i--) {
-            m_log[i] = m_log[i - 1];
-        }
+void TextDisplay::info(const char* fmt, ...) {
 
-        m_log[0] = std::string(text);
-    }
+    if (m_infoCount >= DISPLAY_MAX_LINES) { return; }
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(m_infos[m_infoCount++], DISPLAY_LINE_LENGTH, fmt, args);
+    va_end(args);
 }
 
-void TextDisplay::draw(RenderState& rs, const std::string& _text, int _posx, int _posy) {
-    static VertexLayout vertexLayout({{"a_position", 2, GL_FLOAT, false, 0}});
-    std::vector<glm::vec2> vertices;
-    int nquads;
+void TextDisplay::buildText(const char* _text, int _posx, int _posy) {
 
-    nquads = stb_easy_font_print(_posx, _posy, _text.c_str(), NULL, m_vertexBuffer, VERTEX_BUFFER_SIZE);
+    int nquads = stb_easy_font_print(_posx, _posy, _text, NULL, m_quadBuffer, VERTEX_BUFFER_SIZE);
 
-    float* data = reinterpret_cast<float*>(m_vertexBuffer);
+    float* data = reinterpret_cast<float*>(m_quadBuffer);
 
-    vertices.reserve(nquads * 6);
     for (int quad = 0, stride = 0; quad < nquads; ++quad, stride += 16) {
-        vertices.push_back({data[(0 * 4) + stride], data[(0 * 4) + 1 + stride]});
-        vertices.push_back({data[(1 * 4) + stride], data[(1 * 4) + 1 + stride]});
-        vertices.push_back({data[(2 * 4) + stride], data[(2 * 4) + 1 + stride]});
-        vertices.push_back({data[(2 * 4) + stride], data[(2 * 4) + 1 + stride]});
-        vertices.push_back({data[(3 * 4) + stride], data[(3 * 4) + 1 + stride]});
-        vertices.push_back({data[(0 * 4) + stride], data[(0 * 4) + 1 + stride]});
+        m_vertices.push_back({data[(0 * 4) + stride], data[(0 * 4) + 1 + stride]});
+        m_vertices.push_back({data[(1 * 4) + stride], data[(1 * 4) + 1 + stride]});
+        m_vertices.push_back({data[(2 * 4) + stride], data[(2 * 4) + 1 + stride]});
+        m_vertices.push_back({data[(2 * 4) + stride], data[(2 * 4) + 1 + stride]});
+        m_vertices.push_back({data[(3 * 4) + stride], data[(3 * 4) + 1 + stride]});
+        m_vertices.push_back({data[(0 * 4) + stride], data[(0 * 4) + 1 + stride]});
     }
-    vertexLayout.enable(rs, *m_shader, 0, (void*)vertices.data());
-
-    GL::drawArrays(GL_TRIANGLES, 0, nquads * 6);
 }
 
-void TextDisplay::draw(RenderState& rs, const std::vector<std::string>& _infos) {
-    GLint boundbuffer = -1;
+void TextDisplay::draw(RenderState& rs) {
+    static VertexLayout vertexLayout({{"a_position", 2, GL_FLOAT, false, 0}});
 
     if (!m_shader->use(rs)) { return; }
 
+    // Tessellate both color groups into the persistent vertex stream
+    m_vertices.clear();
+
+    int offset = 0;
+    for (int i = 0; i < m_infoCount; i++) {
+        buildText(m_infos[i], 3, 3 + offset);
+        offset += 10;
+    }
+    size_t infoVertices = m_vertices.size();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        offset = 0;
+        for (int i = 0; i < LOG_CAPACITY; ++i) {
+            const char* line = m_log[(m_logStart + i) % LOG_CAPACITY];
+            if (line[0] != '\0') {
+                buildText(line, 3, m_textDisplayResolution.y - 10 + offset);
+            }
+            offset -= 10;
+        }
+    }
+
+    if (m_vertices.empty()) { return; }
+
     rs.culling(GL_FALSE);
     rs.blending(GL_FALSE);
     rs.depthTest(GL_FALSE);
     rs.depthMask(GL_FALSE);
 
-    GL::getIntegerv(GL_ARRAY_BUFFER_BINDING, &boundbuffer);
-    rs.vertexBuffer(0);
+    if (!rs.isValidGeneration(m_generation)) {
+        m_bufferRing.fill(0);
+        m_bufferRingSizes.fill(0);
+        m_generation = rs.generation();
+    }
+
+    // Stream into the next ring buffer; it was last drawn
+    // BUFFER_RING_SIZE frames ago, so the write waits on nothing
+    size_t vertexBytes = m_vertices.size() * sizeof(glm::vec2);
+
+    m_ringIndex = (m_ringIndex + 1) % BUFFER_RING_SIZE;
+    auto& buffer = m_bufferRing[m_ringIndex];
+    auto& bufferSize = m_bufferRingSizes[m_ringIndex];
+
+    if (buffer == 0) {
+        buffer = rs.getBufferObject(vertexBytes);
+        bufferSize = 0;
+    }
+
+    rs.vertexBuffer(buffer);
+
+    size_t sizeClass = RenderState::bufferSizeClass(vertexBytes);
+    if (bufferSize < sizeClass) {
+        GL::bufferData(GL_ARRAY_BUFFER, sizeClass, nullptr, GL_DYNAMIC_DRAW);
+        bufferSize = sizeClass;
+    }
+
+    GL::bufferSubData(GL_ARRAY_BUFFER, 0, vertexBytes, m_vertices.data());
 
     glm::mat4 orthoProj = glm::ortho(0.f, (float)m_textDisplayResolution.x, (float)m_textDisplayResolution.y, 0.f, -1.f, 1.f);
     m_shader->setUniformMatrix4f(rs, m_uOrthoProj, orthoProj);
 
-    // Display Tangram info messages
+    vertexLayout.enable(rs, *m_shader, 0, nullptr);
+
+    // The info block and the screen log are contiguous ranges of the one
+    // stream, so the overlay costs two draw calls
     m_shader->setUniformf(rs, m_uColor, 0.f, 0.f, 0.f);
-    int offset = 0;
-    for (auto& text : _infos) {
-        draw(rs, text, 3, 3 + offset);
-        offset += 10;
+    if (infoVertices > 0) {
+        GL::drawArrays(GL_TRIANGLES, 0, GLsizei(infoVertices));
     }
 
-    // Display screen log
-    offset = 0;
-    m_shader->setUniformf(rs, m_uColor, 51 / 255.f, 73 / 255.f, 120 / 255.f);
-    for (int i = 0; i < LOG_CAPACITY; ++i) {
-        draw(rs, m_log[i], 3, m_textDisplayResolution.y - 10 + offset);
-        offset -= 10;
+    if (m_vertices.size() > infoVertices) {
+        m_shader->setUniformf(rs, m_uColor, 51 / 255.f, 73 / 255.f, 120 / 255.f);
+        GL::drawArrays(GL_TRIANGLES, GLint(infoVertices),
+                       GLsizei(m_vertices.size() - infoVertices));
     }
 
     rs.culling(GL_TRUE);
-    rs.vertexBuffer(boundbuffer);
 }
 
 }
-
-
@@ -1,31 +1,23 @@
 #pragma once
 
-#include <string>
-#include <vector>
-#include <mutex>
+#include <array>
 #include <cstdio>
-#include "gl/texture.h"
-#include "gl/mesh.h"
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "gl/shaderProgram.h"
 #include "glm/vec2.hpp"
-#include <sstream>
-#include <iomanip>
 
 namespace Tangram {
 
 #define LOG_CAPACITY        10
 #define VERTEX_BUFFER_SIZE  99999
+#define DISPLAY_MAX_LINES   64
+#define DISPLAY_LINE_LENGTH 128
 
 typedef int FontID;
 class RenderState;
 
-template <typename T>
-std::string to_string_with_precision(const T a_value, const int n = 6) {
-    std::ostringstream out;
-    out << std::fixed << std::setprecision(n) << a_value;
-    return out.str();
-}
-
 class TextDisplay {
 
 public:
@@ -43,8 +35,16 @@ public:
     void init();
     void deinit();
 
-    /* Draw stacked messages added through log and draw _infos string list */
-    void draw(RenderState& rs, const std::vector<std::string>& _infos);
+    /* Reset the info block; lines added with info() afterwards are drawn
+     * by the next draw() call */
+    void beginInfos();
+
+    /* printf-style formatting into a fixed line slot, so a frame's info
+     * block allocates nothing. Lines beyond the capacity are dropped. */
+    void info(const char* fmt, ...);
+
+    /* Draw the info block and the stacked log messages */
+    void draw(RenderState& rs);
 
     /* Stack the log message to be displayed in the screen log */
     void log(const char* fmt, ...);
@@ -53,14 +53,35 @@ private:
 
     TextDisplay();
 
-    void draw(RenderState& rs, const std::string& _text, int _posx, int _posy);
+    /* Append the glyph quads of _text at the given position to m_vertices */
+    void buildText(const char* _text, int _posx, int _posy);
 
     glm::vec2 m_textDisplayResolution;
     bool m_initialized;
     std::unique_ptr<ShaderProgram> m_shader;
-    std::string m_log[LOG_CAPACITY];
+
+    // Fixed line slots; the log is a ring with m_logStart at the newest entry
+    char m_log[LOG_CAPACITY][DISPLAY_LINE_LENGTH];
+    int m_logStart = 0;
+    char m_infos[DISPLAY_MAX_LINES][DISPLAY_LINE_LENGTH];
+    int m_infoCount = 0;
+
     std::mutex m_mutex;
-    char* m_vertexBuffer;
+
+    // Scratch the glyph tessellation of one line is written into
+    char* m_quadBuffer;
+
+    // All lines of a frame collected into one vertex stream; the capacity
+    // settles after the first frame, so steady state does not allocate
+    std::vector<glm::vec2> m_vertices;
+
+    // Ring of stream buffers, rotated per frame like DynamicQuadMesh so
+    // the upload never waits on a buffer still in flight
+    static constexpr int BUFFER_RING_SIZE = 3;
+    std::array<GLuint, BUFFER_RING_SIZE> m_bufferRing = {{ 0 }};
+    std::array<size_t, BUFFER_RING_SIZE> m_bufferRingSizes = {{ 0 }};
+    int m_ringIndex = 0;
+    int m_generation = -1;
 
     UniformLocation m_uOrthoProj{"u_orthoProj"};
     UniformLocation m_uColor{"u_color"};
@@ -0,0 +1,145 @@
+#include "debug/trace.h"
+
+#include "log.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+namespace Trace {
+
+namespace {
+
+// Events past this count are dropped rather than growing without bound.
+const size_t MAX_TRACE_EVENTS = 1 << 18;
+
+struct Event {
+    std::string name;
+    uint64_t tid;
+    int64_t ts;
+    int64_t dur;
+};
+
+std::atomic<bool> s_capturing { false };
+
+std::mutex s_mutex;
+std::vector<Event> s_events;
+std::unordered_map<uint64_t, std::string> s_threadNames;
+std::chrono::steady_clock::time_point s_captureStart;
+size_t s_dropped = 0;
+
+uint64_t threadId() {
+    return std::hash<std::thread::id>()(std::this_thread::get_id());
+}
+
+int64_t microsSinceStart() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - s_captureStart).count();
+}
+
+// Trace-event names come from code and thread labels; escaping quotes
+// and backslashes covers everything that can reach them.
+void appendEscaped(std::string& out, const std::string& str) {
+    for (char c : str) {
+        if (c == '"' || c == '\\') { out += '\\'; }
+        out += c;
+    }
+}
+
+}
+
+void beginCapture() {
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_events.clear();
+    s_events.reserve(4096);
+    s_dropped = 0;
+    s_captureStart = std::chrono::steady_clock::now();
+    s_capturing.store(true);
+}
+
+std::string endCapture() {
+
+    s_capturing.store(false);
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    if (s_dropped > 0) {
+        LOGW("Trace capture dropped %d events past the %d event limit",
+             int(s_dropped), int(MAX_TRACE_EVENTS));
+    }
+
+    std::string json = "{\"traceEvents\":[";
+    bool first = true;
+
+    for (const auto& entry : s_threadNames) {
+        if (!first) { json += ','; }
+        first = false;
+        json += "{\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(entry.first);
+        json += ",\"name\":\"thread_name\",\"args\":{\"name\":\"";
+        appendEscaped(json, entry.second);
+        json += "\"}}";
+    }
+
+    for (const auto& event : s_events) {
+        if (!first) { json += ','; }
+        first = false;
+        json += "{\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(event.tid);
+        json += ",\"ts\":" + std::to_string(event.ts);
+        json += ",\"dur\":" + std::to_string(event.dur);
+        json += ",\"name\":\"";
+        appendEscaped(json, event.name);
+        json += "\"}";
+    }
+
+    json += "]}";
+
+    s_events.clear();
+    return json;
+}
+
+bool capturing() {
+    return s_capturing.load(std::memory_order_relaxed);
+}
+
+void setThreadName(const char* _name) {
+
+    // Thread names are kept across captures; a worker started before
+    // beginCapture is still labeled in the export.
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_threadNames[threadId()] = _name;
+}
+
+Scope::Scope(const char* _name) {
+    if (!capturing()) { return; }
+    m_name = _name;
+    m_start = microsSinceStart();
+}
+
+Scope::Scope(std::string _name) {
+    if (!capturing()) { return; }
+    m_name = std::move(_name);
+    m_start = microsSinceStart();
+}
+
+Scope::~Scope() {
+    if (m_start < 0) { return; }
+
+    int64_t end = microsSinceStart();
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (s_events.size() >= MAX_TRACE_EVENTS) {
+        s_dropped++;
+        return;
+    }
+    s_events.push_back({ std::move(m_name), threadId(), m_start, end - m_start });
+}
+
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/*
+ * Scoped-event tracing emitting Chrome trace-event JSON.
+ *
+ * TRACE_SCOPE("name") records a complete event covering the enclosing
+ * scope on the calling thread; TRACE_THREAD("name") labels the calling
+ * thread in the exported trace. Events are only recorded between
+ * Trace::beginCapture() and Trace::endCapture(), which returns a JSON
+ * document loadable in chrome://tracing or any trace-event viewer -
+ * the same format on every platform, so traces from Android, iOS and
+ * Linux line up side by side.
+ *
+ * The macros compile to nothing unless TANGRAM_TRACE is defined, which
+ * Debug builds do by default; outside a capture an enabled scope costs
+ * one relaxed atomic load.
+ */
+
+#if !defined(TANGRAM_TRACE) && defined(DEBUG)
+#define TANGRAM_TRACE
+#endif
+
+namespace Tangram {
+
+namespace Trace {
+
+/* Start recording trace events; drops any previous capture. */
+void beginCapture();
+
+/* Stop recording and return the capture as trace-event JSON. */
+std::string endCapture();
+
+/* Whether a capture is currently recording. */
+bool capturing();
+
+/* Name the calling thread in exported traces. */
+void setThreadName(const char* _name);
+
+/* RAII duration event; use through TRACE_SCOPE. */
+struct Scope {
+    Scope(const char* _name);
+    Scope(std::string _name);
+    ~Scope();
+
+private:
+    std::string m_name;
+    int64_t m_start = -1;
+};
+
+}
+
+}
+
+#ifdef TANGRAM_TRACE
+#define TRACE_CONCAT_IMPL(a, b) a ## b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(_name) Tangram::Trace::Scope TRACE_CONCAT(_traceScope, __LINE__)(_name)
+#define TRACE_THREAD(_name) Tangram::Trace::setThreadName(_name)
+#else
+#define TRACE_SCOPE(_name)
+#define TRACE_THREAD(_name)
+#endif
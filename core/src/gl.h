@@ -225,6 +225,24 @@ typedef char            GLchar;
 #define GL_TEXTURE_MAG_FILTER           0x2800
 #define GL_TEXTURE_MIN_FILTER           0x2801
 
+/* timer_query */
+#define GL_QUERY_RESULT                 0x8866
+#define GL_QUERY_RESULT_AVAILABLE       0x8867
+#define GL_TIME_ELAPSED                 0x88BF
+
+/* framebuffer_object */
+#define GL_FRAMEBUFFER                  0x8D40
+#define GL_RENDERBUFFER                 0x8D41
+#define GL_COLOR_ATTACHMENT0            0x8CE0
+#define GL_DEPTH_ATTACHMENT             0x8D00
+#define GL_FRAMEBUFFER_COMPLETE         0x8CD5
+#define GL_FRAMEBUFFER_BINDING          0x8CA6
+
+/* EXT_discard_framebuffer - default framebuffer attachment names */
+#define GL_COLOR_EXT                    0x1800
+#define GL_DEPTH_EXT                    0x1801
+#define GL_STENCIL_EXT                  0x1802
+
 // glext.h
 #define GL_ARRAY_BUFFER                 0x8892
 #define GL_ELEMENT_ARRAY_BUFFER         0x8893
@@ -233,12 +251,17 @@ typedef char            GLchar;
 #define GL_STATIC_DRAW                  0x88E4
 #define GL_DYNAMIC_DRAW                 0x88E8
 
+// pixel_buffer_object
+#define GL_PIXEL_PACK_BUFFER            0x88EB
+#define GL_STREAM_READ                  0x88E1
+
 // Program
 #define GL_FRAGMENT_SHADER              0x8B30
 #define GL_VERTEX_SHADER                0x8B31
 #define GL_COMPILE_STATUS               0x8B81
 #define GL_LINK_STATUS                  0x8B82
 #define GL_INFO_LOG_LENGTH              0x8B84
+#define GL_PROGRAM_BINARY_LENGTH        0x8741
 
 // mapbuffer
 #define GL_READ_ONLY                    0x88B8
@@ -248,6 +271,15 @@ typedef char            GLchar;
 #define GL_MAX_TEXTURE_SIZE             0x0D33
 #define GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS 0x8B4D
 
+/* KHR_debug */
+#define GL_DEBUG_OUTPUT                 0x92E0
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS     0x8242
+#define GL_DEBUG_TYPE_ERROR             0x824C
+#define GL_DEBUG_SEVERITY_HIGH          0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM        0x9147
+#define GL_DEBUG_SEVERITY_LOW           0x9148
+#define GL_DEBUG_SEVERITY_NOTIFICATION  0x826B
+
 namespace Tangram {
 struct GL {
     static GLenum getError(void);
@@ -288,8 +320,13 @@ struct GL {
     static void getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
     static GLint getUniformLocation(GLuint program, const GLchar *name);
     static GLint getAttribLocation(GLuint program, const GLchar *name);
+    static void bindAttribLocation(GLuint program, GLuint index, const GLchar *name);
     static void getProgramiv(GLuint program, GLenum pname, GLint *params);
     static void getShaderiv(GLuint shader, GLenum pname, GLint *params);
+    static void getProgramBinary(GLuint program, GLsizei bufSize, GLsizei *length,
+                                 GLenum *binaryFormat, void *binary);
+    static void programBinary(GLuint program, GLenum binaryFormat,
+                              const void *binary, GLsizei length);
 
     // Buffers
     static void bindBuffer(GLenum target, GLuint buffer);
@@ -360,9 +397,27 @@ struct GL {
     static void readPixels(GLint x, GLint y, GLsizei width, GLsizei height,
                            GLenum format, GLenum type, GLvoid* pixels);
 
+    // framebuffers
+    static void genFramebuffers(GLsizei n, GLuint *framebuffers);
+    static void deleteFramebuffers(GLsizei n, const GLuint *framebuffers);
+    static void bindFramebuffer(GLenum target, GLuint framebuffer);
+    static void framebufferTexture2D(GLenum target, GLenum attachment,
+                                     GLenum textarget, GLuint texture, GLint level);
+    static GLenum checkFramebufferStatus(GLenum target);
+    // Hint that the given attachments of the bound framebuffer need not
+    // be preserved; only called when Hardware::supportsDiscardFramebuffer
+    static void discardFramebuffer(GLenum target, GLsizei numAttachments, const GLenum *attachments);
+
     static void bindVertexArray(GLuint array);
     static void deleteVertexArrays(GLsizei n, const GLuint *arrays);
     static void genVertexArrays(GLsizei n, GLuint *arrays);
 
+    // timer queries
+    static void genQueries(GLsizei n, GLuint *queries);
+    static void deleteQueries(GLsizei n, const GLuint *queries);
+    static void beginQuery(GLenum target, GLuint query);
+    static void endQuery(GLenum target);
+    static void getQueryObjectuiv(GLuint query, GLenum pname, GLuint *params);
+
 };
 }
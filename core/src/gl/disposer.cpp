@@ -6,7 +6,7 @@ namespace Tangram {
 void Disposer::operator()(std::function<void(RenderState&)> _task) {
     if (!m_rs) { return; }
 
-    m_rs->jobQueue.add(std::bind(_task, std::ref(*m_rs)));
+    m_rs->queueDisposal(std::bind(_task, std::ref(*m_rs)));
 }
 
 } // namespace Tangram
@@ -6,6 +6,7 @@
 #include "gl/shaderProgram.h"
 #include "gl/texture.h"
 
+#include <array>
 #include <memory>
 #include <vector>
 #include <atomic>
@@ -21,7 +22,25 @@ public:
         : MeshBase(_vertexLayout, _drawMode, GL_DYNAMIC_DRAW) {
     }
 
-    bool draw(RenderState& rs, ShaderProgram& _shader) override;
+    ~DynamicQuadMesh() override {
+
+        auto generation = m_generation;
+        auto buffers = m_bufferRing;
+        auto sizes = m_bufferRingSizes;
+        auto active = m_ringIndex;
+
+        m_disposer([=](RenderState& rs) {
+            if (!rs.isValidGeneration(generation)) { return; }
+            // The active ring buffer is m_glVertexBuffer, which the
+            // MeshBase disposer releases
+            for (size_t i = 0; i < BUFFER_RING_SIZE; i++) {
+                if (i == active) { continue; }
+                rs.releaseBufferObject(buffers[i], sizes[i]);
+            }
+        });
+    }
+
+    bool draw(RenderState& rs, ShaderProgram& _shader, bool _useVao = true) override;
 
     // Draw the mesh while swapping textures using the given texture unit.
     bool draw(RenderState& rs, ShaderProgram& _shader, int textureUnit);
@@ -65,8 +84,19 @@ private:
         size_t startVertex = 0;
     };
 
+    // Number of vertex buffers cycled through by upload(). A buffer is
+    // written again only after the frames that referenced it have been
+    // submitted, so streaming writes go to retired storage and never
+    // force the driver to copy or rename a buffer that is still in
+    // flight.
+    static constexpr size_t BUFFER_RING_SIZE = 3;
+
     std::vector<T> m_vertices;
     std::vector<TextureBatch> m_batches;
+
+    std::array<GLuint, BUFFER_RING_SIZE> m_bufferRing = {{ 0 }};
+    std::array<size_t, BUFFER_RING_SIZE> m_bufferRingSizes = {{ 0 }};
+    size_t m_ringIndex = 0;
 };
 
 template<class T>
@@ -81,20 +111,48 @@ void DynamicQuadMesh<T>::upload(RenderState& rs) {
 
     if (m_nVertices == 0 || m_isUploaded) { return; }
 
-    MeshBase::checkValidity(rs);
+    if (!MeshBase::checkValidity(rs)) {
+        // The ring handles died with the GL context
+        m_bufferRing.fill(0);
+        m_bufferRingSizes.fill(0);
+    }
 
-    // Generate vertex buffer, if needed
-    if (m_glVertexBuffer == 0) {
-        GL::genBuffers(1, &m_glVertexBuffer);
+    size_t vertexBytes = m_nVertices * sizeof(T);
+
+    // Stream into the next ring buffer
+    m_ringIndex = (m_ringIndex + 1) % BUFFER_RING_SIZE;
+    auto& buffer = m_bufferRing[m_ringIndex];
+    auto& bufferSize = m_bufferRingSizes[m_ringIndex];
+
+    if (buffer == 0) {
+        buffer = rs.getBufferObject(vertexBytes);
+        bufferSize = 0;
     }
 
-    MeshBase::subDataUpload(rs, reinterpret_cast<GLbyte*>(m_vertices.data()));
+    rs.vertexBuffer(buffer);
+
+    size_t sizeClass = RenderState::bufferSizeClass(vertexBytes);
+    if (bufferSize < sizeClass) {
+        GL::bufferData(GL_ARRAY_BUFFER, sizeClass, nullptr, m_hint);
+        bufferSize = sizeClass;
+    }
+
+    // The buffer was last drawn BUFFER_RING_SIZE frames ago, so this
+    // write needs neither a driver-side copy of fresh orphaned storage
+    // nor a wait on in-flight frames
+    GL::bufferSubData(GL_ARRAY_BUFFER, 0, vertexBytes, m_vertices.data());
+
+    m_glVertexBuffer = buffer;
+    m_vertexBufferSize = bufferSize;
+
+    m_disposer = Disposer(rs);
 
     m_isUploaded = true;
 }
 
 template<class T>
-bool DynamicQuadMesh<T>::draw(RenderState& rs, ShaderProgram& shader) {
+bool DynamicQuadMesh<T>::draw(RenderState& rs, ShaderProgram& shader, bool useVao) {
+    // This mesh never records VAOs, so useVao has no effect here.
     return draw(rs, shader, 0);
 }
 
@@ -3,6 +3,8 @@
 
 namespace Tangram {
 
+bool Error::s_debugCallbackActive = false;
+
 std::unordered_map<GLenum, std::string> Error::s_GlErrorCodesToStrings = {
         {GL_NO_ERROR, "GL_NO_ERROR"},
         {GL_INVALID_ENUM, "GL_INVALID_ENUM"},
@@ -28,6 +30,24 @@ bool Error::hadGlError(const std::string& _locationTag) {
     return false;
 }
 
+void Error::onGlDebugMessage(GLenum _source, GLenum _type, GLuint _id,
+                             GLenum _severity, GLsizei _length,
+                             const GLchar* _message, const void* _userParam) {
+
+    switch (_severity) {
+    case GL_DEBUG_SEVERITY_HIGH:
+        LOGE("GL debug: %s", _message);
+        break;
+    case GL_DEBUG_SEVERITY_MEDIUM:
+    case GL_DEBUG_SEVERITY_LOW:
+        LOGW("GL debug: %s", _message);
+        break;
+    default:
+        LOGD("GL debug: %s", _message);
+        break;
+    }
+}
+
 void Error::glError(const char* stmt, const char* fname, int line) {
     GLenum err = GL::getError();
 
@@ -19,14 +19,35 @@ public:
 
     static void glError(const char* stmt, const char* fname, int line);
 
+    /*
+     * onGlDebugMessage - sink for KHR_debug driver messages, matching the
+     * GLDEBUGPROC signature. Platforms whose context supports the extension
+     * (see Hardware::supportsDebugOutput) can register this with
+     * glDebugMessageCallbackKHR and then call setDebugCallbackActive(true),
+     * which turns off the per-call glGetError polling in GL_CHECK: the driver
+     * reports errors asynchronously instead of being asked after every call,
+     * avoiding the pipeline synchronization that polling forces on some drivers.
+     */
+    static void onGlDebugMessage(GLenum _source, GLenum _type, GLuint _id,
+                                 GLenum _severity, GLsizei _length,
+                                 const GLchar* _message, const void* _userParam);
+
+    static void setDebugCallbackActive(bool _active) { s_debugCallbackActive = _active; }
+    static bool debugCallbackActive() { return s_debugCallbackActive; }
+
 private:
 
+    static bool s_debugCallbackActive;
+
     static std::unordered_map<GLenum, std::string> s_GlErrorCodesToStrings;
 
 };
 
+// In release builds GL_CHECK compiles down to the bare statement and all
+// error reporting is removed. Debug builds follow each call with a
+// glGetError poll, unless a KHR_debug callback is active.
 #ifdef DEBUG
-#define GL_CHECK(STMT) do { STMT; Tangram::Error::glError(#STMT, __FILE__, __LINE__); } while (0)
+#define GL_CHECK(STMT) do { STMT; if (!Tangram::Error::debugCallbackActive()) { Tangram::Error::glError(#STMT, __FILE__, __LINE__); } } while (0)
 #else
 #define GL_CHECK(STMT) STMT;
 #endif
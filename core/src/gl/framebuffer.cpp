@@ -0,0 +1,95 @@
+#include "gl/framebuffer.h"
+
+#include "gl/error.h"
+#include "gl/hardware.h"
+#include "gl/renderState.h"
+#include "log.h"
+
+namespace Tangram {
+
+FrameBuffer::FrameBuffer(int _width, int _height)
+    : m_width(_width),
+      m_height(_height) {
+}
+
+FrameBuffer::~FrameBuffer() {
+
+    GLuint frameBuffer = m_glFrameBufferHandle;
+    GLuint texture = m_glTextureHandle;
+    int generation = m_generation;
+
+    if (frameBuffer != 0) {
+        m_disposer([=](RenderState& rs) {
+            if (rs.isValidGeneration(generation)) {
+                rs.framebufferUnset(frameBuffer);
+                GL::deleteFramebuffers(1, &frameBuffer);
+                GL::deleteTextures(1, &texture);
+            }
+        });
+    }
+}
+
+void FrameBuffer::init(RenderState& rs) {
+
+    m_generation = rs.generation();
+    m_disposer = Disposer(rs);
+
+    GL::genTextures(1, &m_glTextureHandle);
+    rs.texture(GL_TEXTURE_2D, m_glTextureHandle);
+    GL::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    GL::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    GL::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    GL::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GL::texImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0,
+                   GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    GL::genFramebuffers(1, &m_glFrameBufferHandle);
+    rs.framebuffer(m_glFrameBufferHandle);
+    GL::framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                             GL_TEXTURE_2D, m_glTextureHandle, 0);
+
+    GLenum status = GL::checkFramebufferStatus(GL_FRAMEBUFFER);
+
+    m_valid = (status == GL_FRAMEBUFFER_COMPLETE);
+
+    if (!m_valid) {
+        LOGW("Framebuffer incomplete: 0x%x", status);
+    }
+}
+
+bool FrameBuffer::bind(RenderState& rs) {
+
+    if (!rs.isValidGeneration(m_generation)) {
+        m_glFrameBufferHandle = 0;
+        m_glTextureHandle = 0;
+        m_valid = false;
+        m_generation = -1;
+    }
+
+    if (m_glFrameBufferHandle == 0) {
+        init(rs);
+    } else {
+        rs.framebuffer(m_glFrameBufferHandle);
+    }
+
+    return m_valid;
+}
+
+GLuint FrameBuffer::readAt(int _x, int _y) const {
+
+    GLuint pixel = 0;
+    GL::readPixels(_x, _y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &pixel);
+    return pixel;
+}
+
+void FrameBuffer::discard(RenderState& rs) {
+
+    if (!Hardware::supportsDiscardFramebuffer || !m_valid) { return; }
+
+    rs.framebuffer(m_glFrameBufferHandle);
+
+    GLenum attachment = GL_COLOR_ATTACHMENT0;
+    GL::discardFramebuffer(GL_FRAMEBUFFER, 1, &attachment);
+}
+
+}
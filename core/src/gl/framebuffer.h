@@ -0,0 +1,64 @@
+#pragma once
+
+#include "gl.h"
+#include "gl/disposer.h"
+
+namespace Tangram {
+
+class RenderState;
+
+/* FrameBuffer - Offscreen RGBA render target
+ *
+ * Wraps a framebuffer object with a texture color attachment, created
+ * lazily on the render thread. Used by the GPU picking pass to render
+ * id colors that are read back with readAt().
+ */
+class FrameBuffer {
+
+public:
+
+    FrameBuffer(int _width, int _height);
+
+    ~FrameBuffer();
+
+    FrameBuffer(const FrameBuffer&) = delete;
+    FrameBuffer& operator=(const FrameBuffer&) = delete;
+
+    /* Bind this framebuffer as the render target, creating the GL objects
+     * on first use; returns false when the attachment is not usable */
+    bool bind(RenderState& rs);
+
+    /* Read back the RGBA value at the given pixel, packed as
+     * 0xAABBGGRR; only meaningful while this framebuffer is bound */
+    GLuint readAt(int _x, int _y) const;
+
+    /* Hint that the color attachment's contents need not be preserved,
+     * letting tile-based GPUs skip resolving it to memory. Binds this
+     * framebuffer; a no-op without the discard_framebuffer extension */
+    void discard(RenderState& rs);
+
+    int width() const { return m_width; }
+
+    int height() const { return m_height; }
+
+private:
+
+    void init(RenderState& rs);
+
+    GLuint m_glFrameBufferHandle = 0;
+
+    GLuint m_glTextureHandle = 0;
+
+    Disposer m_disposer;
+
+    int m_generation = -1;
+
+    int m_width;
+
+    int m_height;
+
+    bool m_valid = false;
+
+};
+
+}
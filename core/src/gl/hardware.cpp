@@ -15,6 +15,12 @@ namespace Hardware {
 bool supportsMapBuffer = false;
 bool supportsVAOs = false;
 bool supportsTextureNPOT = false;
+bool supportsElementIndexUint = false;
+bool supportsProgramBinary = false;
+bool supportsTimerQueries = false;
+bool supportsDebugOutput = false;
+bool supportsDiscardFramebuffer = false;
+bool supportsPixelBuffers = false;
 
 uint32_t maxTextureSize = 0;
 uint32_t maxCombinedTextureUnits = 0;
@@ -54,9 +60,26 @@ void loadExtensions() {
     supportsMapBuffer = isAvailable("mapbuffer");
     supportsVAOs = isAvailable("vertex_array_object");
     supportsTextureNPOT = isAvailable("texture_non_power_of_two");
+    supportsElementIndexUint = isAvailable("element_index_uint");
+    supportsProgramBinary = isAvailable("get_program_binary");
+    // Matches EXT/ARB_timer_query and EXT_disjoint_timer_query
+    supportsTimerQueries = isAvailable("timer_query");
+    // Platforms can register Error::onGlDebugMessage when this is set
+    supportsDebugOutput = isAvailable("KHR_debug");
+    // Lets tile-based GPUs skip resolving attachments to memory
+    supportsDiscardFramebuffer = isAvailable("discard_framebuffer");
+    // Matches ARB/NV/EXT_pixel_buffer_object; lets readPixels copy into
+    // a buffer asynchronously instead of stalling on the client pointer
+    supportsPixelBuffers = isAvailable("pixel_buffer_object");
 
     LOG("Driver supports map buffer: %d", supportsMapBuffer);
     LOG("Driver supports vaos: %d", supportsVAOs);
+    LOG("Driver supports 32bit indices: %d", supportsElementIndexUint);
+    LOG("Driver supports program binaries: %d", supportsProgramBinary);
+    LOG("Driver supports timer queries: %d", supportsTimerQueries);
+    LOG("Driver supports debug output: %d", supportsDebugOutput);
+    LOG("Driver supports discard framebuffer: %d", supportsDiscardFramebuffer);
+    LOG("Driver supports pixel buffers: %d", supportsPixelBuffers);
 
     // find extension symbols if needed
     initGLExtensions();
@@ -8,6 +8,12 @@ namespace Hardware {
 extern bool supportsMapBuffer;
 extern bool supportsVAOs;
 extern bool supportsTextureNPOT;
+extern bool supportsElementIndexUint;
+extern bool supportsProgramBinary;
+extern bool supportsTimerQueries;
+extern bool supportsDebugOutput;
+extern bool supportsDiscardFramebuffer;
+extern bool supportsPixelBuffers;
 extern uint32_t maxTextureSize;
 extern uint32_t maxCombinedTextureUnits;
 
@@ -41,20 +41,18 @@ MeshBase::~MeshBase() {
     auto generation = m_generation;
     auto glVertexBuffer = m_glVertexBuffer;
     auto glIndexBuffer = m_glIndexBuffer;
+    auto vertexBufferSize = m_vertexBufferSize;
+    auto indexBufferSize = m_indexBufferSize;
 
     m_disposer([=](RenderState& rs) mutable {
         // Deleting a index/array buffer being used ends up setting up the current vertex/index buffer to 0
         // after the driver finishes using it, force the render state to be 0 for vertex/index buffer
         if (rs.isValidGeneration(generation)) {
-            if (glVertexBuffer) {
-                rs.vertexBufferUnset(glVertexBuffer);
-                GL::deleteBuffers(1, &glVertexBuffer);
-            }
-            if (glIndexBuffer) {
-                rs.indexBufferUnset(glIndexBuffer);
-                GL::deleteBuffers(1, &glIndexBuffer);
-            }
-            vaos.dispose();
+            // Recycle the buffer objects so a new tile's mesh can reuse
+            // their storage instead of paying an alloc/free cycle
+            rs.releaseBufferObject(glVertexBuffer, vertexBufferSize);
+            rs.releaseBufferObject(glIndexBuffer, indexBufferSize);
+            vaos.dispose(rs);
         }
     });
 
@@ -105,8 +103,10 @@ void MeshBase::subDataUpload(RenderState& rs, GLbyte* _data) {
 
     long vertexBytes = m_nVertices * m_vertexLayout->getStride();
 
-    // invalidate/orphane the data store on the driver
-    GL::bufferData(GL_ARRAY_BUFFER, vertexBytes, NULL, m_hint);
+    // invalidate/orphane the data store on the driver; the store keeps its
+    // pool size class so the buffer can be recycled without reallocation
+    m_vertexBufferSize = RenderState::bufferSizeClass(vertexBytes);
+    GL::bufferData(GL_ARRAY_BUFFER, m_vertexBufferSize, NULL, m_hint);
 
     if (Hardware::supportsMapBuffer) {
         GLvoid* dataStore = GL::mapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
@@ -119,7 +119,7 @@ void MeshBase::subDataUpload(RenderState& rs, GLbyte* _data) {
 
         // if this buffer is still used by gpu on current frame this call will not wait
         // for the frame to finish using the vbo but "directly" send command to upload the data
-        GL::bufferData(GL_ARRAY_BUFFER, vertexBytes, data, m_hint);
+        GL::bufferSubData(GL_ARRAY_BUFFER, 0, vertexBytes, data);
     }
 
     m_dirty = false;
@@ -127,30 +127,40 @@ void MeshBase::subDataUpload(RenderState& rs, GLbyte* _data) {
 
 void MeshBase::upload(RenderState& rs) {
 
+    // Buffer vertex data
+    size_t vertexBytes = m_nVertices * m_vertexLayout->getStride();
+
     // Generate vertex buffer, if needed
     if (m_glVertexBuffer == 0) {
-        GL::genBuffers(1, &m_glVertexBuffer);
+        m_glVertexBuffer = rs.getBufferObject(vertexBytes);
     }
 
-    // Buffer vertex data
-    int vertexBytes = m_nVertices * m_vertexLayout->getStride();
-
     rs.vertexBuffer(m_glVertexBuffer);
-    GL::bufferData(GL_ARRAY_BUFFER, vertexBytes, m_glVertexData, m_hint);
+
+    // Storage is specified at the full size class, so a recycled buffer
+    // is respecified at the very size it already has and the driver can
+    // keep its allocation
+    m_vertexBufferSize = RenderState::bufferSizeClass(vertexBytes);
+    GL::bufferData(GL_ARRAY_BUFFER, m_vertexBufferSize, nullptr, m_hint);
+    GL::bufferSubData(GL_ARRAY_BUFFER, 0, vertexBytes, m_glVertexData);
 
     delete[] m_glVertexData;
     m_glVertexData = nullptr;
 
     if (m_glIndexData) {
 
+        size_t indexBytes = m_nIndices * indexSize();
+
         if (m_glIndexBuffer == 0) {
-            GL::genBuffers(1, &m_glIndexBuffer);
+            m_glIndexBuffer = rs.getBufferObject(indexBytes);
         }
 
         // Buffer element index data
         rs.indexBuffer(m_glIndexBuffer);
 
-        GL::bufferData(GL_ELEMENT_ARRAY_BUFFER, m_nIndices * sizeof(GLushort), m_glIndexData, m_hint);
+        m_indexBufferSize = RenderState::bufferSizeClass(indexBytes);
+        GL::bufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexBufferSize, nullptr, m_hint);
+        GL::bufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexBytes, m_glIndexData);
 
         delete[] m_glIndexData;
         m_glIndexData = nullptr;
@@ -162,10 +172,12 @@ void MeshBase::upload(RenderState& rs) {
     m_isUploaded = true;
 }
 
-bool MeshBase::draw(RenderState& rs, ShaderProgram& _shader) {
+bool MeshBase::draw(RenderState& rs, ShaderProgram& _shader, bool _useVao) {
 
     checkValidity(rs);
 
+    bool useVao = _useVao && Hardware::supportsVAOs;
+
     if (!m_isCompiled) { return false; }
     if (m_nVertices == 0) { return false; }
 
@@ -181,10 +193,10 @@ bool MeshBase::draw(RenderState& rs, ShaderProgram& _shader) {
         subDataUpload(rs);
     }
 
-    if (Hardware::supportsVAOs) {
+    if (useVao) {
         if (!m_vaos.isInitialized()) {
             // Capture vao state
-            m_vaos.initialize(rs, _shader, m_vertexOffsets, *m_vertexLayout, m_glVertexBuffer, m_glIndexBuffer);
+            m_vaos.initialize(rs, m_vertexOffsets, *m_vertexLayout, m_glVertexBuffer, m_glIndexBuffer);
         }
     } else {
         // Bind buffers for drawing
@@ -203,19 +215,19 @@ bool MeshBase::draw(RenderState& rs, ShaderProgram& _shader) {
         uint32_t nIndices = o.first;
         uint32_t nVertices = o.second;
 
-        if (!Hardware::supportsVAOs) {
+        if (!useVao) {
             // Enable vertex attribs via vertex layout object
             size_t byteOffset = vertexOffset * m_vertexLayout->getStride();
             m_vertexLayout->enable(rs,  _shader, byteOffset);
         } else {
             // Bind the corresponding vao relative to the current offset
-            m_vaos.bind(i);
+            m_vaos.bind(rs, i);
         }
 
         // Draw as elements or arrays
         if (nIndices > 0) {
-            GL::drawElements(m_drawMode, nIndices, GL_UNSIGNED_SHORT,
-                             (void*)(indiceOffset * sizeof(GLushort)));
+            GL::drawElements(m_drawMode, nIndices, m_indexType,
+                             (void*)(indiceOffset * indexSize()));
         } else if (nVertices > 0) {
             GL::drawArrays(m_drawMode, 0, nVertices);
         }
@@ -224,9 +236,9 @@ bool MeshBase::draw(RenderState& rs, ShaderProgram& _shader) {
         indiceOffset += nIndices;
     }
 
-    if (Hardware::supportsVAOs) {
-        m_vaos.unbind();
-    }
+    // The VAO stays bound; the render state breaks it before the next
+    // plain buffer bind, so back-to-back draws of this mesh skip the
+    // bind entirely
 
     return true;
 }
@@ -247,7 +259,82 @@ bool MeshBase::checkValidity(RenderState& rs) {
 }
 
 size_t MeshBase::bufferSize() const {
-    return m_nVertices * m_vertexLayout->getStride() + m_nIndices * sizeof(GLushort);
+    return m_nVertices * m_vertexLayout->getStride() + m_nIndices * indexSize();
+}
+
+bool MeshBase::serialize(std::vector<char>& _out) const {
+
+    if (!m_isCompiled || !m_glVertexData) { return false; }
+
+    uint32_t header[5] = {
+        uint32_t(m_nVertices),
+        uint32_t(m_nIndices),
+        uint32_t(m_vertexOffsets.size()),
+        uint32_t(m_vertexLayout->getStride()),
+        uint32_t(m_indexType),
+    };
+
+    auto append = [&](const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        _out.insert(_out.end(), bytes, bytes + size);
+    };
+
+    append(header, sizeof(header));
+    append(m_vertexOffsets.data(), m_vertexOffsets.size() * sizeof(m_vertexOffsets[0]));
+    append(m_glVertexData, m_nVertices * m_vertexLayout->getStride());
+
+    if (m_nIndices > 0) {
+        append(m_glIndexData, m_nIndices * indexSize());
+    }
+
+    return true;
+}
+
+bool MeshBase::deserialize(const char* _data, size_t _size) {
+
+    if (m_isCompiled || _size < 5 * sizeof(uint32_t)) { return false; }
+
+    uint32_t header[5];
+    std::memcpy(header, _data, sizeof(header));
+
+    size_t nVertices = header[0];
+    size_t nIndices = header[1];
+    size_t nOffsets = header[2];
+    size_t stride = header[3];
+    GLenum indexType = header[4];
+
+    if (stride != size_t(m_vertexLayout->getStride())) { return false; }
+    if (indexType != GL_UNSIGNED_SHORT && indexType != GL_UNSIGNED_INT) { return false; }
+    if (indexType == GL_UNSIGNED_INT && !Hardware::supportsElementIndexUint) { return false; }
+    m_indexType = indexType;
+
+    size_t expected = sizeof(header)
+        + nOffsets * sizeof(std::pair<uint32_t, uint32_t>)
+        + nVertices * stride
+        + nIndices * indexSize();
+
+    if (_size != expected) { return false; }
+
+    const char* cursor = _data + sizeof(header);
+
+    m_vertexOffsets.resize(nOffsets);
+    std::memcpy(m_vertexOffsets.data(), cursor, nOffsets * sizeof(m_vertexOffsets[0]));
+    cursor += nOffsets * sizeof(m_vertexOffsets[0]);
+
+    m_nVertices = nVertices;
+    m_glVertexData = new GLbyte[nVertices * stride];
+    std::memcpy(m_glVertexData, cursor, nVertices * stride);
+    cursor += nVertices * stride;
+
+    m_nIndices = nIndices;
+    if (nIndices > 0) {
+        m_glIndexData = new GLbyte[nIndices * indexSize()];
+        std::memcpy(m_glIndexData, cursor, nIndices * indexSize());
+    }
+
+    m_isCompiled = true;
+
+    return true;
 }
 
 // Add indices by collecting them into batches to draw as much as
@@ -256,8 +343,6 @@ size_t MeshBase::bufferSize() const {
 size_t MeshBase::compileIndices(const std::vector<std::pair<uint32_t, uint32_t>>& _offsets,
                                 const std::vector<uint16_t>& _indices, size_t _offset) {
 
-
-    GLushort* dst = m_glIndexData + _offset;
     size_t curVertices = 0;
     size_t src = 0;
 
@@ -267,6 +352,31 @@ size_t MeshBase::compileIndices(const std::vector<std::pair<uint32_t, uint32_t>>
         curVertices = m_vertexOffsets.back().second;
     }
 
+    if (m_indexType == GL_UNSIGNED_INT) {
+        // 32bit indices address all vertices directly - everything
+        // stays in one range, drawn with a single call.
+        GLuint* dst = reinterpret_cast<GLuint*>(m_glIndexData) + _offset;
+
+        for (auto& p : _offsets) {
+            size_t nIndices = p.first;
+            size_t nVertices = p.second;
+
+            for (size_t i = 0; i < nIndices; i++, dst++) {
+                *dst = _indices[src++] + curVertices;
+            }
+
+            auto& offset = m_vertexOffsets.back();
+            offset.first += nIndices;
+            offset.second += nVertices;
+
+            curVertices += nVertices;
+        }
+
+        return _offset + src;
+    }
+
+    GLushort* dst = reinterpret_cast<GLushort*>(m_glIndexData) + _offset;
+
     for (auto& p : _offsets) {
         size_t nIndices = p.first;
         size_t nVertices = p.second;
@@ -2,6 +2,7 @@
 
 #include "gl.h"
 #include "gl/disposer.h"
+#include "gl/hardware.h"
 #include "vertexLayout.h"
 #include "vao.h"
 #include "util/types.h"
@@ -70,10 +71,23 @@ public:
      * Renders the geometry in this mesh using the ShaderProgram _shader; if
      * geometry has not already been uploaded it will be uploaded at this point
      */
-    bool draw(RenderState& rs, ShaderProgram& _shader);
+    bool draw(RenderState& rs, ShaderProgram& _shader, bool _useVao = true);
 
     size_t bufferSize() const;
 
+    /*
+     * Append the compiled, not yet uploaded vertex/index buffers to _out.
+     * Returns false when no CPU-side data is available.
+     */
+    bool serialize(std::vector<char>& _out) const;
+
+    /*
+     * Restore compiled buffers from data written by serialize(), leaving
+     * the mesh ready for upload. Returns false on malformed data or a
+     * vertex layout stride mismatch.
+     */
+    bool deserialize(const char* _data, size_t _size);
+
 protected:
 
     int m_generation; // Generation in which this mesh's GL handles were created
@@ -87,6 +101,11 @@ protected:
     size_t m_nVertices;
     GLuint m_glVertexBuffer;
 
+    // Sizes at which the buffer stores were specified; always a pool
+    // size class, see RenderState::bufferSizeClass()
+    size_t m_vertexBufferSize = 0;
+    size_t m_indexBufferSize = 0;
+
     Vao m_vaos;
 
     // Compiled vertices for upload
@@ -94,8 +113,18 @@ protected:
 
     size_t m_nIndices;
     GLuint m_glIndexBuffer;
-    // Compiled  indices for upload
-    GLushort* m_glIndexData = nullptr;
+    // Compiled indices for upload; elements are GLushort or GLuint,
+    // according to m_indexType
+    GLbyte* m_glIndexData = nullptr;
+
+    // GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT when the mesh has more
+    // vertices than a 16bit index can address and the driver supports
+    // 32bit element indices
+    GLenum m_indexType = GL_UNSIGNED_SHORT;
+
+    size_t indexSize() const {
+        return m_indexType == GL_UNSIGNED_INT ? sizeof(GLuint) : sizeof(GLushort);
+    }
 
     GLenum m_drawMode;
     GLenum m_hint;
@@ -117,6 +146,37 @@ protected:
     void setDirty(GLintptr _byteOffset, GLsizei _byteSize);
 };
 
+/*
+ * Mesh restored from buffers baked by MeshBase::serialize(). Only carries
+ * the compiled data needed for upload and draw.
+ */
+class SerializedMesh : public StyledMesh, protected MeshBase {
+public:
+
+    SerializedMesh(std::shared_ptr<VertexLayout> _vertexLayout, GLenum _drawMode)
+        : MeshBase(_vertexLayout, _drawMode) {}
+
+    size_t bufferSize() const override {
+        return MeshBase::bufferSize();
+    }
+
+    size_t vertexCount() const override { return m_nVertices; }
+
+    bool draw(RenderState& rs, ShaderProgram& shader, bool useVao = true) override {
+        return MeshBase::draw(rs, shader, useVao);
+    }
+
+    bool isUploaded() const override { return m_isUploaded; }
+
+    bool serialize(std::vector<char>& _out) const override {
+        return MeshBase::serialize(_out);
+    }
+
+    bool deserialize(const char* _data, size_t _size) {
+        return MeshBase::deserialize(_data, _size);
+    }
+};
+
 template<class T>
 struct MeshData {
 
@@ -152,8 +212,16 @@ public:
         return MeshBase::bufferSize();
     }
 
-    bool draw(RenderState& rs, ShaderProgram& shader) override {
-        return MeshBase::draw(rs, shader);
+    size_t vertexCount() const override { return m_nVertices; }
+
+    bool draw(RenderState& rs, ShaderProgram& shader, bool useVao = true) override {
+        return MeshBase::draw(rs, shader, useVao);
+    }
+
+    bool isUploaded() const override { return m_isUploaded; }
+
+    bool serialize(std::vector<char>& _out) const override {
+        return MeshBase::serialize(_out);
     }
 
     void compile(const std::vector<MeshData<T>>& _meshes);
@@ -204,7 +272,13 @@ void Mesh<T>::compile(const std::vector<MeshData<T>>& _meshes) {
     assert(offset == m_nVertices * stride);
 
     if (m_nIndices > 0) {
-        m_glIndexData = new GLushort[m_nIndices];
+        // Large meshes compile to one index range and a single draw
+        // when the hardware can address them with 32bit indices;
+        // otherwise compileIndices splits them into 16bit ranges.
+        if (m_nVertices > MAX_INDEX_VALUE && Hardware::supportsElementIndexUint) {
+            m_indexType = GL_UNSIGNED_INT;
+        }
+        m_glIndexData = new GLbyte[m_nIndices * indexSize()];
 
         size_t offset = 0;
         for (auto& m : _meshes) {
@@ -230,7 +304,10 @@ void Mesh<T>::compile(const MeshData<T>& _mesh) {
                 m_nVertices * stride);
 
     if (m_nIndices > 0) {
-        m_glIndexData = new GLushort[m_nIndices];
+        if (m_nVertices > MAX_INDEX_VALUE && Hardware::supportsElementIndexUint) {
+            m_indexType = GL_UNSIGNED_INT;
+        }
+        m_glIndexData = new GLbyte[m_nIndices * indexSize()];
         compileIndices(_mesh.offsets, _mesh.indices, 0);
     }
 
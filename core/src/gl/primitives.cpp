@@ -11,18 +11,31 @@
 #include "shaders/debugPrimitive_vs.h"
 #include "shaders/debugPrimitive_fs.h"
 
+#include <vector>
+
 namespace Tangram {
 
 namespace Primitives {
 
+// Batched line vertex; the color rides along per vertex so one draw
+// call can carry segments of many colors.
+struct Vertex {
+    glm::vec2 position;
+    unsigned char color[4];
+};
+
 static bool s_initialized;
 static std::unique_ptr<ShaderProgram> s_shader;
 static std::unique_ptr<VertexLayout> s_layout;
 static glm::vec2 s_resolution;
 
-static UniformLocation s_uColor{"u_color"};
 static UniformLocation s_uProj{"u_proj"};
 
+// Accumulated line segments; the buffer keeps its capacity across
+// frames, so steady-state debug drawing does not allocate.
+static std::vector<Vertex> s_vertices;
+static unsigned char s_color[4] = { 255, 255, 255, 255 };
+
 void init() {
 
     // lazy init
@@ -34,6 +47,7 @@ void init() {
 
         s_layout = std::unique_ptr<VertexLayout>(new VertexLayout({
             {"a_position", 2, GL_FLOAT, false, 0},
+            {"a_color", 4, GL_UNSIGNED_BYTE, true, 0},
         }));
 
         s_initialized = true;
@@ -45,72 +59,79 @@ void deinit() {
 
     s_shader.reset(nullptr);
     s_layout.reset(nullptr);
+    s_vertices.clear();
+    s_vertices.shrink_to_fit();
     s_initialized = false;
 
 }
 
-void drawLine(RenderState& rs, const glm::vec2& _origin, const glm::vec2& _destination) {
-
-    init();
-
-    glm::vec2 verts[2] = {
-        glm::vec2(_origin.x, _origin.y),
-        glm::vec2(_destination.x, _destination.y)
-    };
-
-    if (!s_shader->use(rs)) { return; }
-
-    GLint boundBuffer;
-    GL::getIntegerv(GL_ARRAY_BUFFER_BINDING, &boundBuffer);
-    rs.vertexBuffer(0);
-    rs.depthTest(GL_FALSE);
-
-    // enable the layout for the line vertices
-    s_layout->enable(rs, *s_shader, 0, &verts);
+static void addSegment(const glm::vec2& _a, const glm::vec2& _b) {
+    s_vertices.push_back({ _a, { s_color[0], s_color[1], s_color[2], s_color[3] } });
+    s_vertices.push_back({ _b, { s_color[0], s_color[1], s_color[2], s_color[3] } });
+}
 
-    GL::drawArrays(GL_LINES, 0, 2);
+void drawLine(RenderState& rs, const glm::vec2& _origin, const glm::vec2& _destination) {
 
-    rs.vertexBuffer(boundBuffer);
+    addSegment(_origin, _destination);
 }
 
 void drawRect(RenderState& rs, const glm::vec2& _origin, const glm::vec2& _destination) {
-    drawLine(rs, _origin, {_destination.x, _origin.y});
-    drawLine(rs, {_destination.x, _origin.y}, _destination);
-    drawLine(rs, _destination, {_origin.x, _destination.y});
-    drawLine(rs, {_origin.x,_destination.y}, _origin);
+    addSegment(_origin, {_destination.x, _origin.y});
+    addSegment({_destination.x, _origin.y}, _destination);
+    addSegment(_destination, {_origin.x, _destination.y});
+    addSegment({_origin.x, _destination.y}, _origin);
 }
 
 void drawPoly(RenderState& rs, const glm::vec2* _polygon, size_t _n) {
+
+    for (size_t i = 0; i + 1 < _n; i++) {
+        addSegment(_polygon[i], _polygon[i + 1]);
+    }
+    if (_n > 2) {
+        addSegment(_polygon[_n - 1], _polygon[0]);
+    }
+}
+
+void flush(RenderState& rs) {
+
+    if (s_vertices.empty()) { return; }
+
     init();
 
-    if (!s_shader->use(rs)) { return; }
+    if (!s_shader->use(rs)) {
+        s_vertices.clear();
+        return;
+    }
 
     GLint boundBuffer;
     GL::getIntegerv(GL_ARRAY_BUFFER_BINDING, &boundBuffer);
     rs.vertexBuffer(0);
     rs.depthTest(GL_FALSE);
 
-    // enable the layout for the _polygon vertices
-    s_layout->enable(rs, *s_shader, 0, (void*)_polygon);
+    // enable the layout for the batched vertices
+    s_layout->enable(rs, *s_shader, 0, s_vertices.data());
 
-    GL::drawArrays(GL_LINE_LOOP, 0, _n);
+    GL::drawArrays(GL_LINES, 0, s_vertices.size());
 
     rs.vertexBuffer(boundBuffer);
+
+    s_vertices.clear();
 }
 
 void setColor(RenderState& rs, unsigned int _color) {
-    init();
-
-    float r = (_color >> 16 & 0xff) / 255.0;
-    float g = (_color >> 8  & 0xff) / 255.0;
-    float b = (_color       & 0xff) / 255.0;
 
-    s_shader->setUniformf(rs, s_uColor, r, g, b);
+    s_color[0] = _color >> 16 & 0xff;
+    s_color[1] = _color >> 8  & 0xff;
+    s_color[2] = _color       & 0xff;
+    s_color[3] = 255;
 }
 
 void setResolution(RenderState& rs, float _width, float _height) {
     init();
 
+    // Draw anything still queued under the old projection
+    flush(rs);
+
     glm::mat4 proj = glm::ortho(0.f, _width, _height, 0.f, -1.f, 1.f);
     s_shader->setUniformMatrix4f(rs, s_uProj, proj);
 }
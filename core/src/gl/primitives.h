@@ -17,15 +17,20 @@ void setResolution(RenderState& rs, float _width, float _height);
 /* Sets the current primitive color */
 void setColor(RenderState& rs, unsigned int _color);
 
-/* Draws a line from _origin to _destination for the screen resolution _resolution */
+/* Queues a line from _origin to _destination for the screen resolution _resolution */
 void drawLine(RenderState& rs, const glm::vec2& _origin, const glm::vec2& _destination);
 
-/* Draws a rect from _origin to _destination for the screen resolution _resolution */
+/* Queues a rect from _origin to _destination for the screen resolution _resolution */
 void drawRect(RenderState& rs, const glm::vec2& _origin, const glm::vec2& _destination);
 
-/* Draws a polyon of containing _n points in screen space for the screen resolution _resolution */
+/* Queues a polyon of containing _n points in screen space for the screen resolution _resolution */
 void drawPoly(RenderState& rs, const glm::vec2* _polygon, size_t _n);
 
+/* Draws everything queued since the last flush in a single call. The draw*
+ * functions only accumulate vertices, so debug overlays cost one buffer
+ * upload and one draw call per frame instead of one per primitive. */
+void flush(RenderState& rs);
+
 }
 
 }
@@ -30,6 +30,9 @@ RenderState::RenderState() {
     m_cullFace = { 0, false };
     m_vertexBuffer = { 0, false };
     m_indexBuffer = { 0, false };
+    m_vertexArray = { 0, false };
+    m_framebuffer = { 0, false };
+    m_viewport = { 0, 0, 0, 0, false };
     m_program = { 0, false };
     m_clearColor = { 0., 0., 0., 0., false };
     m_texture = { 0, 0, false };
@@ -42,11 +45,58 @@ GLuint RenderState::getTextureUnit(GLuint _unit) {
 
 RenderState::~RenderState() {
 
+    // Run any disposals still held back by the frame delay
+    for (auto& disposal : m_disposals) {
+        disposal.task();
+    }
+
+    for (auto& sizeClass : m_bufferPool) {
+        if (!sizeClass.second.empty()) {
+            GL::deleteBuffers(sizeClass.second.size(), sizeClass.second.data());
+        }
+    }
+
     deleteQuadIndexBuffer();
     deleteDefaultPointTexture();
 
 }
 
+void RenderState::queueDisposal(std::function<void()> _task) {
+
+    std::lock_guard<std::mutex> lock(m_disposalMutex);
+    m_disposals.push_back({ m_frameCount, std::move(_task) });
+}
+
+void RenderState::flushDisposalQueue() {
+
+    // Move the due disposals out of the queue before running them, so the
+    // lock is not held across GL calls
+    std::vector<std::function<void()>> batch;
+
+    m_mipmapBuilds = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_disposalMutex);
+        m_frameCount++;
+
+        while (!m_disposals.empty() && batch.size() < MAX_DISPOSALS_PER_FRAME &&
+               m_disposals.front().frame + DISPOSAL_DELAY_FRAMES <= m_frameCount) {
+            batch.push_back(std::move(m_disposals.front().task));
+            m_disposals.pop_front();
+        }
+    }
+
+    for (auto& task : batch) {
+        task();
+    }
+}
+
+bool RenderState::mipmapBudget() {
+    if (m_mipmapBuilds >= MAX_MIPMAP_BUILDS_PER_FRAME) { return false; }
+    m_mipmapBuilds++;
+    return true;
+}
+
 void RenderState::invalidate() {
 
     m_blending.set = false;
@@ -63,11 +113,15 @@ void RenderState::invalidate() {
     m_program.set = false;
     m_indexBuffer.set = false;
     m_vertexBuffer.set = false;
+    m_vertexArray.set = false;
+    m_framebuffer.set = false;
+    m_viewport.set = false;
     m_texture.set = false;
     m_textureUnit.set = false;
 
     attributeBindings.fill(0);
 
+    m_depthFunc = { GL_LESS, true };
     GL::depthFunc(GL_LESS);
     GL::clearDepth(1.0);
     GL::depthRange(0.0, 1.0);
@@ -76,6 +130,9 @@ void RenderState::invalidate() {
 
 void RenderState::increaseGeneration() {
     generateQuadIndexBuffer();
+    // Pooled buffer handles belong to the lost context
+    m_bufferPool.clear();
+    m_pooledBuffers = 0;
     m_validGeneration++;
 }
 
@@ -119,6 +176,7 @@ inline void setGlFlag(GLenum flag, GLboolean enable) {
 bool RenderState::blending(GLboolean enable) {
     if (!m_blending.set || m_blending.enabled != enable) {
         m_blending = { enable, true };
+        m_stats.blendChanges++;
         setGlFlag(GL_BLEND, enable);
         return false;
     }
@@ -128,6 +186,7 @@ bool RenderState::blending(GLboolean enable) {
 bool RenderState::blendingFunc(GLenum sfactor, GLenum dfactor) {
     if (!m_blendingFunc.set || m_blendingFunc.sfactor != sfactor || m_blendingFunc.dfactor != dfactor) {
         m_blendingFunc = { sfactor, dfactor, true };
+        m_stats.blendChanges++;
         GL::blendFunc(sfactor, dfactor);
         return false;
     }
@@ -188,6 +247,15 @@ bool RenderState::depthMask(GLboolean enable) {
     return true;
 }
 
+bool RenderState::depthFunc(GLenum func) {
+    if (!m_depthFunc.set || m_depthFunc.func != func) {
+        m_depthFunc = { func, true };
+        GL::depthFunc(func);
+        return false;
+    }
+    return true;
+}
+
 bool RenderState::frontFace(GLenum face) {
     if (!m_frontFace.set || m_frontFace.face != face) {
         m_frontFace = { face, true };
@@ -236,6 +304,7 @@ bool RenderState::stencilTest(GLboolean enable) {
 bool RenderState::shaderProgram(GLuint program) {
     if (!m_program.set || m_program.program != program) {
         m_program = { program, true };
+        m_stats.programBinds++;
         GL::useProgram(program);
         return false;
     }
@@ -245,6 +314,7 @@ bool RenderState::shaderProgram(GLuint program) {
 bool RenderState::texture(GLenum target, GLuint handle) {
     if (!m_texture.set || m_texture.target != target || m_texture.handle != handle) {
         m_texture = { target, handle, true };
+        m_stats.textureBinds++;
         GL::bindTexture(target, handle);
         return false;
     }
@@ -263,8 +333,13 @@ bool RenderState::textureUnit(GLuint unit) {
 }
 
 bool RenderState::vertexBuffer(GLuint handle) {
+    // Binding buffers while a VAO is bound would capture the binding in the
+    // VAO instead of the global state the cache tracks, so break the VAO
+    if (Hardware::supportsVAOs) { vertexArray(0); }
+
     if (!m_vertexBuffer.set || m_vertexBuffer.handle != handle) {
         m_vertexBuffer = { handle, true };
+        m_stats.bufferBinds++;
         GL::bindBuffer(GL_ARRAY_BUFFER, handle);
         return false;
     }
@@ -272,14 +347,30 @@ bool RenderState::vertexBuffer(GLuint handle) {
 }
 
 bool RenderState::indexBuffer(GLuint handle) {
+    if (Hardware::supportsVAOs) { vertexArray(0); }
+
     if (!m_indexBuffer.set || m_indexBuffer.handle != handle) {
         m_indexBuffer = { handle, true };
+        m_stats.bufferBinds++;
         GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, handle);
         return false;
     }
     return true;
 }
 
+bool RenderState::vertexArray(GLuint handle) {
+    if (!m_vertexArray.set || m_vertexArray.handle != handle) {
+        m_vertexArray = { handle, true };
+        m_stats.vertexArrayBinds++;
+        GL::bindVertexArray(handle);
+        // The element array binding is part of VAO state, so the cached
+        // index buffer binding no longer applies
+        m_indexBuffer.set = false;
+        return false;
+    }
+    return true;
+}
+
 void RenderState::vertexBufferUnset(GLuint handle) {
     if (m_vertexBuffer.handle == handle) {
         m_vertexBuffer.set = false;
@@ -292,6 +383,37 @@ void RenderState::indexBufferUnset(GLuint handle) {
     }
 }
 
+bool RenderState::framebuffer(GLuint handle) {
+    if (!m_framebuffer.set || m_framebuffer.handle != handle) {
+        m_framebuffer = { handle, true };
+        GL::bindFramebuffer(GL_FRAMEBUFFER, handle);
+        return false;
+    }
+    return true;
+}
+
+void RenderState::framebufferUnset(GLuint handle) {
+    if (m_framebuffer.handle == handle) {
+        m_framebuffer.set = false;
+    }
+}
+
+bool RenderState::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (!m_viewport.set || m_viewport.x != x || m_viewport.y != y ||
+        m_viewport.width != width || m_viewport.height != height) {
+        m_viewport = { x, y, width, height, true };
+        GL::viewport(x, y, width, height);
+        return false;
+    }
+    return true;
+}
+
+void RenderState::vertexArrayUnset(GLuint handle) {
+    if (m_vertexArray.handle == handle) {
+        m_vertexArray.set = false;
+    }
+}
+
 void RenderState::shaderProgramUnset(GLuint program) {
     if (m_program.program == program) {
         m_program.set = false;
@@ -311,6 +433,43 @@ GLuint RenderState::getQuadIndexBuffer() {
     return m_quadIndexBuffer;
 }
 
+size_t RenderState::bufferSizeClass(size_t size) {
+    // 1kB floor keeps tiny meshes from fragmenting the pool into many
+    // near-empty classes
+    size_t sizeClass = 1024;
+    while (sizeClass < size) { sizeClass <<= 1; }
+    return sizeClass;
+}
+
+GLuint RenderState::getBufferObject(size_t size) {
+
+    auto it = m_bufferPool.find(bufferSizeClass(size));
+    if (it != m_bufferPool.end() && !it->second.empty()) {
+        GLuint handle = it->second.back();
+        it->second.pop_back();
+        m_pooledBuffers--;
+        return handle;
+    }
+
+    GLuint handle = 0;
+    GL::genBuffers(1, &handle);
+    return handle;
+}
+
+void RenderState::releaseBufferObject(GLuint handle, size_t size) {
+    if (handle == 0) { return; }
+
+    vertexBufferUnset(handle);
+    indexBufferUnset(handle);
+
+    if (m_pooledBuffers < MAX_POOLED_BUFFERS) {
+        m_bufferPool[bufferSizeClass(size)].push_back(handle);
+        m_pooledBuffers++;
+    } else {
+        GL::deleteBuffers(1, &handle);
+    }
+}
+
 void RenderState::deleteQuadIndexBuffer() {
     indexBufferUnset(m_quadIndexBuffer);
     GL::deleteBuffers(1, &m_quadIndexBuffer);
@@ -351,8 +510,8 @@ void RenderState::deleteDefaultPointTexture() {
 }
 
 void RenderState::generateDefaultPointTexture() {
-    TextureOptions options = { GL_RGBA, GL_RGBA, { GL_LINEAR, GL_LINEAR }, { GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE } };
-    m_defaultPointTexture = new Texture(default_point_texture_data, default_point_texture_size, options, true);
+    m_defaultPointTexture = new Texture(default_point_texture_data, default_point_texture_size,
+                                        TextureOptions::linearRgba(), true);
 }
 
 } // namespace Tangram
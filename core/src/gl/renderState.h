@@ -4,6 +4,10 @@
 #include "gl/disposer.h"
 #include "util/jobQueue.h"
 #include <array>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
 
 namespace Tangram {
 
@@ -18,6 +22,22 @@ public:
 
     static constexpr size_t MAX_QUAD_VERTICES = 16384;
 
+    // Number of frames a queued disposal is held back before it runs, so
+    // objects the driver may still reference from in-flight frames are
+    // never deleted during submission
+    static constexpr uint32_t DISPOSAL_DELAY_FRAMES = 2;
+
+    // Upper bound on disposals run per frame, spreading the deletes of a
+    // mass tile eviction over several frames
+    static constexpr size_t MAX_DISPOSALS_PER_FRAME = 64;
+
+    // Upper bound on recycled buffer objects kept for reuse
+    static constexpr size_t MAX_POOLED_BUFFERS = 256;
+
+    // Upper bound on mipmap chains built per frame, spreading the cost of
+    // a burst of raster tiles over several frames
+    static constexpr size_t MAX_MIPMAP_BUILDS_PER_FRAME = 2;
+
     RenderState();
     ~RenderState();
 
@@ -66,6 +86,8 @@ public:
 
     bool depthMask(GLboolean enable);
 
+    bool depthFunc(GLenum func);
+
     bool frontFace(GLenum face);
 
     bool stencilMask(GLuint mask);
@@ -86,27 +108,105 @@ public:
 
     bool indexBuffer(GLuint handle);
 
+    // Bind a vertex array object, skipping redundant binds. Binding through
+    // the render state keeps the cached index buffer binding consistent,
+    // since the element array binding is part of VAO state.
+    bool vertexArray(GLuint handle);
+
     void vertexBufferUnset(GLuint handle);
 
     void indexBufferUnset(GLuint handle);
 
+    void vertexArrayUnset(GLuint handle);
+
+    // Bind a framebuffer as the render target, skipping redundant binds;
+    // handle 0 is the default framebuffer.
+    bool framebuffer(GLuint handle);
+
+    void framebufferUnset(GLuint handle);
+
+    // Set the viewport rectangle, skipping redundant calls; tracked here so
+    // that offscreen passes can switch render targets and back without
+    // re-validating the viewport each frame.
+    bool viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
     void shaderProgramUnset(GLuint program);
 
     void textureUnset(GLenum target, GLuint handle);
 
     GLuint getQuadIndexBuffer();
 
+    // Round a byte size up to the pool's size class: the next power of
+    // two, with a small floor. Callers specify buffer storage at the
+    // class size so recycled buffers keep their driver allocation.
+    static size_t bufferSizeClass(size_t size);
+
+    // Fetch a recycled buffer object whose storage was last specified at
+    // the size class covering _size, or generate one when that class is
+    // empty. Must be called on the render thread.
+    GLuint getBufferObject(size_t size = 0);
+
+    // Return a buffer object for reuse instead of deleting it, filed
+    // under the size class of its current storage. Respecifying a
+    // recycled buffer at the same class size lets the driver keep its
+    // storage, so steady-state tile churn allocates no new buffers.
+    void releaseBufferObject(GLuint handle, size_t size = 0);
+
+    // Queue a GL resource disposal to run on the render thread a few frames
+    // from now. This is thread-safe.
+    void queueDisposal(std::function<void()> _task);
+
+    // Run a batch of disposals that have aged past the delay; called once
+    // per frame before draw submission starts.
+    void flushDisposalQueue();
+
+    // Consume one unit of this frame's mipmap generation budget; returns
+    // false once the budget is spent, deferring further chains to later
+    // frames.
+    bool mipmapBudget();
+
     Texture* getDefaultPointTexture();
 
     std::array<GLuint, MAX_ATTRIBUTES> attributeBindings = { { 0 } };
 
     JobQueue jobQueue;
 
+    // Counts of GL state changes actually issued since the last reset,
+    // i.e. the calls the state cache could not eliminate. Collected by the
+    // debug overlay to help tune scenes for weak GPUs.
+    struct StateStats {
+        uint32_t programBinds = 0;
+        uint32_t textureBinds = 0;
+        uint32_t blendChanges = 0;
+        uint32_t bufferBinds = 0;
+        uint32_t vertexArrayBinds = 0;
+    };
+
+    const StateStats& stats() const { return m_stats; }
+
+    void resetStats() { m_stats = StateStats(); }
+
 private:
 
     int m_validGeneration = 0;
     uint32_t m_nextTextureUnit = 0;
 
+    StateStats m_stats;
+
+    // Recycled buffer objects bucketed by storage size class
+    std::map<size_t, std::vector<GLuint>> m_bufferPool;
+    size_t m_pooledBuffers = 0;
+
+    struct Disposal {
+        uint32_t frame;
+        std::function<void()> task;
+    };
+
+    std::deque<Disposal> m_disposals;
+    std::mutex m_disposalMutex;
+    uint32_t m_frameCount = 0;
+    size_t m_mipmapBuilds = 0;
+
     GLuint m_quadIndexBuffer = 0;
     void deleteQuadIndexBuffer();
     void generateQuadIndexBuffer();
@@ -152,10 +252,21 @@ private:
         bool set;
     } m_frontFace, m_cullFace;
 
+    struct {
+        GLenum func;
+        bool set;
+    } m_depthFunc;
+
     struct {
         GLuint handle;
         bool set;
-    } m_vertexBuffer, m_indexBuffer;
+    } m_vertexBuffer, m_indexBuffer, m_vertexArray, m_framebuffer;
+
+    struct {
+        GLint x, y;
+        GLsizei width, height;
+        bool set;
+    } m_viewport;
 
     struct {
         GLuint program;
@@ -1,19 +1,81 @@
 #include "shaderProgram.h"
 
 #include "platform.h"
+#include "debug/sceneLoadProfile.h"
 #include "scene/light.h"
 #include "gl/disposer.h"
 #include "gl/error.h"
+#include "gl/hardware.h"
 #include "gl/renderState.h"
 #include "glm/gtc/type_ptr.hpp"
 #include "log.h"
+#include "util/hash.h"
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <regex>
 #include <set>
 
 namespace Tangram {
 
+std::string ShaderProgram::s_binaryCachePath;
+
+namespace {
+
+// Compiled shader stages shared between programs, keyed by a hash of
+// the final source. Styles frequently produce byte-identical stages
+// (most often vertex shaders differing only in their fragment half), so
+// sharing avoids compiling the same source once per program. Entries
+// are reference counted; the cache belongs to one GL context generation
+// and is dropped whole when the context is lost, since every handle in
+// it died with the context. Only touched on the render thread.
+struct ShaderStage {
+    GLuint handle = 0;
+    int refs = 0;
+};
+
+std::map<size_t, ShaderStage> s_stageCache;
+int s_stageGeneration = -1;
+
+// Canonical vertex attribute locations, bound before every program is
+// linked so that locations match across programs. Names that never
+// appear in the same shader may share a slot; all slots stay below the
+// GLES2 minimum of eight vertex attributes.
+const std::pair<const char*, GLuint> s_attribLocations[] = {
+    { "a_position", 0 },
+    { "a_color",    1 },
+    { "a_normal",   2 },
+    { "a_texcoord", 3 },
+    { "a_uv",       3 },
+    { "a_extrude",  4 },
+    { "a_alpha",    5 },
+    { "a_scale",    6 },
+    { "a_stroke",   7 },
+};
+
+void releaseCompiledShader(GLuint _handle, int _generation) {
+
+    if (_handle == 0) { return; }
+
+    if (_generation == s_stageGeneration) {
+        for (auto it = s_stageCache.begin(); it != s_stageCache.end(); ++it) {
+            if (it->second.handle != _handle) { continue; }
+            if (--it->second.refs == 0) {
+                GL::deleteShader(_handle);
+                s_stageCache.erase(it);
+            }
+            return;
+        }
+    }
+
+    // Not in the cache for this generation; delete directly.
+    GL::deleteShader(_handle);
+}
+
+} // namespace
+
 ShaderProgram::ShaderProgram() {
     // Nothing to do.
 }
@@ -31,13 +93,8 @@ ShaderProgram::~ShaderProgram() {
                 GL::deleteProgram(glProgram);
             }
 
-            if (glFragmentShader != 0) {
-                GL::deleteShader(glFragmentShader);
-            }
-
-            if (glVertexShader != 0) {
-                GL::deleteShader(glVertexShader);
-            }
+            releaseCompiledShader(glFragmentShader, generation);
+            releaseCompiledShader(glVertexShader, generation);
         }
         // Deleting the shader program that is currently in-use sets the current shader program to 0
         // so we un-set the current program in the render state.
@@ -49,6 +106,7 @@ void ShaderProgram::setSourceStrings(const std::string& _fragSrc, const std::str
     m_fragmentShaderSource = std::string(_fragSrc);
     m_vertexShaderSource = std::string(_vertSrc);
     m_needsBuild = true;
+    m_sourcesDirty = true;
 }
 
 void ShaderProgram::addSourceBlock(const std::string& _tagName, const std::string& _glslSource, bool _allowDuplicate){
@@ -63,6 +121,7 @@ void ShaderProgram::addSourceBlock(const std::string& _tagName, const std::strin
 
     m_sourceBlocks[_tagName].push_back(_glslSource);
     m_needsBuild = true;
+    m_sourcesDirty = true;
 
     //  TODO:
     //          - add Global Blocks
@@ -70,17 +129,13 @@ void ShaderProgram::addSourceBlock(const std::string& _tagName, const std::strin
 
 GLint ShaderProgram::getAttribLocation(const std::string& _attribName) {
 
-    auto it = m_attribMap.find(_attribName);
-
-    if (it == m_attribMap.end()) {
-        // If this is a new entry, get the actual location from OpenGL.
-        GLint location = GL::getAttribLocation(m_glProgram, _attribName.c_str());
-        m_attribMap[_attribName] = location;
-        return location;
-    } else {
-        return it->second;
+    for (auto& attrib : s_attribLocations) {
+        if (_attribName == attrib.first) {
+            return attrib.second;
+        }
     }
 
+    return -1;
 }
 
 GLint ShaderProgram::getUniformLocation(const UniformLocation& _uniform) {
@@ -120,25 +175,70 @@ bool ShaderProgram::build(RenderState& rs) {
 
     if (m_invalidShaderSource) { return false; }
 
-    // Inject source blocks
+    // Scene-load report entry covering this build; binary cache hits
+    // show up as near-zero entries
+    struct BuildTimer {
+        const std::string& name;
+        int64_t start = SceneLoadProfile::now();
+        ~BuildTimer() { SceneLoadProfile::addShader(name, SceneLoadProfile::msSince(start)); }
+    } buildTimer { m_description };
+
+    // Inject source blocks. Assembly is deterministic in the blocks and
+    // base sources, so rebuilds after a GL context loss reuse the
+    // strings assembled on the first build.
+
+    if (m_sourcesDirty) {
+        // Programs without injected lights never reference the lighting
+        // functions; leaving them out keeps unlit permutations minimal.
+        // Lit styles always have at least the default ambient light.
+        if (m_sourceBlocks.find("__lighting") != m_sourceBlocks.end() ||
+            m_sourceBlocks.find("__lights_to_compute") != m_sourceBlocks.end()) {
+            Light::assembleLights(m_sourceBlocks);
+        }
+
+        m_builtVertexSource = applySourceBlocks(m_vertexShaderSource, false);
+        m_builtFragmentSource = applySourceBlocks(m_fragmentShaderSource, true);
+        m_sourcesDirty = false;
+    }
+
+    const auto& vertSrc = m_builtVertexSource;
+    const auto& fragSrc = m_builtFragmentSource;
+
+    // Try to reload a previously linked binary for these sources, skipping
+    // compilation and linking entirely on a cache hit
+
+    std::string cacheFile;
+    if (!s_binaryCachePath.empty() && Hardware::supportsProgramBinary) {
+        cacheFile = binaryCacheFile(vertSrc, fragSrc);
 
-    Light::assembleLights(m_sourceBlocks);
+        GLuint program = loadBinaryProgram(cacheFile);
+        if (program != 0) {
+            releaseCompiledShader(m_glFragmentShader, m_generation);
+            releaseCompiledShader(m_glVertexShader, m_generation);
+            GL::deleteProgram(m_glProgram);
 
-    auto vertSrc = applySourceBlocks(m_vertexShaderSource, false);
-    auto fragSrc = applySourceBlocks(m_fragmentShaderSource, true);
+            m_glFragmentShader = 0;
+            m_glVertexShader = 0;
+            m_glProgram = program;
+
+            m_disposer = Disposer(rs);
+
+            return true;
+        }
+    }
 
     // Try to compile vertex and fragment shaders, releasing resources and quiting on failure
 
-    GLint vertexShader = makeCompiledShader(vertSrc, GL_VERTEX_SHADER);
+    GLint vertexShader = getCompiledShader(vertSrc, GL_VERTEX_SHADER);
 
     if (vertexShader == 0) {
         return false;
     }
 
-    GLint fragmentShader = makeCompiledShader(fragSrc, GL_FRAGMENT_SHADER);
+    GLint fragmentShader = getCompiledShader(fragSrc, GL_FRAGMENT_SHADER);
 
     if (fragmentShader == 0) {
-        GL::deleteShader(vertexShader);
+        releaseCompiledShader(vertexShader, m_generation);
         return false;
     }
 
@@ -147,35 +247,125 @@ bool ShaderProgram::build(RenderState& rs) {
     GLint program = makeLinkedShaderProgram(fragmentShader, vertexShader);
 
     if (program == 0) {
-        GL::deleteShader(vertexShader);
-        GL::deleteShader(fragmentShader);
+        releaseCompiledShader(vertexShader, m_generation);
+        releaseCompiledShader(fragmentShader, m_generation);
         return false;
     }
 
-    // Delete handles for old shaders and program; values of 0 are silently ignored
+    // Release handles for old shaders and delete the old program;
+    // program values of 0 are silently ignored
 
-    GL::deleteShader(m_glFragmentShader);
-    GL::deleteShader(m_glVertexShader);
+    releaseCompiledShader(m_glFragmentShader, m_generation);
+    releaseCompiledShader(m_glVertexShader, m_generation);
     GL::deleteProgram(m_glProgram);
 
     m_glFragmentShader = fragmentShader;
     m_glVertexShader = vertexShader;
     m_glProgram = program;
 
-    // Clear any cached shader locations
-
-    m_attribMap.clear();
     m_disposer = Disposer(rs);
 
+    if (!cacheFile.empty()) {
+        saveBinaryProgram(program, cacheFile);
+    }
+
     return true;
 }
 
+std::string ShaderProgram::binaryCacheFile(const std::string& _vertSrc, const std::string& _fragSrc) const {
+
+    size_t hash = 0;
+    hash_combine(hash, _vertSrc);
+    hash_combine(hash, _fragSrc);
+
+    // Binaries bake in the attribute locations bound at link time, so a
+    // change to the canonical table must invalidate cached binaries
+    for (auto& attrib : s_attribLocations) {
+        hash_combine(hash, std::string(attrib.first));
+        hash_combine(hash, attrib.second);
+    }
+
+    auto version = reinterpret_cast<const char*>(GL::getString(GL_VERSION));
+    auto renderer = reinterpret_cast<const char*>(GL::getString(GL_RENDERER));
+    if (version) { hash_combine(hash, std::string(version)); }
+    if (renderer) { hash_combine(hash, std::string(renderer)); }
+
+    return s_binaryCachePath + "/" + std::to_string(hash) + ".bin";
+}
+
+GLuint ShaderProgram::loadBinaryProgram(const std::string& _path) {
+
+    size_t size = 0;
+    unsigned char* data = bytesFromFile(_path.c_str(), size);
+
+    if (!data) { return 0; }
+
+    if (size <= sizeof(GLenum)) {
+        free(data);
+        return 0;
+    }
+
+    GLenum format;
+    std::memcpy(&format, data, sizeof(GLenum));
+
+    GLuint program = GL::createProgram();
+    GL::programBinary(program, format, data + sizeof(GLenum), size - sizeof(GLenum));
+    free(data);
+
+    GLint isLinked;
+    GL::getProgramiv(program, GL_LINK_STATUS, &isLinked);
+
+    if (isLinked == GL_FALSE) {
+        // The binary was produced by another driver revision; fall back to
+        // compiling from source and overwrite the file afterwards
+        LOGW("Cached program binary rejected for %s", m_description.c_str());
+        GL::deleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+void ShaderProgram::saveBinaryProgram(GLuint _program, const std::string& _path) {
+
+    GLint length = 0;
+    GL::getProgramiv(_program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+    // Drivers may report no retrievable binary, e.g. when the program was
+    // linked without the retrievable hint
+    if (length <= 0) { return; }
+
+    std::vector<unsigned char> binary(length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    GL::getProgramBinary(_program, length, &written, &format, binary.data());
+
+    if (written <= 0) { return; }
+
+    FILE* file = fopen(_path.c_str(), "wb");
+    if (!file) {
+        LOGW("Could not write program binary at %s", _path.c_str());
+        return;
+    }
+
+    fwrite(&format, sizeof(GLenum), 1, file);
+    fwrite(binary.data(), 1, written, file);
+    fclose(file);
+}
+
 GLuint ShaderProgram::makeLinkedShaderProgram(GLint _fragShader, GLint _vertShader) {
 
     GLuint program = GL::createProgram();
 
     GL::attachShader(program, _fragShader);
     GL::attachShader(program, _vertShader);
+
+    // Bind the canonical attribute locations; names that do not appear
+    // in the sources are simply ignored by the driver
+    for (auto& attrib : s_attribLocations) {
+        GL::bindAttribLocation(program, attrib.second, attrib.first);
+    }
+
     GL::linkProgram(program);
 
     GLint isLinked;
@@ -199,6 +389,31 @@ GLuint ShaderProgram::makeLinkedShaderProgram(GLint _fragShader, GLint _vertShad
     return program;
 }
 
+GLuint ShaderProgram::getCompiledShader(const std::string& _src, GLenum _type) {
+
+    if (s_stageGeneration != m_generation) {
+        // Handles from the previous context died with it.
+        s_stageCache.clear();
+        s_stageGeneration = m_generation;
+    }
+
+    size_t key = 0;
+    hash_combine(key, _src);
+    hash_combine(key, _type);
+
+    auto it = s_stageCache.find(key);
+    if (it != s_stageCache.end()) {
+        it->second.refs++;
+        return it->second.handle;
+    }
+
+    GLuint shader = makeCompiledShader(_src, _type);
+    if (shader != 0) {
+        s_stageCache.emplace(key, ShaderStage{ shader, 1 });
+    }
+    return shader;
+}
+
 GLuint ShaderProgram::makeCompiledShader(const std::string& _src, GLenum _type) {
 
     GLuint shader = GL::createShader(_type);
@@ -43,8 +43,11 @@ public:
     GLuint getGlFragmentShader() const { return m_glFragmentShader; };
     GLuint getGlVertexShader() const { return m_glVertexShader; };
 
-    // Fetch the location of a shader attribute, caching the result.
-    GLint getAttribLocation(const std::string& _attribName);
+    // Location of a vertex attribute in the canonical table bound with
+    // glBindAttribLocation before every program is linked. Locations are
+    // the same across all programs, so vertex layouts resolve them once
+    // instead of querying per program. Returns -1 for unknown names.
+    static GLint getAttribLocation(const std::string& _attribName);
 
     // Fetch the location of a shader uniform, caching the result.
     GLint getUniformLocation(const UniformLocation& _uniformName);
@@ -85,6 +88,12 @@ public:
 
     static std::string getExtensionDeclaration(const std::string& _extension);
 
+    // Set a writable directory in which linked program binaries are cached
+    // and reloaded on later runs, keyed by the shader sources and the driver
+    // version. Requires the get_program_binary extension; an empty path (the
+    // default) disables the cache.
+    static void setBinaryCachePath(const std::string& _path) { s_binaryCachePath = _path; }
+
     auto getSourceBlocks() const { return  m_sourceBlocks; }
 
     void setDescription(std::string _description) { m_description = _description; }
@@ -122,12 +131,19 @@ private:
     GLuint m_glFragmentShader = 0;
     GLuint m_glVertexShader = 0;
 
-    fastmap<std::string, GLint> m_attribMap;
-    fastmap<GLint, UniformValue> m_uniformCache;
+    // SoA map: this is probed per uniform per frame, so the keys
+    // stay contiguous for the branchless search.
+    fastmap_soa<GLint, UniformValue> m_uniformCache;
 
     std::string m_fragmentShaderSource;
     std::string m_vertexShaderSource;
 
+    // Final sources with all blocks applied, reused on rebuilds (e.g.
+    // after a GL context loss) while the blocks are unchanged
+    std::string m_builtFragmentSource;
+    std::string m_builtVertexSource;
+    bool m_sourcesDirty = true;
+
     // An optional shader description printed on compile failure
     std::string m_description;
 
@@ -138,12 +154,26 @@ private:
 
     Disposer m_disposer;
 
+    static std::string s_binaryCachePath;
+
     void checkValidity(RenderState& rs);
     GLuint makeLinkedShaderProgram(GLint _fragShader, GLint _vertShader);
     GLuint makeCompiledShader(const std::string& _src, GLenum _type);
 
+    // Fetch a compiled shader stage from the shared cache, compiling
+    // and inserting it on a miss. The returned handle is reference
+    // counted and must be released with releaseCompiledShader.
+    GLuint getCompiledShader(const std::string& _src, GLenum _type);
+
     std::string applySourceBlocks(const std::string& source, bool fragShader);
 
+    // Cache file name for the given final sources, combining their hash with
+    // the driver version and renderer strings so stale binaries from another
+    // driver are never loaded
+    std::string binaryCacheFile(const std::string& _vertSrc, const std::string& _fragSrc) const;
+    GLuint loadBinaryProgram(const std::string& _path);
+    void saveBinaryProgram(GLuint _program, const std::string& _path);
+
 };
 
 #define SHADER_SOURCE(NAME) ShaderProgram::shaderSourceBlock(NAME ## _data, NAME ## _size)
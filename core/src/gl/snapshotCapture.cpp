@@ -0,0 +1,116 @@
+#include "gl/snapshotCapture.h"
+
+#include "gl/hardware.h"
+#include "gl/renderState.h"
+#include "log.h"
+
+#include <cstring>
+
+namespace Tangram {
+
+SnapshotCapture::~SnapshotCapture() {
+
+    // Callbacks of unfinished captures are dropped; the GL objects go
+    // through the disposer like any other resource
+    for (auto& readback : m_inFlight) {
+        GLuint pbo = readback.pbo;
+        int generation = m_generation;
+
+        m_disposer([=](RenderState& rs) {
+            if (rs.isValidGeneration(generation)) {
+                GL::deleteBuffers(1, &pbo);
+            }
+        });
+    }
+}
+
+void SnapshotCapture::requestCapture(SnapshotCallback _callback) {
+    m_requests.push_back(std::move(_callback));
+}
+
+void SnapshotCapture::complete(InFlight& _readback, std::unique_ptr<SnapshotData> _data) {
+
+    for (size_t i = 1; i < _readback.callbacks.size(); i++) {
+        auto copy = _data ? std::make_unique<SnapshotData>(*_data) : nullptr;
+        _readback.callbacks[i](std::move(copy));
+    }
+    _readback.callbacks[0](std::move(_data));
+}
+
+void SnapshotCapture::deliver(RenderState& rs) {
+
+    if (m_inFlight.empty()) { return; }
+
+    // After a context loss the copies never finished and the buffer
+    // handles are stale; the callbacks still get their answer
+    bool contextLost = !rs.isValidGeneration(m_generation);
+
+    for (auto& readback : m_inFlight) {
+
+        std::unique_ptr<SnapshotData> data;
+
+        if (!contextLost) {
+            data = std::make_unique<SnapshotData>();
+            data->width = readback.width;
+            data->height = readback.height;
+            data->pixels.resize(size_t(readback.width) * readback.height);
+
+            GL::bindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+            void* pixels = GL::mapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+            if (pixels) {
+                std::memcpy(data->pixels.data(), pixels, data->pixels.size() * 4);
+                GL::unmapBuffer(GL_PIXEL_PACK_BUFFER);
+            } else {
+                LOGW("Could not map snapshot readback buffer");
+                data.reset();
+            }
+            GL::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            GL::deleteBuffers(1, &readback.pbo);
+        }
+
+        complete(readback, std::move(data));
+    }
+    m_inFlight.clear();
+}
+
+void SnapshotCapture::capture(RenderState& rs, int _width, int _height) {
+
+    if (m_requests.empty()) { return; }
+
+    m_generation = rs.generation();
+    m_disposer = Disposer(rs);
+
+    size_t bytes = size_t(_width) * _height * 4;
+
+    if (Hardware::supportsPixelBuffers && Hardware::supportsMapBuffer) {
+
+        // With the pack buffer bound, readPixels returns right away and
+        // the copy runs behind the remaining frame; the result is mapped
+        // by deliver() on the next frame
+        GLuint pbo = 0;
+        GL::genBuffers(1, &pbo);
+        GL::bindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        GL::bufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        GL::readPixels(0, 0, _width, _height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        GL::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        m_inFlight.push_back({pbo, _width, _height, std::move(m_requests)});
+
+    } else {
+
+        auto data = std::make_unique<SnapshotData>();
+        data->width = _width;
+        data->height = _height;
+        data->pixels.resize(size_t(_width) * _height);
+
+        GL::readPixels(0, 0, _width, _height, GL_RGBA, GL_UNSIGNED_BYTE,
+                       data->pixels.data());
+
+        InFlight readback{0, _width, _height, std::move(m_requests)};
+        complete(readback, std::move(data));
+    }
+
+    m_requests.clear();
+}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "gl.h"
+#include "gl/disposer.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Tangram {
+
+class RenderState;
+
+/* Pixels of a completed snapshot: tightly packed RGBA rows, bottom row
+ * first, exactly as read back from GL; see Map::captureSnapshotAsync. */
+struct SnapshotData {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned int> pixels;
+};
+
+using SnapshotCallback = std::function<void(std::unique_ptr<SnapshotData>)>;
+
+/* SnapshotCapture - Asynchronous frame readback
+ *
+ * Captures finished frames without stalling the pipeline: right after
+ * the map is drawn - before any debug overlay - the frame is read into
+ * a pixel buffer object, which turns glReadPixels into a copy the GPU
+ * performs on its own schedule. The buffer is mapped and delivered on
+ * the following frame, when that copy has long retired. Drivers without
+ * pixel buffers (or without mapbuffer to get the pixels back out) fall
+ * back to a synchronous read, delivered the same frame.
+ */
+class SnapshotCapture {
+
+public:
+
+    ~SnapshotCapture();
+
+    /* Queue a capture of the next rendered frame. Every queued callback
+     * is served by the same readback. */
+    void requestCapture(SnapshotCallback _callback);
+
+    /* Whether a capture still has to be issued or delivered, i.e. frames
+     * must keep rendering */
+    bool hasPending() const { return !m_requests.empty() || !m_inFlight.empty(); }
+
+    /* Deliver readbacks issued on an earlier frame; called once per
+     * frame, before new captures are issued */
+    void deliver(RenderState& rs);
+
+    /* Read the frame just drawn from the bound framebuffer; called from
+     * render() once all map geometry is down */
+    void capture(RenderState& rs, int _width, int _height);
+
+private:
+
+    struct InFlight {
+        GLuint pbo = 0;
+        int width = 0;
+        int height = 0;
+        std::vector<SnapshotCallback> callbacks;
+    };
+
+    /* Invoke the callbacks of one readback, copying the pixels only when
+     * more than one consumer asked for the same frame */
+    static void complete(InFlight& _readback, std::unique_ptr<SnapshotData> _data);
+
+    std::vector<SnapshotCallback> m_requests;
+    std::vector<InFlight> m_inFlight;
+
+    Disposer m_disposer;
+
+    int m_generation = -1;
+};
+
+}
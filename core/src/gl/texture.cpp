@@ -11,6 +11,8 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#include "util/taskExecutor.h"
+
 #include <cstring> // for memset
 
 namespace Tangram {
@@ -33,6 +35,8 @@ Texture::Texture(const unsigned char* data, size_t dataSize, TextureOptions opti
 
 Texture::~Texture() {
 
+    freeDecodedData();
+
     auto generation = m_generation;
     auto glHandle = m_glHandle;
     auto target = m_target;
@@ -64,9 +68,12 @@ bool Texture::loadImageFromMemory(const unsigned char* blob, unsigned int size)
     if (pixels) {
         resize(width, height);
 
-        setData(reinterpret_cast<GLuint*>(pixels), width * height);
-
-        stbi_image_free(pixels);
+        // Adopt the decoder's buffer instead of copying it into m_data;
+        // it is uploaded in place and freed once on the GPU
+        freeDecodedData();
+        m_data.clear();
+        m_decodedData = pixels;
+        setDirty(0, m_height);
 
         return true;
     }
@@ -91,19 +98,46 @@ Texture& Texture::operator=(Texture&& _other) {
     m_options = _other.m_options;
     m_data = std::move(_other.m_data);
     m_dirtyRanges = std::move(_other.m_dirtyRanges);
+    freeDecodedData();
+    m_decodedData = _other.m_decodedData;
+    _other.m_decodedData = nullptr;
     m_shouldResize = _other.m_shouldResize;
+    m_disposeAfterUpload = _other.m_disposeAfterUpload;
     m_width = _other.m_width;
     m_height = _other.m_height;
     m_target = _other.m_target;
     m_generation = _other.m_generation;
     m_generateMipmaps = _other.m_generateMipmaps;
+    m_needsMipmaps = _other.m_needsMipmaps;
     m_disposer = std::move(_other.m_disposer);
 
     return *this;
 }
 
+void Texture::freeDecodedData() {
+    if (m_decodedData) {
+        stbi_image_free(m_decodedData);
+        m_decodedData = nullptr;
+    }
+}
+
+void Texture::decodeAsync(std::shared_ptr<Texture> _texture, std::vector<char>&& _blob,
+                          std::function<void(bool)> _done) {
+
+    static TaskExecutor::Lane s_decodeWorker;
+
+    s_decodeWorker.enqueue([texture = std::move(_texture), blob = std::move(_blob),
+                            done = std::move(_done)]() {
+            bool ok = texture->loadImageFromMemory(
+                    reinterpret_cast<const unsigned char*>(blob.data()), blob.size());
+            if (done) { done(ok); }
+        });
+}
+
 void Texture::setData(const GLuint* _data, unsigned int _dataSize) {
 
+    freeDecodedData();
+
     if (m_data.size() > 0) { m_data.clear(); }
 
     m_data.insert(m_data.begin(), _data, _data + _dataSize);
@@ -120,6 +154,12 @@ void Texture::setSubData(const GLuint* _subData, uint16_t _xoff, uint16_t _yoff,
     // Init m_data if update() was not called after resize()
     if (m_data.size() != (m_width * m_height) / divisor) {
         m_data.resize((m_width * m_height) / divisor);
+        // Partial updates are applied to m_data, so pixels adopted from
+        // the decoder move there first
+        if (m_decodedData) {
+            std::memcpy(m_data.data(), m_decodedData, m_width * m_height * bpp);
+            freeDecodedData();
+        }
     }
 
     // update m_data with subdata
@@ -178,11 +218,20 @@ void Texture::setDirty(size_t _yoff, size_t _height) {
 void Texture::bind(RenderState& rs, GLuint _unit) {
     rs.textureUnit(_unit);
     rs.texture(m_target, m_glHandle);
+
+    if (m_needsMipmaps && rs.mipmapBudget()) {
+        GL::generateMipmap(m_target);
+        GL::texParameteri(m_target, GL_TEXTURE_MIN_FILTER, m_options.filtering.min);
+        m_needsMipmaps = false;
+    }
 }
 
 void Texture::generate(RenderState& rs, GLuint _textureUnit) {
     GL::genTextures(1, &m_glHandle);
 
+    // A chain deferred on a lost context died with it
+    m_needsMipmaps = false;
+
     bind(rs, _textureUnit);
 
     GL::texParameteri(m_target, GL_TEXTURE_MIN_FILTER, m_options.filtering.min);
@@ -216,15 +265,23 @@ void Texture::update(RenderState& rs, GLuint _textureUnit) {
     }
 
     if (m_glHandle == 0) {
-        if (m_data.size() == 0) {
+        if (m_data.size() == 0 && !m_decodedData) {
             size_t divisor = sizeof(GLuint) / bytesPerPixel();
             m_data.resize((m_width * m_height) / divisor, 0);
         }
     }
 
-    GLuint* data = m_data.size() > 0 ? m_data.data() : nullptr;
+    GLuint* data = m_data.size() > 0 ? m_data.data()
+                 : reinterpret_cast<GLuint*>(m_decodedData);
 
     update(rs, _textureUnit, data);
+
+    // Once a static texture is fully on the GPU its CPU copy is dead weight;
+    // a satellite basemap otherwise doubles its memory use
+    if (m_disposeAfterUpload && !m_shouldResize && m_dirtyRanges.empty()) {
+        std::vector<GLuint>().swap(m_data);
+        freeDecodedData();
+    }
 }
 
 void Texture::update(RenderState& rs, GLuint _textureUnit, const GLuint* data) {
@@ -253,8 +310,16 @@ void Texture::update(RenderState& rs, GLuint _textureUnit, const GLuint* data) {
                        GL_UNSIGNED_BYTE, data);
 
         if (data && m_generateMipmaps) {
-            // generate the mipmaps for this texture
-            GL::generateMipmap(m_target);
+            if (rs.mipmapBudget()) {
+                // generate the mipmaps for this texture
+                GL::generateMipmap(m_target);
+            } else {
+                // This frame's budget is spent; sample the base level
+                // until a later bind() builds the chain, since a mipmap
+                // min filter with an incomplete chain samples black
+                GL::texParameteri(m_target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                m_needsMipmaps = true;
+            }
         }
         m_shouldResize = false;
         m_dirtyRanges.clear();
@@ -3,6 +3,7 @@
 #include "gl.h"
 #include "gl/disposer.h"
 
+#include <functional>
 #include <vector>
 #include <memory>
 #include <string>
@@ -26,6 +27,25 @@ struct TextureOptions {
     GLenum format;
     TextureFiltering filtering;
     TextureWrapping wrapping;
+
+    // Filtering policies for the common texture classes, so sprites,
+    // data textures and raster basemaps each declare their sampling
+    // intent instead of hand-rolling the same option structs:
+
+    // RGBA sampled with bilinear filtering - sprites, marker bitmaps, icons
+    static TextureOptions linearRgba() {
+        return { GL_RGBA, GL_RGBA, { GL_LINEAR, GL_LINEAR }, { GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE } };
+    }
+
+    // RGBA fetched at exact texels - dash patterns and other shader data
+    static TextureOptions nearestRgba() {
+        return { GL_RGBA, GL_RGBA, { GL_NEAREST, GL_NEAREST }, { GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE } };
+    }
+
+    // RGBA minified through a mipmap chain - raster basemaps
+    static TextureOptions mipmapRgba() {
+        return { GL_RGBA, GL_RGBA, { GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR }, { GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE } };
+    }
 };
 
 #define DEFAULT_TEXTURE_OPTION \
@@ -81,6 +101,11 @@ public:
     /* Checks whether the texture has valid data and has been successfully uploaded to GPU */
     bool isValid(RenderState& rs) const;
 
+    /* Release the CPU-side pixel copy after the next full upload. Only for
+     * textures whose content never changes: partial updates and re-uploads
+     * after a context loss need the data to still be around. */
+    void setDisposeAfterUpload(bool _dispose) { m_disposeAfterUpload = _dispose; }
+
     typedef std::pair<GLuint, GLuint> TextureSlot;
 
     static void invalidateAllTextures();
@@ -89,6 +114,14 @@ public:
 
     bool loadImageFromMemory(const unsigned char* blob, unsigned int size);
 
+    /* Decode an image blob on the shared decode worker and attach the
+     * pixels to _texture, so JPEG/PNG decompression stays off the render
+     * and network threads. _done runs on the decode thread afterwards,
+     * with false when the blob could not be decoded. */
+    static void decodeAsync(std::shared_ptr<Texture> _texture,
+                            std::vector<char>&& _blob,
+                            std::function<void(bool)> _done = nullptr);
+
 protected:
 
     void generate(RenderState& rs, GLuint _textureUnit);
@@ -96,6 +129,12 @@ protected:
 
     TextureOptions m_options;
     std::vector<GLuint> m_data;
+
+    // Pixels adopted from the image decoder without a copy; uploaded in
+    // place of m_data and freed with the decoder's deallocator
+    unsigned char* m_decodedData = nullptr;
+    void freeDecodedData();
+
     GLuint m_glHandle;
 
     struct DirtyRange {
@@ -106,6 +145,8 @@ protected:
 
     bool m_shouldResize;
 
+    bool m_disposeAfterUpload = false;
+
     unsigned int m_width;
     unsigned int m_height;
 
@@ -120,6 +161,10 @@ private:
     size_t bytesPerPixel();
 
     bool m_generateMipmaps;
+
+    // Mipmap chain deferred by the per-frame budget; built on a later
+    // bind(), see RenderState::mipmapBudget()
+    bool m_needsMipmaps = false;
 };
 
 }
@@ -18,18 +18,17 @@ TextureCube::TextureCube(std::string _file, TextureOptions _options)
 }
 
 void TextureCube::load(const std::string& _file) {
-    size_t size;
-    unsigned char* data = bytesFromFile(_file.c_str(), size);
+    auto file = mapFile(_file.c_str());
     unsigned char* pixels;
     int width, height, comp;
 
-    if (data == nullptr || size == 0) {
+    if (!file || file.size() == 0) {
         LOGE("Texture not found! '%s'", _file.c_str());
-        free(data);
         return;
     }
 
-    pixels = stbi_load_from_memory(data, size, &width, &height, &comp, STBI_rgb_alpha);
+    pixels = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(file.data()),
+                                   file.size(), &width, &height, &comp, STBI_rgb_alpha);
 
     size = width * height;
 
@@ -63,7 +62,6 @@ void TextureCube::load(const std::string& _file) {
         }
     }
 
-    free(data);
     stbi_image_free(pixels);
 
 }
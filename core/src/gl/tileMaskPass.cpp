@@ -0,0 +1,80 @@
+#include "gl/tileMaskPass.h"
+
+#include "gl/renderState.h"
+#include "gl/shaderProgram.h"
+#include "gl/vertexLayout.h"
+#include "tile/tile.h"
+
+#include "shaders/tileMask_vs.h"
+#include "shaders/tileMask_fs.h"
+
+#include "glm/vec2.hpp"
+
+namespace Tangram {
+
+TileMaskPass::TileMaskPass() {}
+
+TileMaskPass::~TileMaskPass() {}
+
+void TileMaskPass::drawMask(RenderState& rs, const std::vector<const Tile*>& _tiles) {
+
+    if (!m_shaderProgram) {
+        m_shaderProgram = std::make_unique<ShaderProgram>();
+        m_shaderProgram->setSourceStrings(SHADER_SOURCE(tileMask_fs),
+                                          SHADER_SOURCE(tileMask_vs));
+
+        m_vertexLayout = std::unique_ptr<VertexLayout>(new VertexLayout({
+            {"a_position", 2, GL_FLOAT, false, 0},
+        }));
+    }
+
+    if (!m_shaderProgram->use(rs)) { return; }
+
+    // Tile-local coordinates span the unit square; the tile model matrix
+    // scales it to the tile's extent.
+    glm::vec2 quad[4] = {
+        { 0.f, 0.f },
+        { 1.f, 0.f },
+        { 0.f, 1.f },
+        { 1.f, 1.f },
+    };
+
+    rs.vertexBuffer(0);
+    rs.colorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    rs.depthTest(GL_FALSE);
+    rs.depthMask(GL_FALSE);
+    rs.stencilTest(GL_TRUE);
+    rs.stencilMask(0xff);
+    rs.stencilFunc(GL_ALWAYS, 1, 0xff);
+    rs.stencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+
+    m_vertexLayout->enable(rs, *m_shaderProgram, 0, quad);
+
+    for (const auto* tile : _tiles) {
+        if (tile->isProxy()) { continue; }
+
+        m_shaderProgram->setUniformMatrix4f(rs, m_uMvp, tile->mvp());
+        GL::drawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+
+    // Leave the stencil read-only for the style draws that follow.
+    rs.stencilMask(0);
+    rs.stencilTest(GL_FALSE);
+    rs.colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    rs.depthMask(GL_TRUE);
+}
+
+void TileMaskPass::applyStencilState(RenderState& rs, const Tile& _tile) {
+
+    if (_tile.isProxy()) {
+        // Shade proxy geometry only where no target tile footprint was
+        // stamped.
+        rs.stencilTest(GL_TRUE);
+        rs.stencilFunc(GL_EQUAL, 0, 0xff);
+        rs.stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    } else {
+        rs.stencilTest(GL_FALSE);
+    }
+}
+
+}
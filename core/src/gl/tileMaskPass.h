@@ -0,0 +1,49 @@
+#pragma once
+
+#include "gl/uniform.h"
+
+#include <memory>
+#include <vector>
+
+namespace Tangram {
+
+class RenderState;
+class ShaderProgram;
+class Tile;
+class VertexLayout;
+
+/* TileMaskPass - Stencil footprints for proxy tile clipping
+ *
+ * During zoom animations proxy tiles overlap their replacement tiles
+ * and both shade every covered pixel. This pass stamps the footprint
+ * of each non-proxy tile into the stencil buffer before the style
+ * draws, so proxy geometry can be stencil-clipped to the regions no
+ * target tile covers, halving fill cost while proxies are alive.
+ */
+class TileMaskPass {
+
+public:
+
+    TileMaskPass();
+    ~TileMaskPass();
+
+    /* Write the footprint quads of all non-proxy tiles into the stencil
+     * buffer with reference value 1; color and depth writes stay masked.
+     * The stencil buffer must be cleared before this runs. */
+    void drawMask(RenderState& rs, const std::vector<const Tile*>& _tiles);
+
+    /* Configure the stencil test for drawing one tile's meshes after
+     * drawMask has run: proxy tiles pass only where the stencil is
+     * still 0, other tiles draw unclipped. */
+    static void applyStencilState(RenderState& rs, const Tile& _tile);
+
+private:
+
+    std::unique_ptr<ShaderProgram> m_shaderProgram;
+    std::unique_ptr<VertexLayout> m_vertexLayout;
+
+    UniformLocation m_uMvp{"u_mvp"};
+
+};
+
+}
@@ -1,65 +1,60 @@
 #include "vao.h"
 #include "gl/error.h"
 #include "renderState.h"
-#include "shaderProgram.h"
 #include "vertexLayout.h"
-#include <unordered_map>
 
 namespace Tangram {
 
-void Vao::initialize(RenderState& rs, ShaderProgram& _program, const std::vector<std::pair<uint32_t, uint32_t>>& _vertexOffsets,
+void Vao::initialize(RenderState& rs, const std::vector<std::pair<uint32_t, uint32_t>>& _vertexOffsets,
                VertexLayout& _layout, GLuint _vertexBuffer, GLuint _indexBuffer) {
 
     m_glVAOs.resize(_vertexOffsets.size());
 
     GL::genVertexArrays(m_glVAOs.size(), m_glVAOs.data());
 
-    fastmap<std::string, GLuint> locations;
-
-    // FIXME (use a bindAttrib instead of getLocation) to make those locations shader independent
-    for (auto& attrib : _layout.getAttribs()) {
-        GLint location = _program.getAttribLocation(attrib.name);
-        locations[attrib.name] = location;
-    }
-
     int vertexOffset = 0;
     for (size_t i = 0; i < _vertexOffsets.size(); ++i) {
         auto vertexIndexOffset = _vertexOffsets[i];
         int nVerts = vertexIndexOffset.second;
-        GL::bindVertexArray(m_glVAOs[i]);
+        rs.vertexArray(m_glVAOs[i]);
 
-        rs.vertexBufferUnset(_vertexBuffer);
-        rs.vertexBuffer(_vertexBuffer);
+        // Bind the buffers directly: the element binding is captured by the
+        // VAO and the array binding is global state the cache must not track
+        // while a VAO is being recorded
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
 
         if (_indexBuffer != 0) {
-            rs.indexBufferUnset(_indexBuffer);
-            rs.indexBuffer(_indexBuffer);
+            GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
         }
 
-        // Enable vertex layout on the specified locations
-        _layout.enable(locations, vertexOffset * _layout.getStride());
+        // Enable vertex layout at the canonical attribute locations, which
+        // are the same for every program drawing this mesh
+        _layout.enable(vertexOffset * _layout.getStride());
 
         vertexOffset += nVerts;
     }
 
+    // The global array buffer binding was changed behind the cache
+    rs.vertexBufferUnset(_vertexBuffer);
+
 }
 
 bool Vao::isInitialized() {
     return !m_glVAOs.empty();
 }
 
-void Vao::bind(unsigned int _index) {
+void Vao::bind(RenderState& rs, unsigned int _index) {
     if (_index < m_glVAOs.size()) {
-        GL::bindVertexArray(m_glVAOs[_index]);
+        rs.vertexArray(m_glVAOs[_index]);
     }
 }
 
-void Vao::unbind() {
-    GL::bindVertexArray(0);
-}
-
-void Vao::dispose() {
+void Vao::dispose(RenderState& rs) {
     if (!m_glVAOs.empty()) {
+        // Deleting the currently bound VAO resets the binding to 0
+        for (auto vao : m_glVAOs) {
+            rs.vertexArrayUnset(vao);
+        }
         GL::deleteVertexArrays(m_glVAOs.size(), m_glVAOs.data());
         m_glVAOs.clear();
     }
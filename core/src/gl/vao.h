@@ -7,19 +7,17 @@
 namespace Tangram {
 
 class RenderState;
-class ShaderProgram;
 class VertexLayout;
 
 class Vao {
 
 public:
 
-    void initialize(RenderState& rs, ShaderProgram& _program, const std::vector<std::pair<uint32_t, uint32_t>>& _vertexOffsets,
+    void initialize(RenderState& rs, const std::vector<std::pair<uint32_t, uint32_t>>& _vertexOffsets,
                     VertexLayout& _layout, GLuint _vertexBuffer, GLuint _indexBuffer);
     bool isInitialized();
-    void bind(unsigned int _index);
-    void unbind();
-    void dispose();
+    void bind(RenderState& rs, unsigned int _index);
+    void dispose(RenderState& rs);
 
 private:
     std::vector<GLuint> m_glVAOs;
@@ -35,6 +35,14 @@ VertexLayout::VertexLayout(std::vector<VertexAttrib> _attribs) : m_attribs(_attr
 
         // TODO: Automatically add padding or warn if attributes are not byte-aligned
 
+        // Attribute locations are bound per the canonical table when
+        // programs are linked, so they can be resolved once here instead
+        // of being queried per program and draw
+        attrib.location = ShaderProgram::getAttribLocation(attrib.name);
+
+        if (attrib.location < 0) {
+            LOGW("Attribute %s has no canonical location", attrib.name.c_str());
+        }
     }
 }
 
@@ -50,21 +58,14 @@ size_t VertexLayout::getOffset(std::string _attribName) {
     return 0;
 }
 
-void VertexLayout::enable(const fastmap<std::string, GLuint>& _locations, size_t _byteOffset) {
+void VertexLayout::enable(size_t _byteOffset) {
 
     for (auto& attrib : m_attribs) {
-        auto it = _locations.find(attrib.name);
-
-        if (it == _locations.end()) {
-            continue;
-        }
-
-        GLint location = it->second;;
 
-        if (location != -1) {
+        if (attrib.location != -1) {
             void* offset = ((unsigned char*) attrib.offset) + _byteOffset;
-            GL::enableVertexAttribArray(location);
-            GL::vertexAttribPointer(location, attrib.size, attrib.type, attrib.normalized, m_stride, offset);
+            GL::enableVertexAttribArray(attrib.location);
+            GL::vertexAttribPointer(attrib.location, attrib.size, attrib.type, attrib.normalized, m_stride, offset);
         }
     }
 
@@ -77,7 +78,7 @@ void VertexLayout::enable(RenderState& rs, ShaderProgram& _program, size_t _byte
     // Enable all attributes for this layout
     for (auto& attrib : m_attribs) {
 
-        GLint location = _program.getAttribLocation(attrib.name);
+        GLint location = attrib.location;
 
         if (location != -1) {
             auto& loc = rs.attributeBindings[location];
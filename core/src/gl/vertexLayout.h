@@ -2,8 +2,6 @@
 
 #include "gl.h"
 
-#include "util/fastmap.h"
-
 #include <vector>
 #include <memory>
 #include <string>
@@ -23,13 +21,16 @@ public:
         GLenum type;
         GLboolean normalized;
         size_t offset; // Can be left as zero; value is overwritten in constructor of VertexLayout
+        GLint location; // Resolved from the canonical attribute table in constructor of VertexLayout
     };
 
     VertexLayout(std::vector<VertexAttrib> _attribs);
 
     void enable(RenderState& rs, ShaderProgram& _program, size_t _byteOffset, void* _ptr = nullptr);
 
-    void enable(const fastmap<std::string, GLuint>& _locations, size_t _bytOffset);
+    // Enable the layout at its canonical attribute locations without going
+    // through the render state, e.g. while recording a VAO.
+    void enable(size_t _byteOffset);
 
     GLint getStride() const { return m_stride; };
 
@@ -44,7 +44,13 @@ void Label::setParent(Label& _parent, bool _definePriority, bool _defineCollide)
         m_options.collide = _parent.options().collide;
     }
 
-    applyAnchor(m_options.anchors[m_anchorIndex]);
+    // The parent dimension is part of the placement offsets
+    updateAnchorTable();
+    applyAnchor(m_anchorIndex);
+}
+
+void Label::applyAnchor(int _index) {
+    m_anchor = m_anchorOffsets[_index];
 }
 
 float Label::screenDistance2(glm::vec2 _screenPosition) const {
@@ -178,12 +184,24 @@ bool Label::setAnchorIndex(int _index) {
     }
     m_anchorIndex = _index;
 
-    applyAnchor(m_options.anchors[m_anchorIndex]);
+    applyAnchor(m_anchorIndex);
 
     return true;
 }
 
-bool Label::update(const glm::mat4& _mvp, const ViewState& _viewState, bool _drawAllLabels) {
+void Label::appendAnchorPoints(std::vector<glm::vec2>& _points) const {
+    if (m_options.flat) { return; }
+
+    if (m_type == Type::line) {
+        _points.push_back(m_worldTransform.positions[0]);
+        _points.push_back(m_worldTransform.positions[1]);
+    } else {
+        _points.push_back(glm::vec2(m_worldTransform.position));
+    }
+}
+
+bool Label::update(const glm::mat4& _mvp, const ViewState& _viewState, bool _drawAllLabels,
+                   const glm::vec4* _clipAnchors) {
 
     m_occludedLastFrame = m_occluded;
     m_occluded = false;
@@ -196,7 +214,7 @@ bool Label::update(const glm::mat4& _mvp, const ViewState& _viewState, bool _dra
         }
     }
 
-    bool ruleSatisfied = updateScreenTransform(_mvp, _viewState, _drawAllLabels);
+    bool ruleSatisfied = updateScreenTransform(_mvp, _viewState, _drawAllLabels, _clipAnchors);
 
     // one of the label rules has not been satisfied
     if (!ruleSatisfied) {
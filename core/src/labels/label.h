@@ -15,6 +15,7 @@
 #include <string>
 #include <limits>
 #include <memory>
+#include <vector>
 
 namespace Tangram {
 
@@ -104,12 +105,29 @@ public:
     virtual glm::vec2 center() const;
     virtual void updateBBoxes(float _zoomFract) = 0;
 
-    // Update the screen position of the label
-    virtual bool updateScreenTransform(const glm::mat4& _mvp, const ViewState& _viewState, bool _drawAllLabels) = 0;
+    // Update the screen position of the label. When _clipAnchors is given
+    // it points at the label's pre-projected clip-space anchor points (see
+    // LabelSet::projectAnchorPoints), otherwise the anchors are projected
+    // with _mvp in place.
+    virtual bool updateScreenTransform(const glm::mat4& _mvp, const ViewState& _viewState,
+                                       bool _drawAllLabels, const glm::vec4* _clipAnchors) = 0;
 
     bool update(const glm::mat4& _mvp,
                 const ViewState& _viewState,
-                bool _drawAllLabels = false);
+                bool _drawAllLabels = false,
+                const glm::vec4* _clipAnchors = nullptr);
+
+    // Number of world anchor points the owning LabelSet projects for this
+    // label in its batched transform pass. Flat labels derive their screen
+    // corners from the view state each frame and project them on their own.
+    int anchorPointCount() const {
+        if (m_options.flat) { return 0; }
+        return m_type == Type::line ? 2 : 1;
+    }
+
+    // Appends the label's world anchor points in the order that
+    // updateScreenTransform consumes them
+    void appendAnchorPoints(std::vector<glm::vec2>& _points) const;
 
     bool evalState(float _dt);
 
@@ -178,7 +196,11 @@ public:
 
 private:
 
-    virtual void applyAnchor(LabelProperty::Anchor _anchor) = 0;
+    /* Fill m_anchorOffsets (and any per-variant state of the subclass)
+     * for every anchor fallback variant. Runs at build time and when the
+     * parent changes, so anchor fallback during occlusion handling picks
+     * cached placements instead of recomputing them per attempt. */
+    virtual void updateAnchorTable() = 0;
 
     void setAlpha(float _alpha);
 
@@ -190,6 +212,12 @@ private:
 
 protected:
 
+    // Apply the cached placement of anchor fallback variant _index
+    virtual void applyAnchor(int _index);
+
+    // Placement offset per anchor fallback variant, see updateAnchorTable()
+    std::array<glm::vec2, LabelProperty::max_anchors> m_anchorOffsets = {{}};
+
     bool m_occludedLastFrame;
 
     bool m_occluded;
@@ -1,15 +1,24 @@
 #include "labelCollider.h"
 
+#include "debug/allocStats.h"
 #include "labels/labelSet.h"
 #include "view/view.h" // ViewState
 
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtx/norm.hpp"
 
+#include <future>
+#include <thread>
+
 #define MAX_SCALE 2
 
+// Minimum labels per subtask before spawning parallel transform jobs
+#define MIN_LABELS_PER_TASK 128
+
 namespace Tangram {
 
+bool LabelCollider::s_parallelProcess = false;
+
 
 void LabelCollider::addLabels(std::vector<std::unique_ptr<Label>>& _labels) {
 
@@ -53,6 +62,8 @@ void LabelCollider::handleRepeatGroup(size_t startPos) {
 
 void LabelCollider::process(TileID _tileID, float _tileInverseScale, float _tileSize) {
 
+    ALLOC_TAG(labels);
+
     // Sort labels so that all labels of one repeat group are next to each other
     std::sort(m_labels.begin(), m_labels.end(),
               [](auto* l1, auto* l2) {
@@ -98,10 +109,38 @@ void LabelCollider::process(TileID _tileID, float _tileInverseScale, float _tile
         _tileSize, // screenTileSize
     };
 
-    for (auto* label : m_labels) {
-        label->update(mvp, viewState, true);
+    m_aabbs.resize(m_labels.size());
+
+    size_t jobs = s_parallelProcess
+        ? std::min(m_labels.size() / MIN_LABELS_PER_TASK,
+                   size_t(std::max(1u, std::thread::hardware_concurrency() / 2)))
+        : 1;
+
+    if (jobs > 1) {
+        // The screen transform and bounding box of each label only touch
+        // that label's state, so the update pass splits into contiguous
+        // ranges resolved on parallel subtasks. The broadphase and the
+        // conflict resolution below stay sequential: their outcome
+        // depends on the global priority order of the collision pairs.
+        size_t chunk = m_labels.size() / jobs + 1;
+
+        std::vector<std::future<void>> results;
+        for (size_t job = 0; job < jobs; job++) {
+            results.push_back(std::async(std::launch::async, [&, job]{
+                        size_t end = std::min(m_labels.size(), (job + 1) * chunk);
+                        for (size_t i = job * chunk; i < end; i++) {
+                            m_labels[i]->update(mvp, viewState, true);
+                            m_aabbs[i] = m_labels[i]->aabb();
+                        }
+                    }));
+        }
+        for (auto& result : results) { result.wait(); }
 
-        m_aabbs.push_back(label->aabb());
+    } else {
+        for (size_t i = 0; i < m_labels.size(); i++) {
+            m_labels[i]->update(mvp, viewState, true);
+            m_aabbs[i] = m_labels[i]->aabb();
+        }
     }
 
     m_isect2d.resize({screenSize.x / 128, screenSize.y / 128}, screenSize);
@@ -210,6 +249,21 @@ void LabelCollider::process(TileID _tileID, float _tileInverseScale, float _tile
         }
     }
 
+    // Resolve every repeat group over its pre-sorted span. The pass in
+    // the conflict loop above only reaches groups that show up in a
+    // collision pair; groups without pairs would otherwise carry their
+    // repeats into the render-time solve on every frame.
+    for (size_t i = 0; i < m_labels.size();) {
+        size_t group = m_labels[i]->options().repeatGroup;
+        size_t start = i;
+        while (++i < m_labels.size() &&
+               m_labels[i]->options().repeatGroup == group) {}
+
+        if (group == 0 || i - start < 2) { continue; }
+
+        handleRepeatGroup(start);
+    }
+
     for (auto* label : m_labels) {
 
         // Manage link occlusion (unified icon labels)
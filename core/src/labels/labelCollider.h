@@ -21,8 +21,14 @@ public:
 
     void process(TileID _tileID, float _tileInverseScale, float _tileSize);
 
+    /* Compute the label screen transforms of dense tiles on parallel
+     * subtasks during process(). Off by default. */
+    static void setParallelProcess(bool _enable) { s_parallelProcess = _enable; }
+
 private:
 
+    static bool s_parallelProcess;
+
     void handleRepeatGroup(size_t startPos);
 
     using AABB = isect2d::AABB<glm::vec2>;
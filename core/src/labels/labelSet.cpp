@@ -18,6 +18,20 @@ void LabelSet::setLabels(std::vector<std::unique_ptr<Label>>& _labels) {
                     std::move_iterator<iter_t>(_labels.end()));
 
     _labels.clear();
+
+    m_anchorPoints.clear();
+    size_t points = 0;
+    for (auto& label : m_labels) { points += label->anchorPointCount(); }
+    m_anchorPoints.reserve(points);
+    for (auto& label : m_labels) { label->appendAnchorPoints(m_anchorPoints); }
+}
+
+void LabelSet::projectAnchorPoints(const glm::mat4& _mvp) {
+    m_clipAnchorPoints.resize(m_anchorPoints.size());
+
+    for (size_t i = 0; i < m_anchorPoints.size(); i++) {
+        m_clipAnchorPoints[i] = _mvp * glm::vec4(m_anchorPoints[i], 0.f, 1.f);
+    }
 }
 
 }
@@ -15,16 +15,31 @@ public:
 
     virtual ~LabelSet();
 
-    bool draw(RenderState& rs, ShaderProgram& _shader) override { return true; }
+    bool draw(RenderState& rs, ShaderProgram& _shader, bool _useVao = true) override { return true; }
 
     size_t bufferSize() const override { return 0; }
 
+    size_t labelCount() const override { return m_labels.size(); }
+
     void setLabels(std::vector<std::unique_ptr<Label>>& _labels);
 
     void reset();
 
+    /* Projects the world anchor points of all labels with _mvp in one
+     * batched pass over a contiguous buffer; Label::update consumes the
+     * results through its clip anchor parameter. The buffer is laid out
+     * in label order, each label contributing anchorPointCount() entries. */
+    void projectAnchorPoints(const glm::mat4& _mvp);
+
+    const std::vector<glm::vec4>& clipAnchorPoints() const { return m_clipAnchorPoints; }
+
 protected:
     std::vector<std::unique_ptr<Label>> m_labels;
+
+    // World anchor points of all labels, gathered once; label positions
+    // within the mesh do not change after the tile build.
+    std::vector<glm::vec2> m_anchorPoints;
+    std::vector<glm::vec4> m_clipAnchorPoints;
 };
 
 }
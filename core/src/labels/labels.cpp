@@ -1,6 +1,8 @@
 #include "labels.h"
 
 #include "tangram.h"
+#include "debug/allocStats.h"
+#include "debug/trace.h"
 #include "platform.h"
 #include "gl/shaderProgram.h"
 #include "gl/primitives.h"
@@ -19,13 +21,27 @@
 #include "glm/gtx/rotate_vector.hpp"
 #include "glm/gtx/norm.hpp"
 
+#include <cstring>
+
 namespace Tangram {
 
+bool Labels::s_asyncOcclusion = false;
+
 Labels::Labels()
     : m_needUpdate(false),
       m_lastZoom(0.0f) {}
 
-Labels::~Labels() {}
+Labels::~Labels() {
+    finishOcclusionTask();
+}
+
+void Labels::finishOcclusionTask() {
+    if (m_occlusionTask.valid()) {
+        m_occlusionTask.wait();
+        m_occlusionTask = {};
+        m_occlusionTiles.clear();
+    }
+}
 
 // int Labels::LODDiscardFunc(float _maxZoom, float _zoom) {
 //     return (int) MIN(floor(((log(-_zoom + (_maxZoom + 2)) / log(_maxZoom + 2) * (_maxZoom )) * 0.5)), MAX_LOD);
@@ -38,11 +54,19 @@ void Labels::processLabelUpdate(const ViewState& viewState,
                                 bool onlyTransitions, bool isProxy) {
 
     if (!mesh) { return; }
-    auto labelMesh = dynamic_cast<const LabelSet*>(mesh);
+    auto labelMesh = dynamic_cast<LabelSet*>(mesh);
     if (!labelMesh) { return; }
 
+    // Project all anchor points of the mesh in one pass, the per-label
+    // updates below pick up their slice of the results.
+    labelMesh->projectAnchorPoints(mvp);
+    const glm::vec4* clipAnchors = labelMesh->clipAnchorPoints().data();
+
     for (auto& label : labelMesh->getLabels()) {
-        if (!label->update(mvp, viewState, drawAll)) {
+        const glm::vec4* labelAnchors = label->anchorPointCount() > 0 ? clipAnchors : nullptr;
+        clipAnchors += label->anchorPointCount();
+
+        if (!label->update(mvp, viewState, drawAll, labelAnchors)) {
             // skip dead labels
             continue;
         }
@@ -69,6 +93,10 @@ void Labels::updateLabels(const ViewState& _viewState, float _dt,
                           const std::vector<std::unique_ptr<Marker>>& _markers,
                           bool _onlyTransitions) {
 
+    // A pending occlusion solve must be published before label state is
+    // read or rewritten here.
+    finishOcclusionTask();
+
     // Keep labels for debugDraw
     if (!_onlyTransitions) { m_labels.clear(); }
 
@@ -160,9 +188,10 @@ std::shared_ptr<Tile> findProxy(int32_t _sourceID, const TileID& _proxyID,
 
 void Labels::skipTransitions(const std::vector<std::unique_ptr<Style>>& _styles,
                              const std::vector<std::shared_ptr<Tile>>& _tiles,
-                             TileCache& _cache, float _currentZoom) const {
+                             TileCache& _cache, float _currentZoom) {
 
-    std::vector<const Style*> styles;
+    auto& styles = m_filteredStyles;
+    styles.clear();
 
     for (const auto& style : _styles) {
         if (dynamic_cast<const TextStyle*>(style.get()) ||
@@ -197,37 +226,13 @@ void Labels::skipTransitions(const std::vector<std::unique_ptr<Style>>& _styles,
 }
 
 bool Labels::labelComparator(const LabelEntry& _a, const LabelEntry& _b) {
-    if (_a.proxy != _b.proxy) {
-        return _b.proxy;
-    }
-    if (_a.priority != _b.priority) {
-        return _a.priority < _b.priority;
-    }
-    if (!_a.tile || !_b.tile) {
-        return (bool)_a.tile;
-    }
-    if (_a.tile->getID().z != _b.tile->getID().z) {
-        return _a.tile->getID().z > _b.tile->getID().z;
+    if (_a.sortKey != _b.sortKey) {
+        return _a.sortKey < _b.sortKey;
     }
 
     auto l1 = _a.label;
     auto l2 = _b.label;
 
-    // Note: This causes non-deterministic placement, i.e. depending on
-    // navigation history.
-    if (l1->occludedLastFrame() != l2->occludedLastFrame()) {
-        return l2->occludedLastFrame();
-    }
-    // This prefers labels within screen over out_of_screen.
-    // Important for repeat groups!
-    if (l1->visibleState() != l2->visibleState()) {
-        return l1->visibleState();
-    }
-
-    // if (l1->options().repeatGroup != l2->options().repeatGroup) {
-    //     return l1->options().repeatGroup < l2->options().repeatGroup;
-    // }
-
     if (l1->type() == Label::Type::line && l2->type() == Label::Type::line) {
         // Prefer the label with longer line segment as it has a chance
         return l1->worldLineLength2() > l2->worldLineLength2();
@@ -240,18 +245,109 @@ bool Labels::labelComparator(const LabelEntry& _a, const LabelEntry& _b) {
     return l1 < l2;
 }
 
+// Maps float bits so that unsigned comparison preserves their order
+static uint64_t floatKey(float _f) {
+    uint32_t bits;
+    std::memcpy(&bits, &_f, sizeof(bits));
+    return (bits & 0x80000000u) ? uint32_t(~bits) : (bits | 0x80000000u);
+}
+
 void Labels::sortLabels() {
+
+    // Pack the leading comparison fields into one integer per entry, so
+    // the comparator reads a single word instead of chasing tile and
+    // label state O(n log n) times. In comparison order: non-proxies
+    // first, then ascending priority, entries with tiles before markers,
+    // higher tile zoom first, labels visible last frame first
+    // (Note: this causes non-deterministic placement, i.e. depending on
+    // navigation history), and labels within screen over out_of_screen -
+    // important for repeat groups!
+    for (auto& entry : m_labels) {
+        auto* l = entry.label;
+
+        uint64_t key = entry.proxy ? 1 : 0;
+        key = (key << 32) | floatKey(entry.priority);
+        key = (key << 1) | (entry.tile ? 0 : 1);
+        key = (key << 8) | (entry.tile ? (0xff - (entry.tile->getID().z & 0xff)) : 0);
+        key = (key << 1) | (l->occludedLastFrame() ? 1 : 0);
+        key = (key << 1) | (l->visibleState() ? 0 : 1);
+
+        entry.sortKey = key;
+    }
+
     std::sort(m_labels.begin(), m_labels.end(), Labels::labelComparator);
 }
 
+bool Labels::canReuseLastSolve() const {
+
+    if (m_lastSolve.empty() || m_lastSolve.size() != m_labels.size()) { return false; }
+
+    if (m_candidateLimit != m_lastSolveLimit) { return false; }
+
+    // Maximum drift of a label box relative to the common translation
+    // before the overlaps must be recomputed
+    const float threshold = 0.5f;
+
+    glm::vec2 translation;
+
+    for (size_t i = 0; i < m_labels.size(); i++) {
+        auto* label = m_labels[i].label;
+        if (label != m_lastSolve[i].first) { return false; }
+
+        const auto& prev = m_lastSolve[i].second;
+        auto curr = label->aabb();
+
+        glm::vec2 delta = curr.min - prev.min;
+        if (i == 0) { translation = delta; }
+
+        if (std::abs(delta.x - translation.x) > threshold ||
+            std::abs(delta.y - translation.y) > threshold) {
+            return false;
+        }
+
+        // Changed box dimensions (zoom eases, line label rotation) also
+        // invalidate the solve
+        glm::vec2 growth = (curr.max - curr.min) - (prev.max - prev.min);
+        if (std::abs(growth.x) > threshold || std::abs(growth.y) > threshold) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void Labels::handleOcclusions(const ViewState& _viewState) {
 
+    // During slow pans the screen boxes of all labels translate almost
+    // uniformly, which leaves every pairwise overlap as it was. Carry the
+    // previous visibility decisions over in that case instead of
+    // rebuilding the broadphase grid; any change to the label set (tiles
+    // entering or leaving) or relative label movement forces a full solve.
+    if (canReuseLastSolve()) {
+        for (auto& entry : m_labels) {
+            entry.label->occlude(entry.label->occludedLastFrame());
+        }
+        return;
+    }
+
     m_isect2d.clear();
-    m_repeatGroups.clear();
+
+    // Clear the groups in place: the entries and their vectors keep
+    // their capacity instead of reallocating on every solve
+    for (auto& group : m_repeatGroups) { group.second.clear(); }
+
+    size_t candidate = 0;
 
     for (auto& entry : m_labels){
         auto* l = entry.label;
 
+        // Candidates past the governor's cap lost the priority sort; they
+        // neither claim screen space nor take it from anyone else.
+        if (candidate++ >= m_candidateLimit) {
+            l->occlude();
+            continue;
+        }
+
         // Parent must have been processed earlier so at this point its
         // occlusion and anchor position is determined for the current frame.
         if (l->parent()) {
@@ -323,6 +419,13 @@ void Labels::handleOcclusions(const ViewState& _viewState) {
             m_repeatGroups[l->options().repeatGroup].push_back(l);
         }
     }
+
+    m_lastSolve.clear();
+    m_lastSolve.reserve(m_labels.size());
+    for (auto& entry : m_labels) {
+        m_lastSolve.emplace_back(entry.label, entry.label->aabb());
+    }
+    m_lastSolveLimit = m_candidateLimit;
 }
 
 bool Labels::withinRepeatDistance(Label *_label) {
@@ -346,6 +449,9 @@ void Labels::updateLabelSet(const ViewState& _viewState, float _dt,
                             const std::vector<std::unique_ptr<Marker>>& _markers,
                             TileCache& _cache) {
 
+    TRACE_SCOPE("Labels::updateLabelSet");
+    ALLOC_TAG(labels);
+
     /// Collect and update labels from visible tiles
     updateLabels(_viewState, _dt, _styles, _tiles, _markers, false);
 
@@ -361,6 +467,35 @@ void Labels::updateLabelSet(const ViewState& _viewState, float _dt,
     m_isect2d.resize({_viewState.viewportSize.x / 256, _viewState.viewportSize.y / 256},
                      {_viewState.viewportSize.x, _viewState.viewportSize.y});
 
+    if (s_asyncOcclusion) {
+        // Draw this frame with the decisions of the previous solve, the
+        // same way the transitions-only path carries visibility forward.
+        // The new solve runs beside rendering and is latched into
+        // occludedLastFrame by the next Label::update().
+        for (auto& entry : m_labels) {
+            if (entry.label->occludedLastFrame()) { entry.label->occlude(); }
+        }
+
+        for (auto& entry : m_labels) {
+            Label* label = entry.label;
+
+            m_needUpdate |= label->evalState(_dt);
+            label->addVerticesToMesh();
+        }
+
+        // The task reads labels owned by tile meshes; hold the tiles so
+        // cache eviction cannot drop them mid-solve.
+        m_occlusionTiles = _tiles;
+        m_occlusionTask = std::async(std::launch::async, [this, _viewState]() {
+                handleOcclusions(_viewState);
+            });
+
+        // Render one more frame to apply the new solve once it is latched
+        m_needUpdate = true;
+
+        return;
+    }
+
     handleOcclusions(_viewState);
 
     /// Update label meshes
@@ -380,6 +515,8 @@ const std::vector<TouchItem>& Labels::getFeaturesAtPoint(const ViewState& _viewS
     // FIXME dpi dependent threshold
     const float thumbSize = 50;
 
+    finishOcclusionTask();
+
     m_touchItems.clear();
 
     glm::vec2 touchPoint(_x, _y);
@@ -403,7 +540,7 @@ const std::vector<TouchItem>& Labels::getFeaturesAtPoint(const ViewState& _viewS
                 if (!options.interactive) { continue; }
 
                 if (!_visibleOnly) {
-                    label->updateScreenTransform(mvp, _viewState, false);
+                    label->updateScreenTransform(mvp, _viewState, false, nullptr);
                     label->updateBBoxes(_viewState.fractZoom);
                 } else if (!label->visibleState()) {
                     continue;
@@ -431,6 +568,8 @@ void Labels::drawDebug(RenderState& rs, const View& _view) {
         return;
     }
 
+    finishOcclusionTask();
+
     for (auto& entry : m_labels) {
         auto* label = entry.label;
 
@@ -535,6 +674,8 @@ void Labels::drawDebug(RenderState& rs, const View& _view) {
             }
         }
     }
+
+    Primitives::flush(rs);
 }
 
 }
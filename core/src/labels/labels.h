@@ -6,9 +6,12 @@
 #include "data/properties.h"
 #include "isect2d.h"
 #include "glm_vec.h" // for isect2d.h
+#include "util/fastmap.h"
 
+#include <future>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 #include <map>
 #include <unordered_map>
@@ -53,6 +56,26 @@ public:
 
     bool needUpdate() const { return m_needUpdate; }
 
+    size_t numLabels() const { return m_labels.size(); }
+
+    /* Run the occlusion pass (intersection plus priority resolution) on a
+     * background task instead of the render thread. Each solve is latched
+     * by the next frame's label update, so visibility decisions apply one
+     * frame late. Off by default. */
+    static void setAsyncOcclusion(bool _enable) { s_asyncOcclusion = _enable; }
+
+    /* Block until a pending occlusion task has finished. Must be called
+     * before labels read by the task can be destroyed, i.e. before tiles
+     * or marker meshes are dropped. */
+    void finishOcclusionTask();
+
+    /* Cap the number of labels that compete for screen space. Candidates
+     * past the cap - the lowest-priority ones after sorting - are occluded
+     * outright and fade out like any other losing label. SIZE_MAX (the
+     * default) disables the cap; set by the quality governor to shed
+     * label work under load. */
+    void setCandidateLimit(size_t _limit) { m_candidateLimit = _limit; }
+
 protected:
 
     using AABB = isect2d::AABB<glm::vec2>;
@@ -62,7 +85,7 @@ protected:
 
     void skipTransitions(const std::vector<std::unique_ptr<Style>>& _styles,
                          const std::vector<std::shared_ptr<Tile>>& _tiles,
-                         TileCache& _cache, float _currentZoom) const;
+                         TileCache& _cache, float _currentZoom);
 
     PERF_TRACE void skipTransitions(const std::vector<const Style*>& _styles, Tile& _tile, Tile& _proxy) const;
 
@@ -70,6 +93,11 @@ protected:
 
     PERF_TRACE void handleOcclusions(const ViewState& _viewState);
 
+    // Checks whether the previous occlusion solve still applies, i.e. the
+    // label set is unchanged and all screen boxes moved by a common
+    // translation within a sub-pixel tolerance
+    bool canReuseLastSolve() const;
+
     PERF_TRACE bool withinRepeatDistance(Label *_label);
 
     void processLabelUpdate(const ViewState& viewState, StyledMesh* mesh, Tile* tile,
@@ -94,15 +122,41 @@ protected:
         Tile* tile;
         float priority;
         bool proxy;
+
+        // Packed key resolving all but the final tie-breaks of the sort,
+        // filled in by sortLabels()
+        uint64_t sortKey = 0;
     };
 
     static bool labelComparator(const LabelEntry& _a, const LabelEntry& _b);
 
     std::vector<LabelEntry> m_labels;
 
-    std::unordered_map<size_t, std::vector<Label*>> m_repeatGroups;
+    // Visible labels per repeat group, keyed by the interned group id.
+    // The group ids are small and dense, so lookups binary-search a
+    // pre-sorted span of integers.
+    fastmap<size_t, std::vector<Label*>> m_repeatGroups;
+
+    // Labels and screen boxes of the previous occlusion solve, used to
+    // detect frames whose boxes only translated uniformly
+    std::vector<std::pair<Label*, AABB>> m_lastSolve;
+
+    // See setCandidateLimit; m_lastSolveLimit is the cap the last solve
+    // ran with, so a changed cap forces a fresh solve
+    size_t m_candidateLimit = SIZE_MAX;
+    size_t m_lastSolveLimit = SIZE_MAX;
+
+    // Scratch for the text/point style filter of skipTransitions
+    std::vector<const Style*> m_filteredStyles;
 
     float m_lastZoom;
+
+    static bool s_asyncOcclusion;
+
+    std::future<void> m_occlusionTask;
+
+    // Keeps the tiles whose labels a running occlusion task reads alive
+    std::vector<std::shared_ptr<Tile>> m_occlusionTiles;
 };
 
 }
@@ -21,15 +21,19 @@ SpriteLabel::SpriteLabel(Label::WorldTransform _transform, glm::vec2 _size, Labe
       m_texture(_texture),
       m_extrudeScale(_extrudeScale) {
 
-    applyAnchor(m_options.anchors[0]);
+    updateAnchorTable();
+    applyAnchor(0);
 }
 
-void SpriteLabel::applyAnchor(LabelProperty::Anchor _anchor) {
+void SpriteLabel::updateAnchorTable() {
 
-    m_anchor = LabelProperty::anchorDirection(_anchor) * m_dim * 0.5f;
+    for (int i = 0; i < m_options.anchors.count; i++) {
+        m_anchorOffsets[i] = LabelProperty::anchorDirection(m_options.anchors[i]) * m_dim * 0.5f;
+    }
 }
 
-bool SpriteLabel::updateScreenTransform(const glm::mat4& _mvp, const ViewState& _viewState, bool _drawAllLabels) {
+bool SpriteLabel::updateScreenTransform(const glm::mat4& _mvp, const ViewState& _viewState,
+                                        bool _drawAllLabels, const glm::vec4* _clipAnchors) {
 
     glm::vec2 halfScreen = glm::vec2(_viewState.viewportSize * 0.5f);
 
@@ -80,7 +84,9 @@ bool SpriteLabel::updateScreenTransform(const glm::mat4& _mvp, const ViewState&
                 }
 
             } else {
-                glm::vec4 projected = worldToClipSpace(_mvp, glm::vec4(p0, 0.f, 1.f));
+                glm::vec4 projected = _clipAnchors
+                    ? _clipAnchors[0]
+                    : worldToClipSpace(_mvp, glm::vec4(p0, 0.f, 1.f));
                 if (projected.w <= 0.0f) { return false; }
 
                 m_projected[0] = glm::vec3(projected) / projected.w;
@@ -36,9 +36,10 @@ public:
 
 private:
 
-    void applyAnchor(LabelProperty::Anchor _anchor) override;
+    void updateAnchorTable() override;
 
-    bool updateScreenTransform(const glm::mat4& _mvp, const ViewState& _viewState, bool _drawAllLabels) override;
+    bool updateScreenTransform(const glm::mat4& _mvp, const ViewState& _viewState,
+                               bool _drawAllLabels, const glm::vec4* _clipAnchors) override;
 
     // Back-pointer to owning container and position
     const SpriteLabels& m_labels;
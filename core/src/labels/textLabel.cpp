@@ -14,6 +14,7 @@ using namespace LabelProperty;
 using namespace TextLabelProperty;
 
 const float TextVertex::position_scale = 4.0f;
+const float TextVertex::rotation_scale = 32767.0f;
 const float TextVertex::alpha_scale = 65535.0f;
 
 TextLabel::TextLabel(Label::WorldTransform _transform, Type _type, Label::Options _options,
@@ -26,40 +27,56 @@ TextLabel::TextLabel(Label::WorldTransform _transform, Type _type, Label::Option
       m_fontAttrib(_attrib),
       m_preferedAlignment(_preferedAlignment) {
 
-    applyAnchor(m_options.anchors[0]);
+    updateAnchorTable();
+    applyAnchor(0);
 }
 
-void TextLabel::applyAnchor(Anchor _anchor) {
+void TextLabel::updateAnchorTable() {
 
-    if (m_preferedAlignment == Align::none) {
-        Align newAlignment = alignFromAnchor(_anchor);
-        m_textRangeIndex = int(newAlignment);
-    } else {
-        m_textRangeIndex = int(m_preferedAlignment);
-    }
+    glm::vec2 offset = m_dim;
+    if (m_parent) { offset += m_parent->dimension(); }
+
+    for (int i = 0; i < m_options.anchors.count; i++) {
+        Anchor anchor = m_options.anchors[i];
+
+        int rangeIndex;
+        if (m_preferedAlignment == Align::none) {
+            rangeIndex = int(alignFromAnchor(anchor));
+        } else {
+            rangeIndex = int(m_preferedAlignment);
+        }
 
-    if (m_textRanges[m_textRangeIndex].length == 0) {
-        m_textRangeIndex = 0;
+        if (m_textRanges[rangeIndex].length == 0) {
+            rangeIndex = 0;
+        }
+
+        m_anchorTextRanges[i] = uint8_t(rangeIndex);
+        m_anchorOffsets[i] = LabelProperty::anchorDirection(anchor) * offset * 0.5f;
     }
+}
 
-    glm::vec2 offset = m_dim;
-    if (m_parent) { offset += m_parent->dimension(); }
+void TextLabel::applyAnchor(int _index) {
+    Label::applyAnchor(_index);
 
-    m_anchor = LabelProperty::anchorDirection(_anchor) * offset * 0.5f;
+    m_textRangeIndex = m_anchorTextRanges[_index];
 }
 
-bool TextLabel::updateScreenTransform(const glm::mat4& _mvp, const ViewState& _viewState, bool _drawAllLabels) {
-    bool clipped = false;
+bool TextLabel::updateScreenTransform(const glm::mat4& _mvp, const ViewState& _viewState,
+                                      bool _drawAllLabels, const glm::vec4* _clipAnchors) {
 
     switch (m_type) {
         case Type::debug:
         case Type::point:
         {
-            glm::vec2 p0 = glm::vec2(m_worldTransform.position);
+            glm::vec4 c0 = _clipAnchors
+                ? _clipAnchors[0]
+                : worldToClipSpace(_mvp, glm::vec4(glm::vec2(m_worldTransform.position), 0.0, 1.0));
+
+            // check whether the label is behind the camera using the
+            // perspective division factor
+            if (c0.w <= 0.0f) { return false; }
 
-            glm::vec2 position = worldToScreenSpace(_mvp, glm::vec4(p0, 0.0, 1.0),
-                                                    _viewState.viewportSize, clipped);
-            if (clipped) { return false; }
+            glm::vec2 position = clipToScreenSpace(c0, _viewState.viewportSize);
 
             m_screenTransform.position = position + m_options.offset;
 
@@ -68,21 +85,24 @@ bool TextLabel::updateScreenTransform(const glm::mat4& _mvp, const ViewState& _v
         case Type::line:
         {
             // project label position from mercator world space to screen coordinates
-            glm::vec2 p0 = m_worldTransform.positions[0];
-            glm::vec2 p2 = m_worldTransform.positions[1];
-            glm::vec2 position;
-
-            glm::vec2 ap0 = worldToScreenSpace(_mvp, glm::vec4(p0, 0.0, 1.0),
-                                               _viewState.viewportSize, clipped);
-            glm::vec2 ap2 = worldToScreenSpace(_mvp, glm::vec4(p2, 0.0, 1.0),
-                                               _viewState.viewportSize, clipped);
+            glm::vec4 c0, c2;
+            if (_clipAnchors) {
+                c0 = _clipAnchors[0];
+                c2 = _clipAnchors[1];
+            } else {
+                c0 = worldToClipSpace(_mvp, glm::vec4(m_worldTransform.positions[0], 0.0, 1.0));
+                c2 = worldToClipSpace(_mvp, glm::vec4(m_worldTransform.positions[1], 0.0, 1.0));
+            }
 
             // check whether the label is behind the camera using the
             // perspective division factor
-            if (clipped) {
+            if (c0.w <= 0.0f || c2.w <= 0.0f) {
                 return false;
             }
 
+            glm::vec2 ap0 = clipToScreenSpace(c0, _viewState.viewportSize);
+            glm::vec2 ap2 = clipToScreenSpace(c2, _viewState.viewportSize);
+
             float length = glm::length(ap2 - ap0);
 
             // default heuristic : allow label to be 30% wider than segment
@@ -92,13 +112,12 @@ bool TextLabel::updateScreenTransform(const glm::mat4& _mvp, const ViewState& _v
                 return false;
             }
 
-            glm::vec2 p1 = glm::vec2(p2 + p0) * 0.5f;
-
-            glm::vec2 ap1 = worldToScreenSpace(_mvp, glm::vec4(p1, 0.0, 1.0),
-                                               _viewState.viewportSize, clipped);
+            // The projection is linear, so the segment midpoint maps to the
+            // average of the endpoint clip coordinates
+            glm::vec2 ap1 = clipToScreenSpace((c0 + c2) * 0.5f, _viewState.viewportSize);
 
             // Keep screen position center at world center (less sliding in tilted view)
-            position = ap1;
+            glm::vec2 position = ap1;
 
             glm::vec2 rotation = (ap0.x <= ap2.x ? ap2 - ap0 : ap0 - ap2) / length;
             rotation = glm::vec2{rotation.x, -rotation.y};
@@ -133,9 +152,6 @@ void TextLabel::updateBBoxes(float _zoomFract) {
 void TextLabel::addVerticesToMesh() {
     if (!visibleState()) { return; }
 
-    glm::vec2 rotation = m_screenTransform.rotation;
-    bool rotate = (rotation.x != 1.f);
-
     TextVertex::State state {
         m_fontAttrib.fill,
         m_fontAttrib.stroke,
@@ -151,10 +167,16 @@ void TextLabel::addVerticesToMesh() {
     screenPosition += m_anchor;
 
     glm::i16vec2 sp = glm::i16vec2(screenPosition * TextVertex::position_scale);
+
+    // The glyphs stay in label-local space; the vertex shader rotates
+    // them around the label origin (see point.vs), so pushing a label's
+    // quads is plain copying.
+    glm::i16vec2 rot = glm::i16vec2(m_screenTransform.rotation * TextVertex::rotation_scale);
+
     auto& meshes = style.getMeshes();
 
     for (; it != end; ++it) {
-        auto quad = *it;
+        const auto& quad = *it;
 
         if (it->atlas >= meshes.size()) {
             LOGE("Accesing inconsistent quad mesh (id:%u, size:%u)",
@@ -164,12 +186,10 @@ void TextLabel::addVerticesToMesh() {
         auto* quadVertices = meshes[it->atlas]->pushQuad();
         for (int i = 0; i < 4; i++) {
             TextVertex& v = quadVertices[i];
-            if (rotate) {
-                v.pos = sp + glm::i16vec2{rotateBy(quad.quad[i].pos, rotation)};
-            } else {
-                v.pos = sp + quad.quad[i].pos;
-            }
+            v.pos = quad.quad[i].pos;
             v.uv = quad.quad[i].uv;
+            v.origin = sp;
+            v.rotation = rot;
             v.state = state;
         }
     }
@@ -20,8 +20,15 @@ struct GlyphQuad {
 using TextRange = std::array<Range, 3>;
 
 struct TextVertex {
+    // Glyph position in label-local space; the vertex shader rotates it
+    // by 'rotation' around 'origin', so the CPU writes glyph quads
+    // untransformed every frame.
     glm::i16vec2 pos;
     glm::u16vec2 uv;
+    // Label screen origin, in position_scale subpixels like pos
+    glm::i16vec2 origin;
+    // Label rotation unit vector, normalized shorts
+    glm::i16vec2 rotation;
     struct State {
         uint32_t color;
         uint32_t stroke;
@@ -30,6 +37,7 @@ struct TextVertex {
     } state;
 
     const static float position_scale;
+    const static float rotation_scale;
     const static float alpha_scale;
 };
 
@@ -60,9 +68,12 @@ protected:
 
 private:
 
-    void applyAnchor(LabelProperty::Anchor _anchor) override;
+    void updateAnchorTable() override;
 
-    bool updateScreenTransform(const glm::mat4& _mvp, const ViewState& _viewState, bool _drawAllLabels) override;
+    void applyAnchor(int _index) override;
+
+    bool updateScreenTransform(const glm::mat4& _mvp, const ViewState& _viewState,
+                               bool _drawAllLabels, const glm::vec4* _clipAnchors) override;
 
     // Back-pointer to owning container
     const TextLabels& m_textLabels;
@@ -73,6 +84,9 @@ private:
     // TextRange currently used for drawing
     int m_textRangeIndex;
 
+    // TextRange per anchor fallback variant, see updateAnchorTable()
+    std::array<uint8_t, LabelProperty::max_anchors> m_anchorTextRanges = {{}};
+
     FontVertexAttributes m_fontAttrib;
 
     // The text LAbel prefered alignment
@@ -0,0 +1,173 @@
+#include "log.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace Tangram {
+namespace Log {
+
+namespace {
+
+// Power of two; the ring indexes with a mask
+constexpr size_t buffer_slots = 1024;
+constexpr size_t slot_text = 232;
+
+/* Bounded multi-producer ring with one drainer thread. Producers claim a
+ * slot with a compare-and-swap on the enqueue position and publish it by
+ * bumping the slot sequence, so a logging call never takes a lock and
+ * never blocks on the platform sink; when the ring is full the message
+ * is dropped and counted instead. */
+struct Backend {
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        char text[slot_text];
+    };
+
+    Slot m_slots[buffer_slots];
+    std::atomic<size_t> m_enqueuePos{0};
+    std::atomic<size_t> m_dequeuePos{0};
+    std::atomic<size_t> m_dropped{0};
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_running = true;
+
+    std::thread m_thread;
+
+    Backend() {
+        for (size_t i = 0; i < buffer_slots; i++) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_thread = std::thread(&Backend::run, this);
+    }
+
+    ~Backend() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_condition.notify_one();
+        m_thread.join();
+    }
+
+    bool push(const char* _text) {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        while (true) {
+            slot = &m_slots[pos & (buffer_slots - 1)];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(seq) - intptr_t(pos);
+
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // A full ring means the drainer is behind; losing the
+                // message beats stalling the caller
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        strncpy(slot->text, _text, slot_text - 1);
+        slot->text[slot_text - 1] = '\0';
+
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(char* _text) {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Slot* slot = &m_slots[pos & (buffer_slots - 1)];
+        size_t seq = slot->sequence.load(std::memory_order_acquire);
+
+        if (intptr_t(seq) - intptr_t(pos + 1) < 0) { return false; }
+
+        std::memcpy(_text, slot->text, slot_text);
+
+        slot->sequence.store(pos + buffer_slots, std::memory_order_release);
+        m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool pending() {
+        return m_dequeuePos.load(std::memory_order_relaxed) !=
+            m_enqueuePos.load(std::memory_order_relaxed);
+    }
+
+    void drain(char* _text) {
+        while (pop(_text)) { logMsg("%s", _text); }
+
+        size_t dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            logMsg("TANGRAM log.cpp: dropped %d messages on a full log buffer\n",
+                   int(dropped));
+        }
+    }
+
+    void run() {
+        char text[slot_text];
+
+        while (true) {
+            drain(text);
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_running) { break; }
+            m_condition.wait_for(lock, std::chrono::milliseconds(100));
+        }
+
+        // Flush what arrived after the shutdown notify
+        drain(text);
+    }
+};
+
+Backend& backend() {
+    static Backend s_backend;
+    return s_backend;
+}
+
+}
+
+void write(const char* _fmt, ...) {
+
+    auto& log = backend();
+
+    char text[slot_text];
+
+    va_list args;
+    va_start(args, _fmt);
+    vsnprintf(text, sizeof(text), _fmt, args);
+    va_end(args);
+
+    if (!log.push(text)) {
+        log.m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Unlocked notify: a missed wakeup is covered by the timed wait
+    log.m_condition.notify_one();
+}
+
+void flush() {
+
+    auto& log = backend();
+
+    log.m_condition.notify_one();
+
+    while (log.pending()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+}
+}
@@ -10,28 +10,48 @@
  * LOGN: Notification log (displayed once), LOG_LEVEL >= 0
  * LOG: Default log, LOG_LEVEL >= 0
  * LOGS: Screen log, no LOG_LEVEL
+ *
+ * Messages below the compile-time LOG_LEVEL are stripped entirely; the
+ * rest are formatted on the calling thread, queued on a lock-free ring
+ * and written to the platform sink (logMsg) by a drainer thread, so a
+ * warning storm on a tile worker or the render thread costs a snprintf
+ * instead of a write to logcat or stderr.
  */
 
+namespace Tangram {
+namespace Log {
+
+/* Queue a printf-formatted message for the drainer thread. Never blocks;
+ * messages are truncated to the ring slot size and dropped (and counted)
+ * when the ring is full. */
+void write(const char* _fmt, ...);
+
+/* Block until every queued message reached the platform sink. */
+void flush();
+
+}
+}
+
 #define __FILENAME__ (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__)
 #define TANGRAM_MAX_BUFFER_LOG_SIZE 99999
 
 #if LOG_LEVEL >= 3
 #define LOGD(fmt, ...) \
-do { logMsg("DEBUG %s:%d: " fmt "\n", __FILENAME__, __LINE__, ## __VA_ARGS__); } while(0)
+do { ::Tangram::Log::write("DEBUG %s:%d: " fmt "\n", __FILENAME__, __LINE__, ## __VA_ARGS__); } while(0)
 #else
 #define LOGD(fmt, ...)
 #endif
 
 #if LOG_LEVEL >= 2
 #define LOGW(fmt, ...) \
-do { logMsg("WARNING %s:%d: " fmt "\n", __FILENAME__, __LINE__, ## __VA_ARGS__); } while(0)
+do { ::Tangram::Log::write("WARNING %s:%d: " fmt "\n", __FILENAME__, __LINE__, ## __VA_ARGS__); } while(0)
 #else
 #define LOGW(fmt, ...)
 #endif
 
 #if LOG_LEVEL >= 1
 #define LOGE(fmt, ...) \
-do { logMsg("ERROR %s:%d: " fmt "\n", __FILENAME__, __LINE__, ## __VA_ARGS__); } while(0)
+do { ::Tangram::Log::write("ERROR %s:%d: " fmt "\n", __FILENAME__, __LINE__, ## __VA_ARGS__); } while(0)
 #else
 #define LOGE(fmt, ...)
 #endif
@@ -45,11 +65,11 @@ do { logMsg("ERROR %s:%d: " fmt "\n", __FILENAME__, __LINE__, ## __VA_ARGS__); }
     std::string log(buffer);                                                        \
     if (std::find(logs.begin(), logs.end(), log) == logs.end()) {                   \
         logs.push_back(log);                                                        \
-        logMsg("NOTIFY %s:%d: " fmt "\n", __FILENAME__, __LINE__, ## __VA_ARGS__);  \
+        ::Tangram::Log::write("NOTIFY %s:%d: " fmt "\n", __FILENAME__, __LINE__, ## __VA_ARGS__);  \
     }                                                                               \
 } while (0)
 #define LOG(fmt, ...) \
-do { logMsg("TANGRAM %s:%d: " fmt "\n", __FILENAME__, __LINE__, ## __VA_ARGS__); } while(0)
+do { ::Tangram::Log::write("TANGRAM %s:%d: " fmt "\n", __FILENAME__, __LINE__, ## __VA_ARGS__); } while(0)
 #else
 #define LOGN(fmt, ...)
 #define LOG(fmt, ...)
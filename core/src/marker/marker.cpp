@@ -48,6 +48,27 @@ void Marker::setMesh(uint32_t styleId, uint32_t zoom, std::unique_ptr<StyledMesh
     m_modelMatrix = glm::scale(glm::vec3(scale));
 }
 
+void Marker::setPendingMesh(uint32_t styleId, uint32_t zoom, std::unique_ptr<StyledMesh> mesh) {
+    std::lock_guard<std::mutex> lock(m_pendingMeshMutex);
+    m_pendingMesh = std::move(mesh);
+    m_pendingStyleId = styleId;
+    m_pendingZoomLevel = zoom;
+}
+
+bool Marker::swapPendingMesh() {
+    std::unique_ptr<StyledMesh> mesh;
+    uint32_t styleId, zoom;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMeshMutex);
+        if (!m_pendingMesh) { return false; }
+        mesh = std::move(m_pendingMesh);
+        styleId = m_pendingStyleId;
+        zoom = m_pendingZoomLevel;
+    }
+    setMesh(styleId, zoom, std::move(mesh));
+    return true;
+}
+
 void Marker::setTexture(std::unique_ptr<Texture> texture) {
     m_texture = std::move(texture);
 }
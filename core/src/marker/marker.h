@@ -5,7 +5,9 @@
 #include "util/ease.h"
 #include "util/geom.h"
 #include "util/types.h"
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace Tangram {
@@ -46,6 +48,14 @@ public:
     // Set the styled mesh for this marker with the associated style id and zoom level.
     void setMesh(uint32_t styleId, uint32_t zoom, std::unique_ptr<StyledMesh> mesh);
 
+    // Stage a mesh built on a worker thread. It replaces the active mesh in
+    // the next call to swapPendingMesh on the render thread.
+    void setPendingMesh(uint32_t styleId, uint32_t zoom, std::unique_ptr<StyledMesh> mesh);
+
+    // Move a staged mesh into place, if one is present; returns true if the
+    // active mesh changed.
+    bool swapPendingMesh();
+
     void setTexture(std::unique_ptr<Texture> texture);
 
     // Set an ease for the origin of this marker in Mercator meters.
@@ -104,11 +114,18 @@ protected:
 
     std::string m_stylingString;
 
+    // Mesh built asynchronously, waiting to be swapped in on the render thread.
+    std::unique_ptr<StyledMesh> m_pendingMesh;
+    uint32_t m_pendingStyleId = 0;
+    uint32_t m_pendingZoomLevel = 0;
+    std::mutex m_pendingMeshMutex;
+
     MarkerID m_id = 0;
 
     uint32_t m_styleId = 0;
 
-    int m_builtZoomLevel = 0;
+    // Read from the build worker to decide which markers need a rebuild.
+    std::atomic<int> m_builtZoomLevel { 0 };
 
     // Origin of marker geometry relative to global projection space.
     glm::dvec2 m_origin;
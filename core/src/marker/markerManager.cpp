@@ -2,7 +2,9 @@
 #include "gl/texture.h"
 #include "marker/markerManager.h"
 #include "marker/marker.h"
+#include "platform.h"
 #include "scene/sceneLoader.h"
+#include "util/frameScheduler.h"
 #include "style/style.h"
 #include "log.h"
 
@@ -10,6 +12,8 @@ namespace Tangram {
 
 void MarkerManager::setScene(std::shared_ptr<Scene> scene) {
 
+    std::lock_guard<std::mutex> lock(m_buildMutex);
+
     m_scene = scene;
     m_mapProjection = scene->mapProjection().get();
     m_styleContext.initFunctions(*scene);
@@ -27,13 +31,18 @@ void MarkerManager::setScene(std::shared_ptr<Scene> scene) {
         buildGeometry(*entry, m_zoom);
     }
 
+    m_contentChanged = true;
+
 }
 
 MarkerID MarkerManager::add() {
 
     // Add a new empty marker object to the list of markers.
     auto id = ++m_idCounter;
+
+    std::lock_guard<std::mutex> lock(m_buildMutex);
     m_markers.push_back(std::make_unique<Marker>(id));
+    m_contentChanged = true;
 
     // Return a handle for the marker.
     return id;
@@ -41,9 +50,11 @@ MarkerID MarkerManager::add() {
 }
 
 bool MarkerManager::remove(MarkerID markerID) {
+    std::lock_guard<std::mutex> lock(m_buildMutex);
     for (auto it = m_markers.begin(), end = m_markers.end(); it != end; ++it) {
         if (it->get()->id() == markerID) {
             m_markers.erase(it);
+            m_contentChanged = true;
             return true;
         }
     }
@@ -54,6 +65,8 @@ bool MarkerManager::setStyling(MarkerID markerID, const char* styling) {
     Marker* marker = getMarkerOrNull(markerID);
     if (!marker) { return false; }
 
+    std::lock_guard<std::mutex> lock(m_buildMutex);
+
     marker->setStylingString(std::string(styling));
 
     // Create a draw rule from the styling string.
@@ -61,19 +74,52 @@ bool MarkerManager::setStyling(MarkerID markerID, const char* styling) {
 
     // Build the feature mesh for the marker's current geometry.
     buildGeometry(*marker, m_zoom);
+    m_contentChanged = true;
     return true;
 }
 
+bool MarkerManager::setStylingGroup(const MarkerID* markerIDs, int count, const char* styling) {
+
+    if (!m_scene) { return false; }
+    if (!markerIDs || !styling || count < 1) { return false; }
+
+    std::lock_guard<std::mutex> lock(m_buildMutex);
+
+    // Parse the styling string and compile its JS functions once; every
+    // marker in the group shares the resulting draw rule parameters.
+    auto params = parseStyling(styling);
+
+    bool allFound = true;
+
+    for (int i = 0; i < count; ++i) {
+        Marker* marker = getMarkerOrNull(markerIDs[i]);
+        if (!marker) {
+            allFound = false;
+            continue;
+        }
+
+        marker->setStylingString(styling);
+        marker->setDrawRule(std::make_unique<DrawRuleData>("", 0, std::vector<StyleParam>(params)));
+
+        // Build the feature mesh for the marker's current geometry.
+        buildGeometry(*marker, m_zoom);
+    }
+
+    m_contentChanged = true;
+
+    return allFound;
+}
+
 bool MarkerManager::setBitmap(MarkerID markerID, int width, int height, const unsigned int* bitmapData) {
     Marker* marker = getMarkerOrNull(markerID);
     if (!marker) { return false; }
 
-    TextureOptions options = { GL_RGBA, GL_RGBA, { GL_LINEAR, GL_LINEAR }, { GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE } };
-    auto texture = std::make_unique<Texture>(width, height, options);
+    auto texture = std::make_unique<Texture>(width, height, TextureOptions::linearRgba());
     unsigned int size = width * height * 4;
     texture->setData(bitmapData, size);
 
     marker->setTexture(std::move(texture));
+    m_contentChanged = true;
     return true;
 }
 
@@ -82,6 +128,7 @@ bool MarkerManager::setVisible(MarkerID markerID, bool visible) {
     if (!marker) { return false; }
 
     marker->setVisible(visible);
+    m_contentChanged = true;
     return true;
 
 }
@@ -93,6 +140,8 @@ bool MarkerManager::setPoint(MarkerID markerID, LngLat lngLat) {
     Marker* marker = getMarkerOrNull(markerID);
     if (!marker) { return false; }
 
+    std::lock_guard<std::mutex> lock(m_buildMutex);
+
     // If the marker does not have a 'point' feature mesh built, build it.
     if (!marker->mesh() || !marker->feature() || marker->feature()->geometryType != GeometryType::points) {
         auto feature = std::make_unique<Feature>();
@@ -106,9 +155,48 @@ bool MarkerManager::setPoint(MarkerID markerID, LngLat lngLat) {
     auto origin = m_mapProjection->LonLatToMeters({ lngLat.longitude, lngLat.latitude });
     marker->setBounds({ origin, origin });
 
+    m_contentChanged = true;
+
     return true;
 }
 
+bool MarkerManager::setPoints(const MarkerID* markerIDs, const LngLat* coordinates, int count) {
+
+    if (!m_scene) { return false; }
+    if (!markerIDs || !coordinates || count < 1) { return false; }
+
+    // Apply the whole batch under a single lock, so a fleet of markers
+    // moves in one pass instead of one lock/build cycle per marker.
+    std::lock_guard<std::mutex> lock(m_buildMutex);
+
+    bool allFound = true;
+
+    for (int i = 0; i < count; ++i) {
+        Marker* marker = getMarkerOrNull(markerIDs[i]);
+        if (!marker) {
+            allFound = false;
+            continue;
+        }
+
+        // If the marker does not have a 'point' feature mesh built, build it.
+        if (!marker->mesh() || !marker->feature() || marker->feature()->geometryType != GeometryType::points) {
+            auto feature = std::make_unique<Feature>();
+            feature->geometryType = GeometryType::points;
+            feature->points.emplace_back();
+            marker->setFeature(std::move(feature));
+            buildGeometry(*marker, m_zoom);
+        }
+
+        // Update the marker's bounds to the given coordinates.
+        auto origin = m_mapProjection->LonLatToMeters({ coordinates[i].longitude, coordinates[i].latitude });
+        marker->setBounds({ origin, origin });
+    }
+
+    m_contentChanged = true;
+
+    return allFound;
+}
+
 bool MarkerManager::setPointEased(MarkerID markerID, LngLat lngLat, float duration, EaseType ease) {
 
     if (!m_scene) { return false; }
@@ -124,6 +212,8 @@ bool MarkerManager::setPointEased(MarkerID markerID, LngLat lngLat, float durati
     auto dest = m_mapProjection->LonLatToMeters({ lngLat.longitude, lngLat.latitude });
     marker->setEase(dest, duration, ease);
 
+    m_contentChanged = true;
+
     return true;
 }
 
@@ -135,6 +225,8 @@ bool MarkerManager::setPolyline(MarkerID markerID, LngLat* coordinates, int coun
     if (!marker) { return false; }
     if (!coordinates || count < 2) { return false; }
 
+    std::lock_guard<std::mutex> lock(m_buildMutex);
+
     // Build a feature for the new set of polyline points.
     auto feature = std::make_unique<Feature>();
     feature->geometryType = GeometryType::lines;
@@ -170,6 +262,8 @@ bool MarkerManager::setPolyline(MarkerID markerID, LngLat* coordinates, int coun
     // Build a new mesh for the marker.
     buildGeometry(*marker, m_zoom);
 
+    m_contentChanged = true;
+
     return true;
 }
 
@@ -181,6 +275,8 @@ bool MarkerManager::setPolygon(MarkerID markerID, LngLat* coordinates, int* coun
     if (!marker) { return false; }
     if (!coordinates || !counts || rings < 1) { return false; }
 
+    std::lock_guard<std::mutex> lock(m_buildMutex);
+
     // Build a feature for the new set of polygon points.
     auto feature = std::make_unique<Feature>();
     feature->geometryType = GeometryType::polygons;
@@ -230,28 +326,52 @@ bool MarkerManager::setPolygon(MarkerID markerID, LngLat* coordinates, int* coun
     // Build a new mesh for the marker.
     buildGeometry(*marker, m_zoom);
 
+    m_contentChanged = true;
+
     return true;
 }
 
 bool MarkerManager::update(int zoom) {
 
-    if (zoom == m_zoom) {
-         return false;
-    }
-    bool rebuilt = false;
+    // Swap in any meshes that finished building on the worker since the
+    // last frame; this is the only point where staged meshes become active,
+    // so drawing never observes a partially built mesh.
+    bool rebuilt = m_contentChanged.exchange(false);
     for (auto& marker : m_markers) {
-        if (zoom != marker->builtZoomLevel()) {
-            buildGeometry(*marker, zoom);
-            rebuilt = true;
-        }
+        rebuilt |= marker->swapPendingMesh();
+    }
+
+    if (zoom != m_zoom) {
+        m_zoom = zoom;
+
+        // Rebuild outdated marker meshes on the worker; tessellating many
+        // polyline markers is too slow to run inside Map::update.
+        m_buildWorker.enqueue([this, zoom]() {
+
+            std::lock_guard<std::mutex> lock(m_buildMutex);
+
+            // Superseded by a later zoom crossing.
+            if (zoom != m_zoom) { return; }
+
+            bool built = false;
+            for (auto& marker : m_markers) {
+                if (zoom != marker->builtZoomLevel()) {
+                    buildGeometry(*marker, zoom, true);
+                    built = true;
+                }
+            }
+            // Have the next frame pick up the staged meshes.
+            if (built) { FrameScheduler::requestFrame(); }
+        });
     }
-    m_zoom = zoom;
     return rebuilt;
 }
 
 void MarkerManager::removeAll() {
 
+    std::lock_guard<std::mutex> lock(m_buildMutex);
     m_markers.clear();
+    m_contentChanged = true;
 
 }
 
@@ -264,7 +384,15 @@ void MarkerManager::buildStyling(Marker& marker) {
     if (!m_scene) { return; }
 
     // Update the draw rule for the marker.
-    YAML::Node node = YAML::Load(marker.stylingString());
+    auto params = parseStyling(marker.stylingString());
+
+    marker.setDrawRule(std::make_unique<DrawRuleData>("", 0, std::move(params)));
+
+}
+
+std::vector<StyleParam> MarkerManager::parseStyling(const std::string& styling) {
+
+    YAML::Node node = YAML::Load(styling);
     std::vector<StyleParam> params;
     SceneLoader::parseStyleParams(node, m_scene, "", params);
 
@@ -275,11 +403,11 @@ void MarkerManager::buildStyling(Marker& marker) {
     }
     m_jsFnIndex = sceneJsFnList.size();
 
-    marker.setDrawRule(std::make_unique<DrawRuleData>("", 0, std::move(params)));
+    return params;
 
 }
 
-void MarkerManager::buildGeometry(Marker& marker, int zoom) {
+void MarkerManager::buildGeometry(Marker& marker, int zoom, bool stageMesh) {
 
     auto feature = marker.feature();
     auto rule = marker.drawRule();
@@ -304,7 +432,11 @@ void MarkerManager::buildGeometry(Marker& marker, int zoom) {
     if (valid) {
         styler->setup(marker, zoom);
         styler->addFeature(*feature, *rule);
-        marker.setMesh(styler->style().getID(), zoom, styler->build());
+        if (stageMesh) {
+            marker.setPendingMesh(styler->style().getID(), zoom, styler->build());
+        } else {
+            marker.setMesh(styler->style().getID(), zoom, styler->build());
+        }
     }
 
 }
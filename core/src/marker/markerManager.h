@@ -2,10 +2,13 @@
 
 #include "scene/styleContext.h"
 #include "scene/drawRule.h"
+#include "util/taskExecutor.h"
 #include "util/ease.h"
 #include "util/fastmap.h"
 #include "util/types.h"
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace Tangram {
@@ -31,6 +34,10 @@ public:
     // Set the styling string for a marker; returns true if the marker was found and updated.
     bool setStyling(MarkerID markerID, const char* styling);
 
+    // Apply one styling string to a group of markers; the string is parsed and its JS functions are
+    // compiled once for the whole group; returns true if every marker was found and updated.
+    bool setStylingGroup(const MarkerID* markerIDs, int count, const char* styling);
+
     bool setBitmap(MarkerID markerID, int width, int height, const unsigned int* bitmapData);
 
     // Set whether a marker should be visible; returns true if the marker was found and updated.
@@ -39,6 +46,10 @@ public:
     // Set a marker to a point feature at the given position; returns true if the marker was found and updated.
     bool setPoint(MarkerID markerID, LngLat lngLat);
 
+    // Set each marker in the list to a point feature at the corresponding position, all in one pass;
+    // returns true if every marker was found and updated.
+    bool setPoints(const MarkerID* markerIDs, const LngLat* coordinates, int count);
+
     // Set a marker to a point feature at the given position; if the marker was previously set to a point, this
     // eases from the old position to the new one over the given duration with the given ease type; returns true if
     // the marker was found and updated.
@@ -51,7 +62,9 @@ public:
     bool setPolygon(MarkerID markerID, LngLat* coordinates, int* counts, int rings);
 
     // Update the zoom level for all markers; markers are built for one zoom level at a time so when the current zoom
-    // changes, all marker meshes are rebuilt.
+    // changes, all marker meshes are rebuilt. The rebuild runs on a worker thread and finished meshes are swapped in
+    // on a later call; returns true if any marker content changed since the last call, either through a swapped-in
+    // mesh or through the marker API.
     bool update(int zoom);
 
     // Remove and destroy all markers.
@@ -64,7 +77,15 @@ private:
     Marker* getMarkerOrNull(MarkerID markerID);
 
     void buildStyling(Marker& marker);
-    void buildGeometry(Marker& marker, int zoom);
+
+    // Parse a styling string into draw rule parameters and compile any new
+    // JS functions it references.
+    std::vector<StyleParam> parseStyling(const std::string& styling);
+
+    // Build the feature mesh for a marker. With stageMesh the result is
+    // staged on the marker for a later swap instead of set directly; this
+    // is the path taken on the build worker.
+    void buildGeometry(Marker& marker, int zoom, bool stageMesh = false);
 
     DrawRuleMergeSet m_ruleSet;
     StyleContext m_styleContext;
@@ -75,7 +96,15 @@ private:
     MapProjection* m_mapProjection = nullptr;
     size_t m_jsFnIndex = 0;
     uint32_t m_idCounter = 0;
-    int m_zoom = 0;
+    std::atomic<int> m_zoom { 0 };
+
+    // Set by marker mutations on any thread, consumed by update().
+    std::atomic<bool> m_contentChanged { true };
+
+    // Serializes the style context, style builders and the marker list
+    // between API calls and the build worker. update() never takes it.
+    std::mutex m_buildMutex;
+    TaskExecutor::Lane m_buildWorker;
 
 };
 
@@ -0,0 +1,119 @@
+#include "marker/markerPicker.h"
+
+#include "data/tileData.h"
+#include "gl/framebuffer.h"
+#include "gl/renderState.h"
+#include "gl/shaderProgram.h"
+#include "marker/marker.h"
+#include "view/view.h"
+
+#include "shaders/pickId_vs.h"
+#include "shaders/pickId_fs.h"
+
+#include "glm/vec4.hpp"
+
+#include <cmath>
+
+namespace Tangram {
+
+MarkerPicker::MarkerPicker() {}
+
+MarkerPicker::~MarkerPicker() {}
+
+void MarkerPicker::pick(float _x, float _y, Callback _callback) {
+
+    m_queries.push_back({ _x, _y, _callback });
+}
+
+void MarkerPicker::resolveQueries(RenderState& rs, const View& _view,
+                                  const std::vector<std::unique_ptr<Marker>>& _markers) {
+
+    if (m_queries.empty()) { return; }
+
+    if (!m_shaderProgram) {
+        m_shaderProgram = std::make_unique<ShaderProgram>();
+        m_shaderProgram->setSourceStrings(SHADER_SOURCE(pickId_fs),
+                                          SHADER_SOURCE(pickId_vs));
+    }
+
+    if (!m_frameBuffer) {
+        m_frameBuffer = std::make_unique<FrameBuffer>(1, 1);
+    }
+
+    // The default framebuffer is not always object 0 (e.g. iOS), so save
+    // the current binding to restore after the id pass.
+    GLint boundFrameBuffer = 0;
+    GL::getIntegerv(GL_FRAMEBUFFER_BINDING, &boundFrameBuffer);
+
+    int vpWidth = _view.getWidth();
+    int vpHeight = _view.getHeight();
+
+    bool valid = m_frameBuffer->bind(rs) && m_shaderProgram->use(rs);
+
+    if (valid) {
+
+        // Id colors must land in the target unmodified
+        rs.blending(GL_FALSE);
+        rs.depthTest(GL_FALSE);
+        rs.depthMask(GL_FALSE);
+        rs.clearColor(0.f, 0.f, 0.f, 0.f);
+
+        for (auto& query : m_queries) {
+
+            GL::clear(GL_COLOR_BUFFER_BIT);
+
+            // Offset a full-size viewport so that the queried pixel lands
+            // on the framebuffer's single texel; screen y runs down, GL
+            // window y runs up.
+            int px = static_cast<int>(std::floor(query.x));
+            int py = static_cast<int>(std::floor(vpHeight - query.y));
+            rs.viewport(-px, -py, vpWidth, vpHeight);
+
+            for (const auto& marker : _markers) {
+
+                if (!marker->isVisible() || !marker->mesh() || !marker->feature()) {
+                    continue;
+                }
+                // Point markers are drawn as screen-space labels; they are
+                // picked through the label collision data instead.
+                if (marker->feature()->geometryType == GeometryType::points) {
+                    continue;
+                }
+                drawMarker(rs, *marker);
+            }
+
+            // The packed pixel layout matches the id encoding in
+            // drawMarker, so the read-back value is the MarkerID.
+            query.callback(m_frameBuffer->readAt(0, 0));
+        }
+
+        // The id colors are read back, so the attachment contents can be
+        // dropped instead of resolved to memory on tile-based GPUs.
+        m_frameBuffer->discard(rs);
+
+    } else {
+        for (auto& query : m_queries) { query.callback(0); }
+    }
+
+    m_queries.clear();
+
+    rs.framebuffer(static_cast<GLuint>(boundFrameBuffer));
+    rs.viewport(0, 0, vpWidth, vpHeight);
+}
+
+void MarkerPicker::drawMarker(RenderState& rs, const Marker& _marker) {
+
+    MarkerID id = _marker.id();
+
+    glm::vec4 color((id & 0xff) / 255.f,
+                    ((id >> 8) & 0xff) / 255.f,
+                    ((id >> 16) & 0xff) / 255.f,
+                    ((id >> 24) & 0xff) / 255.f);
+
+    m_shaderProgram->setUniformMatrix4f(rs, m_uMvp, _marker.modelViewProjectionMatrix());
+    m_shaderProgram->setUniformf(rs, m_uPickColor, color);
+
+    _marker.mesh()->draw(rs, *m_shaderProgram, false);
+}
+
+}
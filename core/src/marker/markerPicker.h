@@ -0,0 +1,69 @@
+#pragma once
+
+#include "gl/uniform.h"
+#include "util/types.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Tangram {
+
+class FrameBuffer;
+class Marker;
+class RenderState;
+class ShaderProgram;
+class View;
+
+/* MarkerPicker - GPU color-id picking for marker geometry
+ *
+ * Queued picks are resolved at the end of the next rendered frame:
+ * each polygon and polyline marker mesh is drawn into a 1x1 offscreen
+ * framebuffer with a flat color encoding its MarkerID, with the viewport
+ * offset so that the queried pixel lands on the single framebuffer
+ * texel. Unlike the label-based feature queries this is pixel accurate
+ * for filled geometry.
+ */
+class MarkerPicker {
+
+public:
+
+    using Callback = std::function<void(MarkerID)>;
+
+    MarkerPicker();
+    ~MarkerPicker();
+
+    /* Queue a pick at the given screen position (x right, y down); the
+     * callback runs on the render thread after the next frame with the
+     * MarkerID drawn at that pixel, or 0 when no marker covers it. */
+    void pick(float _x, float _y, Callback _callback);
+
+    bool hasQueries() const { return !m_queries.empty(); }
+
+    /* Render the id pass and resolve all queued picks; called at the end
+     * of a frame, while marker model matrices are up to date. */
+    void resolveQueries(RenderState& rs, const View& _view,
+                        const std::vector<std::unique_ptr<Marker>>& _markers);
+
+private:
+
+    void drawMarker(RenderState& rs, const Marker& _marker);
+
+    struct PickQuery {
+        float x;
+        float y;
+        Callback callback;
+    };
+
+    std::vector<PickQuery> m_queries;
+
+    std::unique_ptr<FrameBuffer> m_frameBuffer;
+
+    std::unique_ptr<ShaderProgram> m_shaderProgram;
+
+    UniformLocation m_uMvp{"u_mvp"};
+    UniformLocation m_uPickColor{"u_pick_color"};
+
+};
+
+}
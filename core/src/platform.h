@@ -45,9 +45,73 @@ std::string stringFromFile(const char* _path);
  */
 unsigned char* bytesFromFile(const char* _path, size_t& _size);
 
+/* Read-only view of a whole file's contents
+ *
+ * Where the platform supports it the data points directly into the
+ * memory-mapped file - shared with the page cache instead of copied to
+ * the heap - and the mapping is released on destruction. Platforms
+ * without mapping fall back to a heap buffer. An invalid view has null
+ * data; see mapFile().
+ */
+class MappedFile {
+
+public:
+
+    using ReleaseCallback = std::function<void(const char* _data, size_t _size)>;
+
+    MappedFile() {}
+
+    MappedFile(const char* _data, size_t _size, ReleaseCallback _release)
+        : m_data(_data), m_size(_size), m_release(std::move(_release)) {}
+
+    MappedFile(MappedFile&& _other)
+        : m_data(_other.m_data), m_size(_other.m_size),
+          m_release(std::move(_other.m_release)) {
+        _other.m_data = nullptr;
+        _other.m_size = 0;
+        _other.m_release = nullptr;
+    }
+
+    MappedFile& operator=(MappedFile&& _other) {
+        std::swap(m_data, _other.m_data);
+        std::swap(m_size, _other.m_size);
+        std::swap(m_release, _other.m_release);
+        return *this;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (m_data && m_release) { m_release(m_data, m_size); }
+    }
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+    explicit operator bool() const { return m_data != nullptr; }
+
+private:
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    ReleaseCallback m_release;
+};
+
+/* Map the file at _path into memory, read-only
+ *
+ * Unlike bytesFromFile this does not copy: consumers read the file's
+ * pages in place and drop them by destroying the view. Use it for large
+ * one-shot reads like fonts and textures.
+ */
+MappedFile mapFile(const char* _path);
+
 /* Function type for receiving data from a successful network request */
 using UrlCallback = std::function<void(std::vector<char>&&)>;
 
+/* Function type for receiving successive chunks of a network response */
+using UrlChunkCallback = std::function<void(const char* _data, size_t _length)>;
+
 /* Start retrieving data from a URL asynchronously
  *
  * When the request is finished, the callback @_callback will be
@@ -55,10 +119,46 @@ using UrlCallback = std::function<void(std::vector<char>&&)>;
  */
 bool startUrlRequest(const std::string& _url, UrlCallback _callback);
 
+/* Start retrieving data from a URL asynchronously, with chunked delivery
+ *
+ * @_onChunk is run on the network thread with each chunk of the response
+ * body as it arrives, after content decoding, so consumers can begin work
+ * before the transfer finishes. When the request completes, @_callback is
+ * run with the complete data like startUrlRequest. Platforms whose network
+ * stack only hands over complete responses run @_onChunk once.
+ */
+bool startUrlRequest(const std::string& _url, UrlChunkCallback _onChunk, UrlCallback _callback);
+
+/* Function type for receiving data from a conditional network request
+ *
+ * @_notModified is true when the server confirmed that the cached copy is
+ * still current (HTTP 304) and no body was transferred. Otherwise @_etag
+ * carries the validator of the response when the server sent one.
+ */
+using UrlValidateCallback = std::function<void(std::vector<char>&& _data, std::string&& _etag, bool _notModified)>;
+
+/* Start a conditional GET for @_url
+ *
+ * @_etag is the validator from a previous response of this URL and may be
+ * empty, in which case a plain fetch is performed that still captures the
+ * response validator. Platforms without request-header support always
+ * perform a full fetch and report @_notModified as false.
+ */
+bool startUrlRequest(const std::string& _url, const std::string& _etag, UrlValidateCallback _callback);
+
 /* Stop retrieving data from a URL that was previously requested
  */
 void cancelUrlRequest(const std::string& _url);
 
+/* Hint that requests to the host of @_url are imminent
+ *
+ * Lets the network stack perform DNS resolution and the TCP and TLS
+ * handshakes ahead of the first real request, so connection setup
+ * overlaps other loading work. Platforms without control over their
+ * transport may ignore the hint.
+ */
+void prewarmUrlHost(const std::string& _url);
+
 
 /* Set the priority of the current thread. Priority is equivalent
  * to pthread niceness.
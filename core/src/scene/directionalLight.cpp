@@ -67,4 +67,9 @@ const std::string& DirectionalLight::getTypeName() {
 
 }
 
+bool DirectionalLight::needsViewUniforms() const {
+    // Only a world-attached direction is rotated with the view each frame.
+    return m_origin == LightOrigin::world;
+}
+
 }
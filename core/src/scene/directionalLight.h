@@ -36,6 +36,7 @@ protected:
     virtual std::string getInstanceDefinesBlock() override;
     virtual std::string getInstanceAssignBlock() override;
     virtual const std::string& getTypeName() override;
+    virtual bool needsViewUniforms() const override;
 
     glm::vec3 m_direction;
 
@@ -48,7 +48,7 @@ DrawRule::DrawRule(const DrawRuleData& _ruleData, const std::string& _layerName,
 
 void DrawRule::merge(const DrawRuleData& _ruleData, const SceneLayer& _layer) {
 
-    evalConflict(*this, _ruleData, _layer);
+    DrawRuleWarnings::evalConflict(*this, _ruleData, _layer);
 
     const auto depthNew = _layer.depth();
     const char* layerNew = _layer.name().c_str();
@@ -124,8 +124,16 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
         return false;
     }
 
-    // If the first filter doesn't match, return immediately
-    if (!_layer.filter().eval(_feature, _ctx)) { return false; }
+    // Static zoom and geometry bounds rule out most layers without
+    // running their filter programs.
+    float zoom = _ctx.getKeywordZoom();
+
+    if (!_layer.activeFor(zoom, _feature.geometryType)) { return false; }
+
+    // If the first filter doesn't match, return immediately. Bounds
+    // that describe their filter exactly have already decided it.
+    if (!_layer.bounds().exact &&
+        !_layer.filterProgram().eval(_feature, _ctx)) { return false; }
 
     m_queuedLayers.push_back(&_layer);
 
@@ -146,7 +154,12 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
                 continue;
             }
 
-            if (sublayer.filter().eval(_feature, _ctx)) {
+            if (!sublayer.activeFor(zoom, _feature.geometryType)) {
+                continue;
+            }
+
+            if (sublayer.bounds().exact ||
+                sublayer.filterProgram().eval(_feature, _ctx)) {
                 m_queuedLayers.push_back(&sublayer);
             }
         }
@@ -158,42 +171,96 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
 void DrawRuleMergeSet::apply(const Feature& _feature, const SceneLayer& _layer,
                              StyleContext& _ctx, TileBuilder& _builder) {
 
-    // If no rules matched the feature, return immediately
+    // Matching and evaluation only look at the feature's properties and
+    // geometry type, never its coordinates - so features sharing both
+    // evaluate to the very same rules and can reuse a memoized set.
+    size_t signature = 0;
+    hash_combine(signature, &_layer);
+    hash_combine(signature, static_cast<int>(_feature.geometryType));
+    hash_combine(signature, _feature.props.hash());
+
+    auto cacheIt = m_cache.find(signature);
+    if (cacheIt != m_cache.end()) {
+        for (auto& rule : cacheIt->second.rules) {
+            buildRule(_feature, rule, _builder);
+        }
+        return;
+    }
+
+    auto& cached = m_cache[signature];
+
+    // If no rules matched the feature, memoize the empty rule set
     if (!match(_feature, _layer, _ctx)) { return; }
 
+    // Reserving for every dynamic parameter up front keeps the copied
+    // values at stable addresses while rules are appended below. Params
+    // dropped during evaluation leave slack, which is fine.
+    size_t dynamicParams = 0;
+    for (auto& rule : m_matchedRules) {
+        for (size_t i = 0; i < StyleParamKeySize; ++i) {
+            if (!rule.active[i]) { continue; }
+            auto* param = rule.params[i].param;
+            if (param->function >= 0 || param->stops) { dynamicParams++; }
+        }
+    }
+    cached.params.reserve(dynamicParams);
+
     // For each matched rule, find the style to be used and
     // build the feature with the rule's parameters
     for (auto& rule : m_matchedRules) {
 
-        StyleBuilder* style = _builder.getStyleBuilder(rule.getStyleName());
+        if (!evaluateRuleForContext(rule, _ctx)) { continue; }
 
-        if (!style) {
-            LOGN("Invalid style %s", rule.getStyleName().c_str());
-            continue;
-        }
+        // Copy the rule before the scratch slots are overwritten by the
+        // next rule's evaluation, redirecting evaluated parameters into
+        // the cached storage.
+        cached.rules.push_back(rule);
+        auto& copied = cached.rules.back();
 
-        bool valid = evaluateRuleForContext(rule, _ctx);
-
-        if (valid) {
-
-            // build outline explicitly with outline style
-            const auto& outlineStyleName = rule.findParameter(StyleParamKey::outline_style);
-            if (outlineStyleName) {
-                auto& styleName = outlineStyleName.value.get<std::string>();
-                auto* outlineStyle = _builder.getStyleBuilder(styleName);
-                if (!outlineStyle) {
-                    LOGN("Invalid style %s", styleName.c_str());
-                } else {
-                    rule.isOutlineOnly = true;
-                    outlineStyle->addFeature(_feature, rule);
-                    rule.isOutlineOnly = false;
-                }
+        for (size_t i = 0; i < StyleParamKeySize; ++i) {
+            if (copied.active[i] && isEvaluated(copied.params[i].param)) {
+                cached.params.push_back(*copied.params[i].param);
+                copied.params[i].param = &cached.params.back();
             }
+        }
+
+        buildRule(_feature, copied, _builder);
+    }
+}
+
+void DrawRuleMergeSet::buildRule(const Feature& _feature, DrawRule& _rule, TileBuilder& _builder) {
+
+    StyleBuilder* style = _builder.getStyleBuilder(_rule.getStyleName());
 
-            // build feature with style
-            style->addFeature(_feature, rule);
+    if (!style) {
+        LOGN("Invalid style %s", _rule.getStyleName().c_str());
+        return;
+    }
+
+    // build outline explicitly with outline style
+    const auto& outlineStyleName = _rule.findParameter(StyleParamKey::outline_style);
+    if (outlineStyleName) {
+        auto& styleName = outlineStyleName.value.get<std::string>();
+        auto* outlineStyle = _builder.getStyleBuilder(styleName);
+        if (!outlineStyle) {
+            LOGN("Invalid style %s", styleName.c_str());
+        } else {
+            _rule.isOutlineOnly = true;
+            outlineStyle->addFeature(_feature, _rule);
+            outlineStyle->countFeature();
+            _rule.isOutlineOnly = false;
         }
     }
+
+    // build feature with style
+    style->addFeature(_feature, _rule);
+    style->countFeature();
+
+    // Record interactive features in the tile's spatial index for CPU picking
+    bool interactive = false;
+    if (_rule.get(StyleParamKey::interactive, interactive) && interactive) {
+        _builder.indexFeature(_feature);
+    }
 }
 
 bool DrawRuleMergeSet::evaluateRuleForContext(DrawRule& rule, StyleContext& ctx) {
@@ -216,12 +283,17 @@ bool DrawRuleMergeSet::evaluateRuleForContext(DrawRule& rule, StyleContext& ctx)
             // Evaluate JS functions and Stops
             if (param->function >= 0) {
 
-                // Copy param into 'evaluated' and point param to the evaluated StyleParam.
-                m_evaluated[i] = *param;
-                param = &m_evaluated[i];
-
-                if (!ctx.evalStyle(param->function, param->key, m_evaluated[i].value)) {
-                    if (StyleParam::isRequired(param->key)) {
+                // Only the cheap fields go into the scratch slot; the value
+                // is written by evalStyle below, so the old payload (and any
+                // string it holds) is never copied.
+                auto& evaluated = m_evaluated[i];
+                evaluated.key = param->key;
+                evaluated.stops = param->stops;
+                evaluated.function = param->function;
+                param = &evaluated;
+
+                if (!ctx.evalStyle(evaluated.function, evaluated.key, evaluated.value)) {
+                    if (StyleParam::isRequired(evaluated.key)) {
                         valid = false;
                         break;
                     } else {
@@ -229,10 +301,13 @@ bool DrawRuleMergeSet::evaluateRuleForContext(DrawRule& rule, StyleContext& ctx)
                     }
                 }
             } else if (param->stops) {
-                m_evaluated[i] = *param;
-                param = &m_evaluated[i];
+                auto& evaluated = m_evaluated[i];
+                evaluated.key = param->key;
+                evaluated.stops = param->stops;
+                evaluated.function = param->function;
+                param = &evaluated;
 
-                Stops::eval(*param->stops, param->key, ctx.getKeywordZoom(), m_evaluated[i].value);
+                evaluated.value = ctx.evalStops(*evaluated.stops, evaluated.key);
             }
         }
 
@@ -5,6 +5,7 @@
 #include <vector>
 #include <set>
 #include <bitset>
+#include <unordered_map>
 
 namespace Tangram {
 
@@ -132,12 +133,37 @@ public:
 
     auto& matchedRules() { return m_matchedRules; }
 
+    /* Drop memoized rule evaluations. Called at the start of each tile
+     * build, since evaluated values depend on the tile zoom. */
+    void clearCache() { m_cache.clear(); }
+
 private:
-    // Reusable containers 'matchedRules' and 'queuedLayers'
+
+    // Fully evaluated rules for one feature signature. The rules'
+    // dynamic parameters point into 'params', which lives alongside
+    // them; everything else references stable layer data.
+    struct CachedRules {
+        std::vector<DrawRule> rules;
+        std::vector<StyleParam> params;
+    };
+
+    void buildRule(const Feature& _feature, DrawRule& _rule, TileBuilder& _builder);
+
+    bool isEvaluated(const StyleParam* _param) const {
+        return _param >= m_evaluated && _param < m_evaluated + StyleParamKeySize;
+    }
+
+    // Features with identical properties and geometry type evaluate to
+    // identical rules within one tile; repeats are served from here.
+    std::unordered_map<size_t, CachedRules> m_cache;
+    // Reusable containers 'matchedRules' and 'queuedLayers'. One
+    // DrawRuleMergeSet lives in each TileBuilder, so capacity warms up
+    // once per worker and matching then runs without heap allocations.
     std::vector<DrawRule> m_matchedRules;
     std::vector<const SceneLayer*> m_queuedLayers;
 
-    // Container for dynamically-evaluated parameters
+    // Scratch slots for dynamically-evaluated parameters; values are
+    // written in place by evalStyle and Stops::eval.
     StyleParam m_evaluated[StyleParamKeySize];
 
 };
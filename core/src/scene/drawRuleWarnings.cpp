@@ -0,0 +1,66 @@
+#include "drawRuleWarnings.h"
+
+#include "scene/dataLayer.h"
+#include "scene/styleParam.h"
+
+#include <algorithm>
+
+namespace Tangram {
+namespace DrawRuleWarnings {
+
+namespace {
+
+struct ParamUse {
+    const SceneLayer* layer;
+    const std::string* ruleName;
+    StyleParamKey key;
+    size_t depth;
+};
+
+void collectParams(const SceneLayer& _layer, std::vector<ParamUse>& _uses) {
+
+    for (const auto& rule : _layer.rules()) {
+        for (const auto& param : rule.parameters) {
+            _uses.push_back({ &_layer, &rule.name, param.key, _layer.depth() });
+        }
+    }
+    for (const auto& sublayer : _layer.sublayers()) {
+        collectParams(sublayer, _uses);
+    }
+}
+
+}
+
+void validateRuleConflicts(const std::vector<DataLayer>& _layers) {
+
+    std::vector<ParamUse> uses;
+    for (const auto& layer : _layers) {
+        collectParams(layer, uses);
+    }
+
+    // Group parameter uses so that conflicting ones become adjacent:
+    // same rule name, same parameter, same layer depth.
+    std::sort(uses.begin(), uses.end(),
+              [](const ParamUse& a, const ParamUse& b) {
+                  if (*a.ruleName != *b.ruleName) { return *a.ruleName < *b.ruleName; }
+                  if (a.key != b.key) { return a.key < b.key; }
+                  return a.depth < b.depth;
+              });
+
+    for (size_t i = 1; i < uses.size(); i++) {
+        const auto& a = uses[i - 1];
+        const auto& b = uses[i];
+
+        if (a.layer != b.layer && a.depth == b.depth &&
+            a.key == b.key && *a.ruleName == *b.ruleName) {
+
+            LOGW("Draw parameter '%s' in rule '%s' is set at the same depth"
+                 " by layers '%s' and '%s'; merge order decides which wins",
+                 StyleParam::keyName(b.key).c_str(), b.ruleName->c_str(),
+                 a.layer->name().c_str(), b.layer->name().c_str());
+        }
+    }
+}
+
+}
+}
@@ -1,27 +1,51 @@
 #pragma once
 
-#if defined(TANGRAM_WARN_ON_RULE_CONFLICT)
+#include "scene/drawRule.h"
+#include "scene/sceneLayer.h"
+#include "log.h"
+
+#include <vector>
 
+#if defined(TANGRAM_WARN_ON_RULE_CONFLICT)
 #include <set>
 #include <mutex>
+#endif
 
 namespace Tangram {
 
-static std::set<std::string> log;
-static std::mutex logMutex;
+class DataLayer;
+
+namespace DrawRuleWarnings {
+
+/* Walk the layer tree once at scene load and warn about draw parameters
+ * that are set by different layers at the same depth in rules sharing a
+ * name; the merge order between such layers decides which value wins.
+ * The check is conservative - layers with mutually exclusive filters
+ * can never co-match - but it runs offline instead of per feature. */
+void validateRuleConflicts(const std::vector<DataLayer>& _layers);
+
+#if defined(TANGRAM_WARN_ON_RULE_CONFLICT)
 
-void evalConflict(const DrawRule& rule, const DrawRuleData& data, const SceneLayer& layer) {
+/* Per-merge hook reporting the conflicts that actually occur during
+ * tile builds. Compiled to nothing unless explicitly enabled: the
+ * offline validation above covers scene authoring, and this hook costs
+ * string construction on every rule merge. */
+inline void evalConflict(const DrawRule& rule, const DrawRuleData& data, const SceneLayer& layer) {
+
+    static std::set<std::string> log;
+    static std::mutex logMutex;
 
     for (const auto& param : data.parameters) {
 
         auto k = static_cast<uint8_t>(param.key);
 
-        if (rule.depths[k] == layer.depth()) {
+        if (rule.active[k] && rule.params[k].depth == layer.depth()) {
 
             std::lock_guard<std::mutex> lock(logMutex);
 
             std::string logString = "Draw parameter '" + StyleParam::keyName(param.key) + "' in rule '" +
-                data.name + "' in layer '" + layer.name() + "' conflicts with layer '" + rule.layers[k] + "'";
+                data.name + "' in layer '" + layer.name() + "' conflicts with layer '" +
+                rule.params[k].name + "'";
 
             if (log.insert(logString).second) {
                 LOGW("%s", logString.c_str());
@@ -32,14 +56,12 @@ void evalConflict(const DrawRule& rule, const DrawRuleData& data, const SceneLay
 
 }
 
-}
-
 #else
 
-namespace Tangram {
+inline void evalConflict(const DrawRule& rule, const DrawRuleData& data, const SceneLayer& layer) {}
 
-void evalConflict(const DrawRule& rule, const DrawRuleData& data, const SceneLayer& layer) {}
+#endif
 
 }
 
-#endif
+}
@@ -1,6 +1,7 @@
 #include "filters.h"
 #include "scene/styleContext.h"
 #include "data/tileData.h"
+#include "util/stringIntern.h"
 #include "platform.h"
 
 #include <cmath>
@@ -247,6 +248,25 @@ struct string_matcher {
     bool operator()(const std::string& v) const {
         return str == v;
     }
+    bool operator()(const StringView& v) const {
+        return v == str;
+    }
+};
+
+// Matches feature values that view into the raw tile buffer against the
+// owned strings in filter definitions.
+struct string_view_matcher {
+    using result_type = bool;
+    const StringView& str;
+
+    template <typename T>
+    bool operator()(T v) const { return false; }
+    bool operator()(const std::string& v) const {
+        return str == v;
+    }
+    bool operator()(const StringView& v) const {
+        return str == v;
+    }
 };
 
 struct number_matcher {
@@ -280,6 +300,16 @@ struct match_equal_set {
     bool operator()(const std::string& str) const {
         string_matcher m{str};
 
+        for (const auto& v : values) {
+            if (Value::visit(v, m)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    bool operator()(const StringView& str) const {
+        string_view_matcher m{str};
+
         for (const auto& v : values) {
             if (Value::visit(v, m)) {
                 return true;
@@ -302,15 +332,19 @@ struct match_equal {
     bool operator()(const std::string& str) const {
         return Value::visit(value, string_matcher{str});
     }
+    bool operator()(const StringView& str) const {
+        return Value::visit(value, string_view_matcher{str});
+    }
 };
 
 struct match_range {
-    const Filter::Range& f;
+    float min, max;
 
     bool operator() (const double& num) const {
-        return num >= f.min && num < f.max;
+        return num >= min && num < max;
     }
     bool operator() (const std::string&) const { return false; }
+    bool operator() (const StringView&) const { return false; }
     bool operator() (const none_type&) const { return false; }
 };
 
@@ -367,7 +401,7 @@ struct matcher {
             ? props.get(f.key)
             : ctx.getKeyword(f.keyword);
 
-        return Value::visit(value, match_range{f});
+        return Value::visit(value, match_range{f.min, f.max});
     }
     bool operator() (const Filter::Function& f) const {
         return ctx.evalFilter(f.id);
@@ -381,4 +415,228 @@ bool Filter::eval(const Feature& feat, StyleContext& ctx) const {
     return Data::visit(data, matcher(feat, ctx));
 }
 
+static uint8_t geometryBit(const Value& _value) {
+    if (!_value.isString()) { return FilterBounds::allGeometry; }
+    auto str = _value.toString();
+    if (str == "point") { return 1 << GeometryType::points; }
+    if (str == "line") { return 1 << GeometryType::lines; }
+    if (str == "polygon") { return 1 << GeometryType::polygons; }
+    return FilterBounds::allGeometry;
+}
+
+static uint8_t keywordBit(FilterKeyword _keyword) {
+    return 1 << static_cast<uint8_t>(_keyword);
+}
+
+static FilterBounds dataBounds(const Filter::Data& _data) {
+
+    FilterBounds bounds;
+
+    if (_data.is<none_type>()) {
+        // An empty filter passes everything; the unconstrained bounds
+        // describe it completely.
+        bounds.exact = true;
+
+    } else if (_data.is<Filter::OperatorAll>()) {
+        bounds.exact = true;
+        for (const auto& filter : _data.get<Filter::OperatorAll>().operands) {
+            auto operand = dataBounds(filter.data);
+            bounds.intersect(operand);
+            bounds.keywords |= operand.keywords;
+            bounds.exact &= operand.exact;
+        }
+    } else if (_data.is<Filter::OperatorAny>()) {
+        // The union of the operand bounds; an empty 'any' never passes.
+        bounds.zoomMin = std::numeric_limits<float>::infinity();
+        bounds.zoomMax = -std::numeric_limits<float>::infinity();
+        bounds.geometry = 0;
+        bounds.exact = true;
+        bool zoomConstrained = false;
+        size_t operandCount = 0;
+        for (const auto& filter : _data.get<Filter::OperatorAny>().operands) {
+            auto operand = dataBounds(filter.data);
+            bounds.unite(operand);
+            bounds.keywords |= operand.keywords;
+            bounds.exact &= operand.exact;
+            zoomConstrained |= !operand.zoomUnconstrained();
+            operandCount++;
+        }
+        // The zoom union over-approximates a disjunction of intervals,
+        // so exactness only survives for a single operand or a union of
+        // pure geometry predicates.
+        if (operandCount > 1 && zoomConstrained) {
+            bounds.exact = false;
+        }
+    } else if (_data.is<Filter::Range>()) {
+        const auto& range = _data.get<Filter::Range>();
+        if (range.keyword == FilterKeyword::zoom) {
+            bounds.zoomMin = range.min;
+            bounds.zoomMax = range.max;
+            bounds.keywords |= keywordBit(range.keyword);
+            bounds.exact = true;
+        } else if (range.keyword != FilterKeyword::undefined) {
+            bounds.keywords |= keywordBit(range.keyword);
+        }
+    } else if (_data.is<Filter::Equality>()) {
+        const auto& equality = _data.get<Filter::Equality>();
+        if (equality.keyword == FilterKeyword::geometry) {
+            bounds.geometry = geometryBit(equality.value);
+            bounds.keywords |= keywordBit(equality.keyword);
+            bounds.exact = bounds.geometry != FilterBounds::allGeometry;
+        } else if (equality.keyword != FilterKeyword::undefined) {
+            bounds.keywords |= keywordBit(equality.keyword);
+        }
+    } else if (_data.is<Filter::EqualitySet>()) {
+        const auto& set = _data.get<Filter::EqualitySet>();
+        if (set.keyword == FilterKeyword::geometry) {
+            bounds.geometry = 0;
+            bounds.exact = true;
+            bounds.keywords |= keywordBit(set.keyword);
+            for (const auto& value : set.values) {
+                uint8_t bit = geometryBit(value);
+                bounds.geometry |= bit;
+                bounds.exact &= bit != FilterBounds::allGeometry;
+            }
+        } else if (set.keyword != FilterKeyword::undefined) {
+            bounds.keywords |= keywordBit(set.keyword);
+        }
+    } else if (_data.is<Filter::OperatorNone>()) {
+        // 'none' gives no static bounds, but its operands may still
+        // reference keywords.
+        for (const auto& filter : _data.get<Filter::OperatorNone>().operands) {
+            bounds.keywords |= dataBounds(filter.data).keywords;
+        }
+    }
+    // Existence, function and property predicates give no static bounds.
+
+    return bounds;
+}
+
+FilterBounds Filter::bounds() const {
+    return dataBounds(data);
+}
+
+// Keyword predicates never look at feature properties.
+template<typename F>
+static uint32_t internedKey(const F& _f) {
+    return _f.keyword == FilterKeyword::undefined ? StringIntern::intern(_f.key) : 0;
+}
+
+FilterProgram::FilterProgram(const Filter& _filter) {
+    m_entry = compile(_filter.data, PASS, FAIL);
+}
+
+uint16_t FilterProgram::compile(const Filter::Data& _data, uint16_t _pass, uint16_t _fail) {
+
+    switch (_data.which()) {
+
+    case Filter::Data::type<Filter::OperatorAll>::value: {
+        // Each operand falls through to the next one while it holds.
+        uint16_t next = _pass;
+        auto& operands = _data.get<Filter::OperatorAll>().operands;
+        for (auto it = operands.rbegin(); it != operands.rend(); ++it) {
+            next = compile(it->data, next, _fail);
+        }
+        return next;
+    }
+    case Filter::Data::type<Filter::OperatorAny>::value: {
+        uint16_t next = _fail;
+        auto& operands = _data.get<Filter::OperatorAny>().operands;
+        for (auto it = operands.rbegin(); it != operands.rend(); ++it) {
+            next = compile(it->data, _pass, next);
+        }
+        return next;
+    }
+    case Filter::Data::type<Filter::OperatorNone>::value: {
+        uint16_t next = _pass;
+        auto& operands = _data.get<Filter::OperatorNone>().operands;
+        for (auto it = operands.rbegin(); it != operands.rend(); ++it) {
+            next = compile(it->data, _fail, next);
+        }
+        return next;
+    }
+    case Filter::Data::type<Filter::Equality>::value: {
+        auto& f = _data.get<Filter::Equality>();
+        m_values.push_back(f.value);
+        m_instrs.push_back({ Op::equality, f.keyword, _pass, _fail,
+                             internedKey(f), uint32_t(m_values.size() - 1), 0.f, 0.f });
+        return uint16_t(m_instrs.size() - 1);
+    }
+    case Filter::Data::type<Filter::EqualitySet>::value: {
+        auto& f = _data.get<Filter::EqualitySet>();
+        m_sets.push_back(f.values);
+        m_instrs.push_back({ Op::equalitySet, f.keyword, _pass, _fail,
+                             internedKey(f), uint32_t(m_sets.size() - 1), 0.f, 0.f });
+        return uint16_t(m_instrs.size() - 1);
+    }
+    case Filter::Data::type<Filter::Range>::value: {
+        auto& f = _data.get<Filter::Range>();
+        m_instrs.push_back({ Op::range, f.keyword, _pass, _fail,
+                             internedKey(f), 0, f.min, f.max });
+        return uint16_t(m_instrs.size() - 1);
+    }
+    case Filter::Data::type<Filter::Existence>::value: {
+        auto& f = _data.get<Filter::Existence>();
+        m_instrs.push_back({ Op::existence, FilterKeyword::undefined, _pass, _fail,
+                             StringIntern::intern(f.key), uint32_t(f.exists), 0.f, 0.f });
+        return uint16_t(m_instrs.size() - 1);
+    }
+    case Filter::Data::type<Filter::Function>::value: {
+        auto& f = _data.get<Filter::Function>();
+        m_instrs.push_back({ Op::function, FilterKeyword::undefined, _pass, _fail,
+                             0, f.id, 0.f, 0.f });
+        return uint16_t(m_instrs.size() - 1);
+    }
+    default:
+        // none_type matches everything
+        return _pass;
+    }
+}
+
+bool FilterProgram::eval(const Feature& _feat, StyleContext& _ctx) const {
+
+    uint16_t pc = m_entry;
+
+    while (pc < m_instrs.size()) {
+
+        const Instr& in = m_instrs[pc];
+
+        bool pass = false;
+
+        switch (in.op) {
+        case Op::equality: {
+            auto& value = (in.keyword == FilterKeyword::undefined)
+                ? _feat.props.get(in.keyId)
+                : _ctx.getKeyword(in.keyword);
+            pass = Value::visit(value, match_equal{m_values[in.arg]});
+            break;
+        }
+        case Op::equalitySet: {
+            auto& value = (in.keyword == FilterKeyword::undefined)
+                ? _feat.props.get(in.keyId)
+                : _ctx.getKeyword(in.keyword);
+            pass = Value::visit(value, match_equal_set{m_sets[in.arg]});
+            break;
+        }
+        case Op::range: {
+            auto& value = (in.keyword == FilterKeyword::undefined)
+                ? _feat.props.get(in.keyId)
+                : _ctx.getKeyword(in.keyword);
+            pass = Value::visit(value, match_range{in.min, in.max});
+            break;
+        }
+        case Op::existence:
+            pass = bool(in.arg) == !_feat.props.get(in.keyId).is<none_type>();
+            break;
+        case Op::function:
+            pass = _ctx.evalFilter(in.arg);
+            break;
+        }
+
+        pc = pass ? in.pass : in.fail;
+    }
+
+    return pc == PASS;
+}
+
 }
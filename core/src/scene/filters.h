@@ -2,6 +2,8 @@
 
 #include "util/variant.h"
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 #include <memory>
 
@@ -16,6 +18,53 @@ enum class FilterKeyword : uint8_t {
     geometry,
 };
 
+/* Conservative static bounds implied by a Filter: the zoom interval and
+ * geometry types outside of which the filter can never pass. Derived
+ * from $zoom ranges and $geometry equalities; predicates the analysis
+ * cannot see keep the bounds unconstrained. */
+struct FilterBounds {
+
+    static constexpr uint8_t allGeometry = 0xff;
+
+    float zoomMin = -std::numeric_limits<float>::infinity();
+    float zoomMax = std::numeric_limits<float>::infinity();
+    uint8_t geometry = allGeometry;
+
+    /* Bit per FilterKeyword referenced anywhere in the filter */
+    uint8_t keywords = 0;
+
+    /* True when the bounds fully describe the filter: the match is then
+     * decided by zoom and geometry type alone, so the evaluator can be
+     * skipped for such filters entirely. */
+    bool exact = false;
+
+    bool usesKeyword(FilterKeyword _keyword) const {
+        return keywords & (1 << static_cast<uint8_t>(_keyword));
+    }
+
+    bool zoomUnconstrained() const {
+        return zoomMin == -std::numeric_limits<float>::infinity() &&
+               zoomMax == std::numeric_limits<float>::infinity();
+    }
+
+    bool matchZoom(float _zoom) const {
+        return _zoom >= zoomMin && _zoom < zoomMax;
+    }
+    bool match(float _zoom, int _geometryType) const {
+        return matchZoom(_zoom) && (geometry & (1 << _geometryType));
+    }
+    void intersect(const FilterBounds& _other) {
+        zoomMin = std::max(zoomMin, _other.zoomMin);
+        zoomMax = std::min(zoomMax, _other.zoomMax);
+        geometry &= _other.geometry;
+    }
+    void unite(const FilterBounds& _other) {
+        zoomMin = std::min(zoomMin, _other.zoomMin);
+        zoomMax = std::max(zoomMax, _other.zoomMax);
+        geometry |= _other.geometry;
+    }
+};
+
 struct Filter {
     struct OperatorAll {
         std::vector<Filter> operands;
@@ -66,6 +115,9 @@ struct Filter {
 
     bool eval(const Feature& feat, StyleContext& ctx) const;
 
+    /* Static bounds for this filter, computed once at scene load. */
+    FilterBounds bounds() const;
+
     // Create an 'any', 'all', or 'none' filter
     inline static Filter MatchAny(std::vector<Filter> filters) {
         sort(filters);
@@ -118,4 +170,61 @@ struct Filter {
     const std::vector<Filter>& operands() const;
 
 };
+
+/* Linear, short-circuit compiled form of a Filter tree.
+ *
+ * The tree of operator and predicate nodes is flattened into an
+ * instruction list once at scene load; each instruction carries the
+ * absolute index of the next instruction for its pass and fail case, so
+ * per-feature evaluation is a tight loop without variant dispatch or
+ * recursion. Property lookups are keyed off interned key ids.
+ */
+class FilterProgram {
+
+public:
+
+    FilterProgram() {}
+
+    explicit FilterProgram(const Filter& _filter);
+
+    bool eval(const Feature& _feat, StyleContext& _ctx) const;
+
+private:
+
+    enum class Op : uint8_t {
+        equality,
+        equalitySet,
+        range,
+        existence,
+        function,
+    };
+
+    struct Instr {
+        Op op;
+        FilterKeyword keyword;
+        uint16_t pass;   // next instruction when the predicate holds
+        uint16_t fail;   // next instruction otherwise
+        uint32_t keyId;  // interned property key
+        uint32_t arg;    // value index, set index, function id or existence flag
+        float min, max;  // range bounds
+    };
+
+    // Jump targets past any valid instruction index end the program.
+    enum : uint16_t {
+        PASS = 0xffff,
+        FAIL = 0xfffe,
+    };
+
+    /* Emit instructions for _data back to front, so the pass and fail
+     * targets of nested operands are known when their predicates are
+     * written. Returns the entry index of the emitted fragment. */
+    uint16_t compile(const Filter::Data& _data, uint16_t _pass, uint16_t _fail);
+
+    std::vector<Instr> m_instrs;
+    std::vector<Value> m_values;
+    std::vector<std::vector<Value>> m_sets;
+    uint16_t m_entry = PASS;
+
+};
+
 }
@@ -1,4 +1,5 @@
 #include "importer.h"
+#include "debug/sceneLoadProfile.h"
 #include "platform.h"
 #include "scene/sceneLoader.h"
 #include "util/topologicalSort.h"
@@ -13,6 +14,33 @@ using YAML::NodeType;
 namespace Tangram {
 
 std::atomic_uint Importer::progressCounter(0);
+std::mutex Importer::s_cacheMutex;
+std::map<size_t, Node> Importer::s_documentCache;
+
+bool Importer::loadConfigCached(const std::string& sceneString, Node& node) {
+
+    size_t contentHash = std::hash<std::string>()(sceneString);
+    {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        auto it = s_documentCache.find(contentHash);
+        if (it != s_documentCache.end()) {
+            node = YAML::Clone(it->second);
+            return true;
+        }
+    }
+
+    if (!SceneLoader::loadConfig(sceneString, node)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_cacheMutex);
+    if (s_documentCache.size() >= MAX_CACHED_DOCUMENTS) {
+        s_documentCache.clear();
+    }
+    s_documentCache.emplace(contentHash, YAML::Clone(node));
+
+    return true;
+}
 
 bool isUrl(const std::string &path) {
     static const std::regex r("^(http|https):/");
@@ -65,18 +93,31 @@ Node Importer::applySceneImports(const std::string& scenePath, const std::string
         if (isUrl(path)) {
             progressCounter++;
             startUrlRequest(path,
-                    [&, p = path](std::vector<char>&& rawData) {
+                    [&, p = path,
+                     fetchStart = SceneLoadProfile::now()](std::vector<char>&& rawData) {
+
+                    SceneLoadProfile::addResource(p, rawData.size(),
+                                                  SceneLoadProfile::msSince(fetchStart));
 
                     if (!rawData.empty()) {
-                        std::unique_lock<std::mutex> lock(sceneMutex);
-                        processScene(p, std::string(rawData.data(), rawData.size()));
+                        // Parse off the lock, so that payloads arriving
+                        // concurrently don't serialize on each other.
+                        Node sceneNode;
+                        if (loadConfigCached(std::string(rawData.data(),
+                                                         rawData.size()), sceneNode)) {
+                            std::unique_lock<std::mutex> lock(sceneMutex);
+                            processScene(p, std::move(sceneNode));
+                        }
                     }
                     progressCounter--;
                     m_condition.notify_all();
             });
         } else {
-            std::unique_lock<std::mutex> lock(sceneMutex);
-            processScene(path, getSceneString(path));
+            Node sceneNode;
+            if (loadConfigCached(getSceneString(path), sceneNode)) {
+                std::unique_lock<std::mutex> lock(sceneMutex);
+                processScene(path, std::move(sceneNode));
+            }
         }
     }
 
@@ -85,27 +126,20 @@ Node Importer::applySceneImports(const std::string& scenePath, const std::string
     return root;
 }
 
-void Importer::processScene(const std::string &scenePath, const std::string &sceneString) {
+void Importer::processScene(const std::string &scenePath, Node&& sceneNode) {
 
     LOGD("Process: '%s'", scenePath.c_str());
 
-    try {
-        auto sceneNode = YAML::Load(sceneString);
+    normalizeSceneImports(sceneNode, scenePath);
+    normalizeSceneDataSources(sceneNode, scenePath);
+    normalizeSceneTextures(sceneNode, scenePath);
+    normalizeFonts(sceneNode, scenePath);
 
-        normalizeSceneImports(sceneNode, scenePath);
-        normalizeSceneDataSources(sceneNode, scenePath);
-        normalizeSceneTextures(sceneNode, scenePath);
-        normalizeFonts(sceneNode, scenePath);
+    m_scenes[scenePath] = sceneNode;
 
-        m_scenes[scenePath] = sceneNode;
-
-        for (const auto& import : getScenesToImport(sceneNode)) {
-            m_sceneQueue.push_back(import);
-            m_condition.notify_all();
-        }
-    }
-    catch (YAML::ParserException e) {
-        LOGE("Parsing scene config '%s'", e.what());
+    for (const auto& import : getScenesToImport(sceneNode)) {
+        m_sceneQueue.push_back(import);
+        m_condition.notify_all();
     }
 }
 
@@ -30,7 +30,18 @@ public:
 // protected for testing purposes, else could be private
 protected:
     virtual std::string getSceneString(const std::string& scenePath);
-    void processScene(const std::string& scenePath, const std::string& sceneString);
+
+    // Registers an already parsed scene and queues its imports. Parsing
+    // happens outside the importer lock, so concurrent downloads can
+    // parse their payloads in parallel; only this step is serialized.
+    void processScene(const std::string& scenePath, Node&& sceneNode);
+
+    // Parse a scene document, going through a cache keyed by content
+    // hash. Imports shared between scenes - and unchanged files across
+    // scene reloads - skip the YAML parse entirely. The cached document
+    // is cloned on every hit, since normalization and merging mutate
+    // nodes in place.
+    static bool loadConfigCached(const std::string& sceneString, Node& node);
 
     // Get the sequence of scene names that are designated to be imported into the
     // input scene node by its 'import' fields.
@@ -66,7 +77,12 @@ private:
     std::mutex sceneMutex;
     std::condition_variable m_condition;
 
+    // Parsed documents by content hash, shared by all importers
+    static std::mutex s_cacheMutex;
+    static std::map<size_t, Node> s_documentCache;
+
     const unsigned int MAX_SCENE_DOWNLOAD = 4;
+    static const size_t MAX_CACHED_DOCUMENTS = 32;
 };
 
 }
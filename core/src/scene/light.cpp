@@ -17,7 +17,8 @@ Light::Light(const std::string& _name, bool _dynamic):
     m_specular(0.0f),
     m_type(LightType::ambient),
     m_origin(LightOrigin::camera),
-    m_dynamic(_dynamic) {
+    m_dynamic(_dynamic),
+    m_animated(false) {
 }
 
 Light::~Light() {
@@ -41,10 +42,21 @@ void Light::setSpecularColor(const glm::vec4 _specular) {
 }
 
 void Light::setOrigin(LightOrigin origin) {
-    m_dynamic = true;
     m_origin = origin;
 }
 
+bool Light::needsViewUniforms() const {
+    // Color-only lights never depend on the view.
+    return false;
+}
+
+void Light::specialize() {
+    // Called once the light is fully configured: everything that is
+    // neither animated nor view dependent gets its values folded into
+    // the shader source, dropping the per-style per-frame uniform sets.
+    m_dynamic = m_dynamic || m_animated || needsViewUniforms();
+}
+
 void Light::injectSourceBlocks(ShaderProgram& _shader) {
 
     // Inject all needed #defines for this light instance
@@ -80,6 +80,16 @@ public:
     /*  Set the origin relative to which this light will be positioned */
     void setOrigin(LightOrigin origin);
 
+    /*  Mark this light as animated: its parameters may change at runtime, so its
+     *  uniforms are retained instead of being folded into the shader source */
+    void setAnimated(bool _animated) { m_animated = _animated; }
+
+    /*  Decide, once the light is fully configured at scene load, whether its
+     *  parameters can be constant-folded into the generated shader source.
+     *  Only animated lights and lights whose parameters depend on the view
+     *  keep their per-frame uniform path */
+    void specialize();
+
     /*  Get the origin relative to which this light is positioned */
     LightOrigin getOrigin() const { return m_origin; }
 
@@ -129,6 +139,10 @@ protected:
     /* Get the string name of the type of this light (as it would be declared in GLSL) */
     virtual const std::string& getTypeName() = 0;
 
+    /*  Whether any parameter of this light has to be recomputed from the view
+     *  each frame; such lights cannot be folded into the shader source */
+    virtual bool needsViewUniforms() const;
+
     /*  The name reference to the uniform on the shader.  */
     std::string m_name;
 
@@ -145,6 +159,9 @@ protected:
 
     bool m_dynamic;
 
+    /*  Set from the scene 'animated' field; forces the uniform path */
+    bool m_animated;
+
 };
 
 }
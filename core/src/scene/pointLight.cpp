@@ -142,4 +142,15 @@ const std::string& PointLight::getTypeName() {
 
 }
 
+bool PointLight::needsViewUniforms() const {
+    if (m_origin == LightOrigin::world || m_origin == LightOrigin::ground) {
+        return true;
+    }
+    // A camera-attached position only depends on the view when it is
+    // given in pixels, which scale with pixelsPerMeter.
+    return m_position.units[0] == Unit::pixel ||
+           m_position.units[1] == Unit::pixel ||
+           m_position.units[2] == Unit::pixel;
+}
+
 }
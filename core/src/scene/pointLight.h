@@ -48,6 +48,7 @@ protected:
     virtual std::string getInstanceDefinesBlock() override;
     virtual std::string getInstanceAssignBlock() override;
     virtual const std::string& getTypeName() override;
+    virtual bool needsViewUniforms() const override;
 
     UnitVec<glm::vec3> m_position;
 
@@ -0,0 +1,110 @@
+#include "scene/resourceCache.h"
+
+#include <algorithm>
+#include <list>
+
+namespace Tangram {
+
+namespace ResourceCache {
+
+namespace {
+
+// Upper bound for retained raw font data.
+const size_t MAX_FONT_CACHE_BYTES = 16 * 1024 * 1024;
+
+std::mutex s_mutex;
+
+std::unordered_map<std::string, std::weak_ptr<Texture>> s_textures;
+
+struct FontEntry {
+    std::string uri;
+    std::shared_ptr<std::vector<char>> data;
+};
+
+// Insertion-ordered for eviction; the set of distinct fonts is small.
+std::list<FontEntry> s_fontData;
+size_t s_fontBytes = 0;
+
+}
+
+std::string textureKey(const std::string& url, const TextureOptions& options, bool generateMipmaps) {
+
+    std::string key = url;
+    key += '|';
+    key += std::to_string(options.internalFormat);
+    key += '|';
+    key += std::to_string(options.format);
+    key += '|';
+    key += std::to_string(options.filtering.min);
+    key += '|';
+    key += std::to_string(options.filtering.mag);
+    key += '|';
+    key += std::to_string(options.wrapping.wraps);
+    key += '|';
+    key += std::to_string(options.wrapping.wrapt);
+    key += '|';
+    key += generateMipmaps ? '1' : '0';
+    return key;
+}
+
+std::shared_ptr<Texture> getTexture(const std::string& key) {
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    auto it = s_textures.find(key);
+    if (it == s_textures.end()) { return nullptr; }
+
+    auto texture = it->second.lock();
+    if (!texture) {
+        // No scene holds this texture anymore.
+        s_textures.erase(it);
+    }
+    return texture;
+}
+
+void putTexture(const std::string& key, const std::shared_ptr<Texture>& texture) {
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_textures[key] = texture;
+}
+
+std::shared_ptr<std::vector<char>> getFontData(const std::string& uri) {
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    for (auto& entry : s_fontData) {
+        if (entry.uri == uri) { return entry.data; }
+    }
+    return nullptr;
+}
+
+void putFontData(const std::string& uri, const std::shared_ptr<std::vector<char>>& data) {
+
+    if (!data || data->empty()) { return; }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    for (auto& entry : s_fontData) {
+        if (entry.uri == uri) { return; }
+    }
+
+    s_fontData.push_back({ uri, data });
+    s_fontBytes += data->size();
+
+    while (s_fontBytes > MAX_FONT_CACHE_BYTES && !s_fontData.empty()) {
+        s_fontBytes -= s_fontData.front().data->size();
+        s_fontData.pop_front();
+    }
+}
+
+void clear() {
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_textures.clear();
+    s_fontData.clear();
+    s_fontBytes = 0;
+}
+
+}
+
+}
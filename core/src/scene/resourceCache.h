@@ -0,0 +1,49 @@
+#pragma once
+
+#include "gl/texture.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+/* ResourceCache - Shared resources surviving scene reloads
+ *
+ * Scenes that reference the same texture urls or font files (day/night
+ * themes typically share all of them) used to re-download and re-decode
+ * every resource on each scene switch. This cache is keyed by resource
+ * url plus the options that shape the GL object, and is shared across
+ * Scene instances.
+ *
+ * Textures are held weakly: during a scene switch the outgoing scene
+ * still owns its textures, so the incoming scene picks up the live
+ * objects - GL handles included - and entries vanish once no scene
+ * uses them. Raw font data is held strongly up to a byte budget, since
+ * nothing else keeps it alive after it is handed to the font context.
+ */
+namespace ResourceCache {
+
+/* Key combining a texture url with the options baked into the GL object. */
+std::string textureKey(const std::string& url, const TextureOptions& options, bool generateMipmaps);
+
+/* Returns the cached texture for the key, or null. */
+std::shared_ptr<Texture> getTexture(const std::string& key);
+
+/* Make a loaded texture available to later scene loads. */
+void putTexture(const std::string& key, const std::shared_ptr<Texture>& texture);
+
+/* Returns the cached raw font data for the uri, or null. */
+std::shared_ptr<std::vector<char>> getFontData(const std::string& uri);
+
+/* Cache raw font data; oldest entries are evicted past the byte budget. */
+void putFontData(const std::string& uri, const std::shared_ptr<std::vector<char>>& data);
+
+/* Drop every cache entry. */
+void clear();
+
+}
+
+}
@@ -71,6 +71,11 @@ Scene::Scene(const Scene& _other)
 
 Scene::~Scene() {}
 
+void Scene::setFontContext(std::shared_ptr<FontContext> _fontContext) {
+    m_fontContext = std::move(_fontContext);
+    m_fontContext->setSceneResourceRoot(m_resourceRoot);
+}
+
 const Style* Scene::findStyle(const std::string& _name) const {
 
     for (auto& style : m_styles) {
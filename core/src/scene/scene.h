@@ -71,11 +71,16 @@ public:
     auto& lights() { return m_lights; };
     auto& textures() { return m_textures; };
     auto& functions() { return m_jsFunctions; };
+    auto& compiledFunctions() { return m_jsFunctionBytecode; };
     auto& spriteAtlases() { return m_spriteAtlases; };
     auto& stops() { return m_stops; }
     auto& background() { return m_background; }
     auto& fontContext() { return m_fontContext; }
     auto& globalRefs() { return m_globalRefs; }
+
+    /* Replace the scene's FontContext with one shared between Maps (see
+     * ShareGroup); must happen before the scene is loaded. */
+    void setFontContext(std::shared_ptr<FontContext> _fontContext);
     Style* findStyle(const std::string& _name);
 
     const auto& path() const { return m_path; }
@@ -86,6 +91,7 @@ public:
     const auto& styles() const { return m_styles; };
     const auto& lights() const { return m_lights; };
     const auto& functions() const { return m_jsFunctions; };
+    const auto& compiledFunctions() const { return m_jsFunctionBytecode; };
     const auto& mapProjection() const { return m_mapProjection; };
     const auto& fontContext() const { return m_fontContext; }
     const auto& globalRefs() const { return m_globalRefs; }
@@ -149,6 +155,12 @@ private:
     std::vector<std::string> m_names;
 
     std::vector<std::string> m_jsFunctions;
+
+    // Bytecode of m_jsFunctions, compiled once at scene load and loaded
+    // into each worker's StyleContext; empty blobs mark functions that
+    // did not compile, see StyleContext::compileFunctions()
+    std::vector<std::string> m_jsFunctionBytecode;
+
     std::list<Stops> m_stops;
 
     Color m_background;
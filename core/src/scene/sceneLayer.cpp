@@ -9,6 +9,8 @@ SceneLayer::SceneLayer(std::string _name, Filter _filter,
                        std::vector<SceneLayer> _sublayers,
                        bool _visible) :
     m_filter(std::move(_filter)),
+    m_filterProgram(m_filter),
+    m_bounds(m_filter.bounds()),
     m_name(_name),
     m_rules(_rules),
     m_sublayers(std::move(_sublayers)),
@@ -14,6 +14,8 @@ struct Feature;
 class SceneLayer {
 
     Filter m_filter;
+    FilterProgram m_filterProgram;
+    FilterBounds m_bounds;
     std::string m_name;
     std::vector<DrawRuleData> m_rules;
     std::vector<SceneLayer> m_sublayers;
@@ -29,6 +31,14 @@ public:
 
     const auto& name() const { return m_name; }
     const auto& filter() const { return m_filter; }
+    const auto& filterProgram() const { return m_filterProgram; }
+    const auto& bounds() const { return m_bounds; }
+
+    /* Cheap static pre-check: false when m_filter can never pass for a
+     * feature of _geometryType at _zoom. */
+    bool activeFor(float _zoom, int _geometryType) const {
+        return m_bounds.match(_zoom, _geometryType);
+    }
     const auto& rules() const { return m_rules; }
     const auto& sublayers() const { return m_sublayers; }
     const auto& depth() const { return m_depth; }
@@ -6,6 +6,8 @@
 #include "data/geoJsonSource.h"
 #include "data/mvtSource.h"
 #include "data/topoJsonSource.h"
+#include "debug/allocStats.h"
+#include "debug/sceneLoadProfile.h"
 #include "data/rasterSource.h"
 #include "gl/shaderProgram.h"
 #include "style/material.h"
@@ -17,14 +19,19 @@
 #include "style/pointStyle.h"
 #include "style/rasterStyle.h"
 #include "scene/dataLayer.h"
+#include "scene/drawRuleWarnings.h"
 #include "scene/filters.h"
 #include "scene/importer.h"
+#include "scene/resourceCache.h"
 #include "scene/sceneLayer.h"
 #include "scene/spriteAtlas.h"
 #include "scene/stops.h"
+#include "scene/styleContext.h"
 #include "scene/styleMixer.h"
 #include "scene/styleParam.h"
 #include "util/base64.h"
+#include "util/dashArray.h"
+#include "util/taskExecutor.h"
 #include "util/yamlHelper.h"
 #include "view/view.h"
 #include "log.h"
@@ -33,6 +40,8 @@
 
 #include <vector>
 #include <algorithm>
+#include <set>
+#include <future>
 #include <iterator>
 #include <regex>
 
@@ -54,17 +63,35 @@ bool SceneLoader::loadScene(std::shared_ptr<Scene> _scene) {
 
     Node& root = _scene->config();
 
+    SceneLoadProfile::beginLoad();
+
     Importer sceneImporter;
 
-    if ((root = sceneImporter.applySceneImports(_scene->path(), _scene->resourceRoot())) ) {
-        // Load font resources
-        _scene->fontContext()->loadFonts();
+    // Default font resources don't depend on the config; load them while
+    // imports are fetched and merged. The future is joined before
+    // applyConfig touches the FontContext.
+    auto fontLoad = std::async(std::launch::async, [&]() {
+            SceneLoadProfile::Phase phase("loadFonts");
+            _scene->fontContext()->loadFonts();
+        });
 
-        applyConfig(root, _scene);
+    {
+        SceneLoadProfile::Phase phase("applySceneImports");
+        root = sceneImporter.applySceneImports(_scene->path(), _scene->resourceRoot());
+    }
 
-        return true;
+    fontLoad.wait();
+
+    bool ok = false;
+    if (root) {
+        SceneLoadProfile::Phase phase("applyConfig");
+        applyConfig(root, _scene);
+        ok = true;
     }
-    return false;
+
+    SceneLoadProfile::endLoad();
+
+    return ok;
 }
 
 bool SceneLoader::loadConfig(const std::string& _sceneString, Node& root) {
@@ -77,6 +104,26 @@ bool SceneLoader::loadConfig(const std::string& _sceneString, Node& root) {
     return true;
 }
 
+bool SceneLoader::tileConfigEquals(const Node& _a, const Node& _b) {
+
+    // yaml-cpp has no deep node comparison; serializing the subtrees is
+    // good enough for a check that runs once per scene load.
+    static const char* tileKeys[] = {
+        "sources", "layers", "styles", "textures", "fonts", "global",
+    };
+
+    for (const auto& key : tileKeys) {
+        const Node& a = _a[key];
+        const Node& b = _b[key];
+
+        if (bool(a) != bool(b)) { return false; }
+        if (!a) { continue; }
+
+        if (YAML::Dump(a) != YAML::Dump(b)) { return false; }
+    }
+    return true;
+}
+
 void SceneLoader::applyUpdates(Scene& scene, const std::vector<SceneUpdate>& updates) {
     auto& root = scene.config();
     for (const auto& update : updates) {
@@ -139,14 +186,50 @@ void SceneLoader::applyGlobals(Node root, Scene& scene) {
     }
 }
 
+// Pack the dash patterns of all styles into one shared texture, giving each
+// style its row range in it. Dashed strokes then sample regions of the same
+// texture instead of forcing a texture switch between styles.
+static void buildSharedDashTexture(const std::shared_ptr<Scene>& _scene) {
+
+    std::vector<std::pair<PolylineStyle*, std::vector<unsigned int>>> patterns;
+    size_t sumRows = 0;
+
+    for (auto& style : _scene->styles()) {
+        auto polylineStyle = dynamic_cast<PolylineStyle*>(style.get());
+        if (polylineStyle && !polylineStyle->dashArray().empty()) {
+            patterns.emplace_back(polylineStyle, DashArray::render(polylineStyle->dashArray()));
+            sumRows += patterns.back().second.size();
+        }
+    }
+
+    if (patterns.empty()) { return; }
+
+    auto texture = std::make_shared<Texture>(1, sumRows, TextureOptions::nearestRgba());
+
+    std::vector<unsigned int> pixels;
+    pixels.reserve(sumRows);
+
+    int offset = 0;
+    for (auto& entry : patterns) {
+        pixels.insert(pixels.end(), entry.second.begin(), entry.second.end());
+        entry.first->setDashTexture(texture, offset, entry.second.size());
+        offset += entry.second.size();
+    }
+
+    texture->setData(pixels.data(), pixels.size());
+}
+
 bool SceneLoader::applyConfig(Node& config, const std::shared_ptr<Scene>& _scene) {
 
+    ALLOC_TAG(scene);
+
     // Instantiate built-in styles
     _scene->styles().emplace_back(new PolygonStyle("polygons"));
     _scene->styles().emplace_back(new PolylineStyle("lines"));
     _scene->styles().emplace_back(new DebugTextStyle("debugtext", true));
     _scene->styles().emplace_back(new TextStyle("text", _scene->fontContext(), true));
     _scene->styles().emplace_back(new DebugStyle("debug"));
+    _scene->styles().emplace_back(new DebugStyle("debug-heatmap", Blending::overlay, GL_TRIANGLE_STRIP, true));
     _scene->styles().emplace_back(new PointStyle("points", _scene->fontContext()));
     _scene->styles().emplace_back(new RasterStyle("raster"));
 
@@ -167,6 +250,25 @@ bool SceneLoader::applyConfig(Node& config, const std::shared_ptr<Scene>& _scene
         LOGW("No source defined in the yaml scene configuration.");
     }
 
+    // Open connections to the distinct tile hosts while the rest of the
+    // scene is processed, so the first tile requests skip DNS and the
+    // TCP/TLS handshakes instead of paying them after scene compilation
+    {
+        std::set<std::string> hosts;
+        for (auto& source : _scene->dataSources()) {
+            const auto& url = source->urlTemplate();
+            if (url.compare(0, 7, "http://") != 0 &&
+                url.compare(0, 8, "https://") != 0) { continue; }
+
+            auto pathStart = url.find('/', url.find("://") + 3);
+            auto host = url.substr(0, pathStart);
+
+            if (hosts.insert(host).second) {
+                prewarmUrlHost(host + "/");
+            }
+        }
+    }
+
     if (Node textures = config["textures"]) {
         for (const auto& texture : textures) {
             try { loadTexture(texture, _scene); }
@@ -206,6 +308,8 @@ bool SceneLoader::applyConfig(Node& config, const std::shared_ptr<Scene>& _scene
         }
     }
 
+    buildSharedDashTexture(_scene);
+
     // Styles that are opaque must be ordered first in the scene so that
     // they are rendered 'under' styles that require blending
     std::sort(_scene->styles().begin(), _scene->styles().end(), Style::compare);
@@ -224,6 +328,9 @@ bool SceneLoader::applyConfig(Node& config, const std::shared_ptr<Scene>& _scene
                 LOGNode("Parsing layer: '%s'", layer, e.what());
             }
         }
+        // One-shot validation of the loaded layer tree, replacing the
+        // per-feature rule conflict hook for regular builds.
+        DrawRuleWarnings::validateRuleConflicts(_scene->layers());
     }
 
     if (Node lights = config["lights"]) {
@@ -255,17 +362,24 @@ bool SceneLoader::applyConfig(Node& config, const std::shared_ptr<Scene>& _scene
         }
     }
 
-    loadBackground(config["scene"]["background"], _scene);
+    // Resolve the 'scene' block once; each operator[] is a string-keyed
+    // scan over the map's nodes.
+    if (Node sceneNode = config["scene"]) {
+        loadBackground(sceneNode["background"], _scene);
 
-    Node animated = config["scene"]["animated"];
-    if (animated) {
-        _scene->animated(animated.as<bool>());
+        if (Node animated = sceneNode["animated"]) {
+            _scene->animated(animated.as<bool>());
+        }
     }
 
     for (auto& style : _scene->styles()) {
         style->build(*_scene);
     }
 
+    // Compile scene functions once; each worker StyleContext loads the
+    // bytecode instead of parsing and compiling every function again.
+    _scene->compiledFunctions() = StyleContext::compileFunctions(_scene->functions());
+
     return true;
 }
 
@@ -529,53 +643,84 @@ std::shared_ptr<Texture> SceneLoader::fetchTexture(const std::string& name, cons
 
     std::shared_ptr<Texture> texture;
 
+    // Scene switches usually reference the same resources; reuse the live
+    // texture - GL handle included - when an earlier scene load decoded it.
+    std::string cacheKey = ResourceCache::textureKey(url, options, generateMipmaps);
+    if (auto cached = ResourceCache::getTexture(cacheKey)) {
+        return cached;
+    }
+
     std::regex r("^(http|https):/");
     std::smatch match;
     // TODO: generalize using URI handlers
     if (std::regex_search(url, match, r)) {
         scene->pendingTextures++;
-        startUrlRequest(url, [=](std::vector<char>&& rawData) {
-                auto ptr = (unsigned char*)(rawData.data());
-                size_t dataSize = rawData.size();
-                std::lock_guard<std::mutex> lock(m_textureMutex);
-                auto texture = scene->getTexture(name);
-                if (texture) {
-                    if (!texture->loadImageFromMemory(ptr, dataSize)) {
-                        LOGE("Invalid texture data '%s'", url.c_str());
-                    }
-
-                    updateSpriteNodes(name, texture, scene);
-                    scene->pendingTextures--;
+        startUrlRequest(url, [=, fetchStart = SceneLoadProfile::now()](std::vector<char>&& rawData) {
+                SceneLoadProfile::addResource(url, rawData.size(),
+                                              SceneLoadProfile::msSince(fetchStart));
+                std::shared_ptr<Texture> texture;
+                {
+                    std::lock_guard<std::mutex> lock(m_textureMutex);
+                    texture = scene->getTexture(name);
                 }
+                if (!texture) { return; }
+
+                // Decode on the shared worker so image decompression never
+                // blocks the network thread. pendingTextures stays up until
+                // the pixels are attached, keeping scene readiness correct.
+                Texture::decodeAsync(texture, std::move(rawData), [=](bool ok) {
+                        std::lock_guard<std::mutex> lock(m_textureMutex);
+                        if (!ok) {
+                            LOGE("Invalid texture data '%s'", url.c_str());
+                        } else {
+                            // Only loaded textures enter the cache, so a reuse
+                            // never observes a half-fetched object.
+                            ResourceCache::putTexture(cacheKey, texture);
+                        }
+
+                        updateSpriteNodes(name, texture, scene);
+                        scene->pendingTextures--;
+                    });
             });
         texture = std::make_shared<Texture>(nullptr, 0, options, generateMipmaps);
     } else {
 
         if (url.substr(0, 22) == "data:image/png;base64,") {
-            // Skip data: prefix
-            auto data = url.substr(22);
-
-            std::vector<unsigned char> blob;
+            // Decode inline blobs on the shared pool; an embedded sprite
+            // sheet costs hundreds of milliseconds that the scene-apply
+            // path does not need to wait for. As with fetched textures,
+            // pendingTextures holds the first render until the pixels
+            // are attached.
+            texture = std::make_shared<Texture>(nullptr, 0, options, generateMipmaps);
+            scene->pendingTextures++;
+
+            auto tex = texture;
+            TaskExecutor::shared().enqueue([=]() {
+                std::vector<unsigned char> blob;
+
+                try {
+                    // Skip data: prefix
+                    blob = Base64::decode(url.substr(22));
+                } catch(std::runtime_error e) {
+                    LOGE("Can't decode Base64 texture '%s'", e.what());
+                }
 
-            try {
-                blob = Base64::decode(data);
-            } catch(std::runtime_error e) {
-                LOGE("Can't decode Base64 texture '%s'", e.what());
-            }
+                bool ok = !blob.empty() && tex->loadImageFromMemory(blob.data(), blob.size());
 
-            if (blob.empty()) {
-                LOGE("Can't decode Base64 texture");
-                return nullptr;
-            }
-            texture = std::make_shared<Texture>(0, 0, options, generateMipmaps);
+                std::lock_guard<std::mutex> lock(m_textureMutex);
+                if (!ok) {
+                    LOGE("Invalid Base64 texture");
+                } else {
+                    ResourceCache::putTexture(cacheKey, tex);
+                }
 
-            if (!texture->loadImageFromMemory(blob.data(), blob.size())) {
-                LOGE("Invalid Base64 texture");
-            }
+                updateSpriteNodes(name, tex, scene);
+                scene->pendingTextures--;
+            });
 
         } else {
-            size_t size = 0;
-            unsigned char* blob = bytesFromFile(url.c_str(), size);
+            // Decoded in place from the mapped file, no heap copy
+            auto blob = mapFile(url.c_str());
 
             if (!blob) {
                 LOGE("Can't load texture resource at url '%s'", url.c_str());
@@ -583,10 +728,12 @@ std::shared_ptr<Texture> SceneLoader::fetchTexture(const std::string& name, cons
             }
             texture = std::make_shared<Texture>(0, 0, options, generateMipmaps);
 
-            if (!texture->loadImageFromMemory(blob, size)) {
+            if (!texture->loadImageFromMemory(reinterpret_cast<const unsigned char*>(blob.data()),
+                                              blob.size())) {
                 LOGE("Invalid texture data '%s'", url.c_str());
+            } else {
+                ResourceCache::putTexture(cacheKey, texture);
             }
-            free(blob);
         }
     }
 
@@ -594,9 +741,7 @@ std::shared_ptr<Texture> SceneLoader::fetchTexture(const std::string& name, cons
 }
 
 bool SceneLoader::loadTexture(const std::string& url, const std::shared_ptr<Scene>& scene) {
-    TextureOptions options = {GL_RGBA, GL_RGBA, {GL_LINEAR, GL_LINEAR}, {GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE}};
-
-    auto texture = fetchTexture(url, url, options, false, scene);
+    auto texture = fetchTexture(url, url, TextureOptions::linearRgba(), false, scene);
     if (texture) {
         std::lock_guard<std::mutex> lock(m_textureMutex);
         scene->textures().emplace(url, texture);
@@ -612,7 +757,7 @@ void SceneLoader::loadTexture(const std::pair<Node, Node>& node, const std::shar
     Node textureConfig = node.second;
 
     std::string file;
-    TextureOptions options = {GL_RGBA, GL_RGBA, {GL_LINEAR, GL_LINEAR}, {GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE} };
+    TextureOptions options = TextureOptions::linearRgba();
 
     if (Node url = textureConfig["url"]) {
         file = url.as<std::string>();
@@ -690,28 +835,42 @@ void loadFontDescription(const Node& node, const std::string& family, const std:
     // Download/Load the font and add it to the context
     FontDescription _ft(familyNormalized, styleNormalized, weight, uri);
 
+    // Raw font data cached from an earlier scene load spares the
+    // download or disk read.
+    if (auto cachedData = ResourceCache::getFontData(_ft.uri)) {
+        auto source = alfons::InputSource(*cachedData);
+        scene->fontContext()->addFont(_ft, source);
+        return;
+    }
+
     std::regex regex("^(http|https):/");
     std::smatch match;
 
     if (std::regex_search(uri, match, regex)) {
         // Load remote
         scene->pendingFonts++;
-        startUrlRequest(_ft.uri, [_ft, scene](std::vector<char>&& rawData) {
+        startUrlRequest(_ft.uri, [_ft, scene, fetchStart = SceneLoadProfile::now()](std::vector<char>&& rawData) {
+            SceneLoadProfile::addResource(_ft.uri, rawData.size(),
+                                          SceneLoadProfile::msSince(fetchStart));
             if (rawData.size() == 0) {
                 LOGE("Bad URL request for font %s at URL %s", _ft.alias.c_str(), _ft.uri.c_str());
             } else {
                 auto source = alfons::InputSource(rawData);
                 scene->fontContext()->addFont(_ft, source);
+                ResourceCache::putFontData(_ft.uri,
+                        std::make_shared<std::vector<char>>(std::move(rawData)));
             }
             scene->pendingFonts--;
         });
     } else {
         // Load from local storage
-        size_t dataSize = 0;
-
-        if (unsigned char* data = bytesFromFile(_ft.uri.c_str(), dataSize)) {
-            auto source = alfons::InputSource(reinterpret_cast<const char*>(data), dataSize);
-            free(data);
+        if (auto fontFile = mapFile(_ft.uri.c_str())) {
+            auto source = alfons::InputSource(fontFile.data(), fontFile.size());
+            // The resource cache keeps its own copy - the only one made;
+            // the mapping is dropped once the font was added.
+            ResourceCache::putFontData(_ft.uri,
+                    std::make_shared<std::vector<char>>(
+                        fontFile.data(), fontFile.data() + fontFile.size()));
 
             LOGN("Add local font %s (%s)", _ft.uri.c_str(), _ft.bundleAlias.c_str());
             scene->fontContext()->addFont(_ft, source);
@@ -774,6 +933,18 @@ void SceneLoader::loadStyleProps(Style& style, Node styleNode, const std::shared
         style.setTexCoordsGeneration(texcoordsNode.as<bool>());
     }
 
+    if (Node optimizeNode = styleNode["mesh_optimize"]) {
+        style.setMeshOptimization(optimizeNode.as<bool>());
+    }
+
+    if (Node optionalNode = styleNode["optional"]) {
+        style.setOptional(optionalNode.as<bool>());
+    }
+
+    if (Node prepassNode = styleNode["depth_prepass"]) {
+        style.setDepthPrepass(prepassNode.as<bool>());
+    }
+
     if (Node dashNode = styleNode["dash"]) {
         if (auto polylineStyle = dynamic_cast<PolylineStyle*>(&style)) {
             if (dashNode.IsSequence()) {
@@ -787,6 +958,15 @@ void SceneLoader::loadStyleProps(Style& style, Node styleNode, const std::shared
         }
     }
 
+    if (Node roundsNode = styleNode["rounds"]) {
+        if (auto polylineStyle = dynamic_cast<PolylineStyle*>(&style)) {
+            const std::string& rounds = roundsNode.Scalar();
+            if (rounds == "fragment") { polylineStyle->setFragmentRounds(true); }
+            else if (rounds == "geometry") { polylineStyle->setFragmentRounds(false); }
+            else { LOGW("Unrecognized rounds mode '%s'", rounds.c_str()); }
+        }
+    }
+
     if (Node dashBackgroundColor = styleNode["dash_background_color"]) {
         if (auto polylineStyle = dynamic_cast<PolylineStyle*>(&style)) {
             glm::vec4 backgroundColor = getColorAsVec4(dashBackgroundColor);
@@ -955,14 +1135,17 @@ void SceneLoader::loadSource(const std::string& name, const Node& source, const
     } else if (type == "MVT") {
         sourcePtr = std::shared_ptr<DataSource>(new MVTSource(name, url, minDisplayZoom, maxDisplayZoom, maxZoom));
     } else if (type == "Raster") {
-        TextureOptions options = {GL_RGBA, GL_RGBA, {GL_LINEAR, GL_LINEAR}, {GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE} };
+        TextureOptions options = TextureOptions::linearRgba();
         bool generateMipmaps = false;
         if (Node filtering = source["filtering"]) {
             if (extractTexFiltering(filtering, options.filtering)) {
                 generateMipmaps = true;
             }
         }
-        sourcePtr = std::shared_ptr<DataSource>(new RasterSource(name, url, minDisplayZoom, maxDisplayZoom, maxZoom, options, generateMipmaps));
+        auto rasterPtr = new RasterSource(name, url, minDisplayZoom, maxDisplayZoom, maxZoom, options, generateMipmaps);
+        // Decoded textures get the same byte budget as the raw data cache
+        rasterPtr->setTextureCacheSize(CACHE_SIZE);
+        sourcePtr = std::shared_ptr<DataSource>(rasterPtr);
     } else {
         LOGW("Unrecognized data source type '%s', skipping", type.c_str());
     }
@@ -1096,6 +1279,9 @@ void SceneLoader::loadLight(const std::pair<Node, Node>& node, const std::shared
     if (Node specular = light["specular"]) {
         sceneLight->setSpecularColor(getColorAsVec4(specular));
     }
+    if (Node animated = light["animated"]) {
+        sceneLight->setAnimated(animated.as<bool>(false));
+    }
 
     // Verify that light position parameters are consistent with the origin type
     if (sceneLight->getType() == LightType::point || sceneLight->getType() == LightType::spot) {
@@ -1112,6 +1298,10 @@ void SceneLoader::loadLight(const std::pair<Node, Node>& node, const std::shared
         }
     }
 
+    // With all parameters known, fold static lights into the shader
+    // source; only animated or view-dependent lights keep uniforms.
+    sceneLight->specialize();
+
     scene->lights().push_back(std::move(sceneLight));
 }
 
@@ -1374,6 +1564,23 @@ Filter SceneLoader::generateNoneFilter(Node _filter, Scene& scene) {
     return Filter::MatchNone(std::move(filters));
 }
 
+// Numeric two-element sequences of vec2-valued parameters can be taken
+// as-is; elements with unit suffixes still go through the string path.
+static bool parseVec2Sequence(const Node& _node, StyleParamKey _key, glm::vec2& _vec) {
+
+    if (_key != StyleParamKey::extrude && _key != StyleParamKey::size &&
+        !StyleParam::isOffsets(_key)) {
+        return false;
+    }
+    if (_node.size() != 2) { return false; }
+
+    double x, y;
+    if (!getDouble(_node[0], x) || !getDouble(_node[1], y)) { return false; }
+
+    _vec = { x, y };
+    return true;
+}
+
 void SceneLoader::parseStyleParams(Node params, const std::shared_ptr<Scene>& scene, const std::string& prefix,
                                    std::vector<StyleParam>& out) {
 
@@ -1437,7 +1644,18 @@ void SceneLoader::parseStyleParams(Node params, const std::shared_ptr<Scene>& sc
                 }
 
             } else {
-                out.push_back(StyleParam{ key, parseSequence(value) });
+                auto styleKey = StyleParam::getKey(key);
+                glm::vec2 vec;
+                if (parseVec2Sequence(value, styleKey, vec)) {
+                    // Pre-parsed: the numbers go straight into the typed
+                    // value instead of a string that is tokenized again.
+                    StyleParam param;
+                    param.key = styleKey;
+                    param.value = vec;
+                    out.push_back(std::move(param));
+                } else {
+                    out.push_back(StyleParam{ key, parseSequence(value) });
+                }
             }
             break;
         }
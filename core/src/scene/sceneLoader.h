@@ -42,6 +42,11 @@ struct SceneLoader {
 
     static bool loadScene(std::shared_ptr<Scene> _scene);
     static bool loadConfig(const std::string& _sceneString, Node& _root);
+
+    /* True when the subtrees of the two configs that determine tile
+     * geometry (sources, layers, styles, textures, fonts and globals)
+     * are identical, i.e. tiles built for _a remain valid under _b. */
+    static bool tileConfigEquals(const Node& _a, const Node& _b);
     static bool applyConfig(Node& config, const std::shared_ptr<Scene>& scene);
     static void applyUpdates(Scene& scene, const std::vector<SceneUpdate>& updates);
     static void applyGlobals(Node root, Scene& scene);
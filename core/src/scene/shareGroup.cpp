@@ -0,0 +1,18 @@
+#include "scene/shareGroup.h"
+
+#include "text/fontContext.h"
+
+namespace Tangram {
+
+std::shared_ptr<FontContext> ShareGroup::fontContext() {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_fontContext) {
+        m_fontContext = std::make_shared<FontContext>();
+    }
+
+    return m_fontContext;
+}
+
+}
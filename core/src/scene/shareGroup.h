@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+namespace Tangram {
+
+class FontContext;
+
+/* Resources shared between Map instances rendering the same scene.
+ *
+ * Texture pixels and raw font files are already reused process-wide
+ * through ResourceCache, and compiled shaders through the program
+ * binary cache. What a second Map instance still pays for twice is the
+ * FontContext: glyph atlases, SDF rasterization and the shaping cache.
+ * Maps constructed with the same ShareGroup hand one FontContext to
+ * all of their scenes, so a main view and a minimap on the same style
+ * rasterize and hold every glyph once.
+ *
+ * The participating GL contexts must be share-listed (or be the same
+ * context): glyph textures upload once and are drawn from all of them.
+ */
+class ShareGroup {
+
+public:
+
+    /* The FontContext shared by the group's scenes; created on first use. */
+    std::shared_ptr<FontContext> fontContext();
+
+private:
+
+    std::mutex m_mutex;
+    std::shared_ptr<FontContext> m_fontContext;
+
+};
+
+}
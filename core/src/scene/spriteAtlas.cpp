@@ -14,24 +14,45 @@ void SpriteAtlas::addSpriteNode(const std::string& _name, glm::vec2 _origin, glm
     float uvB = 1.f - _origin.y / atlasHeight;
     float uvT = uvB - _size.y / atlasHeight;
 
-    m_spritesNodes[_name] = SpriteNode { { uvL, uvB }, { uvR, uvT }, _size, _origin };
+    SpriteNode node { { uvL, uvB }, { uvR, uvT }, _size, _origin,
+                      { uvL, uvB, uvR, uvT } };
+
+    auto it = m_spriteIds.find(_name);
+    if (it == m_spriteIds.end()) {
+        m_spriteIds[_name] = m_nodes.size();
+        m_nodes.push_back(node);
+    } else {
+        // Re-added sprites (e.g. after a texture update) keep their index.
+        m_nodes[it->second] = node;
+    }
 }
 
 bool SpriteAtlas::getSpriteNode(const std::string& _name, SpriteNode& _node) const {
-    auto it = m_spritesNodes.find(_name);
-    if (it == m_spritesNodes.end()) {
+    size_t index;
+    if (!getSpriteIndex(_name, index)) {
+        return false;
+    }
+
+    _node = m_nodes[index];
+    return true;
+}
+
+bool SpriteAtlas::getSpriteIndex(const std::string& _name, size_t& _index) const {
+    auto it = m_spriteIds.find(_name);
+    if (it == m_spriteIds.end()) {
         return false;
     }
 
-    _node = it->second;
+    _index = it->second;
     return true;
 }
 
 void SpriteAtlas::updateSpriteNodes(std::shared_ptr<Texture> _texture) {
     m_texture = _texture;
-    for (auto& spriteNode : m_spritesNodes) {
+    for (auto& spriteId : m_spriteIds) {
         // Use the origin of the spriteNode set when the node was created
-        addSpriteNode(spriteNode.first.k, spriteNode.second.m_origin, spriteNode.second.m_size);
+        auto& node = m_nodes[spriteId.second];
+        addSpriteNode(spriteId.first.k, node.m_origin, node.m_size);
     }
 }
 
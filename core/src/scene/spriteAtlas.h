@@ -2,6 +2,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 #include "gl/texture.h"
 #include "util/fastmap.h"
 #include "glm/glm.hpp"
@@ -13,6 +14,9 @@ struct SpriteNode {
     glm::vec2 m_uvTR;
     glm::vec2 m_size;
     glm::vec2 m_origin;
+    // Texture coordinates packed as {BL.x, BL.y, TR.x, TR.y}, ready to
+    // be copied into a quad without touching the vec2s again.
+    glm::vec4 m_uvQuad;
 };
 
 class SpriteAtlas {
@@ -25,13 +29,23 @@ public:
     bool getSpriteNode(const std::string& _name, SpriteNode& _node) const;
     void updateSpriteNodes(std::shared_ptr<Texture> _texture);
 
+    /* Resolve a sprite name to its index; returns false for unknown
+     * names. Indices are stable for the lifetime of the atlas, so
+     * builders can resolve a name once and use the index per feature. */
+    bool getSpriteIndex(const std::string& _name, size_t& _index) const;
+
+    const SpriteNode& getSpriteNode(size_t _index) const { return m_nodes[_index]; }
+
     /* Bind the atlas in the driver */
     void bind(RenderState& rs, GLuint _slot);
 
     Texture* texture() { return m_texture.get(); }
 
 private:
-    fastmap<std::string, SpriteNode> m_spritesNodes;
+    // Sprite nodes by index, with the name lookup kept separate so that
+    // the per-feature path only ever touches the vector.
+    fastmap<std::string, size_t> m_spriteIds;
+    std::vector<SpriteNode> m_nodes;
     std::shared_ptr<Texture> m_texture;
 };
 
@@ -5,11 +5,18 @@
 #include "data/tileData.h"
 #include "scene/filters.h"
 #include "scene/scene.h"
+#include "scene/stops.h"
 #include "util/builders.h"
+#include "util/stringIntern.h"
 #include "log.h"
 
 #include "duktape.h"
 
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <regex>
+
 #define DUMP(...) // do { logMsg(__VA_ARGS__); duk_dump_context_stderr(m_ctx); } while(0)
 #define DBG(...) do { logMsg(__VA_ARGS__); duk_dump_context_stderr(m_ctx); } while(0)
 
@@ -167,29 +174,76 @@ void StyleContext::initFunctions(const Scene& _scene) {
     m_sceneId = _scene.id;
 
     setSceneGlobals(_scene.config()["global"]);
-    setFunctions(_scene.functions());
+
+    const auto& bytecode = _scene.compiledFunctions();
+    setFunctions(_scene.functions(), bytecode.empty() ? nullptr : &bytecode);
+}
+
+std::vector<std::string> StyleContext::compileFunctions(const std::vector<std::string>& _functions) {
+
+    std::vector<std::string> bytecode;
+    bytecode.reserve(_functions.size());
+
+    duk_context* ctx = duk_create_heap_default();
+
+    for (auto& function : _functions) {
+        duk_push_string(ctx, function.c_str());
+        duk_push_string(ctx, "");
+
+        if (duk_pcompile(ctx, DUK_COMPILE_FUNCTION) == 0) {
+            duk_dump_function(ctx);
+
+            duk_size_t size = 0;
+            const char* data = static_cast<const char*>(duk_get_buffer_data(ctx, -1, &size));
+            bytecode.emplace_back(data, size);
+        } else {
+            // Left empty; setFunctions() compiles from source and warns
+            bytecode.emplace_back();
+        }
+        duk_pop(ctx);
+    }
+
+    duk_destroy_heap(ctx);
+
+    return bytecode;
 }
 
-bool StyleContext::setFunctions(const std::vector<std::string>& _functions) {
+bool StyleContext::setFunctions(const std::vector<std::string>& _functions,
+                               const std::vector<std::string>* _bytecode) {
 
     auto arr_idx = duk_push_array(m_ctx);
     int id = 0;
 
     bool ok = true;
 
+    m_nativeFns.clear();
+    m_nativeFns.reserve(_functions.size());
+
     for (auto& function : _functions) {
-        duk_push_string(m_ctx, function.c_str());
-        duk_push_string(m_ctx, "");
 
-        if (duk_pcompile(m_ctx, DUK_COMPILE_FUNCTION) == 0) {
+        if (_bytecode && size_t(id) < _bytecode->size() && !(*_bytecode)[id].empty()) {
+            // Load the shared bytecode instead of compiling the source again
+            const auto& blob = (*_bytecode)[id];
+            void* buffer = duk_push_fixed_buffer(m_ctx, blob.size());
+            memcpy(buffer, blob.data(), blob.size());
+            duk_load_function(m_ctx);
             duk_put_prop_index(m_ctx, arr_idx, id);
+
         } else {
-            LOGW("Compile failed: %s\n%s\n---",
-                 duk_safe_to_string(m_ctx, -1),
-                 function.c_str());
-            duk_pop(m_ctx);
-            ok = false;
+            duk_push_string(m_ctx, function.c_str());
+            duk_push_string(m_ctx, "");
+
+            if (duk_pcompile(m_ctx, DUK_COMPILE_FUNCTION) == 0) {
+                duk_put_prop_index(m_ctx, arr_idx, id);
+            } else {
+                LOGW("Compile failed: %s\n%s\n---",
+                     duk_safe_to_string(m_ctx, -1),
+                     function.c_str());
+                duk_pop(m_ctx);
+                ok = false;
+            }
         }
+        m_nativeFns.push_back(recognize(function));
         id++;
     }
 
@@ -230,9 +284,109 @@ bool StyleContext::addFunction(const std::string& _function) {
     // Pop the functions array off the stack
     duk_pop(m_ctx);
 
+    if (m_nativeFns.size() <= size_t(id)) { m_nativeFns.resize(id + 1); }
+    m_nativeFns[id] = recognize(_function);
+
     return ok;
 }
 
+// Matches the source of a trivial single-expression function against a few
+// common shapes: constants, feature property lookups, comparisons against a
+// literal and two-way $zoom ternaries. Anything else is left to duktape.
+StyleContext::NativeFn StyleContext::recognize(const std::string& _function) {
+
+    NativeFn fn;
+
+    static const std::regex reFunction(
+        R"(^\s*function\s*\(\s*\)\s*\{\s*return\s+([^;]+?)\s*;?\s*\}\s*$)");
+    static const std::regex reLiteral(
+        R"(^(?:true|false|-?\d+(?:\.\d+)?|'[^'\\]*'|"[^"\\]*")$)");
+    static const std::regex reProperty(
+        R"(^feature\.(\w+)$|^feature\[\s*'([^'\\]+)'\s*\]$)");
+    static const std::regex reCompare(
+        R"(^(\$zoom|feature\.\w+|feature\[\s*'[^'\\]+'\s*\])\s*(===|==|!==|!=|>=|<=|>|<)\s*(-?\d+(?:\.\d+)?|'[^'\\]*')$)");
+    static const std::regex reTernary(
+        R"(^\$zoom\s*(>=|<=|>|<)\s*(-?\d+(?:\.\d+)?)\s*\?\s*(-?\d+(?:\.\d+)?|'[^'\\]*')\s*:\s*(-?\d+(?:\.\d+)?|'[^'\\]*')$)");
+
+    auto parseLiteral = [](const std::string& _token, Value& _value, bool* _boolean) {
+        if (_boolean) { *_boolean = false; }
+        if (_token == "true" || _token == "false") {
+            if (!_boolean) { return false; }
+            *_boolean = true;
+            _value = (_token == "true") ? 1.0 : 0.0;
+            return true;
+        }
+        if (!_token.empty() && (_token.front() == '\'' || _token.front() == '"')) {
+            _value = _token.substr(1, _token.size() - 2);
+            return true;
+        }
+        // Token shape is guaranteed numeric by the expression regexes.
+        _value = std::stod(_token);
+        return true;
+    };
+
+    auto parseCmp = [](const std::string& _op, NativeFn& _fn) {
+        _fn.strict = (_op == "===" || _op == "!==");
+        if (_op == "==" || _op == "===") { _fn.cmp = NativeFn::Cmp::eq; }
+        else if (_op == "!=" || _op == "!==") { _fn.cmp = NativeFn::Cmp::ne; }
+        else if (_op == "<") { _fn.cmp = NativeFn::Cmp::lt; }
+        else if (_op == "<=") { _fn.cmp = NativeFn::Cmp::le; }
+        else if (_op == ">") { _fn.cmp = NativeFn::Cmp::gt; }
+        else { _fn.cmp = NativeFn::Cmp::ge; }
+    };
+
+    std::smatch match;
+    if (!std::regex_match(_function, match, reFunction)) { return fn; }
+
+    std::string expr = match[1];
+
+    if (std::regex_match(expr, reLiteral)) {
+        if (parseLiteral(expr, fn.a, &fn.boolean)) {
+            fn.kind = NativeFn::Kind::constant;
+        }
+        return fn;
+    }
+
+    if (std::regex_match(expr, match, reProperty)) {
+        fn.kind = NativeFn::Kind::property;
+        fn.keyId = StringIntern::intern(match[1].matched ? match[1] : match[2]);
+        return fn;
+    }
+
+    if (std::regex_match(expr, match, reTernary)) {
+        parseCmp(match[1], fn);
+        fn.operand = std::stod(match[2]);
+        if (parseLiteral(match[3], fn.a, nullptr) &&
+            parseLiteral(match[4], fn.b, nullptr)) {
+            fn.kind = NativeFn::Kind::zoomTernary;
+        }
+        return fn;
+    }
+
+    if (std::regex_match(expr, match, reCompare)) {
+        std::string lhs = match[1];
+        parseCmp(match[2], fn);
+        if (!parseLiteral(match[3], fn.operand, nullptr)) { return fn; }
+
+        // JS compares strings lexicographically; only take equality natively.
+        if (fn.operand.isString() &&
+            fn.cmp != NativeFn::Cmp::eq && fn.cmp != NativeFn::Cmp::ne) {
+            return fn;
+        }
+        if (lhs == "$zoom") {
+            fn.zoomOperand = true;
+        } else {
+            std::smatch key;
+            if (!std::regex_match(lhs, key, reProperty)) { return fn; }
+            fn.keyId = StringIntern::intern(key[1].matched ? key[1] : key[2]);
+        }
+        fn.kind = NativeFn::Kind::compare;
+        return fn;
+    }
+
+    return fn;
+}
+
 void StyleContext::setFeature(const Feature& _feature) {
 
     m_feature = &_feature;
@@ -258,8 +412,12 @@ void StyleContext::setKeyword(const std::string& _key, Value _val) {
     }
 
     // Unset shortcuts in case setKeyword was not called by
-    // the helper functions above.
-    if (_key == key_zoom) { m_keywordZoom = -1; }
+    // the helper functions above. Cached Stops results are only
+    // valid for one zoom.
+    if (_key == key_zoom) {
+        m_keywordZoom = -1;
+        m_stopsCache.clear();
+    }
     if (_key == key_geom) { m_keywordGeom = -1; }
 
     Value& entry = m_keywords[static_cast<uint8_t>(keywordKey)];
@@ -268,6 +426,11 @@ void StyleContext::setKeyword(const std::string& _key, Value _val) {
     if (_val.is<std::string>()) {
         duk_push_string(m_ctx, _val.get<std::string>().c_str());
         duk_put_global_string(m_ctx, _key.c_str());
+    } else if (_val.is<StringView>()) {
+        // Views are not null-terminated, push with explicit length.
+        const auto& view = _val.get<StringView>();
+        duk_push_lstring(m_ctx, view.data, view.length);
+        duk_put_global_string(m_ctx, _key.c_str());
     } else if (_val.is<double>()) {
         duk_push_number(m_ctx, _val.get<double>());
         duk_put_global_string(m_ctx, _key.c_str());
@@ -313,8 +476,138 @@ bool StyleContext::evalFunction(FunctionID id) {
     return true;
 }
 
+static bool truthy(const Value& _v) {
+    if (_v.is<double>()) {
+        double d = _v.get<double>();
+        return d != 0.0 && !std::isnan(d);
+    }
+    if (_v.is<std::string>()) { return !_v.get<std::string>().empty(); }
+    if (_v.is<StringView>()) { return _v.get<StringView>().length != 0; }
+    return false;
+}
+
+static bool stringEqual(const Value& _a, const std::string& _b) {
+    if (_a.is<std::string>()) { return _a.get<std::string>() == _b; }
+    if (_a.is<StringView>()) { return _a.get<StringView>() == _b; }
+    return false;
+}
+
+bool StyleContext::evalNativeCompare(const NativeFn& _fn) const {
+
+    const Value& lhs = _fn.zoomOperand
+        ? getKeyword(FilterKeyword::zoom)
+        : (m_feature ? m_feature->props.get(_fn.keyId) : NOT_A_VALUE);
+
+    double a = 0.0, b = 0.0;
+    bool numeric = false;
+
+    if (lhs.is<double>() && _fn.operand.is<double>()) {
+        a = lhs.get<double>();
+        b = _fn.operand.get<double>();
+        numeric = true;
+    } else if (!_fn.strict && lhs.isString() && _fn.operand.is<double>()) {
+        // Loose '==' coerces the string side to a number, like JS.
+        auto str = lhs.toString();
+        char* end = nullptr;
+        a = std::strtod(str.c_str(), &end);
+        numeric = (end != str.c_str() && *end == '\0');
+        b = _fn.operand.get<double>();
+    }
+
+    if (numeric) {
+        switch (_fn.cmp) {
+        case NativeFn::Cmp::eq: return a == b;
+        case NativeFn::Cmp::ne: return a != b;
+        case NativeFn::Cmp::lt: return a < b;
+        case NativeFn::Cmp::le: return a <= b;
+        case NativeFn::Cmp::gt: return a > b;
+        case NativeFn::Cmp::ge: return a >= b;
+        }
+    }
+
+    if (lhs.isString() && _fn.operand.is<std::string>()) {
+        bool equal = stringEqual(lhs, _fn.operand.get<std::string>());
+        return (_fn.cmp == NativeFn::Cmp::ne) ? !equal : equal;
+    }
+
+    // Mismatched or missing operands only satisfy inequality, as in JS.
+    return _fn.cmp == NativeFn::Cmp::ne;
+}
+
+const Value& StyleContext::evalZoomTernary(const NativeFn& _fn) const {
+
+    const Value& zoom = getKeyword(FilterKeyword::zoom);
+    // An unset $zoom is undefined in JS; all comparisons are false.
+    if (!zoom.is<double>()) { return _fn.b; }
+
+    double z = zoom.get<double>();
+    double t = _fn.operand.get<double>();
+
+    bool cond = false;
+    switch (_fn.cmp) {
+    case NativeFn::Cmp::lt: cond = z < t; break;
+    case NativeFn::Cmp::le: cond = z <= t; break;
+    case NativeFn::Cmp::gt: cond = z > t; break;
+    case NativeFn::Cmp::ge: cond = z >= t; break;
+    default: break;
+    }
+    return cond ? _fn.a : _fn.b;
+}
+
+bool StyleContext::evalNativeFilter(const NativeFn& _fn) const {
+
+    switch (_fn.kind) {
+    case NativeFn::Kind::constant:
+        return truthy(_fn.a);
+    case NativeFn::Kind::property:
+        return m_feature && truthy(m_feature->props.get(_fn.keyId));
+    case NativeFn::Kind::compare:
+        return evalNativeCompare(_fn);
+    case NativeFn::Kind::zoomTernary:
+        return truthy(evalZoomTernary(_fn));
+    default:
+        return false;
+    }
+}
+
+bool StyleContext::evalNativeStyle(const NativeFn& _fn, StyleParamKey _key, StyleParam::Value& _val) const {
+
+    _val = none_type{};
+
+    switch (_fn.kind) {
+    case NativeFn::Kind::constant:
+        if (_fn.boolean) {
+            parseStyleBool(_key, _fn.a.get<double>() != 0.0, _val);
+        } else {
+            parseStyleValue(_key, _fn.a, _val);
+        }
+        break;
+    case NativeFn::Kind::property:
+        if (m_feature) {
+            parseStyleValue(_key, m_feature->props.get(_fn.keyId), _val);
+        }
+        break;
+    case NativeFn::Kind::compare:
+        parseStyleBool(_key, evalNativeCompare(_fn), _val);
+        break;
+    case NativeFn::Kind::zoomTernary:
+        parseStyleValue(_key, evalZoomTernary(_fn), _val);
+        break;
+    default:
+        break;
+    }
+
+    return !_val.is<none_type>();
+}
+
 bool StyleContext::evalFilter(FunctionID _id) {
 
+    // Functions the recognizer understood never touch the duktape heap.
+    if (_id < m_nativeFns.size() &&
+        m_nativeFns[_id].kind != NativeFn::Kind::none) {
+        return evalNativeFilter(m_nativeFns[_id]);
+    }
+
     if (!evalFunction(_id)) { return false; };
 
     // Evaluate the "truthiness" of the function result at the top of the stack.
@@ -326,8 +619,24 @@ bool StyleContext::evalFilter(FunctionID _id) {
     return result;
 }
 
+const StyleParam::Value& StyleContext::evalStops(const Stops& _stops, StyleParamKey _key) {
+
+    auto& entry = m_stopsCache[{ &_stops, static_cast<uint8_t>(_key) }];
+
+    // Stops::eval never yields none_type, so an empty entry is unresolved.
+    if (entry.is<none_type>()) {
+        Stops::eval(_stops, _key, getKeywordZoom(), entry);
+    }
+    return entry;
+}
+
 bool StyleContext::evalStyle(FunctionID _id, StyleParamKey _key, StyleParam::Value& _val) {
 
+    if (_id < m_nativeFns.size() &&
+        m_nativeFns[_id].kind != NativeFn::Kind::none) {
+        return evalNativeStyle(m_nativeFns[_id], _key, _val);
+    }
+
     if (!evalFunction(_id)) { return false; }
 
     // parse evaluated result at stack top
@@ -466,6 +775,61 @@ void StyleContext::parseStyleResult(StyleParamKey _key, StyleParam::Value& _val)
     DUMP("parseStyleResult\n");
 }
 
+// Value-based counterpart of the string and number branches of
+// parseStyleResult, for results produced by native function shortcuts.
+void StyleContext::parseStyleValue(StyleParamKey _key, const Value& _result, StyleParam::Value& _val) const {
+
+    if (_result.isString()) {
+        _val = StyleParam::parseString(_key, _result.toString());
+        return;
+    }
+    if (!_result.is<double>()) { return; }
+
+    double v = _result.get<double>();
+    if (std::isnan(v)) { return; }
+
+    switch (_key) {
+        case StyleParamKey::extrude:
+            _val = glm::vec2(0.f, static_cast<float>(v));
+            break;
+        case StyleParamKey::width:
+        case StyleParamKey::outline_width:
+            _val = StyleParam::Width{static_cast<float>(v)};
+            break;
+        case StyleParamKey::text_font_stroke_width:
+            _val = static_cast<float>(v);
+            break;
+        case StyleParamKey::order:
+        case StyleParamKey::outline_order:
+        case StyleParamKey::priority:
+        case StyleParamKey::color:
+        case StyleParamKey::outline_color:
+        case StyleParamKey::text_font_fill:
+        case StyleParamKey::text_font_stroke_color:
+            _val = static_cast<uint32_t>(v);
+            break;
+        default:
+            break;
+    }
+}
+
+// Value-based counterpart of the boolean branch of parseStyleResult.
+void StyleContext::parseStyleBool(StyleParamKey _key, bool _result, StyleParam::Value& _val) const {
+
+    switch (_key) {
+        case StyleParamKey::interactive:
+        case StyleParamKey::text_interactive:
+        case StyleParamKey::visible:
+            _val = _result;
+            break;
+        case StyleParamKey::extrude:
+            _val = _result ? glm::vec2(NAN, NAN) : glm::vec2(0.0f, 0.0f);
+            break;
+        default:
+            break;
+    }
+}
+
 // Implements Proxy handler.has(target_object, key)
 duk_ret_t StyleContext::jsHasProperty(duk_context *_ctx) {
 
@@ -501,6 +865,9 @@ duk_ret_t StyleContext::jsGetProperty(duk_context *_ctx) {
     auto it = attr->m_feature->props.get(key);
     if (it.is<std::string>()) {
         duk_push_string(_ctx, it.get<std::string>().c_str());
+    } else if (it.is<StringView>()) {
+        const auto& view = it.get<StringView>();
+        duk_push_lstring(_ctx, view.data, view.length);
     } else if (it.is<double>()) {
         duk_push_number(_ctx, it.get<double>());
     } else {
@@ -21,6 +21,7 @@ namespace Tangram {
 class Scene;
 struct Feature;
 struct StyleParam;
+struct Stops;
 
 enum class StyleParamKey : uint8_t;
 enum class FilterKeyword : uint8_t;
@@ -58,6 +59,11 @@ public:
     /* Called from DrawRule::eval */
     bool evalStyle(FunctionID id, StyleParamKey _key, StyleParam::Value& _val);
 
+    /* Called from DrawRule::eval. Within one tile build Stops always
+     * evaluate at the tile zoom, so each (stops, key) pair is resolved
+     * once and then served from a table kept until the zoom changes. */
+    const StyleParam::Value& evalStops(const Stops& _stops, StyleParamKey _key);
+
     /*
      * Setup filter and style functions from @_scene
      */
@@ -68,14 +74,57 @@ public:
      */
     void clear();
 
-    bool setFunctions(const std::vector<std::string>& _functions);
+    bool setFunctions(const std::vector<std::string>& _functions,
+                      const std::vector<std::string>* _bytecode = nullptr);
     bool addFunction(const std::string& _function);
+
+    /* Compile _functions once into duktape bytecode that can be loaded
+     * into any context, so per-worker contexts skip parsing and compiling
+     * every scene function again. Returns one blob per function; a
+     * function that fails to compile yields an empty blob and is compiled
+     * from source (with the warning) in setFunctions(). */
+    static std::vector<std::string> compileFunctions(const std::vector<std::string>& _functions);
     void setSceneGlobals(const YAML::Node& sceneGlobals);
 
     void setKeyword(const std::string& _key, Value _value);
     const Value& getKeyword(const std::string& _key) const;
 
 private:
+
+    /* Native shortcut for a trivial scene function (constant, property
+     * lookup or simple comparison), filled in by recognize() at scene
+     * load. Only functions the recognizer does not understand pay for a
+     * duktape round trip per feature. */
+    struct NativeFn {
+        enum class Kind : uint8_t {
+            none,         // not recognized - evaluate in duktape
+            constant,     // return <literal>
+            property,     // return feature.<key>
+            compare,      // return feature.<key>|$zoom <cmp> <literal>
+            zoomTernary,  // return $zoom <cmp> <number> ? <a> : <b>
+        };
+        enum class Cmp : uint8_t { eq, ne, lt, le, gt, ge };
+
+        Kind kind = Kind::none;
+        Cmp cmp = Cmp::eq;
+        bool strict = false;      // === / !== comparison
+        bool zoomOperand = false; // compare against $zoom instead of a property
+        bool boolean = false;     // 'a' holds a boolean literal
+        uint32_t keyId = 0;       // interned feature property key
+        Value operand;            // comparison operand
+        Value a;                  // constant value / ternary consequent
+        Value b;                  // ternary alternative
+    };
+
+    static NativeFn recognize(const std::string& _function);
+
+    bool evalNativeFilter(const NativeFn& _fn) const;
+    bool evalNativeStyle(const NativeFn& _fn, StyleParamKey _key, StyleParam::Value& _val) const;
+    bool evalNativeCompare(const NativeFn& _fn) const;
+    const Value& evalZoomTernary(const NativeFn& _fn) const;
+    void parseStyleValue(StyleParamKey _key, const Value& _result, StyleParam::Value& _val) const;
+    void parseStyleBool(StyleParamKey _key, bool _result, StyleParam::Value& _val) const;
+
     static int jsGetProperty(duk_context *_ctx);
     static int jsHasProperty(duk_context *_ctx);
 
@@ -83,6 +132,11 @@ private:
     void parseStyleResult(StyleParamKey _key, StyleParam::Value& _val) const;
     void parseSceneGlobals(const YAML::Node& node);
 
+    std::vector<NativeFn> m_nativeFns;
+
+    // Per-zoom Stops results; cleared by setKeywordZoom
+    fastmap_soa<std::pair<const Stops*, uint8_t>, StyleParam::Value> m_stopsCache;
+
     std::array<Value, 4> m_keywords;
     int m_keywordGeom= -1;
     int m_keywordZoom = -1;
@@ -1,5 +1,6 @@
 #include "styleMixer.h"
 #include "style/style.h"
+#include "util/hash.h"
 #include "util/topologicalSort.h"
 #include "yaml-cpp/yaml.h"
 
@@ -8,6 +9,9 @@
 
 namespace Tangram {
 
+std::mutex StyleMixer::s_cacheMutex;
+std::map<size_t, StyleMixer::Node> StyleMixer::s_mixCache;
+
 std::vector<std::string> StyleMixer::getStylesToMix(const Node& _style) {
 
     std::vector<std::string> names;
@@ -82,7 +86,32 @@ void StyleMixer::mixStyleNodes(Node _styles) {
             mixins.push_back(_styles[styleNameToMix]);
         }
 
+        // Styles are processed in mixing order, so the mixins are final
+        // at this point and their serialized content captures the whole
+        // transitive mix input of this style.
+        size_t mixHash = std::hash<std::string>()(YAML::Dump(style));
+        for (const auto& mixin : mixins) {
+            if (mixin.IsDefined()) {
+                hash_combine(mixHash, std::hash<std::string>()(YAML::Dump(mixin)));
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(s_cacheMutex);
+            auto it = s_mixCache.find(mixHash);
+            if (it != s_mixCache.end()) {
+                _styles[name] = YAML::Clone(it->second);
+                continue;
+            }
+        }
+
         applyStyleMixins(style, mixins);
+
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        if (s_mixCache.size() >= MAX_CACHED_STYLES) {
+            s_mixCache.clear();
+        }
+        s_mixCache.emplace(mixHash, YAML::Clone(style));
     }
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -38,6 +40,14 @@ public:
 
 private:
 
+    // Mixed style nodes keyed by a hash of the style's pre-mix content
+    // and its mixins' mixed content, shared by all mixers. Scene updates
+    // that leave a style and its mixins untouched then skip the deep
+    // node merging and reuse a clone of the earlier result.
+    static std::mutex s_cacheMutex;
+    static std::map<size_t, Node> s_mixCache;
+    static const size_t MAX_CACHED_STYLES = 64;
+
     void mergeBooleanFieldAsDisjunction(const std::string& _key, Node _target, const std::vector<Node>& _sources);
 
     void mergeFieldTakingLast(const std::string& _key, Node _target, const std::vector<Node>& _sources);
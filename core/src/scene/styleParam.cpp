@@ -9,6 +9,7 @@
 #include "log.h"
 #include <algorithm>
 #include <map>
+#include <mutex>
 #include <cstring>
 
 namespace Tangram {
@@ -99,6 +100,12 @@ const std::map<StyleParamKey, std::vector<Unit>> s_StyleParamUnits = {
     {StyleParamKey::outline_width, {Unit::meter, Unit::pixel}}
 };
 
+// Parsed values, memoized across scene loads: stylesheets repeat the
+// same literal strings across many rules, and a reload parses the whole
+// scene again, so most constructions reduce to a single lookup here.
+static std::mutex s_parseCacheMutex;
+static std::map<std::pair<StyleParamKey, std::string>, StyleParam::Value> s_parseCache;
+
 static int parseInt(const std::string& _str, int& _value) {
     try {
         size_t index;
@@ -148,7 +155,13 @@ StyleParam::StyleParam(const std::string& _key, const std::string& _value) {
         return;
     }
     if (!_value.empty()) {
-        value = parseString(key, _value);
+        std::lock_guard<std::mutex> lock(s_parseCacheMutex);
+
+        auto entry = s_parseCache.emplace(std::make_pair(key, _value), none_type{});
+        if (entry.second) {
+            entry.first->second = parseString(key, _value);
+        }
+        value = entry.first->second;
     }
 }
 
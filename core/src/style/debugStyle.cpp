@@ -7,6 +7,7 @@
 #include "gl/shaderProgram.h"
 #include "gl/mesh.h"
 
+#include <cmath>
 #include <vector>
 #include <memory>
 #include <string>
@@ -24,8 +25,13 @@ struct PosColVertex {
 };
 
 
-DebugStyle::DebugStyle(std::string _name, Blending _blendMode, GLenum _drawMode)
-    : Style(_name, _blendMode, _drawMode) {}
+DebugStyle::DebugStyle(std::string _name, Blending _blendMode, GLenum _drawMode, bool _heatmap)
+    : Style(_name, _blendMode, _drawMode),
+      m_heatmap(_heatmap) {
+
+    // The debug shaders have no lighting or material blocks
+    m_lightingType = LightingType::none;
+}
 
 void DebugStyle::constructVertexLayout() {
 
@@ -47,10 +53,51 @@ struct DebugStyleBuilder : public StyleBuilder {
 
     const DebugStyle& m_style;
 
-    void setup(const Tile& _tile) override {}
-    void setup(const Marker& _marker, int zoom) override {}
+    const Tile* m_tile = nullptr;
+
+    void setup(const Tile& _tile) override { m_tile = &_tile; }
+    void setup(const Marker& _marker, int zoom) override { m_tile = nullptr; }
+
+    std::unique_ptr<StyledMesh> buildHeatmap() {
+        if (!Tangram::getDebugFlag(Tangram::DebugFlags::tile_heatmap)) {
+            return nullptr;
+        }
+
+        // Feature counts are final once the mesh build stage starts, the
+        // rest of the tile's stats is not; see TileBuilder::build
+        const TileBuildStats* stats = m_tile ? m_tile->buildStats() : nullptr;
+        if (!stats) { return nullptr; }
+
+        size_t features = 0;
+        for (const auto& entry : stats->styles) {
+            features += entry.features;
+        }
+
+        // Green through yellow to red on a log scale, saturating at 4096
+        // features per tile
+        float t = std::min(std::log2(1.f + features) / 12.f, 1.f);
+        GLuint r = GLuint(std::min(2.f * t, 1.f) * 255.f);
+        GLuint g = GLuint(std::min(2.f - 2.f * t, 1.f) * 255.f);
+        GLuint abgr = 0x60000000 | (g << 8) | r;
+
+        auto mesh = std::make_unique<Mesh<PosColVertex>>(m_style.vertexLayout(),
+                                                         m_style.drawMode());
+
+        // One translucent quad over the tile
+        mesh->compile({{ 0, 1, 2, 3 },
+                       {{{ 0.f, 0.f, 0.f }, abgr },
+                        {{ 1.f, 0.f, 0.f }, abgr },
+                        {{ 0.f, 1.f, 0.f }, abgr },
+                        {{ 1.f, 1.f, 0.f }, abgr }}});
+
+        return std::move(mesh);
+    }
 
     std::unique_ptr<StyledMesh> build() override {
+        if (m_style.heatmap()) {
+            return buildHeatmap();
+        }
+
         if (!Tangram::getDebugFlag(Tangram::DebugFlags::tile_bounds)) {
             return nullptr;
         }
@@ -15,11 +15,21 @@ protected:
 
 public:
 
-    DebugStyle(std::string _name, Blending _blendMode = Blending::overlay, GLenum _drawMode = GL_LINE_LOOP);
+    DebugStyle(std::string _name, Blending _blendMode = Blending::overlay, GLenum _drawMode = GL_LINE_LOOP,
+               bool _heatmap = false);
+
+    /* Whether this instance tints tiles by the content counters recorded
+     * at build time (see DebugFlags::tile_heatmap) instead of drawing
+     * tile bounds */
+    bool heatmap() const { return m_heatmap; }
 
     virtual ~DebugStyle() {
     }
 
+private:
+
+    bool m_heatmap = false;
+
 };
 
 }
@@ -17,6 +17,9 @@ PointStyle::PointStyle(std::string _name, std::shared_ptr<FontContext> _fontCont
                        Blending _blendMode, GLenum _drawMode)
     : Style(_name, _blendMode, _drawMode) {
 
+    // The point shaders have no lighting or material blocks
+    m_lightingType = LightingType::none;
+
     m_textStyle = std::make_unique<TextStyle>(_name, _fontContext, true, _blendMode, _drawMode);
 }
 
@@ -206,25 +206,42 @@ void PointStyleBuilder::addLabel(const Point& _point, const glm::vec4& _quad,
         _params.color});
 }
 
+bool PointStyleBuilder::findSpriteIndex(const std::string& _name, size_t& _index) const {
+
+    if (_name.empty()) { return false; }
+
+    if (_name == m_lastSprite) {
+        _index = m_lastSpriteIndex;
+        return true;
+    }
+
+    if (!m_style.spriteAtlas()->getSpriteIndex(_name, _index)) {
+        return false;
+    }
+
+    m_lastSprite = _name;
+    m_lastSpriteIndex = _index;
+    return true;
+}
+
 bool PointStyleBuilder::getUVQuad(PointStyle::Parameters& _params, glm::vec4& _quad) const {
     _quad = glm::vec4(0.0, 0.0, 1.0, 1.0);
 
     if (m_style.spriteAtlas()) {
-        SpriteNode spriteNode;
+        size_t spriteIndex;
 
-        if (!m_style.spriteAtlas()->getSpriteNode(_params.sprite, spriteNode) &&
-            !m_style.spriteAtlas()->getSpriteNode(_params.spriteDefault, spriteNode)) {
+        if (!findSpriteIndex(_params.sprite, spriteIndex) &&
+            !findSpriteIndex(_params.spriteDefault, spriteIndex)) {
             return false;
         }
 
+        const SpriteNode& spriteNode = m_style.spriteAtlas()->getSpriteNode(spriteIndex);
+
         if (std::isnan(_params.size.x)) {
             _params.size = spriteNode.m_size;
         }
 
-        _quad.x = spriteNode.m_uvBL.x;
-        _quad.y = spriteNode.m_uvBL.y;
-        _quad.z = spriteNode.m_uvTR.x;
-        _quad.w = spriteNode.m_uvTR.y;
+        _quad = spriteNode.m_uvQuad;
     } else {
         // default point size
         if (std::isnan(_params.size.x)) {
@@ -40,6 +40,11 @@ struct PointStyleBuilder : public StyleBuilder {
 
     bool getUVQuad(PointStyle::Parameters& _params, glm::vec4& _quad) const;
 
+    // Resolve a sprite name against the style's atlas through a
+    // one-entry cache: POI-dense tiles repeat the same handful of names
+    // thousands of times per build, so most features skip the map probe.
+    bool findSpriteIndex(const std::string& _name, size_t& _index) const;
+
     PointStyle::Parameters applyRule(const DrawRule& _rule, const Properties& _props) const;
 
     void addLabel(const Point& _point, const glm::vec4& _quad,
@@ -62,6 +67,10 @@ private:
     // Non-owning reference to a texture to use for the current feature.
     Texture* m_texture = nullptr;
 
+    // Last resolved sprite name and its atlas index
+    mutable std::string m_lastSprite;
+    mutable size_t m_lastSpriteIndex = 0;
+
 };
 
 }
@@ -5,6 +5,7 @@
 #include "material.h"
 #include "util/builders.h"
 #include "util/extrude.h"
+#include "util/meshOptimizer.h"
 #include "gl/shaderProgram.h"
 #include "gl/mesh.h"
 #include "tile/tile.h"
@@ -96,12 +97,14 @@ public:
         m_tileUnitsPerMeter = _tile.getInverseScale();
         m_zoom = _tile.getID().z;
         m_meshData.clear();
+        m_builder.earcutCache.clear();
     }
 
     void setup(const Marker& _marker, int zoom) override {
         m_zoom = zoom;
         m_tileUnitsPerMeter = 1.f / _marker.extent();
         m_meshData.clear();
+        m_builder.earcutCache.clear();
     }
 
     void addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) override;
@@ -133,6 +136,10 @@ template <class V>
 std::unique_ptr<StyledMesh> PolygonStyleBuilder<V>::build() {
     if (m_meshData.vertices.empty()) { return nullptr; }
 
+    if (m_style.meshOptimization()) {
+        MeshOptimizer::optimize(m_meshData);
+    }
+
     auto mesh = std::make_unique<Mesh<V>>(m_style.vertexLayout(),
                                                       m_style.drawMode());
     mesh->compile(m_meshData);
@@ -162,12 +169,6 @@ void PolygonStyleBuilder<V>::addPolygon(const Polygon& _polygon, const Propertie
 
     parseRule(_rule, _props);
 
-    m_builder.addVertex = [this](const glm::vec3& coord,
-                                 const glm::vec3& normal,
-                                 const glm::vec2& uv) {
-        m_meshData.vertices.push_back({ coord, m_params.order, normal, uv, m_params.color });
-    };
-
     if (m_params.minHeight != m_params.height) {
         Builders::buildPolygonExtrusion(_polygon, m_params.minHeight,
                                         m_params.height, m_builder);
@@ -175,6 +176,14 @@ void PolygonStyleBuilder<V>::addPolygon(const Polygon& _polygon, const Propertie
 
     Builders::buildPolygon(_polygon, m_params.height, m_builder);
 
+    // Copy the batch into the typed vertex buffer in one tight loop,
+    // with order and color constant per polygon.
+    m_meshData.vertices.reserve(m_meshData.vertices.size() + m_builder.vertices.size());
+
+    for (const auto& v : m_builder.vertices) {
+        m_meshData.vertices.push_back({ v.coord, m_params.order, v.normal, v.uv, m_params.color });
+    }
+
     m_meshData.indices.insert(m_meshData.indices.end(),
                               m_builder.indices.begin(),
                               m_builder.indices.end());
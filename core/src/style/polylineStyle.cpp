@@ -13,6 +13,7 @@
 #include "tile/tile.h"
 #include "util/builders.h"
 #include "util/mapProjection.h"
+#include "util/meshOptimizer.h"
 #include "util/extrude.h"
 #include "util/dashArray.h"
 #include "log.h"
@@ -94,10 +95,22 @@ void PolylineStyle::onBeginDrawFrame(RenderState& rs, const View& _view, Scene&
         m_texture->bind(rs, textureUnit);
 
         m_shaderProgram->setUniformi(rs, m_uTexture, textureUnit);
-        m_shaderProgram->setUniformf(rs, m_uTextureRatio, m_texture->getHeight() / m_texture->getWidth());
+        // For a region of a shared dash texture the repeat period is the
+        // pattern's own row count, not the full texture height
+        float ratio = m_dashPatternRows > 0 ? m_dashPatternRows
+            : m_texture->getHeight() / m_texture->getWidth();
+        m_shaderProgram->setUniformf(rs, m_uTextureRatio, ratio);
+        m_shaderProgram->setUniformf(rs, m_uTextureRegion, m_textureRegion);
     }
 }
 
+void PolylineStyle::setDashTexture(std::shared_ptr<Texture> _texture, int _offset, int _rows) {
+    m_texture = _texture;
+    m_dashPatternRows = _rows;
+    float height = _texture->getHeight();
+    m_textureRegion = { _offset / height, _rows / height };
+}
+
 void PolylineStyle::setDashBackgroundColor(const glm::vec4 _dashBackgroundColor) {
     m_dashBackgroundColor = _dashBackgroundColor;
     m_dashBackground = true;
@@ -106,11 +119,15 @@ void PolylineStyle::setDashBackgroundColor(const glm::vec4 _dashBackgroundColor)
 void PolylineStyle::constructShaderProgram() {
 
     if (m_dashArray.size() > 0) {
-        TextureOptions options {GL_RGBA, GL_RGBA, {GL_NEAREST, GL_NEAREST}, {GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE}};
-        auto pixels = DashArray::render(m_dashArray);
-
-        m_texture = std::make_shared<Texture>(1, pixels.size(), options);
-        m_texture->setData(pixels.data(), pixels.size());
+        // Scenes pack the dash patterns of all styles into one shared
+        // texture; render a texture here only when the style was set up
+        // without the loader (see SceneLoader::applyConfig)
+        if (!m_texture) {
+            auto pixels = DashArray::render(m_dashArray);
+
+            m_texture = std::make_shared<Texture>(1, pixels.size(), TextureOptions::nearestRgba());
+            m_texture->setData(pixels.data(), pixels.size());
+        }
 
         if (m_dashBackground) {
             m_shaderProgram->addSourceBlock("defines", "#define TANGRAM_LINE_BACKGROUND_COLOR vec3(" +
@@ -125,6 +142,10 @@ void PolylineStyle::constructShaderProgram() {
         m_shaderProgram->addSourceBlock("defines", "#define TANGRAM_ALPHA_TEST 0.25\n", false);
     }
 
+    if (m_fragmentRounds) {
+        m_shaderProgram->addSourceBlock("defines", "#define TANGRAM_LINE_FRAGMENT_ROUNDS\n", false);
+    }
+
     m_shaderProgram->setSourceStrings(SHADER_SOURCE(polyline_fs),
                                       SHADER_SOURCE(polyline_vs));
 
@@ -237,6 +258,11 @@ std::unique_ptr<StyledMesh> PolylineStyleBuilder<V>::build() {
         return nullptr;
     }
 
+    if (m_style.meshOptimization()) {
+        MeshOptimizer::optimize(m_meshData[0]);
+        MeshOptimizer::optimize(m_meshData[1]);
+    }
+
     auto mesh = std::make_unique<Mesh<V>>(m_style.vertexLayout(), m_style.drawMode());
 
     bool painterMode = (m_style.blendMode() == Blending::overlay ||
@@ -410,13 +436,18 @@ void PolylineStyleBuilder<V>::buildLine(const Line& _line, const typename Parame
                         MeshData<V>& _mesh) {
 
     float zoom = m_overzoom2;
-    m_builder.addVertex = [&](const glm::vec3& coord, const glm::vec2& normal, const glm::vec2& uv) {
-        _mesh.vertices.push_back({{ coord.x,coord.y }, normal, { uv.x, uv.y * zoom },
-                                  _att.width, _att.height, _att.color});
-    };
 
     Builders::buildPolyLine(_line, m_builder);
 
+    // Copy the batch into the typed vertex buffer in one go; with the
+    // attributes constant per line this loop boils down to plain stores.
+    _mesh.vertices.reserve(_mesh.vertices.size() + m_builder.vertices.size());
+
+    for (const auto& v : m_builder.vertices) {
+        _mesh.vertices.push_back({{ v.coord.x, v.coord.y }, v.enormal, { v.uv.x, v.uv.y * zoom },
+                                  _att.width, _att.height, _att.color});
+    }
+
     _mesh.indices.insert(_mesh.indices.end(),
                          m_builder.indices.begin(),
                          m_builder.indices.end());
@@ -481,10 +512,12 @@ std::unique_ptr<StyleBuilder> PolylineStyle::createBuilder() const {
     if (m_texCoordsGeneration) {
         auto builder = std::make_unique<PolylineStyleBuilder<PolylineVertex>>(*this);
         builder->polylineBuilder().useTexCoords = true;
+        builder->polylineBuilder().fragmentRounds = m_fragmentRounds;
         return std::move(builder);
     } else {
         auto builder = std::make_unique<PolylineStyleBuilder<PolylineVertexNoUVs>>(*this);
         builder->polylineBuilder().useTexCoords = false;
+        builder->polylineBuilder().fragmentRounds = m_fragmentRounds;
         return std::move(builder);
     }
 }
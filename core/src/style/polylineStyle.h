@@ -23,15 +23,35 @@ public:
 
     void setDashBackgroundColor(const glm::vec4 _dashBackgroundColor);
 
+    const std::vector<int>& dashArray() const { return m_dashArray; }
+
+    // Assign this style's row range within a dash texture shared across
+    // styles; _offset and _rows are measured in pixel rows of _texture.
+    void setDashTexture(std::shared_ptr<Texture> _texture, int _offset, int _rows);
+
+    // Carve round caps and joins in the fragment shader instead of
+    // tessellating vertex fans ('rounds: fragment' in the scene file).
+    // Every line of the style draws with round ends, the per-rule cap
+    // and join parameters are ignored.
+    void setFragmentRounds(bool _enable) { m_fragmentRounds = _enable; }
+
 private:
 
     std::vector<int> m_dashArray;
     std::shared_ptr<Texture> m_texture;
     bool m_dashBackground = false;
+    bool m_fragmentRounds = false;
     glm::vec4 m_dashBackgroundColor;
 
+    // Repeat period of the dash pattern in texture rows; 0 when the line
+    // texture is not a region of a shared dash texture.
+    float m_dashPatternRows = 0;
+    // Normalized v-offset and v-scale of this style's region
+    glm::vec2 m_textureRegion = { 0, 1 };
+
     UniformLocation m_uTexture{"u_texture"};
     UniformLocation m_uTextureRatio{"u_texture_ratio"};
+    UniformLocation m_uTextureRegion{"u_texture_region"};
 };
 
 }
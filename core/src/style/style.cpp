@@ -62,7 +62,9 @@ void Style::build(const Scene& _scene) {
         m_shaderProgram->addSourceBlock("defines", "#define TANGRAM_BLEND_OVERLAY\n", false);
     }
 
-    if (m_material.material) {
+    // The material block is only referenced from the lighting functions, so
+    // unlit styles compile without it and skip its uniform uploads per frame
+    if (m_material.material && m_lightingType != LightingType::none) {
         m_material.uniforms = m_material.material->injectOnProgram(*m_shaderProgram);
     }
 
@@ -194,16 +196,24 @@ void Style::onBeginDrawFrame(RenderState& rs, const View& _view, Scene& _scene)
         light.light->setupProgram(rs, _view, *light.uniforms);
     }
 
-    // Set Map Position
-    m_shaderProgram->setUniformf(rs, m_uResolution, _view.getWidth(), _view.getHeight());
+    // Set Map Position. The view uniforms only change when the view does,
+    // so frames with an unchanged view skip their uploads and cache probes
+    if (m_frameUniformGeneration != _view.stateGeneration() ||
+        m_frameUniformRSGeneration != rs.generation()) {
 
-    const auto& mapPos = _view.getPosition();
-    m_shaderProgram->setUniformf(rs, m_uMapPosition, mapPos.x, mapPos.y, _view.getZoom());
-    m_shaderProgram->setUniformMatrix3f(rs, m_uNormalMatrix, _view.getNormalMatrix());
-    m_shaderProgram->setUniformMatrix3f(rs, m_uInverseNormalMatrix, _view.getInverseNormalMatrix());
-    m_shaderProgram->setUniformf(rs, m_uMetersPerPixel, 1.0 / _view.pixelsPerMeter());
-    m_shaderProgram->setUniformMatrix4f(rs, m_uView, _view.getViewMatrix());
-    m_shaderProgram->setUniformMatrix4f(rs, m_uProj, _view.getProjectionMatrix());
+        m_frameUniformGeneration = _view.stateGeneration();
+        m_frameUniformRSGeneration = rs.generation();
+
+        m_shaderProgram->setUniformf(rs, m_uResolution, _view.getWidth(), _view.getHeight());
+
+        const auto& mapPos = _view.getPosition();
+        m_shaderProgram->setUniformf(rs, m_uMapPosition, mapPos.x, mapPos.y, _view.getZoom());
+        m_shaderProgram->setUniformMatrix3f(rs, m_uNormalMatrix, _view.getNormalMatrix());
+        m_shaderProgram->setUniformMatrix3f(rs, m_uInverseNormalMatrix, _view.getInverseNormalMatrix());
+        m_shaderProgram->setUniformf(rs, m_uMetersPerPixel, 1.0 / _view.pixelsPerMeter());
+        m_shaderProgram->setUniformMatrix4f(rs, m_uView, _view.getViewMatrix());
+        m_shaderProgram->setUniformMatrix4f(rs, m_uProj, _view.getProjectionMatrix());
+    }
 
     setupShaderUniforms(rs, _scene);
 
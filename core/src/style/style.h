@@ -51,9 +51,28 @@ enum class RasterType {
 };
 
 struct StyledMesh {
-    virtual bool draw(RenderState& rs, ShaderProgram& _shader) = 0;
+    /* Draw the mesh with the given shader. Recorded VAOs bind attributes
+     * at the canonical locations shared by all programs, so they apply
+     * regardless of which program _shader is. */
+    virtual bool draw(RenderState& rs, ShaderProgram& _shader, bool _useVao = true) = 0;
     virtual size_t bufferSize() const = 0;
 
+    /* Whether the compiled geometry has reached the GPU; meshes that
+     * upload on first draw report false until then. */
+    virtual bool isUploaded() const { return true; }
+
+    /* Number of vertices in the compiled buffers; label sets, which own
+     * no buffers of their own, report 0 */
+    virtual size_t vertexCount() const { return 0; }
+
+    /* Number of labels owned by the mesh; only label sets report any */
+    virtual size_t labelCount() const { return 0; }
+
+    /* Append the compiled vertex and index data of this mesh to _out.
+     * Returns false for meshes that cannot be rebuilt from raw buffers
+     * (e.g. label meshes) or whose data was already uploaded. */
+    virtual bool serialize(std::vector<char>& _out) const { return false; }
+
     virtual ~StyledMesh() {}
 };
 
@@ -88,8 +107,18 @@ public:
 
     virtual const Style& style() const = 0;
 
+    /* Features this builder received since the last clear, counted at the
+     * draw rule dispatch and recorded into the tile's build stats */
+    size_t featureCount() const { return m_featureCount; }
+
+    void countFeature() { m_featureCount++; }
+
+    void clearFeatureCount() { m_featureCount = 0; }
+
 protected:
     bool m_hasColorShaderBlock = false;
+
+    size_t m_featureCount = 0;
 };
 
 /* Means of constructing and rendering map geometry
@@ -133,9 +162,21 @@ protected:
     /* animated property */
     bool m_animated = false;
 
+    /* Whether the style runs a depth-only pre-pass before its color pass */
+    bool m_depthPrepass = false;
+
     /* Whether the style should generate texture coordinates */
     bool m_texCoordsGeneration = false;
 
+    /* Whether builders run the vertex welding and cache reordering pass
+     * on finished meshes before upload (see util/meshOptimizer.h). Only
+     * honored by styles whose meshes stay static after the build. */
+    bool m_meshOptimization = false;
+
+    /* Whether the quality governor may skip drawing this style to shed
+     * GPU load under thermal or frame-time pressure ('optional: true') */
+    bool m_optional = false;
+
     /* Set uniform values when @_updateUniforms is true,
      */
     void setupShaderUniforms(RenderState& rs, Scene& _scene);
@@ -160,6 +201,11 @@ protected:
 
     RasterType m_rasterType = RasterType::none;
 
+    // View state generation the view uniforms were last uploaded for, paired
+    // with the render state generation to re-upload after context loss
+    int64_t m_frameUniformGeneration = -1;
+    int m_frameUniformRSGeneration = -1;
+
 private:
 
     std::vector<StyleUniform> m_styleUniforms;
@@ -217,6 +263,14 @@ public:
     /* Whether or not the style is animated */
     bool isAnimated() { return m_animated; }
 
+    void setDepthPrepass(bool _prepass) { m_depthPrepass = _prepass; }
+
+    /* Whether to lay down final depth with color writes off before the color
+     * pass. Only meaningful for opaque styles: the color pass then runs with
+     * GL_LEQUAL and early-z rejects every hidden fragment, which bounds
+     * overdraw on fill-limited GPUs at the cost of a second geometry pass. */
+    bool depthPrepass() const { return m_depthPrepass && m_blend == Blending::opaque; }
+
     /* Make this style ready to be used (call after all needed properties are set) */
     virtual void build(const Scene& _scene);
 
@@ -261,6 +315,14 @@ public:
 
     bool genTexCoords() const { return m_texCoordsGeneration; }
 
+    void setMeshOptimization(bool _optimize) { m_meshOptimization = _optimize; }
+
+    bool meshOptimization() const { return m_meshOptimization; }
+
+    void setOptional(bool _optional) { m_optional = _optional; }
+
+    bool isOptional() const { return m_optional; }
+
     void setID(uint32_t _id) { m_id = _id; }
 
     std::shared_ptr<Material> getMaterial() { return m_material.material; }
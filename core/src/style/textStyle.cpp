@@ -19,7 +19,11 @@ namespace Tangram {
 TextStyle::TextStyle(std::string _name, std::shared_ptr<FontContext> _fontContext,
                      bool _sdf, Blending _blendMode, GLenum _drawMode)
     : Style(_name, _blendMode, _drawMode), m_sdf(_sdf),
-      m_context(_fontContext ? _fontContext : std::make_shared<FontContext>()) {}
+      m_context(_fontContext ? _fontContext : std::make_shared<FontContext>()) {
+
+    // The text shaders have no lighting or material blocks
+    m_lightingType = LightingType::none;
+}
 
 TextStyle::~TextStyle() {}
 
@@ -27,6 +31,8 @@ void TextStyle::constructVertexLayout() {
     m_vertexLayout = std::shared_ptr<VertexLayout>(new VertexLayout({
         {"a_position", 2, GL_SHORT, false, 0},
         {"a_uv", 2, GL_UNSIGNED_SHORT, false, 0},
+        {"a_screen_origin", 2, GL_SHORT, false, 0},
+        {"a_rotation", 2, GL_SHORT, true, 0},
         {"a_color", 4, GL_UNSIGNED_BYTE, true, 0},
         {"a_stroke", 4, GL_UNSIGNED_BYTE, true, 0},
         {"a_alpha", 1, GL_UNSIGNED_SHORT, true, 0},
@@ -80,18 +86,7 @@ void TextStyle::onBeginDrawFrame(RenderState& rs, const View& _view, Scene& _sce
     m_shaderProgram->setUniformi(rs, m_uTex, texUnit);
     m_shaderProgram->setUniformMatrix4f(rs, m_uOrtho, _view.getOrthoViewportMatrix());
 
-    if (m_sdf) {
-        m_shaderProgram->setUniformi(rs, m_uPass, 1);
-
-        for (size_t i = 0; i < m_meshes.size(); i++) {
-            if (m_meshes[i]->isReady()) {
-                m_context->bindTexture(rs, i, texUnit);
-                m_meshes[i]->draw(rs, *m_shaderProgram);
-            }
-        }
-        m_shaderProgram->setUniformi(rs, m_uPass, 0);
-    }
-
+    // Fill and stroke of SDF text render in one pass, see sdf.fs
     for (size_t i = 0; i < m_meshes.size(); i++) {
         if (m_meshes[i]->isReady()) {
             m_context->bindTexture(rs, i, texUnit);
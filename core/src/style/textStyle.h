@@ -51,7 +51,6 @@ protected:
     UniformLocation m_uTexScaleFactor{"u_uv_scale_factor"};
     UniformLocation m_uTex{"u_tex"};
     UniformLocation m_uOrtho{"u_ortho"};
-    UniformLocation m_uPass{"u_pass"};
     UniformLocation m_uMaxStrokeWidth{"u_max_stroke_width"};
 
     mutable std::vector<std::unique_ptr<DynamicQuadMesh<TextVertex>>> m_meshes;
@@ -19,11 +19,25 @@
 #include <locale>
 #include <mutex>
 #include <algorithm>
+#include <unordered_map>
 
 namespace Tangram {
 
 const static std::string key_name("name");
 
+// Process-wide registry assigning small sequential ids to repeat-group
+// hashes. Ids keep equality across tiles and styles, while the
+// render-time group bookkeeping gets a dense, pre-sorted integer map
+// instead of hashing. Id 0 is reserved for 'no repeat group'.
+static size_t internRepeatGroup(size_t _hash) {
+    static std::mutex mutex;
+    static std::unordered_map<size_t, size_t> groups;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto entry = groups.emplace(_hash, groups.size() + 1);
+    return entry.first->second;
+}
+
 TextStyleBuilder::TextStyleBuilder(const TextStyle& _style)
     : StyleBuilder(_style),
       m_style(_style) {}
@@ -228,33 +242,51 @@ void TextStyleBuilder::addLineTextLabels(const Feature& _feat, const TextStyle::
 
     for (auto& line : _feat.lines) {
 
-        for (size_t i = 0; i < line.size() - 1; i++) {
-            glm::vec2 p1 = glm::vec2(line[i]);
-            glm::vec2 p2;
+        if (line.size() < 2) { continue; }
+
+        // Packed copy for the batch distance kernel
+        m_linePoints.clear();
+        for (auto& point : line) { m_linePoints.emplace_back(point); }
+        auto& points = m_linePoints;
+
+        for (size_t i = 0; i < points.size() - 1; i++) {
+            glm::vec2 p1 = points[i];
 
-            float segmentLength = 0;
-            bool merged = false;
             size_t next = i+1;
+            glm::vec2 p2 = points[next];
+
+            float segmentLength = glm::length(p1 - p2);
+            if (segmentLength > minLength) {
+                addLabel(_params, Label::Type::line, { p1, p2 });
+            }
 
-            for (size_t j = next; j < line.size(); j++) {
-                glm::vec2 p = glm::vec2(line[j]);
-                segmentLength = glm::length(p1 - p);
+            // Merge the following segments while their shared points stay
+            // within tolerance of the straightened segment; the distances
+            // of each candidate are evaluated blockwise with the batch
+            // kernel, fanning out from p1.
+            constexpr size_t block = 16;
+            float dist[block];
 
-                if (j == next) {
-                    if (segmentLength > minLength) {
-                        addLabel(_params, Label::Type::line, { p1, p });
-                    }
-                } else {
-                    glm::vec2 pp = glm::vec2(line[j-1]);
+            bool merged = false;
+            bool open = true;
 
-                    float d = sqPointSegmentDistance(pp, p1, p);
-                    if (d > tolerance) { break; }
+            for (size_t j = next + 1; open && j < points.size(); j += block) {
+                size_t n = std::min(block, points.size() - j);
 
+                sqPointSegmentDistances(&points[j-1], p1, &points[j], n, dist);
+
+                for (size_t k = 0; k < n; k++) {
+                    segmentLength = glm::length(p1 - points[j + k]);
+
+                    if (dist[k] > tolerance) {
+                        open = false;
+                        break;
+                    }
                     // Skip merged segment
                     merged = true;
                     i += 1;
+                    p2 = points[j + k];
                 }
-                p2 = p;
             }
 
             // place labels at segment-subdivisions
@@ -377,7 +409,7 @@ TextStyle::Parameters TextStyleBuilder::applyRule(const DrawRule& _rule,
     }
 
     hash_combine(repeatGroupHash, p.text);
-    p.labelOptions.repeatGroup = repeatGroupHash;
+    p.labelOptions.repeatGroup = internRepeatGroup(repeatGroupHash);
     p.labelOptions.repeatDistance *= m_style.pixelScale();
 
     if (p.interactive) {
@@ -63,6 +63,10 @@ protected:
     std::bitset<FontContext::max_textures> m_atlasRefs;
     std::vector<std::unique_ptr<Label>> m_labels;
 
+    // Scratch buffer of the current line feature, packed for the batch
+    // distance kernels of addLineTextLabels()
+    std::vector<glm::vec2> m_linePoints;
+
     // Attributes of the currently prepared Label
     struct {
         float width = 0;
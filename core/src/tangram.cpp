@@ -3,22 +3,29 @@
 #include "platform.h"
 #include "scene/scene.h"
 #include "scene/sceneLoader.h"
+#include "scene/shareGroup.h"
 #include "style/material.h"
 #include "style/style.h"
 #include "labels/labels.h"
 #include "text/fontContext.h"
 #include "tile/tileManager.h"
 #include "tile/tile.h"
+#include "tile/featureIndex.h"
 #include "gl/error.h"
 #include "gl/shaderProgram.h"
 #include "gl/renderState.h"
 #include "gl/primitives.h"
+#include "gl/tileMaskPass.h"
+#include "gl/snapshotCapture.h"
 #include "marker/marker.h"
 #include "marker/markerManager.h"
-#include "util/asyncWorker.h"
+#include "marker/markerPicker.h"
+#include "util/taskExecutor.h"
 #include "util/inputHandler.h"
 #include "tile/tileCache.h"
 #include "util/fastmap.h"
+#include "util/frameScheduler.h"
+#include "util/qualityGovernor.h"
 #include "view/view.h"
 #include "data/clientGeoJsonSource.h"
 #include "gl.h"
@@ -27,13 +34,31 @@
 #include "util/jobQueue.h"
 #include "debug/textDisplay.h"
 #include "debug/frameInfo.h"
+#include "debug/gpuProfiler.h"
+#include "debug/sceneLoadProfile.h"
+#include "debug/sessionRecorder.h"
+#include "debug/trace.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <bitset>
 
 namespace Tangram {
 
-const static size_t MAX_WORKERS = 2;
+// Upper bound of tile-builder threads. Two start active - matching the
+// previous fixed pool - and TileWorker grows into the spare threads when
+// measured build times show the cores keep up.
+const static size_t MAX_WORKERS = 4;
+
+// Per-frame budget for deferrable render-thread jobs; cleanup beyond
+// this carries over to the next frame.
+const static int64_t JOB_QUEUE_FRAME_BUDGET_US = 2000;
+
+// Frame interval requested while label fades or marker eases are the
+// only motion; 30Hz is indistinguishable on a 400ms fade and halves the
+// wakeups on a 60Hz display.
+const static double FADE_FRAME_INTERVAL = 1.0 / 30.0;
 
 enum class EaseField { position, zoom, rotation, tilt };
 
@@ -60,10 +85,13 @@ public:
     JobQueue jobQueue;
     View view;
     Labels labels;
-    std::unique_ptr<AsyncWorker> asyncWorker = std::make_unique<AsyncWorker>();
+    std::unique_ptr<TaskExecutor::Lane> asyncWorker = std::make_unique<TaskExecutor::Lane>();
     InputHandler inputHandler{view};
 
     std::vector<SceneUpdate> sceneUpdates;
+    // Open transaction nesting depth; applySceneUpdates defers to the
+    // outermost commit while non-zero. Guarded by sceneMutex.
+    int sceneTransactionDepth = 0;
     std::array<Ease, 4> eases;
 
     std::shared_ptr<Scene> scene = std::make_shared<Scene>();
@@ -75,21 +103,53 @@ public:
     TileWorker tileWorker{MAX_WORKERS};
     TileManager tileManager{tileWorker};
     MarkerManager markerManager;
+    MarkerPicker markerPicker;
+    TileMaskPass tileMaskPass;
+    SnapshotCapture snapshotCapture;
+    GpuProfiler gpuProfiler;
+    SessionRecorder sessionRecorder;
 
     bool cacheGlState;
 
+    // Bias tile selection down one zoom level while downloads are slow;
+    // see Map::setAdaptiveTileResolution
+    bool adaptiveTileResolution = false;
+
+    // Steps quality tiers under sustained load; see Map::setQualityGovernor
+    QualityGovernor qualityGovernor;
+
+    // Resources shared with other Map instances; null for a lone map
+    std::shared_ptr<ShareGroup> shareGroup;
+
+    // Damage tracking; 'render' may skip a frame only when it is enabled
+    // and nothing marked the frame dirty since the last draw
+    bool damageTracking = false;
+    bool mapDirty = true;
+
+    // Tiles of the snapshot being drawn; owning references held for the
+    // frame, see TileManager::getRenderTiles
+    std::vector<std::shared_ptr<Tile>> renderTiles;
+
+    // Per-frame draw queues, kept as members to reuse their allocations
+    std::vector<const Tile*> frameTiles;
+    std::vector<const Tile*> tileDrawQueue;
+    std::vector<const Marker*> markerDrawQueue;
+
+    // Combined results of the last pickFeaturesAt query
+    std::vector<TouchItem> touchItems;
+
 };
 
 void Map::Impl::setEase(EaseField _f, Ease _e) {
     eases[static_cast<size_t>(_f)] = _e;
-    requestRender();
+    FrameScheduler::requestFrame();
 }
 void Map::Impl::clearEase(EaseField _f) {
     static Ease none = {};
     eases[static_cast<size_t>(_f)] = none;
 }
 
-static std::bitset<8> g_flags = 0;
+static std::bitset<9> g_flags = 0;
 
 Map::Map() {
 
@@ -97,8 +157,16 @@ Map::Map() {
 
 }
 
+Map::Map(std::shared_ptr<ShareGroup> _shareGroup) {
+
+    impl.reset(new Impl());
+    impl->shareGroup = std::move(_shareGroup);
+
+}
+
 Map::~Map() {
     // The unique_ptr to Impl will be automatically destroyed when Map is destroyed.
+    impl->labels.finishOcclusionTask();
     impl->tileWorker.stop();
     impl->asyncWorker.reset();
     impl->jobQueue.runJobs();
@@ -108,8 +176,26 @@ Map::~Map() {
 }
 
 void Map::Impl::setScene(std::shared_ptr<Scene>& _scene) {
+
+    // The scene swap drops markers and may drop tiles whose labels a
+    // pending occlusion task still reads.
+    labels.finishOcclusionTask();
+
+    bool keepTiles = false;
     {
         std::lock_guard<std::mutex> lock(sceneMutex);
+
+        // When the tile-affecting parts of the config are unchanged -
+        // e.g. a camera, light or background retheme applied through
+        // scene updates - the tiles built for the old scene stay valid
+        // and survive the switch. Sharing the FontContext is required,
+        // since text meshes reference its glyph atlases.
+        if (scene && scene != _scene &&
+            scene->fontContext() == _scene->fontContext()) {
+            keepTiles = SceneLoader::tileConfigEquals(scene->config(),
+                                                      _scene->config());
+        }
+
         scene = _scene;
     }
 
@@ -147,7 +233,7 @@ void Map::Impl::setScene(std::shared_ptr<Scene>& _scene) {
     }
 
     inputHandler.setView(view);
-    tileManager.setDataSources(_scene->dataSources());
+    tileManager.setDataSources(_scene->dataSources(), keepTiles);
     tileWorker.setScene(_scene);
     markerManager.setScene(_scene);
     setPixelScale(view.pixelScale());
@@ -163,6 +249,13 @@ void Map::Impl::setScene(std::shared_ptr<Scene>& _scene) {
     if (animated != isContinuousRendering()) {
         setContinuousRendering(animated);
     }
+
+    if (asyncWorker) {
+        // Rasterize the common glyph set off-thread so the first labels
+        // do not stall a tile worker on SDF generation
+        auto fontContext = scene->fontContext();
+        asyncWorker->enqueue([fontContext]() { fontContext->prewarmGlyphs(); });
+    }
 }
 
 void Map::loadScene(const char* _scenePath, bool _useScenePosition) {
@@ -172,6 +265,10 @@ void Map::loadScene(const char* _scenePath, bool _useScenePosition) {
     auto scene = std::make_shared<Scene>(_scenePath);
     scene->useScenePosition = _useScenePosition;
 
+    if (impl->shareGroup) {
+        scene->setFontContext(impl->shareGroup->fontContext());
+    }
+
     if (SceneLoader::loadScene(scene)) {
         impl->setScene(scene);
     }
@@ -185,36 +282,69 @@ void Map::loadSceneAsync(const char* _scenePath, bool _useScenePosition, MapRead
         impl->sceneUpdates.clear();
         impl->nextScene = std::make_shared<Scene>(_scenePath);
         impl->nextScene->useScenePosition = _useScenePosition;
-    }
 
-    runAsyncTask([scene = impl->nextScene, _platformCallback, _cbData, &jobQueue = impl->jobQueue, this](){
-
-            bool ok = SceneLoader::loadScene(scene);
+        if (impl->shareGroup) {
+            impl->nextScene->setFontContext(impl->shareGroup->fontContext());
+        }
+    }
 
-            jobQueue.add([scene, ok, _platformCallback, _cbData, this]() {
-                    {
-                        std::lock_guard<std::mutex> lock(impl->sceneMutex);
-                        if (scene == impl->nextScene) {
-                            impl->nextScene.reset();
-                        } else { return; }
-                    }
+    // Parse off-thread, then publish on the GL thread where update()
+    // drains the job queue.
+    auto scene = impl->nextScene;
+    auto ok = std::make_shared<bool>(false);
+
+    TaskExecutor::Chain()
+        .then([scene, ok]() {
+            *ok = SceneLoader::loadScene(scene);
+            FrameScheduler::requestFrame();
+        })
+        .thenOn(impl->jobQueue, [scene, ok, _platformCallback, _cbData, this]() {
+            {
+                std::lock_guard<std::mutex> lock(impl->sceneMutex);
+                if (scene == impl->nextScene) {
+                    impl->nextScene.reset();
+                } else { return; }
+            }
 
-                    if (ok) {
-                        auto s = scene;
-                        impl->setScene(s);
-                        applySceneUpdates();
-                        if (_platformCallback) { _platformCallback(_cbData); }
-                    }
-                });
-            requestRender();
-        });
+            if (*ok) {
+                auto s = scene;
+                impl->setScene(s);
+                applySceneUpdates();
+                if (_platformCallback) { _platformCallback(_cbData); }
+            }
+        })
+        .run();
 }
 
 void Map::queueSceneUpdate(const char* _path, const char* _value) {
     std::lock_guard<std::mutex> lock(impl->sceneMutex);
+
+    // Repeated updates to one path collapse to the latest value, so a
+    // dragged slider holds one queued update, not one per change.
+    for (auto& update : impl->sceneUpdates) {
+        if (update.path == _path) {
+            update.value = _value;
+            return;
+        }
+    }
+
     impl->sceneUpdates.push_back({_path, _value});
 }
 
+void Map::beginSceneTransaction() {
+    std::lock_guard<std::mutex> lock(impl->sceneMutex);
+    impl->sceneTransactionDepth++;
+}
+
+void Map::commitSceneTransaction() {
+    {
+        std::lock_guard<std::mutex> lock(impl->sceneMutex);
+        if (impl->sceneTransactionDepth == 0) { return; }
+        if (--impl->sceneTransactionDepth > 0) { return; }
+    }
+    applySceneUpdates();
+}
+
 void Map::applySceneUpdates() {
 
     LOG("Applying %d scene updates", impl->sceneUpdates.size());
@@ -227,6 +357,8 @@ void Map::applySceneUpdates() {
     std::vector<SceneUpdate> updates;
     {
         std::lock_guard<std::mutex> lock(impl->sceneMutex);
+        // Inside a transaction the outermost commit applies everything
+        if (impl->sceneTransactionDepth > 0) { return; }
         if (impl->sceneUpdates.empty()) { return; }
 
         impl->nextScene = std::make_shared<Scene>(*impl->scene);
@@ -236,26 +368,29 @@ void Map::applySceneUpdates() {
         impl->sceneUpdates.clear();
     }
 
-    runAsyncTask([scene = impl->nextScene, updates = std::move(updates), &jobQueue = impl->jobQueue, this](){
+    auto scene = impl->nextScene;
+    auto ok = std::make_shared<bool>(false);
 
+    TaskExecutor::Chain()
+        .then([scene, updates = std::move(updates), ok]() {
             SceneLoader::applyUpdates(*scene, updates);
 
-            bool ok = SceneLoader::applyConfig(scene->config(), scene);
-
-            jobQueue.add([scene, ok, this]() {
-                    if (scene == impl->nextScene) {
-                        std::lock_guard<std::mutex> lock(impl->sceneMutex);
-                        impl->nextScene.reset();
-                    } else { return; }
-
-                    if (ok) {
-                        auto s = scene;
-                        impl->setScene(s);
-                        applySceneUpdates();
-                    }
-                });
-            requestRender();
-        });
+            *ok = SceneLoader::applyConfig(scene->config(), scene);
+            FrameScheduler::requestFrame();
+        })
+        .thenOn(impl->jobQueue, [scene, ok, this]() {
+            if (scene == impl->nextScene) {
+                std::lock_guard<std::mutex> lock(impl->sceneMutex);
+                impl->nextScene.reset();
+            } else { return; }
+
+            if (*ok) {
+                auto s = scene;
+                impl->setScene(s);
+                applySceneUpdates();
+            }
+        })
+        .run();
 }
 
 void Map::resize(int _newWidth, int _newHeight) {
@@ -263,9 +398,10 @@ void Map::resize(int _newWidth, int _newHeight) {
     LOGS("resize: %d x %d", _newWidth, _newHeight);
     LOG("resize: %d x %d", _newWidth, _newHeight);
 
-    GL::viewport(0, 0, _newWidth, _newHeight);
+    impl->renderState.viewport(0, 0, _newWidth, _newHeight);
 
     impl->view.setSize(_newWidth, _newHeight);
+    impl->mapDirty = true;
 
     Primitives::setResolution(impl->renderState, _newWidth, _newHeight);
 }
@@ -274,7 +410,7 @@ bool Map::update(float _dt) {
 
     // Wait until font resources are fully loaded
     if (impl->scene->pendingFonts > 0) {
-        requestRender();
+        FrameScheduler::requestFrame();
         return false;
     }
 
@@ -296,9 +432,25 @@ bool Map::update(float _dt) {
 
     impl->inputHandler.update(_dt);
 
+    {
+        // A disabled governor sits at tier 0, whose levers are no-ops
+        const auto& levers = impl->qualityGovernor.levers();
+        impl->labels.setCandidateLimit(levers.maxLabelCandidates);
+
+        int zoomBias = levers.tileZoomBias;
+        if (impl->adaptiveTileResolution) {
+            zoomBias = std::max(zoomBias, impl->tileManager.recommendedZoomBias());
+        }
+        impl->view.setZoomBias(zoomBias);
+    }
+
     impl->view.update();
 
-    impl->markerManager.update(static_cast<int>(impl->view.getZoom()));
+    // Marker updates may rebuild meshes whose labels a pending occlusion
+    // task still reads.
+    impl->labels.finishOcclusionTask();
+
+    bool markersChanged = impl->markerManager.update(static_cast<int>(impl->view.getZoom()));
 
     for (const auto& style : impl->scene->styles()) {
         style->onBeginUpdate();
@@ -307,7 +459,8 @@ bool Map::update(float _dt) {
     {
         std::lock_guard<std::mutex> lock(impl->tilesMutex);
 
-        impl->tileManager.updateTileSets(impl->view.state(), impl->view.getVisibleTiles());
+        impl->tileManager.updateTileSets(impl->view.state(), impl->view.getVisibleTiles(),
+                                         impl->view.visibleTilesChanged());
 
         auto& tiles = impl->tileManager.getVisibleTiles();
         auto& markers = impl->markerManager.markers();
@@ -343,23 +496,80 @@ bool Map::update(float _dt) {
         viewComplete = false;
     }
 
+    // The next frame must be drawn if anything visible changed this update,
+    // or if shader animation keeps the scene moving on its own
+    if (viewChanged || tilesChanged || markersChanged || markersNeedUpdate ||
+        labelsNeedUpdate || resourceLoading || nextScene ||
+        impl->scene->animated() == Scene::yes) {
+        impl->mapDirty = true;
+    }
+
     // Request render if labels are in fading states or markers are easing.
-    if (labelsNeedUpdate || markersNeedUpdate) { requestRender(); }
+    // When fades are the only thing moving, the next frame is scheduled at
+    // the reduced fade rate instead of the full display rate.
+    if (labelsNeedUpdate || markersNeedUpdate) {
+        bool pureFade = !viewChanged && !tilesChanged && !markersChanged &&
+                        !tilesLoading && !resourceLoading && !nextScene;
+        if (pureFade) {
+            FrameScheduler::requestFrame(FADE_FRAME_INTERVAL);
+        } else {
+            FrameScheduler::requestFrame();
+        }
+    }
 
     return viewComplete;
 }
 
+// Squared ground distance from the view position to the tile center, using
+// the view-relative translation kept in the tile's model matrix
+static float tileDistanceSquared(const Tile& _tile) {
+    float half = _tile.getScale() * 0.5f;
+    float x = _tile.getModelMatrix()[3][0] + half;
+    float y = _tile.getModelMatrix()[3][1] + half;
+    return x * x + y * y;
+}
+
 void Map::render() {
 
+    // The wakeup for this frame is spent; the next render request wakes
+    // the platform again
+    FrameScheduler::frameBegins();
+
+    // With damage tracking enabled, skip frames in which nothing changed;
+    // the previously drawn frame is still valid on a preserved surface
+    if (impl->damageTracking && !impl->mapDirty &&
+        !impl->markerPicker.hasQueries() &&
+        !impl->snapshotCapture.hasPending()) {
+        return;
+    }
+    impl->mapDirty = false;
+
+    TRACE_SCOPE("Map::render");
+
+    // Wall-clock frame time feeds the rolling telemetry histogram,
+    // independently of the debug overlay
+    auto frameStart = std::chrono::steady_clock::now();
+
     FrameInfo::beginFrame();
 
+    // Poll GPU timings of earlier frames and open this frame for queries
+    impl->gpuProfiler.beginFrame();
+
     // Invalidate render states for new frame
     if (!impl->cacheGlState) {
         impl->renderState.invalidate();
     }
 
-    // Run render-thread tasks
-    impl->renderState.jobQueue.runJobs();
+    // Run render-thread tasks; deferrable jobs stop once the frame budget
+    // is spent and finish on later frames
+    impl->renderState.jobQueue.runJobs(JOB_QUEUE_FRAME_BUDGET_US);
+
+    // Run a batch of resource disposals that have aged past the frame delay
+    impl->renderState.flushDisposalQueue();
+
+    // Map and deliver snapshot readbacks issued on earlier frames; their
+    // GPU-side copies have had a whole frame to finish
+    impl->snapshotCapture.deliver(impl->renderState);
 
     // Set up openGL for new frame
     impl->renderState.depthMask(GL_TRUE);
@@ -367,36 +577,194 @@ void Map::render() {
     impl->renderState.culling(GL_TRUE);
     impl->renderState.cullFace(GL_BACK);
     impl->renderState.clearColor(color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f);
-    GL::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // Stencil writes must be unmasked for the clear to reach the stencil
+    // buffer, which the proxy clip pass relies on
+    impl->renderState.stencilMask(0xff);
+    GL::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
     for (const auto& style : impl->scene->styles()) {
         style->onBeginFrame(impl->renderState);
     }
 
+    // Meshes built this frame that still have to reach the GPU; counted
+    // while queuing draws so an over-budget frame can be classified
+    size_t pendingUploads = 0;
+
     {
         std::lock_guard<std::mutex> lock(impl->tilesMutex);
 
+        const auto& markers = impl->markerManager.markers();
+
+        // Cull tiles whose bounding volume lies entirely outside the view
+        // frustum. The tile scan selects tiles against the view trapezoid,
+        // but LOD-aligned blocks and proxy parents can extend fully
+        // offscreen in tilted views
+        // Draw from the published snapshot: it only changes between
+        // frames, when an update completes, and the owning references
+        // keep its tiles alive for this frame
+        auto& renderTiles = impl->renderTiles;
+        impl->tileManager.getRenderTiles(renderTiles);
+
+        auto& tiles = impl->frameTiles;
+        tiles.clear();
+        bool hasProxies = false;
+        for (const auto& tile : renderTiles) {
+            if (!tile->isOutsideFrustum()) {
+                tiles.push_back(tile.get());
+                hasProxies |= tile->isProxy();
+            }
+        }
+
+        // While proxy tiles overlap their replacements during zooms, stamp
+        // the target tile footprints into the stencil buffer so proxy
+        // geometry only shades the regions no target tile covers yet
+        if (hasProxies) {
+            impl->tileMaskPass.drawMask(impl->renderState, tiles);
+        }
+
+        // Upload new raster textures before draw submission starts. Several
+        // tiles landing together still upload in one frame, but doing it up
+        // front keeps glTexImage2D calls from being interleaved with draws,
+        // which is what forces the driver to synchronize mid-frame
+        for (const auto& tile : tiles) {
+            for (auto& raster : tile->rasters()) {
+                if (raster.isValid()) {
+                    raster.texture->update(impl->renderState, 0);
+                }
+            }
+        }
+
         // Loop over all styles
         for (const auto& style : impl->scene->styles()) {
 
+            if (style->isOptional() && !impl->qualityGovernor.levers().drawOptionalStyles) {
+                continue;
+            }
+
+            // Queue the tiles that built a mesh for this style and the
+            // markers it owns; styles with nothing queued skip their
+            // per-frame shader and blending setup entirely
+            auto& tileQueue = impl->tileDrawQueue;
+            tileQueue.clear();
+            for (const auto* tile : tiles) {
+                const auto& mesh = tile->getMesh(*style);
+                if (mesh) {
+                    if (!mesh->isUploaded()) { pendingUploads++; }
+                    tileQueue.push_back(tile);
+                }
+            }
+
+            auto& markerQueue = impl->markerDrawQueue;
+            markerQueue.clear();
+            for (const auto& marker : markers) {
+                if (marker->styleId() == style->getID() &&
+                    marker->isVisible() && marker->mesh()) {
+                    markerQueue.push_back(marker.get());
+                }
+            }
+
+            if (tileQueue.empty() && markerQueue.empty()) { continue; }
+
+            // Draw opaque tiles front-to-back so early depth rejection
+            // discards hidden fragments; the output is depth-tested and
+            // therefore order-independent
+            if (style->blendMode() == Blending::opaque && tileQueue.size() > 1) {
+                std::sort(tileQueue.begin(), tileQueue.end(),
+                          [](const Tile* _a, const Tile* _b) {
+                              return tileDistanceSquared(*_a) < tileDistanceSquared(*_b);
+                          });
+            }
+
+            impl->gpuProfiler.begin(style->getName());
+
             style->onBeginDrawFrame(impl->renderState, impl->view, *(impl->scene));
 
-            // Loop over all tiles in m_tileSet
-            for (const auto& tile : impl->tileManager.getVisibleTiles()) {
+            // Screen-space overlay quads (labels) may cross tile edges, so
+            // they are never stencil-clipped
+            bool clipProxies = hasProxies && style->blendMode() != Blending::overlay;
+
+            // Optional depth-only pre-pass: lay down final depth with color
+            // writes off, then draw the color pass with GL_LEQUAL so only
+            // the nearest surface passes the depth test and every hidden
+            // fragment is rejected by early-z instead of being shaded
+            bool depthPrepass = style->depthPrepass() && !tileQueue.empty();
+            if (depthPrepass) {
+                impl->renderState.colorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+                for (const auto* tile : tileQueue) {
+                    if (clipProxies) {
+                        TileMaskPass::applyStencilState(impl->renderState, *tile);
+                    }
+                    style->draw(impl->renderState, *tile);
+                }
+
+                impl->renderState.colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                impl->renderState.depthFunc(GL_LEQUAL);
+            }
+
+            for (const auto* tile : tileQueue) {
+                if (clipProxies) {
+                    TileMaskPass::applyStencilState(impl->renderState, *tile);
+                }
                 style->draw(impl->renderState, *tile);
             }
 
-            for (const auto& marker : impl->markerManager.markers()) {
+            if (depthPrepass) {
+                impl->renderState.depthFunc(GL_LESS);
+            }
+
+            if (clipProxies) {
+                impl->renderState.stencilTest(GL_FALSE);
+            }
+
+            for (const auto* marker : markerQueue) {
                 style->draw(impl->renderState, *marker);
             }
 
             style->onEndDrawFrame();
+
+            impl->gpuProfiler.end();
         }
+
+        // Resolve queued marker picks while marker model matrices are
+        // still in sync with the frame just drawn
+        if (impl->markerPicker.hasQueries()) {
+            impl->markerPicker.resolveQueries(impl->renderState, impl->view, markers);
+        }
+    }
+
+    // Issue queued captures while only map content is down, so snapshots
+    // exclude the debug overlays drawn below
+    impl->snapshotCapture.capture(impl->renderState, impl->view.getWidth(),
+                                  impl->view.getHeight());
+    if (impl->snapshotCapture.hasPending()) {
+        // One more frame maps and delivers the readback
+        FrameScheduler::requestFrame();
     }
 
     impl->labels.drawDebug(impl->renderState, impl->view);
 
-    FrameInfo::draw(impl->renderState, impl->view, impl->tileManager);
+    FrameInfo::draw(impl->renderState, impl->view, impl->tileManager, impl->gpuProfiler);
+
+    if (Hardware::supportsDiscardFramebuffer) {
+        // Depth and stencil are cleared before the next frame draws, so
+        // tile-based GPUs need not resolve them to memory
+        static const GLenum attachments[] = { GL_DEPTH_EXT, GL_STENCIL_EXT };
+        GL::discardFramebuffer(GL_FRAMEBUFFER, 2, attachments);
+    }
+
+    float frameMs = std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - frameStart).count();
+
+    if (FrameInfo::recordFrameTime(frameMs)) {
+        FrameInfo::recordJank(frameMs, impl->tileManager.numLoadingTiles(),
+                              impl->labels.numLabels(), pendingUploads);
+    }
+
+    if (impl->qualityGovernor.onFrameRendered(frameMs)) {
+        // The new tier's levers apply on the next update
+        FrameScheduler::requestFrame();
+    }
 }
 
 int Map::getViewportHeight() {
@@ -415,17 +783,23 @@ void Map::captureSnapshot(unsigned int* _data) {
     GL::readPixels(0, 0, impl->view.getWidth(), impl->view.getHeight(), GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)_data);
 }
 
+void Map::captureSnapshotAsync(std::function<void(std::unique_ptr<SnapshotData>)> _callback) {
+    impl->snapshotCapture.requestCapture(std::move(_callback));
+    FrameScheduler::requestFrame();
+}
+
 void Map::Impl::setPositionNow(double _lon, double _lat) {
 
     glm::dvec2 meters = view.getMapProjection().LonLatToMeters({ _lon, _lat});
     view.setPosition(meters.x, meters.y);
     inputHandler.cancelFling();
-    requestRender();
+    FrameScheduler::requestFrame();
 
 }
 
 void Map::setPosition(double _lon, double _lat) {
 
+    impl->sessionRecorder.record(SessionEvent::Call::setPosition, _lon, _lat);
     impl->setPositionNow(_lon, _lat);
     impl->clearEase(EaseField::position);
 
@@ -453,12 +827,13 @@ void Map::Impl::setZoomNow(float _z) {
 
     view.setZoom(_z);
     inputHandler.cancelFling();
-    requestRender();
+    FrameScheduler::requestFrame();
 
 }
 
 void Map::setZoom(float _z) {
 
+    impl->sessionRecorder.record(SessionEvent::Call::setZoom, _z);
     impl->setZoomNow(_z);
     impl->clearEase(EaseField::zoom);
 
@@ -481,12 +856,13 @@ float Map::getZoom() {
 void Map::Impl::setRotationNow(float _radians) {
 
     view.setRoll(_radians);
-    requestRender();
+    FrameScheduler::requestFrame();
 
 }
 
 void Map::setRotation(float _radians) {
 
+    impl->sessionRecorder.record(SessionEvent::Call::setRotation, _radians);
     impl->setRotationNow(_radians);
     impl->clearEase(EaseField::rotation);
 
@@ -516,17 +892,40 @@ float Map::getRotation() {
 void Map::Impl::setTiltNow(float _radians) {
 
     view.setPitch(_radians);
-    requestRender();
+    FrameScheduler::requestFrame();
 
 }
 
 void Map::setTilt(float _radians) {
 
+    impl->sessionRecorder.record(SessionEvent::Call::setTilt, _radians);
     impl->setTiltNow(_radians);
     impl->clearEase(EaseField::tilt);
 
 }
 
+void Map::setCameraState(double _lng, double _lat, float _zoom, float _rotation, float _tilt) {
+
+    // Recorded as the equivalent individual calls, so sessions replay
+    // without a new event type
+    impl->sessionRecorder.record(SessionEvent::Call::setPosition, _lng, _lat);
+    impl->sessionRecorder.record(SessionEvent::Call::setZoom, _zoom);
+    impl->sessionRecorder.record(SessionEvent::Call::setRotation, _rotation);
+    impl->sessionRecorder.record(SessionEvent::Call::setTilt, _tilt);
+
+    glm::dvec2 meters = impl->view.getMapProjection().LonLatToMeters({ _lng, _lat });
+    impl->view.setCameraState(meters.x, meters.y, _zoom, _rotation, _tilt);
+
+    impl->inputHandler.cancelFling();
+    impl->clearEase(EaseField::position);
+    impl->clearEase(EaseField::zoom);
+    impl->clearEase(EaseField::rotation);
+    impl->clearEase(EaseField::tilt);
+
+    FrameScheduler::requestFrame();
+
+}
+
 void Map::setTiltEased(float _radians, float _duration, EaseType _e) {
 
     float tilt_start = getTilt();
@@ -553,6 +952,15 @@ bool Map::screenPositionToLngLat(double _x, double _y, double* _lng, double* _la
     return (intersection >= 0);
 }
 
+void Map::lngLatToScreenPositions(const double* _lngLats, float* _screenPositions,
+                                  size_t _count, bool* _clipped) {
+    impl->view.lonLatToScreenPositions(_lngLats, _screenPositions, _count, _clipped);
+}
+
+void Map::screenPositionsToLngLats(double* _coordinates, size_t _count) {
+    impl->view.screenPositionsToLonLats(_coordinates, _count);
+}
+
 bool Map::lngLatToScreenPosition(double _lng, double _lat, double* _x, double* _y) {
     bool clipped = false;
 
@@ -587,7 +995,7 @@ void Map::Impl::setPixelScale(float _pixelsPerPoint) {
 void Map::setCameraType(int _type) {
 
     impl->view.setCameraType(static_cast<CameraType>(_type));
-    requestRender();
+    FrameScheduler::requestFrame();
 
 }
 
@@ -613,7 +1021,100 @@ void Map::clearDataSource(DataSource& _source, bool _data, bool _tiles) {
     if (_tiles) { impl->tileManager.clearTileSet(_source.id()); }
     if (_data) { _source.clearData(); }
 
-    requestRender();
+    FrameScheduler::requestFrame();
+}
+
+void Map::setWorkerHints(int _performantCores, bool _thermalThrottled) {
+    impl->tileWorker.setHints(_performantCores, _thermalThrottled);
+}
+
+void Map::setAdaptiveTileResolution(bool _enabled) {
+    impl->adaptiveTileResolution = _enabled;
+    if (!_enabled) {
+        impl->view.setZoomBias(0);
+        FrameScheduler::requestFrame();
+    }
+}
+
+void Map::setQualityGovernor(bool _enabled) {
+    if (impl->qualityGovernor.setEnabled(_enabled)) {
+        FrameScheduler::requestFrame();
+    }
+}
+
+void Map::setQualityTiers(std::vector<QualityTier> _tiers) {
+    impl->qualityGovernor.setTiers(std::move(_tiers));
+    FrameScheduler::requestFrame();
+}
+
+void Map::setThermalState(ThermalState _state) {
+    if (impl->qualityGovernor.setThermalState(_state)) {
+        FrameScheduler::requestFrame();
+    }
+}
+
+void Map::setLowPowerMode(bool _enabled) {
+    if (impl->qualityGovernor.setLowPowerMode(_enabled)) {
+        FrameScheduler::requestFrame();
+    }
+}
+
+double Map::getNextFrameDelay() {
+    return FrameScheduler::nextFrameDelay();
+}
+
+void Map::warmCache(LngLat _sw, LngLat _ne, int _minZoom, int _maxZoom,
+                    bool _buildMeshes, RegionProgressCallback _progress) {
+
+    // Cap accidental world-spanning requests before they flood the queue.
+    const size_t maxTiles = 1 << 14;
+
+    const auto& projection = impl->view.getMapProjection();
+
+    glm::dvec2 sw = projection.LonLatToMeters({ _sw.longitude, _sw.latitude });
+    glm::dvec2 ne = projection.LonLatToMeters({ _ne.longitude, _ne.latitude });
+
+    std::vector<TileID> tiles;
+
+    int minZoom = std::max(_minZoom, int(View::s_minZoom));
+    int maxZoom = std::min(_maxZoom, int(View::s_maxZoom));
+
+    for (int z = minZoom; z <= maxZoom; z++) {
+
+        glm::ivec2 a = projection.MetersToTileXY(sw, z);
+        glm::ivec2 b = projection.MetersToTileXY(ne, z);
+
+        int maxIndex = (1 << z) - 1;
+        int minX = glm::clamp(std::min(a.x, b.x), 0, maxIndex);
+        int maxX = glm::clamp(std::max(a.x, b.x), 0, maxIndex);
+        int minY = glm::clamp(std::min(a.y, b.y), 0, maxIndex);
+        int maxY = glm::clamp(std::max(a.y, b.y), 0, maxIndex);
+
+        for (int x = minX; x <= maxX; x++) {
+            for (int y = minY; y <= maxY; y++) {
+                if (tiles.size() >= maxTiles) {
+                    LOGW("warmCache request truncated at %d tiles", int(maxTiles));
+                    break;
+                }
+                // MetersToTileXY returns TMS row order; visible TileIDs
+                // count rows from the north edge.
+                tiles.emplace_back(x, maxIndex - y, z);
+            }
+            if (tiles.size() >= maxTiles) { break; }
+        }
+        if (tiles.size() >= maxTiles) { break; }
+    }
+
+    if (tiles.empty()) { return; }
+
+    std::sort(tiles.begin(), tiles.end());
+
+    {
+        std::lock_guard<std::mutex> lock(impl->tilesMutex);
+        impl->tileManager.warmTiles(tiles, _buildMeshes, std::move(_progress));
+    }
+
+    FrameScheduler::requestFrame();
 }
 
 MarkerID Map::markerAdd() {
@@ -621,96 +1122,124 @@ MarkerID Map::markerAdd() {
 }
 
 bool Map::markerRemove(MarkerID _marker) {
+    impl->labels.finishOcclusionTask();
     bool success = impl->markerManager.remove(_marker);
-    requestRender();
+    FrameScheduler::requestFrame();
     return success;
 }
 
 bool Map::markerSetPoint(MarkerID _marker, LngLat _lngLat) {
+    impl->labels.finishOcclusionTask();
     bool success = impl->markerManager.setPoint(_marker, _lngLat);
-    requestRender();
+    FrameScheduler::requestFrame();
+    return success;
+}
+
+bool Map::markerSetPoints(const MarkerID* _markers, const LngLat* _coordinates, int _count) {
+    impl->labels.finishOcclusionTask();
+    bool success = impl->markerManager.setPoints(_markers, _coordinates, _count);
+    FrameScheduler::requestFrame();
     return success;
 }
 
 bool Map::markerSetPointEased(MarkerID _marker, LngLat _lngLat, float _duration, EaseType ease) {
     bool success = impl->markerManager.setPointEased(_marker, _lngLat, _duration, ease);
-    requestRender();
+    FrameScheduler::requestFrame();
     return success;
 }
 
 bool Map::markerSetPolyline(MarkerID _marker, LngLat* _coordinates, int _count) {
+    impl->labels.finishOcclusionTask();
     bool success = impl->markerManager.setPolyline(_marker, _coordinates, _count);
-    requestRender();
+    FrameScheduler::requestFrame();
     return success;
 }
 
 bool Map::markerSetPolygon(MarkerID _marker, LngLat* _coordinates, int* _counts, int _rings) {
+    impl->labels.finishOcclusionTask();
     bool success = impl->markerManager.setPolygon(_marker, _coordinates, _counts, _rings);
-    requestRender();
+    FrameScheduler::requestFrame();
     return success;
 }
 
 bool Map::markerSetStyling(MarkerID _marker, const char* _styling) {
+    impl->labels.finishOcclusionTask();
     bool success = impl->markerManager.setStyling(_marker, _styling);
-    requestRender();
+    FrameScheduler::requestFrame();
+    return success;
+}
+
+bool Map::markerSetStylingGroup(const MarkerID* _markers, int _count, const char* _styling) {
+    impl->labels.finishOcclusionTask();
+    bool success = impl->markerManager.setStylingGroup(_markers, _count, _styling);
+    FrameScheduler::requestFrame();
     return success;
 }
 
 bool Map::markerSetBitmap(MarkerID _marker, int _width, int _height, const unsigned int* _data) {
+    impl->labels.finishOcclusionTask();
     bool success = impl->markerManager.setBitmap(_marker, _width, _height, _data);
-    requestRender();
+    FrameScheduler::requestFrame();
     return success;
 }
 
 bool Map::markerSetVisible(MarkerID _marker, bool _visible) {
     bool success = impl->markerManager.setVisible(_marker, _visible);
-    requestRender();
+    FrameScheduler::requestFrame();
     return success;
 }
 
 void Map::markerRemoveAll() {
+    impl->labels.finishOcclusionTask();
     impl->markerManager.removeAll();
-    requestRender();
+    FrameScheduler::requestFrame();
 }
 
 void Map::handleTapGesture(float _posX, float _posY) {
 
+    impl->sessionRecorder.record(SessionEvent::Call::tapGesture, _posX, _posY);
     impl->inputHandler.handleTapGesture(_posX, _posY);
 
 }
 
 void Map::handleDoubleTapGesture(float _posX, float _posY) {
 
+    impl->sessionRecorder.record(SessionEvent::Call::doubleTapGesture, _posX, _posY);
     impl->inputHandler.handleDoubleTapGesture(_posX, _posY);
 
 }
 
 void Map::handlePanGesture(float _startX, float _startY, float _endX, float _endY) {
 
+    impl->sessionRecorder.record(SessionEvent::Call::panGesture, _startX, _startY, _endX, _endY);
     impl->inputHandler.handlePanGesture(_startX, _startY, _endX, _endY);
 
 }
 
 void Map::handleFlingGesture(float _posX, float _posY, float _velocityX, float _velocityY) {
 
+    impl->sessionRecorder.record(SessionEvent::Call::flingGesture, _posX, _posY, _velocityX, _velocityY);
     impl->inputHandler.handleFlingGesture(_posX, _posY, _velocityX, _velocityY);
 
 }
 
 void Map::handlePinchGesture(float _posX, float _posY, float _scale, float _velocity) {
 
+    impl->sessionRecorder.record(SessionEvent::Call::pinchGesture, _posX, _posY, _scale, _velocity);
     impl->inputHandler.handlePinchGesture(_posX, _posY, _scale, _velocity);
 
 }
 
 void Map::handleRotateGesture(float _posX, float _posY, float _radians) {
 
+    impl->sessionRecorder.record(SessionEvent::Call::rotateGesture, _posX, _posY, _radians);
     impl->inputHandler.handleRotateGesture(_posX, _posY, _radians);
 
 }
 
 void Map::handleShoveGesture(float _distance) {
 
+    impl->sessionRecorder.record(SessionEvent::Call::shoveGesture, _distance);
     impl->inputHandler.handleShoveGesture(_distance);
 
 }
@@ -719,6 +1248,8 @@ void Map::setupGL() {
 
     LOG("setup GL");
 
+    TRACE_THREAD("Render");
+
     impl->tileManager.clearTileSets();
 
     // Reconfigure the render states. Increases context 'generation'.
@@ -727,6 +1258,10 @@ void Map::setupGL() {
     impl->renderState.increaseGeneration();
     impl->renderState.invalidate();
 
+    // Outstanding timer queries died with the old context
+    impl->gpuProfiler.invalidate();
+    impl->mapDirty = true;
+
     // Set default primitive render color
     Primitives::setColor(impl->renderState, 0xffffff);
 
@@ -741,10 +1276,198 @@ void Map::useCachedGlState(bool _useCache) {
     impl->cacheGlState = _useCache;
 }
 
+void Map::useDamageTracking(bool _use) {
+    impl->damageTracking = _use;
+    impl->mapDirty = true;
+}
+
 const std::vector<TouchItem>& Map::pickFeaturesAt(float _x, float _y) {
-    return impl->labels.getFeaturesAtPoint(impl->view.state(), 0, impl->scene->styles(),
-                                           impl->tileManager.getVisibleTiles(),
-                                           _x, _y);
+
+    impl->touchItems = impl->labels.getFeaturesAtPoint(impl->view.state(), 0, impl->scene->styles(),
+                                                       impl->tileManager.getVisibleTiles(),
+                                                       _x, _y);
+
+    // Resolve the pick against the feature indexes of the visible tiles,
+    // covering interactive polygons and lines that produced no label
+    float x = _x, y = _y;
+    if (impl->view.screenToGroundPlane(x, y) < 0) { return impl->touchItems; }
+
+    glm::dvec3 eye = impl->view.getPosition();
+    glm::dvec2 meters(x + eye.x, y + eye.y);
+
+    // FIXME dpi dependent threshold, matches Labels::getFeaturesAtPoint
+    const float thumbSize = 50;
+    float pixelsPerMeter = impl->view.pixelsPerMeter();
+    float radiusMeters = 0.5f * thumbSize / pixelsPerMeter;
+
+    std::vector<FeatureIndex::Result> hits;
+
+    for (const auto& tile : impl->tileManager.getVisibleTiles()) {
+        const auto* index = tile->featureIndex();
+        if (!index) { continue; }
+
+        glm::vec2 local((meters.x - tile->getOrigin().x) * tile->getInverseScale(),
+                        (meters.y - tile->getOrigin().y) * tile->getInverseScale());
+        float radius = radiusMeters * tile->getInverseScale();
+
+        if (local.x < -radius || local.x > 1.f + radius ||
+            local.y < -radius || local.y > 1.f + radius) { continue; }
+
+        hits.clear();
+        index->query(local, radius, hits);
+
+        for (const auto& hit : hits) {
+            float distance = hit.second * tile->getScale() * pixelsPerMeter;
+            impl->touchItems.push_back({ hit.first->properties, { _x, _y }, distance });
+        }
+    }
+
+    std::sort(impl->touchItems.begin(), impl->touchItems.end(),
+              [](auto& a, auto& b){ return a.distance < b.distance; });
+
+    return impl->touchItems;
+}
+
+void Map::pickFeaturesAt(float _x, float _y, std::function<void(std::vector<TouchItem>)> _callback) {
+
+    // Label hits depend on screen transforms owned by this thread, so they
+    // are gathered here; the feature-index resolution below only reads the
+    // immutable per-tile indexes through captured shared_ptrs and moves to
+    // a worker.
+    auto result = std::make_shared<std::vector<TouchItem>>(
+            impl->labels.getFeaturesAtPoint(impl->view.state(), 0, impl->scene->styles(),
+                                            impl->tileManager.getVisibleTiles(), _x, _y));
+
+    float x = _x, y = _y;
+
+    std::vector<std::shared_ptr<Tile>> tiles;
+    if (impl->view.screenToGroundPlane(x, y) >= 0) {
+        tiles = impl->tileManager.getVisibleTiles();
+    }
+
+    glm::dvec3 eye = impl->view.getPosition();
+    glm::dvec2 meters(x + eye.x, y + eye.y);
+
+    // FIXME dpi dependent threshold, matches Labels::getFeaturesAtPoint
+    const float thumbSize = 50;
+    float pixelsPerMeter = impl->view.pixelsPerMeter();
+    float radiusMeters = 0.5f * thumbSize / pixelsPerMeter;
+
+    TaskExecutor::Chain()
+        .then([result, tiles, meters, radiusMeters, pixelsPerMeter, _x, _y]() {
+
+                std::vector<FeatureIndex::Result> hits;
+
+                for (const auto& tile : tiles) {
+                    const auto* index = tile->featureIndex();
+                    if (!index) { continue; }
+
+                    glm::vec2 local((meters.x - tile->getOrigin().x) * tile->getInverseScale(),
+                                    (meters.y - tile->getOrigin().y) * tile->getInverseScale());
+                    float radius = radiusMeters * tile->getInverseScale();
+
+                    if (local.x < -radius || local.x > 1.f + radius ||
+                        local.y < -radius || local.y > 1.f + radius) { continue; }
+
+                    hits.clear();
+                    index->query(local, radius, hits);
+
+                    for (const auto& hit : hits) {
+                        float distance = hit.second * tile->getScale() * pixelsPerMeter;
+                        result->push_back({ hit.first->properties, { _x, _y }, distance });
+                    }
+                }
+
+                std::sort(result->begin(), result->end(),
+                          [](auto& a, auto& b){ return a.distance < b.distance; });
+            })
+        .thenOn(impl->jobQueue, [result, callback = std::move(_callback)]() {
+                callback(std::move(*result));
+            })
+        .run();
+
+    FrameScheduler::requestFrame();
+}
+
+void Map::pickMarkerAt(float _x, float _y, std::function<void(MarkerID)> _callback) {
+    impl->markerPicker.pick(_x, _y, std::move(_callback));
+    FrameScheduler::requestFrame();
+}
+
+void Map::startSessionRecording() {
+    impl->sessionRecorder.start();
+}
+
+bool Map::stopSessionRecording(const char* _path) {
+    return impl->sessionRecorder.stop(_path);
+}
+
+std::vector<TileBuildStats> Map::getTileContentStats() {
+
+    std::vector<TileBuildStats> stats;
+
+    std::lock_guard<std::mutex> lock(impl->tilesMutex);
+
+    for (const auto& tile : impl->tileManager.getVisibleTiles()) {
+        if (tile->buildStats()) {
+            stats.push_back(*tile->buildStats());
+        }
+    }
+
+    return stats;
+}
+
+MemoryStats Map::getMemoryStats() {
+
+    MemoryStats stats;
+
+    std::lock_guard<std::mutex> lock(impl->tilesMutex);
+
+    stats.tileCacheBytes = impl->tileManager.getTileCache()->getMemoryUsage();
+
+    for (const auto& tile : impl->tileManager.getVisibleTiles()) {
+        stats.visibleTileBytes += tile->getMemoryUsage();
+    }
+
+    auto& scene = impl->scene;
+
+    for (const auto& source : scene->dataSources()) {
+        stats.rawTileCacheBytes += source->cacheUsage();
+        stats.rasterCacheBytes += source->rasterBytes();
+        for (const auto& raster : source->rasterSources()) {
+            stats.rawTileCacheBytes += raster->cacheUsage();
+            stats.rasterCacheBytes += raster->rasterBytes();
+        }
+    }
+
+    for (const auto& entry : scene->textures()) {
+        const auto& texture = entry.second;
+        if (texture) {
+            stats.textureBytes += texture->getWidth() * texture->getHeight()
+                * texture->bytesPerPixel();
+        }
+    }
+
+    stats.glyphTextureCount = scene->fontContext()->glyphTextureCount();
+    // Each atlas page keeps its pixel data for partial updates alongside
+    // the uploaded texture
+    stats.fontAtlasBytes = stats.glyphTextureCount
+        * GlyphTexture::size * GlyphTexture::size * 2;
+
+    stats.dataSourceCount = scene->dataSources().size();
+    stats.styleCount = scene->styles().size();
+    stats.layerCount = scene->layers().size();
+    stats.markerCount = impl->markerManager.markers().size();
+
+    return stats;
+}
+
+FrameStats Map::getFrameStats() {
+    return FrameInfo::getFrameStats();
+}
+
+SceneLoadReport Map::getSceneLoadReport() {
+    return SceneLoadProfile::report();
 }
 
 void Map::runAsyncTask(std::function<void()> _task) {
@@ -10,6 +10,7 @@
 namespace Tangram {
 
 class DataSource;
+class ShareGroup;
 
 struct TouchItem {
     std::shared_ptr<Properties> properties;
@@ -22,6 +23,67 @@ struct SceneUpdate {
     std::string value;
 };
 
+// Per-subsystem memory usage, see Map::getMemoryStats
+struct MemoryStats {
+    size_t tileCacheBytes = 0;    // Cached tile meshes kept for later reuse
+    size_t visibleTileBytes = 0;  // Meshes of the tiles currently held for display
+    size_t rawTileCacheBytes = 0; // Raw tile data blobs cached by the data sources
+    size_t textureBytes = 0;      // Pixel data of scene textures, including sprite atlases
+    size_t rasterCacheBytes = 0;  // Decoded raster tile textures cached by the raster sources
+    size_t fontAtlasBytes = 0;    // Glyph atlas pages, counting the CPU copy and its GPU mirror
+    size_t glyphTextureCount = 0; // Number of glyph atlas pages
+    size_t dataSourceCount = 0;
+    size_t styleCount = 0;
+    size_t layerCount = 0;
+    size_t markerCount = 0;
+};
+
+// Content counters recorded while one tile was built, per style; see
+// Map::getTileContentStats. Styles that contributed nothing are omitted.
+struct TileBuildStats {
+    struct StyleStats {
+        std::string style;
+        size_t features = 0;  // Features whose draw rules matched the style
+        size_t vertices = 0;  // Vertices compiled into the style's mesh
+        size_t meshBytes = 0; // Compiled vertex and index data
+        size_t labels = 0;    // Labels the style added
+        float buildMs = 0.f;  // Mesh build time of the style
+    };
+    int32_t zoom = 0; // Tile coordinates
+    int32_t x = 0;
+    int32_t y = 0;
+    float prepareMs = 0.f; // Geometry simplification and clipping
+    float rulesMs = 0.f;   // Layer filters and draw rule application
+    float meshMs = 0.f;    // All style mesh builds together
+    std::vector<StyleStats> styles;
+};
+
+// Rolling frame-time telemetry, see Map::getFrameStats
+struct FrameStats {
+    float p50Ms = 0.f; // Percentiles of render-thread frame time over the rolling window
+    float p95Ms = 0.f;
+    float p99Ms = 0.f;
+    size_t frameCount = 0;    // Frames rendered since startup
+    size_t droppedFrames = 0; // Frames that missed the 60Hz budget
+    // Engine state captured at the slowest over-budget frame since the
+    // stats were last read; worstFrameMs is 0 when no frame went over
+    float worstFrameMs = 0.f;
+    size_t worstFrameTilesLoading = 0;   // Tiles in flight
+    size_t worstFrameLabels = 0;         // Labels in the active set
+    size_t worstFramePendingUploads = 0; // Built meshes awaiting GPU upload
+};
+
+// Timings collected during scene loading, defined in debug/sceneLoadProfile.h
+struct SceneLoadReport;
+
+// Thermal pressure hint and degradation steps for the quality governor,
+// defined in util/qualityGovernor.h
+enum class ThermalState : char;
+struct QualityTier;
+
+// Pixels of a completed asynchronous snapshot, defined in gl/snapshotCapture.h
+struct SnapshotData;
+
 enum class EaseType : char {
     linear = 0,
     cubic,
@@ -35,6 +97,14 @@ public:
 
     // Create an empty map object. To display a map, call either loadScene() or loadSceneAsync().
     Map();
+
+    // Create a map that shares resources with every other map constructed
+    // with the same ShareGroup - one glyph atlas and shaping cache instead
+    // of one per instance, e.g. for a main view plus minimap on the same
+    // scene. The instances' GL contexts must be share-listed (or be the
+    // same context); see scene/shareGroup.h for what is shared.
+    explicit Map(std::shared_ptr<ShareGroup> _shareGroup);
+
     ~Map();
 
     // Load the scene at the given absolute file path asynchronously
@@ -46,12 +116,22 @@ public:
 
     // Request an update to the scene configuration; the path is a series of yaml keys
     // separated by a '.' and the value is a string of yaml to replace the current value
-    // at the given path in the scene
+    // at the given path in the scene. Repeated updates to the same path collapse to the
+    // latest value until they are applied.
     void queueSceneUpdate(const char* _path, const char* _value);
 
-    // Apply all previously requested scene updates
+    // Apply all previously requested scene updates in one pass with a single style and
+    // shader recompute. Updates queued while an apply is in flight are coalesced into
+    // one follow-up apply when it finishes, so continuous edits (e.g. dragging a color
+    // slider) cost at most one rebuild at a time.
     void applySceneUpdates();
 
+    // Batch scene updates into one transaction: while a transaction is open,
+    // applySceneUpdates defers, and the outermost commitSceneTransaction applies
+    // everything queued in a single pass. Transactions may nest.
+    void beginSceneTransaction();
+    void commitSceneTransaction();
+
     // Initialize graphics resources; OpenGL context must be created prior to calling this
     void setupGL();
 
@@ -85,6 +165,14 @@ public:
     // Each unsigned int corresponds to an RGBA pixel value
     void captureSnapshot(unsigned int* _data);
 
+    // Capture the next rendered frame without stalling the pipeline: the frame
+    // is read back through a pixel buffer object and delivered to the callback
+    // about one frame later, on the render thread, in the same layout as
+    // captureSnapshot() but excluding debug overlays. Drivers without pixel
+    // buffer support fall back to a synchronous read. The callback receives
+    // null if the GL context is lost before the readback completes.
+    void captureSnapshotAsync(std::function<void(std::unique_ptr<SnapshotData>)> _callback);
+
     // Set the position of the map view in degrees longitude and latitude; if duration
     // (in seconds) is provided, position eases to the set value over the duration;
     // calling either version of the setter overrides all previous calls
@@ -124,6 +212,12 @@ public:
     // Get the tilt angle of the view in radians; 0 corresponds to straight down
     float getTilt();
 
+    // Set position, zoom, rotation and tilt in one call with a single
+    // constraint pass and dirty-state propagation; meant for embedders
+    // driving the whole camera per frame during custom animations. Cancels
+    // eases and flings like the individual setters
+    void setCameraState(double _lng, double _lat, float _zoom, float _rotation, float _tilt);
+
     // Set the camera type (0 = perspective, 1 = isometric, 2 = flat)
     void setCameraType(int _type);
 
@@ -140,6 +234,17 @@ public:
     // point is not visible on the screen, otherwise returns true
     bool lngLatToScreenPosition(double _lng, double _lat, double* _x, double* _y);
 
+    // Transform _count coordinates per call instead of crossing the API per
+    // point. _lngLats holds interleaved longitude, latitude pairs and
+    // _screenPositions receives interleaved screen x, y pairs; _clipped, when
+    // given, receives one flag per coordinate marking points behind the camera
+    void lngLatToScreenPositions(const double* _lngLats, float* _screenPositions,
+                                 size_t _count, bool* _clipped = nullptr);
+
+    // Convert _count interleaved screen (x, y) pairs to longitude, latitude
+    // pairs in place
+    void screenPositionsToLngLats(double* _coordinates, size_t _count);
+
     // Add a data source for adding drawable map data, which will be styled
     // according to the scene file using the provided data source name;
     void addDataSource(std::shared_ptr<DataSource> _source);
@@ -150,6 +255,66 @@ public:
 
     void clearDataSource(DataSource& _source, bool _data, bool _tiles);
 
+    // Hint the tile workers about the platform: _performantCores is the
+    // number of cores that can run builds at full speed (e.g. the big
+    // cluster on big.LITTLE devices; 0 leaves the current hint unchanged)
+    // and _thermalThrottled caps parallelism while the device throttles.
+    // Call when topology or thermal state changes; without hints the
+    // worker pool adapts from measured build times alone.
+    void setWorkerHints(int _performantCores, bool _thermalThrottled);
+
+    // Trade tile crispness for load time on slow connections: while the
+    // measured download throughput stays low, tiles are selected one zoom
+    // level below the view - a quarter of the bytes per viewport - and
+    // drawn overzoomed; selection returns to full resolution once
+    // bandwidth recovers. Off by default.
+    void setAdaptiveTileResolution(bool _enabled);
+
+    // Degrade quality smoothly under sustained load instead of dropping
+    // frames: while enabled, the governor steps through quality tiers
+    // driven by frame-time percentiles and the thermal hint, capping the
+    // label candidate count, skipping styles flagged 'optional: true' in
+    // the scene, and biasing tile selection to lower zooms. Off by
+    // default; see util/qualityGovernor.h for the tier mechanics.
+    void setQualityGovernor(bool _enabled);
+
+    // Replace the governor's tier ladder; tier 0 should be full quality.
+    // An empty vector restores the built-in defaults.
+    void setQualityTiers(std::vector<QualityTier> _tiers);
+
+    // Forward the OS thermal status to the quality governor, which keeps
+    // at least the matching tier while the device throttles. Pair with
+    // setWorkerHints to also cap tile build parallelism.
+    void setThermalState(ThermalState _state);
+
+    // While the OS reports battery-saver mode, the governor holds one
+    // tier lower than it otherwise would.
+    void setLowPowerMode(bool _enabled);
+
+    // Seconds until the earliest frame requested since render() last ran,
+    // 0 when a frame is due right away and a negative value when no frame
+    // is needed. Platforms reacting to requestRender() can align their
+    // wakeup with this deadline - e.g. the reduced rate of a pure label
+    // fade - instead of drawing on the next vsync unconditionally.
+    double getNextFrameDelay();
+
+    // Progress of a warmCache region: completed and total tile count.
+    // Invoked from update() as tiles finish; completed == total signals
+    // the end of all queued warming.
+    using RegionProgressCallback = std::function<void(std::size_t, std::size_t)>;
+
+    // Pre-fetch the tiles covering the given area for the given zoom range
+    // into the persistent tile caches, e.g. for an anticipated route or
+    // offline region. With _buildMeshes the tiles are also built into the
+    // in-memory tile cache on the workers' background lane. Warming only
+    // uses workers and download slots left idle by visible tiles, so
+    // interactive pan and zoom latency is unaffected. Tiles already cached
+    // are skipped: re-issuing an interrupted region resumes where it
+    // stopped instead of re-downloading.
+    void warmCache(LngLat _sw, LngLat _ne, int _minZoom, int _maxZoom,
+                   bool _buildMeshes = true,
+                   RegionProgressCallback _progress = nullptr);
+
     // Add a marker object to the map and return an ID for it; an ID of 0 indicates an invalid marker;
     // the marker will not be drawn until both styling and geometry are set using the functions below.
     MarkerID markerAdd();
@@ -163,6 +328,12 @@ public:
     // updated, otherwise returns false.
     bool markerSetStyling(MarkerID _marker, const char* _styling);
 
+    // Apply one styling string to a group of markers; the styling is parsed and compiled once and
+    // then applied to every marker in the group, which is much cheaper than calling 'markerSetStyling'
+    // once per marker; _markers is a pointer to a sequence of _count MarkerIDs; returns true if all
+    // marker IDs were found and successfully updated, otherwise returns false.
+    bool markerSetStylingGroup(const MarkerID* _markers, int _count, const char* _styling);
+
     // Set a bitmap to use as the image for a point marker; _data is a buffer of RGBA pixel data with
     // length of _width * _height; pixels are in row-major order beginning from the bottom-left of the
     // image; returns true if the marker ID was found and successfully updated, otherwise returns false.
@@ -173,6 +344,13 @@ public:
     // marker ID was found and successfully updated, otherwise returns false.
     bool markerSetPoint(MarkerID _marker, LngLat _lngLat);
 
+    // Set the geometry of a group of markers to points at the given coordinates; _markers and
+    // _coordinates are pointers to sequences of _count elements, pairing each marker with its new
+    // position; the whole batch is applied in one pass, so moving many markers at once costs far
+    // less than calling 'markerSetPoint' once per marker; returns true if all marker IDs were
+    // found and successfully updated, otherwise returns false.
+    bool markerSetPoints(const MarkerID* _markers, const LngLat* _coordinates, int _count);
+
     // Set the geometry of a marker to a point at the given coordinates; if the marker was previously
     // set to a point, this eases the position over the given duration in seconds with the given EaseType;
     // returns true if the marker ID was found and successfully updated, otherwise returns false.
@@ -227,8 +405,59 @@ public:
     // efficiency, but can cause errors if your application code makes OpenGL calls (false by default)
     void useCachedGlState(bool _use);
 
+    // Set whether 'render' may skip frames in which nothing has changed since the last drawn frame
+    // (false by default). Only enable this when the target surface preserves its contents between
+    // presents (e.g. EGL_BUFFER_PRESERVED or a retained backing layer), otherwise a skipped frame
+    // leaves the backbuffer undefined.
+    void useDamageTracking(bool _use);
+
     const std::vector<TouchItem>& pickFeaturesAt(float _x, float _y);
 
+    // Asynchronous variant of 'pickFeaturesAt'. Label hits are gathered at call time from this
+    // frame's label state; the feature-index resolution, which dominates the query on dense tiles,
+    // runs on a worker against a frame-consistent snapshot of the visible tiles. The callback runs
+    // on the map's thread during a later update with the combined items sorted by distance.
+    void pickFeaturesAt(float _x, float _y, std::function<void(std::vector<TouchItem>)> _callback);
+
+    // Query the marker drawn at the given screen coordinates (x right, y down). The query renders
+    // marker geometry into an offscreen id buffer, so unlike 'pickFeaturesAt' it is pixel accurate
+    // for polyline and polygon markers; point markers are picked with 'pickFeaturesAt'. The callback
+    // runs on the render thread after the next frame, with the MarkerID at that pixel or 0 if no
+    // marker covers it.
+    void pickMarkerAt(float _x, float _y, std::function<void(MarkerID)> _callback);
+
+    // Begin capturing the stream of gesture and camera-setter calls with timestamps. Together with
+    // a DataSource disk cache holding the fetched tiles, a captured session can be replayed
+    // deterministically through SessionReplay (see debug/sessionRecorder.h) to reproduce
+    // performance reports from the field.
+    void startSessionRecording();
+
+    // Stop capturing and write the recorded session to the given file path; returns false if the
+    // file could not be written.
+    bool stopSessionRecording(const char* _path);
+
+    // Report the memory held by each subsystem. Byte counts are computed from object dimensions,
+    // not allocator bookkeeping, so they track content size rather than exact heap usage; use them
+    // to pick cache budgets per device tier and to watch for leaks across scene reloads.
+    MemoryStats getMemoryStats();
+
+    // Report the content counters of every visible tile, recorded while the
+    // tiles were built: which styles and tiles drive feature, vertex and label
+    // counts, and where the build time goes. Tiles restored from the mesh
+    // cache carry no counters and are omitted. See also the tile_heatmap
+    // debug flag for an on-map view.
+    std::vector<TileBuildStats> getTileContentStats();
+
+    // Report frame-time percentiles and dropped-frame counts, plus an engine-state snapshot taken
+    // at the slowest over-budget frame since the last call. Cheap enough to poll periodically for
+    // production telemetry; the on-screen overlay is unaffected.
+    FrameStats getFrameStats();
+
+    // Report timings collected during the most recent scene load: phase durations, bytes and
+    // fetch time per URL resource, and shader build times. Shader programs build lazily over the
+    // first frames, so pull the report once the map has settled to see the full startup path.
+    SceneLoadReport getSceneLoadReport();
+
     // Run this task asynchronously to Tangram's main update loop.
     void runAsyncTask(std::function<void()> _task);
 
@@ -248,6 +477,7 @@ enum DebugFlags {
     tangram_infos,      // Various text tangram debug info printed on the screen
     draw_all_labels,    // Draw all labels
     tangram_stats,      // Tangram frame graph stats
+    tile_heatmap,       // Tints tiles by the feature count recorded at build
 };
 
 // Set debug features on or off using a boolean (see debug.h)
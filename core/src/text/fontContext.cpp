@@ -2,10 +2,12 @@
 
 #include "platform.h"
 #include "log.h"
+#include "util/taskExecutor.h"
 
 #define SDF_IMPLEMENTATION
 #include "sdf.h"
 
+#include <algorithm>
 #include <memory>
 #include <regex>
 
@@ -23,6 +25,11 @@
 
 #define MIN_LINE_WIDTH 4
 
+// Rasterized upfront by prewarmGlyphs(): basic Latin, digits and the
+// punctuation common in names and shields
+#define PREWARM_GLYPHS \
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789 .,:;-'()/&#"
+
 namespace Tangram {
 
 FontContext::FontContext() :
@@ -32,6 +39,16 @@ FontContext::FontContext() :
 
 void FontContext::loadFonts() {
 
+    // A context shared between Maps (see ShareGroup) gets here once per
+    // scene load, possibly while other scenes already shape with it -
+    // same locking as getFont(), and one load serves everyone.
+    std::lock(m_shapeMutex, m_mutex);
+    std::lock_guard<std::mutex> shapeLock(m_shapeMutex, std::adopt_lock);
+    std::lock_guard<std::mutex> lock(m_mutex, std::adopt_lock);
+
+    if (m_fontsLoaded) { return; }
+    m_fontsLoaded = true;
+
     // Load default fonts
     {
         std::string systemFont = systemFontPath("sans-serif", std::to_string(DEFAULT_BOLDNESS), "normal");
@@ -43,18 +60,17 @@ void FontContext::loadFonts() {
                 m_font[i] = m_alfons.addFont("default", alfons::InputSource(systemFont), size);
             }
         } else {
-            size_t dataSize;
-            char* data = reinterpret_cast<char*>(bytesFromFile(DEFAULT, dataSize));
+            // Map instead of copying - fonts are the largest files read
+            // at startup and the face loader only reads them once.
+            auto fontFile = mapFile(DEFAULT);
 
             LOG("Loading default font file %s", DEFAULT);
 
             for (int i = 0, size = BASE_SIZE; i < MAX_STEPS; i++, size += STEP_SIZE) {
-                m_font[i] = m_alfons.addFont("default", alfons::InputSource(data, dataSize), size);
+                m_font[i] = m_alfons.addFont("default", alfons::InputSource(fontFile.data(), fontFile.size()), size);
             }
 
-            if (data) {
-                free(data);
-            } else {
+            if (!fontFile) {
                 LOGW("Default font %s not found", DEFAULT);
             }
         }
@@ -67,29 +83,13 @@ void FontContext::loadFonts() {
         fallback = systemFontFallbackPath(importance++, DEFAULT_BOLDNESS);
 
         if (fallback.empty()) {
-            LOGW("No system font fallback, loading bundled fonts");
-
-            auto addFaces = [&](const char* path) {
-                size_t dataSize;
-                char* data = reinterpret_cast<char*>(bytesFromFile(path, dataSize));
-
-                if (data) {
-                    LOG("Adding bundled font at path %s", path);
-
-                    for (int i = 0, size = BASE_SIZE; i < MAX_STEPS; i++, size += STEP_SIZE) {
-                        m_font[i]->addFace(m_alfons.addFontFace(alfons::InputSource(data, dataSize), size));
-                    }
+            LOGW("No system font fallback, loading bundled fonts on demand");
 
-                    free(data);
-                } else {
-                    LOGE("Bundle font %s not found", path);
-                }
-            };
-
-            addFaces(FONT_AR);
-            addFaces(FONT_HE);
-            addFaces(FONT_JA);
-            addFaces(FALLBACK);
+            // The bundled fallbacks cover Arabic, Hebrew, Kana and the
+            // catch-all CJK set - tens of megabytes that a Latin-only
+            // session never shapes with. Their faces are added lazily by
+            // ensureGlyphCoverage() when a label first needs their script.
+            m_fallbacksPending = true;
         } else {
             // Add fallback system fonts faces paths
             while (!fallback.empty()) {
@@ -105,6 +105,102 @@ void FontContext::loadFonts() {
     }
 }
 
+// The bundled fallback fonts in the order their faces are appended
+static const std::array<const char*, 4> s_bundledFallbacks =
+    {{ FONT_AR, FONT_HE, FONT_JA, FALLBACK }};
+
+// Picks the bundled fallback covering a codepoint, or -1 when the default
+// font covers it. Over-triggering only costs a load that eager loading
+// always paid, so everything not clearly covered by the default font
+// routes to the catch-all DroidSansFallback.
+static int fallbackForCodepoint(uint32_t _codepoint) {
+
+    if (_codepoint < 0x0590) { return -1; } // Latin, Greek and Cyrillic
+    if (_codepoint < 0x0600) { return 1; }  // Hebrew
+
+    if (_codepoint < 0x0700 ||
+        (_codepoint >= 0x0750 && _codepoint < 0x0780) ||
+        (_codepoint >= 0x08a0 && _codepoint < 0x0900) ||
+        (_codepoint >= 0xfb50 && _codepoint < 0xfe00) ||
+        (_codepoint >= 0xfe70 && _codepoint < 0xff00)) { return 0; } // Arabic
+
+    // Latin Extended Additional, punctuation and currency
+    if (_codepoint >= 0x1e00 && _codepoint < 0x2100) { return -1; }
+
+    if (_codepoint >= 0x3040 && _codepoint < 0x3100) { return 2; } // Hiragana and Katakana
+
+    return 3;
+}
+
+void FontContext::ensureGlyphCoverage(const std::string& _text) {
+
+    if (!m_fallbacksPending.load(std::memory_order_relaxed)) { return; }
+
+    uint32_t needed = 0;
+
+    for (size_t i = 0; i < _text.size();) {
+        unsigned char byte = _text[i++];
+        uint32_t codepoint = byte;
+        int continuations = 0;
+
+        if (byte >= 0xf0) { codepoint = byte & 0x07; continuations = 3; }
+        else if (byte >= 0xe0) { codepoint = byte & 0x0f; continuations = 2; }
+        else if (byte >= 0xc0) { codepoint = byte & 0x1f; continuations = 1; }
+
+        for (; continuations > 0 && i < _text.size(); continuations--, i++) {
+            codepoint = (codepoint << 6) | (_text[i] & 0x3f);
+        }
+
+        int fallback = fallbackForCodepoint(codepoint);
+        if (fallback >= 0) { needed |= 1u << fallback; }
+    }
+
+    if (needed == 0) { return; }
+
+    loadPendingFallbacks(needed);
+}
+
+void FontContext::loadPendingFallbacks(uint32_t _needed) {
+
+    // Faces are added to fonts that other tile workers may be shaping
+    // with, take the shaping lock in addition to m_mutex
+    std::lock(m_shapeMutex, m_mutex);
+    std::lock_guard<std::mutex> shapeLock(m_shapeMutex, std::adopt_lock);
+    std::lock_guard<std::mutex> lock(m_mutex, std::adopt_lock);
+
+    for (size_t fallback = 0; fallback < s_bundledFallbacks.size(); fallback++) {
+        if (m_fallbackLoaded[fallback] || !(_needed & (1u << fallback))) { continue; }
+
+        // A missing file is not retried on every label
+        m_fallbackLoaded[fallback] = true;
+
+        const char* path = s_bundledFallbacks[fallback];
+        auto fontFile = mapFile(path);
+
+        if (!fontFile) {
+            LOGE("Bundle font %s not found", path);
+            continue;
+        }
+
+        LOG("Adding bundled font at path %s", path);
+
+        for (int i = 0, size = BASE_SIZE; i < MAX_STEPS; i++, size += STEP_SIZE) {
+            auto face = m_alfons.addFontFace(alfons::InputSource(fontFile.data(), fontFile.size()), size);
+
+            m_font[i]->addFace(face);
+
+            // Fonts created from the defaults copied their face list,
+            // append the new face to them as well
+            for (auto& font : m_derivedFonts[i]) { font->addFace(face); }
+        }
+    }
+
+    if (std::all_of(m_fallbackLoaded.begin(), m_fallbackLoaded.end(),
+                    [](bool _loaded) { return _loaded; })) {
+        m_fallbacksPending = false;
+    }
+}
+
 // Synchronized on m_mutex in layoutText(), called on tile-worker threads
 void FontContext::addTexture(alfons::AtlasID id, uint16_t width, uint16_t height) {
     if (m_textures.size() == max_textures) {
@@ -121,10 +217,8 @@ void FontContext::addGlyph(alfons::AtlasID id, uint16_t gx, uint16_t gy, uint16_
     if (id >= max_textures) { return; }
 
     auto& texData = m_textures[id].texData;
-    auto& texture = m_textures[id].texture;
 
     size_t stride = GlyphTexture::size;
-    size_t width =  GlyphTexture::size;
 
     unsigned char* dst = &texData[(gx + pad) + (gy + pad) * stride];
 
@@ -132,21 +226,65 @@ void FontContext::addGlyph(alfons::AtlasID id, uint16_t gx, uint16_t gy, uint16_
         std::memcpy(dst + (y * stride), src + pos, gw);
     }
 
-    dst = &texData[size_t(gx) + (size_t(gy) * width)];
     gw += pad * 2;
     gh += pad * 2;
 
-    size_t bytes = size_t(gw) * size_t(gh) * sizeof(float) * 3;
-    if (m_sdfBuffer.size() < bytes) {
-        m_sdfBuffer.resize(bytes);
-    }
+    // The SDF transform of this glyph is deferred: all glyphs of the
+    // layout run are transformed together in processPendingGlyphs()
+    // before the caller releases m_mutex. The padded border of the rect
+    // is still zero from the atlas page clear, so the coverage copied
+    // above completes the transform input.
+    m_pendingGlyphs.push_back({ id, gx, gy, gw, gh });
+}
+
+// Called on tile-worker threads with m_mutex held
+void FontContext::processPendingGlyphs() {
+
+    if (m_pendingGlyphs.empty()) { return; }
 
-    sdfBuildDistanceFieldNoAlloc(dst, width, m_sdfRadius,
-                                 dst, gw, gh, width,
-                                 &m_sdfBuffer[0]);
+    size_t width = GlyphTexture::size;
 
-    texture.setDirty(gy, gh);
-    m_textures[id].dirty = true;
+    auto transform = [&](const PendingGlyph& _glyph, unsigned char* _buffer) {
+        unsigned char* dst = &m_textures[_glyph.id].texData[size_t(_glyph.x) +
+                                                            size_t(_glyph.y) * width];
+        sdfBuildDistanceFieldNoAlloc(dst, width, m_sdfRadius,
+                                     dst, _glyph.w, _glyph.h, width,
+                                     _buffer);
+    };
+
+    if (m_pendingGlyphs.size() == 1) {
+        auto& glyph = m_pendingGlyphs[0];
+        size_t bytes = size_t(glyph.w) * size_t(glyph.h) * sizeof(float) * 3;
+        if (m_sdfBuffer.size() < bytes) {
+            m_sdfBuffer.resize(bytes);
+        }
+        transform(glyph, &m_sdfBuffer[0]);
+
+    } else {
+        // Glyph rects never overlap, so the transforms are independent.
+        // Fan them out over the shared pool; pool threads blocked on
+        // m_mutex cannot stall this, the calling thread claims ranges
+        // too. This is where a cold glyph cache - the first CJK-heavy
+        // view - spends most of its label latency.
+        size_t bytes = 0;
+        for (auto& glyph : m_pendingGlyphs) {
+            bytes = std::max(bytes, size_t(glyph.w) * size_t(glyph.h) * sizeof(float) * 3);
+        }
+
+        TaskExecutor::shared().forRanges(m_pendingGlyphs.size(), 4,
+                [&](size_t _begin, size_t _end) {
+                    std::vector<unsigned char> buffer(bytes);
+                    for (size_t i = _begin; i < _end; i++) {
+                        transform(m_pendingGlyphs[i], buffer.data());
+                    }
+                });
+    }
+
+    for (auto& glyph : m_pendingGlyphs) {
+        m_textures[glyph.id].texture.setDirty(glyph.y, glyph.h);
+        m_textures[glyph.id].dirty = true;
+    }
+    m_pendingGlyphs.clear();
 }
 
 void FontContext::releaseAtlas(std::bitset<max_textures> _refs) {
@@ -181,13 +319,106 @@ void FontContext::bindTexture(RenderState& rs, alfons::AtlasID _id, GLuint _unit
 
 }
 
+alfons::LineLayout FontContext::shape(std::shared_ptr<alfons::Font>& _font, const std::string& _text) {
+
+    std::lock_guard<std::mutex> lock(m_shapeMutex);
+
+    ShapingKey key { _font.get(), _text };
+
+    auto entry = m_shapingIndex.find(key);
+    if (entry != m_shapingIndex.end()) {
+        // Move the hit to the front of the LRU list
+        m_shapingCache.splice(m_shapingCache.begin(), m_shapingCache, entry->second);
+        return entry->second->layout;
+    }
+
+    alfons::LineLayout line = m_shaper.shape(_font, _text);
+
+    m_shapingCache.push_front({ key, _font, line });
+    m_shapingIndex.emplace(std::move(key), m_shapingCache.begin());
+
+    while (m_shapingCache.size() > max_shaping_entries) {
+        m_shapingIndex.erase(m_shapingCache.back().key);
+        m_shapingCache.pop_back();
+    }
+
+    return line;
+}
+
+float FontContext::wrapLine(const alfons::LineLayout& _line, alfons::Font* _font,
+                            const std::string& _text, size_t _maxLineChars) {
+
+    std::lock_guard<std::mutex> lock(m_shapeMutex);
+
+    auto entry = m_shapingIndex.find({ _font, _text });
+
+    if (entry != m_shapingIndex.end()) {
+        for (auto& wrap : entry->second->wraps) {
+            if (wrap.maxLineChars == _maxLineChars && wrap.scale == _line.scale()) {
+                m_textWrapper.setWraps(wrap.lineWraps);
+                return wrap.maxWidth;
+            }
+        }
+    }
+
+    float width = m_textWrapper.getShapeRangeWidth(_line, MIN_LINE_WIDTH, _maxLineChars);
+
+    // The entry may have been evicted since the layout was shaped; then
+    // the result is just used for this label
+    if (entry != m_shapingIndex.end()) {
+        entry->second->wraps.push_back({ _maxLineChars, _line.scale(),
+                                         width, m_textWrapper.wraps() });
+    }
+
+    return width;
+}
+
+void FontContext::prewarmGlyphs(const std::string& _glyphs) {
+
+    const std::string& glyphs = _glyphs.empty() ? PREWARM_GLYPHS : _glyphs;
+
+    // Cover any non-default scripts before taking the locks
+    ensureGlyphCoverage(glyphs);
+
+    std::lock(m_shapeMutex, m_mutex);
+    std::lock_guard<std::mutex> shapeLock(m_shapeMutex, std::adopt_lock);
+    std::lock_guard<std::mutex> lock(m_mutex, std::adopt_lock);
+
+    std::vector<GlyphQuad> quads;
+    m_scratch.quads = &quads;
+
+    for (auto& font : m_font) {
+        if (!font) { continue; }
+
+        alfons::LineLayout line = m_shaper.shape(font, glyphs);
+
+        glm::vec2 position(0);
+        alfons::LineMetrics metrics;
+        m_batch.drawShapeRange(line, 0, line.shapes().size(), position, metrics);
+    }
+
+    processPendingGlyphs();
+
+    // Pin the touched atlas pages so the prewarmed glyphs are not dropped
+    // with the last label that references them
+    std::bitset<max_textures> refs;
+    for (auto& quad : quads) {
+        if (!refs[quad.atlas]) {
+            refs[quad.atlas] = true;
+            m_atlasRefCount[quad.atlas]++;
+        }
+    }
+}
+
 bool FontContext::layoutText(TextStyle::Parameters& _params, const std::string& _text,
                              std::vector<GlyphQuad>& _quads, std::bitset<max_textures>& _refs,
                              glm::vec2& _size, TextRange& _textRanges) {
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    // Bundled fallback faces load on first use; make sure any scripts in
+    // _text are covered before shaping
+    ensureGlyphCoverage(_text);
 
-    alfons::LineLayout line = m_shaper.shape(_params.font, _text);
+    alfons::LineLayout line = shape(_params.font, _text);
 
     if (line.shapes().size() == 0) {
         LOGD("Empty text line");
@@ -196,6 +427,8 @@ bool FontContext::layoutText(TextStyle::Parameters& _params, const std::string&
 
     line.setScale(_params.fontScale);
 
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     // m_batch.drawShapeRange() calls FontContext's TextureCallback for new glyphs
     // and MeshCallback (drawGlyph) for vertex quads of each glyph in LineLayout.
 
@@ -218,11 +451,20 @@ bool FontContext::layoutText(TextStyle::Parameters& _params, const std::string&
         }
     }
 
+    // Sizing pre-pass: every visible shape emits at most one quad per
+    // laid-out alignment, so a single reservation covers the whole line
+    // and the glyph callbacks below append without reallocating.
+    size_t layouts = 1;
+    if (_params.wordWrap) {
+        layouts = std::max<size_t>(1, size_t(alignments[0]) + size_t(alignments[1])
+                                      + size_t(alignments[2]));
+    }
+    _quads.reserve(_quads.size() + line.shapes().size() * layouts);
+
     if (_params.wordWrap) {
         m_textWrapper.clearWraps();
 
-        float width = m_textWrapper.getShapeRangeWidth(line, MIN_LINE_WIDTH,
-                                                       _params.maxLineWidth);
+        float width = wrapLine(line, _params.font.get(), _text, _params.maxLineWidth);
 
         for (size_t i = 0; i < 3; i++) {
 
@@ -256,6 +498,8 @@ bool FontContext::layoutText(TextStyle::Parameters& _params, const std::string&
         _textRanges[2] = Range(rangeEnd, 0);
     }
 
+    processPendingGlyphs();
+
     auto it = _quads.begin() + quadsStart;
     if (it == _quads.end()) {
         // No glyphs added
@@ -290,8 +534,11 @@ bool FontContext::layoutText(TextStyle::Parameters& _params, const std::string&
 
 void FontContext::addFont(const FontDescription& _ft, const alfons::InputSource& _source) {
 
-    // NB: Synchronize for calls from download thread
-    std::lock_guard<std::mutex> lock(m_mutex);
+    // NB: Synchronize for calls from download thread. The shaping lock is
+    // taken as well since tile workers may be shaping with these fonts.
+    std::lock(m_shapeMutex, m_mutex);
+    std::lock_guard<std::mutex> shapeLock(m_shapeMutex, std::adopt_lock);
+    std::lock_guard<std::mutex> lock(m_mutex, std::adopt_lock);
 
     for (int i = 0, size = BASE_SIZE; i < MAX_STEPS; i++, size += STEP_SIZE) {
         auto font = m_alfons.getFont(_ft.alias, size);
@@ -299,6 +546,11 @@ void FontContext::addFont(const FontDescription& _ft, const alfons::InputSource&
 
         // add fallbacks from default font
         font->addFaces(*m_font[i]);
+
+        if (m_fallbacksPending &&
+            std::find(m_derivedFonts[i].begin(), m_derivedFonts[i].end(), font) == m_derivedFonts[i].end()) {
+            m_derivedFonts[i].push_back(font);
+        }
     }
 }
 
@@ -329,40 +581,41 @@ std::shared_ptr<alfons::Font> FontContext::getFont(const std::string& _family, c
         fontSize += STEP_SIZE;
     }
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    // Faces may be added to a font that tile workers are shaping with,
+    // take the shaping lock in addition to m_mutex
+    std::lock(m_shapeMutex, m_mutex);
+    std::lock_guard<std::mutex> shapeLock(m_shapeMutex, std::adopt_lock);
+    std::lock_guard<std::mutex> lock(m_mutex, std::adopt_lock);
 
     auto font =  m_alfons.getFont(FontDescription::Alias(_family, _style, _weight), fontSize);
     if (font->hasFaces()) { return font; }
 
-    unsigned char* data = nullptr;
-    size_t dataSize = 0;
-
     // Assuming bundled ttf file follows this convention
     std::string bundleFontPath = m_sceneResourceRoot + "fonts/" +
         FontDescription::BundleAlias(_family, _style, _weight);
 
-    data = bytesFromFile(bundleFontPath.c_str(), dataSize);
+    auto fontFile = mapFile(bundleFontPath.c_str());
 
-    if (!data) {
+    if (!fontFile) {
         // Try fallback
         std::string sysFontPath = systemFontPath(_family, _weight, _style);
-        data = bytesFromFile(sysFontPath.c_str(), dataSize);
+        fontFile = mapFile(sysFontPath.c_str());
 
-        if (!data) {
+        if (!fontFile) {
             LOGN("Could not load font file %s", FontDescription::BundleAlias(_family, _style, _weight).c_str());
 
             // add fallbacks from default font
             font->addFaces(*m_font[sizeIndex]);
+            if (m_fallbacksPending) { m_derivedFonts[sizeIndex].push_back(font); }
             return font;
         }
     }
 
-    font->addFace(m_alfons.addFontFace(alfons::InputSource(reinterpret_cast<char*>(data), dataSize), fontSize));
-
-    free(data);
+    font->addFace(m_alfons.addFontFace(alfons::InputSource(fontFile.data(), fontFile.size()), fontSize));
 
     // add fallbacks from default font
     font->addFaces(*m_font[sizeIndex]);
+    if (m_fallbacksPending) { m_derivedFonts[sizeIndex].push_back(font); }
 
     return font;
 }
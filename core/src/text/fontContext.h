@@ -15,9 +15,13 @@
 #include "alfons/inputSource.h"
 
 #include "gl/texture.h"
+#include "util/hash.h"
 
+#include <atomic>
 #include <bitset>
+#include <list>
 #include <mutex>
+#include <unordered_map>
 
 namespace Tangram {
 
@@ -109,6 +113,19 @@ public:
                     std::vector<GlyphQuad>& _quads, std::bitset<max_textures>& _refs,
                     glm::vec2& _bbox, TextRange& _textRanges);
 
+    /* Synchronized on m_shapeMutex, called on tile-worker threads.
+     * Shapes _text with _font, or returns a copy of the cached layout when
+     * the same string was shaped with the same font before. Repeated names
+     * (roads, shields) make the cache hit on most labels of a tile. */
+    alfons::LineLayout shape(std::shared_ptr<alfons::Font>& _font, const std::string& _text);
+
+    /* Rasterizes the glyphs of _glyphs with the default fonts at every
+     * standard size, so the first labels do not pay the SDF rasterization
+     * burst on a tile worker. Pass an empty string for the built-in
+     * Latin + digits set. Synchronized like layoutText, meant to run on
+     * a background worker at scene load. */
+    void prewarmGlyphs(const std::string& _glyphs = "");
+
     struct ScratchBuffer : public alfons::MeshCallback {
         void drawGlyph(const alfons::Quad& q, const alfons::AtlasGlyph& altasGlyph) override {}
         void drawGlyph(const alfons::Rect& q, const alfons::AtlasGlyph& atlasGlyph) override;
@@ -121,17 +138,114 @@ public:
 
 private:
 
+    static constexpr int max_shaping_entries = 512;
+
+    // The font pointer identifies family, style, weight and base size;
+    // the scale applied after shaping does not affect the layout
+    struct ShapingKey {
+        alfons::Font* font;
+        std::string text;
+
+        bool operator==(const ShapingKey& _other) const {
+            return font == _other.font && text == _other.text;
+        }
+    };
+
+    struct ShapingKeyHash {
+        size_t operator()(const ShapingKey& _key) const {
+            std::size_t seed = 0;
+            hash_combine(seed, _key.font);
+            hash_combine(seed, _key.text);
+            return seed;
+        }
+    };
+
+    struct ShapingEntry {
+        ShapingKey key;
+        // Pins the font of the key
+        std::shared_ptr<alfons::Font> font;
+        alfons::LineLayout layout;
+
+        // Wrap results computed from this layout: identical names wrap
+        // identically in every tile, so line breaking runs once per
+        // (text, wrap width, scale) instead of once per label
+        struct Wrap {
+            size_t maxLineChars;
+            float scale;
+            float maxWidth;
+            TextWrapper::LineWraps lineWraps;
+        };
+        std::vector<Wrap> wraps;
+    };
+
+    /* Computes the line breaks of _line into m_textWrapper, reusing the
+     * result stored with the shaping entry of (_font, _text) when the same
+     * text was wrapped at the same width and scale before. Returns the
+     * width of the widest line. Takes m_shapeMutex; called on tile-worker
+     * threads with m_mutex held. */
+    float wrapLine(const alfons::LineLayout& _line, alfons::Font* _font,
+                   const std::string& _text, size_t _maxLineChars);
+
+    /* Loads any still pending bundled fallback fonts whose scripts appear
+     * in _text, so shaping sees their faces. Returns immediately once all
+     * fallbacks are loaded; called on tile-worker threads. */
+    void ensureGlyphCoverage(const std::string& _text);
+
+    /* Maps and adds the faces of the pending fallbacks in _needed (one bit
+     * per entry of the bundled fallback table) to the default fonts and to
+     * every font derived from them. Takes m_shapeMutex and m_mutex. */
+    void loadPendingFallbacks(uint32_t _needed);
+
+    /* Runs the deferred SDF transform over every glyph queued by
+     * addGlyph() since the last call, fanning the independent glyphs
+     * out over the shared TaskExecutor, then marks the touched texture
+     * rows dirty. Called with m_mutex still held so the texture upload
+     * never sees half-transformed glyph data. */
+    void processPendingGlyphs();
+
+    // Glyphs whose coverage was copied into the atlas but whose SDF
+    // transform is still pending; drained by processPendingGlyphs()
+    // before layoutText() or prewarmGlyphs() release m_mutex.
+    struct PendingGlyph {
+        alfons::AtlasID id;
+        uint16_t x, y, w, h;
+    };
+    std::vector<PendingGlyph> m_pendingGlyphs;
+
     float m_sdfRadius;
     ScratchBuffer m_scratch;
     std::vector<unsigned char> m_sdfBuffer;
 
     std::mutex m_mutex;
+
+    // Guards m_shaper and the shaping cache. Kept separate from m_mutex so
+    // tile workers resolving repeated strings from the cache do not
+    // serialize on the atlas and texture state.
+    std::mutex m_shapeMutex;
+
+    // Shaping results in most-recently-used order with a lookup index
+    std::list<ShapingEntry> m_shapingCache;
+    std::unordered_map<ShapingKey, std::list<ShapingEntry>::iterator, ShapingKeyHash> m_shapingIndex;
+
     std::array<int, max_textures> m_atlasRefCount = {{0}};
     alfons::GlyphAtlas m_atlas;
 
     alfons::FontManager m_alfons;
     std::array<std::shared_ptr<alfons::Font>, 3> m_font;
 
+    // Guards against repeated loadFonts() on a context shared between
+    // scenes; the default faces only load once
+    bool m_fontsLoaded = false;
+
+    // Set when loadFonts() deferred the bundled fallback fonts; checked per
+    // label so Latin-only sessions skip their I/O entirely
+    std::atomic<bool> m_fallbacksPending{false};
+    std::array<bool, 4> m_fallbackLoaded = {{ false, false, false, false }};
+
+    // Fonts that copied the default font's face list, per size step; faces
+    // of lazily loaded fallbacks are appended to them as well
+    std::array<std::vector<std::shared_ptr<alfons::Font>>, 3> m_derivedFonts;
+
     std::vector<GlyphTexture> m_textures;
 
     // TextShaper to create <LineLayout> for a given text and Font
@@ -14,11 +14,19 @@ class TextWrapper {
 
 public:
 
+    using LineWraps = std::vector<std::pair<int, float>>;
+
     float getShapeRangeWidth(const alfons::LineLayout& _line,
         size_t _minLineChars, size_t _maxLineChars);
 
     void clearWraps();
 
+    /* The computed line breaks as (end shape, line width) pairs */
+    const LineWraps& wraps() const { return m_lineWraps; }
+
+    /* Restore line breaks computed for the same layout before */
+    void setWraps(const LineWraps& _wraps) { m_lineWraps = _wraps; }
+
     /* Wrap an Alfons line layout, and draw the glyph quads to the TextBatch.
      *
      * This method is not threadsafe!
@@ -36,7 +44,7 @@ public:
              alfons::LineMetrics& _metrics);
 
 private:
-    std::vector<std::pair<int,float>> m_lineWraps;
+    LineWraps m_lineWraps;
 };
 
 }
@@ -0,0 +1,168 @@
+#include "tile/featureIndex.h"
+
+#include "data/tileData.h"
+
+#include "glm/common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Tangram {
+
+namespace {
+
+// Interleave the lower 16 bits of _x with zeros
+uint32_t interleave(uint32_t _x) {
+    _x &= 0x0000ffff;
+    _x = (_x | (_x << 8)) & 0x00ff00ff;
+    _x = (_x | (_x << 4)) & 0x0f0f0f0f;
+    _x = (_x | (_x << 2)) & 0x33333333;
+    _x = (_x | (_x << 1)) & 0x55555555;
+    return _x;
+}
+
+// Position of _point on the z-order curve of the unit square
+uint32_t zOrder(glm::vec2 _point) {
+    glm::vec2 p = glm::clamp(_point, 0.f, 1.f);
+    return interleave(uint32_t(p.x * 65535.f)) |
+          (interleave(uint32_t(p.y * 65535.f)) << 1);
+}
+
+// Distance of _point to the box (_min, _max); 0 inside the box
+float boxDistance(glm::vec2 _point, glm::vec2 _min, glm::vec2 _max) {
+    float dx = std::max(std::max(_min.x - _point.x, 0.f), _point.x - _max.x);
+    float dy = std::max(std::max(_min.y - _point.y, 0.f), _point.y - _max.y);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+}
+
+void FeatureIndex::add(const Feature& _feature) {
+
+    glm::vec2 min(std::numeric_limits<float>::max());
+    glm::vec2 max(std::numeric_limits<float>::lowest());
+
+    auto grow = [&](const Point& _point) {
+        min = glm::min(min, glm::vec2(_point));
+        max = glm::max(max, glm::vec2(_point));
+    };
+
+    switch (_feature.geometryType) {
+        case GeometryType::points:
+            for (const auto& point : _feature.points) { grow(point); }
+            break;
+        case GeometryType::lines:
+            for (const auto& line : _feature.lines) {
+                for (const auto& point : line) { grow(point); }
+            }
+            break;
+        case GeometryType::polygons:
+            for (const auto& polygon : _feature.polygons) {
+                // The outer ring bounds the holes
+                if (!polygon.empty()) {
+                    for (const auto& point : polygon.front()) { grow(point); }
+                }
+            }
+            break;
+        default:
+            return;
+    }
+
+    if (min.x > max.x) { return; }
+
+    m_entries.push_back({ min, max, std::make_shared<Properties>(_feature.props) });
+}
+
+void FeatureIndex::build() {
+
+    if (m_entries.empty()) { return; }
+
+    // Pack the entries along the z-order curve so that nearby features
+    // end up in the same node
+    std::sort(m_entries.begin(), m_entries.end(),
+              [](const Entry& _a, const Entry& _b) {
+                  return zOrder((_a.min + _a.max) * 0.5f) <
+                         zOrder((_b.min + _b.max) * 0.5f);
+              });
+
+    // Build the leaf nodes over the entries, then one level of nodes over
+    // the previous level until a single root remains
+    size_t childStart = 0;
+    size_t childCount = m_entries.size();
+    bool childrenAreEntries = true;
+
+    do {
+        size_t nodeStart = m_nodes.size();
+
+        for (size_t i = 0; i < childCount; i += node_size) {
+            Node node;
+            node.first = uint32_t(childStart + i);
+            node.count = uint32_t(std::min(node_size, childCount - i));
+            node.min = glm::vec2(std::numeric_limits<float>::max());
+            node.max = glm::vec2(std::numeric_limits<float>::lowest());
+
+            for (uint32_t c = node.first; c < node.first + node.count; c++) {
+                node.min = glm::min(node.min, childrenAreEntries ? m_entries[c].min : m_nodes[c].min);
+                node.max = glm::max(node.max, childrenAreEntries ? m_entries[c].max : m_nodes[c].max);
+            }
+            m_nodes.push_back(node);
+        }
+
+        if (childrenAreEntries) {
+            m_leafNodes = m_nodes.size();
+            childrenAreEntries = false;
+        }
+
+        childStart = nodeStart;
+        childCount = m_nodes.size() - nodeStart;
+
+    } while (childCount > 1);
+}
+
+void FeatureIndex::query(glm::vec2 _point, float _radius,
+                         std::vector<Result>& _results) const {
+
+    if (m_nodes.empty()) { return; }
+
+    glm::vec2 queryMin = _point - _radius;
+    glm::vec2 queryMax = _point + _radius;
+
+    std::vector<uint32_t> stack;
+    stack.push_back(uint32_t(m_nodes.size() - 1));
+
+    while (!stack.empty()) {
+        uint32_t index = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_nodes[index];
+
+        if (node.min.x > queryMax.x || node.max.x < queryMin.x ||
+            node.min.y > queryMax.y || node.max.y < queryMin.y) {
+            continue;
+        }
+
+        if (index < m_leafNodes) {
+            for (uint32_t c = node.first; c < node.first + node.count; c++) {
+                const Entry& entry = m_entries[c];
+
+                if (entry.min.x > queryMax.x || entry.max.x < queryMin.x ||
+                    entry.min.y > queryMax.y || entry.max.y < queryMin.y) {
+                    continue;
+                }
+                _results.emplace_back(&entry, boxDistance(_point, entry.min, entry.max));
+            }
+        } else {
+            for (uint32_t c = node.first; c < node.first + node.count; c++) {
+                stack.push_back(c);
+            }
+        }
+    }
+}
+
+size_t FeatureIndex::getMemoryUsage() const {
+    return m_entries.capacity() * sizeof(Entry) +
+           m_nodes.capacity() * sizeof(Node);
+}
+
+}
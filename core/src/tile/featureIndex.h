@@ -0,0 +1,71 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace Tangram {
+
+struct Feature;
+struct Properties;
+
+/* Packed R-tree over the bounds of the interactive features of one tile
+ *
+ * The index is filled on a tile worker while draw rules are applied and
+ * packed once with build(). Entries keep a copy of the feature properties,
+ * so picking resolves against polygons and lines that produced no label,
+ * without the GPU read-back path. All coordinates are tile-local, see the
+ * description in tileData.h.
+ */
+class FeatureIndex {
+
+public:
+
+    struct Entry {
+        glm::vec2 min;
+        glm::vec2 max;
+        std::shared_ptr<Properties> properties;
+    };
+
+    /* An entry together with its distance to the query point, in tile units */
+    using Result = std::pair<const Entry*, float>;
+
+    /* Add the bounds of _feature to the index */
+    void add(const Feature& _feature);
+
+    /* Pack the entries into the tree. add() must not be called afterwards. */
+    void build();
+
+    /* Append a <Result> for each entry whose bounds intersect the box of
+     * half-width _radius around _point */
+    void query(glm::vec2 _point, float _radius, std::vector<Result>& _results) const;
+
+    bool empty() const { return m_entries.empty(); }
+
+    size_t getMemoryUsage() const;
+
+private:
+
+    /* Children per node; two levels cover 256 features, three 4096 */
+    static constexpr size_t node_size = 16;
+
+    struct Node {
+        glm::vec2 min;
+        glm::vec2 max;
+        /* Index of the first child into m_nodes, or into m_entries for
+         * leaf nodes */
+        uint32_t first;
+        uint32_t count;
+    };
+
+    std::vector<Entry> m_entries;
+
+    /* Nodes of all levels, leaves first, the root last */
+    std::vector<Node> m_nodes;
+
+    /* Nodes below this index are leaves whose children are entries */
+    size_t m_leafNodes = 0;
+};
+
+}
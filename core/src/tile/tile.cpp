@@ -1,9 +1,11 @@
 #include "tile.h"
 
+#include "tangram.h"
 #include "data/dataSource.h"
 #include "style/style.h"
 #include "view/view.h"
 #include "tile/tileID.h"
+#include "tile/featureIndex.h"
 #include "labels/labelSet.h"
 
 #include "glm/gtc/matrix_transform.hpp"
@@ -29,6 +31,10 @@ Tile::Tile(TileID _id, const MapProjection& _projection, const DataSource* _sour
 
 Tile::~Tile() {}
 
+void Tile::setBuildStats(std::unique_ptr<TileBuildStats> _stats) {
+    m_buildStats = std::move(_stats);
+}
+
 //Note: This could set tile origin to be something different than the one if TileID's wrap is used.
 // But, this is required for wrapped tiles which are picked up from the cache
 void Tile::updateTileOrigin(const int _wrap) {
@@ -59,6 +65,33 @@ void Tile::update(float _dt, const View& _view) {
     m_mvp = _view.getViewProjectionMatrix() * m_modelMatrix;
 }
 
+bool Tile::isOutsideFrustum() const {
+
+    // Corners of the tile's bounding box in tile-local coordinates. The box
+    // extends above the ground plane to cover extruded geometry; a quarter
+    // of the tile span is a generous allowance for building heights.
+    static const glm::vec4 corners[8] = {
+        { 0.f, 0.f, 0.f,   1.f }, { 1.f, 0.f, 0.f,   1.f },
+        { 1.f, 1.f, 0.f,   1.f }, { 0.f, 1.f, 0.f,   1.f },
+        { 0.f, 0.f, 0.25f, 1.f }, { 1.f, 0.f, 0.25f, 1.f },
+        { 1.f, 1.f, 0.25f, 1.f }, { 0.f, 1.f, 0.25f, 1.f },
+    };
+
+    // The box is culled only when all corners lie beyond the same clip
+    // plane. The plane distances are linear in homogeneous coordinates, so
+    // the test stays correct for corners behind the eye.
+    int left = 0, right = 0, bottom = 0, top = 0;
+    for (const auto& corner : corners) {
+        glm::vec4 c = m_mvp * corner;
+        if (c.x + c.w < 0.f) { left++; }
+        if (c.w - c.x < 0.f) { right++; }
+        if (c.y + c.w < 0.f) { bottom++; }
+        if (c.w - c.y < 0.f) { top++; }
+    }
+
+    return left == 8 || right == 8 || bottom == 8 || top == 8;
+}
+
 void Tile::resetState() {
     for (auto& entry : m_geometry) {
         if (!entry) { continue; }
@@ -76,6 +109,10 @@ void Tile::setMesh(const Style& _style, std::unique_ptr<StyledMesh> _mesh) {
     m_geometry[_style.getID()] = std::move(_mesh);
 }
 
+void Tile::setFeatureIndex(std::unique_ptr<FeatureIndex> _index) {
+    m_featureIndex = std::move(_index);
+}
+
 const std::unique_ptr<StyledMesh>& Tile::getMesh(const Style& _style) const {
     static std::unique_ptr<StyledMesh> NONE = nullptr;
     if (_style.getID() >= m_geometry.size()) { return NONE; }
@@ -90,6 +127,9 @@ size_t Tile::getMemoryUsage() const {
                 m_memoryUsage += entry->bufferSize();
             }
         }
+        if (m_featureIndex) {
+            m_memoryUsage += m_featureIndex->getMemoryUsage();
+        }
     }
 
     return m_memoryUsage;
@@ -13,10 +13,12 @@
 namespace Tangram {
 
 class DataSource;
+class FeatureIndex;
 class MapProjection;
 class Style;
 class View;
 struct StyledMesh;
+struct TileBuildStats;
 
 struct Raster {
     TileID tileID;
@@ -68,12 +70,23 @@ public:
 
     void setMesh(const Style& _style, std::unique_ptr<StyledMesh> _mesh);
 
+    /* Attach the spatial index of this tile's interactive features */
+    void setFeatureIndex(std::unique_ptr<FeatureIndex> _index);
+
+    /* Returns the spatial index of interactive features, or null when the
+     * tile has none; see <FeatureIndex> */
+    const FeatureIndex* featureIndex() const { return m_featureIndex.get(); }
+
     auto& rasters() { return m_rasters; }
     const auto& rasters() const { return m_rasters; }
 
     /* Update the Tile considering the current view */
     void update(float _dt, const View& _view);
 
+    /* Returns true if the tile's bounding volume lies entirely outside the
+     * view frustum of the most recent update() */
+    bool isOutsideFrustum() const;
+
     /* Update tile origin based on wraping for this tile */
     void updateTileOrigin(const int _wrap);
 
@@ -90,6 +103,13 @@ public:
 
     void setProxyState(bool isProxy) { m_proxyState = isProxy; }
 
+    /* Attach the content counters recorded during the build */
+    void setBuildStats(std::unique_ptr<TileBuildStats> _stats);
+
+    /* Content counters recorded while this tile was built, or null for
+     * tiles restored from the mesh cache; see Map::getTileContentStats */
+    const TileBuildStats* buildStats() const { return m_buildStats.get(); }
+
 private:
 
     const TileID m_id;
@@ -121,6 +141,12 @@ private:
     std::vector<std::unique_ptr<StyledMesh>> m_geometry;
     std::vector<Raster> m_rasters;
 
+    // Spatial index of interactive features for CPU picking
+    std::unique_ptr<FeatureIndex> m_featureIndex;
+
+    // Per-style content counters of the build, see buildStats()
+    std::unique_ptr<TileBuildStats> m_buildStats;
+
     mutable size_t m_memoryUsage = 0;
 };
 
@@ -1,15 +1,30 @@
 #include "tile/tileBuilder.h"
 
+#include "tangram.h"
 #include "data/dataSource.h"
+#include "data/tileData.h"
+#include "debug/allocStats.h"
+#include "debug/trace.h"
 #include "gl/mesh.h"
 #include "scene/dataLayer.h"
 #include "scene/scene.h"
 #include "style/style.h"
+#include "tile/featureIndex.h"
 #include "tile/tile.h"
+#include "util/builders.h"
+#include "util/geom.h"
 #include "util/mapProjection.h"
 
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
+
 namespace Tangram {
 
+bool TileBuilder::s_parallelMeshBuild = false;
+bool TileBuilder::s_clipGeometry = false;
+
 TileBuilder::TileBuilder(std::shared_ptr<Scene> _scene)
     : m_scene(_scene) {
 
@@ -30,23 +45,157 @@ StyleBuilder* TileBuilder::getStyleBuilder(const std::string& _name) {
     return it->second.get();
 }
 
-std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileData, const DataSource& _source) {
+void TileBuilder::indexFeature(const Feature& _feature) {
+    if (m_lastIndexedFeature == &_feature) { return; }
+    m_lastIndexedFeature = &_feature;
+
+    m_featureIndex->add(_feature);
+}
+
+const std::vector<std::string>* TileBuilder::referencedCollections(const DataSource& _source) {
+
+    auto it = m_referencedCollections.find(_source.id());
+    if (it != m_referencedCollections.end()) { return &it->second; }
+
+    auto& collections = m_referencedCollections[_source.id()];
+
+    for (const auto& datalayer : m_scene->layers()) {
+        if (datalayer.source() != _source.name()) { continue; }
+
+        for (const auto& collection : datalayer.collections()) {
+            if (std::find(collections.begin(), collections.end(),
+                          collection) == collections.end()) {
+                collections.push_back(collection);
+            }
+        }
+    }
+    return &collections;
+}
+
+std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, TileData& _tileData, const DataSource& _source,
+                                         const TileTask* _task) {
+
+    auto canceled = [&]() { return _task && _task->isCanceled(); };
+
+    // Styles drawing the same lines share tessellated batches for the
+    // duration of this build; see Builders::beginPolyLineCache().
+    struct PolyLineCacheScope {
+        PolyLineCacheScope() { Builders::beginPolyLineCache(); }
+        ~PolyLineCacheScope() { Builders::endPolyLineCache(); }
+    } polyLineCacheScope;
 
     auto tile = std::make_shared<Tile>(_tileID, *m_scene->mapProjection(), &_source);
 
     tile->initGeometry(m_scene->styles().size());
 
+    float tileSize = m_scene->mapProjection()->TileSize() * m_scene->pixelScale();
+
+    // Content counters for scene tuning; attached to the tile and
+    // retrievable through Map::getTileContentStats
+    auto stats = std::make_unique<TileBuildStats>();
+    auto* buildStats = stats.get();
+    buildStats->zoom = _tileID.z;
+    buildStats->x = _tileID.x;
+    buildStats->y = _tileID.y;
+
+    auto stageStart = std::chrono::steady_clock::now();
+    auto stageMs = [&stageStart]() {
+        auto now = std::chrono::steady_clock::now();
+        float ms = std::chrono::duration<float, std::milli>(now - stageStart).count();
+        stageStart = now;
+        return ms;
+    };
+
+    if (_source.simplifyGeometry() && !(_task && _task->sharedTileData())) {
+        // Simplify lines and polygon rings to half-pixel tolerance before
+        // the style builders tessellate them; overview tiles usually carry
+        // more detail than the pixel grid can show. Overzoomed tiles are
+        // drawn magnified by 2^(s-z) and keep correspondingly more of it.
+        // Data shared between overzoomed siblings is left untouched, since
+        // another worker may be reading it.
+        int overzoom = std::min(std::max(_tileID.s - _tileID.z, 0), 16);
+        float tolerance = 0.5f / (tileSize * float(1 << overzoom));
+
+        for (auto& collection : _tileData.layers) {
+            for (auto& feature : collection.features) {
+                if (feature.geometryType == GeometryType::lines) {
+                    for (auto& line : feature.lines) {
+                        simplifyLine(line, tolerance);
+                    }
+                } else if (feature.geometryType == GeometryType::polygons) {
+                    for (auto& polygon : feature.polygons) {
+                        for (auto& ring : polygon) {
+                            simplifyLine(ring, tolerance);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (s_clipGeometry && !(_task && _task->sharedTileData())) {
+        // Clip geometry to the padded tile bounds so only what can show up
+        // on screen reaches the tessellators. The padding matches typical
+        // source tile buffers (64-128 units of a 4096 extent), so edge
+        // geometry - wide lines, joins - still meets up between tiles.
+        float pad = 1.f / 16.f;
+
+        for (auto& collection : _tileData.layers) {
+            for (auto& feature : collection.features) {
+                if (feature.geometryType == GeometryType::lines) {
+                    auto clipped = decltype(feature.lines)(feature.lines.get_allocator());
+                    for (auto& line : feature.lines) {
+                        clipLine(line, -pad, 1.f + pad, clipped);
+                    }
+                    feature.lines = std::move(clipped);
+                } else if (feature.geometryType == GeometryType::polygons) {
+                    for (auto& polygon : feature.polygons) {
+                        for (auto& ring : polygon) {
+                            clipPolygonRing(ring, -pad, 1.f + pad);
+                        }
+                        polygon.erase(std::remove_if(polygon.begin(), polygon.end(),
+                                                     [](const Line& ring) { return ring.empty(); }),
+                                      polygon.end());
+                    }
+                    feature.polygons.erase(std::remove_if(feature.polygons.begin(), feature.polygons.end(),
+                                                          [](const Polygon& p) { return p.empty(); }),
+                                           feature.polygons.end());
+                }
+            }
+        }
+    }
+
+    buildStats->prepareMs = stageMs();
+
     m_styleContext.setKeywordZoom(_tileID.s);
 
+    // Memoized rule evaluations depend on the tile zoom
+    m_ruleSet.clearCache();
+
+    m_featureIndex = std::make_unique<FeatureIndex>();
+    m_lastIndexedFeature = nullptr;
+
     for (auto& builder : m_styleBuilder) {
-        if (builder.second)
+        if (builder.second) {
             builder.second->setup(*tile);
+            builder.second->clearFeatureCount();
+        }
     }
 
+    // Setup time is not attributed to any stage
+    stageStart = std::chrono::steady_clock::now();
+
     for (const auto& datalayer : m_scene->layers()) {
 
+        // Bail out between layers once the tile left the view.
+        if (canceled()) { return nullptr; }
+
         if (datalayer.source() != _source.name()) { continue; }
 
+        // Layers whose filters can never pass at this zoom are skipped
+        // wholesale; the per-feature geometry check happens in apply().
+        if (!datalayer.bounds().matchZoom(_tileID.s)) { continue; }
+
         for (const auto& collection : _tileData.layers) {
 
             if (!collection.name.empty()) {
@@ -63,17 +212,125 @@ std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileDa
         }
     }
 
+    buildStats->rulesMs = stageMs();
+
+    if (canceled()) { return nullptr; }
+
+    if (!m_featureIndex->empty()) {
+        m_featureIndex->build();
+        tile->setFeatureIndex(std::move(m_featureIndex));
+    }
+
     for (auto& builder : m_styleBuilder) {
 
         builder.second->addLayoutItems(m_labelLayout);
     }
 
-    float tileSize = m_scene->mapProjection()->TileSize() * m_scene->pixelScale();
-
     m_labelLayout.process(_tileID, tile->getInverseScale(), tileSize);
 
+    // Feature counts are final here; attach the stats before the mesh
+    // stage so the heatmap debug style can read them while building. The
+    // entries are only extended after the mesh builds have joined.
+    for (auto& builder : m_styleBuilder) {
+        size_t features = builder.second->featureCount();
+        if (features == 0) { continue; }
+
+        TileBuildStats::StyleStats entry;
+        entry.style = builder.second->style().getName();
+        entry.features = features;
+        buildStats->styles.push_back(std::move(entry));
+    }
+    tile->setBuildStats(std::move(stats));
+
+    stageStart = std::chrono::steady_clock::now();
+
+    std::vector<std::pair<StyleBuilder*, float>> buildTimes;
+    buildTimes.reserve(m_styleBuilder.size());
+
+    if (s_parallelMeshBuild && m_styleBuilder.size() > 1) {
+
+        // Each StyleBuilder writes an independent mesh, so the per-style
+        // build stage can run on multiple cores. Builders are dealt out
+        // round-robin to a few helper threads; the meshes are attached to
+        // the tile sequentially after the join.
+        size_t jobs = std::min<size_t>(m_styleBuilder.size(),
+                                       std::max(1u, std::thread::hardware_concurrency() / 2));
+
+        std::vector<std::pair<StyleBuilder*, std::unique_ptr<StyledMesh>>> meshes;
+        meshes.reserve(m_styleBuilder.size());
+        for (auto& builder : m_styleBuilder) {
+            meshes.emplace_back(builder.second.get(), nullptr);
+        }
+
+        std::vector<float> meshTimes(meshes.size(), 0.f);
+
+        std::vector<std::future<void>> results;
+        for (size_t job = 0; job < jobs; job++) {
+            results.push_back(std::async(std::launch::async, [&, job]{
+                        for (size_t i = job; i < meshes.size(); i += jobs) {
+                            TRACE_SCOPE("build " + meshes[i].first->style().getName());
+                            ALLOC_TAG(styleBuild);
+                            auto start = std::chrono::steady_clock::now();
+                            meshes[i].second = meshes[i].first->build();
+                            meshTimes[i] = std::chrono::duration<float, std::milli>(
+                                    std::chrono::steady_clock::now() - start).count();
+                        }
+                    }));
+        }
+        for (auto& result : results) { result.wait(); }
+
+        if (canceled()) { return nullptr; }
+
+        for (size_t i = 0; i < meshes.size(); i++) {
+            buildTimes.emplace_back(meshes[i].first, meshTimes[i]);
+            tile->setMesh(meshes[i].first->style(), std::move(meshes[i].second));
+        }
+
+    } else {
+        for (auto& builder : m_styleBuilder) {
+            // The canceled state is also checked between per-style mesh
+            // builds, the styles already finished are discarded with the
+            // tile.
+            if (canceled()) { return nullptr; }
+
+            TRACE_SCOPE("build " + builder.second->style().getName());
+            ALLOC_TAG(styleBuild);
+            auto start = std::chrono::steady_clock::now();
+            tile->setMesh(builder.second->style(), builder.second->build());
+            buildTimes.emplace_back(builder.second.get(),
+                                    std::chrono::duration<float, std::milli>(
+                                            std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    buildStats->meshMs = stageMs();
+
+    // Complete the per-style entries with what the mesh builds produced
     for (auto& builder : m_styleBuilder) {
-        tile->setMesh(builder.second->style(), builder.second->build());
+        const auto& style = builder.second->style();
+        const auto& mesh = tile->getMesh(style);
+
+        size_t vertices = mesh ? mesh->vertexCount() : 0;
+        size_t labels = mesh ? mesh->labelCount() : 0;
+        if (vertices == 0 && labels == 0) { continue; }
+
+        auto entry = std::find_if(buildStats->styles.begin(), buildStats->styles.end(),
+                                  [&](const auto& s) { return s.style == style.getName(); });
+        if (entry == buildStats->styles.end()) {
+            buildStats->styles.emplace_back();
+            entry = buildStats->styles.end() - 1;
+            entry->style = style.getName();
+        }
+        entry->vertices = vertices;
+        entry->meshBytes = mesh->bufferSize();
+        entry->labels = labels;
+
+        for (auto& time : buildTimes) {
+            if (time.first == builder.second.get()) {
+                entry->buildMs = time.second;
+                break;
+            }
+        }
     }
 
     return tile;
@@ -9,7 +9,10 @@ namespace Tangram {
 
 class DataLayer;
 class DataSource;
+class FeatureIndex;
 class Tile;
+class TileTask;
+struct Feature;
 struct TileData;
 class StyleBuilder;
 
@@ -23,11 +26,46 @@ public:
 
     StyleBuilder* getStyleBuilder(const std::string& _name);
 
-    std::shared_ptr<Tile> build(TileID _tileID, const TileData& _data, const DataSource& _source);
+    /* Assemble the tile for _data. Geometry may be simplified in place to
+     * the tile's display resolution before tessellation, unless _source
+     * opts out. When _task is given, its canceled flag is checked between
+     * the per-layer and per-style stages and the build is abandoned
+     * (returning null) once it is set. */
+    std::shared_ptr<Tile> build(TileID _tileID, TileData& _data, const DataSource& _source,
+                                const TileTask* _task = nullptr);
+
+    /* Collection names referenced by the scene layers styling _source.
+     * Sources use this to skip decoding collections that could never
+     * produce geometry. The result is cached per source and stays valid
+     * as long as the builder. */
+    const std::vector<std::string>* referencedCollections(const DataSource& _source);
+
+    /* Record the bounds of an interactive _feature in the spatial index of
+     * the tile being built. Called from the draw rule application for each
+     * rule marked interactive; consecutive calls for the same feature are
+     * folded into one entry. */
+    void indexFeature(const Feature& _feature);
+
+    /* Fan the per-style mesh build stage out over a task pool instead of
+     * running it on the calling worker alone. Meshes of one tile are
+     * independent, so a heavy tile no longer pins a single core while
+     * others idle. Off by default. */
+    static void setParallelMeshBuild(bool _enable) { s_parallelMeshBuild = _enable; }
+
+    /* Clip lines and polygons to the padded tile bounds before the style
+     * builders tessellate them. Large features crossing the tile - lakes,
+     * motorways - otherwise tessellate in full and rely on the GPU to clip
+     * the excess every frame. Off by default. */
+    static void setClipGeometry(bool _enable) { s_clipGeometry = _enable; }
 
     const Scene& scene() const { return *m_scene; }
 
 private:
+
+    static bool s_parallelMeshBuild;
+
+    static bool s_clipGeometry;
+
     std::shared_ptr<Scene> m_scene;
 
     StyleContext m_styleContext;
@@ -36,6 +74,15 @@ private:
     LabelCollider m_labelLayout;
 
     fastmap<std::string, std::unique_ptr<StyleBuilder>> m_styleBuilder;
+
+    fastmap<int32_t, std::vector<std::string>> m_referencedCollections;
+
+    // Index of interactive feature bounds for the tile being built
+    std::unique_ptr<FeatureIndex> m_featureIndex;
+
+    // The feature last added to m_featureIndex, to fold the calls of
+    // multiple matched rules on one feature into a single entry
+    const Feature* m_lastIndexedFeature = nullptr;
 };
 
 }
@@ -8,6 +8,7 @@
 #include <unordered_map>
 #include <list>
 #include <memory>
+#include <vector>
 
 namespace Tangram {
 // TileSet serial + TileID
@@ -49,8 +50,37 @@ public:
         m_cacheList.push_front({k, _tile});
         m_cacheMap[k] = m_cacheList.begin();
         m_cacheUsage += _tile->getMemoryUsage();
+        m_sourceUsage[_sourceId] += _tile->getMemoryUsage();
 
-        return limitCacheSize(m_cacheMaxUsage);
+        auto popped = limitSourceSize(_sourceId);
+
+        for (auto& id : limitCacheSize(m_cacheMaxUsage)) {
+            popped.push_back(id);
+        }
+        return popped;
+    }
+
+    /* Limit the bytes cached for one source, so e.g. a raster overlay
+     * with large textures cannot evict every vector tile. A budget of 0
+     * (the default) only applies the global limit. */
+    void setSourceBudget(int32_t _sourceId, size_t _bytes) {
+        m_sourceBudget[_sourceId] = _bytes;
+    }
+
+    /* Drop roughly _fraction of the cached bytes, least recently used
+     * tiles first. Hooked up to the platform low-memory callback through
+     * TileManager. Returns the evicted entries so the caller can release
+     * dependent resources (e.g. rasters). */
+    std::vector<TileCacheKey> evictForMemoryPressure(float _fraction) {
+        std::vector<TileCacheKey> popped;
+
+        size_t target = m_cacheUsage - size_t(m_cacheUsage * _fraction);
+
+        while (size_t(m_cacheUsage) > target && !m_cacheList.empty()) {
+            popped.push_back(m_cacheList.back().key);
+            popEntry();
+        }
+        return popped;
     }
 
     std::shared_ptr<Tile> get(int32_t _sourceId, TileID _tileId) {
@@ -63,6 +93,7 @@ public:
             m_cacheList.erase(it->second);
             m_cacheMap.erase(it);
             m_cacheUsage -= tile->getMemoryUsage();
+            m_sourceUsage[_sourceId] -= tile->getMemoryUsage();
         }
         return tile;
     }
@@ -88,11 +119,34 @@ public:
                 m_cacheUsage = 0;
                 break;
             }
-            auto& tile = m_cacheList.back().tile;
-            poppedTileIDs.push_back(tile->getID());
-            m_cacheUsage -= tile->getMemoryUsage();
-            m_cacheMap.erase(m_cacheList.back().key);
-            m_cacheList.pop_back();
+            poppedTileIDs.push_back(m_cacheList.back().tile->getID());
+            popEntry();
+        }
+        return poppedTileIDs;
+    }
+
+    /* Evict least recently used tiles of _sourceId until it is back
+     * within its budget. */
+    std::vector<TileID> limitSourceSize(int32_t _sourceId) {
+        std::vector<TileID> poppedTileIDs;
+
+        auto budget = m_sourceBudget.find(_sourceId);
+        if (budget == m_sourceBudget.end() || budget->second == 0) {
+            return poppedTileIDs;
+        }
+
+        auto it = m_cacheList.rbegin();
+        while (m_sourceUsage[_sourceId] > budget->second &&
+               it != m_cacheList.rend()) {
+
+            if (it->key.first != _sourceId) { ++it; continue; }
+
+            poppedTileIDs.push_back(it->tile->getID());
+
+            m_cacheUsage -= it->tile->getMemoryUsage();
+            m_sourceUsage[_sourceId] -= it->tile->getMemoryUsage();
+            m_cacheMap.erase(it->key);
+            it = decltype(it)(m_cacheList.erase(std::next(it).base()));
         }
         return poppedTileIDs;
     }
@@ -108,13 +162,26 @@ public:
     void clear() {
         m_cacheMap.clear();
         m_cacheList.clear();
+        m_sourceUsage.clear();
         m_cacheUsage = 0;
     }
 
 private:
+
+    void popEntry() {
+        auto& entry = m_cacheList.back();
+        m_cacheUsage -= entry.tile->getMemoryUsage();
+        m_sourceUsage[entry.key.first] -= entry.tile->getMemoryUsage();
+        m_cacheMap.erase(entry.key);
+        m_cacheList.pop_back();
+    }
+
     CacheMap m_cacheMap;
     CacheList m_cacheList;
 
+    std::unordered_map<int32_t, size_t> m_sourceUsage;
+    std::unordered_map<int32_t, size_t> m_sourceBudget;
+
     int m_cacheUsage;
     int m_cacheMaxUsage;
 };
@@ -4,17 +4,25 @@
 #include "platform.h"
 #include "tile/tile.h"
 #include "tileCache.h"
+#include "util/frameScheduler.h"
 #include "util/mapProjection.h"
 #include "view/view.h"
 
 #include "glm/gtx/norm.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 
 #define DBG(...) // LOGD(__VA_ARGS__)
 
 namespace Tangram {
 
+static double clockSeconds() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 TileManager::TileManager(TileTaskQueue& _tileWorker) : m_workers(_tileWorker) {
 
     m_tileCache = std::unique_ptr<TileCache>(new TileCache(DEFAULT_CACHE_SIZE));
@@ -22,14 +30,32 @@ TileManager::TileManager(TileTaskQueue& _tileWorker) : m_workers(_tileWorker) {
     // Callback to pass task from Download-Thread to Worker-Queue
     m_dataCallback = TileTaskCb{[this](std::shared_ptr<TileTask>&& task) {
 
+         if (task->loadStart() > 0.0) { measureThroughput(*task); }
+
          if (task->isReady()) {
-             requestRender();
+             m_contentChanged = true;
+             FrameScheduler::requestFrame();
 
         } else if (task->hasData()) {
-            m_workers.enqueue(std::move(task));
+            if (task->isDownloadOnly()) {
+                // The source stored the raw data in its caches on arrival;
+                // hand the task back for bookkeeping instead of a build.
+                std::lock_guard<std::mutex> lock(m_finishedDownloadsMutex);
+                m_finishedDownloads.push_back(std::move(task));
+                m_contentChanged = true;
+                FrameScheduler::requestFrame();
+            } else {
+                m_workers.enqueue(std::move(task));
+            }
 
         } else {
             task->cancel();
+            if (task->isBackground()) {
+                // Failed warming tasks never reach the workers; force an
+                // update so the sweep in updateTileSets retires them.
+                m_contentChanged = true;
+                FrameScheduler::requestFrame();
+            }
         }
     }};
 }
@@ -38,9 +64,10 @@ TileManager::~TileManager() {
     m_tileSets.clear();
 }
 
-void TileManager::setDataSources(const std::vector<std::shared_ptr<DataSource>>& _sources) {
+void TileManager::setDataSources(const std::vector<std::shared_ptr<DataSource>>& _sources,
+                                 bool _keepTiles) {
 
-    m_tileCache->clear();
+    if (!_keepTiles) { m_tileCache->clear(); }
 
     // remove sources that are not in new scene - there must be a better way..
     auto it = std::remove_if(
@@ -55,8 +82,9 @@ void TileManager::setDataSources(const std::vector<std::shared_ptr<DataSource>>&
                     return true;
                 }
             }
-            // Clear cache
-            tileSet.tiles.clear();
+            // Clear cache - unless the new scene is known to produce
+            // identical tiles for this source.
+            if (!_keepTiles) { tileSet.tiles.clear(); }
             return false;
         });
 
@@ -76,10 +104,13 @@ void TileManager::setDataSources(const std::vector<std::shared_ptr<DataSource>>&
             m_tileSets.push_back({ source, false });
         }
     }
+
+    m_contentChanged = true;
 }
 
 void TileManager::addClientDataSource(std::shared_ptr<DataSource> _dataSource) {
     m_tileSets.push_back({ _dataSource, true });
+    m_contentChanged = true;
 }
 
 bool TileManager::removeClientDataSource(DataSource& dataSource) {
@@ -91,6 +122,7 @@ bool TileManager::removeClientDataSource(DataSource& dataSource) {
             // Remove the tile set associated with this data source
             it = m_tileSets.erase(it);
             removed = true;
+            m_contentChanged = true;
         } else {
             ++it;
         }
@@ -98,12 +130,80 @@ bool TileManager::removeClientDataSource(DataSource& dataSource) {
     return removed;
 }
 
+void TileManager::setCacheSourceBudget(int32_t _sourceId, size_t _bytes) {
+    m_tileCache->setSourceBudget(_sourceId, _bytes);
+}
+
+void TileManager::onMemoryPressure(float _fraction) {
+
+    for (auto& popped : m_tileCache->evictForMemoryPressure(_fraction)) {
+        for (auto& tileSet : m_tileSets) {
+            if (tileSet.source->id() == popped.first) {
+                tileSet.source->clearRaster(popped.second);
+                break;
+            }
+        }
+    }
+}
+
+void TileManager::warmTiles(const std::vector<TileID>& _tiles, bool _buildMeshes,
+                            WarmingProgressCb _progress) {
+
+    size_t queued = m_warmingQueue.size();
+
+    for (auto& tileSet : m_tileSets) {
+        // Client sources hold their data in memory already.
+        if (tileSet.clientDataSource) { continue; }
+
+        for (const auto& id : _tiles) {
+            TileID tileId = id;
+            if (tileId.z > tileSet.source->maxZoom()) {
+                tileId = tileId.withMaxSourceZoom(tileSet.source->maxZoom());
+            }
+            m_warmingQueue.emplace_back(tileSet.source->id(), tileId);
+        }
+    }
+
+    std::sort(m_warmingQueue.begin(), m_warmingQueue.end());
+    m_warmingQueue.erase(std::unique(m_warmingQueue.begin(), m_warmingQueue.end()),
+                         m_warmingQueue.end());
+
+    // The queue was unique before, so the growth is the number of new
+    // entries; entries already queued stay counted once.
+    m_warmingBuildsMeshes = _buildMeshes;
+    m_warmingTotal += m_warmingQueue.size() - queued;
+    if (_progress) { m_warmingProgress = std::move(_progress); }
+
+    m_contentChanged = true;
+    FrameScheduler::requestFrame();
+}
+
 void TileManager::clearTileSets() {
     for (auto& tileSet : m_tileSets) {
+        // Drop cached raster textures too: this runs on GL context loss,
+        // after which the textures' handles and any disposed pixel copies
+        // are gone, so the tiles must be rebuilt from raw data
+        tileSet.source->clearRasters();
         tileSet.tiles.clear();
     }
 
+    for (auto& task : m_warmingTasks) {
+        task->cancel();
+    }
+    m_warmingTasks.clear();
+    m_warmingQueue.clear();
+
+    m_warmingTotal = 0;
+    m_warmingDone = 0;
+    m_warmingReported = 0;
+    m_warmingProgress = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_finishedDownloadsMutex);
+        m_finishedDownloads.clear();
+    }
+
     m_tileCache->clear();
+    m_contentChanged = true;
 }
 
 void TileManager::clearTileSet(int32_t _sourceId) {
@@ -114,24 +214,127 @@ void TileManager::clearTileSet(int32_t _sourceId) {
 
     m_tileCache->clear();
     m_tileSetChanged = true;
+    m_contentChanged = true;
 }
 
 void TileManager::updateTileSets(const ViewState& _view,
-                                 const std::set<TileID>& _visibleTiles) {
+                                 const std::vector<TileID>& _visibleTiles,
+                                 bool _visibleTilesChanged) {
+
+    // Drain tasks the workers finished since the last update. The tile
+    // entries below still hold these tasks, so only their arrival matters:
+    // it forces the merge on frames the early-out would otherwise skip.
+    m_completedTasks.clear();
+    if (m_workers.collectCompleted(m_completedTasks)) {
+        m_contentChanged = true;
+
+        // Raster sub-tasks that finished after their main tile went active
+        // swap their texture into the placeholder slot now.
+        for (auto& task : m_completedTasks) {
+            if (task->isSubTask() && !task->isCanceled()) {
+                task->completeLate();
+            }
+        }
+
+        // Warming results go straight into the cache - no tile entry holds
+        // these tasks, so they are finalized here.
+        for (auto& task : m_completedTasks) {
+            if (task->isSubTask() || !task->isBackground()) { continue; }
+
+            auto it = std::find(m_warmingTasks.begin(), m_warmingTasks.end(), task);
+            if (it == m_warmingTasks.end()) { continue; }
+            m_warmingTasks.erase(it);
+            m_warmingDone++;
+
+            if (!task->isCanceled() && task->isReady()) {
+                task->complete();
+
+                for (auto& tileID : m_tileCache->put(task->source().id(), task->tile())) {
+                    task->source().clearRaster(tileID);
+                }
+            }
+        }
+    }
+
+    // Download-only warming tasks end here: their raw data is already in
+    // the source's caches, no build follows.
+    {
+        std::lock_guard<std::mutex> lock(m_finishedDownloadsMutex);
+        for (auto& task : m_finishedDownloads) {
+            auto it = std::find(m_warmingTasks.begin(), m_warmingTasks.end(), task);
+            if (it != m_warmingTasks.end()) {
+                m_warmingTasks.erase(it);
+                m_warmingDone++;
+            }
+        }
+        m_finishedDownloads.clear();
+    }
+
+    // Failed or canceled warming tasks never reach the workers - retire
+    // them so a region download can run to completion.
+    for (auto it = m_warmingTasks.begin(); it != m_warmingTasks.end();) {
+        if ((*it)->isCanceled()) {
+            it = m_warmingTasks.erase(it);
+            m_warmingDone++;
+        } else {
+            ++it;
+        }
+    }
+
+    // When the visible set is identical to the last update, nothing is
+    // loading and no source changed, this update would reproduce the
+    // previous bookkeeping - keep the current tile list as-is instead of
+    // walking every tile set again.
+    if (!_visibleTilesChanged && !m_contentChanged &&
+        m_tilesInProgress == 0 && m_loadPending == 0 &&
+        m_warmingQueue.empty() && m_warmingTasks.empty() &&
+        std::all_of(m_tileSets.begin(), m_tileSets.end(),
+                    [](const TileSet& _tileSet) {
+                        return _tileSet.sourceGeneration ==
+                               _tileSet.source->generation();
+                    })) {
+        m_tileSetChanged = false;
+        return;
+    }
+    m_contentChanged = false;
+
     m_tiles.clear();
     m_loadPending = 0;
     m_tilesInProgress = 0;
+    m_promoteBudget = MAX_PROMOTED_BYTES;
+    m_hostPending.clear();
     m_tileSetChanged = false;
 
+    // During fast pans extend the visible set with the tiles the view is
+    // heading towards, so their loads start before they enter the screen.
+    std::vector<TileID> prefetchTiles(_visibleTiles);
+    addPrefetchTiles(_view, prefetchTiles);
+
+    const auto& visibleTiles =
+        prefetchTiles.size() > _visibleTiles.size() ? prefetchTiles : _visibleTiles;
+
     for (auto& tileSet : m_tileSets) {
         // check if tile set is active for zoom (zoom might be below min_zoom)
         if (tileSet.source->isActiveForZoom(_view.zoom)) {
-            updateTileSet(tileSet, _view, _visibleTiles);
+            updateTileSet(tileSet, _view, visibleTiles);
+        }
+    }
+
+    // Warming downloads in flight count against the shared budget, so
+    // visible and warming loads together stay within MAX_DOWNLOADS.
+    for (auto& task : m_warmingTasks) {
+        if (!task->hasData() && !task->isCanceled()) {
+            m_loadPending++;
+            m_hostPending[sourceHost(task->source())]++;
         }
     }
 
     loadTiles();
 
+    processWarmingQueue();
+
+    reportWarmingProgress();
+
     // Make m_tiles an unique list of tiles for rendering sorted from
     // high to low zoom-levels.
     std::sort(m_tiles.begin(), m_tiles.end(), [](auto& a, auto& b){
@@ -139,10 +342,96 @@ void TileManager::updateTileSets(const ViewState& _view,
 
     // Remove duplicates: Proxy tiles could have been added more than once
     m_tiles.erase(std::unique(m_tiles.begin(), m_tiles.end()), m_tiles.end());
+
+    // Publish the completed set. Early-out frames skip this - the last
+    // snapshot still matches - and a renderer amid drawing the previous
+    // snapshot keeps those tiles alive through its own references.
+    {
+        std::lock_guard<std::mutex> lock(m_snapshotMutex);
+        m_publishedTiles = m_tiles;
+    }
+}
+
+void TileManager::getRenderTiles(std::vector<std::shared_ptr<Tile>>& _out) {
+    _out.clear();
+
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    _out.insert(_out.end(), m_publishedTiles.begin(), m_publishedTiles.end());
+}
+
+void TileManager::addPrefetchTiles(const ViewState& _view, std::vector<TileID>& _tiles) {
+
+    // Look ahead by this much of the current velocity.
+    const double leadTime = 0.35;
+
+    // Never spend more than a few loads on speculative tiles, so visible
+    // work cannot be starved.
+    const size_t maxPrefetch = 6;
+
+    double now = clockSeconds();
+
+    glm::dvec2 velocity(0.0);
+    double dt = now - m_lastUpdateTime;
+
+    if (m_lastUpdateTime > 0.0 && dt > 0.0 && dt < 1.0 &&
+        _view.zoom == m_lastViewZoom) {
+        velocity = (_view.center - m_lastViewCenter) / dt;
+    }
+
+    m_lastViewCenter = _view.center;
+    m_lastViewZoom = _view.zoom;
+    m_lastUpdateTime = now;
+
+    if (velocity == glm::dvec2(0.0)) { return; }
+
+    size_t added = 0;
+    size_t visibleCount = _tiles.size();
+
+    // Shift each visible tile by the distance covered within leadTime,
+    // clamped to the direct neighborhood. Candidates are appended past
+    // visibleCount, so iterate the original tiles by index.
+    for (size_t i = 0; i < visibleCount; i++) {
+
+        TileID id = _tiles[i];
+
+        auto bounds = _view.mapProjection->TileBounds(id);
+        double span = bounds.max.x - bounds.min.x;
+        if (span <= 0.0) { continue; }
+
+        int dx = glm::clamp(int(std::round(velocity.x * leadTime / span)), -2, 2);
+        // Tile y indices grow towards south while projection meters grow north.
+        int dy = glm::clamp(int(std::round(-velocity.y * leadTime / span)), -2, 2);
+
+        if (dx == 0 && dy == 0) { continue; }
+
+        int max = 1 << id.z;
+        int x = id.x + dx;
+        int y = id.y + dy;
+
+        if (x < 0 || x >= max || y < 0 || y >= max) { continue; }
+
+        TileID prefetch(x, y, id.z, id.s, id.wrap);
+
+        // Skip tiles already visible or already added.
+        if (std::binary_search(_tiles.begin(), _tiles.begin() + visibleCount, prefetch)) {
+            continue;
+        }
+        if (std::find(_tiles.begin() + visibleCount, _tiles.end(), prefetch) != _tiles.end()) {
+            continue;
+        }
+
+        _tiles.push_back(prefetch);
+
+        if (++added >= maxPrefetch) { break; }
+    }
+
+    if (added > 0) {
+        std::sort(_tiles.begin(), _tiles.end());
+    }
 }
 
 void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
-                                const std::set<TileID>& _visibleTiles) {
+                                const std::vector<TileID>& _visibleTiles) {
 
     bool newTiles = false;
 
@@ -159,10 +448,43 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
     auto& tiles = _tileSet.tiles;
 
     // Check for ready tasks, move Tile to active TileSet and unset Proxies.
+    // Promotion is batched under a shared per-update byte budget: when a
+    // zoom boundary completes many tiles at once, the ones closest to the
+    // view center go active immediately while the rest keep their proxies
+    // for another frame, spreading the buffer uploads their first draw
+    // triggers over several frames.
+    std::vector<std::pair<TileID, TileEntry*>> readyTiles;
     for (auto& it : tiles) {
         auto& entry = it.second;
         if (entry.newData()) {
-            clearProxyTiles(_tileSet, it.first, entry, removeTiles);
+            readyTiles.emplace_back(it.first, &entry);
+        }
+    }
+
+    if (!readyTiles.empty()) {
+        std::sort(readyTiles.begin(), readyTiles.end(),
+                  [](const auto& a, const auto& b) {
+                      return a.second->task->getPriority() <
+                             b.second->task->getPriority();
+                  });
+
+        for (auto& ready : readyTiles) {
+            auto& entry = *ready.second;
+            size_t bytes = entry.task->tile()->getMemoryUsage();
+
+            // m_tileSetChanged tells whether a tile went active in this
+            // update already; the first one is always promoted so a single
+            // oversized mesh cannot stall the queue.
+            if (bytes > m_promoteBudget && m_tileSetChanged) {
+                // Over budget - the remaining tiles stay on their proxies
+                // and go active in the next updates.
+                m_contentChanged = true;
+                FrameScheduler::requestFrame();
+                break;
+            }
+            m_promoteBudget -= std::min(bytes, m_promoteBudget);
+
+            clearProxyTiles(_tileSet, ready.first, entry, removeTiles);
             entry.task->complete();
 
             entry.tile = std::move(entry.task->tile());
@@ -175,23 +497,30 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
 
     const auto* visibleTiles = &_visibleTiles;
 
-    std::set<TileID> mappedTiles;
+    std::vector<TileID> mappedTiles;
     if (_view.zoom > _tileSet.source->maxZoom()) {
+        mappedTiles.reserve(_visibleTiles.size());
         for (const auto& id : _visibleTiles) {
-            auto tile = id.withMaxSourceZoom(_tileSet.source->maxZoom());
-            // Replace tile with same coordinates and lower source zoom
-            auto other = std::find_if(mappedTiles.begin(), mappedTiles.end(),
-                             [&](auto& t) { return tile.x == t.x &&
-                                            tile.y == t.y &&
-                                            tile.z == t.z &&
-                                            tile.wrap == t.wrap; });
-            if (other == mappedTiles.end()) {
-                mappedTiles.insert(tile);
-            } else if (other->s < tile.s) {
-                mappedTiles.erase(other);
-                mappedTiles.insert(tile);
-            }
+            mappedTiles.push_back(id.withMaxSourceZoom(_tileSet.source->maxZoom()));
         }
+        // Several tiles map to the same coordinates with different styling
+        // zooms; group them with the highest styling zoom first and keep
+        // only that one.
+        std::sort(mappedTiles.begin(), mappedTiles.end(),
+                  [](const TileID& a, const TileID& b) {
+                      if (a.x != b.x) { return a.x < b.x; }
+                      if (a.y != b.y) { return a.y < b.y; }
+                      if (a.wrap != b.wrap) { return a.wrap < b.wrap; }
+                      return a.s > b.s;
+                  });
+        mappedTiles.erase(std::unique(mappedTiles.begin(), mappedTiles.end(),
+                              [](const TileID& a, const TileID& b) {
+                                  return a.x == b.x && a.y == b.y &&
+                                         a.z == b.z && a.wrap == b.wrap;
+                              }),
+                          mappedTiles.end());
+        // Restore the TileID ordering the merge loop below relies on.
+        std::sort(mappedTiles.begin(), mappedTiles.end());
         visibleTiles = &mappedTiles;
     }
 
@@ -341,10 +670,14 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
             // limit download requests.
             if (!task->hasData()) {
                 m_loadPending++;
+                m_hostPending[sourceHost(*_tileSet.source)]++;
             }
 
             for (auto& subTask : task->subTasks()) {
-                if (!subTask->hasData()) { m_loadPending++; }
+                if (!subTask->hasData()) {
+                    m_loadPending++;
+                    m_hostPending[sourceHost(subTask->source())]++;
+                }
             }
         }
 
@@ -394,25 +727,30 @@ void TileManager::loadSubTasks(std::vector<std::shared_ptr<DataSource>>& _subSou
             subTileID = subTileID.withMaxSourceZoom(subSource->maxZoom());
         }
         auto subTask = subSource->createTask(subTileID, index);
+        // Rasters of a warming tile share its lane, and of a download-only
+        // tile only feed the cache.
+        subTask->setBackground(tileTask->isBackground());
+        subTask->setDownloadOnly(tileTask->isDownloadOnly());
         if (subTask->isReady()) {
             subTasks.insert(it, subTask);
-            requestRender();
+            FrameScheduler::requestFrame();
 
         } else if (subTask->hasData()) {
             subTasks.insert(it, subTask);
             m_dataCallback.func(std::move(subTask));
 
-        } else if (m_loadPending < MAX_DOWNLOADS) {
+        } else if (hasDownloadSlot(*subSource)) {
             subTasks.insert(it, subTask);
 
+            subTask->setLoadStart(clockSeconds());
             if (subSource->loadTileData(std::move(subTask), m_dataCallback)) {
-                m_loadPending++;
+                takeDownloadSlot(*subSource);
 
             } else {
                 // dependent raster's loading failed..
                 // this subTask's rasterReady must have been set with black texture
                 assert(subTask->isReady());
-                requestRender();
+                FrameScheduler::requestFrame();
             }
         }
     }
@@ -442,10 +780,11 @@ void TileManager::loadTiles() {
             loadSubTasks(tileSet.source->rasterSources(), entry.task, tileId);
             m_dataCallback.func(std::move(task));
 
-        } else if (m_loadPending < MAX_DOWNLOADS) {
+        } else if (hasDownloadSlot(*tileSet.source)) {
             entry.task = task;
+            task->setLoadStart(clockSeconds());
             if (tileSet.source->loadTileData(std::move(task), m_dataCallback)) {
-                m_loadPending++;
+                takeDownloadSlot(*tileSet.source);
                 loadSubTasks(tileSet.source->rasterSources(), entry.task, tileId);
             } else {
                 // Set canceled state, so that tile will not be tried
@@ -463,6 +802,176 @@ void TileManager::loadTiles() {
     m_loadTasks.clear();
 }
 
+void TileManager::processWarmingQueue() {
+
+    if (m_warmingQueue.empty()) { return; }
+
+    size_t out = 0;
+
+    for (auto& entry : m_warmingQueue) {
+
+        auto tileSetIt = std::find_if(m_tileSets.begin(), m_tileSets.end(),
+                                      [&](const TileSet& ts) {
+                                          return ts.source->id() == entry.first;
+                                      });
+        // Source left the scene - drop its warming requests.
+        if (tileSetIt == m_tileSets.end()) { m_warmingDone++; continue; }
+
+        auto& source = tileSetIt->source;
+        const auto& tileId = entry.second;
+
+        // Already active, cached with the current generation, or warming -
+        // counted as done right away, which is what lets a re-queued
+        // region resume past the part already on disk.
+        if (tileSetIt->tiles.find(tileId) != tileSetIt->tiles.end()) {
+            m_warmingDone++;
+            continue;
+        }
+
+        auto cached = m_tileCache->contains(source->id(), tileId);
+        if (cached && cached->sourceGeneration() == source->generation()) {
+            m_warmingDone++;
+            continue;
+        }
+
+        if (std::any_of(m_warmingTasks.begin(), m_warmingTasks.end(),
+                        [&](auto& task) {
+                            return task->source().id() == entry.first &&
+                                   task->tileId() == tileId;
+                        })) { m_warmingDone++; continue; }
+
+        auto task = source->createTask(tileId);
+        task->setBackground(true);
+        task->setDownloadOnly(!m_warmingBuildsMeshes);
+
+        if (task->isReady()) {
+            // createTask found a finished tile (e.g. in the mesh cache).
+            m_warmingDone++;
+            continue;
+
+        } else if (task->hasData()) {
+            m_warmingTasks.push_back(task);
+            loadSubTasks(source->rasterSources(), m_warmingTasks.back(), tileId);
+            m_dataCallback.func(std::move(task));
+
+        } else if (hasDownloadSlot(*source)) {
+            m_warmingTasks.push_back(task);
+
+            task->setLoadStart(clockSeconds());
+            if (source->loadTileData(std::move(task), m_dataCallback)) {
+                takeDownloadSlot(*source);
+                loadSubTasks(source->rasterSources(), m_warmingTasks.back(), tileId);
+            } else {
+                m_warmingTasks.pop_back();
+                m_warmingDone++;
+            }
+
+        } else {
+            // No download slot left - keep the entry for the next update.
+            m_warmingQueue[out++] = entry;
+        }
+    }
+
+    m_warmingQueue.resize(out);
+}
+
+void TileManager::reportWarmingProgress() {
+
+    if (m_warmingTotal == 0) { return; }
+
+    // Entries can finish through paths that bypass the counters (e.g. a
+    // source removal clearing its queue); an empty queue is always done.
+    if (m_warmingQueue.empty() && m_warmingTasks.empty()) {
+        m_warmingDone = m_warmingTotal;
+    } else {
+        m_warmingDone = std::min(m_warmingDone, m_warmingTotal - 1);
+    }
+
+    if (m_warmingDone == m_warmingReported) { return; }
+    m_warmingReported = m_warmingDone;
+
+    if (m_warmingProgress) { m_warmingProgress(m_warmingDone, m_warmingTotal); }
+
+    if (m_warmingDone == m_warmingTotal) {
+        m_warmingTotal = 0;
+        m_warmingDone = 0;
+        m_warmingReported = 0;
+        m_warmingProgress = nullptr;
+    }
+}
+
+const std::string& TileManager::sourceHost(DataSource& _source) {
+
+    auto& host = m_sourceHosts[_source.id()];
+
+    if (host.empty()) {
+        // Reduce the URL template to its host part; sources without one
+        // (e.g. file paths) share a pseudo host.
+        const auto& url = _source.urlTemplate();
+        auto start = url.find("://");
+        start = (start == std::string::npos) ? 0 : start + 3;
+        auto end = url.find('/', start);
+        host = url.substr(start, (end == std::string::npos) ? std::string::npos : end - start);
+        if (host.empty()) { host = "local"; }
+    }
+
+    return host;
+}
+
+bool TileManager::hasDownloadSlot(DataSource& _source) {
+    if (m_loadPending >= MAX_DOWNLOADS) { return false; }
+    return m_hostPending[sourceHost(_source)] < MAX_DOWNLOADS_PER_HOST;
+}
+
+void TileManager::takeDownloadSlot(DataSource& _source) {
+    m_loadPending++;
+    m_hostPending[sourceHost(_source)]++;
+}
+
+void TileManager::measureThroughput(TileTask& _task) {
+
+    auto& task = static_cast<DownloadTileTask&>(_task);
+
+    // 304 revalidations and failed transfers carry no body to measure.
+    if (!task.rawTileData || task.rawTileData->empty() ||
+        task.rawTileData == task.cachedTileData) {
+        return;
+    }
+
+    double elapsed = clockSeconds() - _task.loadStart();
+    if (elapsed <= 0.0) { return; }
+
+    // Bytes over time-to-completion, so connection latency counts
+    // against the link just like transfer time does.
+    float rate = float(task.rawTileData->size() / elapsed);
+
+    std::lock_guard<std::mutex> lock(m_throughputMutex);
+
+    if (m_throughputSamples == 0) {
+        m_throughputAvg = rate;
+    } else {
+        m_throughputAvg += (rate - m_throughputAvg) * 0.25f;
+    }
+    m_throughputSamples++;
+}
+
+int TileManager::recommendedZoomBias() {
+
+    std::lock_guard<std::mutex> lock(m_throughputMutex);
+
+    // Hold the current mode until a few downloads have been seen, so a
+    // single outlier cannot flip it.
+    if (m_throughputSamples >= 4) {
+        if (m_lowBandwidth) {
+            if (m_throughputAvg > RECOVERED_LINK_BPS) { m_lowBandwidth = false; }
+        } else if (m_throughputAvg < SLOW_LINK_BPS) {
+            m_lowBandwidth = true;
+        }
+    }
+
+    return m_lowBandwidth ? 1 : 0;
+}
+
 bool TileManager::addTile(TileSet& _tileSet, const TileID& _tileID) {
 
     auto tile = m_tileCache->get(_tileSet.source->id(), _tileID);
@@ -7,12 +7,13 @@
 #include "tileTask.h"
 #include "util/fastmap.h"
 
+#include <atomic>
+#include <functional>
 #include <map>
 #include <vector>
 #include <memory>
 #include <mutex>
 #include <tuple>
-#include <set>
 #include <data/dataSource.h>
 
 namespace Tangram {
@@ -29,7 +30,25 @@ struct ViewState;
 class TileManager {
 
     const static size_t DEFAULT_CACHE_SIZE = 32*1024*1024; // 32 MB
-    const static int MAX_DOWNLOADS = 4;
+
+    // Connection budget shared across all TileSets, plus a cap per remote
+    // host: one slow source cannot hold every slot while others sit below
+    // capacity, and several sources on one host cannot burst past what
+    // weak radios handle.
+    const static int MAX_DOWNLOADS = 8;
+    const static int MAX_DOWNLOADS_PER_HOST = 4;
+
+    // Throughput thresholds for the adaptive resolution mode: below
+    // SLOW_LINK_BPS tile selection drops one zoom level, and it returns
+    // to full resolution once the average climbs past RECOVERED_LINK_BPS.
+    // The gap keeps the mode from flapping around a single threshold.
+    constexpr static float SLOW_LINK_BPS = 64 * 1024;
+    constexpr static float RECOVERED_LINK_BPS = 192 * 1024;
+
+    // Byte budget for tiles going active per update. A tile's meshes are
+    // uploaded on its first draw, so this bounds the buffer uploads one
+    // frame can trigger when many tiles finish together.
+    const static size_t MAX_PROMOTED_BYTES = 2 * 1024 * 1024;
 
 public:
 
@@ -37,11 +56,19 @@ public:
 
     virtual ~TileManager();
 
-    /* Sets the tile DataSources */
-    void setDataSources(const std::vector<std::shared_ptr<DataSource>>& _sources);
+    /* Sets the tile DataSources. With _keepTiles the already built tiles
+     * of sources that stay in the scene survive the switch; only valid
+     * when the new scene produces identical tile geometry. */
+    void setDataSources(const std::vector<std::shared_ptr<DataSource>>& _sources,
+                        bool _keepTiles = false);
 
-    /* Updates visible tile set and load missing tiles */
-    void updateTileSets(const ViewState& _view, const std::set<TileID>& _visibleTiles);
+    /* Updates visible tile set and load missing tiles.
+     * _visibleTiles must be sorted by TileID ordering without duplicates.
+     * With _visibleTilesChanged false the caller asserts that _visibleTiles
+     * is identical to the previous update, which allows skipping the
+     * per-tile bookkeeping entirely on idle frames. */
+    void updateTileSets(const ViewState& _view, const std::vector<TileID>& _visibleTiles,
+                        bool _visibleTilesChanged = true);
 
     void clearTileSets();
 
@@ -50,10 +77,20 @@ public:
     /* Returns the set of currently visible tiles */
     const auto& getVisibleTiles() { return m_tiles; }
 
+    /* Copy the published visible-tile snapshot into _out. updateTileSets
+     * builds the next set in its working list and publishes it only when
+     * its bookkeeping completed, so a render thread can draw the previous
+     * snapshot while an update runs. The owning references in _out keep
+     * the tiles alive for the duration of the frame; _out is reused to
+     * avoid reallocation. */
+    void getRenderTiles(std::vector<std::shared_ptr<Tile>>& _out);
+
     bool hasTileSetChanged() { return m_tileSetChanged; }
 
     bool hasLoadingTiles() { return m_tilesInProgress > 0; }
 
+    int32_t numLoadingTiles() { return m_tilesInProgress; }
+
     void addClientDataSource(std::shared_ptr<DataSource> _dataSource);
 
     bool removeClientDataSource(DataSource& dataSource);
@@ -67,6 +104,32 @@ public:
      */
     void setCacheSize(size_t _cacheSize);
 
+    /* Limit the cache bytes used by one source; see TileCache. */
+    void setCacheSourceBudget(int32_t _sourceId, size_t _bytes);
+
+    /* Drop roughly _fraction of the cached tiles. Call from the
+     * platform's low-memory callback. */
+    void onMemoryPressure(float _fraction = 0.5f);
+
+    /* Progress of queued warming work: completed and total tile count.
+     * Invoked from updateTileSets as tiles finish. */
+    using WarmingProgressCb = std::function<void(size_t, size_t)>;
+
+    /* Queue _tiles to be fetched into the sources' persistent caches and,
+     * when _buildMeshes is set, built on the workers' background lane and
+     * stored in the tile cache. Warming never competes with visible tiles:
+     * its tasks only run on idle workers and its downloads only start when
+     * visible loads left slots in the budget. Tiles already cached count
+     * as completed right away, so re-queuing an interrupted region resumes
+     * instead of re-fetching. */
+    void warmTiles(const std::vector<TileID>& _tiles, bool _buildMeshes = true,
+                   WarmingProgressCb _progress = nullptr);
+
+    /* Zoom-level bias suggested by the measured download throughput: 1
+     * while the link is slower than tiles at full resolution need, 0
+     * once it recovered. See Map::setAdaptiveTileResolution(). */
+    int recommendedZoomBias();
+
 private:
 
     enum class ProxyID : uint8_t {
@@ -108,15 +171,16 @@ private:
         // New Data only when
         // - task still exists
         // - task has a tile ready
-        // - tile has all rasters set
+        // - every raster sampler slot has a sub-task to fill it
+        // Raster sub-tasks no longer gate readiness: pending ones attach a
+        // placeholder texture in complete() and swap their result in
+        // through completeLate() when decoding finishes, so vector
+        // geometry displays without waiting on slow rasters.
         bool newData() {
             if (bool(task) && task->isReady()) {
 
                 if (rastersPending()) { return false; }
 
-                for (auto& rTask : task->subTasks()) {
-                    if (!rTask->isReady()) { return false; }
-                }
                 return true;
             }
             return false;
@@ -182,11 +246,16 @@ private:
         bool clientDataSource;
     };
 
-    void updateTileSet(TileSet& tileSet, const ViewState& _view, const std::set<TileID>& _visibleTiles);
+    void updateTileSet(TileSet& tileSet, const ViewState& _view, const std::vector<TileID>& _visibleTiles);
 
     void enqueueTask(TileSet& _tileSet, const TileID& _tileID, const ViewState& _view);
 
     void loadTiles();
+
+    /* Start queued warming tasks; called after loadTiles so visible loads
+     * claim their download slots first. */
+    void processWarmingQueue();
+
     void loadSubTasks(std::vector<std::shared_ptr<DataSource>>& subSources, std::shared_ptr<TileTask>& tileTask,
                       const TileID& tileID);
 
@@ -215,28 +284,105 @@ private:
      */
     void clearProxyTiles(TileSet& _tileSet, const TileID& _tileID, TileEntry& _tile, std::vector<TileID>& _removes);
 
+    /* Host part of a source's URL template, extracted once per source */
+    const std::string& sourceHost(DataSource& _source);
+
+    /* Whether a download may start, given the global budget and the limit
+     * of the source's host */
+    bool hasDownloadSlot(DataSource& _source);
+
+    void takeDownloadSlot(DataSource& _source);
+
+    /* Fold one finished download into the throughput average; called
+     * from the network threads. */
+    void measureThroughput(TileTask& _task);
+
+    /* Exponential moving average of tile download throughput in
+     * bytes per second, with hysteresis state for the zoom bias */
+    std::mutex m_throughputMutex;
+    float m_throughputAvg = 0.f;
+    int m_throughputSamples = 0;
+    bool m_lowBandwidth = false;
+
     int32_t m_loadPending = 0;
     int32_t m_tilesInProgress = 0;
 
+    /* Promotion budget left in this update, shared by all tile sets */
+    size_t m_promoteBudget = 0;
+
+    /* Downloads in flight per remote host, rebuilt each update */
+    std::map<std::string, int> m_hostPending;
+
+    fastmap<int32_t, std::string> m_sourceHosts;
+
     std::vector<TileSet> m_tileSets;
 
-    /* Current tiles ready for rendering */
+    /* Current tiles ready for rendering; working list of updateTileSets */
     std::vector<std::shared_ptr<Tile>> m_tiles;
 
+    /* Published snapshot of m_tiles, swapped in whole once an update
+     * completed; guarded by m_snapshotMutex, see getRenderTiles() */
+    std::vector<std::shared_ptr<Tile>> m_publishedTiles;
+    std::mutex m_snapshotMutex;
+
     std::unique_ptr<TileCache> m_tileCache;
 
     TileTaskQueue& m_workers;
 
     bool m_tileSetChanged = false;
 
+    /* Set whenever tile content may have changed outside of updateTileSets
+     * (sources added or cleared, client data completed); forces a full
+     * update even when the visible set did not change. */
+    std::atomic<bool> m_contentChanged { true };
+
     /* Callback for DataSource:
      * Passes TileTask back with data for further processing by <TileWorker>s
      */
     TileTaskCb m_dataCallback;
 
+    // Scratch list for completions drained from the workers each update;
+    // a member to reuse its allocation.
+    std::vector<std::shared_ptr<TileTask>> m_completedTasks;
+
     /* Temporary list of tiles that need to be loaded */
     std::vector<std::tuple<double, TileSet*, TileID>> m_loadTasks;
 
+    /* Warming requests not yet started, as (source id, tile) pairs */
+    std::vector<std::pair<int32_t, TileID>> m_warmingQueue;
+
+    /* Warming tasks handed to the background lane or downloading */
+    std::vector<std::shared_ptr<TileTask>> m_warmingTasks;
+
+    /* Fire the warming progress callback when the done count changed and
+     * reset the bookkeeping once all queued warming finished; called at
+     * the end of updateTileSets. */
+    void reportWarmingProgress();
+
+    /* Whether queued warming work is built into meshes or only fetched
+     * into the sources' caches; set per warmTiles call, applies to all
+     * queued entries */
+    bool m_warmingBuildsMeshes = true;
+
+    WarmingProgressCb m_warmingProgress;
+    size_t m_warmingTotal = 0;
+    size_t m_warmingDone = 0;
+    size_t m_warmingReported = 0;
+
+    /* Download-only warming tasks whose data arrived, handed over from
+     * the network threads and finalized by updateTileSets */
+    std::vector<std::shared_ptr<TileTask>> m_finishedDownloads;
+    std::mutex m_finishedDownloadsMutex;
+
+    /* Add tiles about to become visible to _tiles, extrapolated from the
+     * view velocity of the last updates. _tiles is kept sorted. */
+    void addPrefetchTiles(const ViewState& _view, std::vector<TileID>& _tiles);
+
+    /* View center and time of the last update, for the prefetch velocity */
+    glm::dvec2 m_lastViewCenter = { 0.0, 0.0 };
+    double m_lastUpdateTime = 0.0;
+    float m_lastViewZoom = 0.f;
+
 
 };
 
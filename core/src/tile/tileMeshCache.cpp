@@ -0,0 +1,258 @@
+#include "tile/tileMeshCache.h"
+
+#include "data/dataSource.h"
+#include "gl/mesh.h"
+#include "scene/scene.h"
+#include "style/style.h"
+#include "tile/tile.h"
+#include "util/lz.h"
+#include "util/mapProjection.h"
+#include "log.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define MESH_CACHE_MAGIC 0x31434d54 // 'TMC1'
+
+namespace Tangram {
+
+TileMeshCache::TileMeshCache(const std::string& _path, uint64_t _sceneKey,
+                             size_t _ramBudget)
+    : m_path(_path), m_sceneKey(_sceneKey), m_ramBudget(_ramBudget) {}
+
+std::string TileMeshCache::entryPath(const TileID& _tileID, int32_t _sourceId,
+                                     int64_t _generation) const {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s/%d_%d_%d_%d_%lld_%llx.tmc",
+             m_path.c_str(), _sourceId, _tileID.z, _tileID.x, _tileID.y,
+             (long long)_generation, (unsigned long long)m_sceneKey);
+    return buffer;
+}
+
+void TileMeshCache::setRamBudget(size_t _bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_ramBudget = _bytes;
+
+    while (m_ramUsage > m_ramBudget && !m_ramList.empty()) {
+        auto& entry = m_ramList.back();
+        m_ramUsage -= entry.blob.size();
+        m_ramIndex.erase(entry.key);
+        m_ramList.pop_back();
+    }
+}
+
+void TileMeshCache::storeRam(const Key& _key, const std::vector<char>& _buffer) {
+
+    if (m_ramBudget == 0) { return; }
+
+    // Compress outside the lock; workers bake tiles concurrently.
+    std::vector<char> blob;
+    LZ::compress(_buffer.data(), _buffer.size(), blob);
+
+    bool compressed = blob.size() < _buffer.size();
+    if (!compressed) { blob.assign(_buffer.begin(), _buffer.end()); }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_ramIndex.find(_key);
+    if (it != m_ramIndex.end()) {
+        m_ramUsage -= it->second->blob.size();
+        m_ramList.erase(it->second);
+        m_ramIndex.erase(it);
+    }
+
+    m_ramUsage += blob.size();
+    m_ramList.push_front({_key, uint32_t(_buffer.size()), compressed, std::move(blob)});
+    m_ramIndex[_key] = m_ramList.begin();
+
+    while (m_ramUsage > m_ramBudget && !m_ramList.empty()) {
+        auto& entry = m_ramList.back();
+        m_ramUsage -= entry.blob.size();
+        m_ramIndex.erase(entry.key);
+        m_ramList.pop_back();
+    }
+}
+
+bool TileMeshCache::fetchRam(const Key& _key, std::vector<char>& _buffer) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_ramIndex.find(_key);
+    if (it == m_ramIndex.end()) { return false; }
+
+    auto& entry = *it->second;
+    _buffer.resize(entry.rawSize);
+
+    bool ok = entry.compressed
+        ? LZ::decompress(entry.blob.data(), entry.blob.size(),
+                         _buffer.data(), _buffer.size())
+        : (std::memcpy(_buffer.data(), entry.blob.data(), entry.blob.size()),
+           entry.blob.size() == entry.rawSize);
+
+    if (!ok) {
+        LOGW("Dropping corrupt mesh cache entry %s", _key.id.toString().c_str());
+        m_ramUsage -= entry.blob.size();
+        auto listIt = it->second;
+        m_ramIndex.erase(it);
+        m_ramList.erase(listIt);
+        return false;
+    }
+
+    m_ramList.splice(m_ramList.begin(), m_ramList, it->second);
+
+    return true;
+}
+
+bool TileMeshCache::put(const Tile& _tile, const Scene& _scene, int64_t _generation) {
+
+    std::vector<char> buffer;
+    uint32_t count = 0;
+
+    // Reserve space for the header, filled in below.
+    buffer.resize(2 * sizeof(uint32_t));
+
+    auto append = [&](const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    };
+
+    for (const auto& style : _scene.styles()) {
+
+        const auto& mesh = _tile.getMesh(*style);
+        if (!mesh) { continue; }
+
+        std::vector<char> blob;
+        if (!mesh->serialize(blob)) {
+            // All-or-nothing: a partially baked tile would come back
+            // without its labels.
+            return false;
+        }
+
+        const auto& name = style->getName();
+        uint32_t nameLen = name.size();
+        uint32_t blobLen = blob.size();
+
+        append(&nameLen, sizeof(nameLen));
+        append(name.data(), nameLen);
+        append(&blobLen, sizeof(blobLen));
+        append(blob.data(), blobLen);
+
+        count++;
+    }
+
+    uint32_t magic = MESH_CACHE_MAGIC;
+    std::memcpy(buffer.data(), &magic, sizeof(magic));
+    std::memcpy(buffer.data() + sizeof(magic), &count, sizeof(count));
+
+    storeRam({_tile.sourceID(), _generation, _tile.getID()}, buffer);
+
+    if (m_path.empty()) { return true; }
+
+    auto path = entryPath(_tile.getID(), _tile.sourceID(), _generation);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) { return false; }
+
+    bool ok = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    fclose(file);
+
+    return ok;
+}
+
+std::shared_ptr<Tile> TileMeshCache::get(const TileID& _tileID, const DataSource& _source,
+                                         const Scene& _scene, int64_t _generation) {
+
+    Key key { _source.id(), _generation, _tileID };
+
+    std::vector<char> buffer;
+
+    if (fetchRam(key, buffer)) {
+        return inflate(buffer, _tileID, _source, _scene);
+    }
+
+    if (m_path.empty()) { return nullptr; }
+
+    auto path = entryPath(_tileID, _source.id(), _generation);
+
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) { return nullptr; }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    buffer.resize(size > 0 ? size : 0);
+    bool ok = size > long(2 * sizeof(uint32_t)) &&
+        fread(buffer.data(), 1, size, file) == size_t(size);
+    fclose(file);
+
+    if (!ok) { return nullptr; }
+
+    auto tile = inflate(buffer, _tileID, _source, _scene);
+
+    if (tile) {
+        // Promote to the RAM tier; re-entering the same area again skips
+        // the read.
+        storeRam(key, buffer);
+    }
+
+    return tile;
+}
+
+std::shared_ptr<Tile> TileMeshCache::inflate(const std::vector<char>& _buffer,
+                                             const TileID& _tileID, const DataSource& _source,
+                                             const Scene& _scene) const {
+
+    if (_buffer.size() < 2 * sizeof(uint32_t)) { return nullptr; }
+
+    uint32_t magic, count;
+    std::memcpy(&magic, _buffer.data(), sizeof(magic));
+    std::memcpy(&count, _buffer.data() + sizeof(magic), sizeof(count));
+
+    if (magic != MESH_CACHE_MAGIC) { return nullptr; }
+
+    auto tile = std::make_shared<Tile>(_tileID, *_scene.mapProjection(), &_source);
+    tile->initGeometry(_scene.styles().size());
+
+    const char* cursor = _buffer.data() + 2 * sizeof(uint32_t);
+    const char* end = _buffer.data() + _buffer.size();
+
+    for (uint32_t i = 0; i < count; i++) {
+
+        uint32_t nameLen;
+        if (cursor + sizeof(nameLen) > end) { return nullptr; }
+        std::memcpy(&nameLen, cursor, sizeof(nameLen));
+        cursor += sizeof(nameLen);
+
+        if (cursor + nameLen > end) { return nullptr; }
+        std::string name(cursor, nameLen);
+        cursor += nameLen;
+
+        uint32_t blobLen;
+        if (cursor + sizeof(blobLen) > end) { return nullptr; }
+        std::memcpy(&blobLen, cursor, sizeof(blobLen));
+        cursor += sizeof(blobLen);
+
+        if (cursor + blobLen > end) { return nullptr; }
+
+        const Style* style = nullptr;
+        for (const auto& s : _scene.styles()) {
+            if (s->getName() == name) { style = s.get(); break; }
+        }
+
+        if (!style) { return nullptr; }
+
+        auto mesh = std::make_unique<SerializedMesh>(style->vertexLayout(),
+                                                     style->drawMode());
+        if (!mesh->deserialize(cursor, blobLen)) { return nullptr; }
+        cursor += blobLen;
+
+        tile->setMesh(*style, std::move(mesh));
+    }
+
+    return tile;
+}
+
+}
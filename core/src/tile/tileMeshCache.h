@@ -0,0 +1,127 @@
+#pragma once
+
+#include "tile/tileID.h"
+#include "util/hash.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+class DataSource;
+class Scene;
+class Tile;
+
+/* Two-tier cache of built tiles.
+ *
+ * Stores the compiled per-style vertex and index buffers of a Tile, keyed
+ * by (TileID, source generation, scene key). Entries live in an in-RAM
+ * tier of LZ-compressed blobs under a byte budget, backed by baked files
+ * on disk when a path is given; a tile evicted from the in-memory
+ * TileCache can then be rehydrated with a decompress (or one read) and
+ * upload instead of a full parse and tessellation pass. The compiled
+ * buffers are already attribute-quantized by the styles, so the LZ pass
+ * is lossless and typically keeps several times more tiles resident than
+ * TileCache alone within the same footprint.
+ *
+ * A tile is only stored when every one of its meshes serializes; tiles
+ * containing label meshes fall back to the regular build path since label
+ * placement cannot be restored from raw buffers.
+ */
+class TileMeshCache {
+
+public:
+
+    const static size_t DEFAULT_RAM_BUDGET = 16 * 1024 * 1024; // 16 MB
+
+    /* @_path: directory for the baked tile files, or an empty string for
+     * a RAM-only cache. @_sceneKey: a hash of the scene sources and
+     * styles; entries baked under a different key are ignored.
+     * @_ramBudget: byte budget of the compressed in-RAM tier. */
+    TileMeshCache(const std::string& _path, uint64_t _sceneKey,
+                  size_t _ramBudget = DEFAULT_RAM_BUDGET);
+
+    /* Serialize the meshes of _tile. Returns false when the tile contains
+     * a mesh that cannot be baked. */
+    bool put(const Tile& _tile, const Scene& _scene, int64_t _generation);
+
+    /* Rebuild a Tile from baked buffers, or null on a miss. */
+    std::shared_ptr<Tile> get(const TileID& _tileID, const DataSource& _source,
+                              const Scene& _scene, int64_t _generation);
+
+    /* Resize the in-RAM tier, evicting least-recently-used entries past
+     * the new budget. Zero disables the tier. */
+    void setRamBudget(size_t _bytes);
+
+private:
+
+    struct Key {
+        int32_t sourceId;
+        int64_t generation;
+        TileID id;
+
+        bool operator==(const Key& _other) const {
+            return sourceId == _other.sourceId &&
+                generation == _other.generation &&
+                id == _other.id;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& _key) const {
+            std::size_t seed = 0;
+            hash_combine(seed, _key.sourceId);
+            hash_combine(seed, _key.generation);
+            hash_combine(seed, _key.id.x);
+            hash_combine(seed, _key.id.y);
+            hash_combine(seed, _key.id.z);
+            return seed;
+        }
+    };
+
+    struct RamEntry {
+        Key key;
+        // Serialized size; the decompress target
+        uint32_t rawSize;
+        // Raw bytes when the LZ pass did not shrink the buffer
+        bool compressed;
+        std::vector<char> blob;
+    };
+
+    using RamList = std::list<RamEntry>;
+
+    /* Compress _buffer into the RAM tier, evicting from the LRU tail past
+     * the budget. Takes m_mutex; called on tile-worker threads. */
+    void storeRam(const Key& _key, const std::vector<char>& _buffer);
+
+    /* Restore the serialized buffer of _key from the RAM tier into
+     * _buffer, or return false on a miss. Takes m_mutex. */
+    bool fetchRam(const Key& _key, std::vector<char>& _buffer);
+
+    /* Rebuild a Tile from a serialized buffer, or null when the buffer is
+     * malformed or references styles the scene no longer has. */
+    std::shared_ptr<Tile> inflate(const std::vector<char>& _buffer,
+                                  const TileID& _tileID, const DataSource& _source,
+                                  const Scene& _scene) const;
+
+    std::string entryPath(const TileID& _tileID, int32_t _sourceId,
+                          int64_t _generation) const;
+
+    std::string m_path;
+    uint64_t m_sceneKey;
+
+    // Compressed entries in most-recently-used order with a lookup index
+    RamList m_ramList;
+    std::unordered_map<Key, RamList::iterator, KeyHash> m_ramIndex;
+    size_t m_ramUsage = 0;
+    size_t m_ramBudget;
+
+    std::mutex m_mutex;
+};
+
+}
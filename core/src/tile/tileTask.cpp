@@ -1,5 +1,6 @@
 #include "tileTask.h"
 #include "data/dataSource.h"
+#include "tile/tileMeshCache.h"
 #include "tile/tileBuilder.h"
 #include "scene/scene.h"
 #include "util/mapProjection.h"
@@ -16,22 +17,44 @@ TileTask::TileTask(TileID& _tileId, std::shared_ptr<DataSource> _source, int _su
 
 void TileTask::process(TileBuilder& _tileBuilder) {
 
-    auto tileData = m_source->parse(*this, *_tileBuilder.scene().mapProjection());
+    auto* meshCache = m_source->meshCache();
+
+    if (meshCache) {
+        // Rehydrate baked meshes instead of a full parse and build.
+        m_tile = meshCache->get(m_tileId, *m_source, _tileBuilder.scene(),
+                                m_sourceGeneration);
+        if (m_tile) { return; }
+    }
+
+    // Let the source skip collections the scene does not reference.
+    m_collectionFilter = _tileBuilder.referencedCollections(*m_source);
+
+    // Overzoomed siblings map to the same data tile; parseShared hands
+    // all of them one parsed result so only the build runs per child.
+    auto tileData = m_source->parseShared(*this, *_tileBuilder.scene().mapProjection(),
+                                          m_sharedTileData);
 
     if (tileData) {
-        m_tile = _tileBuilder.build(m_tileId, *tileData, *m_source);
-    } else {
+        m_tile = _tileBuilder.build(m_tileId, *tileData, *m_source, this);
+    }
+
+    if (!m_tile) {
         cancel();
     }
+
+    if (m_tile && meshCache) {
+        meshCache->put(*m_tile, _tileBuilder.scene(), m_sourceGeneration);
+    }
 }
 
 void TileTask::complete() {
 
+    // Sub-tasks that are still pending attach a placeholder here and swap
+    // their result in through completeLate() once it arrives.
     for (auto& subTask : m_subTasks) {
-        assert(subTask->isReady());
         subTask->complete(*this);
     }
-    
+
 }
 
 }
@@ -54,6 +54,34 @@ public:
     void setProxyState(bool isProxy) { m_proxyState = isProxy; }
     bool isProxy() const { return m_proxyState; }
 
+    /* Time the download for this task started, for the throughput
+     * measurement in TileManager; stays 0 when the data did not come
+     * from a download. */
+    void setLoadStart(double _time) { m_loadStart = _time; }
+    double loadStart() const { return m_loadStart; }
+
+    /* Background tasks warm the tile cache: the workers only pick them up
+     * when no interactive task is queued, and TileManager stores their
+     * result in the cache instead of the visible tile set. */
+    void setBackground(bool _background) { m_background = _background; }
+    bool isBackground() const { return m_background; }
+
+    /* Download-only background tasks end once their data is stored in the
+     * source's caches; no mesh is built. Used for offline region
+     * downloads, see TileManager::warmTiles(). */
+    void setDownloadOnly(bool _downloadOnly) { m_downloadOnly = _downloadOnly; }
+    bool isDownloadOnly() const { return m_downloadOnly; }
+
+    /* Collection names the scene references for this source, or null when
+     * unknown. Sources may skip decoding collections that are not listed.
+     * Assigned by process() before parsing. */
+    const std::vector<std::string>* collectionFilter() const { return m_collectionFilter; }
+
+    /* Whether the parsed data handed to the build may also be referenced
+     * by overzoomed sibling tasks and must not be modified in place.
+     * Set by process(). */
+    bool sharedTileData() const { return m_sharedTileData; }
+
     auto& subTasks() { return m_subTasks; }
     int subTaskId() const { return m_subTaskId; }
     bool isSubTask() const { return m_subTaskId >= 0; }
@@ -67,6 +95,10 @@ public:
     // onDone for sub-tasks
     virtual void complete(TileTask& _mainTask) {}
 
+    // For sub-tasks finishing after their main task completed: attach the
+    // result to the already-active tile. Default no-op.
+    virtual void completeLate() {}
+
 protected:
 
     const TileID m_tileId;
@@ -84,10 +116,21 @@ protected:
     // Tile result, set when tile was  sucessfully created
     std::shared_ptr<Tile> m_tile;
 
-    bool m_canceled = false;
+    // Set on the main thread, checked by workers between build stages.
+    std::atomic<bool> m_canceled{false};
 
     std::atomic<float> m_priority;
     bool m_proxyState = false;
+
+    bool m_sharedTileData = false;
+
+    bool m_background = false;
+
+    bool m_downloadOnly = false;
+
+    double m_loadStart = 0.0;
+
+    const std::vector<std::string>* m_collectionFilter = nullptr;
 };
 
 class DownloadTileTask : public TileTask {
@@ -100,10 +143,22 @@ public:
     }
     // Raw tile data that will be processed by DataSource.
     std::shared_ptr<std::vector<char>> rawTileData;
+
+    // Stale persistent-cache copy awaiting revalidation; served without a
+    // body transfer when the server answers the conditional request with 304.
+    std::shared_ptr<std::vector<char>> cachedTileData;
+    std::string cachedETag;
+
+    // Validator of the downloaded response, stored alongside the tile.
+    std::string responseETag;
 };
 
 struct TileTaskQueue {
     virtual void enqueue(std::shared_ptr<TileTask>&& task) = 0;
+
+    /* Drain tasks whose processing finished since the last call into
+     * _tasks; returns true if any task was collected. */
+    virtual bool collectCompleted(std::vector<std::shared_ptr<TileTask>>& _tasks) { return false; }
 };
 
 struct TileTaskCb {
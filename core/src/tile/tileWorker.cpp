@@ -1,14 +1,18 @@
 #include "tileWorker.h"
 
+#include "debug/allocStats.h"
+#include "debug/trace.h"
 #include "platform.h"
 #include "data/dataSource.h"
 #include "tile/tileID.h"
 #include "tile/tileTask.h"
 #include "tile/tileBuilder.h"
+#include "util/frameScheduler.h"
 #include "tangram.h"
 #include "log.h"
 
 #include <algorithm>
+#include <chrono>
 
 #define WORKER_NICENESS 10
 
@@ -17,8 +21,13 @@ namespace Tangram {
 TileWorker::TileWorker(int _num_worker) {
     m_running = true;
 
+    // Half the pool starts active; the rest are spare threads the
+    // build-time feedback can grow into when the cores keep up.
+    m_activeWorkers = std::max(1, _num_worker / 2);
+
     for (int i = 0; i < _num_worker; i++) {
         auto worker = std::make_unique<Worker>();
+        worker->index = i;
         worker->thread = std::thread(&TileWorker::run, this, worker.get());
         m_workers.push_back(std::move(worker));
     }
@@ -30,93 +39,381 @@ TileWorker::~TileWorker(){
     }
 }
 
+namespace {
+
+// Proxy tiles and tiles of stale source generations sort after anything
+// that is needed for the current view.
+double taskSortKey(const TileTask& _task) {
+    double key = _task.getPriority();
+    if (_task.isProxy()) { key += 1e8; }
+    return key;
+}
+
+struct HeapCompare {
+    bool operator()(const TileWorker::QueuedTask& a,
+                    const TileWorker::QueuedTask& b) const {
+        // std::push_heap builds a max-heap - invert for min-first.
+        return a.key > b.key;
+    }
+};
+
+double secondsNow() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+std::shared_ptr<TileTask> TileWorker::dequeue(Worker& _self) {
+
+    std::shared_ptr<TileTask> task;
+
+    // Move incoming tasks from the lock-free queue into the local heap.
+    // Once in the heap a task is no longer visible to stealing peers, so
+    // it leaves the shared pending count.
+    while (_self.queue.pop(task)) {
+        m_pendingTasks.fetch_sub(1);
+        _self.heap.push_back({taskSortKey(*task), std::move(task)});
+        std::push_heap(_self.heap.begin(), _self.heap.end(), HeapCompare{});
+    }
+
+    while (!_self.heap.empty()) {
+        std::pop_heap(_self.heap.begin(), _self.heap.end(), HeapCompare{});
+        auto entry = std::move(_self.heap.back());
+        _self.heap.pop_back();
+
+        if (entry.task->isCanceled()) {
+            continue;
+        }
+
+        // TileManager re-prioritizes waiting tasks as the view moves. When
+        // the key this entry was inserted with is stale, re-insert it with
+        // the live priority instead of building a possibly occluded tile.
+        double key = taskSortKey(*entry.task);
+        if (key > entry.key) {
+            entry.key = key;
+            _self.heap.push_back(std::move(entry));
+            std::push_heap(_self.heap.begin(), _self.heap.end(), HeapCompare{});
+            continue;
+        }
+
+        return std::move(entry.task);
+    }
+
+    // Steal from the other workers' queues.
+    for (auto& other : m_workers) {
+        if (other.get() == &_self) { continue; }
+
+        if (other->queue.pop(task)) {
+            m_pendingTasks.fetch_sub(1);
+            return task;
+        }
+    }
+
+    // Drain tasks that overflowed the fixed-size queues.
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_overflowQueue.empty()) {
+            task = std::move(m_overflowQueue.back());
+            m_overflowQueue.pop_back();
+            m_pendingTasks.fetch_sub(1);
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<TileTask> TileWorker::dequeueBackground() {
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_backgroundQueue.empty()) {
+        auto task = std::move(m_backgroundQueue.back());
+        m_backgroundQueue.pop_back();
+        m_pendingBackground.fetch_sub(1);
+
+        if (!task->isCanceled()) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
 void TileWorker::run(Worker* instance) {
 
     setCurrentThreadPriority(WORKER_NICENESS);
 
+    TRACE_THREAD("TileWorker");
+
     std::unique_ptr<TileBuilder> builder;
+    uint64_t builderVersion = 0;
 
     while (true) {
 
-        std::shared_ptr<TileTask> task;
+        std::shared_ptr<Scene> scene;
+
         {
             std::unique_lock<std::mutex> lock(m_mutex);
 
+            // Workers beyond the active count park here; a non-empty heap
+            // still gets drained so no task is stranded when the pool
+            // shrinks.
             m_condition.wait(lock, [&, this]{
-                    return !m_running || !m_queue.empty();
+                    return !m_running || !instance->heap.empty()
+                        || builderVersion != m_sceneVersion.load()
+                        || (instance->index < m_activeWorkers.load()
+                            && (m_pendingTasks.load() > 0
+                                || m_pendingBackground.load() > 0));
                 });
 
-            if (instance->tileBuilder) {
-                builder = std::move(instance->tileBuilder);
-                LOG("Passed new TileBuilder to TileWorker");
+            if (builderVersion != m_sceneVersion.load()) {
+                scene = m_scene;
+                builderVersion = m_sceneVersion.load();
             }
 
             // Check if thread should stop
             if (!m_running) {
                 break;
             }
+        }
 
-            if (!builder) {
-                continue;
-            }
-
-            // Remove all canceled tasks
-            auto removes = std::remove_if(m_queue.begin(), m_queue.end(),
-                                          [](const auto& a) { return a->isCanceled(); });
-
-            m_queue.erase(removes, m_queue.end());
-
-            if (m_queue.empty()) {
-                continue;
-            }
+        if (scene) {
+            // Construct the TileBuilder against the adopted snapshot
+            // outside the lock; each worker builds its own, off the
+            // thread that published the scene.
+            builder = std::make_unique<TileBuilder>(std::move(scene));
+            LOG("TileWorker %d adopted scene snapshot %d",
+                instance->index, int(builderVersion));
+        }
 
-            // Pop highest priority tile from queue
-            auto it = std::min_element(m_queue.begin(), m_queue.end(),
-                [](const auto& a, const auto& b) {
-                    if (a->isProxy() != b->isProxy()) {
-                        return !a->isProxy();
-                    }
-                    if (a->source().id() == b->source().id() &&
-                        a->sourceGeneration() != b->sourceGeneration()) {
-                        return a->sourceGeneration() < b->sourceGeneration();
-                    }
-                    return a->getPriority() < b->getPriority();
-                });
+        if (!builder) {
+            continue;
+        }
 
-            task = std::move(*it);
-            m_queue.erase(it);
+        auto task = dequeue(*instance);
+        if (!task) {
+            // Nothing interactive left anywhere - take warming work.
+            task = dequeueBackground();
+        }
+        if (!task) {
+            continue;
         }
 
         if (task->isCanceled()) {
             continue;
         }
 
-        // const clock_t begin = clock();
+        {
+            TRACE_SCOPE("TileWorker::run");
+            ALLOC_TAG(tileParse);
 
-        task->process(*builder);
+            double start = secondsNow();
+            task->process(*builder);
+            adaptPoolSize(secondsNow() - start);
+        }
+
+        deliver(*instance, std::move(task));
+    }
+}
 
-        // float loadTime = (float(clock() - begin) / CLOCKS_PER_SEC) * 1000;
-        // LOG("loadTime %s - %f", task->tileID.toString().c_str(), loadTime);
+void TileWorker::deliver(Worker& _self, std::shared_ptr<TileTask>&& _task) {
+
+    if (!_self.completed.push(std::move(_task))) {
+        // Completion queue is full - park the task for collectCompleted.
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_completedOverflow.push_back(std::move(_task));
+    }
 
-        requestRender();
+    // Batch the wakeup: tasks finishing while an earlier completion still
+    // awaits collection ride along with its notification.
+    if (!m_completedPending.exchange(true)) {
+        FrameScheduler::requestFrame();
     }
 }
 
-void TileWorker::setScene(std::shared_ptr<Scene>& _scene) {
+bool TileWorker::collectCompleted(std::vector<std::shared_ptr<TileTask>>& _tasks) {
+
+    size_t before = _tasks.size();
+
+    // Re-arm the notification before draining so a completion racing with
+    // the drain triggers another wakeup rather than going unseen.
+    m_completedPending.store(false);
+
+    std::shared_ptr<TileTask> task;
     for (auto& worker : m_workers) {
-        worker->tileBuilder = std::make_unique<TileBuilder>(_scene);
+        while (worker->completed.pop(task)) {
+            _tasks.push_back(std::move(task));
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_completedOverflow.empty()) {
+            for (auto& overflow : m_completedOverflow) {
+                _tasks.push_back(std::move(overflow));
+            }
+            m_completedOverflow.clear();
+        }
     }
+
+    return _tasks.size() != before;
+}
+
+void TileWorker::setScene(std::shared_ptr<Scene>& _scene) {
+    // Publish the next snapshot; worker state is never touched from
+    // here, so builds in flight finish against the scene they started
+    // with and retire it with their last reference.
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_scene = _scene;
+        m_sceneVersion.fetch_add(1);
+    }
+    m_condition.notify_all();
 }
 
 void TileWorker::enqueue(std::shared_ptr<TileTask>&& task) {
+
+    if (!m_running) {
+        return;
+    }
+
+    if (task->isBackground()) {
+        // Cache-warming work goes to its own lane so it never competes
+        // with interactive tiles for the worker queues and heaps.
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_running) { return; }
+        m_backgroundQueue.push_back(std::move(task));
+        m_pendingBackground.fetch_add(1);
+        // Broadcast: a single notification could be consumed by a spare
+        // parked beyond the active count, whose predicate is false.
+        m_condition.notify_all();
+        return;
+    }
+
+    // Distribute tasks round-robin over the active workers' queues. The
+    // push is lock-free; idle workers will steal should the assignment
+    // turn out unbalanced, and stealing also rescues tasks left in the
+    // queue of a worker the pool shrank away.
+    size_t active = std::min(m_workers.size(), size_t(m_activeWorkers.load()));
+    uint32_t start = m_enqueueIndex.fetch_add(1);
+    bool queued = false;
+
+    for (size_t i = 0; i < active; i++) {
+        auto& worker = m_workers[(start + i) % active];
+
+        if (worker->queue.push(std::move(task))) {
+            queued = true;
+            break;
+        }
+    }
+
+    if (!queued) {
+        // All worker queues are full - park the task until a worker
+        // drains the overflow list.
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_running) { return; }
+        m_overflowQueue.push_back(std::move(task));
+    }
+
+    m_pendingTasks.fetch_add(1);
+
+    // Workers evaluate the wait predicate under m_mutex; passing through
+    // the lock here orders the counter update against a worker that saw
+    // no pending work but has not blocked yet, so the notification
+    // cannot fall between its predicate check and its wait.
+    { std::lock_guard<std::mutex> lock(m_mutex); }
+
+    // Broadcast instead of waking one thread: with workers parked beyond
+    // the active count, a single notification can land on a spare whose
+    // predicate is false, and the task would strand. Spares re-check and
+    // block again right away.
+    m_condition.notify_all();
+}
+
+int TileWorker::workerCap() const {
+
+    int cap = int(m_workers.size());
+
+    int hint = m_hintWorkers.load();
+    if (hint > 0) { cap = std::min(cap, hint); }
+
+    if (m_throttled.load()) { cap = std::max(1, cap / 2); }
+
+    return cap;
+}
+
+void TileWorker::setHints(int _performantCores, bool _thermalThrottled) {
+
+    if (_performantCores > 0) { m_hintWorkers.store(_performantCores); }
+    m_throttled.store(_thermalThrottled);
+
+    int cap = workerCap();
+    int active = m_activeWorkers.load();
+
+    if (active > cap) {
+        m_activeWorkers.store(cap);
+    } else if (active < cap && !_thermalThrottled) {
+        // A raised cap takes effect right away; growing further is left
+        // to the build-time feedback.
+        m_condition.notify_all();
+    }
+
+    LOG("TileWorker hints: %d performant cores, throttled:%d -> %d active",
+        _performantCores, _thermalThrottled, m_activeWorkers.load());
+}
+
+void TileWorker::adaptPoolSize(double _taskTime) {
+
+    // Window of the moving average, in tasks.
+    const double window = 16.0;
+    // Seconds between resizes, damping oscillation.
+    const double cooldown = 2.0;
+
+    int target = 0;
     {
         std::unique_lock<std::mutex> lock(m_mutex);
-        if (!m_running) {
+
+        if (m_avgTaskTime == 0.0) {
+            m_avgTaskTime = _taskTime;
+        } else {
+            m_avgTaskTime += (_taskTime - m_avgTaskTime) / window;
+        }
+
+        // The best sustained average is the baseline; let it drift up
+        // slowly so one burst of tiny tiles cannot pin it forever.
+        if (m_bestTaskTime == 0.0 || m_avgTaskTime < m_bestTaskTime) {
+            m_bestTaskTime = m_avgTaskTime;
+        } else {
+            m_bestTaskTime *= 1.001;
+        }
+
+        double now = secondsNow();
+        if (now - m_lastResizeTime < cooldown) { return; }
+
+        int active = m_activeWorkers.load();
+        int cap = workerCap();
+
+        if (active > cap || (active > 1 && m_avgTaskTime > 2.0 * m_bestTaskTime)) {
+            // Builds run well below the sustained pace: the cores are
+            // oversubscribed or thermally throttled - back off.
+            target = std::min(active - 1, cap);
+        } else if (active < cap && m_avgTaskTime < 1.25 * m_bestTaskTime &&
+                   m_pendingTasks.load() > active) {
+            // Near-baseline builds and a backlog - use another core.
+            target = active + 1;
+        } else {
             return;
         }
-        m_queue.push_back(std::move(task));
+
+        m_activeWorkers.store(std::max(1, target));
+        m_lastResizeTime = now;
+
+        LOG("TileWorker pool resized to %d (avg %.1fms, base %.1fms)",
+            m_activeWorkers.load(), m_avgTaskTime * 1000.0, m_bestTaskTime * 1000.0);
     }
-    m_condition.notify_one();
+
+    m_condition.notify_all();
 }
 
 void TileWorker::stop() {
@@ -2,6 +2,8 @@
 
 #include "tile/tileTask.h"
 #include "util/jobQueue.h"
+#include "util/mpmcQueue.h"
+#include "util/spscQueue.h"
 
 #include <memory>
 #include <vector>
@@ -26,29 +28,138 @@ public:
 
     virtual void enqueue(std::shared_ptr<TileTask>&& task) override;
 
+    // Drain completed tasks from all worker completion queues; called on
+    // the thread running TileManager::updateTileSets.
+    virtual bool collectCompleted(std::vector<std::shared_ptr<TileTask>>& _tasks) override;
+
     void stop();
 
     bool isRunning() const { return m_running; }
 
+    /* Hint the pool about the platform. _performantCores caps the active
+     * workers to the number of cores that run builds at full speed - on
+     * big.LITTLE devices the big cluster - and 0 leaves the cap unchanged.
+     * _thermalThrottled halves the cap while set. Safe to call from any
+     * thread; platforms call this when topology or thermal state changes.
+     * Without hints the pool adapts from measured build times alone. */
+    void setHints(int _performantCores, bool _thermalThrottled);
+
+    int activeWorkers() const { return m_activeWorkers.load(); }
+
+    /* Publish _scene as the snapshot new builds run against. Workers
+     * adopt it at their next task boundary and build their own
+     * TileBuilder from it; builds already in flight finish against the
+     * snapshot they started with, which is retired when the last such
+     * build drops its references. */
     void setScene(std::shared_ptr<Scene>& _scene);
 
+    // Heap entry holding the priority under which a task was (re-)inserted.
+    // Priorities are updated atomically by TileManager while tasks wait, so
+    // the key is re-checked against the live value when the entry surfaces.
+    struct QueuedTask {
+        double key;
+        std::shared_ptr<TileTask> task;
+    };
+
 private:
 
+    // Number of task slots in each worker's local queue.
+    static const size_t QUEUE_CAPACITY = 512;
+
     struct Worker {
+        Worker() : queue(QUEUE_CAPACITY), completed(QUEUE_CAPACITY) {}
+
+        // Position in m_workers; workers with index >= m_activeWorkers
+        // park once their local work is drained.
+        int index = 0;
+
         std::thread thread;
-        std::unique_ptr<TileBuilder> tileBuilder;
+
+        // Local task queue: the owning worker dequeues from it on the
+        // lock-free fast path, idle workers steal from it.
+        MPMCQueue<std::shared_ptr<TileTask>> queue;
+
+        // Completion channel back to the update thread; the owning worker
+        // is the single producer, collectCompleted the single consumer.
+        SPSCQueue<std::shared_ptr<TileTask>> completed;
+
+        // Min-heap on QueuedTask::key, only touched by the owning thread.
+        std::vector<QueuedTask> heap;
     };
 
     void run(Worker* instance);
 
-    bool m_running;
+    // Dequeue a task for _self, stealing from other workers when the
+    // local queue is empty. Returns an empty pointer when no work is left.
+    std::shared_ptr<TileTask> dequeue(Worker& _self);
+
+    // Take a task from the background lane; only called after dequeue()
+    // came up empty, so warming work never delays interactive tiles.
+    std::shared_ptr<TileTask> dequeueBackground();
+
+    // Feed the duration of a finished build into the moving average and
+    // grow or shrink the active worker count when the measurements say
+    // builds got faster or slower than the sustained baseline.
+    void adaptPoolSize(double _taskTime);
+
+    // Upper bound of active workers from pool size, hints and thermal state.
+    int workerCap() const;
+
+    // Hand a processed task back to the update thread, waking the render
+    // loop only when no earlier completion is still pending collection.
+    void deliver(Worker& _self, std::shared_ptr<TileTask>&& _task);
+
+    // Written under m_mutex in stop(); atomic for the lock-free reads on
+    // the enqueue fast path.
+    std::atomic<bool> m_running;
 
     std::vector<std::unique_ptr<Worker>> m_workers;
 
     std::condition_variable m_condition;
 
+    // Round-robin cursor distributing incoming tasks over workers.
+    std::atomic<uint32_t> m_enqueueIndex{0};
+
+    // Number of tasks in worker queues and the overflow list,
+    // used as the wakeup predicate.
+    std::atomic<int> m_pendingTasks{0};
+
+    // True while completions await collection; lets a batch of tasks
+    // finishing together wake the render loop once.
+    std::atomic<bool> m_completedPending{false};
+
+    // Tasks in the background lane, see dequeueBackground().
+    std::atomic<int> m_pendingBackground{0};
+
+    // Number of workers currently taking new tasks, in [1, m_workers.size()]
+    std::atomic<int> m_activeWorkers{1};
+
+    // The published scene snapshot; guarded by m_mutex. Workers compare
+    // m_sceneVersion - a wait-free atomic read - against the version
+    // their TileBuilder was made from at every task boundary and only
+    // take the lock to copy the snapshot when it moved on.
+    std::shared_ptr<Scene> m_scene;
+    std::atomic<uint64_t> m_sceneVersion{0};
+
+    // Platform hints, see setHints(). 0 means no topology hint given.
+    std::atomic<int> m_hintWorkers{0};
+    std::atomic<bool> m_throttled{false};
+
+    // Build-time feedback, guarded by m_mutex: a moving average of task
+    // durations and the best sustained average as the baseline.
+    double m_avgTaskTime = 0.0;
+    double m_bestTaskTime = 0.0;
+    double m_lastResizeTime = 0.0;
+
+    // Slow path: tasks that did not fit into any worker queue.
     std::mutex m_mutex;
-    std::vector<std::shared_ptr<TileTask>> m_queue;
+    std::vector<std::shared_ptr<TileTask>> m_overflowQueue;
+
+    // Low-priority lane for cache-warming tasks, see TileTask::isBackground().
+    std::vector<std::shared_ptr<TileTask>> m_backgroundQueue;
+
+    // Slow path: completions that did not fit into their worker's queue.
+    std::vector<std::shared_ptr<TileTask>> m_completedOverflow;
 };
 
 }
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace Tangram {
+
+/* Bump allocator for short-lived object graphs.
+ *
+ * Hands out memory from geometrically growing blocks and releases
+ * everything in one shot when destroyed (or reset), replacing thousands
+ * of small allocations with a handful of block mallocs. Used for the
+ * geometry of one TileData, which lives exactly as long as its tile
+ * build.
+ */
+class Arena {
+
+public:
+
+    explicit Arena(size_t _blockSize = 1 << 16)
+        : m_blockSize(_blockSize) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t _bytes, size_t _align = alignof(std::max_align_t)) {
+
+        size_t offset = (m_offset + _align - 1) & ~(_align - 1);
+
+        if (m_blocks.empty() || offset + _bytes > m_capacity) {
+            size_t blockSize = m_blockSize;
+            while (blockSize < _bytes) { blockSize *= 2; }
+
+            m_blocks.emplace_back(new char[blockSize]);
+            m_capacity = blockSize;
+            offset = 0;
+        }
+
+        m_offset = offset + _bytes;
+        return m_blocks.back().get() + offset;
+    }
+
+    /* Drop all allocations at once. Pointers into the arena are invalid
+     * afterwards. */
+    void reset() {
+        m_blocks.clear();
+        m_offset = 0;
+        m_capacity = 0;
+    }
+
+    size_t blockCount() const { return m_blocks.size(); }
+
+private:
+
+    size_t m_blockSize;
+    size_t m_offset = 0;
+    size_t m_capacity = 0;
+
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+};
+
+/* Minimal std-allocator over an Arena.
+ *
+ * A default-constructed instance has no arena and falls back to the
+ * heap, so containers using this allocator behave exactly like their
+ * plain counterparts unless an arena is passed in. deallocate() is a
+ * no-op for arena-backed memory; the arena frees in bulk.
+ */
+template<typename T>
+class ArenaAllocator {
+
+public:
+
+    using value_type = T;
+
+    ArenaAllocator() = default;
+
+    ArenaAllocator(Arena* _arena) : m_arena(_arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& _other) : m_arena(_other.arena()) {}
+
+    T* allocate(size_t _n) {
+        if (m_arena) {
+            return static_cast<T*>(m_arena->allocate(_n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(_n * sizeof(T)));
+    }
+
+    void deallocate(T* _ptr, size_t) {
+        if (!m_arena) { ::operator delete(_ptr); }
+    }
+
+    Arena* arena() const { return m_arena; }
+
+    bool operator==(const ArenaAllocator& _other) const { return m_arena == _other.m_arena; }
+    bool operator!=(const ArenaAllocator& _other) const { return m_arena != _other.m_arena; }
+
+private:
+
+    Arena* m_arena = nullptr;
+};
+
+}
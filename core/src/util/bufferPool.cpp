@@ -0,0 +1,60 @@
+#include "util/bufferPool.h"
+
+#include <mutex>
+
+namespace Tangram {
+
+namespace BufferPool {
+
+// Enough for a viewport of tile responses; pooling more capacity than
+// that would only pin memory between pans.
+constexpr size_t maxPooledBuffers = 32;
+constexpr size_t maxPooledBytes = 16 * 1024 * 1024;
+
+static std::mutex s_mutex;
+static std::vector<std::vector<char>> s_buffers;
+static size_t s_pooledBytes = 0;
+
+std::vector<char> acquire() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    if (s_buffers.empty()) { return {}; }
+
+    auto buffer = std::move(s_buffers.back());
+    s_buffers.pop_back();
+    s_pooledBytes -= buffer.capacity();
+
+    return buffer;
+}
+
+void release(std::vector<char>&& _buffer) {
+
+    if (_buffer.capacity() == 0) { return; }
+
+    // clear() keeps the allocation - that is the whole point
+    _buffer.clear();
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    if (s_buffers.size() >= maxPooledBuffers ||
+        s_pooledBytes + _buffer.capacity() > maxPooledBytes) {
+        return;
+    }
+
+    s_pooledBytes += _buffer.capacity();
+    s_buffers.push_back(std::move(_buffer));
+}
+
+std::shared_ptr<std::vector<char>> adopt(std::vector<char>&& _data) {
+
+    return std::shared_ptr<std::vector<char>>(
+        new std::vector<char>(std::move(_data)),
+        [](std::vector<char>* _buffer) {
+            release(std::move(*_buffer));
+            delete _buffer;
+        });
+}
+
+}
+
+}
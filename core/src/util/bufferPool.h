@@ -0,0 +1,30 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace Tangram {
+
+/* Pool of recycled byte buffers for url responses.
+ *
+ * Tile downloads land in buffers drawn from here and their capacity
+ * returns to the pool once the raw data is finally dropped, so a pan
+ * that keeps dozens of fetches in flight cycles through a steady set of
+ * allocations instead of growing and freeing a fresh vector per
+ * response.
+ */
+namespace BufferPool {
+
+/* An empty buffer, with whatever capacity its last user grew it to */
+std::vector<char> acquire();
+
+/* Hand the capacity of _buffer back for reuse */
+void release(std::vector<char>&& _buffer);
+
+/* Wrap _data in a shared reference whose buffer returns to the pool
+ * when the last owner lets go */
+std::shared_ptr<std::vector<char>> adopt(std::vector<char>&& _data);
+
+}
+
+}
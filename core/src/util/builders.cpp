@@ -1,6 +1,7 @@
 #include "builders.h"
 
 #include "geom.h"
+#include "hash.h"
 #include "glm/gtx/rotate_vector.hpp"
 #include "glm/gtx/norm.hpp"
 
@@ -17,6 +18,31 @@ struct nth<1, Tangram::Point> {
 
 namespace Tangram {
 
+namespace {
+
+struct PolyLineBatch {
+    std::vector<PolyLineBuilder::Vertex> vertices;
+    std::vector<uint16_t> indices;
+    size_t numVertices = 0;
+};
+
+// Per-worker cache of tessellated line batches, active for the duration
+// of one tile build (see Builders::beginPolyLineCache).
+thread_local bool t_polyLineCacheActive = false;
+thread_local fastmap_soa<size_t, PolyLineBatch> t_polyLineCache;
+
+}
+
+void Builders::beginPolyLineCache() {
+    t_polyLineCacheActive = true;
+    t_polyLineCache.clear();
+}
+
+void Builders::endPolyLineCache() {
+    t_polyLineCacheActive = false;
+    t_polyLineCache.clear();
+}
+
 CapTypes CapTypeFromString(const std::string& str) {
     if (str == "square") { return CapTypes::square; }
     if (str == "round") { return CapTypes::round; }
@@ -29,10 +55,14 @@ JoinTypes JoinTypeFromString(const std::string& str) {
     return JoinTypes::miter;
 }
 
-void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx) {
+// The tessellation loop is instantiated once per texcoord mode, so the
+// no-UV path taken by flat fill styles carries no bounding-box scan and
+// no per-vertex mapping math at all.
+template<bool TexCoords>
+static void buildPolygonImpl(const Polygon& _polygon, float _height, PolygonBuilder& _ctx) {
 
     glm::vec2 min, max;
-    if (_ctx.useTexCoords) {
+    if (TexCoords) {
         min = glm::vec2(std::numeric_limits<float>::max());
         max = glm::vec2(std::numeric_limits<float>::min());
 
@@ -44,18 +74,31 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
         }
     }
 
-    // Run earcut, triangles are stored in _ctx.earcut.indices
-    _ctx.earcut(_polygon);
-
     size_t sumPoints = 0;
+    size_t geomHash = _polygon.size();
     for (auto& line : _polygon) {
         sumPoints += line.size();
+        for (auto& p : line) {
+            hash_combine(geomHash, p.x);
+            hash_combine(geomHash, p.y);
+        }
+    }
+
+    // Triangulation depends only on the ring geometry, so identical
+    // footprints - multipolygon rings and features matched into the
+    // style by several rules - reuse the earcut result.
+    const std::vector<uint16_t>* triangles = _ctx.earcutCache.find(geomHash);
+
+    if (!triangles) {
+        // Run earcut, triangles are stored in _ctx.earcut.indices
+        _ctx.earcut(_polygon);
+        triangles = &(_ctx.earcutCache[geomHash] = _ctx.earcut.indices);
     }
 
     // Mark the points that are referenced by indices as used.
     size_t sumVertices = 0;
     _ctx.used.assign(sumPoints, 0);
-    for (auto i : _ctx.earcut.indices) {
+    for (auto i : *triangles) {
         if (_ctx.used[i] == 0) {
             _ctx.used[i] = 1;
             sumVertices++;
@@ -64,6 +107,7 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
 
     uint16_t vertexDataOffset = _ctx.numVertices;
     _ctx.numVertices += sumVertices;
+    _ctx.vertices.reserve(_ctx.vertices.size() + sumVertices);
 
     size_t ring = 0;
     size_t offset = 0;
@@ -86,21 +130,30 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
         auto& p = _polygon[ring][src - offset];
         glm::vec3 coord(p.x, p.y, _height);
 
-        if (_ctx.useTexCoords) {
+        if (TexCoords) {
             glm::vec2 uv(mapValue(coord.x, min.x, max.x, 0., 1.),
                          mapValue(coord.y, min.y, max.y, 1., 0.));
 
-            _ctx.addVertex(coord, glm::vec3(0.0, 0.0, 1.0), uv);
+            _ctx.vertices.push_back({ coord, glm::vec3(0.0, 0.0, 1.0), uv });
         } else {
-            _ctx.addVertex(coord, glm::vec3(0.0, 0.0, 1.0), glm::vec2(0));
+            _ctx.vertices.push_back({ coord, glm::vec3(0.0, 0.0, 1.0), glm::vec2(0) });
         }
     }
 
-    for (auto i : _ctx.earcut.indices) {
+    for (auto i : *triangles) {
         _ctx.indices.push_back(vertexDataOffset + _ctx.used[i]);
     }
 }
 
+void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx) {
+
+    if (_ctx.useTexCoords) {
+        buildPolygonImpl<true>(_polygon, _height, _ctx);
+    } else {
+        buildPolygonImpl<false>(_polygon, _height, _ctx);
+    }
+}
+
 void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx) {
 
     auto vertexDataOffset = _ctx.numVertices;
@@ -108,6 +161,12 @@ void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight,
     static const glm::vec3 upVector(0.0f, 0.0f, 1.0f);
     glm::vec3 normalVector;
 
+    size_t sumVertices = 0;
+    for (auto& line : _polygon) {
+        sumVertices += (line.size() - 1) * 4;
+    }
+    _ctx.vertices.reserve(_ctx.vertices.size() + sumVertices);
+
     for (auto& line : _polygon) {
 
         size_t lineSize = line.size();
@@ -128,19 +187,19 @@ void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight,
 
             // 1st vertex top
             a.z = _maxHeight;
-            _ctx.addVertex(a, normalVector, glm::vec2(1.,1.));
+            _ctx.vertices.push_back({ a, normalVector, glm::vec2(1.,1.) });
 
             // 2nd vertex top
             b.z = _maxHeight;
-            _ctx.addVertex(b, normalVector, glm::vec2(0.,1.));
+            _ctx.vertices.push_back({ b, normalVector, glm::vec2(0.,1.) });
 
             // 1st vertex bottom
             a.z = _minHeight;
-            _ctx.addVertex(a, normalVector, glm::vec2(1.,0.));
+            _ctx.vertices.push_back({ a, normalVector, glm::vec2(1.,0.) });
 
             // 2nd vertex bottom
             b.z = _minHeight;
-            _ctx.addVertex(b, normalVector, glm::vec2(0.,0.));
+            _ctx.vertices.push_back({ b, normalVector, glm::vec2(0.,0.) });
 
             // Start the index from the previous state of the vertex Data
             _ctx.indices.push_back(vertexDataOffset);
@@ -166,7 +225,7 @@ glm::vec2 perp2d(const glm::vec3& _v1, const glm::vec3& _v2 ){
 // Helper function for polyline tesselation
 inline void addPolyLineVertex(const glm::vec3& _coord, const glm::vec2& _normal, const glm::vec2& _uv, PolyLineBuilder& _ctx) {
     _ctx.numVertices++;
-    _ctx.addVertex(_coord, _normal, _uv);
+    _ctx.vertices.push_back({ _coord, _normal, _uv });
 }
 
 // Helper function for polyline tesselation; adds indices for pairs of vertices arranged like a line strip
@@ -187,6 +246,7 @@ void indexPairs( int _nPairs, int _nVertices, std::vector<uint16_t>& _indicesOut
 //  and interpolating their UVs               \ p /
 //                                             \./
 //                                              C
+template<bool TexCoords>
 void addFan(const glm::vec3& _pC,
             const glm::vec2& _nA, const glm::vec2& _nB, const glm::vec2& _nC,
             const glm::vec2& _uA, const glm::vec2& _uB, const glm::vec2& _uC,
@@ -211,7 +271,7 @@ void addFan(const glm::vec3& _pC,
         radial = glm::rotate(_nA, angle * frac);
 
         glm::vec2 uv(0.0);
-        if (_ctx.useTexCoords) {
+        if (TexCoords) {
             uv = (1.f - frac) * _uA + frac * _uB;
         }
 
@@ -226,6 +286,7 @@ void addFan(const glm::vec3& _pC,
 }
 
 // Function to add the vertices for line caps
+template<bool TexCoords>
 void addCap(const glm::vec3& _coord, const glm::vec2& _normal, int _numCorners, bool _isBeginning, PolyLineBuilder& _ctx) {
 
     float v = _isBeginning ? 0.f : 1.f; // length-wise tex coord
@@ -252,7 +313,76 @@ void addCap(const glm::vec3& _coord, const glm::vec2& _normal, int _numCorners,
         uA.x = 0.f; // To keep tex coords consistent, we must reverse these too
         uB.x = 1.f;
     }
-    addFan(_coord, nA, nB, nC, uA, uB, uC, _numCorners, _ctx);
+    addFan<TexCoords>(_coord, nA, nB, nC, uA, uB, uC, _numCorners, _ctx);
+}
+
+// Cover a round cap with a single quad reaching half a line width past
+// the end point; the fragment shader carves the half circle out of it
+// (see TANGRAM_LINE_FRAGMENT_ROUNDS in polyline.fs). The margin keeps
+// fragments right on the circle clear of the carve threshold.
+void addCapQuad(const glm::vec3& _coord, const glm::vec2& _normal, bool _isBeginning, PolyLineBuilder& _ctx) {
+
+    float v = _isBeginning ? 0.f : 1.f; // length-wise tex coord
+    const float margin = 1.05f;
+
+    glm::vec2 normal = _normal * margin;
+    glm::vec2 tangent(-normal.y, normal.x);
+    if (_isBeginning) { tangent *= -1.f; }
+
+    // Pairs are ordered along the direction of travel to match the
+    // winding of the segment quads
+    if (_isBeginning) {
+        addPolyLineVertex(_coord, normal + tangent, {1.f, v}, _ctx);
+        addPolyLineVertex(_coord, -normal + tangent, {0.f, v}, _ctx);
+        addPolyLineVertex(_coord, normal, {1.f, v}, _ctx);
+        addPolyLineVertex(_coord, -normal, {0.f, v}, _ctx);
+    } else {
+        addPolyLineVertex(_coord, normal, {1.f, v}, _ctx);
+        addPolyLineVertex(_coord, -normal, {0.f, v}, _ctx);
+        addPolyLineVertex(_coord, normal + tangent, {1.f, v}, _ctx);
+        addPolyLineVertex(_coord, -normal + tangent, {0.f, v}, _ctx);
+    }
+    indexPairs(1, _ctx.numVertices, _ctx.indices);
+}
+
+// Cover the open wedge on the outer side of a join with two triangles
+// from the corner point to slightly past the arc; the fragment shader
+// trims them to the round join. The segments around the corner end in
+// square cross-sections through the corner point, so together with the
+// carved wedge the union is exactly the round join with no overdraw.
+void addJoinWedge(const glm::vec3& _coord, const glm::vec2& _normPrev, const glm::vec2& _normNext,
+                  bool _isRightTurn, float _v, PolyLineBuilder& _ctx) {
+
+    glm::vec2 nA = _isRightTurn ? -_normPrev : _normPrev;
+    glm::vec2 nB = _isRightTurn ? -_normNext : _normNext;
+
+    glm::vec2 mid = nA + nB;
+    if (mid == glm::zero<glm::vec2>()) {
+        // Full u-turn; the wedge opens towards the direction of travel
+        mid = glm::vec2(-_normPrev.y, _normPrev.x);
+    } else {
+        mid = glm::normalize(mid);
+    }
+
+    // Scale the rim vertices so the chords stay outside the unit circle
+    float cosQuarter = sqrtf(0.5f * (1.f + glm::dot(nA, mid)));
+    float scale = 1.05f / std::max(cosQuarter, 0.7f);
+
+    float u = _isRightTurn ? 0.f : 1.f; // wedge is on the outer side
+
+    int startIndex = _ctx.numVertices;
+    addPolyLineVertex(_coord, glm::vec2(0.f), {0.5f, _v}, _ctx);
+    addPolyLineVertex(_coord, nA * scale, {u, _v}, _ctx);
+    addPolyLineVertex(_coord, mid * scale, {u, _v}, _ctx);
+    addPolyLineVertex(_coord, nB * scale, {u, _v}, _ctx);
+
+    bool ccw = (nA.x * nB.y - nA.y * nB.x) > 0;
+    _ctx.indices.push_back(startIndex);
+    _ctx.indices.push_back(startIndex + (ccw ? 1 : 2));
+    _ctx.indices.push_back(startIndex + (ccw ? 2 : 1));
+    _ctx.indices.push_back(startIndex);
+    _ctx.indices.push_back(startIndex + (ccw ? 2 : 3));
+    _ctx.indices.push_back(startIndex + (ccw ? 3 : 2));
 }
 
 // Tests if a line segment (from point A to B) is outside the edge of a tile
@@ -274,6 +404,7 @@ bool isOutsideTile(const glm::vec3& _a, const glm::vec3& _b) {
     return false;
 }
 
+template<bool TexCoords, bool FragmentRounds>
 void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _startIndex,
                           size_t _endIndex, bool endCap = true) {
 
@@ -295,11 +426,19 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
     int cornersOnCap = (int)_ctx.cap;
     int trianglesOnJoin = (int)_ctx.join;
 
+    // Common case estimate: two extrusion vertices per point plus the
+    // caps; fans on sharp joins may still grow the batch.
+    _ctx.vertices.reserve(_ctx.numVertices + lineSize * 2 + cornersOnCap * 2 + 4);
+
     // Process first point in line with an end cap
     normNext = glm::normalize(perp2d(coordCurr, coordNext));
 
     if (endCap) {
-        addCap(coordCurr, normNext, cornersOnCap, true, _ctx);
+        if (FragmentRounds) {
+            addCapQuad(coordCurr, normNext, true, _ctx);
+        } else {
+            addCap<TexCoords>(coordCurr, normNext, cornersOnCap, true, _ctx);
+        }
     }
     addPolyLineVertex(coordCurr, normNext, {1.0f, 0.0f}, _ctx); // right corner
     addPolyLineVertex(coordCurr, -normNext, {0.0f, 0.0f}, _ctx); // left corner
@@ -322,6 +461,24 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
         normPrev = normNext;
         normNext = glm::normalize(perp2d(coordCurr, coordNext));
 
+        if (FragmentRounds) {
+            // Close the incoming segment with a square cross-section,
+            // bridge the outer wedge with a carve-tested quad and open
+            // the next segment; the round outline is cut per fragment
+            float vr = distance;
+            bool isRightTurn = (normNext.x * normPrev.y - normNext.y * normPrev.x) > 0;
+
+            addPolyLineVertex(coordCurr, normPrev, {1.0f, vr}, _ctx); // right corner
+            addPolyLineVertex(coordCurr, -normPrev, {0.0f, vr}, _ctx); // left corner
+            indexPairs(1, _ctx.numVertices, _ctx.indices);
+
+            addJoinWedge(coordCurr, normPrev, normNext, isRightTurn, vr, _ctx);
+
+            addPolyLineVertex(coordCurr, normNext, {1.0f, vr}, _ctx); // right corner
+            addPolyLineVertex(coordCurr, -normNext, {0.0f, vr}, _ctx); // left corner
+            continue;
+        }
+
         // Compute "normal" for miter joint
         miterVec = normPrev + normNext;
 
@@ -364,7 +521,7 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
                 addPolyLineVertex(coordCurr, -normPrev, {0.0f, v}, _ctx); // left (outer) corner
                 indexPairs(1, _ctx.numVertices, _ctx.indices);
 
-                addFan(coordCurr, -normPrev, -normNext, miterVec, {0.f, v}, {0.f, v}, {1.f, v}, trianglesOnJoin, _ctx);
+                addFan<TexCoords>(coordCurr, -normPrev, -normNext, miterVec, {0.f, v}, {0.f, v}, {1.f, v}, trianglesOnJoin, _ctx);
 
                 addPolyLineVertex(coordCurr, miterVec, {1.0f, v}, _ctx); // right (inner) corner
                 addPolyLineVertex(coordCurr, -normNext, {0.0f, v}, _ctx); // left (outer) corner
@@ -375,7 +532,7 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
                 addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx); // left (inner) corner
                 indexPairs(1, _ctx.numVertices, _ctx.indices);
 
-                addFan(coordCurr, normPrev, normNext, -miterVec, {1.f, v}, {1.f, v}, {0.0f, v}, trianglesOnJoin, _ctx);
+                addFan<TexCoords>(coordCurr, normPrev, normNext, -miterVec, {1.f, v}, {1.f, v}, {0.0f, v}, trianglesOnJoin, _ctx);
 
                 addPolyLineVertex(coordCurr, normNext, {1.0f, v}, _ctx); // right (outer) corner
                 addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx); // left (inner) corner
@@ -390,18 +547,23 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
     addPolyLineVertex(coordNext, -normNext, {0.f, distance}, _ctx); // left corner
     indexPairs(1, _ctx.numVertices, _ctx.indices);
     if (endCap) {
-        addCap(coordNext, normNext, cornersOnCap, false, _ctx);
+        if (FragmentRounds) {
+            addCapQuad(coordNext, normNext, false, _ctx);
+        } else {
+            addCap<TexCoords>(coordNext, normNext, cornersOnCap, false, _ctx);
+        }
     }
 
 }
 
-void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
+template<bool TexCoords, bool FragmentRounds>
+void buildPolyLineImpl(const Line& _line, PolyLineBuilder& _ctx) {
 
     size_t lineSize = _line.size();
 
     if (_ctx.keepTileEdges) {
 
-        buildPolyLineSegment(_line, _ctx, 0, lineSize);
+        buildPolyLineSegment<TexCoords, FragmentRounds>(_line, _ctx, 0, lineSize);
 
     } else {
 
@@ -416,7 +578,7 @@ void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
                 if (cut == 0) {
                     firstCutEnd = i + 1;
                 }
-                buildPolyLineSegment(_line, _ctx, cut, i + 1);
+                buildPolyLineSegment<TexCoords, FragmentRounds>(_line, _ctx, cut, i + 1);
                 cut = i + 1;
             }
         }
@@ -425,16 +587,74 @@ void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
             if (cut == 0) {
                 // no tile edge cuts!
                 // loop and close the polygon with no endcaps
-                buildPolyLineSegment(_line, _ctx, 0, lineSize+2, false);
+                buildPolyLineSegment<TexCoords, FragmentRounds>(_line, _ctx, 0, lineSize+2, false);
             } else {
                 // merge first and last cut line-segments together
-                buildPolyLineSegment(_line, _ctx, cut, firstCutEnd);
+                buildPolyLineSegment<TexCoords, FragmentRounds>(_line, _ctx, cut, firstCutEnd);
             }
         } else {
-            buildPolyLineSegment(_line, _ctx, cut, lineSize);
+            buildPolyLineSegment<TexCoords, FragmentRounds>(_line, _ctx, cut, lineSize);
         }
 
     }
+}
+
+void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
+
+    size_t lineSize = _line.size();
+
+    // Cached batches store indices relative to an empty context, so the
+    // cache only applies to per-line batched use.
+    bool useCache = t_polyLineCacheActive && _ctx.numVertices == 0 && _ctx.indices.empty();
+    size_t geomHash = 0;
+
+    if (useCache) {
+        // Tessellation depends on the coordinates and the cap, join and
+        // miter parameters only; styles consuming the same geometry share
+        // one batch and differ in how they pack the attributes.
+        geomHash = lineSize;
+        for (auto& p : _line) {
+            hash_combine(geomHash, p.x);
+            hash_combine(geomHash, p.y);
+        }
+        hash_combine(geomHash, static_cast<int>(_ctx.cap));
+        hash_combine(geomHash, static_cast<int>(_ctx.join));
+        hash_combine(geomHash, _ctx.miterLimit);
+        hash_combine(geomHash, _ctx.keepTileEdges);
+        hash_combine(geomHash, _ctx.closedPolygon);
+        hash_combine(geomHash, _ctx.useTexCoords);
+        hash_combine(geomHash, _ctx.fragmentRounds);
+
+        if (auto* batch = t_polyLineCache.find(geomHash)) {
+            _ctx.vertices.insert(_ctx.vertices.end(),
+                                 batch->vertices.begin(), batch->vertices.end());
+            _ctx.indices.insert(_ctx.indices.end(),
+                                batch->indices.begin(), batch->indices.end());
+            _ctx.numVertices += batch->numVertices;
+            return;
+        }
+    }
+
+    if (_ctx.useTexCoords) {
+        if (_ctx.fragmentRounds) {
+            buildPolyLineImpl<true, true>(_line, _ctx);
+        } else {
+            buildPolyLineImpl<true, false>(_line, _ctx);
+        }
+    } else {
+        if (_ctx.fragmentRounds) {
+            buildPolyLineImpl<false, true>(_line, _ctx);
+        } else {
+            buildPolyLineImpl<false, false>(_line, _ctx);
+        }
+    }
+
+    if (useCache) {
+        auto& batch = t_polyLineCache[geomHash];
+        batch.vertices = _ctx.vertices;
+        batch.indices = _ctx.indices;
+        batch.numVertices = _ctx.numVertices;
+    }
 
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "data/tileData.h"
+#include "util/fastmap.h"
 
 #include <functional>
 #include <vector>
@@ -25,52 +26,77 @@ enum class JoinTypes {
 
 JoinTypes JoinTypeFromString(const std::string& str);
 
-/* Callback function for PolygonBuilder:
- *
- * @coord  tesselated output coordinate
- * @normal triangle plane normal
- * @uv     texture coordinate of the output coordinate
- */
-typedef std::function<void(const glm::vec3& coord, const glm::vec3& normal, const glm::vec2& uv)> PolygonVertexFn;
-
 /* PolygonBuilder context,
  * see Builders::buildPolygon() and Builders::buildPolygonExtrusion()
+ *
+ * Like PolyLineBuilder, tesselation output is batched: the builders
+ * fill 'vertices' and the style copies the batch into its typed vertex
+ * buffer in one tight loop, with no std::function call per vertex.
  */
 struct PolygonBuilder {
+
+    /* Tesselated output vertex:
+     *
+     * @coord  tesselated output coordinate
+     * @normal triangle plane normal
+     * @uv     texture coordinate of the output coordinate
+     */
+    struct Vertex {
+        glm::vec3 coord;
+        glm::vec3 normal;
+        glm::vec2 uv;
+    };
+
     std::vector<uint16_t> indices; // indices for drawing the polyon as triangles are added to this vector
+    std::vector<Vertex> vertices;
     std::vector<int> used;
 
-    PolygonVertexFn addVertex;
     size_t numVertices = 0;
     bool useTexCoords;
 
     mapbox::detail::Earcut<uint16_t> earcut;
 
-    PolygonBuilder(PolygonVertexFn _addVertex = [](auto&,auto&,auto&){},
-                   bool _useTexCoords = true)
-        : addVertex(_addVertex), useTexCoords(_useTexCoords){}
+    // Earcut results per polygon geometry hash: identical footprints
+    // repeating within one tile build are triangulated only once.
+    // Cleared by the style's per-tile setup.
+    fastmap_soa<size_t, std::vector<uint16_t>> earcutCache;
+
+    PolygonBuilder(bool _useTexCoords = true)
+        : useTexCoords(_useTexCoords){}
 
     void clear() {
         numVertices = 0;
         indices.clear();
+        vertices.clear();
     }
 };
 
 
-/* Callback function for PolyLineBuilder:
- *
- * @coord   tesselated output coordinate
- * @enormal extrusion vector of the output coordinate
- * @uv      texture coordinate of the output coordinate
- */
-typedef std::function<void(const glm::vec3& coord, const glm::vec2& enormal, const glm::vec2& uv)> PolyLineVertexFn;
-
 /* PolyLineBuilder context,
  * see Builders::buildPolyLine()
+ *
+ * Tesselation output is batched per line: buildPolyLine() fills
+ * 'vertices' for the whole run of coordinates, and the style copies the
+ * batch into its typed vertex buffer in one tight loop. This keeps the
+ * per-vertex work free of std::function calls - the hottest path during
+ * road-network tile builds.
  */
 struct PolyLineBuilder {
+
+    /* Tesselated output vertex:
+     *
+     * @coord   tesselated output coordinate
+     * @enormal extrusion vector of the output coordinate
+     * @uv      texture coordinate of the output coordinate
+     */
+    struct Vertex {
+        glm::vec3 coord;
+        glm::vec2 enormal;
+        glm::vec2 uv;
+    };
+
     std::vector<uint16_t> indices; // indices for drawing the polyline as triangles are added to this vector
-    PolyLineVertexFn addVertex;
+    std::vector<Vertex> vertices;
     size_t numVertices = 0;
     float miterLimit = 3.f;
     CapTypes cap;
@@ -79,15 +105,21 @@ struct PolyLineBuilder {
     bool closedPolygon;
     bool useTexCoords = false;
 
-    PolyLineBuilder(PolyLineVertexFn _addVertex = [](auto&,auto&,auto&){},
-                    CapTypes _cap = CapTypes::butt,
+    // Emit plain quads for caps and joins and let the fragment shader
+    // carve the round outline, instead of tessellating vertex fans; set
+    // by styles using 'rounds: fragment', which also adds the matching
+    // TANGRAM_LINE_FRAGMENT_ROUNDS define (see polyline.fs).
+    bool fragmentRounds = false;
+
+    PolyLineBuilder(CapTypes _cap = CapTypes::butt,
                     JoinTypes _join = JoinTypes::bevel,
                     bool _kte = true, bool _closedPoly = false)
-        : addVertex(_addVertex), cap(_cap), join(_join), keepTileEdges(_kte), closedPolygon(_closedPoly) {}
+        : cap(_cap), join(_join), keepTileEdges(_kte), closedPolygon(_closedPoly) {}
 
     void clear() {
         numVertices = 0;
         indices.clear();
+        vertices.clear();
     }
 };
 
@@ -132,6 +164,16 @@ public:
      */
     static void buildPolyLine(const Line& _line, PolyLineBuilder& _ctx);
 
+    /* Begin/end the per-worker tessellation cache covering one tile
+     * build. While active, buildPolyLine() reuses the vertex batch of a
+     * line already tessellated with the same cap, join and miter
+     * parameters by any style - a casing and a fill style drawing one
+     * roads layer tessellate the shared centerlines only once, and each
+     * style only packs its own attribute stream. end() drops the cached
+     * batches. */
+    static void beginPolyLineCache();
+    static void endPolyLineCache();
+
     /* Build a tesselated quad centered on _screenOrigin
      * @_screenOrigin the sprite origin in screen space
      * @_size the size of the sprite in pixels
@@ -1,4 +1,6 @@
 #include "extrude.h"
+#include "util/stringIntern.h"
+#include "util/variant.h"
 #include <cmath>
 #include <cstdlib>
 
@@ -47,13 +49,15 @@ Extrude parseExtrudeString(const std::string& _str) {
 
 float getLowerExtrudeMeters(const Extrude& _extrude, const Properties& _props) {
 
-    const static std::string key_min_height("min_height");
+    // Interned once; the per-feature lookup is then a scan over key ids
+    const static uint32_t key_min_height = StringIntern::intern("min_height");
 
     double lower = 0;
 
     if (std::isnan(_extrude[0])) {
         // A NAN indicates that the default property should be used for this height
-        _props.getNumber(key_min_height, lower);
+        auto& value = _props.get(key_min_height);
+        if (value.is<double>()) { lower = value.get<double>(); }
     } else {
         lower = _extrude[0];
     }
@@ -64,13 +68,14 @@ float getLowerExtrudeMeters(const Extrude& _extrude, const Properties& _props) {
 
 float getUpperExtrudeMeters(const Extrude& _extrude, const Properties& _props) {
 
-    const static std::string key_height("height");
+    const static uint32_t key_height = StringIntern::intern("height");
 
     double upper = 0;
 
     if (std::isnan(_extrude[1])) {
         // A NAN indicates that the default property should be used for this height
-        _props.getNumber(key_height, upper);
+        auto& value = _props.get(key_height);
+        if (value.is<double>()) { upper = value.get<double>(); }
     } else {
         upper = _extrude[1];
     }
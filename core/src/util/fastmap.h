@@ -68,6 +68,129 @@ struct fastmap {
     void clear() { map.clear(); }
 };
 
+// Structure-of-arrays companion to fastmap: keys live in their own
+// contiguous vector, so the search streams over key-sized elements only
+// and values are touched on a hit. The probe is the branchless
+// lower-bound from the post above - both outcomes of each step are
+// computed and selected, so there is no branch to mispredict. Lookup
+// returns a pointer instead of an iterator; nullptr means not found.
+template<typename K, typename T>
+struct fastmap_soa {
+
+    std::vector<K> keys;
+    std::vector<T> values;
+
+    T& operator[](const K& key) {
+        size_t i = probe(key);
+
+        if (i == keys.size() || keys[i] != key) {
+            keys.emplace(keys.begin() + i, key);
+            values.emplace(values.begin() + i);
+        }
+        return values[i];
+    }
+
+    T* find(const K& key) {
+        size_t i = probe(key);
+
+        if (i == keys.size() || keys[i] != key) {
+            return nullptr;
+        }
+        return &values[i];
+    }
+
+    const T* find(const K& key) const {
+        return const_cast<fastmap_soa*>(this)->find(key);
+    }
+
+    size_t size() const { return keys.size(); }
+
+    void clear() {
+        keys.clear();
+        values.clear();
+    }
+
+private:
+    size_t probe(const K& key) const {
+        size_t low = 0;
+        size_t n = keys.size();
+
+        while (n > 0) {
+            size_t half = n / 2;
+            size_t middle = low + half;
+            size_t upper = low + n - half;
+            n = half;
+            low = (keys[middle] < key) ? upper : low;
+        }
+        return low;
+    }
+};
+
+// String keys are probed by hash: the hashes sit in one contiguous
+// vector for the branchless search and the strings are only compared
+// once a hash matches. Entries sharing a hash are adjacent, so the
+// (rare) collision run is resolved by a short forward scan.
+template<typename T>
+struct fastmap_soa<std::string, T> {
+
+    std::vector<size_t> hashes;
+    std::vector<std::string> keys;
+    std::vector<T> values;
+
+    T& operator[](const std::string& key) {
+        size_t hash = std::hash<std::string>()(key);
+        size_t i = probe(hash);
+
+        while (i < hashes.size() && hashes[i] == hash && keys[i] != key) { i++; }
+
+        if (i == hashes.size() || hashes[i] != hash) {
+            hashes.emplace(hashes.begin() + i, hash);
+            keys.emplace(keys.begin() + i, key);
+            values.emplace(values.begin() + i);
+        }
+        return values[i];
+    }
+
+    T* find(const std::string& key) {
+        size_t hash = std::hash<std::string>()(key);
+        size_t i = probe(hash);
+
+        while (i < hashes.size() && hashes[i] == hash && keys[i] != key) { i++; }
+
+        if (i == hashes.size() || hashes[i] != hash) {
+            return nullptr;
+        }
+        return &values[i];
+    }
+
+    const T* find(const std::string& key) const {
+        return const_cast<fastmap_soa*>(this)->find(key);
+    }
+
+    size_t size() const { return hashes.size(); }
+
+    void clear() {
+        hashes.clear();
+        keys.clear();
+        values.clear();
+    }
+
+private:
+    size_t probe(size_t hash) const {
+        size_t low = 0;
+        size_t n = hashes.size();
+
+        while (n > 0) {
+            size_t half = n / 2;
+            size_t middle = low + half;
+            size_t upper = low + n - half;
+            n = half;
+            low = (hashes[middle] < hash) ? upper : low;
+        }
+        return low;
+    }
+};
+
 template<typename T>
 struct fastmap<std::string, T> {
 
@@ -0,0 +1,69 @@
+#include "util/frameScheduler.h"
+
+#include "platform.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+namespace Tangram {
+
+namespace FrameScheduler {
+
+namespace {
+
+std::mutex s_mutex;
+
+// Whether a wakeup was sent to the platform since the last frame began
+bool s_framePending = false;
+
+// Deadline of the earliest requested frame, in clockSeconds()
+double s_deadline = 0.;
+
+double clockSeconds() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+void requestFrame(double _delaySeconds) {
+
+    double deadline = clockSeconds() + _delaySeconds;
+
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        if (s_framePending && deadline >= s_deadline) {
+            // A wakeup is already on its way and the frame it triggers
+            // comes early enough - coalesce
+            return;
+        }
+
+        s_deadline = s_framePending ? std::min(s_deadline, deadline) : deadline;
+        s_framePending = true;
+    }
+
+    // Platforms that cannot schedule by deadline draw right away; the
+    // request is never later than before the scheduler
+    requestRender();
+}
+
+void requestFrame() {
+    requestFrame(0.);
+}
+
+void frameBegins() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_framePending = false;
+}
+
+double nextFrameDelay() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!s_framePending) { return -1.; }
+    return std::max(s_deadline - clockSeconds(), 0.);
+}
+
+}
+
+}
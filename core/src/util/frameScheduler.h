@@ -0,0 +1,34 @@
+#pragma once
+
+namespace Tangram {
+
+/* Coalesces render requests into platform wakeups.
+ *
+ * Tile callbacks, label fades and eases each ask for a redraw on their
+ * own; a burst of tile completions would wake the platform once per
+ * tile. The scheduler forwards the first request to requestRender() and
+ * swallows the rest until the next frame begins, and keeps the deadline
+ * of the earliest requested frame so platforms can align their wakeup
+ * with it instead of drawing immediately.
+ */
+namespace FrameScheduler {
+
+/* Request a frame as soon as possible. Wakes the platform through
+ * requestRender() unless a wakeup is already on its way. */
+void requestFrame();
+
+/* Request a frame no later than _delaySeconds from now. Used by pure
+ * fade animations to run at a reduced rate instead of every vsync. */
+void requestFrame(double _delaySeconds);
+
+/* Marks the begin of a frame; the next request wakes the platform
+ * again. Called from Map::render(). */
+void frameBegins();
+
+/* Seconds until the earliest requested frame - 0 when a frame is due
+ * now, negative when no frame is requested at all. */
+double nextFrameDelay();
+
+}
+
+}
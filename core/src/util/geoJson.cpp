@@ -2,8 +2,14 @@
 
 #include "data/propertyItem.h"
 #include "glm/glm.hpp"
+#include "util/taskExecutor.h"
 #include "log.h"
 
+#include "rapidjson/encodedstream.h"
+#include "rapidjson/error/en.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/reader.h"
+
 namespace Tangram {
 
 bool GeoJson::isFeatureCollection(const JsonValue& _in) {
@@ -72,6 +78,7 @@ Properties GeoJson::getProperties(const JsonValue& _in, int32_t _sourceId) {
     properties.sourceId = _sourceId;
     properties.setSorted(std::move(items));
     properties.sort();
+    properties.compact();
 
     return properties;
 
@@ -145,12 +152,348 @@ Layer GeoJson::getLayer(const JsonValue& _in, const Transform& _proj, int32_t _s
         return layer;
     }
 
-    for (auto featureIt = features->value.Begin(); featureIt != features->value.End(); ++featureIt) {
-        layer.features.push_back(getFeature(*featureIt, _proj, _sourceId));
-    }
+    // Feature conversion only reads the document, so large layers are
+    // converted in parallel ranges writing to disjoint slots.
+    const auto& array = features->value;
+    size_t count = array.Size();
+
+    layer.features.resize(count);
+
+    TaskExecutor::shared().forRanges(count, 256, [&](size_t _begin, size_t _end) {
+        for (size_t i = _begin; i < _end; i++) {
+            layer.features[i] = getFeature(array[rapidjson::SizeType(i)], _proj, _sourceId);
+        }
+    });
 
     return layer;
 
 }
 
+namespace {
+
+/* SAX handler that assembles Features as tokens arrive.
+ *
+ * Mirrors the structure handled by getLayer/getFeature: the document is
+ * either a FeatureCollection or an object of named FeatureCollections.
+ * Coordinate arrays are accumulated bottom-up (numbers -> points ->
+ * lines -> polygons) and assembled according to the geometry type once
+ * the feature object closes, since member order within "geometry" is
+ * not guaranteed. Unrecognized subtrees are skipped by depth counting.
+ */
+struct FeatureCollectionHandler
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, FeatureCollectionHandler> {
+
+    enum State {
+        root,        // before the document object
+        document,    // inside the root object
+        layerObject, // inside a named object that may be a FeatureCollection
+        features,    // inside a "features" array
+        feature,     // inside a feature object
+        properties,  // inside a "properties" object
+        geometry,    // inside a "geometry" object
+        coordinates, // inside "coordinates" arrays
+        skip,        // unrecognized subtree
+    };
+
+    FeatureCollectionHandler(const GeoJson::Transform& _proj, int32_t _sourceId, TileData& _data)
+        : m_proj(_proj), m_sourceId(_sourceId), m_data(_data) {}
+
+    const GeoJson::Transform& m_proj;
+    int32_t m_sourceId;
+    TileData& m_data;
+
+    std::vector<State> m_state{root};
+    int m_skipDepth = 0;
+
+    std::string m_key;
+
+    Layer m_layer{""};
+    bool m_layerHasFeatures = false;
+
+    Feature m_feature;
+    std::vector<PropertyItem> m_items;
+    std::string m_geometryType;
+
+    // Bottom-up coordinate accumulation
+    double m_coord[2] = { 0, 0 };
+    int m_coordNum = 0;
+    int m_arrayDepth = 0;
+    enum { closedNone, closedPoint, closedLine, closedPolygon } m_lastClosed = closedNone;
+    Line m_curLine;
+    std::vector<Line> m_curLines;
+    std::vector<Polygon> m_curPolygons;
+
+    State state() const { return m_state.back(); }
+
+    void beginSkip() {
+        m_state.push_back(skip);
+        m_skipDepth = 1;
+    }
+
+    bool Key(const char* _str, rapidjson::SizeType _len, bool) {
+        if (state() != skip) { m_key.assign(_str, _len); }
+        return true;
+    }
+
+    bool StartObject() {
+        switch (state()) {
+        case root:
+            m_state.push_back(document);
+            break;
+        case document:
+            // A named member object; treated as a layer if it turns out
+            // to contain a "features" array.
+            m_layer = Layer(m_key);
+            m_layerHasFeatures = false;
+            m_state.push_back(layerObject);
+            break;
+        case features:
+            m_feature = Feature();
+            m_items.clear();
+            m_geometryType.clear();
+            resetCoordinates();
+            m_state.push_back(feature);
+            break;
+        case feature:
+            if (m_key == "properties") {
+                m_items.clear();
+                m_state.push_back(properties);
+            } else if (m_key == "geometry") {
+                m_state.push_back(geometry);
+            } else {
+                beginSkip();
+            }
+            break;
+        case skip:
+            m_skipDepth++;
+            break;
+        default:
+            beginSkip();
+            break;
+        }
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        switch (state()) {
+        case skip:
+            if (--m_skipDepth == 0) { m_state.pop_back(); }
+            return true;
+        case feature:
+            finishFeature();
+            break;
+        case properties: {
+            Properties props;
+            props.sourceId = m_sourceId;
+            props.setSorted(std::move(m_items));
+            props.sort();
+            props.compact();
+            m_feature.props = std::move(props);
+            m_items.clear();
+            break;
+        }
+        case layerObject:
+            if (m_layerHasFeatures) {
+                m_data.layers.push_back(std::move(m_layer));
+            }
+            break;
+        default:
+            break;
+        }
+        m_state.pop_back();
+        return true;
+    }
+
+    bool StartArray() {
+        switch (state()) {
+        case document:
+            if (m_key == "features") {
+                // The root object is itself a FeatureCollection.
+                m_layer = Layer("");
+                m_layerHasFeatures = true;
+                m_state.push_back(features);
+            } else {
+                beginSkip();
+            }
+            break;
+        case layerObject:
+            if (m_key == "features") {
+                m_layerHasFeatures = true;
+                m_state.push_back(features);
+            } else {
+                beginSkip();
+            }
+            break;
+        case geometry:
+            if (m_key == "coordinates") {
+                resetCoordinates();
+                m_arrayDepth = 1;
+                m_state.push_back(coordinates);
+            } else {
+                beginSkip();
+            }
+            break;
+        case coordinates:
+            m_arrayDepth++;
+            break;
+        case skip:
+            m_skipDepth++;
+            break;
+        default:
+            beginSkip();
+            break;
+        }
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        switch (state()) {
+        case skip:
+            if (--m_skipDepth == 0) { m_state.pop_back(); }
+            break;
+        case features:
+            m_state.pop_back();
+            break;
+        case coordinates:
+            m_arrayDepth--;
+            if (m_coordNum > 0) {
+                // This array held the components of one point.
+                m_curLine.push_back(m_proj(glm::dvec2(m_coord[0], m_coord[1])));
+                m_coordNum = 0;
+                m_lastClosed = closedPoint;
+            } else if (m_arrayDepth > 0) {
+                // Fold completed points into lines and lines into
+                // polygons; the outermost array is left unfolded and
+                // assembled by geometry type in finishFeature.
+                if (m_lastClosed == closedPoint) {
+                    m_curLines.push_back(std::move(m_curLine));
+                    m_curLine = Line();
+                    m_lastClosed = closedLine;
+                } else if (m_lastClosed == closedLine) {
+                    Polygon polygon;
+                    for (auto& line : m_curLines) {
+                        polygon.push_back(std::move(line));
+                    }
+                    m_curLines.clear();
+                    m_curPolygons.push_back(std::move(polygon));
+                    m_lastClosed = closedPolygon;
+                }
+            }
+            if (m_arrayDepth == 0) { m_state.pop_back(); }
+            break;
+        default:
+            m_state.pop_back();
+            break;
+        }
+        return true;
+    }
+
+    bool String(const char* _str, rapidjson::SizeType _len, bool) {
+        if (state() == properties) {
+            m_items.emplace_back(m_key, std::string(_str, _len));
+        } else if (state() == geometry && m_key == "type") {
+            m_geometryType.assign(_str, _len);
+        }
+        return true;
+    }
+
+    bool Double(double _val) { return number(_val); }
+    bool Int(int _val) { return number(_val); }
+    bool Uint(unsigned _val) { return number(_val); }
+    bool Int64(int64_t _val) { return number(double(_val)); }
+    bool Uint64(uint64_t _val) { return number(double(_val)); }
+
+    bool Default() { return true; }
+
+private:
+
+    bool number(double _val) {
+        if (state() == coordinates) {
+            if (m_coordNum < 2) { m_coord[m_coordNum] = _val; }
+            m_coordNum++;
+        } else if (state() == properties) {
+            m_items.emplace_back(m_key, _val);
+        }
+        return true;
+    }
+
+    void resetCoordinates() {
+        m_coordNum = 0;
+        m_arrayDepth = 0;
+        m_lastClosed = closedNone;
+        m_curLine.clear();
+        m_curLines.clear();
+        m_curPolygons.clear();
+    }
+
+    void finishFeature() {
+
+        if (m_geometryType == "Point" || m_geometryType == "MultiPoint") {
+
+            m_feature.geometryType = GeometryType::points;
+            m_feature.points.insert(m_feature.points.begin(),
+                                    m_curLine.begin(), m_curLine.end());
+
+        } else if (m_geometryType == "LineString") {
+
+            m_feature.geometryType = GeometryType::lines;
+            m_feature.lines.push_back(std::move(m_curLine));
+
+        } else if (m_geometryType == "MultiLineString") {
+
+            m_feature.geometryType = GeometryType::lines;
+            for (auto& line : m_curLines) {
+                m_feature.lines.push_back(std::move(line));
+            }
+
+        } else if (m_geometryType == "Polygon") {
+
+            m_feature.geometryType = GeometryType::polygons;
+            Polygon polygon;
+            for (auto& line : m_curLines) {
+                polygon.push_back(std::move(line));
+            }
+            m_feature.polygons.push_back(std::move(polygon));
+
+        } else if (m_geometryType == "MultiPolygon") {
+
+            m_feature.geometryType = GeometryType::polygons;
+            for (auto& polygon : m_curPolygons) {
+                m_feature.polygons.push_back(std::move(polygon));
+            }
+        }
+
+        m_feature.props.sourceId = m_sourceId;
+        m_layer.features.push_back(std::move(m_feature));
+        m_feature = Feature();
+        resetCoordinates();
+    }
+};
+
+}
+
+bool GeoJson::parseLayers(const char* _bytes, size_t _length, const Transform& _proj,
+                          int32_t _sourceId, TileData& _data,
+                          const char** _error, size_t* _errorOffset) {
+
+    FeatureCollectionHandler handler(_proj, _sourceId, _data);
+
+    rapidjson::Reader reader;
+    rapidjson::MemoryStream mstream(_bytes, _length);
+    rapidjson::EncodedInputStream<rapidjson::UTF8<char>, rapidjson::MemoryStream> istream(mstream);
+
+    auto result = reader.Parse(istream, handler);
+
+    *_error = nullptr;
+    *_errorOffset = 0;
+
+    if (result.IsError()) {
+        *_error = rapidjson::GetParseError_En(result.Code());
+        *_errorOffset = result.Offset();
+        return false;
+    }
+
+    return true;
+}
+
 }
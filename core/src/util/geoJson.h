@@ -2,14 +2,15 @@
 
 #include "data/tileData.h"
 #include "util/json.h"
-
-#include <functional>
+#include "util/mapProjection.h"
 
 namespace Tangram {
 
 namespace GeoJson {
 
-using Transform = std::function<Point(glm::dvec2 _lonLat)>;
+/* Concrete per-tile transform: one tile-origin/scale setup in double,
+ * float results, and no per-point std::function indirection. */
+using Transform = TileTransform;
 
 bool isFeatureCollection(const JsonValue& _in);
 
@@ -25,6 +26,18 @@ Feature getFeature(const JsonValue& _in, const Transform& _proj, int32_t _source
 
 Layer getLayer(const JsonValue& _in, const Transform& _proj, int32_t _sourceId);
 
+/* Stream-parse GeoJSON directly into _data.
+ *
+ * Features are emitted as tokens arrive, so no DOM is built and peak
+ * memory stays at roughly the size of one feature. Accepts either a
+ * FeatureCollection or an object mapping layer names to
+ * FeatureCollections, like getLayer. Returns false on malformed input
+ * and reports the parse error through _error and _errorOffset.
+ */
+bool parseLayers(const char* _bytes, size_t _length, const Transform& _proj,
+                 int32_t _sourceId, TileData& _data,
+                 const char** _error, size_t* _errorOffset);
+
 }
 
 }
@@ -1,5 +1,6 @@
 #include "geom.h"
 
+#include <algorithm>
 #include <limits>
 #include <cmath>
 #include "glm/gtx/norm.hpp"
@@ -101,27 +102,6 @@ glm::vec2 worldToScreenSpace(const glm::mat4& _mvp, const glm::vec4& _worldPosit
     return clipToScreenSpace(clipCoords, _screenSize);
 }
 
-glm::vec2 centroid(const std::vector<std::vector<glm::vec3>>& _polygon) {
-    glm::vec2 centroid;
-    int n = 0;
-
-    for (auto& l : _polygon) {
-        for (auto& p : l) {
-            centroid.x += p.x;
-            centroid.y += p.y;
-            n++;
-        }
-    }
-
-    if (n == 0) {
-        return centroid;
-    }
-
-    centroid /= n;
-
-    return centroid;
-}
-
 // square distance from a point <_p> to a segment <_p1,_p2>
 // http://stackoverflow.com/questions/849211/shortest-distance-between-a-point-and-a-line-segment
 //
@@ -142,6 +122,80 @@ float sqSegmentDistance(const glm::vec2& _p, const glm::vec2& _p1, const glm::ve
     return glm::length2(_p - _p1);
 }
 
+void sqSegmentDistances(const glm::vec2* _points, size_t _count,
+                        const glm::vec2& _a, const glm::vec2& _b, float* _out) {
+
+    float dx = _b.x - _a.x;
+    float dy = _b.y - _a.y;
+
+    float lengthSq = dx * dx + dy * dy;
+    float inv = (lengthSq != 0.f) ? 1.f / lengthSq : 0.f;
+
+    for (size_t i = 0; i < _count; i++) {
+        float px = _points[i].x - _a.x;
+        float py = _points[i].y - _a.y;
+
+        // Clamping the projection parameter covers the before-start,
+        // on-segment and past-end cases without branches
+        float t = (px * dx + py * dy) * inv;
+        t = t < 0.f ? 0.f : (t > 1.f ? 1.f : t);
+
+        float ex = px - dx * t;
+        float ey = py - dy * t;
+
+        _out[i] = ex * ex + ey * ey;
+    }
+}
+
+void sqPointSegmentDistances(const glm::vec2* _points, const glm::vec2& _a,
+                             const glm::vec2* _ends, size_t _count, float* _out) {
+
+    for (size_t i = 0; i < _count; i++) {
+        float dx = _ends[i].x - _a.x;
+        float dy = _ends[i].y - _a.y;
+
+        float lengthSq = dx * dx + dy * dy;
+        float inv = (lengthSq != 0.f) ? 1.f / lengthSq : 0.f;
+
+        float px = _points[i].x - _a.x;
+        float py = _points[i].y - _a.y;
+
+        float t = (px * dx + py * dy) * inv;
+        t = t < 0.f ? 0.f : (t > 1.f ? 1.f : t);
+
+        float ex = px - dx * t;
+        float ey = py - dy * t;
+
+        _out[i] = ex * ex + ey * ey;
+    }
+}
+
+size_t maxSqSegmentDistance(const glm::vec2* _points, size_t _count,
+                            const glm::vec2& _a, const glm::vec2& _b, float& _maxSqDist) {
+
+    constexpr size_t block = 32;
+    float dist[block];
+
+    float maxSq = 0.f;
+    size_t maxIndex = 0;
+
+    for (size_t start = 0; start < _count; start += block) {
+        size_t n = std::min(block, _count - start);
+
+        sqSegmentDistances(_points + start, n, _a, _b, dist);
+
+        for (size_t i = 0; i < n; i++) {
+            if (dist[i] > maxSq) {
+                maxSq = dist[i];
+                maxIndex = start + i;
+            }
+        }
+    }
+
+    _maxSqDist = maxSq;
+    return maxIndex;
+}
+
 bool isPowerOfTwo(int _value) {
     return (_value & (_value - 1)) == 0;
 }
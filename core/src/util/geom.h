@@ -1,6 +1,7 @@
 #pragma once
 
 #include "glm/glm.hpp"
+#include <utility>
 #include <vector>
 
 #ifndef PI
@@ -107,7 +108,27 @@ glm::vec2 worldToScreenSpace(const glm::mat4& _mvp, const glm::vec4& _worldPosit
 glm::vec2 worldToScreenSpace(const glm::mat4& _mvp, const glm::vec4& _worldPosition, const glm::vec2& _screenSize, bool& _clipped);
 
 /* Computes the geometric center of the two dimentionnal region defined by the polygon */
-glm::vec2 centroid(const std::vector<std::vector<glm::vec3>>& _polygon);
+template<typename Polygon>
+glm::vec2 centroid(const Polygon& _polygon) {
+    glm::vec2 centroid;
+    int n = 0;
+
+    for (auto& l : _polygon) {
+        for (auto& p : l) {
+            centroid.x += p.x;
+            centroid.y += p.y;
+            n++;
+        }
+    }
+
+    if (n == 0) {
+        return centroid;
+    }
+
+    centroid /= n;
+
+    return centroid;
+}
 
 inline glm::vec2 rotateBy(const glm::vec2& _in, const glm::vec2& _normal) {
     return {
@@ -123,4 +144,165 @@ bool isPowerOfTwo(int _value);
 float sqPointSegmentDistance(const glm::vec2& _p, const glm::vec2& _a, const glm::vec2& _b);
 float pointSegmentDistance(const glm::vec2& _p, const glm::vec2& _a, const glm::vec2& _b);
 
+/* Batch of sqSegmentDistance: writes the squared distance of each of the
+ * _count points at _points to the segment (_a, _b) into _out. The loop
+ * body is branchless so the compiler vectorizes the span; use this for
+ * Douglas-Peucker style scans over long lines instead of the per-point
+ * call. */
+void sqSegmentDistances(const glm::vec2* _points, size_t _count,
+                        const glm::vec2& _a, const glm::vec2& _b, float* _out);
+
+/* Batch of sqPointSegmentDistance over a fan of segments sharing the
+ * origin _a: writes the squared distance of _points[i] to the segment
+ * (_a, _ends[i]) into _out. Matches the segment-merge scan of line label
+ * placement, where candidate end points extend from one start point. */
+void sqPointSegmentDistances(const glm::vec2* _points, const glm::vec2& _a,
+                             const glm::vec2* _ends, size_t _count, float* _out);
+
+/* Index of the point of _points farthest from the segment (_a, _b), with
+ * its squared distance in _maxSqDist. Evaluates sqSegmentDistances() in
+ * stack-sized blocks; _count must be at least one. */
+size_t maxSqSegmentDistance(const glm::vec2* _points, size_t _count,
+                            const glm::vec2& _a, const glm::vec2& _b, float& _maxSqDist);
+
+/* Simplifies a line in place with the Douglas-Peucker algorithm, dropping
+ * points that are closer than _tolerance to the simplified line. The first
+ * and last point are always kept. */
+template<typename Line>
+void simplifyLine(Line& _line, float _tolerance) {
+
+    size_t n = _line.size();
+    if (n < 3) { return; }
+
+    float sqTolerance = _tolerance * _tolerance;
+
+    // A packed copy feeds the distance scans through the batch kernel
+    std::vector<glm::vec2> points;
+    points.reserve(n);
+    for (auto& p : _line) { points.emplace_back(p.x, p.y); }
+
+    std::vector<char> keep(n, 0);
+    keep[0] = 1;
+    keep[n - 1] = 1;
+
+    std::vector<std::pair<size_t, size_t>> stack;
+    stack.emplace_back(0, n - 1);
+
+    while (!stack.empty()) {
+        size_t first = stack.back().first;
+        size_t last = stack.back().second;
+        stack.pop_back();
+
+        float maxSqDist = 0;
+        size_t index = first + 1 + maxSqSegmentDistance(&points[first + 1], last - first - 1,
+                                                        points[first], points[last], maxSqDist);
+
+        if (maxSqDist > sqTolerance) {
+            keep[index] = 1;
+            if (index - first > 1) { stack.emplace_back(first, index); }
+            if (last - index > 1) { stack.emplace_back(index, last); }
+        }
+    }
+
+    size_t out = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (keep[i]) { _line[out++] = _line[i]; }
+    }
+    _line.erase(_line.begin() + out, _line.end());
+}
+
+/* Clips a line to the square [_min, _max] in x and y, appending the
+ * resulting pieces to _out. Segments are clipped with Liang-Barsky; the
+ * z coordinate is interpolated along with the position. */
+template<typename Line, typename Lines>
+void clipLine(const Line& _line, float _min, float _max, Lines& _out) {
+
+    auto clipSegment = [&](glm::vec3 a, glm::vec3 b, glm::vec3& _a, glm::vec3& _b) {
+        float t0 = 0.f, t1 = 1.f;
+        glm::vec3 d = b - a;
+        float p[4] = { -d.x, d.x, -d.y, d.y };
+        float q[4] = { a.x - _min, _max - a.x, a.y - _min, _max - a.y };
+
+        for (int i = 0; i < 4; i++) {
+            if (p[i] == 0.f) {
+                if (q[i] < 0.f) { return false; }
+            } else {
+                float r = q[i] / p[i];
+                if (p[i] < 0.f) {
+                    if (r > t1) { return false; }
+                    if (r > t0) { t0 = r; }
+                } else {
+                    if (r < t0) { return false; }
+                    if (r < t1) { t1 = r; }
+                }
+            }
+        }
+        _a = a + d * t0;
+        _b = a + d * t1;
+        return true;
+    };
+
+    typename Lines::value_type current(_out.get_allocator());
+
+    for (size_t i = 1; i < _line.size(); i++) {
+        glm::vec3 a, b;
+        if (!clipSegment(glm::vec3(_line[i-1]), glm::vec3(_line[i]), a, b)) {
+            if (current.size() > 1) { _out.push_back(std::move(current)); }
+            current = typename Lines::value_type(_out.get_allocator());
+            continue;
+        }
+        if (current.empty()) { current.push_back(a); }
+        current.push_back(b);
+
+        // A segment leaving the square ends the current piece
+        if (b != glm::vec3(_line[i])) {
+            _out.push_back(std::move(current));
+            current = typename Lines::value_type(_out.get_allocator());
+        }
+    }
+    if (current.size() > 1) { _out.push_back(std::move(current)); }
+}
+
+/* Clips a polygon ring in place to the square [_min, _max] in x and y
+ * with the Sutherland-Hodgman algorithm, one box edge per pass. The ring
+ * comes out empty when it lies entirely outside the square. */
+template<typename Line>
+void clipPolygonRing(Line& _ring, float _min, float _max) {
+
+    bool closed = _ring.size() > 1 && _ring.front() == _ring.back();
+
+    std::vector<glm::vec3> in(_ring.begin(), _ring.end() - (closed ? 1 : 0));
+    std::vector<glm::vec3> out;
+
+    for (int edge = 0; edge < 4; edge++) {
+        int axis = edge >> 1;
+        float bound = (edge & 1) ? _max : _min;
+        float sign = (edge & 1) ? -1.f : 1.f;
+
+        out.clear();
+        size_t n = in.size();
+        for (size_t i = 0; i < n; i++) {
+            const glm::vec3& curr = in[i];
+            const glm::vec3& prev = in[(i + n - 1) % n];
+            bool currIn = sign * (curr[axis] - bound) >= 0.f;
+            bool prevIn = sign * (prev[axis] - bound) >= 0.f;
+
+            if (currIn != prevIn) {
+                float t = (bound - prev[axis]) / (curr[axis] - prev[axis]);
+                out.push_back(prev + (curr - prev) * t);
+            }
+            if (currIn) { out.push_back(curr); }
+        }
+        std::swap(in, out);
+
+        if (in.size() < 3) {
+            _ring.clear();
+            return;
+        }
+    }
+
+    _ring.assign(in.begin(), in.end());
+    if (closed) { _ring.push_back(_ring.front()); }
+}
+
 }
@@ -3,6 +3,7 @@
 #include "glm/vec2.hpp"
 #include "glm/gtx/rotate_vector.hpp"
 #include "platform.h"
+#include "util/frameScheduler.h"
 #include <cmath>
 
 // Damping factor for translation; reciprocal of the decay period in seconds
@@ -23,12 +24,43 @@
 // Minimum zoom at which momentum should stop (zoom levels per second)
 #define THRESHOLD_STOP_ZOOM 0.3f
 
+// Seconds without pan events after which pan extrapolation stops
+#define PAN_TRACKING_TIMEOUT 0.1f
+
+// Exponential smoothing factor for the tracked pan velocity
+#define PAN_VELOCITY_SMOOTHING 0.5f
+
+// Upper bound on how far ahead a pan is extrapolated (seconds)
+#define PAN_PREDICTION_MAX 0.05f
+
 namespace Tangram {
 
 InputHandler::InputHandler(View& _view) : m_view(_view) {}
 
 void InputHandler::update(float _dt) {
 
+    if (m_panTracking) {
+        float sincePan = std::chrono::duration<float>(Clock::now() - m_lastPanTime).count();
+
+        if (sincePan > PAN_TRACKING_TIMEOUT) {
+            // The finger stopped or lifted; undo the lead so the view
+            // rests where the last event put it
+            stopPanPrediction();
+        } else {
+            // Extrapolate the pan to the expected present time of this
+            // frame, one frame ahead, correcting for the displacement
+            // already applied by previous frames
+            float lead = std::min(sincePan + _dt, PAN_PREDICTION_MAX);
+            glm::vec2 predicted = m_panVelocity * lead;
+
+            m_view.translate(predicted.x - m_appliedPrediction.x,
+                             predicted.y - m_appliedPrediction.y);
+            m_appliedPrediction = predicted;
+
+            FrameScheduler::requestFrame();
+        }
+    }
+
     auto velocityPanPixels = m_view.pixelsPerMeter() / m_view.pixelScale() * m_velocityPan;
 
     bool isFlinging = glm::length(velocityPanPixels) > THRESHOLD_STOP_PAN ||
@@ -42,7 +74,7 @@ void InputHandler::update(float _dt) {
         m_velocityZoom -= _dt * DAMPING_ZOOM * m_velocityZoom;
         m_view.zoom(m_velocityZoom * _dt);
 
-        requestRender();
+        FrameScheduler::requestFrame();
     }
 }
 
@@ -68,6 +100,11 @@ void InputHandler::handleDoubleTapGesture(float _posX, float _posY) {
 
 void InputHandler::handlePanGesture(float _startX, float _startY, float _endX, float _endY) {
 
+    auto now = Clock::now();
+    float elapsed = std::chrono::duration<float>(now - m_lastPanTime).count();
+
+    // Rolls back any extrapolation applied ahead of this event, the
+    // delivered positions are authoritative
     onGesture();
 
     m_view.screenToGroundPlane(_startX, _startY);
@@ -76,6 +113,15 @@ void InputHandler::handlePanGesture(float _startX, float _startY, float _endX, f
     float dx = _startX - _endX;
     float dy = _startY - _endY;
 
+    if (elapsed > 0.f && elapsed < PAN_TRACKING_TIMEOUT) {
+        glm::vec2 velocity = glm::vec2(dx, dy) / elapsed;
+        m_panVelocity += (velocity - m_panVelocity) * PAN_VELOCITY_SMOOTHING;
+    } else {
+        m_panVelocity = { 0.f, 0.f };
+    }
+    m_lastPanTime = now;
+    m_panTracking = true;
+
     m_view.translate(dx, dy);
 
 }
@@ -161,8 +207,19 @@ void InputHandler::cancelFling() {
 void InputHandler::onGesture() {
 
     setVelocity(0.f, { 0.f, 0.f });
-    requestRender();
+    stopPanPrediction();
+    FrameScheduler::requestFrame();
+
+}
 
+void InputHandler::stopPanPrediction() {
+
+    m_panTracking = false;
+
+    if (m_appliedPrediction.x != 0.f || m_appliedPrediction.y != 0.f) {
+        m_view.translate(-m_appliedPrediction.x, -m_appliedPrediction.y);
+        m_appliedPrediction = { 0.f, 0.f };
+    }
 }
 
 void InputHandler::setVelocity(float _zoom, glm::vec2 _translate) {
@@ -1,8 +1,9 @@
 #pragma once
 
 #include "view/view.h"
-#include <memory>
 #include <bitset>
+#include <chrono>
+#include <memory>
 
 namespace Tangram {
 
@@ -27,16 +28,32 @@ public:
 
 private:
 
+    using Clock = std::chrono::steady_clock;
+
     void setVelocity(float _zoom, glm::vec2 _pan);
 
     void onGesture();
 
+    /* Stop pan extrapolation and roll back the displacement applied ahead
+     * of the last real pan event */
+    void stopPanPrediction();
+
     View& m_view;
 
     // fling deltas on zoom and translation
     glm::vec2 m_velocityPan;
     float m_velocityZoom = 0.f;
 
+    // Pan events are timestamped on arrival and the tracked velocity is
+    // extrapolated to the expected present time of each frame, so the
+    // rendered position does not trail the finger by the event-queue and
+    // frame delay. The displacement applied ahead of the real input is
+    // remembered and corrected once the next event or timeout arrives.
+    Clock::time_point m_lastPanTime;
+    glm::vec2 m_panVelocity = { 0.f, 0.f };
+    glm::vec2 m_appliedPrediction = { 0.f, 0.f };
+    bool m_panTracking = false;
+
 };
 
 }
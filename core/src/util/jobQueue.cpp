@@ -1,10 +1,13 @@
 #include "jobQueue.h"
 
+#include <chrono>
+#include <iterator>
+
 namespace Tangram {
 
 JobQueue::~JobQueue() {
 
-    if (!m_jobs.empty()) {
+    if (!m_jobs.empty() || !m_priorityJobs.empty()) {
         runJobs();
     }
 
@@ -17,17 +20,64 @@ void JobQueue::add(Job job) {
 
 }
 
+void JobQueue::addPriority(Job job) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_priorityJobs.push_back(job);
+
+}
+
 void JobQueue::runJobs() {
 
-    for (size_t i = 0; i < m_jobs.size(); i++) {
-        Job job;
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            job.swap(m_jobs[i]);
-        }
+    drain(-1);
+
+}
+
+void JobQueue::runJobs(int64_t budgetUs) {
+
+    drain(budgetUs);
+
+}
+
+void JobQueue::drain(int64_t budgetUs) {
+
+    std::vector<Job> priorityJobs;
+    std::vector<Job> jobs;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        priorityJobs.swap(m_priorityJobs);
+        jobs.swap(m_jobs);
+    }
+
+    // The priority lane always runs in full.
+    for (auto& job : priorityJobs) {
         job();
     }
-    m_jobs.clear();
+
+    auto start = std::chrono::steady_clock::now();
+
+    size_t i = 0;
+    for (; i < jobs.size(); i++) {
+        jobs[i]();
+
+        if (budgetUs >= 0 && i + 1 < jobs.size()) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+            if (elapsed >= budgetUs) {
+                i++;
+                break;
+            }
+        }
+    }
+
+    if (i < jobs.size()) {
+        // Put the deferred remainder back ahead of jobs added while
+        // draining, preserving the order they were queued in.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.insert(m_jobs.begin(),
+                      std::make_move_iterator(jobs.begin() + i),
+                      std::make_move_iterator(jobs.end()));
+    }
 
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <mutex>
 #include <vector>
@@ -22,12 +23,24 @@ public:
     // Put a job on the queue. This is thread-safe.
     void add(Job job);
 
+    // Put a job on the priority lane; priority jobs gate rendering correctness, so every drain
+    // runs them first and in full, regardless of any time budget. This is thread-safe.
+    void addPriority(Job job);
+
     // Run all jobs on the queue in the order they were added, then remove them. This is thread-safe.
     void runJobs();
 
+    // Run the priority lane in full, then further jobs only until the given budget has elapsed;
+    // jobs over budget stay queued for the next drain, so long cleanup bursts amortize across
+    // frames instead of spiking one. At least one queued job runs per call. This is thread-safe.
+    void runJobs(int64_t budgetUs);
+
 private:
 
+    void drain(int64_t budgetUs);
+
     std::vector<Job> m_jobs;
+    std::vector<Job> m_priorityJobs;
     std::mutex m_mutex;
 
 };
@@ -0,0 +1,134 @@
+#include "util/lz.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace Tangram {
+namespace LZ {
+
+// Control byte layout, following LZF:
+// 000LLLLL            - literal run of L+1 bytes
+// LLLOOOOO OOOOOOOO   - match of L+2 bytes at offset O+1, L < 7
+// 111OOOOO LLLLLLLL OOOOOOOO - match of L+9 bytes at offset O+1
+
+namespace {
+
+constexpr size_t hash_bits = 13;
+constexpr size_t max_offset = 1 << 13;
+constexpr size_t min_match = 3;
+constexpr size_t max_match = 7 + 255 + 2;
+constexpr size_t max_literals = 32;
+
+inline uint32_t hashAt(const unsigned char* _p) {
+    uint32_t v = _p[0] | (_p[1] << 8) | (_p[2] << 16);
+    return (v * 2654435761u) >> (32 - hash_bits);
+}
+
+}
+
+void compress(const char* _data, size_t _size, std::vector<char>& _out) {
+
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(_data);
+
+    // Positions of recently seen 3-byte sequences, offset by one so that
+    // zero marks an empty slot.
+    std::vector<uint32_t> table(1 << hash_bits, 0);
+
+    auto flushLiterals = [&](size_t _from, size_t _to) {
+        while (_from < _to) {
+            size_t run = std::min(max_literals, _to - _from);
+            _out.push_back(char(run - 1));
+            _out.insert(_out.end(), _data + _from, _data + _from + run);
+            _from += run;
+        }
+    };
+
+    size_t pos = 0;
+    size_t literalStart = 0;
+
+    while (pos + min_match <= _size) {
+
+        uint32_t slot = hashAt(in + pos);
+        size_t ref = table[slot];
+        table[slot] = uint32_t(pos + 1);
+
+        if (ref > 0) {
+            size_t match = ref - 1;
+            size_t offset = pos - match;
+
+            if (offset > 0 && offset <= max_offset &&
+                in[match] == in[pos] &&
+                in[match + 1] == in[pos + 1] &&
+                in[match + 2] == in[pos + 2]) {
+
+                size_t limit = std::min(max_match, _size - pos);
+                size_t len = min_match;
+                while (len < limit && in[match + len] == in[pos + len]) { len++; }
+
+                flushLiterals(literalStart, pos);
+
+                size_t encLen = len - 2;
+                size_t encOff = offset - 1;
+                if (encLen < 7) {
+                    _out.push_back(char((encLen << 5) | (encOff >> 8)));
+                } else {
+                    _out.push_back(char((7 << 5) | (encOff >> 8)));
+                    _out.push_back(char(encLen - 7));
+                }
+                _out.push_back(char(encOff & 0xff));
+
+                pos += len;
+                literalStart = pos;
+                continue;
+            }
+        }
+        pos++;
+    }
+
+    flushLiterals(literalStart, _size);
+}
+
+bool decompress(const char* _data, size_t _size, char* _out, size_t _outSize) {
+
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(_data);
+    size_t ip = 0;
+    size_t op = 0;
+
+    while (ip < _size) {
+
+        unsigned ctrl = in[ip++];
+
+        if (ctrl < max_literals) {
+            size_t run = ctrl + 1;
+            if (ip + run > _size || op + run > _outSize) { return false; }
+
+            std::memcpy(_out + op, _data + ip, run);
+            ip += run;
+            op += run;
+
+        } else {
+            size_t len = ctrl >> 5;
+            if (len == 7) {
+                if (ip >= _size) { return false; }
+                len += in[ip++];
+            }
+            len += 2;
+
+            if (ip >= _size) { return false; }
+            size_t offset = (((ctrl & 0x1f) << 8) | in[ip++]) + 1;
+
+            if (offset > op || op + len > _outSize) { return false; }
+
+            // Byte-wise copy: matches may overlap their own output.
+            const char* src = _out + op - offset;
+            for (size_t i = 0; i < len; i++) { _out[op + i] = src[i]; }
+            op += len;
+        }
+    }
+
+    return op == _outSize;
+}
+
+}
+}
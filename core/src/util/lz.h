@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Tangram {
+
+/* Small byte-oriented LZ77 codec (LZF-style control bytes, 8KB window).
+ *
+ * Tuned for speed over ratio: one hash probe per position and greedy
+ * matching, so compression runs at memcpy-like rates and decompression
+ * is a plain copy loop. Used to keep serialized tile meshes resident in
+ * RAM, see TileMeshCache.
+ */
+namespace LZ {
+
+/* Append _size bytes at _data to _out in compressed form. The output can
+ * be larger than the input for incompressible data; callers should fall
+ * back to storing raw bytes in that case. */
+void compress(const char* _data, size_t _size, std::vector<char>& _out);
+
+/* Decode a stream written by compress() into _out, whose exact decoded
+ * size _outSize the caller must know. Returns false on malformed input
+ * or a size mismatch. */
+bool decompress(const char* _data, size_t _size, char* _out, size_t _outSize);
+
+}
+}
@@ -176,4 +176,35 @@ public:
     virtual ~MercatorProjection() {}
 };
 
+/* Transform from longitude/latitude into the local coordinates of one
+ * tile (see tileData.h).
+ *
+ * The tile origin and inverse scale are computed in double exactly once
+ * per tile. Per coordinate only the projection to meters and the offset
+ * against the origin run in double - tile-local offsets are small while
+ * absolute mercator meters are not - and the result is handed on as
+ * float, keeping double math out of the per-feature geometry paths. */
+struct TileTransform {
+
+    TileTransform() {}
+
+    TileTransform(const MapProjection& _projection, const TileID& _tileID)
+        : projection(&_projection) {
+        BoundingBox bounds(_projection.TileBounds(_tileID));
+        origin = { bounds.min.x, -bounds.max.y };
+        invScale = 1.0 / bounds.width();
+    }
+
+    glm::vec3 operator()(glm::dvec2 _lonLat) const {
+        glm::dvec2 meters = projection->LonLatToMeters(_lonLat);
+        return { float((meters.x - origin.x) * invScale),
+                 float((meters.y - origin.y) * invScale),
+                 0.f };
+    }
+
+    const MapProjection* projection = nullptr;
+    glm::dvec2 origin = { 0.0, 0.0 };
+    double invScale = 1.0;
+};
+
 }
@@ -0,0 +1,257 @@
+#include "util/meshOptimizer.h"
+
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+namespace {
+
+const uint32_t NO_VERTEX = uint32_t(-1);
+
+// FNV-1a over the raw vertex bytes; packed attributes make welding a
+// plain byte comparison, no per-attribute epsilons involved.
+size_t byteHash(const char* _data, size_t _size) {
+    size_t h = 0xcbf29ce484222325;
+    for (size_t i = 0; i < _size; i++) {
+        h = (h ^ uint8_t(_data[i])) * 0x100000001b3;
+    }
+    return h;
+}
+
+// Forsyth scoring parameters, the values from the original article
+const int cache_size = 32;
+const float cache_decay_power = 1.5f;
+const float last_tri_score = 0.75f;
+const float valence_boost_scale = 2.0f;
+const float valence_boost_power = 0.5f;
+
+struct VertexScore {
+    float score = 0.f;
+    int32_t cachePos = -1;
+    uint32_t trisLeft = 0;
+    uint32_t triListStart = 0;
+};
+
+float vertexScore(const VertexScore& _v) {
+    if (_v.trisLeft == 0) { return -1.f; }
+
+    float score = 0.f;
+    if (_v.cachePos < 0) {
+        // Not in cache
+    } else if (_v.cachePos < 3) {
+        // Vertices of the last drawn triangle get a fixed score, so the
+        // chain does not keep feeding on one strip direction
+        score = last_tri_score;
+    } else {
+        score = powf(1.f - float(_v.cachePos - 3) / (cache_size - 3), cache_decay_power);
+    }
+
+    // Boost vertices with few remaining triangles to retire them early
+    score += valence_boost_scale * powf(float(_v.trisLeft), -valence_boost_power);
+    return score;
+}
+
+}
+
+uint32_t MeshOptimizer::weldVertices(char* _vertices, size_t _stride, uint32_t _nVertices,
+                                     uint16_t* _indices, size_t _nIndices) {
+
+    std::unordered_map<size_t, uint32_t> heads;
+    heads.reserve(_nVertices);
+
+    // Chain of welded vertex ids sharing one hash bucket
+    std::vector<uint32_t> chain;
+    chain.reserve(_nVertices);
+
+    std::vector<uint16_t> remap(_nVertices);
+
+    uint32_t out = 0;
+    for (uint32_t i = 0; i < _nVertices; i++) {
+        const char* v = _vertices + i * _stride;
+
+        size_t hash = byteHash(v, _stride);
+        auto it = heads.find(hash);
+
+        uint32_t found = NO_VERTEX;
+        for (uint32_t id = (it != heads.end()) ? it->second : NO_VERTEX;
+             id != NO_VERTEX; id = chain[id]) {
+            if (std::memcmp(_vertices + id * _stride, v, _stride) == 0) {
+                found = id;
+                break;
+            }
+        }
+
+        if (found != NO_VERTEX) {
+            remap[i] = found;
+            continue;
+        }
+
+        if (out != i) {
+            std::memcpy(_vertices + out * _stride, v, _stride);
+        }
+        chain.push_back((it != heads.end()) ? it->second : NO_VERTEX);
+        heads[hash] = out;
+        remap[i] = out++;
+    }
+
+    for (size_t i = 0; i < _nIndices; i++) {
+        _indices[i] = remap[_indices[i]];
+    }
+
+    return out;
+}
+
+void MeshOptimizer::optimizeIndexOrder(uint16_t* _indices, size_t _nIndices, uint32_t _nVertices) {
+
+    size_t nTris = _nIndices / 3;
+    if (nTris < 2 || _nVertices == 0) { return; }
+
+    std::vector<VertexScore> verts(_nVertices);
+
+    for (size_t i = 0; i < _nIndices; i++) {
+        verts[_indices[i]].trisLeft++;
+    }
+
+    // Per-vertex triangle lists, packed into one array
+    std::vector<uint32_t> triLists(_nIndices);
+    uint32_t listPos = 0;
+    for (auto& v : verts) {
+        v.triListStart = listPos;
+        listPos += v.trisLeft;
+        v.trisLeft = 0;
+    }
+    for (size_t t = 0; t < nTris; t++) {
+        for (int k = 0; k < 3; k++) {
+            auto& v = verts[_indices[t * 3 + k]];
+            triLists[v.triListStart + v.trisLeft++] = t;
+        }
+    }
+
+    for (auto& v : verts) { v.score = vertexScore(v); }
+
+    std::vector<float> triScores(nTris);
+    std::vector<bool> triAdded(nTris, false);
+    for (size_t t = 0; t < nTris; t++) {
+        triScores[t] = verts[_indices[t * 3]].score
+                     + verts[_indices[t * 3 + 1]].score
+                     + verts[_indices[t * 3 + 2]].score;
+    }
+
+    // LRU cache with three overflow slots for the incoming triangle
+    int32_t cache[cache_size + 3];
+    for (auto& c : cache) { c = -1; }
+
+    std::vector<uint16_t> out;
+    out.reserve(_nIndices);
+
+    size_t scanPos = 0; // fallback cursor over not-yet-added triangles
+    int32_t bestTri = -1;
+
+    for (size_t added = 0; added < nTris; added++) {
+
+        if (bestTri < 0) {
+            // No candidate from the cache neighborhood; take the best
+            // of the remaining triangles, advancing past finished ones
+            while (triAdded[scanPos]) { scanPos++; }
+            float bestScore = -1.f;
+            for (size_t t = scanPos; t < nTris; t++) {
+                if (!triAdded[t] && triScores[t] > bestScore) {
+                    bestScore = triScores[t];
+                    bestTri = t;
+                }
+            }
+        }
+
+        uint32_t tri = bestTri;
+        triAdded[tri] = true;
+
+        // Emit and retire the triangle from its vertices' lists
+        for (int k = 0; k < 3; k++) {
+            uint16_t idx = _indices[tri * 3 + k];
+            out.push_back(idx);
+
+            auto& v = verts[idx];
+            for (uint32_t j = 0; j < v.trisLeft; j++) {
+                if (triLists[v.triListStart + j] == tri) {
+                    triLists[v.triListStart + j] = triLists[v.triListStart + v.trisLeft - 1];
+                    break;
+                }
+            }
+            v.trisLeft--;
+        }
+
+        // Push the triangle's vertices to the cache front; entries
+        // falling into the three overflow slots are evicted, but still
+        // get rescored below
+        int32_t updated[cache_size + 3];
+        int32_t used = 0;
+        for (int k = 0; k < 3; k++) { updated[used++] = _indices[tri * 3 + k]; }
+        for (int c = 0; c < cache_size + 3 && used < cache_size + 3; c++) {
+            int32_t idx = cache[c];
+            if (idx < 0) { continue; }
+            if (idx == updated[0] || idx == updated[1] || idx == updated[2]) { continue; }
+            updated[used++] = idx;
+        }
+        for (int c = 0; c < cache_size + 3; c++) {
+            cache[c] = (c < used) ? updated[c] : -1;
+            if (cache[c] >= 0) { verts[cache[c]].cachePos = (c < cache_size) ? c : -1; }
+        }
+
+        // Rescore cached vertices and find the next best triangle among
+        // their remaining ones
+        bestTri = -1;
+        float bestScore = -1.f;
+        for (int c = 0; c < cache_size + 3; c++) {
+            if (cache[c] < 0) { continue; }
+            auto& v = verts[cache[c]];
+
+            float diff = vertexScore(v) - v.score;
+            v.score += diff;
+
+            for (uint32_t j = 0; j < v.trisLeft; j++) {
+                uint32_t t = triLists[v.triListStart + j];
+                triScores[t] += diff;
+                if (triScores[t] > bestScore) {
+                    bestScore = triScores[t];
+                    bestTri = t;
+                }
+            }
+        }
+
+        // Overflow slots only carry the scoring update above
+        for (int c = cache_size; c < cache_size + 3; c++) { cache[c] = -1; }
+    }
+
+    std::memcpy(_indices, out.data(), _nIndices * sizeof(uint16_t));
+}
+
+void MeshOptimizer::orderVerticesByUse(char* _vertices, size_t _stride, uint32_t _nVertices,
+                                       uint16_t* _indices, size_t _nIndices) {
+
+    std::vector<uint32_t> remap(_nVertices, NO_VERTEX);
+
+    uint32_t out = 0;
+    for (size_t i = 0; i < _nIndices; i++) {
+        if (remap[_indices[i]] == NO_VERTEX) {
+            remap[_indices[i]] = out++;
+        }
+    }
+    // Unreferenced vertices keep a slot at the end, so batch counts stay valid
+    for (auto& r : remap) {
+        if (r == NO_VERTEX) { r = out++; }
+    }
+
+    std::vector<char> scratch(_nVertices * _stride);
+    for (uint32_t i = 0; i < _nVertices; i++) {
+        std::memcpy(&scratch[remap[i] * _stride], _vertices + i * _stride, _stride);
+    }
+    std::memcpy(_vertices, scratch.data(), scratch.size());
+
+    for (size_t i = 0; i < _nIndices; i++) {
+        _indices[i] = remap[_indices[i]];
+    }
+}
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "gl/mesh.h"
+
+#include <cstring>
+
+namespace Tangram {
+
+/* Optional mesh optimization pass, run by style builders on the tile
+ * worker between tessellation and upload (enabled per style with
+ * 'mesh_optimize: true').
+ *
+ * Two steps, applied to each draw batch of a mesh:
+ *  - Welding: vertices with byte-identical attributes collapse into
+ *    one, shrinking the vertex buffer where the builders emit repeated
+ *    corners.
+ *  - Cache reordering: triangles are resorted with Forsyth's
+ *    linear-speed vertex cache optimization and the vertices renumbered
+ *    in first-use order, so the post-transform cache re-serves shared
+ *    vertices instead of shading them again. Tilted views over extruded
+ *    buildings are vertex bound on low-end GPUs, and those meshes are
+ *    emitted in per-feature order with no cache locality at all.
+ *
+ * Only meshes that stay static after the build may be optimized; the
+ * pass reorders vertices, so anything addressed later through
+ * updateVertices()/updateAttribute() ranges must keep builder order.
+ */
+class MeshOptimizer {
+
+public:
+
+    template<class V>
+    static void optimize(MeshData<V>& _mesh) {
+
+        if (_mesh.vertices.empty() || _mesh.offsets.empty()) { return; }
+
+        char* vertices = reinterpret_cast<char*>(_mesh.vertices.data());
+        const size_t stride = sizeof(V);
+
+        size_t indexPos = 0;
+        size_t vertexPos = 0;
+        size_t vertexOut = 0;
+
+        // Batches partition the buffers and their indices are relative
+        // to the batch's first vertex, so each is optimized on its own.
+        for (auto& offset : _mesh.offsets) {
+            uint32_t nIndices = offset.first;
+            uint32_t nVertices = offset.second;
+
+            if (nIndices > 0 && nIndices % 3 == 0) {
+                uint32_t welded = weldVertices(vertices + vertexPos * stride, stride,
+                                               nVertices, &_mesh.indices[indexPos], nIndices);
+
+                optimizeIndexOrder(&_mesh.indices[indexPos], nIndices, welded);
+
+                orderVerticesByUse(vertices + vertexPos * stride, stride,
+                                   welded, &_mesh.indices[indexPos], nIndices);
+
+                if (vertexOut != vertexPos) {
+                    std::memmove(vertices + vertexOut * stride,
+                                 vertices + vertexPos * stride, welded * stride);
+                }
+                offset.second = welded;
+                vertexOut += welded;
+            } else {
+                // Not a triangle batch, keep it as-is
+                if (vertexOut != vertexPos) {
+                    std::memmove(vertices + vertexOut * stride,
+                                 vertices + vertexPos * stride, nVertices * stride);
+                }
+                vertexOut += nVertices;
+            }
+
+            vertexPos += nVertices;
+            indexPos += nIndices;
+        }
+
+        _mesh.vertices.resize(vertexOut);
+    }
+
+private:
+
+    /* Collapse byte-identical vertices in place, rewriting _indices to
+     * the surviving ones; returns the welded vertex count. */
+    static uint32_t weldVertices(char* _vertices, size_t _stride, uint32_t _nVertices,
+                                 uint16_t* _indices, size_t _nIndices);
+
+    /* Reorder the triangles of _indices for post-transform cache
+     * locality (Forsyth's linear-speed greedy scoring). */
+    static void optimizeIndexOrder(uint16_t* _indices, size_t _nIndices, uint32_t _nVertices);
+
+    /* Renumber vertices in order of first use by _indices, so vertex
+     * fetches walk the buffer mostly forward. */
+    static void orderVerticesByUse(char* _vertices, size_t _stride, uint32_t _nVertices,
+                                   uint16_t* _indices, size_t _nIndices);
+};
+
+}
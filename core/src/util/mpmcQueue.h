@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+
+namespace Tangram {
+
+/* Bounded lock-free multi-producer/multi-consumer queue.
+ *
+ * Based on Dmitry Vyukov's bounded MPMC ring buffer: each cell carries a
+ * sequence counter that producers and consumers use to claim slots with a
+ * single CAS, so push and pop never take a lock. Capacity must be a power
+ * of two. When the queue is full push() fails and the caller is expected
+ * to fall back to a slow path.
+ */
+template<typename T>
+class MPMCQueue {
+
+public:
+
+    explicit MPMCQueue(size_t _capacity)
+        : m_buffer(new Cell[_capacity]),
+          m_mask(_capacity - 1) {
+
+        assert(_capacity >= 2 && (_capacity & (_capacity - 1)) == 0);
+
+        for (size_t i = 0; i < _capacity; i++) {
+            m_buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_enqueuePos.store(0, std::memory_order_relaxed);
+        m_dequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    /* Try to enqueue an item. Returns false when the queue is full,
+     * leaving _item untouched. */
+    bool push(T&& _item) {
+        Cell* cell;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+        while (true) {
+            cell = &m_buffer[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(seq) - intptr_t(pos);
+
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // Queue is full
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(_item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* Try to dequeue an item. Returns false when the queue is empty. */
+    bool pop(T& _item) {
+        Cell* cell;
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+
+        while (true) {
+            cell = &m_buffer[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // Queue is empty
+                return false;
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        _item = std::move(cell->data);
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return m_enqueuePos.load(std::memory_order_relaxed) ==
+               m_dequeuePos.load(std::memory_order_relaxed);
+    }
+
+private:
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static const size_t cacheLineSize = 64;
+
+    std::unique_ptr<Cell[]> m_buffer;
+    size_t m_mask;
+
+    alignas(cacheLineSize) std::atomic<size_t> m_enqueuePos;
+    alignas(cacheLineSize) std::atomic<size_t> m_dequeuePos;
+};
+
+}
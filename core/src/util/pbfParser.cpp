@@ -2,6 +2,7 @@
 
 #include "data/propertyItem.h"
 #include "tile/tile.h"
+#include "util/stringIntern.h"
 #include "platform.h"
 #include "util/geom.h"
 #include "log.h"
@@ -23,57 +24,101 @@
 
 namespace Tangram {
 
+namespace {
+
+// Decode a varint straight off the raw buffer. Tile coordinate deltas
+// are almost always one or two bytes, so those cases are branched to
+// first; the cursor never crosses _end.
+inline uint64_t decodeVarint(const char*& _p, const char* _end) {
+
+    if (UNLIKELY(_p >= _end)) {
+        throw std::runtime_error("unterminated varint, unexpected end of buffer");
+    }
+
+    uint64_t result = uint8_t(*_p++);
+    if (LIKELY(result < 0x80)) { return result; }
+
+    result &= 0x7f;
+    int bitpos = 7;
+
+    while (_p < _end) {
+        uint8_t byte = uint8_t(*_p++);
+        result |= uint64_t(byte & 0x7f) << bitpos;
+        if (!(byte & 0x80)) { return result; }
+        bitpos += 7;
+        if (bitpos >= 70) {
+            throw std::runtime_error("unterminated varint (too long)");
+        }
+    }
+    throw std::runtime_error("unterminated varint, unexpected end of buffer");
+}
+
+inline int64_t unzigzag(uint64_t _value) {
+    return int64_t(_value >> 1) ^ -int64_t(_value & 1);
+}
+
+}
+
 PbfParser::Geometry PbfParser::getGeometry(ParserContext& _ctx, protobuf::message _geomIn) {
 
     Geometry geometry;
 
-    pbfGeomCmd cmd = pbfGeomCmd::moveTo;
-    uint32_t cmdRepeat = 0;
-
-    double invTileExtent = (1.0/(_ctx.tileExtent-1.0));
+    // Tile coordinates are already local and bounded by the extent, so
+    // float covers them exactly; keeping the hot decode loop free of
+    // double math matters on 32-bit ARM.
+    float invTileExtent = 1.f / (_ctx.tileExtent - 1.f);
 
     int64_t x = 0;
     int64_t y = 0;
 
     size_t numCoordinates = 0;
 
-    while(_geomIn.getData() < _geomIn.getEnd()) {
+    // Decode the command stream directly off the buffer: the per-varint
+    // call and bounds-check overhead of message::svarint dominates this
+    // loop on dense tiles.
+    const char* data = _geomIn.getData();
+    const char* end = _geomIn.getEnd();
 
-        if(cmdRepeat == 0) { // get new command, length and parameters..
-            uint32_t cmdData = static_cast<uint32_t>(_geomIn.varint());
-            cmd = static_cast<pbfGeomCmd>(cmdData & 0x7); //first 3 bits of the cmdData
-            cmdRepeat = cmdData >> 3; //last 5 bits
-        }
+    while (data < end) {
+
+        uint32_t cmdData = static_cast<uint32_t>(decodeVarint(data, end));
+        pbfGeomCmd cmd = static_cast<pbfGeomCmd>(cmdData & 0x7); //first 3 bits of the cmdData
+        uint32_t cmdRepeat = cmdData >> 3; //remaining bits
 
         if(cmd == pbfGeomCmd::moveTo || cmd == pbfGeomCmd::lineTo) { // get parameters/points
-            // if cmd is move then move to a new line/set of points and save this line
-            if(cmd == pbfGeomCmd::moveTo) {
-                if (geometry.coordinates.size() > 0) {
-                    geometry.sizes.push_back(numCoordinates);
+
+            geometry.coordinates.reserve(geometry.coordinates.size() + cmdRepeat);
+
+            for (uint32_t i = 0; i < cmdRepeat; i++) {
+                // if cmd is move then move to a new line/set of points and save this line
+                if(cmd == pbfGeomCmd::moveTo) {
+                    if (geometry.coordinates.size() > 0) {
+                        geometry.sizes.push_back(numCoordinates);
+                    }
+                    numCoordinates = 0;
                 }
-                numCoordinates = 0;
-            }
 
-            x += _geomIn.svarint();
-            y += _geomIn.svarint();
+                x += unzigzag(decodeVarint(data, end));
+                y += unzigzag(decodeVarint(data, end));
 
-            // bring the points in 0 to 1 space
-            Point p;
-            p.x = invTileExtent * (double)x;
-            p.y = invTileExtent * (double)(_ctx.tileExtent - y);
+                // bring the points in 0 to 1 space
+                Point p;
+                p.x = invTileExtent * float(x);
+                p.y = invTileExtent * float(_ctx.tileExtent - y);
 
-            if (numCoordinates == 0 || geometry.coordinates.back() != p) {
-                geometry.coordinates.push_back(p);
-                numCoordinates++;
+                if (numCoordinates == 0 || geometry.coordinates.back() != p) {
+                    geometry.coordinates.push_back(p);
+                    numCoordinates++;
+                }
             }
         } else if(cmd == pbfGeomCmd::closePath) {
-            // end of a polygon, push first point in this line as last and push line to poly
-            geometry.coordinates.push_back(geometry.coordinates[geometry.coordinates.size() - numCoordinates]);
-            geometry.sizes.push_back(numCoordinates + 1);
-            numCoordinates = 0;
+            for (uint32_t i = 0; i < cmdRepeat; i++) {
+                // end of a polygon, push first point in this line as last and push line to poly
+                geometry.coordinates.push_back(geometry.coordinates[geometry.coordinates.size() - numCoordinates]);
+                geometry.sizes.push_back(numCoordinates + 1);
+                numCoordinates = 0;
+            }
         }
-
-        cmdRepeat--;
     }
 
     // Enter the last line
@@ -86,7 +131,7 @@ PbfParser::Geometry PbfParser::getGeometry(ParserContext& _ctx, protobuf::messag
 
 Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
 
-    Feature feature(_ctx.sourceId);
+    Feature feature(_ctx.sourceId, _ctx.arena);
 
     _ctx.featureTags.clear();
     _ctx.featureTags.assign(_ctx.keys.size(), -1);
@@ -146,7 +191,7 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
     for (int tagKey : _ctx.orderedKeys) {
         int tagValue = _ctx.featureTags[tagKey];
         if (tagValue >= 0) {
-            properties.emplace_back(_ctx.keys[tagKey], _ctx.values[tagValue]);
+            properties.emplace_back(_ctx.keyIds[tagKey], _ctx.values[tagValue]);
         }
     }
     feature.props.setSorted(std::move(properties));
@@ -163,7 +208,7 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
             auto pos = _ctx.geometry.coordinates.begin();
             for (int length : _ctx.geometry.sizes) {
                 if (length == 0) { continue; }
-                Line line;
+                Line line{Line::allocator_type(_ctx.arena)};
                 line.reserve(length);
                 line.insert(line.begin(), pos, pos + length);
                 pos += length;
@@ -188,7 +233,7 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
                 if (_ctx.winding == 0) {
                     _ctx.winding = winding;
                 }
-                Line line;
+                Line line{Line::allocator_type(_ctx.arena)};
                 line.reserve(length);
                 if (_ctx.winding > 0) {
                     line.insert(line.end(), pos, pos + length);
@@ -199,7 +244,7 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
                 rpos -= length;
                 if (winding == _ctx.winding || feature.polygons.empty()) {
                     // This is an exterior polygon.
-                    feature.polygons.emplace_back();
+                    feature.polygons.emplace_back(Polygon::allocator_type(_ctx.arena));
                 }
                 feature.polygons.back().push_back(std::move(line));
             }
@@ -214,11 +259,23 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
     return feature;
 }
 
+std::string PbfParser::getLayerName(protobuf::message _layerIn) {
+
+    while (_layerIn.next()) {
+        if (_layerIn.tag == LAYER_NAME) {
+            return _layerIn.string();
+        }
+        _layerIn.skip();
+    }
+    return "";
+}
+
 Layer PbfParser::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
 
     Layer layer("");
 
     _ctx.keys.clear();
+    _ctx.keyIds.clear();
     _ctx.values.clear();
     _ctx.featureMsgs.clear();
 
@@ -245,6 +302,7 @@ Layer PbfParser::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
             }
             case LAYER_KEY: {
                 _ctx.keys.push_back(_layerIn.string());
+                _ctx.keyIds.push_back(StringIntern::intern(_ctx.keys.back()));
                 break;
             }
             case LAYER_VALUE: {
@@ -252,9 +310,15 @@ Layer PbfParser::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
 
                 while (valueItr.next()) {
                     switch (valueItr.tag) {
-                        case 1: // string value
-                            _ctx.values.push_back(valueItr.string());
+                        case 1: { // string value
+                            // Reference the string in place instead of copying;
+                            // the raw buffer is pinned to the TileData.
+                            uint64_t len = valueItr.varint();
+                            const char* str = valueItr.getData();
+                            valueItr.skipBytes(len);
+                            _ctx.values.push_back(StringView{str, size_t(len)});
                             break;
+                        }
                         case 2: // float value
                             _ctx.values.push_back(valueItr.float32());
                             break;
@@ -301,10 +365,11 @@ Layer PbfParser::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
     for (int i = 0, n = _ctx.keys.size(); i < n; i++) {
         _ctx.orderedKeys.push_back(i);
     }
-    // sort by Property key ordering
+    // sort by interned key id - the canonical Properties ordering, so
+    // per-feature items can be emitted pre-sorted with integer compares
     std::sort(_ctx.orderedKeys.begin(), _ctx.orderedKeys.end(),
               [&](int a, int b) {
-                  return Properties::keyComparator(_ctx.keys[a], _ctx.keys[b]);
+                  return _ctx.keyIds[a] < _ctx.keyIds[b];
               });
 
     layer.features.reserve(numFeatures);
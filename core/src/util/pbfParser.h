@@ -23,16 +23,24 @@ namespace PbfParser {
 
         int32_t sourceId;
         std::vector<std::string> keys;
+        // Interned id for each key, see StringIntern. Keys are interned
+        // once per layer so features share ids instead of string copies.
+        std::vector<uint32_t> keyIds;
         std::vector<Value> values;
         std::vector<protobuf::message> featureMsgs;
         Geometry geometry;
         // Map Key ID -> Tag values
         std::vector<int> featureTags;
-        // Key IDs sorted by Property key ordering
+        // Tag key indices sorted by interned key id, the canonical
+        // Properties ordering
         std::vector<int> orderedKeys;
 
         int tileExtent = 0;
         int winding = 0;
+
+        // When set, feature geometry is allocated from this arena and
+        // freed in one shot with the TileData.
+        Arena* arena = nullptr;
     };
 
     Geometry getGeometry(ParserContext& _ctx, protobuf::message _geomIn);
@@ -41,6 +49,10 @@ namespace PbfParser {
 
     Layer getLayer(ParserContext& _ctx, protobuf::message _layerIn);
 
+    /* Scan a layer message for its name only, skipping all other fields.
+     * Used to decide whether a layer needs to be decoded at all. */
+    std::string getLayerName(protobuf::message _layerIn);
+
     enum pbfGeomCmd {
         moveTo = 1,
         lineTo = 2,
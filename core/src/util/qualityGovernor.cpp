@@ -0,0 +1,146 @@
+#include "util/qualityGovernor.h"
+
+#include "log.h"
+
+#include <algorithm>
+
+namespace Tangram {
+
+namespace {
+
+constexpr float frame_budget_ms = 1000.f / 60.f;
+
+// A window's p95 above this escalates one tier right away
+constexpr float escalate_threshold_ms = frame_budget_ms * 1.25f;
+
+// ... and only p95 below this counts as calm. The band between the two
+// thresholds holds the current tier
+constexpr float relax_threshold_ms = frame_budget_ms * 0.75f;
+
+// Frames between tier decisions and frames of history per decision
+constexpr size_t eval_interval = 30;
+constexpr size_t window_size = 90;
+
+// Calm evaluations in a row before stepping one tier back up
+constexpr int relax_hold = 4;
+
+}
+
+QualityGovernor::QualityGovernor() {
+    setTiers({});
+    m_frameTimes.resize(window_size, 0.f);
+}
+
+bool QualityGovernor::setEnabled(bool _enabled) {
+    if (_enabled == m_enabled) { return false; }
+
+    m_enabled = _enabled;
+    m_frameCount = 0;
+    m_framePos = 0;
+    m_calmEvals = 0;
+
+    int tier = m_enabled ? floorTier() : 0;
+    if (tier == m_tier) { return false; }
+
+    m_tier = tier;
+    return true;
+}
+
+void QualityGovernor::setTiers(std::vector<QualityTier> _tiers) {
+    if (_tiers.empty()) {
+        // Default ladder: thin out labels first - cheap to shed and the
+        // least destructive visually - then drop optional styles, and as
+        // a last resort trade tile resolution for a quarter of the
+        // geometry
+        m_tiers = {{ SIZE_MAX, true, 0 },
+                   { 384, true, 0 },
+                   { 192, false, 0 },
+                   { 96, false, 1 }};
+    } else {
+        m_tiers = std::move(_tiers);
+    }
+    m_tier = std::min(m_tier, int(m_tiers.size()) - 1);
+}
+
+bool QualityGovernor::setThermalState(ThermalState _state) {
+    if (_state == m_thermal) { return false; }
+    m_thermal = _state;
+    return applyFloor();
+}
+
+bool QualityGovernor::setLowPowerMode(bool _lowPower) {
+    if (_lowPower == m_lowPower) { return false; }
+    m_lowPower = _lowPower;
+    return applyFloor();
+}
+
+bool QualityGovernor::onFrameRendered(float _frameMs) {
+    if (!m_enabled) { return false; }
+
+    m_frameTimes[m_framePos] = _frameMs;
+    m_framePos = (m_framePos + 1) % window_size;
+    m_frameCount++;
+
+    // Decide only on a full window and then every eval_interval frames,
+    // so one decision's effect is visible before the next
+    if (m_frameCount < window_size || m_frameCount % eval_interval != 0) {
+        return false;
+    }
+
+    float sorted[window_size];
+    std::copy(m_frameTimes.begin(), m_frameTimes.end(), sorted);
+    auto p95 = sorted + (window_size * 95) / 100;
+    std::nth_element(sorted, p95, sorted + window_size);
+
+    int tier = m_tier;
+
+    if (*p95 > escalate_threshold_ms) {
+        tier++;
+        m_calmEvals = 0;
+    } else if (*p95 < relax_threshold_ms) {
+        if (++m_calmEvals >= relax_hold) {
+            tier--;
+            m_calmEvals = 0;
+        }
+    } else {
+        m_calmEvals = 0;
+    }
+
+    tier = std::max(tier, floorTier());
+    tier = std::min(std::max(tier, 0), int(m_tiers.size()) - 1);
+
+    if (tier == m_tier) { return false; }
+
+    LOG("Quality tier %d -> %d (p95 %.1fms)", m_tier, tier, *p95);
+    m_tier = tier;
+    return true;
+}
+
+int QualityGovernor::floorTier() const {
+    int floor = 0;
+    switch (m_thermal) {
+        case ThermalState::nominal: floor = 0; break;
+        case ThermalState::fair: floor = 1; break;
+        case ThermalState::serious: floor = 2; break;
+        case ThermalState::critical: floor = 3; break;
+    }
+    if (m_lowPower) { floor++; }
+
+    return std::min(floor, int(m_tiers.size()) - 1);
+}
+
+bool QualityGovernor::applyFloor() {
+    if (!m_enabled) { return false; }
+
+    // A rising floor applies at once; a falling one lets the frame-time
+    // evaluations step back down at their own pace
+    int floor = floorTier();
+    if (m_tier >= floor) { return false; }
+
+    LOG("Quality tier %d -> %d (thermal floor)", m_tier, floor);
+    m_tier = floor;
+    m_calmEvals = 0;
+    return true;
+}
+
+}
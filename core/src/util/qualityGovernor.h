@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Tangram {
+
+/* Platform thermal pressure, fed to the quality governor by the host
+ * application; see Map::setThermalState. The levels map directly onto
+ * the thermal status reported by Android's PowerManager and iOS's
+ * ProcessInfo. */
+enum class ThermalState : char {
+    nominal = 0, // No throttling
+    fair,        // Device is warming, clocks may start to drop
+    serious,     // Sustained throttling, performance is noticeably reduced
+    critical,    // Severe throttling, the OS may soon kill workloads
+};
+
+/* One degradation step of the quality governor; see Map::setQualityTiers.
+ * Tier 0 is full quality and each following tier sheds more load. */
+struct QualityTier {
+    // Cap on the number of labels competing for screen space per solve;
+    // the lowest-priority candidates past the cap are dropped
+    size_t maxLabelCandidates = SIZE_MAX;
+    // Whether styles flagged 'optional: true' in the scene are drawn
+    bool drawOptionalStyles = true;
+    // Added to the view's tile zoom bias: each step selects tiles one
+    // zoom level lower and draws them overzoomed, quartering the
+    // geometry per viewport
+    int tileZoomBias = 0;
+};
+
+/* Steps the engine between quality tiers so sustained load degrades the
+ * map smoothly instead of dropping frames.
+ *
+ * The governor watches render-thread frame times over a rolling window:
+ * when the 95th percentile stays over the frame budget it escalates one
+ * tier, and only after the view has been comfortably under budget for
+ * several windows does it step back - the asymmetry keeps the tier from
+ * oscillating at the threshold. A thermal or low-power hint from the
+ * platform sets a floor tier, so a throttling device sheds load before
+ * frame times ever climb.
+ *
+ * Tier changes only pick levers; they are applied by Map::update and the
+ * render loop (label candidate cap, optional styles, tile zoom bias).
+ * Off by default.
+ */
+class QualityGovernor {
+
+public:
+
+    QualityGovernor();
+
+    /* Enable or disable the governor. Disabling returns to tier 0 and
+     * drops the frame-time history; returns true when the tier changed. */
+    bool setEnabled(bool _enabled);
+
+    bool isEnabled() const { return m_enabled; }
+
+    /* Replace the tier ladder. Tier 0 should be full quality; an empty
+     * vector restores the built-in defaults. */
+    void setTiers(std::vector<QualityTier> _tiers);
+
+    /* Update the thermal floor; returns true when the active tier
+     * changed as a result. */
+    bool setThermalState(ThermalState _state);
+
+    /* Raise the floor by one tier while the OS reports battery-saver or
+     * low-power mode; returns true when the active tier changed. */
+    bool setLowPowerMode(bool _lowPower);
+
+    /* Feed one rendered frame's duration; called once per frame on the
+     * render thread. Returns true when the tier changed, so the caller
+     * can schedule an update to apply the new levers. */
+    bool onFrameRendered(float _frameMs);
+
+    /* Levers of the active tier. Tier 0 (i.e. no degradation) while the
+     * governor is disabled. */
+    const QualityTier& levers() const { return m_tiers[m_tier]; }
+
+    int tier() const { return m_tier; }
+
+private:
+
+    // Minimum tier imposed by the thermal and low-power hints
+    int floorTier() const;
+
+    // Raise the tier to the current floor; returns true when it moved
+    bool applyFloor();
+
+    std::vector<QualityTier> m_tiers;
+
+    // Rolling window of frame times, written round-robin
+    std::vector<float> m_frameTimes;
+    size_t m_framePos = 0;
+    size_t m_frameCount = 0;
+
+    // Consecutive under-budget evaluations, reset by any hot window
+    int m_calmEvals = 0;
+
+    int m_tier = 0;
+    ThermalState m_thermal = ThermalState::nominal;
+    bool m_lowPower = false;
+    bool m_enabled = false;
+};
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+
+namespace Tangram {
+
+/* Bounded lock-free single-producer/single-consumer queue.
+ *
+ * A plain ring buffer with acquire/release head and tail counters; with
+ * one producer and one consumer no CAS is needed, so push and pop are a
+ * load, a store and a counter bump each. Capacity must be a power of
+ * two. When the queue is full push() fails and the caller is expected
+ * to fall back to a slow path.
+ */
+template<typename T>
+class SPSCQueue {
+
+public:
+
+    explicit SPSCQueue(size_t _capacity)
+        : m_buffer(new T[_capacity]),
+          m_mask(_capacity - 1) {
+
+        assert(_capacity >= 2 && (_capacity & (_capacity - 1)) == 0);
+
+        m_writePos.store(0, std::memory_order_relaxed);
+        m_readPos.store(0, std::memory_order_relaxed);
+    }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    /* Try to enqueue an item; producer thread only. Returns false when
+     * the queue is full, leaving _item untouched. */
+    bool push(T&& _item) {
+        size_t write = m_writePos.load(std::memory_order_relaxed);
+        size_t read = m_readPos.load(std::memory_order_acquire);
+
+        if (write - read > m_mask) {
+            // Queue is full
+            return false;
+        }
+
+        m_buffer[write & m_mask] = std::move(_item);
+        m_writePos.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* Try to dequeue an item; consumer thread only. Returns false when
+     * the queue is empty. */
+    bool pop(T& _item) {
+        size_t read = m_readPos.load(std::memory_order_relaxed);
+        size_t write = m_writePos.load(std::memory_order_acquire);
+
+        if (read == write) {
+            // Queue is empty
+            return false;
+        }
+
+        _item = std::move(m_buffer[read & m_mask]);
+        m_readPos.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return m_writePos.load(std::memory_order_relaxed) ==
+               m_readPos.load(std::memory_order_relaxed);
+    }
+
+private:
+
+    static const size_t cacheLineSize = 64;
+
+    std::unique_ptr<T[]> m_buffer;
+    size_t m_mask;
+
+    alignas(cacheLineSize) std::atomic<size_t> m_writePos;
+    alignas(cacheLineSize) std::atomic<size_t> m_readPos;
+};
+
+}
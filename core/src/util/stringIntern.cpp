@@ -0,0 +1,59 @@
+#include "stringIntern.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace Tangram {
+namespace StringIntern {
+
+namespace {
+
+std::mutex s_mutex;
+
+// Canonical strings, indexed by id - 1. A deque keeps references stable
+// while the pool grows.
+std::deque<std::string> s_strings;
+
+std::unordered_map<std::string, uint32_t> s_ids;
+
+const std::string s_empty = "";
+
+}
+
+uint32_t intern(const std::string& _str) {
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    auto it = s_ids.find(_str);
+    if (it != s_ids.end()) {
+        return it->second;
+    }
+
+    s_strings.push_back(_str);
+    uint32_t id = s_strings.size();
+    s_ids.emplace(_str, id);
+
+    return id;
+}
+
+uint32_t find(const std::string& _str) {
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    auto it = s_ids.find(_str);
+    return it == s_ids.end() ? 0 : it->second;
+}
+
+const std::string& string(uint32_t _id) {
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    if (_id == 0 || _id > s_strings.size()) {
+        return s_empty;
+    }
+    return s_strings[_id - 1];
+}
+
+}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Tangram {
+
+/* Process-wide interning pool for property keys.
+ *
+ * Tile sources use a small, heavily repeated set of keys ("name", "kind",
+ * "height", ...). Interning maps each distinct key to a stable integer id,
+ * so PropertyItems store an id instead of their own copy of the string and
+ * Properties lookups reduce to integer comparisons.
+ */
+namespace StringIntern {
+
+/* Get the id for _str, interning it if it was not seen before.
+ * Ids are never 0 and stay valid for the lifetime of the process. */
+uint32_t intern(const std::string& _str);
+
+/* Get the id for _str, or 0 if it was never interned. Since every stored
+ * property key is interned, an unknown key cannot match any item. */
+uint32_t find(const std::string& _str);
+
+/* The canonical string for an interned id. */
+const std::string& string(uint32_t _id);
+
+}
+}
@@ -0,0 +1,207 @@
+#include "util/taskExecutor.h"
+
+#include "util/jobQueue.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace Tangram {
+
+TaskExecutor& TaskExecutor::shared() {
+    // Two threads cover decode, marker builds and scene loading; the tile
+    // workers and the render thread take the remaining cores.
+    static TaskExecutor instance(
+        std::min(2u, std::max(1u, std::thread::hardware_concurrency() / 2)));
+    return instance;
+}
+
+TaskExecutor::TaskExecutor(unsigned int _threads) {
+    for (unsigned int i = 0; i < _threads; i++) {
+        m_threads.emplace_back(&TaskExecutor::run, this);
+    }
+}
+
+TaskExecutor::~TaskExecutor() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+bool TaskExecutor::enqueue(Task _task) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_running) { return false; }
+
+        m_queue.push_back(std::move(_task));
+    }
+    m_condition.notify_one();
+    return true;
+}
+
+void TaskExecutor::forRanges(size_t _count, size_t _minRange,
+                             std::function<void(size_t, size_t)> _body) {
+
+    if (_count == 0) { return; }
+
+    size_t ranges = std::max<size_t>(1, _count / std::max<size_t>(1, _minRange));
+    ranges = std::min(ranges, m_threads.size() + 1);
+
+    if (ranges <= 1) {
+        _body(0, _count);
+        return;
+    }
+
+    struct Shared {
+        std::mutex mutex;
+        std::condition_variable done;
+        std::atomic<size_t> next{0};
+        size_t finished = 0;
+        size_t ranges;
+        size_t step;
+        size_t count;
+        std::function<void(size_t, size_t)> body;
+    };
+
+    auto shared = std::make_shared<Shared>();
+    shared->ranges = ranges;
+    shared->step = (_count + ranges - 1) / ranges;
+    shared->count = _count;
+    shared->body = std::move(_body);
+
+    auto claim = [](std::shared_ptr<Shared> _shared) {
+        while (true) {
+            size_t range = _shared->next.fetch_add(1);
+            if (range >= _shared->ranges) { return; }
+
+            size_t begin = range * _shared->step;
+            size_t end = std::min(begin + _shared->step, _shared->count);
+            if (begin < end) { _shared->body(begin, end); }
+
+            std::lock_guard<std::mutex> lock(_shared->mutex);
+            if (++_shared->finished == _shared->ranges) {
+                _shared->done.notify_all();
+            }
+        }
+    };
+
+    for (size_t i = 1; i < ranges; i++) {
+        enqueue([shared, claim]() { claim(shared); });
+    }
+
+    // Work the ranges here as well, then wait out helpers still running
+    claim(shared);
+
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->done.wait(lock, [&]{ return shared->finished == shared->ranges; });
+}
+
+void TaskExecutor::run() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [&]{ return !m_running || !m_queue.empty(); });
+            if (!m_running) { break; }
+
+            task = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        task();
+    }
+}
+
+TaskExecutor::Lane::Lane(TaskExecutor& _executor)
+    : m_state(std::make_shared<State>()) {
+    m_state->executor = &_executor;
+}
+
+TaskExecutor::Lane::~Lane() {
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->alive = false;
+    m_state->queue.clear();
+    // Like the single-thread workers before: wait for the task in flight,
+    // drop the rest.
+    m_state->idle.wait(lock, [&]{ return !m_state->scheduled; });
+}
+
+void TaskExecutor::Lane::enqueue(Task _task) {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    if (!m_state->alive) { return; }
+
+    m_state->queue.push_back(std::move(_task));
+
+    if (!m_state->scheduled) {
+        auto state = m_state;
+        m_state->scheduled = m_state->executor->enqueue([state]() { drain(state); });
+    }
+}
+
+void TaskExecutor::Lane::drain(std::shared_ptr<State> _state) {
+
+    Task task;
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        if (!_state->alive || _state->queue.empty()) {
+            _state->scheduled = false;
+            _state->idle.notify_all();
+            return;
+        }
+        task = std::move(_state->queue.front());
+        _state->queue.pop_front();
+    }
+
+    task();
+
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        // One task per pool job, so long lanes share the pool fairly.
+        if (!_state->alive || _state->queue.empty() ||
+            !_state->executor->enqueue([_state]() { drain(_state); })) {
+            _state->scheduled = false;
+            _state->idle.notify_all();
+        }
+    }
+}
+
+TaskExecutor::Chain& TaskExecutor::Chain::then(Task _task) {
+    m_stages.push_back({ std::move(_task), nullptr });
+    return *this;
+}
+
+TaskExecutor::Chain& TaskExecutor::Chain::thenOn(JobQueue& _queue, Task _task) {
+    m_stages.push_back({ std::move(_task), &_queue });
+    return *this;
+}
+
+void TaskExecutor::Chain::run() {
+    if (m_stages.empty()) { return; }
+
+    auto stages = std::make_shared<std::vector<Stage>>(std::move(m_stages));
+    runStage(&m_executor, std::move(stages), 0);
+}
+
+void TaskExecutor::Chain::runStage(TaskExecutor* _executor,
+                                   std::shared_ptr<std::vector<Stage>> _stages,
+                                   size_t _index) {
+    if (_index >= _stages->size()) { return; }
+
+    JobQueue* queue = (*_stages)[_index].queue;
+
+    auto job = [_executor, _stages, _index]() {
+        (*_stages)[_index].task();
+        runStage(_executor, _stages, _index + 1);
+    };
+
+    if (queue) {
+        queue->add(std::move(job));
+    } else {
+        _executor->enqueue(std::move(job));
+    }
+}
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Tangram {
+
+class JobQueue;
+
+/* Shared pool for miscellaneous background work.
+ *
+ * Subsystems used to bring their own thread (texture decode, marker
+ * builds, client geojson updates, scene loading), oversubscribing small
+ * devices. They now schedule onto this pool, sized once to the device;
+ * ordering per subsystem comes from a Lane and multi-stage work with a
+ * GL-thread tail is expressed as a Chain. The tile workers keep their
+ * own pool: their priority lanes and cancellation are their own problem.
+ */
+class TaskExecutor {
+
+public:
+
+    using Task = std::function<void()>;
+
+    /* The process-wide pool; started on first use. */
+    static TaskExecutor& shared();
+
+    explicit TaskExecutor(unsigned int _threads);
+
+    /* Drops tasks that have not started and joins the threads. */
+    ~TaskExecutor();
+
+    /* Run _task on any pool thread. Returns false when the pool is
+     * already shutting down and the task was dropped. */
+    bool enqueue(Task _task);
+
+    /* Run _body(begin, end) over [0, _count) split into ranges of at
+     * least _minRange items, and return when every range completed. The
+     * ranges are claimed from a shared counter by the pool threads and
+     * by the calling thread alike, so the call makes progress even when
+     * the pool is saturated and is safe from a tile worker. _body must
+     * be reentrant. */
+    void forRanges(size_t _count, size_t _minRange,
+                   std::function<void(size_t, size_t)> _body);
+
+    /* A serial lane on the pool: its tasks run in enqueue order, one at
+     * a time, without holding a thread while idle. Drop-in replacement
+     * for the single-thread workers it replaces, including the shutdown
+     * contract: the destructor drops tasks that have not started and
+     * waits for the one in flight. */
+    class Lane {
+
+    public:
+
+        explicit Lane(TaskExecutor& _executor = TaskExecutor::shared());
+        ~Lane();
+
+        void enqueue(Task _task);
+
+    private:
+
+        struct State {
+            std::mutex mutex;
+            std::condition_variable idle;
+            std::deque<Task> queue;
+            TaskExecutor* executor;
+            /* A drain job is queued or running on the pool */
+            bool scheduled = false;
+            bool alive = true;
+        };
+
+        /* Run one task of the lane, then reschedule while tasks remain;
+         * keeps the state alive past the Lane itself. */
+        static void drain(std::shared_ptr<State> _state);
+
+        std::shared_ptr<State> m_state;
+    };
+
+    /* Continuation chain: each stage starts when the previous one
+     * returned, on the pool or marshaled to a JobQueue for stages that
+     * must run on the GL thread.
+     *
+     *     TaskExecutor::Chain()
+     *         .then([]{ parse(); })
+     *         .thenOn(glJobQueue, []{ upload(); })
+     *         .run();
+     */
+    class Chain {
+
+    public:
+
+        explicit Chain(TaskExecutor& _executor = TaskExecutor::shared())
+            : m_executor(_executor) {}
+
+        Chain& then(Task _task);
+
+        /* The stage runs on _queue's thread at its next drain; _queue
+         * must outlive the chain's execution. */
+        Chain& thenOn(JobQueue& _queue, Task _task);
+
+        /* Schedule the first stage; the Chain object itself may go away. */
+        void run();
+
+    private:
+
+        struct Stage {
+            Task task;
+            JobQueue* queue;
+        };
+
+        static void runStage(TaskExecutor* _executor,
+                             std::shared_ptr<std::vector<Stage>> _stages,
+                             size_t _index);
+
+        TaskExecutor& m_executor;
+        std::vector<Stage> m_stages;
+    };
+
+private:
+
+    void run();
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Task> m_queue;
+    bool m_running = true;
+};
+
+}
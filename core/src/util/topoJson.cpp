@@ -1,6 +1,7 @@
 #include "topoJson.h"
 #include "data/propertyItem.h"
 #include "util/geoJson.h"
+#include "util/taskExecutor.h"
 
 namespace Tangram {
 namespace TopoJson {
@@ -38,17 +39,25 @@ Topology getTopology(const JsonDocument& _document, const Transform& _proj) {
 
     topo.arcs.reserve(jsonArcs.Size());
 
-    // Decode and transform the points that make up 'arcs'
+    // Sum up the arc lengths first, so the shared pool is allocated once.
+    size_t pointCount = 0;
+    for (auto jsonArcsIt = jsonArcs.Begin(); jsonArcsIt != jsonArcs.End(); ++jsonArcsIt) {
+        if (jsonArcsIt->IsArray()) { pointCount += jsonArcsIt->Size(); }
+    }
+    topo.points.reserve(pointCount);
+
+    // Decode and transform the points that make up 'arcs' into the pool
     for (auto jsonArcsIt = jsonArcs.Begin(); jsonArcsIt != jsonArcs.End(); ++jsonArcsIt) {
 
         const auto& jsonArc = *jsonArcsIt;
 
         if (!jsonArc.IsArray()) { // According to spec, jsonArc.Size() >= 2 should also hold
+            // Keep an empty slice, so arc indices stay aligned.
+            topo.arcs.push_back({ uint32_t(topo.points.size()), 0 });
             continue;
         }
 
-        Line arc;
-        arc.reserve(jsonArc.Size());
+        uint32_t start = topo.points.size();
 
         // Quantized position
         glm::ivec2 q;
@@ -57,10 +66,10 @@ Topology getTopology(const JsonDocument& _document, const Transform& _proj) {
 
             const auto& jsonCoords = *jsonCoordsIt;
 
-            arc.push_back(getPoint(jsonCoords, topo, q));
+            topo.points.push_back(getPoint(jsonCoords, topo, q));
         }
 
-        topo.arcs.push_back(arc);
+        topo.arcs.push_back({ start, uint32_t(topo.points.size()) - start });
     }
 
     return topo;
@@ -96,18 +105,21 @@ Line getLine(const JsonValue& _arcs, const Topology& _topology) {
             index = -1 - index;
         }
 
-        if (index < 0 || (std::vector<Line>::size_type)index >= _topology.arcs.size()) {
+        if (index < 0 || (size_t)index >= _topology.arcs.size()) {
             continue;
         }
 
-        const auto& arc = _topology.arcs[index];
+        const auto& slice = _topology.arcs[index];
+        if (slice.length == 0) { continue; }
 
-        auto begin = arc.begin();
-        auto end = arc.end();
-        size_t inc = 1;
+        const Point* arc = _topology.points.data() + slice.start;
+
+        const Point* begin = arc;
+        const Point* end = arc + slice.length;
+        int inc = 1;
         if (reverse) {
-            begin = arc.end() - 1;
-            end = arc.begin() - 1;
+            begin = arc + slice.length - 1;
+            end = arc - 1;
             inc = -inc;
         }
 
@@ -118,6 +130,8 @@ Line getLine(const JsonValue& _arcs, const Topology& _topology) {
             begin = begin + inc;
         }
 
+        line.reserve(line.size() + slice.length);
+
         for (auto pointIt = begin; pointIt != end; pointIt += inc) {
             line.push_back(*pointIt);
         }
@@ -231,9 +245,19 @@ Layer getLayer(JsonValue::MemberIterator& _objectIt, const Topology& _topology,
     if (type != object.MemberEnd() && strcmp("GeometryCollection", type->value.GetString()) == 0) {
         auto geometries = object.FindMember("geometries");
         if (geometries != object.MemberEnd() && geometries->value.IsArray()) {
-            for (auto it = geometries->value.Begin(); it != geometries->value.End(); ++it) {
-                layer.features.push_back(getFeature(*it, _topology, _source));
-            }
+            // Reconstruction only reads the document and the topology, so
+            // large layers are converted in parallel ranges writing to
+            // disjoint slots.
+            const auto& array = geometries->value;
+            size_t count = array.Size();
+
+            layer.features.resize(count);
+
+            TaskExecutor::shared().forRanges(count, 256, [&](size_t _begin, size_t _end) {
+                for (size_t i = _begin; i < _end; i++) {
+                    layer.features[i] = getFeature(array[rapidjson::SizeType(i)], _topology, _source);
+                }
+            });
         }
     }
 
@@ -3,18 +3,28 @@
 #include "data/tileData.h"
 #include "glm/vec2.hpp"
 #include "util/json.h"
-#include <functional>
+#include "util/mapProjection.h"
 
 namespace Tangram {
 
 namespace TopoJson {
 
-using Transform = std::function<Point(glm::dvec2 _lonLat)>;
+using Transform = TileTransform;
 
 struct Topology {
     glm::dvec2 scale = { 1., 1. };
     glm::dvec2 translate = { 0., 0. };
-    std::vector<Line> arcs;
+
+    // Decoded arc coordinates, flattened into one shared pool; arcs[i]
+    // is the slice of points belonging to arc i. Geometries reference
+    // slices instead of re-materializing shared arcs.
+    struct Slice {
+        uint32_t start;
+        uint32_t length;
+    };
+    std::vector<Slice> arcs;
+    std::vector<Point> points;
+
     Transform proj;
 };
 
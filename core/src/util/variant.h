@@ -14,6 +14,7 @@
 #undef NDEBUG
 #endif
 
+#include <cstring>
 #include <string>
 
 namespace Tangram {
@@ -31,17 +32,59 @@ struct none_type {
 
 };
 
+/* Non-owning slice of a string. Parsers use this to reference property
+ * strings directly in the raw tile buffer instead of copying them; whoever
+ * creates the view must keep the backing buffer alive for as long as the
+ * Value is used (for tile parsing the buffer is pinned to the TileData). */
+struct StringView {
+    const char* data = nullptr;
+    uint32_t length = 0;
+
+    StringView() = default;
+    StringView(const char* _data, size_t _length)
+        : data(_data), length(static_cast<uint32_t>(_length)) {}
+
+    std::string toString() const { return std::string(data, data + length); }
+
+    bool operator==(const StringView& _rhs) const {
+        return length == _rhs.length &&
+            std::memcmp(data, _rhs.data, length) == 0;
+    }
+    bool operator==(const std::string& _rhs) const {
+        return length == _rhs.length() &&
+            std::memcmp(data, _rhs.data(), length) == 0;
+    }
+    bool operator<(const StringView& _rhs) const {
+        int cmp = std::memcmp(data, _rhs.data,
+                              length < _rhs.length ? length : _rhs.length);
+        return cmp != 0 ? cmp < 0 : length < _rhs.length;
+    }
+};
+
 template<typename... Types>
 using variant = mapbox::util::variant<Types...>;
 
 namespace detail {
 /* Common Value type for Feature Properties and Filter Values */
-using Value = variant<none_type, double, std::string>;
+using Value = variant<none_type, double, std::string, StringView>;
 }
 
 class Value : public detail::Value {
     using Base = detail::Value;
     using Base::Base;
+
+public:
+    /* True for both owned strings and views */
+    bool isString() const {
+        return is<std::string>() || is<StringView>();
+    }
+
+    /* Copy out the string contents, whether owned or viewed */
+    std::string toString() const {
+        if (is<std::string>()) { return get<std::string>(); }
+        if (is<StringView>()) { return get<StringView>().toString(); }
+        return "";
+    }
 };
 
 const static Value NOT_A_VALUE(none_type{});
@@ -8,6 +8,7 @@
 #include "glm/gtx/rotate_vector.hpp"
 #include "log.h"
 
+#include <algorithm>
 #include <cmath>
 
 #define MAX_LOD 6
@@ -47,6 +48,8 @@ void View::setMapProjection(ProjectionType _projType) {
     m_constraint.setLimitsY(bounds.min.y, bounds.max.y);
 
     m_dirtyMatrices = true;
+    m_dirtyProjection = true;
+    m_dirtyRotation = true;
     m_dirtyTiles = true;
 
 }
@@ -55,6 +58,7 @@ void View::setPixelScale(float _pixelsPerPoint) {
 
     m_pixelScale = _pixelsPerPoint;
     m_dirtyMatrices = true;
+    m_dirtyProjection = true;
     m_dirtyTiles = true;
 
 }
@@ -63,6 +67,7 @@ void View::setCameraType(CameraType _type) {
 
     m_type = _type;
     m_dirtyMatrices = true;
+    m_dirtyProjection = true;
     m_dirtyTiles = true;
 
 }
@@ -87,6 +92,7 @@ void View::setSize(int _width, int _height) {
     m_vpHeight = std::max(_height, 1);
     m_aspect = (float)m_vpWidth/ (float)m_vpHeight;
     m_dirtyMatrices = true;
+    m_dirtyProjection = true;
     m_dirtyTiles = true;
 
     // Screen space orthographic projection matrix, top left origin, y pointing down
@@ -99,6 +105,7 @@ void View::setFieldOfView(float radians) {
     m_fov = radians;
     m_fovStops = nullptr;
     m_dirtyMatrices = true;
+    m_dirtyProjection = true;
     m_dirtyTiles = true;
 
 }
@@ -107,6 +114,7 @@ void View::setFieldOfViewStops(std::shared_ptr<Stops> stops) {
 
     m_fovStops = stops;
     m_dirtyMatrices = true;
+    m_dirtyProjection = true;
     m_dirtyTiles = true;
 
 }
@@ -180,6 +188,16 @@ void View::setZoom(float _z) {
     // ensure zoom value is allowed
     m_zoom = glm::clamp(_z, s_minZoom, s_maxZoom);
     m_dirtyMatrices = true;
+    m_dirtyProjection = true;
+    m_dirtyTiles = true;
+}
+
+void View::setZoomBias(int _bias) {
+
+    _bias = glm::clamp(_bias, 0, 2);
+    if (_bias == m_zoomBias) { return; }
+
+    m_zoomBias = _bias;
     m_dirtyTiles = true;
 }
 
@@ -187,6 +205,7 @@ void View::setRoll(float _roll) {
 
     m_roll = glm::mod(_roll, (float)TWO_PI);
     m_dirtyMatrices = true;
+    m_dirtyRotation = true;
     m_dirtyTiles = true;
 
 }
@@ -195,6 +214,22 @@ void View::setPitch(float _pitch) {
 
     m_pitch = _pitch;
     m_dirtyMatrices = true;
+    m_dirtyRotation = true;
+    m_dirtyTiles = true;
+
+}
+
+void View::setCameraState(double _x, double _y, float _zoom, float _roll, float _pitch) {
+
+    m_pos.x = _x;
+    m_pos.y = _y;
+    m_zoom = glm::clamp(_zoom, s_minZoom, s_maxZoom);
+    m_roll = glm::mod(_roll, (float)TWO_PI);
+    m_pitch = _pitch;
+
+    m_dirtyMatrices = true;
+    m_dirtyProjection = true;
+    m_dirtyRotation = true;
     m_dirtyTiles = true;
 
 }
@@ -226,12 +261,21 @@ void View::pitch(float _dpitch) {
 void View::update(bool _constrainToWorldBounds) {
 
     m_changed = false;
+    m_visibleTilesChanged = false;
 
     if (_constrainToWorldBounds) {
         m_constraint.setRadius(std::fmax(getWidth(), getHeight()) / pixelsPerMeter() / pixelScale());
-        m_pos.x = m_constraint.getConstrainedX(m_pos.x);
-        m_pos.y = m_constraint.getConstrainedY(m_pos.y);
-        m_zoom -= std::log(m_constraint.getConstrainedScale()) / std::log(2);
+        // Cameras well inside the bounds skip the constraint math entirely
+        if (!m_constraint.isSatisfied(m_pos.x, m_pos.y)) {
+            m_pos.x = m_constraint.getConstrainedX(m_pos.x);
+            m_pos.y = m_constraint.getConstrainedY(m_pos.y);
+            double constrainedScale = m_constraint.getConstrainedScale();
+            if (constrainedScale != 1.0) {
+                m_zoom -= std::log(constrainedScale) / std::log(2);
+                m_dirtyMatrices = true;
+                m_dirtyProjection = true;
+            }
+        }
     }
 
     // Ensure valid pitch angle.
@@ -241,7 +285,16 @@ void View::update(bool _constrainToWorldBounds) {
             // Prevent projection plane from intersecting ground plane.
             maxPitchRadians = atan2(m_pos.z, m_height * .5f);
         }
-        m_pitch = glm::clamp(m_pitch, 0.f, maxPitchRadians);
+        float pitch = glm::clamp(m_pitch, 0.f, maxPitchRadians);
+        if (pitch != m_pitch) {
+            m_pitch = pitch;
+            m_dirtyMatrices = true;
+            m_dirtyRotation = true;
+        }
+    }
+
+    if (m_dirtyMatrices || m_dirtyTiles) {
+        m_stateGeneration++;
     }
 
     if (m_dirtyMatrices) {
@@ -338,41 +391,58 @@ float View::fieldOfViewToFocalLength(float radians) {
 
 void View::updateMatrices() {
 
-    // find dimensions of tiles in world space at new zoom level
-    float worldTileSize = 2 * MapProjection::HALF_CIRCUMFERENCE * pow(2, -m_zoom);
+    // Scale-dependent terms; skipped during rotation-only changes
+    if (m_dirtyProjection) {
+
+        // find dimensions of tiles in world space at new zoom level
+        m_worldTileSize = 2 * MapProjection::HALF_CIRCUMFERENCE * pow(2, -m_zoom);
+
+        // viewport height in world space is such that each tile is [m_pixelsPerTile] px square in screen space
+        float screenTileSize = s_pixelsPerTile * m_pixelScale;
+        m_height = (float)m_vpHeight * m_worldTileSize / screenTileSize;
+        m_width = m_height * m_aspect;
 
-    // viewport height in world space is such that each tile is [m_pixelsPerTile] px square in screen space
-    float screenTileSize = s_pixelsPerTile * m_pixelScale;
-    m_height = (float)m_vpHeight * worldTileSize / screenTileSize;
-    m_width = m_height * m_aspect;
+        // set vertical field-of-view
+        m_fovy = getFieldOfView();
 
-    // set vertical field-of-view
-    float fovy = getFieldOfView();
+        // we assume portrait orientation by default, so in landscape
+        // mode we scale the vertical FOV such that the wider dimension
+        // gets the intended FOV
+        if (m_width > m_height) {
+            m_fovy /= m_aspect;
+        }
+
+        // set camera z to produce desired viewable area
+        m_pos.z = m_height * 0.5 / tan(m_fovy * 0.5);
+
+        m_dirtyProjection = false;
+    }
+
+    // Rotation-dependent terms; the trig here is what zoom-only eases skip
+    if (m_dirtyRotation) {
+
+        m_eyeDir = glm::rotateZ(glm::rotateX(glm::vec3(0.f, 0.f, 1.f), m_pitch), m_roll);
+        m_up = glm::rotateZ(glm::rotateX(glm::vec3(0.f, 1.f, 0.f), m_pitch), m_roll);
 
-    // we assume portrait orientation by default, so in landscape
-    // mode we scale the vertical FOV such that the wider dimension
-    // gets the intended FOV
-    if (m_width > m_height) {
-        fovy /= m_aspect;
+        m_dirtyRotation = false;
     }
 
-    // set camera z to produce desired viewable area
-    m_pos.z = m_height * 0.5 / tan(fovy * 0.5);
+    float fovy = m_fovy;
 
-    m_eye = glm::rotateZ(glm::rotateX(glm::vec3(0.f, 0.f, m_pos.z), m_pitch), m_roll);
+    m_eye = m_eyeDir * (float)m_pos.z;
     glm::vec3 at = { 0.f, 0.f, 0.f };
-    glm::vec3 up = glm::rotateZ(glm::rotateX(glm::vec3(0.f, 1.f, 0.f), m_pitch), m_roll);
 
     // Generate view matrix
-    m_view = glm::lookAt(m_eye, at, up);
+    m_view = glm::lookAt(m_eye, at, m_up);
 
-    float maxTileDistance = worldTileSize * invLodFunc(MAX_LOD + 1);
+    float maxTileDistance = m_worldTileSize * invLodFunc(MAX_LOD + 1);
     float near = m_pos.z / 50.f;
     float far = 1;
     float hw = 0.5 * m_width;
     float hh = 0.5 * m_height;
 
-    // Generate projection matrix based on camera type
+    // Generate projection matrix based on camera type; the far plane
+    // couples zoom and pitch, so this runs for either kind of change
     switch (m_type) {
         case CameraType::perspective:
             far = 2. * m_pos.z / std::max(0., cos(m_pitch + 0.5 * fovy));
@@ -429,11 +499,54 @@ glm::vec2 View::lonLatToScreenPosition(double lon, double lat, bool& clipped) {
     return screenPosition;
 }
 
+void View::lonLatToScreenPositions(const double* _lonLats, float* _screenPositions,
+                                   size_t _count, bool* _clipped) {
+
+    // The view state is fetched once; the per-coordinate work is a plain
+    // multiply-add chain that the compiler can vectorize.
+    const glm::mat4 viewProj = m_viewProj;
+    const glm::dvec2 origin(m_pos.x, m_pos.y);
+    const glm::vec2 screenSize(m_vpWidth, m_vpHeight);
+
+    for (size_t i = 0; i < _count; i++) {
+        glm::dvec2 meters = m_projection->LonLatToMeters({ _lonLats[2 * i],
+                                                           _lonLats[2 * i + 1] });
+        glm::vec4 world(glm::vec2(meters - origin), 0.f, 1.f);
+
+        bool clipped = false;
+        glm::vec2 screen = worldToScreenSpace(viewProj, world, screenSize, clipped);
+
+        _screenPositions[2 * i] = screen.x;
+        _screenPositions[2 * i + 1] = screen.y;
+        if (_clipped) { _clipped[i] = clipped; }
+    }
+}
+
+void View::screenPositionsToLonLats(double* _coordinates, size_t _count) {
+
+    if (m_dirtyMatrices) { updateMatrices(); }
+
+    for (size_t i = 0; i < _count; i++) {
+        double x = _coordinates[2 * i];
+        double y = _coordinates[2 * i + 1];
+
+        screenToGroundPlane(x, y);
+
+        glm::dvec2 lonLat = m_projection->MetersToLonLat({ x + m_pos.x, y + m_pos.y });
+        _coordinates[2 * i] = lonLat.x;
+        _coordinates[2 * i + 1] = lonLat.y;
+    }
+}
+
 void View::updateTiles() {
 
+    // Keep the last result around to detect whether the set changed.
+    std::swap(m_visibleTiles, m_lastVisibleTiles);
     m_visibleTiles.clear();
 
-    int zoom = int(m_zoom);
+    // A zoom bias selects coarser tiles than the view zoom would;
+    // rendering overzooms them like any other low-detail tile.
+    int zoom = std::max(int(m_zoom) - m_zoomBias, 0);
     int maxTileIndex = 1 << zoom;
 
     // Bounds of view trapezoid in world space (i.e. view frustum projected onto z = 0 plane)
@@ -449,6 +562,7 @@ void View::updateTiles() {
 
     // if all of our raycasts have a negative intersection distance, we have no area to cover
     if (t0 < .0 && t1 < 0. && t2 < 0. && t3 < 0.) {
+        m_visibleTilesChanged = !m_lastVisibleTiles.empty();
         return;
     }
 
@@ -473,10 +587,10 @@ void View::updateTiles() {
     // Scan options - avoid heap allocation for std::function
     // [1] http://www.drdobbs.com/cpp/efficient-use-of-lambda-expressions-and/232500059?pgno=2
     struct ScanParams {
-        ScanParams(std::set<TileID>& _tiles, int _zoom)
+        ScanParams(std::vector<TileID>& _tiles, int _zoom)
             : tiles(_tiles), zoom(_zoom) {}
 
-        std::set<TileID>& tiles;
+        std::vector<TileID>& tiles;
         int zoom;
         int maxZoom = int(s_maxZoom);
 
@@ -530,7 +644,7 @@ void View::updateTiles() {
         tile.w = (x - tile.x) >> opt.zoom; // wrap
 
         if (tile != opt.last) {
-            opt.tiles.emplace(tile.x, tile.y, tile.z, tile.z, tile.w);
+            opt.tiles.emplace_back(tile.x, tile.y, tile.z, tile.z, tile.w);
             opt.last = tile;
         }
     };
@@ -544,6 +658,14 @@ void View::updateTiles() {
     // (which should remain visible, even though the base of the tile is not).
     Rasterize::scanTriangle(a, b, e, 0, maxTileIndex, s);
 
+    // The scan callback only filters consecutive duplicates; sort the flat
+    // list and drop the remaining ones.
+    std::sort(m_visibleTiles.begin(), m_visibleTiles.end());
+    m_visibleTiles.erase(std::unique(m_visibleTiles.begin(), m_visibleTiles.end()),
+                         m_visibleTiles.end());
+
+    m_visibleTilesChanged = (m_visibleTiles != m_lastVisibleTiles);
+
     m_dirtyTiles = false;
 
 }
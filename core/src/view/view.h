@@ -8,8 +8,8 @@
 #include "util/mapProjection.h"
 #include "view/viewConstraint.h"
 
-#include <set>
 #include <memory>
+#include <vector>
 
 namespace Tangram {
 
@@ -107,12 +107,24 @@ public:
     /* Sets the zoom level of the view */
     void setZoom(float _z);
 
+    /* Selects tiles _bias zoom levels below the view zoom while leaving
+     * the rendered view itself unchanged; the coarser tiles are drawn
+     * overzoomed. Used by the adaptive resolution mode when bandwidth
+     * is low. */
+    void setZoomBias(int _bias);
+    int zoomBias() const { return m_zoomBias; }
+
     /* Sets the roll angle of the view in radians (default is 0) */
     void setRoll(float _rad);
 
     /* Sets the pitch angle of the view in radians (default is 0) */
     void setPitch(float _rad);
 
+    /* Sets position, zoom, roll and pitch together, with one dirty-state
+     * propagation. Equivalent to calling the individual setters in turn;
+     * meant for embedders driving the whole camera per animation frame. */
+    void setCameraState(double _x, double _y, float _zoom, float _roll, float _pitch);
+
     /* Moves the position of the view */
     void translate(double _dx, double _dy);
 
@@ -178,12 +190,35 @@ public:
     /* Gets the screen position from a latitude/longitude */
     glm::vec2 lonLatToScreenPosition(double lon, double lat, bool& clipped);
 
-    /* Returns the set of all tiles visible at the current position and zoom */
-    const std::set<TileID>& getVisibleTiles() { return m_visibleTiles; }
+    /* Converts _count interleaved (longitude, latitude) pairs to screen
+     * positions in one call, hoisting the view state out of the loop.
+     * When _clipped is given it receives one flag per coordinate; clipped
+     * coordinates get the screen position (0, 0) like the single-value
+     * overload. */
+    void lonLatToScreenPositions(const double* _lonLats, float* _screenPositions,
+                                 size_t _count, bool* _clipped = nullptr);
+
+    /* Converts _count interleaved screen (x, y) pairs to (longitude,
+     * latitude) in place. Coordinates whose ray misses the ground plane
+     * get the position where the ray's extension leaves it, matching
+     * screenToGroundPlane(). */
+    void screenPositionsToLonLats(double* _coordinates, size_t _count);
+
+    /* Returns all tiles visible at the current position and zoom, sorted by
+     * TileID ordering and free of duplicates */
+    const std::vector<TileID>& getVisibleTiles() { return m_visibleTiles; }
+
+    /* Returns true if the last call to update() changed the visible tile
+     * set; false for frames where the view only moved within the same tiles */
+    bool visibleTilesChanged() const { return m_visibleTilesChanged; }
 
     /* Returns true if the view properties have changed since the last call to update() */
     bool changedOnLastUpdate() const { return m_changed; }
 
+    /* Counter incremented whenever update() processes a view change; lets
+     * per-frame consumers skip work for frames with an unchanged view */
+    int64_t stateGeneration() const { return m_stateGeneration; }
+
     /* TODO: API for setting these */
     constexpr static float s_maxZoom = 20.5;
     constexpr static float s_minZoom = 0.0;
@@ -205,12 +240,17 @@ protected:
     std::shared_ptr<MapProjection> m_projection;
     std::shared_ptr<Stops> m_fovStops;
     std::shared_ptr<Stops> m_maxPitchStops;
-    std::set<TileID> m_visibleTiles;
+    std::vector<TileID> m_visibleTiles;
+    std::vector<TileID> m_lastVisibleTiles;
 
     ViewConstraint m_constraint;
 
     glm::dvec3 m_pos;
     glm::vec3 m_eye;
+    // Unit eye direction and up vector for the current pitch and roll;
+    // cached so zoom-only matrix updates skip the rotation trig.
+    glm::vec3 m_eyeDir = { 0.f, 0.f, 1.f };
+    glm::vec3 m_up = { 0.f, 1.f, 0.f };
     glm::vec2 m_obliqueAxis;
     glm::vec2 m_vanishingPoint;
 
@@ -227,6 +267,8 @@ protected:
 
     float m_zoom = 0.f;
 
+    int m_zoomBias = 0;
+
     float m_width;
     float m_height;
 
@@ -235,13 +277,23 @@ protected:
     float m_aspect;
     float m_pixelScale = 1.0f;
     float m_fov = 0.25 * PI;
+    float m_fovy = 0.f;
+    float m_worldTileSize = 0.f;
     float m_maxPitch = 0.5 * PI;
 
     CameraType m_type;
 
     bool m_dirtyMatrices;
+    // Sub-flags of m_dirtyMatrices: scale-dependent terms (zoom, viewport,
+    // field of view) and rotation-dependent terms (pitch, roll) are
+    // recomputed independently, so single-axis eases skip the other half.
+    bool m_dirtyProjection = true;
+    bool m_dirtyRotation = true;
     bool m_dirtyTiles;
     bool m_changed;
+    bool m_visibleTilesChanged = true;
+
+    int64_t m_stateGeneration = 1;
 
 };
 
@@ -34,6 +34,13 @@ auto ViewConstraint::getConstrainedY(double y) -> double {
 
 }
 
+bool ViewConstraint::isSatisfied(double x, double y) const {
+
+    return x - m_radius >= m_xMin && x + m_radius <= m_xMax &&
+           y - m_radius >= m_yMin && y + m_radius <= m_yMax;
+
+}
+
 auto ViewConstraint::getConstrainedScale() -> double {
 
     double xScale = 1.0, yScale = 1.0;
@@ -14,6 +14,10 @@ public:
     auto getConstrainedY(double y) -> double;
     auto getConstrainedScale() -> double;
 
+    /* True when the circle of the current radius around (x, y) lies fully
+     * inside the limits, i.e. the constraint would leave the view unchanged */
+    bool isSatisfied(double x, double y) const;
+
 private:
 
     auto constrain(double pos, double radius, double min, double max) -> double;
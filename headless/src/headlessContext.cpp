@@ -0,0 +1,101 @@
+#include "headlessContext.h"
+
+#include "platform_gl.h"
+#include "log.h"
+
+namespace Tangram {
+
+bool HeadlessContext::create(int _width, int _height) {
+
+    m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (m_display == EGL_NO_DISPLAY) {
+        LOGE("No EGL display available");
+        return false;
+    }
+
+    if (!eglInitialize(m_display, nullptr, nullptr)) {
+        LOGE("Failed to initialize EGL");
+        return false;
+    }
+
+    // The stencil buffer is required by the proxy-tile clip pass
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 16,
+        EGL_STENCIL_SIZE, 8,
+        EGL_NONE
+    };
+
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(m_display, configAttribs, &config, 1, &configCount) ||
+        configCount == 0) {
+        LOGE("No EGL config with pbuffer, depth and stencil support");
+        return false;
+    }
+
+    const EGLint surfaceAttribs[] = {
+        EGL_WIDTH, _width,
+        EGL_HEIGHT, _height,
+        EGL_NONE
+    };
+
+    m_surface = eglCreatePbufferSurface(m_display, config, surfaceAttribs);
+    if (m_surface == EGL_NO_SURFACE) {
+        LOGE("Failed to create %dx%d pbuffer surface", _width, _height);
+        return false;
+    }
+
+    eglBindAPI(EGL_OPENGL_ES_API);
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_CLIENT_VERSION, 2,
+        EGL_NONE
+    };
+
+    m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (m_context == EGL_NO_CONTEXT) {
+        LOGE("Failed to create ES2 context");
+        return false;
+    }
+
+    if (!eglMakeCurrent(m_display, m_surface, m_surface, m_context)) {
+        LOGE("Failed to make context current");
+        return false;
+    }
+
+    LOG("Headless context: %s on %s", glGetString(GL_VERSION), glGetString(GL_RENDERER));
+
+    return true;
+}
+
+void HeadlessContext::finishFrame() {
+    glFinish();
+}
+
+void HeadlessContext::destroy() {
+
+    if (m_display == EGL_NO_DISPLAY) { return; }
+
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    if (m_context != EGL_NO_CONTEXT) { eglDestroyContext(m_display, m_context); }
+    if (m_surface != EGL_NO_SURFACE) { eglDestroySurface(m_display, m_surface); }
+
+    eglTerminate(m_display);
+
+    m_display = EGL_NO_DISPLAY;
+    m_context = EGL_NO_CONTEXT;
+    m_surface = EGL_NO_SURFACE;
+}
+
+HeadlessContext::~HeadlessContext() {
+    destroy();
+}
+
+}
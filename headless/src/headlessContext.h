@@ -0,0 +1,37 @@
+#pragma once
+
+#include <EGL/egl.h>
+
+namespace Tangram {
+
+/* Offscreen EGL pbuffer context.
+ *
+ * Gives Map::render a real GL context without a window system, so CI
+ * machines with only a GPU driver (or a software renderer like Mesa
+ * llvmpipe) can run full update+render benchmarks and produce frames for
+ * golden-image comparison.
+ */
+class HeadlessContext {
+
+public:
+
+    ~HeadlessContext();
+
+    /* Create an ES2 pbuffer surface of the given size and make its
+     * context current. Returns false when no usable EGL config exists. */
+    bool create(int _width, int _height);
+
+    /* Block until all GL work submitted for the frame has finished;
+     * pbuffer surfaces have no swap to pace on. */
+    void finishFrame();
+
+    void destroy();
+
+private:
+
+    EGLDisplay m_display = EGL_NO_DISPLAY;
+    EGLContext m_context = EGL_NO_CONTEXT;
+    EGLSurface m_surface = EGL_NO_SURFACE;
+};
+
+}
@@ -0,0 +1,112 @@
+#include "tangram.h"
+#include "platform_headless.h"
+#include "headlessContext.h"
+#include "debug/sessionRecorder.h"
+#include "log.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace Tangram;
+
+// Headless runner for CI performance jobs: renders a scene to an
+// offscreen pbuffer for a fixed number of frames, optionally driving a
+// recorded interaction session, and reports the frame-time distribution.
+// With -o the final frame is written as raw RGBA for golden-image diffs.
+
+void printUsage() {
+    printf("usage: tangram-headless [options]\n"
+           "  -s <scene.yaml>   scene file (default scene.yaml)\n"
+           "  -w <width>        viewport width (default 800)\n"
+           "  -h <height>       viewport height (default 600)\n"
+           "  -f <frames>       frames to render after the view settles (default 180)\n"
+           "  -r <session>      replay a recorded interaction session\n"
+           "  -o <out.rgba>     write the final frame as raw RGBA\n");
+}
+
+int main(int argc, char* argv[]) {
+
+    const char* scenePath = "scene.yaml";
+    const char* sessionPath = nullptr;
+    const char* outputPath = nullptr;
+    int width = 800;
+    int height = 600;
+    int frames = 180;
+
+    for (int i = 1; i < argc - 1; i++) {
+        if (strcmp(argv[i], "-s") == 0) { scenePath = argv[++i]; }
+        else if (strcmp(argv[i], "-w") == 0) { width = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "-h") == 0) { height = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "-f") == 0) { frames = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "-r") == 0) { sessionPath = argv[++i]; }
+        else if (strcmp(argv[i], "-o") == 0) { outputPath = argv[++i]; }
+        else { printUsage(); return 1; }
+    }
+
+    HeadlessContext context;
+    if (!context.create(width, height)) {
+        return 1;
+    }
+
+    Map map;
+    map.loadScene(scenePath, true);
+    map.setupGL();
+    map.resize(width, height);
+
+    SessionReplay replay;
+    bool hasSession = sessionPath && replay.load(sessionPath);
+    if (sessionPath && !hasSession) { return 1; }
+
+    const float dt = 1.f / 60.f;
+
+    // Let tile loading and easings settle before measuring, so the timed
+    // frames cover a steady, reproducible view
+    for (int i = 0; i < 1000; i++) {
+        if (map.update(dt) && i > 0) { break; }
+        map.render();
+        context.finishFrame();
+    }
+
+    // Drop the settling frames from the histogram
+    map.getFrameStats();
+
+    bool more = true;
+    for (int i = 0; i < frames || (hasSession && more); i++) {
+        if (hasSession) { more = replay.step(map, dt); }
+        map.update(dt);
+        map.render();
+        context.finishFrame();
+    }
+
+    auto stats = map.getFrameStats();
+    printf("frames: %zu\n", stats.frameCount);
+    printf("frame time p50: %.2fms p95: %.2fms p99: %.2fms\n",
+           stats.p50Ms, stats.p95Ms, stats.p99Ms);
+    printf("dropped frames: %zu\n", stats.droppedFrames);
+    if (stats.worstFrameMs > 0.f) {
+        printf("worst frame: %.2fms (tiles loading: %zu, labels: %zu, pending uploads: %zu)\n",
+               stats.worstFrameMs, stats.worstFrameTilesLoading,
+               stats.worstFrameLabels, stats.worstFramePendingUploads);
+    }
+
+    if (outputPath) {
+        std::vector<unsigned int> pixels(width * height, 0);
+        map.captureSnapshot(pixels.data());
+
+        std::ofstream file(outputPath, std::ofstream::binary);
+        if (!file.is_open()) {
+            LOGE("Failed to write frame to path: %s", outputPath);
+            return 1;
+        }
+        file.write(reinterpret_cast<const char*>(pixels.data()),
+                   pixels.size() * sizeof(unsigned int));
+        printf("wrote %dx%d frame to %s\n", width, height, outputPath);
+    }
+
+    finishUrlRequests();
+    context.destroy();
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <fstream>
+#include <list>
+#include <string>
+
+#include "urlClient.h"
+#include "platform_headless.h"
+#include "platform_gl.h"
+#include "gl/hardware.h"
+
+#include <fcntl.h>
+#include <libgen.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include <EGL/egl.h>
+
+static bool s_isContinuousRendering = false;
+
+// Shared transport for all url requests, see urlClient.h
+static UrlClient s_urlClient;
+
+PFNGLBINDVERTEXARRAYOESPROC glBindVertexArrayOESEXT = 0;
+PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT = 0;
+PFNGLGENVERTEXARRAYSOESPROC glGenVertexArraysOESEXT = 0;
+PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinaryOESEXT = 0;
+PFNGLPROGRAMBINARYOESPROC glProgramBinaryOESEXT = 0;
+PFNGLGENQUERIESEXTPROC glGenQueriesEXTEXT = 0;
+PFNGLDELETEQUERIESEXTPROC glDeleteQueriesEXTEXT = 0;
+PFNGLBEGINQUERYEXTPROC glBeginQueryEXTEXT = 0;
+PFNGLENDQUERYEXTPROC glEndQueryEXTEXT = 0;
+PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuivEXTEXT = 0;
+PFNGLDISCARDFRAMEBUFFEREXTPROC glDiscardFramebufferEXTEXT = 0;
+
+void logMsg(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+}
+
+void requestRender() {
+    // The headless runner renders every frame; there is no event loop to
+    // wake up
+}
+
+void setContinuousRendering(bool _isContinuous) {
+
+    s_isContinuousRendering = _isContinuous;
+
+}
+
+bool isContinuousRendering() {
+
+    return s_isContinuousRendering;
+
+}
+
+std::string stringFromFile(const char* _path) {
+
+    size_t length = 0;
+    unsigned char* bytes = bytesFromFile(_path, length);
+    if (!bytes) { return {}; }
+
+    std::string out(reinterpret_cast<char*>(bytes), length);
+    free(bytes);
+
+    return out;
+}
+
+unsigned char* bytesFromFile(const char* _path, size_t& _size) {
+
+    std::ifstream resource(_path, std::ifstream::ate | std::ifstream::binary);
+
+    if(!resource.is_open()) {
+        logMsg("Failed to read file at path: %s\n", _path);
+        _size = 0;
+        return nullptr;
+    }
+
+    _size = resource.tellg();
+
+    resource.seekg(std::ifstream::beg);
+
+    char* cdata = (char*) malloc(sizeof(char) * (_size));
+
+    resource.read(cdata, _size);
+    resource.close();
+
+    return reinterpret_cast<unsigned char *>(cdata);
+}
+
+MappedFile mapFile(const char* _path) {
+
+    int fd = open(_path, O_RDONLY);
+    if (fd < 0) {
+        logMsg("Failed to open file at path: %s\n", _path);
+        return {};
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return {};
+    }
+
+    size_t size = st.st_size;
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        // Fall back to a heap copy
+        size_t length = 0;
+        unsigned char* bytes = bytesFromFile(_path, length);
+        if (!bytes) { return {}; }
+        return MappedFile(reinterpret_cast<const char*>(bytes), length,
+                          [](const char* _data, size_t) {
+                              free(const_cast<char*>(_data));
+                          });
+    }
+
+    return MappedFile(static_cast<const char*>(data), size,
+                      [](const char* _data, size_t _size) {
+                          munmap(const_cast<char*>(_data), _size);
+                      });
+}
+
+// No system fonts implementation (yet!)
+std::string systemFontPath(const std::string& _name, const std::string& _weight,
+                           const std::string& _face) {
+    return "";
+}
+
+// No system fonts fallback implementation (yet!)
+std::string systemFontFallbackPath(int _importance, int _weightHint) {
+    return "";
+}
+
+bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
+
+    return startUrlRequest(_url, UrlChunkCallback(), _callback);
+
+}
+
+bool startUrlRequest(const std::string& _url, UrlChunkCallback _onChunk, UrlCallback _callback) {
+
+    s_urlClient.enqueue(std::unique_ptr<UrlTask>(new UrlTask(_url, _callback, _onChunk)));
+    return true;
+
+}
+
+bool startUrlRequest(const std::string& _url, const std::string& _etag, UrlValidateCallback _callback) {
+
+    s_urlClient.enqueue(std::unique_ptr<UrlTask>(new UrlTask(_url, _etag, _callback)));
+    return true;
+
+}
+
+void cancelUrlRequest(const std::string& _url) {
+
+    s_urlClient.cancel(_url);
+}
+
+void prewarmUrlHost(const std::string& _url) {
+
+    s_urlClient.prewarm(_url);
+}
+
+void finishUrlRequests() {
+
+    s_urlClient.join();
+}
+
+void setCurrentThreadPriority(int priority){
+    int tid = syscall(SYS_gettid);
+
+    setpriority(PRIO_PROCESS, tid, priority);
+}
+
+void initGLExtensions() {
+
+    glBindVertexArrayOESEXT = (PFNGLBINDVERTEXARRAYOESPROC)eglGetProcAddress("glBindVertexArrayOES");
+    glDeleteVertexArraysOESEXT = (PFNGLDELETEVERTEXARRAYSOESPROC)eglGetProcAddress("glDeleteVertexArraysOES");
+    glGenVertexArraysOESEXT = (PFNGLGENVERTEXARRAYSOESPROC)eglGetProcAddress("glGenVertexArraysOES");
+    glGetProgramBinaryOESEXT = (PFNGLGETPROGRAMBINARYOESPROC)eglGetProcAddress("glGetProgramBinaryOES");
+    glProgramBinaryOESEXT = (PFNGLPROGRAMBINARYOESPROC)eglGetProcAddress("glProgramBinaryOES");
+    glGenQueriesEXTEXT = (PFNGLGENQUERIESEXTPROC)eglGetProcAddress("glGenQueriesEXT");
+    glDeleteQueriesEXTEXT = (PFNGLDELETEQUERIESEXTPROC)eglGetProcAddress("glDeleteQueriesEXT");
+    glBeginQueryEXTEXT = (PFNGLBEGINQUERYEXTPROC)eglGetProcAddress("glBeginQueryEXT");
+    glEndQueryEXTEXT = (PFNGLENDQUERYEXTPROC)eglGetProcAddress("glEndQueryEXT");
+    glGetQueryObjectuivEXTEXT = (PFNGLGETQUERYOBJECTUIVEXTPROC)eglGetProcAddress("glGetQueryObjectuivEXT");
+    glDiscardFramebufferEXTEXT = (PFNGLDISCARDFRAMEBUFFEREXTPROC)eglGetProcAddress("glDiscardFramebufferEXT");
+
+    Tangram::Hardware::supportsMapBuffer = true;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "platform.h"
+
+void finishUrlRequests();
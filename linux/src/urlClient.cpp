@@ -0,0 +1,273 @@
+#include "urlClient.h"
+#include "log.h"
+#include "util/bufferPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Up to this many connections are opened before transfers queue on
+// existing ones; against an HTTP/2 host a whole viewport of tile
+// requests shares a single connection anyway (see CURLOPT_PIPEWAIT).
+#define MAX_TOTAL_CONNECTIONS 8L
+
+static size_t write_data(void *_buffer, size_t _size, size_t _nmemb, void *_dataPtr) {
+
+    const size_t realSize = _size * _nmemb;
+
+    UrlTask* task = (UrlTask*)_dataPtr;
+
+    // curl inflates gzip-encoded payloads incrementally, so each chunk
+    // arrives here already decompressed while the transfer is running.
+    task->content.insert(task->content.end(),
+                         (const char*)_buffer, (const char*)_buffer + realSize);
+
+    if (task->onChunk) {
+        task->onChunk((const char*)_buffer, realSize);
+    }
+
+    return realSize;
+}
+
+static size_t header_data(char* _buffer, size_t _size, size_t _nitems, void* _dataPtr) {
+
+    const size_t realSize = _size * _nitems;
+
+    UrlTask* task = (UrlTask*)_dataPtr;
+
+    // Capture the ETag response header as validator for later
+    // conditional requests of the same URL.
+    const char name[] = "etag:";
+    const size_t nameLength = sizeof(name) - 1;
+
+    if (realSize > nameLength && strncasecmp(_buffer, name, nameLength) == 0) {
+        const char* begin = _buffer + nameLength;
+        const char* end = _buffer + realSize;
+        while (begin < end && (*begin == ' ' || *begin == '\t')) { begin++; }
+        while (end > begin && (end[-1] == '\r' || end[-1] == '\n' ||
+                               end[-1] == ' ' || end[-1] == '\t')) { end--; }
+        task->responseEtag.assign(begin, end);
+    }
+
+    return realSize;
+}
+
+UrlClient::UrlClient() {
+
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    m_multiHandle = curl_multi_init();
+
+#if LIBCURL_VERSION_NUM >= 0x072B00 // 7.43.0
+    // Multiplex concurrent transfers to the same host over one connection
+    curl_multi_setopt(m_multiHandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+    curl_multi_setopt(m_multiHandle, CURLMOPT_MAX_TOTAL_CONNECTIONS, MAX_TOTAL_CONNECTIONS);
+
+    m_thread = std::thread(&UrlClient::run, this);
+}
+
+UrlClient::~UrlClient() {
+
+    join();
+
+    curl_multi_cleanup(m_multiHandle);
+    curl_global_cleanup();
+}
+
+void UrlClient::enqueue(std::unique_ptr<UrlTask> _task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) { return; }
+
+        m_pending.push_back(std::move(_task));
+    }
+#if LIBCURL_VERSION_NUM >= 0x074400 // 7.68.0
+    curl_multi_wakeup(m_multiHandle);
+#endif
+}
+
+void UrlClient::prewarm(const std::string& _url) {
+
+    enqueue(std::unique_ptr<UrlTask>(new UrlTask(_url)));
+}
+
+void UrlClient::cancel(const std::string& _url) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = std::find_if(m_pending.begin(), m_pending.end(),
+                           [&](const auto& task) { return task->url == _url; });
+    if (it != m_pending.end()) {
+        m_pending.erase(it);
+        return;
+    }
+
+    // Picked up by the transport thread, which aborts the transfer
+    m_canceled.push_back(_url);
+}
+
+void UrlClient::join() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) { return; }
+
+        m_running = false;
+        m_pending.clear();
+    }
+#if LIBCURL_VERSION_NUM >= 0x074400 // 7.68.0
+    curl_multi_wakeup(m_multiHandle);
+#endif
+    m_thread.join();
+}
+
+void UrlClient::startPendingTasks() {
+
+    std::list<std::unique_ptr<UrlTask>> pending;
+    std::list<std::string> canceled;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pending.swap(m_pending);
+        canceled.swap(m_canceled);
+    }
+
+    for (auto& url : canceled) {
+        auto it = std::find_if(m_transfers.begin(), m_transfers.end(),
+                               [&](const auto& t) { return t.task->url == url; });
+        if (it != m_transfers.end()) {
+            curl_multi_remove_handle(m_multiHandle, it->handle);
+            if (it->requestHeaders) { curl_slist_free_all(it->requestHeaders); }
+            curl_easy_cleanup(it->handle);
+            m_transfers.erase(it);
+        }
+    }
+
+    for (auto& task : pending) {
+
+        // The response lands in a recycled buffer; its capacity returns
+        // to the pool when the tile's raw data is finally dropped.
+        task->content = Tangram::BufferPool::acquire();
+
+        CURL* handle = curl_easy_init();
+
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, write_data);
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, task.get());
+        curl_easy_setopt(handle, CURLOPT_URL, task->url.c_str());
+        curl_easy_setopt(handle, CURLOPT_HEADER, 0L);
+        curl_easy_setopt(handle, CURLOPT_VERBOSE, 0L);
+        curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "gzip");
+        curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+
+#if LIBCURL_VERSION_NUM >= 0x072F00 // 7.47.0
+        // Negotiate HTTP/2 where the server offers it over TLS
+        curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif
+#if LIBCURL_VERSION_NUM >= 0x072B00 // 7.43.0
+        // Wait for a multiplexed connection to the host instead of
+        // opening another one
+        curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+#endif
+
+        if (!task->callback && !task->validateCallback) {
+            // Prewarm: the handshakes are the point, not the response
+            curl_easy_setopt(handle, CURLOPT_NOBODY, 1L);
+        }
+
+        struct curl_slist* requestHeaders = nullptr;
+
+        if (task->validateCallback) {
+            if (!task->etag.empty()) {
+                std::string header = "If-None-Match: " + task->etag;
+                requestHeaders = curl_slist_append(requestHeaders, header.c_str());
+                curl_easy_setopt(handle, CURLOPT_HTTPHEADER, requestHeaders);
+            }
+            curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, header_data);
+            curl_easy_setopt(handle, CURLOPT_HEADERDATA, task.get());
+        }
+
+        LOGD("Fetching URL: %s", task->url.c_str());
+
+        curl_multi_add_handle(m_multiHandle, handle);
+
+        m_transfers.push_back({handle, requestHeaders, std::move(task)});
+    }
+}
+
+void UrlClient::finishTransfer(CURL* _handle, CURLcode _result) {
+
+    auto it = std::find_if(m_transfers.begin(), m_transfers.end(),
+                           [&](const auto& t) { return t.handle == _handle; });
+    if (it == m_transfers.end()) { return; }
+
+    auto task = std::move(it->task);
+
+    long httpStatusCode = 0;
+    curl_easy_getinfo(_handle, CURLINFO_RESPONSE_CODE, &httpStatusCode);
+
+    curl_multi_remove_handle(m_multiHandle, _handle);
+    if (it->requestHeaders) { curl_slist_free_all(it->requestHeaders); }
+    curl_easy_cleanup(_handle);
+    m_transfers.erase(it);
+
+    if (task->validateCallback) {
+        if (_result == CURLE_OK && httpStatusCode == 304) {
+            // The cached copy named by the request validator is still
+            // current - no body was transferred.
+            task->validateCallback({}, std::string(), true);
+        } else {
+            if (_result != CURLE_OK || httpStatusCode != 200) {
+                LOGE("curl transfer failed: %s - %d",
+                     curl_easy_strerror(_result), httpStatusCode);
+                task->content.clear();
+            }
+            task->validateCallback(std::move(task->content),
+                                   std::move(task->responseEtag), false);
+        }
+    } else if (task->callback) {
+        if (_result != CURLE_OK || httpStatusCode != 200) {
+            LOGE("curl transfer failed: %s - %d",
+                 curl_easy_strerror(_result), httpStatusCode);
+            task->content.clear();
+        }
+
+        task->callback(std::move(task->content));
+    } else {
+        // Prewarm connected regardless of the response status
+        LOGD("Prewarmed %s: %d", task->url.c_str(), httpStatusCode);
+        return;
+    }
+
+    requestRender();
+}
+
+void UrlClient::run() {
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_running && m_pending.empty() && m_transfers.empty()) {
+                break;
+            }
+        }
+
+        startPendingTasks();
+
+        int activeCount = 0;
+        curl_multi_perform(m_multiHandle, &activeCount);
+
+        CURLMsg* message = nullptr;
+        int messagesLeft = 0;
+        while ((message = curl_multi_info_read(m_multiHandle, &messagesLeft))) {
+            if (message->msg == CURLMSG_DONE) {
+                finishTransfer(message->easy_handle, message->data.result);
+            }
+        }
+
+        int numfds = 0;
+#if LIBCURL_VERSION_NUM >= 0x074400 // 7.68.0: woken by curl_multi_wakeup
+        curl_multi_poll(m_multiHandle, nullptr, 0, 1000, &numfds);
+#else
+        // Without wakeup support newly enqueued tasks are only picked up
+        // on the next iteration, so keep the wait short
+        curl_multi_wait(m_multiHandle, nullptr, 0, 100, &numfds);
+#endif
+    }
+}
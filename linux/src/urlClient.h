@@ -0,0 +1,98 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "platform.h"
+
+#include <curl/curl.h>
+
+struct UrlTask {
+    UrlCallback callback;
+    UrlChunkCallback onChunk;
+    UrlValidateCallback validateCallback;
+    const std::string url;
+    std::string etag;
+    std::string responseEtag;
+    std::vector<char> content;
+
+    UrlTask(UrlTask&& _other) :
+        callback(std::move(_other.callback)),
+        onChunk(std::move(_other.onChunk)),
+        validateCallback(std::move(_other.validateCallback)),
+        url(std::move(_other.url)),
+        etag(std::move(_other.etag)),
+        responseEtag(std::move(_other.responseEtag)),
+        content(std::move(_other.content)) {
+    }
+
+    UrlTask(const std::string& _url, const UrlCallback& _callback,
+            const UrlChunkCallback& _onChunk = UrlChunkCallback()) :
+        callback(_callback),
+        onChunk(_onChunk),
+        url(_url) {
+    }
+
+    UrlTask(const std::string& _url, const std::string& _etag,
+            const UrlValidateCallback& _callback) :
+        validateCallback(_callback),
+        url(_url),
+        etag(_etag) {
+    }
+
+    /* A prewarm request: no callbacks, performed without a body */
+    explicit UrlTask(const std::string& _url) : url(_url) {}
+};
+
+/* Shared HTTP transport for all url requests: a single curl multi handle
+ * drives every transfer on one thread, so requests to the same host
+ * multiplex as parallel streams over one HTTP/2 connection (or reuse a
+ * kept-alive HTTP/1.1 connection) instead of each transfer paying
+ * connection setup or queueing behind a small pool of handles. */
+class UrlClient {
+    public:
+        UrlClient();
+        ~UrlClient();
+
+        void enqueue(std::unique_ptr<UrlTask> _task);
+
+        /* Open (or refresh) a connection to the host of _url ahead of the
+         * first real request, so DNS, TCP and TLS handshakes overlap other
+         * loading work. Implemented as a bodyless request whose connection
+         * returns to the pool for the fetches that follow. */
+        void prewarm(const std::string& _url);
+
+        /* Drop the request for _url, whether it is still pending or
+         * already transferring */
+        void cancel(const std::string& _url);
+
+        /* Finish running transfers, drop pending ones and stop the
+         * transport thread; enqueue becomes a no-op afterwards */
+        void join();
+
+    private:
+        struct Transfer {
+            CURL* handle = nullptr;
+            struct curl_slist* requestHeaders = nullptr;
+            std::unique_ptr<UrlTask> task;
+        };
+
+        void run();
+        void startPendingTasks();
+        void finishTransfer(CURL* _handle, CURLcode _result);
+
+        CURLM* m_multiHandle = nullptr;
+
+        std::mutex m_mutex;
+        std::list<std::unique_ptr<UrlTask>> m_pending;
+        std::list<std::string> m_canceled;
+        bool m_running = true;
+
+        /* Only touched on the transport thread */
+        std::vector<Transfer> m_transfers;
+
+        std::thread m_thread;
+};
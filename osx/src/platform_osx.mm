@@ -92,6 +92,24 @@ unsigned char* bytesFromFile(const char* _path, size_t& _size) {
     return ptr;
 }
 
+MappedFile mapFile(const char* _path) {
+
+    NSString* path = resolvePath(_path);
+    NSData* data = [NSData dataWithContentsOfFile:path
+                                          options:NSDataReadingMappedIfSafe
+                                            error:NULL];
+
+    if (data == nil) {
+        LOGW("Failed to map file at path: %s", [path UTF8String]);
+        return {};
+    }
+
+    // The view retains the NSData, which owns the mapping
+    CFDataRef retained = (CFDataRef)CFBridgingRetain(data);
+    return MappedFile((const char*)[data bytes], [data length],
+                      [retained](const char*, size_t) { CFRelease(retained); });
+}
+
 // No system fonts implementation (yet!)
 std::string systemFontPath(const std::string& _name, const std::string& _weight, const std::string& _face) {
     return "";
@@ -166,6 +184,27 @@ bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
 
 }
 
+bool startUrlRequest(const std::string& _url, UrlChunkCallback _onChunk, UrlCallback _callback) {
+
+    // NSURLSession delivers complete responses here, so the body is handed
+    // over as a single chunk before the completion callback.
+    return startUrlRequest(_url, [_onChunk, _callback](std::vector<char>&& _data) {
+        if (_onChunk && !_data.empty()) { _onChunk(_data.data(), _data.size()); }
+        _callback(std::move(_data));
+    });
+
+}
+
+bool startUrlRequest(const std::string& _url, const std::string& _etag, UrlValidateCallback _callback) {
+
+    // No conditional request support here yet - revalidation falls back to
+    // a full fetch without a response validator.
+    return startUrlRequest(_url, [_callback](std::vector<char>&& _data) {
+        _callback(std::move(_data), std::string(), false);
+    });
+
+}
+
 void cancelUrlRequest(const std::string& _url) {
 
     NSString* nsUrl = [NSString stringWithUTF8String:_url.c_str()];
@@ -180,6 +219,17 @@ void cancelUrlRequest(const std::string& _url) {
     }];
 }
 
+void prewarmUrlHost(const std::string& _url) {
+
+    NSString* nsUrl = [NSString stringWithUTF8String:_url.c_str()];
+    NSMutableURLRequest* request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:nsUrl]];
+    request.HTTPMethod = @"HEAD";
+
+    // The handshakes are the point; the response is discarded and the
+    // connection returns to the session's pool
+    [[defaultSession dataTaskWithRequest:request] resume];
+}
+
 void finishUrlRequests() {
 
     {
@@ -56,8 +56,6 @@ int main(int argc, char **argv){
     while (bUpdate) {
         updateGL();
 
-        processNetworkQueue();
-
         if (getRenderRequest()) {
             setRenderRequest(false);
             newFrame();
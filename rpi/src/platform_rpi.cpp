@@ -1,10 +1,14 @@
 #include "platform.h"
 #include "gl.h"
 #include "context.h"
-#include "urlWorker.h"
+#include "urlClient.h"
 
+#include <fcntl.h>
 #include <libgen.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <stdarg.h>
 #include <iostream>
 #include <fstream>
@@ -13,12 +17,10 @@
 
 #include <regex>
 
-#define NUM_WORKERS 3
-
 static bool s_isContinuousRendering = false;
 
-static UrlWorker s_Workers[NUM_WORKERS];
-static std::list<std::unique_ptr<UrlTask>> s_urlTaskQueue;
+// Shared transport for all url requests, see urlClient.h
+static UrlClient s_urlClient;
 
 void logMsg(const char* fmt, ...) {
     va_list args;
@@ -27,20 +29,6 @@ void logMsg(const char* fmt, ...) {
     va_end(args);
 }
 
-void processNetworkQueue() {
-    // attach workers to NetWorkerData
-    auto taskItr = s_urlTaskQueue.begin();
-    for(auto& worker : s_Workers) {
-        if(taskItr == s_urlTaskQueue.end()) {
-            break;
-        }
-        if(worker.isAvailable()) {
-            worker.perform(std::move(*taskItr));
-            taskItr = s_urlTaskQueue.erase(taskItr);
-        }
-    }
-}
-
 void requestRender() {
     setRenderRequest(true);
 }
@@ -86,6 +74,41 @@ unsigned char* bytesFromFile(const char* _path, size_t& _size) {
     return reinterpret_cast<unsigned char *>(cdata);
 }
 
+MappedFile mapFile(const char* _path) {
+
+    int fd = open(_path, O_RDONLY);
+    if (fd < 0) {
+        logMsg("Failed to open file at path: %s\n", _path);
+        return {};
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return {};
+    }
+
+    size_t size = st.st_size;
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        // Fall back to a heap copy
+        size_t length = 0;
+        unsigned char* bytes = bytesFromFile(_path, length);
+        if (!bytes) { return {}; }
+        return MappedFile(reinterpret_cast<const char*>(bytes), length,
+                          [](const char* _data, size_t) {
+                              free(const_cast<char*>(_data));
+                          });
+    }
+
+    return MappedFile(static_cast<const char*>(data), size,
+                      [](const char* _data, size_t _size) {
+                          munmap(const_cast<char*>(_data), _size);
+                      });
+}
+
 // No system fonts implementation (yet!)
 std::string systemFontPath(const std::string& _name, const std::string& _weight,
                            const std::string& _face) {
@@ -99,30 +122,32 @@ std::string systemFontFallbackPath(int _importance, int _weightHint) {
 
 bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
 
-    std::unique_ptr<UrlTask> task(new UrlTask(_url, _callback));
-    for(auto& worker : s_Workers) {
-        if(worker.isAvailable()) {
-            worker.perform(std::move(task));
-            return true;
-        }
-    }
-    s_urlTaskQueue.push_back(std::move(task));
+    return startUrlRequest(_url, UrlChunkCallback(), _callback);
+
+}
+
+bool startUrlRequest(const std::string& _url, UrlChunkCallback _onChunk, UrlCallback _callback) {
+
+    s_urlClient.enqueue(std::unique_ptr<UrlTask>(new UrlTask(_url, _callback, _onChunk)));
+    return true;
+
+}
+
+bool startUrlRequest(const std::string& _url, const std::string& _etag, UrlValidateCallback _callback) {
+
+    s_urlClient.enqueue(std::unique_ptr<UrlTask>(new UrlTask(_url, _etag, _callback)));
     return true;
 
 }
 
 void cancelUrlRequest(const std::string& _url) {
 
-    // Only clear this request if a worker has not started operating on it!
-    // otherwise it gets too convoluted with curl!
-    auto itr = s_urlTaskQueue.begin();
-    while(itr != s_urlTaskQueue.end()) {
-        if((*itr)->url == _url) {
-            itr = s_urlTaskQueue.erase(itr);
-        } else {
-            itr++;
-        }
-    }
+    s_urlClient.cancel(_url);
+}
+
+void prewarmUrlHost(const std::string& _url) {
+
+    s_urlClient.prewarm(_url);
 }
 
 void setCurrentThreadPriority(int priority) {}
@@ -8,4 +8,3 @@
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 
-void processNetworkQueue();
@@ -83,6 +83,8 @@ GLint GL::getUniformLocation(GLuint program, const GLchar *name) {
 GLint GL::getAttribLocation(GLuint program, const GLchar *name) {
     return 0;
 }
+void GL::bindAttribLocation(GLuint program, GLuint index, const GLchar *name) {
+}
 void GL::getProgramiv(GLuint program, GLenum pname, GLint *params) {
 }
 void GL::getShaderiv(GLuint shader, GLenum pname, GLint *params) {
@@ -197,5 +199,16 @@ void GL::deleteVertexArrays(GLsizei n, const GLuint *arrays) {
 void GL::genVertexArrays(GLsizei n, GLuint *arrays) {
 }
 
+// timer queries
+void GL::genQueries(GLsizei n, GLuint *queries) {
+}
+void GL::deleteQueries(GLsizei n, const GLuint *queries) {
+}
+void GL::beginQuery(GLenum target, GLuint query) {
+}
+void GL::endQuery(GLenum target) {
+}
+void GL::getQueryObjectuiv(GLuint query, GLenum pname, GLuint *params) {
+}
 
 }
@@ -62,6 +62,19 @@ unsigned char* bytesFromFile(const char* _path, size_t& _size) {
     return reinterpret_cast<unsigned char *>(cdata);
 }
 
+MappedFile mapFile(const char* _path) {
+
+    // Tests read so little that a heap copy is fine
+    size_t length = 0;
+    unsigned char* bytes = bytesFromFile(_path, length);
+    if (!bytes) { return {}; }
+
+    return MappedFile(reinterpret_cast<const char*>(bytes), length,
+                      [](const char* _data, size_t) {
+                          free(const_cast<char*>(_data));
+                      });
+}
+
 // No system fonts implementation (yet!)
 std::string systemFontPath(const std::string& _name, const std::string& _weight, const std::string& _face) {
     return "";
@@ -75,9 +88,20 @@ bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
     return true;
 }
 
+bool startUrlRequest(const std::string& _url, UrlChunkCallback _onChunk, UrlCallback _callback) {
+    return true;
+}
+
+bool startUrlRequest(const std::string& _url, const std::string& _etag, UrlValidateCallback _callback) {
+    return true;
+}
+
 void cancelUrlRequest(const std::string& _url) {
 }
 
+void prewarmUrlHost(const std::string& _url) {
+}
+
 void setCurrentThreadPriority(int priority){
 }
 
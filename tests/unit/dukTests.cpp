@@ -366,3 +366,36 @@ TEST_CASE( "Test evalFunction explicit", "[Duktape][evalFunction]") {
     }
 
 }
+
+TEST_CASE( "Test native shortcuts for trivial functions", "[Duktape][nativeFn]") {
+    Feature feature;
+    feature.props.set("kind", "park");
+    feature.props.set("area", "42");
+
+    StyleContext ctx;
+    ctx.setFeature(feature);
+    ctx.setKeyword("$zoom", 14);
+
+    // Bracket property lookup
+    REQUIRE(ctx.setFunctions({ R"(function() { return feature['kind'] == 'park'; })"}));
+    REQUIRE(ctx.evalFilter(0) == true);
+
+    // Loose equality coerces numeric strings, strict does not
+    REQUIRE(ctx.setFunctions({
+                R"(function() { return feature.area == 42; })",
+                R"(function() { return feature.area === 42; })"}));
+    REQUIRE(ctx.evalFilter(0) == true);
+    REQUIRE(ctx.evalFilter(1) == false);
+
+    // Two-way $zoom ternary
+    REQUIRE(ctx.setFunctions({ R"(function() { return $zoom >= 14 ? 5 : 2; })"}));
+
+    StyleParam::Value value;
+    REQUIRE(ctx.evalStyle(0, StyleParamKey::width, value) == true);
+    REQUIRE(value.is<StyleParam::Width>() == true);
+    REQUIRE(value.get<StyleParam::Width>().value == 5);
+
+    ctx.setKeyword("$zoom", 10);
+    REQUIRE(ctx.evalStyle(0, StyleParamKey::width, value) == true);
+    REQUIRE(value.get<StyleParam::Width>().value == 2);
+}
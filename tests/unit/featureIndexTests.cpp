@@ -0,0 +1,94 @@
+#include "catch.hpp"
+
+#include "data/tileData.h"
+#include "tile/featureIndex.h"
+
+using namespace Tangram;
+
+namespace {
+
+Feature makePolygon(glm::vec2 _min, glm::vec2 _max, const std::string& _name) {
+    Feature feature;
+    feature.geometryType = GeometryType::polygons;
+    feature.polygons.push_back({{
+        { _min.x, _min.y, 0.f },
+        { _max.x, _min.y, 0.f },
+        { _max.x, _max.y, 0.f },
+        { _min.x, _max.y, 0.f },
+        { _min.x, _min.y, 0.f },
+    }});
+    feature.props.set("name", _name);
+    return feature;
+}
+
+}
+
+TEST_CASE( "Query returns features containing the point", "[FeatureIndex]" ) {
+
+    FeatureIndex index;
+    index.add(makePolygon({ 0.0f, 0.0f }, { 0.4f, 0.4f }, "a"));
+    index.add(makePolygon({ 0.6f, 0.6f }, { 1.0f, 1.0f }, "b"));
+    index.build();
+
+    std::vector<FeatureIndex::Result> results;
+    index.query({ 0.2f, 0.2f }, 0.01f, results);
+
+    REQUIRE(results.size() == 1);
+    REQUIRE(results[0].first->properties->getString("name") == "a");
+    REQUIRE(results[0].second == 0.f);
+
+    results.clear();
+    index.query({ 0.5f, 0.5f }, 0.01f, results);
+    REQUIRE(results.empty());
+}
+
+TEST_CASE( "Query radius reaches nearby features", "[FeatureIndex]" ) {
+
+    FeatureIndex index;
+    index.add(makePolygon({ 0.0f, 0.0f }, { 0.4f, 0.4f }, "a"));
+    index.build();
+
+    std::vector<FeatureIndex::Result> results;
+    index.query({ 0.5f, 0.2f }, 0.2f, results);
+
+    REQUIRE(results.size() == 1);
+    // Distance to the box edge, in tile units
+    REQUIRE(results[0].second == Approx(0.1f));
+}
+
+TEST_CASE( "Query matches a linear scan over many features", "[FeatureIndex]" ) {
+
+    FeatureIndex index;
+
+    // A 16x16 grid of small boxes, enough for several tree levels
+    for (int y = 0; y < 16; y++) {
+        for (int x = 0; x < 16; x++) {
+            glm::vec2 min(x / 16.f, y / 16.f);
+            index.add(makePolygon(min, min + 1.f / 32.f,
+                                  std::to_string(x) + "/" + std::to_string(y)));
+        }
+    }
+    index.build();
+
+    std::vector<FeatureIndex::Result> results;
+    index.query({ 0.5f, 0.5f }, 0.06f, results);
+
+    // The query box spans x and y in [0.44..0.56], overlapping only the
+    // boxes of columns and rows 7 and 8
+    REQUIRE(results.size() == 4);
+    for (auto& result : results) {
+        auto name = result.first->properties->getString("name");
+        REQUIRE((name == "7/7" || name == "7/8" || name == "8/7" || name == "8/8"));
+    }
+}
+
+TEST_CASE( "Empty and pointless features are not indexed", "[FeatureIndex]" ) {
+
+    FeatureIndex index;
+
+    Feature feature;
+    feature.geometryType = GeometryType::polygons;
+    index.add(feature);
+
+    REQUIRE(index.empty());
+}
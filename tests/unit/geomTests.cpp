@@ -0,0 +1,111 @@
+#include "catch.hpp"
+
+#include "glm/glm.hpp"
+#include "util/geom.h"
+
+#include <vector>
+
+using namespace Tangram;
+
+TEST_CASE( "Simplification keeps endpoints and significant points", "[GEOM][SIMPLIFY]" ) {
+
+    std::vector<glm::vec3> line = {
+        { 0.0, 0.0, 0.0 },
+        { 0.25, 0.001, 0.0 },
+        { 0.5, 0.2, 0.0 },
+        { 0.75, 0.001, 0.0 },
+        { 1.0, 0.0, 0.0 },
+    };
+
+    simplifyLine(line, 0.01f);
+
+    // The near-collinear points are dropped, the corner survives
+    REQUIRE(line.size() == 3);
+    REQUIRE(line[0] == glm::vec3(0.0, 0.0, 0.0));
+    REQUIRE(line[1] == glm::vec3(0.5, 0.2, 0.0));
+    REQUIRE(line[2] == glm::vec3(1.0, 0.0, 0.0));
+}
+
+TEST_CASE( "Simplification leaves detailed lines untouched", "[GEOM][SIMPLIFY]" ) {
+
+    std::vector<glm::vec3> line = {
+        { 0.0, 0.0, 0.0 },
+        { 0.25, 0.2, 0.0 },
+        { 0.5, -0.2, 0.0 },
+        { 0.75, 0.2, 0.0 },
+        { 1.0, 0.0, 0.0 },
+    };
+
+    auto original = line;
+    simplifyLine(line, 0.01f);
+
+    REQUIRE(line == original);
+}
+
+TEST_CASE( "Line clipping splits a line leaving and re-entering the bounds", "[GEOM][CLIP]" ) {
+
+    std::vector<glm::vec3> line = {
+        { 0.5, 0.5, 0.0 },
+        { 1.5, 0.5, 0.0 },
+        { 1.5, 0.75, 0.0 },
+        { 0.5, 0.75, 0.0 },
+    };
+
+    std::vector<std::vector<glm::vec3>> pieces;
+    clipLine(line, 0.f, 1.f, pieces);
+
+    REQUIRE(pieces.size() == 2);
+    REQUIRE(pieces[0].size() == 2);
+    REQUIRE(pieces[0][0] == glm::vec3(0.5, 0.5, 0.0));
+    REQUIRE(pieces[0][1] == glm::vec3(1.0, 0.5, 0.0));
+    REQUIRE(pieces[1].size() == 2);
+    REQUIRE(pieces[1][0] == glm::vec3(1.0, 0.75, 0.0));
+    REQUIRE(pieces[1][1] == glm::vec3(0.5, 0.75, 0.0));
+}
+
+TEST_CASE( "Line clipping drops a line entirely outside the bounds", "[GEOM][CLIP]" ) {
+
+    std::vector<glm::vec3> line = {
+        { 2.0, 0.0, 0.0 },
+        { 2.0, 1.0, 0.0 },
+    };
+
+    std::vector<std::vector<glm::vec3>> pieces;
+    clipLine(line, 0.f, 1.f, pieces);
+
+    REQUIRE(pieces.empty());
+}
+
+TEST_CASE( "Ring clipping reduces an oversized ring to the bounds", "[GEOM][CLIP]" ) {
+
+    std::vector<glm::vec3> ring = {
+        { -2.0, -2.0, 0.0 },
+        {  3.0, -2.0, 0.0 },
+        {  3.0,  3.0, 0.0 },
+        { -2.0,  3.0, 0.0 },
+        { -2.0, -2.0, 0.0 },
+    };
+
+    clipPolygonRing(ring, 0.f, 1.f);
+
+    // Closed on input, so closed on output: 4 corners plus the repeat
+    REQUIRE(ring.size() == 5);
+    REQUIRE(ring.front() == ring.back());
+    for (auto& p : ring) {
+        REQUIRE(p.x >= 0.f); REQUIRE(p.x <= 1.f);
+        REQUIRE(p.y >= 0.f); REQUIRE(p.y <= 1.f);
+    }
+}
+
+TEST_CASE( "Ring clipping empties a ring outside the bounds", "[GEOM][CLIP]" ) {
+
+    std::vector<glm::vec3> ring = {
+        { 2.0, 2.0, 0.0 },
+        { 3.0, 2.0, 0.0 },
+        { 3.0, 3.0, 0.0 },
+    };
+
+    clipPolygonRing(ring, 0.f, 1.f);
+
+    REQUIRE(ring.empty());
+}
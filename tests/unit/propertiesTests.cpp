@@ -0,0 +1,72 @@
+#include "catch.hpp"
+
+#include "data/properties.h"
+#include "data/propertyItem.h"
+
+using namespace Tangram;
+
+TEST_CASE( "Compacted string values stay readable", "[Core][Properties]" ) {
+
+    Properties props;
+    props.set("name", "A rather long street name somewhere");
+    props.set("kind", "motorway");
+    props.set("sort_rank", 377.0);
+
+    props.compact();
+
+    REQUIRE(props.getString("name") == "A rather long street name somewhere");
+    REQUIRE(props.getString("kind") == "motorway");
+    REQUIRE(props.getNumber("sort_rank") == 377.0);
+
+    // String values are views into the shared buffer now.
+    REQUIRE(props.get("kind").is<StringView>());
+    REQUIRE(props.get("sort_rank").is<double>());
+}
+
+TEST_CASE( "Copies of compacted Properties share the buffer safely", "[Core][Properties]" ) {
+
+    Properties copy;
+    {
+        Properties props;
+        props.set("kind", "residential");
+        props.compact();
+        copy = props;
+    }
+
+    // The original is gone; the copy keeps the backing buffer alive.
+    REQUIRE(copy.getString("kind") == "residential");
+}
+
+TEST_CASE( "Lookups stay consistent as items are inserted and overwritten", "[Core][Properties]" ) {
+
+    Properties props;
+    props.set("zz", 1.0);
+    props.set("a", 2.0);
+    props.set("landuse_kind", "park");
+    props.set("a", 3.0);
+
+    REQUIRE(props.getNumber("zz") == 1.0);
+    REQUIRE(props.getNumber("a") == 3.0);
+    REQUIRE(props.getString("landuse_kind") == "park");
+    REQUIRE(!props.contains("b"));
+
+    // Items end up in the canonical ordering regardless of insertion order.
+    Properties sorted;
+    std::vector<PropertyItem> items;
+    items.emplace_back("zz", Value(1.0));
+    items.emplace_back("a", Value(3.0));
+    items.emplace_back("landuse_kind", Value(std::string("park")));
+    sorted.setSorted(std::move(items));
+    sorted.sort();
+
+    REQUIRE(sorted.hash() == props.hash());
+}
+
+TEST_CASE( "Compacting without string values is a no-op", "[Core][Properties]" ) {
+
+    Properties props;
+    props.set("area", 42.0);
+    props.compact();
+
+    REQUIRE(props.getNumber("area") == 42.0);
+}
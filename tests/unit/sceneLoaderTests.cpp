@@ -70,3 +70,27 @@ TEST_CASE("Test light parameter parsing") {
     REQUIRE(pos.units[1] == Unit::meter);
     REQUIRE(pos.units[2] == Unit::meter);
 }
+
+TEST_CASE("Numeric and unit sequence parameters parse alike") {
+    std::shared_ptr<Scene> scene = std::make_shared<Scene>();
+
+    YAML::Node node = YAML::Load(R"END(
+        offset: [4, -6]
+        text:
+            offset: [2px, 8px]
+        )END");
+
+    std::vector<StyleParam> params;
+    SceneLoader::parseStyleParams(node, scene, "", params);
+
+    // 'text' adds the point_text marker param besides its content
+    REQUIRE(params.size() == 3);
+
+    REQUIRE(params[0].key == StyleParamKey::offset);
+    REQUIRE(params[0].value.is<glm::vec2>());
+    REQUIRE(params[0].value.get<glm::vec2>() == glm::vec2(4, -6));
+
+    REQUIRE(params[2].key == StyleParamKey::text_offset);
+    REQUIRE(params[2].value.is<glm::vec2>());
+    REQUIRE(params[2].value.get<glm::vec2>() == glm::vec2(2, 8));
+}
@@ -177,3 +177,41 @@ TEST_CASE("Apply and propogate repeated global value updates") {
     CHECK(root["seq"][1].Scalar() == "global_a_value");
     CHECK(root["map"]["b"].Scalar() == "newer_global_b_value");
 }
+
+TEST_CASE("Config diff detects tile-affecting changes") {
+
+    const std::string config = R"END(
+cameras: { cam: { type: perspective } }
+lights: { light1: { type: directional } }
+sources: { osm: { type: MVT, url: "https://tile.xyz" } }
+layers: { water: { draw: { polygons: { order: 1 } } } }
+)END";
+
+    Node a, b;
+    REQUIRE(SceneLoader::loadConfig(config, a));
+    REQUIRE(SceneLoader::loadConfig(config, b));
+
+    REQUIRE(SceneLoader::tileConfigEquals(a, b));
+
+    // Camera and light changes don't invalidate tiles
+    SceneUpdate cameraUpdate{"cameras.cam.type", "isometric"};
+    Scene sceneB;
+    sceneB.config() = b;
+    SceneLoader::applyUpdates(sceneB, {cameraUpdate});
+    REQUIRE(SceneLoader::tileConfigEquals(a, sceneB.config()));
+
+    SceneLoader::applyUpdates(sceneB, {{"lights.light1.type", "ambient"}});
+    REQUIRE(SceneLoader::tileConfigEquals(a, sceneB.config()));
+
+    // Layer changes do
+    SceneLoader::applyUpdates(sceneB, {{"layers.water.draw.polygons.order", "5"}});
+    REQUIRE(!SceneLoader::tileConfigEquals(a, sceneB.config()));
+
+    // So does adding a source section entry
+    Node c;
+    REQUIRE(SceneLoader::loadConfig(config, c));
+    Scene sceneC;
+    sceneC.config() = c;
+    SceneLoader::applyUpdates(sceneC, {{"sources.osm.url", "'https://other.xyz'"}});
+    REQUIRE(!SceneLoader::tileConfigEquals(a, sceneC.config()));
+}
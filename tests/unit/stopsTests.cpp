@@ -1,6 +1,7 @@
 #include "catch.hpp"
 
 #include "scene/stops.h"
+#include "scene/styleContext.h"
 #include "yaml-cpp/yaml.h"
 #include "util/mapProjection.h"
 
@@ -160,3 +161,27 @@ TEST_CASE("Regression test - Dont crash on evaluating empty stops", "[Stops][YAM
 
 }
 
+
+TEST_CASE("StyleContext serves cached Stops results per zoom", "[Stops]") {
+
+    Stops stops({
+            Stops::Frame(0, 0.f),
+            Stops::Frame(10, 100.f)
+    });
+
+    StyleContext ctx;
+    ctx.setKeywordZoom(5);
+
+    auto value = ctx.evalStops(stops, StyleParamKey::order);
+    REQUIRE(value.is<float>());
+    REQUIRE(value.get<float>() == 50.f);
+
+    // Same table entry is reused within one zoom
+    REQUIRE(&ctx.evalStops(stops, StyleParamKey::order) ==
+            &ctx.evalStops(stops, StyleParamKey::order));
+
+    // Changing the zoom invalidates the cache
+    ctx.setKeywordZoom(10);
+    value = ctx.evalStops(stops, StyleParamKey::order);
+    REQUIRE(value.get<float>() == 100.f);
+}
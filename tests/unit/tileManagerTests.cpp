@@ -115,7 +115,7 @@ TEST_CASE( "Use proxy Tile - Dont remove proxy if it is now visible", "[TileMana
     tileManager.setDataSources(sources);
 
     /// Start loading tile 0/0/0
-    std::set<TileID> visibleTiles_1 = { TileID{0,0,0} };
+    std::vector<TileID> visibleTiles_1 = { TileID{0,0,0} };
     tileManager.updateTileSets(viewState, visibleTiles_1);
 
     REQUIRE(tileManager.getVisibleTiles().size() == 0);
@@ -123,7 +123,7 @@ TEST_CASE( "Use proxy Tile - Dont remove proxy if it is now visible", "[TileMana
     REQUIRE(worker.processedCount == 0);
 
     /// Start loading tile 0/0/1 - uses 0/0/0 as proxy
-    std::set<TileID> visibleTiles_2 = { TileID{0,0,1} };
+    std::vector<TileID> visibleTiles_2 = { TileID{0,0,1} };
     tileManager.updateTileSets(viewState, visibleTiles_2);
 
     REQUIRE(tileManager.getVisibleTiles().size() == 0);
@@ -170,7 +170,7 @@ TEST_CASE( "Load visible Tile", "[TileManager][updateTileSets]" ) {
     std::vector<std::shared_ptr<DataSource>> sources = { source };
     tileManager.setDataSources(sources);
 
-    std::set<TileID> visibleTiles = { TileID{0,0,0} };
+    std::vector<TileID> visibleTiles = { TileID{0,0,0} };
     tileManager.updateTileSets(viewState, visibleTiles);
     worker.processTask();
 
@@ -196,7 +196,7 @@ TEST_CASE( "Use proxy Tile", "[TileManager][updateTileSets]" ) {
     std::vector<std::shared_ptr<DataSource>> sources = { source };
     tileManager.setDataSources(sources);
 
-    std::set<TileID> visibleTiles = { TileID{0,0,0} };
+    std::vector<TileID> visibleTiles = { TileID{0,0,0} };
     tileManager.updateTileSets(viewState, visibleTiles);
     worker.processTask();
 
@@ -204,7 +204,7 @@ TEST_CASE( "Use proxy Tile", "[TileManager][updateTileSets]" ) {
     REQUIRE(source->tileTaskCount == 1);
     REQUIRE(worker.processedCount == 1);
 
-    std::set<TileID> visibleTiles2 = { TileID{0,0,1} };
+    std::vector<TileID> visibleTiles2 = { TileID{0,0,1} };
     tileManager.updateTileSets(viewState, visibleTiles2);
     worker.processTask();
 
@@ -236,7 +236,7 @@ TEST_CASE( "Use proxy Tile - circular proxies", "[TileManager][updateTileSets]"
     tileManager.setDataSources(sources);
 
     /// Start loading tile 0/0/0
-    std::set<TileID> visibleTiles_1 = { TileID{0,0,0} };
+    std::vector<TileID> visibleTiles_1 = { TileID{0,0,0} };
     tileManager.updateTileSets(viewState, visibleTiles_1);
 
     REQUIRE(tileManager.getVisibleTiles().size() == 0);
@@ -244,7 +244,7 @@ TEST_CASE( "Use proxy Tile - circular proxies", "[TileManager][updateTileSets]"
     REQUIRE(worker.processedCount == 0);
 
     /// Start loading tile 0/0/1 - add 0/0/0 as proxy
-    std::set<TileID> visibleTiles_2 = { TileID{0,0,1} };
+    std::vector<TileID> visibleTiles_2 = { TileID{0,0,1} };
     tileManager.updateTileSets(viewState, visibleTiles_2);
 
     REQUIRE(tileManager.getVisibleTiles().size() == 0);
@@ -247,3 +247,94 @@ TEST_CASE("Sequences in filters implicitly create an 'any' filter", "[filters][c
     REQUIRE(filter.eval(bmw1, ctx));
     REQUIRE(!filter.eval(bike, ctx));
 }
+
+TEST_CASE( "yaml-filter-tests: compiled program matches tree evaluation", "[filters][core][yaml]") {
+    init();
+
+    for (auto& yaml : {
+            "filter: { series: !!str 3}",
+            "filter: { any: [{ wheel: 2 }, { drive: fwd }] }",
+            "filter: { all: [{ type: car }, { not: { brand: bmw } }, { wheel: { min: 3 } }] }",
+            "filter: { none: [{ brand: honda }] }",
+            "filter: { check: true }",
+            "filter: { name: [civic, cb1100] }" }) {
+
+        Filter filter = load(yaml);
+        FilterProgram program(filter);
+
+        REQUIRE(program.eval(civic, ctx) == filter.eval(civic, ctx));
+        REQUIRE(program.eval(bmw1, ctx) == filter.eval(bmw1, ctx));
+        REQUIRE(program.eval(bike, ctx) == filter.eval(bike, ctx));
+    }
+}
+
+TEST_CASE( "yaml-filter-tests: static filter bounds", "[filters][core][yaml]") {
+
+    // Unconstrained property filter
+    auto bounds = load(R"(filter: { series: '3'})").bounds();
+    REQUIRE(bounds.match(0, GeometryType::points));
+    REQUIRE(bounds.match(20, GeometryType::polygons));
+
+    // $zoom range
+    bounds = load(R"(filter: {$zoom: {min: 12, max: 15}})").bounds();
+    REQUIRE(!bounds.matchZoom(11));
+    REQUIRE(bounds.matchZoom(12));
+    REQUIRE(bounds.matchZoom(14));
+    REQUIRE(!bounds.matchZoom(15));
+
+    // $geometry equality
+    bounds = load(R"(filter: {$geometry: line})").bounds();
+    REQUIRE(!bounds.match(14, GeometryType::points));
+    REQUIRE(bounds.match(14, GeometryType::lines));
+    REQUIRE(!bounds.match(14, GeometryType::polygons));
+
+    // 'all' intersects, 'any' unites
+    bounds = load(R"(filter: {all: [{$zoom: {min: 10}}, {$geometry: point}]})").bounds();
+    REQUIRE(!bounds.match(9, GeometryType::points));
+    REQUIRE(bounds.match(10, GeometryType::points));
+    REQUIRE(!bounds.match(10, GeometryType::lines));
+
+    bounds = load(R"(filter: {any: [{$geometry: point}, {$geometry: polygon}]})").bounds();
+    REQUIRE(bounds.match(14, GeometryType::points));
+    REQUIRE(!bounds.match(14, GeometryType::lines));
+    REQUIRE(bounds.match(14, GeometryType::polygons));
+
+    // 'none' gives no static bounds
+    bounds = load(R"(filter: {not: {$geometry: point}})").bounds();
+    REQUIRE(bounds.match(14, GeometryType::points));
+}
+
+TEST_CASE( "yaml-filter-tests: bounds exactness and keyword usage", "[filters][core][yaml]") {
+
+    // Pure keyword filters are decided by their bounds alone
+    auto bounds = load(R"(filter: {$zoom: {min: 12, max: 15}})").bounds();
+    REQUIRE(bounds.exact);
+    REQUIRE(bounds.usesKeyword(FilterKeyword::zoom));
+    REQUIRE(!bounds.usesKeyword(FilterKeyword::geometry));
+
+    bounds = load(R"(filter: {all: [{$zoom: {min: 10}}, {$geometry: point}]})").bounds();
+    REQUIRE(bounds.exact);
+    REQUIRE(bounds.usesKeyword(FilterKeyword::zoom));
+    REQUIRE(bounds.usesKeyword(FilterKeyword::geometry));
+
+    // A geometry union stays exact, a zoom union does not
+    bounds = load(R"(filter: {any: [{$geometry: point}, {$geometry: polygon}]})").bounds();
+    REQUIRE(bounds.exact);
+
+    bounds = load(R"(filter: {any: [{$zoom: {max: 5}}, {$zoom: {min: 10}}]})").bounds();
+    REQUIRE(!bounds.exact);
+
+    // Property predicates need the evaluator
+    bounds = load(R"(filter: { series: '3'})").bounds();
+    REQUIRE(!bounds.exact);
+    REQUIRE(bounds.keywords == 0);
+
+    bounds = load(R"(filter: {all: [{$zoom: {min: 10}}, {series: '3'}]})").bounds();
+    REQUIRE(!bounds.exact);
+    REQUIRE(bounds.usesKeyword(FilterKeyword::zoom));
+
+    // 'none' hides its operands from the bounds but not their keywords
+    bounds = load(R"(filter: {not: {$geometry: point}})").bounds();
+    REQUIRE(!bounds.exact);
+    REQUIRE(bounds.usesKeyword(FilterKeyword::geometry));
+}
@@ -12,12 +12,26 @@
 
 struct UrlTask {
     UrlCallback callback;
+    UrlChunkCallback onChunk;
+    UrlValidateCallback validateCallback;
     const std::string url;
+    std::string etag;
+    std::string responseEtag;
+    std::vector<char> content;
 
-    UrlTask(const std::string& _url, const UrlCallback& _callback) :
+    UrlTask(const std::string& _url, const UrlCallback& _callback,
+            const UrlChunkCallback& _onChunk = UrlChunkCallback()) :
         callback(_callback),
+        onChunk(_onChunk),
         url(_url) {
     }
+
+    UrlTask(const std::string& _url, const std::string& _etag,
+            const UrlValidateCallback& _callback) :
+        validateCallback(_callback),
+        url(_url),
+        etag(_etag) {
+    }
 };
 
 class UrlWorker {
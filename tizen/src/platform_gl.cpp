@@ -114,12 +114,23 @@ GLint GL::getUniformLocation(GLuint program, const GLchar *name) {
 GLint GL::getAttribLocation(GLuint program, const GLchar *name) {
     return __evas_gl_glapi->glGetAttribLocation(program, name);
 }
+void GL::bindAttribLocation(GLuint program, GLuint index, const GLchar *name) {
+    __evas_gl_glapi->glBindAttribLocation(program, index, name);
+}
 void GL::getProgramiv(GLuint program, GLenum pname, GLint *params) {
     __evas_gl_glapi->glGetProgramiv(program,pname,params);
 }
 void GL::getShaderiv(GLuint shader, GLenum pname, GLint *params) {
     __evas_gl_glapi->glGetShaderiv(shader,pname, params);
 }
+void GL::getProgramBinary(GLuint program, GLsizei bufSize, GLsizei *length,
+                          GLenum *binaryFormat, void *binary) {
+    __evas_gl_glapi->glGetProgramBinaryOES(program, bufSize, length, binaryFormat, binary);
+}
+void GL::programBinary(GLuint program, GLenum binaryFormat,
+                       const void *binary, GLsizei length) {
+    __evas_gl_glapi->glProgramBinaryOES(program, binaryFormat, binary, length);
+}
 
 // Buffers
 void GL::bindBuffer(GLenum target, GLuint buffer) {
@@ -142,6 +153,27 @@ void GL::readPixels(GLint x, GLint y, GLsizei width, GLsizei height,
     __evas_gl_glapi->glReadPixels(x, y, width, height, format, type, pixels);
 }
 
+// Framebuffer
+void GL::genFramebuffers(GLsizei n, GLuint *framebuffers) {
+    __evas_gl_glapi->glGenFramebuffers(n, framebuffers);
+}
+void GL::deleteFramebuffers(GLsizei n, const GLuint *framebuffers) {
+    __evas_gl_glapi->glDeleteFramebuffers(n, framebuffers);
+}
+void GL::bindFramebuffer(GLenum target, GLuint framebuffer) {
+    __evas_gl_glapi->glBindFramebuffer(target, framebuffer);
+}
+void GL::framebufferTexture2D(GLenum target, GLenum attachment,
+                              GLenum textarget, GLuint texture, GLint level) {
+    __evas_gl_glapi->glFramebufferTexture2D(target, attachment, textarget, texture, level);
+}
+GLenum GL::checkFramebufferStatus(GLenum target) {
+    return __evas_gl_glapi->glCheckFramebufferStatus(target);
+}
+void GL::discardFramebuffer(GLenum target, GLsizei numAttachments, const GLenum *attachments) {
+    __evas_gl_glapi->glDiscardFramebufferEXT(target, numAttachments, attachments);
+}
+
 // Texture
 void GL::bindTexture(GLenum target, GLuint texture ) {
     __evas_gl_glapi->glBindTexture(target, texture );
@@ -271,4 +303,16 @@ void GL::deleteVertexArrays(GLsizei n, const GLuint *arrays) {
 void GL::genVertexArrays(GLsizei n, GLuint *arrays) {
     __evas_gl_glapi->glGenVertexArraysOES(n, arrays);
 }
+
+// timer queries - not exposed through the Evas GL API
+void GL::genQueries(GLsizei n, GLuint *queries) {
+}
+void GL::deleteQueries(GLsizei n, const GLuint *queries) {
+}
+void GL::beginQuery(GLenum target, GLuint query) {
+}
+void GL::endQuery(GLenum target) {
+}
+void GL::getQueryObjectuiv(GLuint query, GLenum pname, GLuint *params) {
+}
 }
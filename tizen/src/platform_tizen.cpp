@@ -12,9 +12,12 @@
 #include "platform_gl.h"
 #include "urlWorker.h"
 
+#include <fcntl.h>
 #include <libgen.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/resource.h>
+#include <sys/stat.h>
 #include <sys/syscall.h>
 
 #include <fontconfig.h>
@@ -35,9 +38,22 @@ bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
     return true;
 }
 
+bool startUrlRequest(const std::string& _url, UrlChunkCallback _onChunk, UrlCallback _callback) {
+    s_workers.enqueue(std::make_unique<UrlTask>(_url, _callback, _onChunk));
+    return true;
+}
+
+bool startUrlRequest(const std::string& _url, const std::string& _etag, UrlValidateCallback _callback) {
+    s_workers.enqueue(std::make_unique<UrlTask>(_url, _etag, _callback));
+    return true;
+}
+
 void cancelUrlRequest(const std::string& _url) {
 }
 
+void prewarmUrlHost(const std::string& _url) {
+}
+
 void initUrlRequests(const char* proxyAddress) {
     s_workers.start(4, proxyAddress);
 }
@@ -235,6 +251,43 @@ unsigned char* bytesFromFile(const char* _path, size_t& _size) {
     return reinterpret_cast<unsigned char *>(cdata);
 }
 
+MappedFile mapFile(const char* _path) {
+
+    if (!_path || strlen(_path) == 0) { return {}; }
+
+    int fd = open(_path, O_RDONLY);
+    if (fd < 0) {
+        logMsg("Failed to open file at path: %s\n", _path);
+        return {};
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return {};
+    }
+
+    size_t size = st.st_size;
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        // Fall back to a heap copy
+        size_t length = 0;
+        unsigned char* bytes = bytesFromFile(_path, length);
+        if (!bytes) { return {}; }
+        return MappedFile(reinterpret_cast<const char*>(bytes), length,
+                          [](const char* _data, size_t) {
+                              free(const_cast<char*>(_data));
+                          });
+    }
+
+    return MappedFile(static_cast<const char*>(data), size,
+                      [](const char* _data, size_t _size) {
+                          munmap(const_cast<char*>(_data), _size);
+                      });
+}
+
 void setCurrentThreadPriority(int priority){
     int tid = syscall(SYS_gettid);
     //int  p1 = getpriority(PRIO_PROCESS, tid);
@@ -2,12 +2,42 @@
 #include "log.h"
 
 #include <curl/curl.h>
-#include <sstream>
+
+#include <cstring>
 
 static size_t write_data(void *_buffer, size_t _size, size_t _nmemb, void *_dataPtr) {
-        size_t realSize = _size * _nmemb;
-        auto* stream = (std::stringstream*)_dataPtr;
-    stream->write(reinterpret_cast<const char*>(_buffer), realSize);
+    size_t realSize = _size * _nmemb;
+    auto* task = (UrlTask*)_dataPtr;
+
+    // curl inflates gzip-encoded payloads incrementally, so each chunk
+    // arrives here already decompressed while the transfer is running.
+    task->content.insert(task->content.end(),
+                         (const char*)_buffer, (const char*)_buffer + realSize);
+
+    if (task->onChunk) {
+        task->onChunk((const char*)_buffer, realSize);
+    }
+    return realSize;
+}
+
+static size_t header_data(char* _buffer, size_t _size, size_t _nitems, void* _dataPtr) {
+    const size_t realSize = _size * _nitems;
+    auto* task = (UrlTask*)_dataPtr;
+
+    // Capture the ETag response header as validator for later
+    // conditional requests of the same URL.
+    const char name[] = "etag:";
+    const size_t nameLength = sizeof(name) - 1;
+
+    if (realSize > nameLength && strncasecmp(_buffer, name, nameLength) == 0) {
+        const char* begin = _buffer + nameLength;
+        const char* end = _buffer + realSize;
+        while (begin < end && (*begin == ' ' || *begin == '\t')) { begin++; }
+        while (end > begin && (end[-1] == '\r' || end[-1] == '\n' ||
+                               end[-1] == ' ' || end[-1] == '\t')) { end--; }
+        task->responseEtag.assign(begin, end);
+    }
+
     return realSize;
 }
 
@@ -30,7 +60,6 @@ UrlWorker::~UrlWorker() {
 }
 
 void UrlWorker::run() {
-    std::stringstream stream;
     CURL* curlHandle;
 
     {
@@ -38,7 +67,6 @@ void UrlWorker::run() {
         curlHandle = curl_easy_init();
         // set up curl to perform fetch
         curl_easy_setopt(curlHandle, CURLOPT_WRITEFUNCTION, write_data);
-        curl_easy_setopt(curlHandle, CURLOPT_WRITEDATA, &stream);
         if (!m_proxyAddress.empty()) {
             curl_easy_setopt(curlHandle, CURLOPT_PROXY, m_proxyAddress.c_str());
         }
@@ -66,29 +94,57 @@ void UrlWorker::run() {
 
         LOGD("Fetching URL: %s", task->url.c_str());
         curl_easy_setopt(curlHandle, CURLOPT_URL, task->url.c_str());
+        curl_easy_setopt(curlHandle, CURLOPT_WRITEDATA, task.get());
+
+        struct curl_slist* requestHeaders = nullptr;
+
+        if (task->validateCallback) {
+            if (!task->etag.empty()) {
+                std::string header = "If-None-Match: " + task->etag;
+                requestHeaders = curl_slist_append(requestHeaders, header.c_str());
+            }
+            curl_easy_setopt(curlHandle, CURLOPT_HEADERFUNCTION, header_data);
+            curl_easy_setopt(curlHandle, CURLOPT_HEADERDATA, task.get());
+        } else {
+            curl_easy_setopt(curlHandle, CURLOPT_HEADERFUNCTION, nullptr);
+            curl_easy_setopt(curlHandle, CURLOPT_HEADERDATA, nullptr);
+        }
+        curl_easy_setopt(curlHandle, CURLOPT_HTTPHEADER, requestHeaders);
 
-        // Reset stream
-        stream.seekp(0);
         CURLcode result = curl_easy_perform(curlHandle);
 
         long httpStatusCode = 0;
         curl_easy_getinfo(curlHandle, CURLINFO_RESPONSE_CODE, &httpStatusCode);
 
-        std::vector<char> content;
+        if (requestHeaders) {
+            curl_slist_free_all(requestHeaders);
+            curl_easy_setopt(curlHandle, CURLOPT_HTTPHEADER, nullptr);
+        }
 
-        if (result == CURLE_OK && httpStatusCode == 200) {
-            size_t nBytes = stream.tellp();
-            stream.seekp(0);
+        if (task->validateCallback) {
+            if (result == CURLE_OK && httpStatusCode == 304) {
+                // The cached copy named by the request validator is still
+                // current - no body was transferred.
+                task->validateCallback({}, std::string(), true);
+                continue;
+            }
+            if (result != CURLE_OK || httpStatusCode != 200) {
+                LOGE("curl_easy_perform failed: %s - %d",
+                       curl_easy_strerror(result), httpStatusCode);
+                task->content.clear();
+            }
+            task->validateCallback(std::move(task->content),
+                                   std::move(task->responseEtag), false);
+            continue;
+        }
 
-            content.resize(nBytes);
-            stream.seekg(0);
-            stream.read(content.data(), nBytes);
-        } else {
+        if (result != CURLE_OK || httpStatusCode != 200) {
             LOGE("curl_easy_perform failed: %s - %d",
                    curl_easy_strerror(result), httpStatusCode);
+            task->content.clear();
         }
 
-        task->callback(std::move(content));
+        task->callback(std::move(task->content));
     }
 
     curl_easy_cleanup(curlHandle);
@@ -0,0 +1,75 @@
+# Headless offscreen EGL target for CI performance runs; renders without
+# a window system through a pbuffer surface (see headless/src).
+set(PLATFORM_HEADLESS ON)
+
+# global compile options
+set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -Wall -std=c++1y")
+set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fno-omit-frame-pointer")
+
+if (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+  set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -Wno-gnu-zero-variadic-macro-arguments")
+  set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -stdlib=libc++")
+  set(CMAKE_EXE_LINKER_FLAGS "${CMAKE_EXE_LINKER_FLAGS}  -lc++ -lc++abi")
+endif()
+
+if (CMAKE_COMPILER_IS_GNUCC)
+  execute_process(COMMAND ${CMAKE_CXX_COMPILER} -dumpversion
+    OUTPUT_VARIABLE GCC_VERSION)
+  string(REGEX MATCHALL "[0-9]+" GCC_VERSION_COMPONENTS ${GCC_VERSION})
+  list(GET GCC_VERSION_COMPONENTS 0 GCC_MAJOR)
+  list(GET GCC_VERSION_COMPONENTS 1 GCC_MINOR)
+
+  message(STATUS "Using gcc ${GCC_VERSION}")
+  if (GCC_VERSION VERSION_GREATER 5.1)
+    message(STATUS "USE CXX11_ABI")
+    add_definitions("-D_GLIBCXX_USE_CXX11_ABI=1")
+  endif()
+endif()
+
+check_unsupported_compiler_version()
+
+# compile definitions (adds -DPLATFORM_HEADLESS)
+set(CORE_COMPILE_DEFS PLATFORM_HEADLESS)
+
+if (USE_EXTERNAL_LIBS)
+include(${EXTERNAL_LIBS_DIR}/core-dependencies.cmake)
+else()
+add_subdirectory(${PROJECT_SOURCE_DIR}/external)
+endif()
+
+# load core library
+add_subdirectory(${PROJECT_SOURCE_DIR}/core)
+
+if(APPLICATION)
+
+  set(EXECUTABLE_NAME "tangram-headless")
+
+  find_library(EGL_LIBRARY EGL REQUIRED)
+  find_library(GLES2_LIBRARY GLESv2 REQUIRED)
+
+  # add sources and include headers
+  find_sources_and_include_directories(
+    ${PROJECT_SOURCE_DIR}/headless/src/*.h
+    ${PROJECT_SOURCE_DIR}/headless/src/*.cpp)
+
+  # reuse the curl URL workers from the linux platform
+  include_directories(${PROJECT_SOURCE_DIR}/linux/src)
+
+  add_executable(${EXECUTABLE_NAME}
+    ${SOURCES}
+    ${PROJECT_SOURCE_DIR}/linux/src/urlClient.cpp
+    ${PROJECT_SOURCE_DIR}/core/common/platform_gl.cpp
+    )
+
+  target_link_libraries(${EXECUTABLE_NAME}
+    ${CORE_LIBRARY}
+    -lcurl
+    # only used when not using external lib
+    -ldl
+    -pthread
+    ${EGL_LIBRARY}
+    ${GLES2_LIBRARY})
+
+  add_resources(${EXECUTABLE_NAME} "${PROJECT_SOURCE_DIR}/scenes")
+
+endif()
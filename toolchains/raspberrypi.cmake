@@ -17,8 +17,8 @@ find_sources_and_include_directories(
 
 # add sources and include headers
 find_sources_and_include_directories(
-  ${PROJECT_SOURCE_DIR}/linux/src/urlWorker.*
-  ${PROJECT_SOURCE_DIR}/linux/src/urlWorker.*)
+  ${PROJECT_SOURCE_DIR}/linux/src/urlClient.*
+  ${PROJECT_SOURCE_DIR}/linux/src/urlClient.*)
 
 # include headers for rpi-installed libraries
 include_directories(/opt/vc/include/)